@@ -0,0 +1,151 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "AllocationTracker.h"
+
+#if KONSOLE_ALLOCATION_TRACKING
+
+// Qt
+#include <QStringList>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using Konsole::AllocationTracker;
+
+thread_local AllocationTracker::Subsystem AllocationTracker::s_currentSubsystem = AllocationTracker::NoSubsystem;
+
+namespace
+{
+// one counter pair per subsystem; atomics because allocations happen on
+// every thread, the scope tag itself is thread-local
+std::array<std::atomic<quint64>, AllocationTracker::SubsystemCount> s_allocationCount;
+std::array<std::atomic<quint64>, AllocationTracker::SubsystemCount> s_allocationBytes;
+std::atomic<quint64> s_outputBytes{0};
+
+const char *subsystemName(int subsystem)
+{
+    switch (subsystem) {
+    case AllocationTracker::TokenizerSubsystem:
+        return "tokenizer";
+    case AllocationTracker::ScreenSubsystem:
+        return "screen";
+    case AllocationTracker::HistorySubsystem:
+        return "history";
+    case AllocationTracker::PainterSubsystem:
+        return "painter";
+    case AllocationTracker::FilterSubsystem:
+        return "filters";
+    default:
+        return "other";
+    }
+}
+
+}
+
+void AllocationTracker::addOutputBytes(qint64 bytes)
+{
+    s_outputBytes.fetch_add(quint64(bytes), std::memory_order_relaxed);
+}
+
+void AllocationTracker::recordAllocation(std::size_t size)
+{
+    const Subsystem subsystem = s_currentSubsystem;
+    s_allocationCount[subsystem].fetch_add(1, std::memory_order_relaxed);
+    s_allocationBytes[subsystem].fetch_add(quint64(size), std::memory_order_relaxed);
+}
+
+QString AllocationTracker::report()
+{
+    const double outputMegabytes = double(s_outputBytes.load()) / (1024.0 * 1024.0);
+    QStringList lines;
+    lines.append(QStringLiteral("allocations after %1 MB of output:").arg(outputMegabytes, 0, 'f', 1));
+    for (int subsystem = 0; subsystem < SubsystemCount; ++subsystem) {
+        const quint64 count = s_allocationCount[subsystem].load();
+        const quint64 bytes = s_allocationBytes[subsystem].load();
+        if (subsystem != NoSubsystem && count == 0) {
+            continue;
+        }
+        lines.append(QStringLiteral("  %1: %2 allocations (%3 KB), %4 per MB of output")
+                         .arg(QLatin1String(subsystemName(subsystem)))
+                         .arg(count)
+                         .arg(bytes / 1024)
+                         .arg(outputMegabytes > 0.0 ? double(count) / outputMegabytes : 0.0, 0, 'f', 1));
+    }
+    return lines.join(QLatin1Char('\n'));
+}
+
+void AllocationTracker::reset()
+{
+    for (int subsystem = 0; subsystem < SubsystemCount; ++subsystem) {
+        s_allocationCount[subsystem] = 0;
+        s_allocationBytes[subsystem] = 0;
+    }
+    s_outputBytes = 0;
+}
+
+// The counting allocator.  Defined here so konsoleprivate carries the
+// strong symbols; they take precedence over the C++ runtime's for the
+// whole process.  Deallocation is left untracked on purpose: free() is
+// cheap, and the question the counters answer is how often the hot
+// paths allocate at all.
+
+void *operator new(std::size_t size)
+{
+    AllocationTracker::recordAllocation(size);
+    void *pointer = std::malloc(size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void *operator new[](std::size_t size)
+{
+    AllocationTracker::recordAllocation(size);
+    void *pointer = std::malloc(size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    AllocationTracker::recordAllocation(size);
+    return std::malloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    AllocationTracker::recordAllocation(size);
+    return std::malloc(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+#endif // KONSOLE_ALLOCATION_TRACKING
@@ -0,0 +1,109 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+// Qt
+#include <QString>
+
+#include <cstddef>
+
+#include "config-konsole.h"
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+/**
+ * Per-subsystem heap allocation counters for the output hot paths.
+ *
+ * Allocator churn regressions are easy to introduce and invisible in
+ * wall-clock numbers until they are not.  Configuring with
+ * -DKONSOLE_ALLOCATION_TRACKING=ON installs a counting global allocator
+ * that attributes every allocation to the subsystem scope the current
+ * thread is in (tokenizer, screen, history, painter, filters), and
+ * report() relates the counts to the pty output processed, giving
+ * allocations per MB of output per subsystem.  The report is appended
+ * to the pipeline metrics D-Bus report.
+ *
+ * In a normal build the scopes compile to nothing and no allocator is
+ * installed.
+ */
+class KONSOLEPRIVATE_EXPORT AllocationTracker
+{
+public:
+    enum Subsystem {
+        NoSubsystem = 0, // everything outside an annotated scope
+        TokenizerSubsystem,
+        ScreenSubsystem,
+        HistorySubsystem,
+        PainterSubsystem,
+        FilterSubsystem,
+        SubsystemCount,
+    };
+
+#if KONSOLE_ALLOCATION_TRACKING
+    /** Attributes allocations on this thread to @p subsystem while alive. */
+    class Scope
+    {
+    public:
+        explicit Scope(Subsystem subsystem)
+            : _previous(s_currentSubsystem)
+        {
+            s_currentSubsystem = subsystem;
+        }
+
+        ~Scope()
+        {
+            s_currentSubsystem = _previous;
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Subsystem _previous;
+    };
+
+    /** Adds pty output bytes to the denominator of report(). */
+    static void addOutputBytes(qint64 bytes);
+
+    /** Called by the counting allocator; attributes to the current scope. */
+    static void recordAllocation(std::size_t size);
+
+    /** Counts and allocations-per-MB-of-output, one line per subsystem. */
+    static QString report();
+
+    static void reset();
+
+    static thread_local Subsystem s_currentSubsystem;
+#else
+    class Scope
+    {
+    public:
+        explicit Scope(Subsystem)
+        {
+        }
+    };
+
+    static void addOutputBytes(qint64)
+    {
+    }
+
+    static QString report()
+    {
+        return QString();
+    }
+
+    static void reset()
+    {
+    }
+#endif
+};
+
+}
+
+#endif // ALLOCATIONTRACKER_H
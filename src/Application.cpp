@@ -10,6 +10,12 @@
 // Qt
 #include <QApplication>
 #include <QCommandLineParser>
+#if HAVE_DBUS
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QXmlStreamReader>
+#endif
 #include <QDir>
 #include <QFileInfo>
 #include <QHash>
@@ -79,6 +85,8 @@ void Application::populateCommandLineParser(QCommandLineParser *parser)
          QStringLiteral("cmd")},
         {{QStringLiteral("force-reuse")},
          i18nc("@info:shell", "Force re-using the existing instance even if it breaks functionality, e. g. --new-tab. Mostly for debugging.")},
+        {{QStringLiteral("profile-startup")}, i18nc("@info:shell", "Print timestamped startup phases to standard error. Mostly for debugging.")},
+        {{QStringLiteral("diagnose")}, i18nc("@info:shell", "Print per-session memory and I/O accounting of all running Konsole processes, then exit")},
     };
 
     for (const auto &option : options) {
@@ -119,6 +127,9 @@ QStringList Application::getCustomCommand(QStringList &args)
 
 Application::~Application()
 {
+    // the pre-warmed window is hidden and has no session, so nothing else
+    // owns or closes it
+    delete m_prewarmedWindow.data();
     SessionManager::instance()->closeAllSessions();
 }
 
@@ -142,9 +153,61 @@ MainWindow *Application::newMainWindow()
     return window;
 }
 
+// Pre-warming only pays off while a single resident process serves the
+// new-window requests of later konsole invocations
+static bool prewarmEnabled()
+{
+    return KonsoleSettings::useSingleInstance() && KonsoleSettings::prewarmNewWindows();
+}
+
+void Application::schedulePrewarm()
+{
+    if (!prewarmEnabled()) {
+        return;
+    }
+
+    // Defer until the event loop is idle so the window being handed to the
+    // user wins the race for CPU time
+    QTimer::singleShot(0, this, &Application::prewarmWindow);
+}
+
+void Application::prewarmWindow()
+{
+    if (!prewarmEnabled() || !m_prewarmedWindow.isNull()) {
+        return;
+    }
+
+    // Building a MainWindow (XMLGUI actions, ViewManager, tab container) is
+    // the expensive part of opening a new window; keep one constructed but
+    // hidden so a new-window request only pays for creating the session.
+    // The session itself cannot be pre-created: sessions fork their shell
+    // as soon as the emulation image size settles (see the queued
+    // imageSizeInitialized connection in Session), which would leave a
+    // shell running behind a window nobody asked for yet.
+    m_prewarmedWindow = newMainWindow();
+}
+
+MainWindow *Application::takePrewarmedWindow()
+{
+    if (m_prewarmedWindow.isNull()) {
+        return nullptr;
+    }
+
+    MainWindow *window = m_prewarmedWindow.data();
+    m_prewarmedWindow.clear();
+
+    // refill the pool once the adopted window is up
+    schedulePrewarm();
+
+    return window;
+}
+
 void Application::createWindow(const Profile::Ptr &profile, const QString &directory, const ContainerInfo &container)
 {
-    MainWindow *window = newMainWindow();
+    MainWindow *window = takePrewarmedWindow();
+    if (window == nullptr) {
+        window = newMainWindow();
+    }
     Session *session = window->createSession(profile, directory);
 
     // Apply inherited container context for the new window.
@@ -250,6 +313,8 @@ int Application::newInstance()
         }
     }
 
+    schedulePrewarm();
+
     return 1;
 }
 
@@ -409,7 +474,10 @@ MainWindow *Application::processWindowArgs(bool &createdNewMainWindow)
 
     if (window == nullptr) {
         createdNewMainWindow = true;
-        window = newMainWindow();
+        window = takePrewarmedWindow();
+        if (window == nullptr) {
+            window = newMainWindow();
+        }
 
         // override default menubar visibility
         if (m_parser->isSet(QStringLiteral("show-menubar"))) {
@@ -490,6 +558,74 @@ void Application::listProfilePropertyInfo()
     }
 }
 
+int Application::printDiagnostics()
+{
+#if HAVE_DBUS
+    QDBusConnectionInterface *busInterface = QDBusConnection::sessionBus().interface();
+    if (busInterface == nullptr) {
+        fprintf(stderr, "Could not connect to the D-Bus session bus.\n");
+        return 1;
+    }
+
+    bool foundSession = false;
+    // one service per running Konsole process: org.kde.konsole-<pid>, or
+    // plain org.kde.konsole when running in single instance mode
+    const QStringList services = busInterface->registeredServiceNames().value();
+    for (const QString &service : services) {
+        if (!service.startsWith(QLatin1String("org.kde.konsole"))) {
+            continue;
+        }
+
+        // the session ids are the child nodes of /Sessions
+        QDBusMessage introspectCall = QDBusMessage::createMethodCall(service,
+                                                                     QStringLiteral("/Sessions"),
+                                                                     QStringLiteral("org.freedesktop.DBus.Introspectable"),
+                                                                     QStringLiteral("Introspect"));
+        const QDBusMessage introspectReply = QDBusConnection::sessionBus().call(introspectCall);
+        if (introspectReply.type() != QDBusMessage::ReplyMessage || introspectReply.arguments().isEmpty()) {
+            continue;
+        }
+
+        QXmlStreamReader xml(introspectReply.arguments().constFirst().toString());
+        while (!xml.atEnd()) {
+            xml.readNext();
+            if (!xml.isStartElement() || xml.name() != QLatin1String("node")) {
+                continue;
+            }
+            const QString sessionId = xml.attributes().value(QStringLiteral("name")).toString();
+            if (sessionId.isEmpty()) {
+                // the root <node> element describing /Sessions itself
+                continue;
+            }
+
+            QDBusMessage diagnosticsCall = QDBusMessage::createMethodCall(service,
+                                                                          QStringLiteral("/Sessions/") + sessionId,
+                                                                          QStringLiteral("org.kde.konsole.Session"),
+                                                                          QStringLiteral("diagnostics"));
+            const QDBusMessage diagnosticsReply = QDBusConnection::sessionBus().call(diagnosticsCall);
+            if (diagnosticsReply.type() != QDBusMessage::ReplyMessage || diagnosticsReply.arguments().isEmpty()) {
+                continue;
+            }
+
+            foundSession = true;
+            printf("%s, session %s:\n", qPrintable(service), qPrintable(sessionId));
+            const QStringList lines = diagnosticsReply.arguments().constFirst().toString().split(QLatin1Char('\n'));
+            for (const QString &line : lines) {
+                printf("  %s\n", qPrintable(line));
+            }
+        }
+    }
+
+    if (!foundSession) {
+        fprintf(stderr, "No running Konsole sessions found on the session bus.\n");
+    }
+    return foundSession ? 0 : 1;
+#else
+    fprintf(stderr, "This build of Konsole has no D-Bus support.\n");
+    return 1;
+#endif
+}
+
 Profile::Ptr Application::processProfileChangeArgs(Profile::Ptr baseProfile)
 {
     bool shouldUseNewProfile = false;
@@ -9,6 +9,7 @@
 
 // Qt
 #include <QCommandLineParser>
+#include <QPointer>
 
 // Konsole
 #include "containers/ContainerInfo.h"
@@ -47,6 +48,13 @@ public:
     static void populateCommandLineParser(QCommandLineParser *parser);
     static QStringList getCustomCommand(QStringList &args);
 
+    /**
+     * Prints the diagnostics() report of every session of every running
+     * Konsole process to standard output (see Session::diagnostics()) and
+     * returns the exit code for `konsole --diagnose`.
+     */
+    static int printDiagnostics();
+
     ~Application() override;
 
     /** Creates a new main window and opens a default terminal session */
@@ -65,6 +73,8 @@ private Q_SLOTS:
 
     void toggleBackgroundInstance();
 
+    void prewarmWindow();
+
 public Q_SLOTS:
     void slotActivateRequested(QStringList args, const QString &workingDir);
 
@@ -81,7 +91,15 @@ private:
     bool processTabsFromFileArgs(MainWindow *window);
     void createTabFromArgs(MainWindow *window, const QHash<QString, QString> &);
 
+    void schedulePrewarm();
+    MainWindow *takePrewarmedWindow();
+
     MainWindow *_backgroundInstance;
+
+    // A hidden, fully constructed main window kept ready so new-window
+    // requests served by the resident instance only pay for session
+    // creation; see prewarmWindow()
+    QPointer<MainWindow> m_prewarmedWindow;
     QSharedPointer<QCommandLineParser> m_parser;
     QStringList m_customCommand;
     PluginManager m_pluginManager;
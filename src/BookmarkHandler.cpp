@@ -12,6 +12,7 @@
 #include "BookmarkHandler.h"
 
 // Qt
+#include <QCoreApplication>
 #include <QDir>
 #include <QFileInfo>
 #include <QStandardPaths>
@@ -29,30 +30,36 @@ BookmarkHandler::BookmarkHandler(KActionCollection *collection, QMenu *menu, boo
     : QObject(parent)
     , KBookmarkOwner()
     , _menu(menu)
-    , _file(QString())
     , _toplevel(toplevel)
     , _activeView(nullptr)
     , _views(QList<ViewProperties *>())
 {
     setObjectName(QStringLiteral("BookmarkHandler"));
 
-    _file = QStandardPaths::locate(QStandardPaths::GenericDataLocation, QStringLiteral("konsole/bookmarks.xml"));
-
-    if (_file.isEmpty()) {
-        _file = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QStringLiteral("/konsole");
-        QDir().mkpath(_file);
-        _file += QStringLiteral("/bookmarks.xml");
-    }
-
-    KBookmarkManager *manager = new KBookmarkManager(_file, this);
-
     // This constructor is only called with toplevel as true; regardless the
     // fourth argument can not be nullptr as it will crash in BookmarkMenu
     // TODO: remove the toplevel boolean argument in API
-    auto *bookmarkMenu = new BookmarkMenu(manager, this, _menu, collection);
+    auto *bookmarkMenu = new BookmarkMenu(bookmarkManager(), this, _menu, collection);
     bookmarkMenu->setParent(this);
 }
 
+KBookmarkManager *BookmarkHandler::bookmarkManager()
+{
+    static KBookmarkManager *manager = nullptr;
+    if (manager == nullptr) {
+        QString file = QStandardPaths::locate(QStandardPaths::GenericDataLocation, QStringLiteral("konsole/bookmarks.xml"));
+
+        if (file.isEmpty()) {
+            file = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QStringLiteral("/konsole");
+            QDir().mkpath(file);
+            file += QStringLiteral("/bookmarks.xml");
+        }
+
+        manager = new KBookmarkManager(file, QCoreApplication::instance());
+    }
+    return manager;
+}
+
 BookmarkHandler::~BookmarkHandler() = default;
 
 void BookmarkHandler::openBookmark(const KBookmark &bm, Qt::MouseButtons, Qt::KeyboardModifiers)
@@ -53,6 +53,14 @@ public:
     BookmarkHandler(KActionCollection *collection, QMenu *menu, bool toplevel, QObject *parent);
     ~BookmarkHandler() override;
 
+    /**
+     * Returns the bookmark manager shared by all windows. The XBEL file is
+     * parsed once here instead of per window; the manager watches the file
+     * and emits changed(), which marks every window's menu dirty so it
+     * refills on its next aboutToShow.
+     */
+    static KBookmarkManager *bookmarkManager();
+
     QUrl currentUrl() const override;
     QString currentTitle() const override;
     QString currentIcon() const override;
@@ -108,7 +116,6 @@ private:
     QString iconForView(ViewProperties *view) const;
 
     QMenu *_menu;
-    QString _file;
     bool _toplevel;
     ViewProperties *_activeView;
     QList<ViewProperties *> _views;
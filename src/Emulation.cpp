@@ -10,10 +10,14 @@
 #include "Emulation.h"
 
 // Qt
+#include <QGuiApplication>
 #include <QKeyEvent>
+#include <QScreen>
 
 // Konsole
+#include "AllocationTracker.h"
 #include "KonsoleSettings.h"
+#include "PipelineMetrics.h"
 #include "Screen.h"
 #include "ScreenWindow.h"
 #include "keyboardtranslator/KeyboardTranslator.h"
@@ -31,6 +35,13 @@ Emulation::Emulation()
     QObject::connect(&_bulkTimer1, &QTimer::timeout, this, &Konsole::Emulation::showBulk);
     QObject::connect(&_bulkTimer2, &QTimer::timeout, this, &Konsole::Emulation::showBulk);
 
+    // one bell event per window at most; matches the rate TerminalBell
+    // masks to, so coalescing here only removes work, not audible bells
+    static const int BELL_COALESCE_TIMEOUT = 500;
+    _bellTimer.setSingleShot(true);
+    _bellTimer.setInterval(BELL_COALESCE_TIMEOUT);
+    QObject::connect(&_bellTimer, &QTimer::timeout, this, &Konsole::Emulation::flushPendingBells);
+
     // listen for mouse status changes
     connect(this, &Konsole::Emulation::programRequestsMouseTracking, this, &Konsole::Emulation::setUsesMouseTracking);
     connect(this, &Konsole::Emulation::programBracketedPasteModeChanged, this, &Konsole::Emulation::bracketedPasteModeChanged);
@@ -83,6 +94,7 @@ ScreenWindow *Emulation::createWindow()
     connect(window, &Konsole::ScreenWindow::selectionChanged, this, &Konsole::Emulation::checkSelectedText);
 
     connect(this, &Konsole::Emulation::outputChanged, window, &Konsole::ScreenWindow::notifyOutputChanged);
+    connect(this, &Konsole::Emulation::contentsAboutToChange, window, &Konsole::ScreenWindow::contentsAboutToChange);
 
     return window;
 }
@@ -93,6 +105,28 @@ void Emulation::setCurrentTerminalDisplay(TerminalDisplay *display)
     _screen[1]->setCurrentTerminalDisplay(display);
 }
 
+void Emulation::reportBell()
+{
+    // leading edge: the first bell of a burst keeps its latency, the rest
+    // of the window only bumps a counter
+    if (!_bellTimer.isActive()) {
+        Q_EMIT bell(1);
+        _bellTimer.start();
+    } else {
+        _pendingBells++;
+    }
+}
+
+void Emulation::flushPendingBells()
+{
+    if (_pendingBells > 0) {
+        Q_EMIT bell(_pendingBells);
+        _pendingBells = 0;
+        // a sustained flood keeps emitting one summary event per window
+        _bellTimer.start();
+    }
+}
+
 void Emulation::checkScreenInUse()
 {
     Q_EMIT primaryScreenInUse(_currentScreen == _screen[0]);
@@ -152,11 +186,15 @@ void Emulation::clearHistory()
         Q_EMIT updateDroppedLines(_screen[0]->getHistLines());
     }
 
+    Q_EMIT contentsAboutToChange();
+
     _screen[0]->setScroll(_screen[0]->getScroll(), false);
 }
 
 void Emulation::setHistory(const HistoryType &history)
 {
+    Q_EMIT contentsAboutToChange();
+
     _screen[0]->setScroll(history);
 
     showBulk();
@@ -167,6 +205,42 @@ const HistoryType &Emulation::history() const
     return _screen[0]->getScroll();
 }
 
+qint64 Emulation::historySizeBytes() const
+{
+    // only the primary screen keeps a history scroll
+    return _screen[0]->historySizeBytes();
+}
+
+int Emulation::dropOldestHistoryLines(int keepLines)
+{
+    const int dropped = _screen[0]->dropOldestHistoryLines(keepLines);
+    if (dropped > 0) {
+        // the views recompute their scroll range from the new line count
+        bufferedUpdate();
+    }
+    return dropped;
+}
+
+bool Emulation::hibernateHistory(const QString &path)
+{
+    return _screen[0]->hibernateHistory(path);
+}
+
+void Emulation::thawHistory()
+{
+    _screen[0]->thawHistory();
+}
+
+qint64 Emulation::screenBufferSizeBytes() const
+{
+    return _screen[0]->bufferSizeBytes() + _screen[1]->bufferSizeBytes();
+}
+
+void Emulation::setHistorySnapshot(const QString &path)
+{
+    _screen[0]->setHistorySnapshot(path);
+}
+
 bool Emulation::setCodec(const QByteArray &name)
 {
     // if we requested a specific codec, only try that one
@@ -176,6 +250,8 @@ bool Emulation::setCodec(const QByteArray &name)
         if (decoder.isValid() && encoder.isValid()) {
             _decoder = std::move(decoder);
             _encoder = std::move(encoder);
+            _decoderIsUtf8 = utf8();
+            _utf8Need = 0; // drop any partial sequence from the previous codec
             Q_EMIT useUtf8Request(utf8());
             return true;
         }
@@ -235,7 +311,7 @@ void Emulation::receiveChars(const QVector<uint> &chars)
             _currentScreen->toStartOfLine();
             break;
         case 0x07:
-            Q_EMIT bell();
+            reportBell();
             break;
         default:
             _currentScreen->displayCharacter(c);
@@ -259,6 +335,11 @@ void Emulation::sendKeyEvent(QKeyEvent *ev)
     }
 }
 
+void Emulation::cancelOngoingPaste()
+{
+    // only emulations which chunk large pastes have anything to cancel
+}
+
 void Emulation::setSuppressTerminalResponsesDuringReceive(bool suppress)
 {
     _suppressTerminalResponsesDuringReceive = suppress;
@@ -278,8 +359,15 @@ void Emulation::receiveData(const char *text, int length)
 {
     Q_ASSERT(_decoder.isValid());
 
+    PipelineMetrics::ScopedTimer timer(PipelineMetrics::ReceiveDataStage);
+    AllocationTracker::Scope allocationScope(AllocationTracker::TokenizerSubsystem);
+    AllocationTracker::addOutputBytes(length);
+
+    updateReceiveRate(length);
     bufferedUpdate();
 
+    Q_EMIT contentsAboutToChange();
+
     // Allow subclass to intercept raw bytes (e.g. for tmux control mode
     // DCS passthrough where UTF-8 round-tripping through QStringDecoder
     // is lossy at chunk boundaries)
@@ -288,12 +376,82 @@ void Emulation::receiveData(const char *text, int length)
     }
 
     // send characters to terminal emulator
-    const QString readString = _decoder.decode(QByteArrayView(text, length));
-    const QVector<uint> chars = readString.toUcs4();
     _receivingData = true;
-    receiveChars(chars);
+    if (_decoderIsUtf8) {
+        // Decode straight from the PTY read buffer into the reusable
+        // codepoint buffer, skipping the intermediate QString and the
+        // per-chunk toUcs4() allocation.
+        decodeUtf8(text, length);
+        receiveChars(_codepointBuffer);
+    } else {
+        const QString readString = _decoder.decode(QByteArrayView(text, length));
+        receiveChars(readString.toUcs4());
+    }
+    _receivingData = false;
+
+    scanForZModem(text, length);
+}
+
+void Emulation::receiveData(const QList<QByteArray> &buffers)
+{
+    Q_ASSERT(_decoder.isValid());
+
+    PipelineMetrics::ScopedTimer timer(PipelineMetrics::ReceiveDataStage);
+
+    qsizetype total = 0;
+    for (const QByteArray &buffer : buffers) {
+        total += buffer.size();
+    }
+    if (total == 0) {
+        return;
+    }
+
+    AllocationTracker::Scope allocationScope(AllocationTracker::TokenizerSubsystem);
+    AllocationTracker::addOutputBytes(total);
+
+    updateReceiveRate(int(total));
+    bufferedUpdate();
+
+    Q_EMIT contentsAboutToChange();
+
+    _receivingData = true;
+    if (_decoderIsUtf8) {
+        // Decode every buffer into the shared codepoint buffer and run the
+        // tokenizer once over the whole batch, so the framing of the input
+        // costs neither a join allocation nor extra receiveChars() passes.
+        _codepointBuffer.resize(0);
+        if (_codepointBuffer.capacity() < total) {
+            _codepointBuffer.reserve(total);
+        }
+        bool decoded = false;
+        for (const QByteArray &buffer : buffers) {
+            if (buffer.isEmpty() || receiveRawData(buffer.constData(), buffer.size())) {
+                continue;
+            }
+            decodeUtf8Append(buffer.constData(), buffer.size());
+            decoded = true;
+        }
+        if (decoded) {
+            receiveChars(_codepointBuffer);
+        }
+    } else {
+        for (const QByteArray &buffer : buffers) {
+            if (buffer.isEmpty() || receiveRawData(buffer.constData(), buffer.size())) {
+                continue;
+            }
+            const QString readString = _decoder.decode(QByteArrayView(buffer.constData(), buffer.size()));
+            receiveChars(readString.toUcs4());
+        }
+    }
     _receivingData = false;
 
+    for (const QByteArray &buffer : buffers) {
+        scanForZModem(buffer.constData(), buffer.size());
+    }
+}
+
+void Emulation::scanForZModem(const char *text, int length)
+{
     if (KonsoleSettings::listenForZModemTerminalCodes() == false) {
         return;
     }
@@ -319,6 +477,64 @@ void Emulation::receiveData(const char *text, int length)
     }
 }
 
+void Emulation::decodeUtf8(const char *text, int length)
+{
+    _codepointBuffer.resize(0); // keeps the capacity, unlike clear()
+    if (_codepointBuffer.capacity() < length) {
+        _codepointBuffer.reserve(length);
+    }
+
+    decodeUtf8Append(text, length);
+}
+
+void Emulation::decodeUtf8Append(const char *text, int length)
+{
+    int i = 0;
+    while (i < length) {
+        const uchar b = static_cast<uchar>(text[i]);
+
+        if (_utf8Need > 0) {
+            if ((b & 0xC0) == 0x80) {
+                _utf8Acc = (_utf8Acc << 6) | (b & 0x3F);
+                ++i;
+                if (--_utf8Need == 0) {
+                    // reject overlong forms, surrogates and out-of-range values
+                    if (_utf8Acc < _utf8Min || (_utf8Acc >= 0xD800 && _utf8Acc <= 0xDFFF) || _utf8Acc > 0x10FFFF) {
+                        _codepointBuffer.append(0xFFFD);
+                    } else {
+                        _codepointBuffer.append(_utf8Acc);
+                    }
+                }
+            } else {
+                // truncated sequence; re-examine this byte as a new lead byte
+                _utf8Need = 0;
+                _codepointBuffer.append(0xFFFD);
+            }
+            continue;
+        }
+
+        ++i;
+        if (b < 0x80) {
+            _codepointBuffer.append(b);
+        } else if (b >= 0xC2 && b <= 0xDF) {
+            _utf8Acc = b & 0x1F;
+            _utf8Min = 0x80;
+            _utf8Need = 1;
+        } else if (b >= 0xE0 && b <= 0xEF) {
+            _utf8Acc = b & 0x0F;
+            _utf8Min = 0x800;
+            _utf8Need = 2;
+        } else if (b >= 0xF0 && b <= 0xF4) {
+            _utf8Acc = b & 0x07;
+            _utf8Min = 0x10000;
+            _utf8Need = 3;
+        } else {
+            // stray continuation byte or invalid lead (0xC0, 0xC1, 0xF5..0xFF)
+            _codepointBuffer.append(0xFFFD);
+        }
+    }
+}
+
 void Emulation::writeToStream(TerminalCharacterDecoder *decoder, int startLine, int endLine)
 {
     _currentScreen->writeLinesToStream(decoder, startLine, endLine);
@@ -338,25 +554,73 @@ void Emulation::showBulk()
     _bulkTimer2.stop();
 
     Q_EMIT updateDroppedLines(_currentScreen->fastDroppedLines() + _currentScreen->droppedLines());
+    if (PipelineMetrics::enabled()) {
+        PipelineMetrics::instance()->markOutputChanged();
+    }
     Q_EMIT outputChanged();
 
     _currentScreen->resetScrolledLines();
     _currentScreen->resetDroppedLines();
 }
 
+// Debounce interval for busy streams: there is no point in emitting
+// outputChanged() faster than the display can show it.
+static int busyUpdateInterval()
+{
+    static const int interval = []() {
+        if (const QScreen *screen = QGuiApplication::primaryScreen()) {
+            const qreal refreshRate = screen->refreshRate();
+            if (refreshRate > 1.0) {
+                return qBound(5, qRound(1000.0 / refreshRate), 50);
+            }
+        }
+        return 17; // assume 60Hz when the refresh rate is unknown
+    }();
+    return interval;
+}
+
+void Emulation::updateReceiveRate(int length)
+{
+    // Bulk output (cat, build logs) arrives in large back-to-back chunks;
+    // interactive output (keystroke echo, prompts) in small bursts with
+    // pauses in between. Count the bytes seen in a sliding 100ms window and
+    // switch mode on a simple volume threshold, so the decision adds one
+    // clock read per chunk.
+    static const qint64 RATE_WINDOW_MS = 100;
+    static const qint64 BUSY_THRESHOLD_BYTES = 64 * 1024; // per window
+
+    if (!_receiveRateTimer.isValid()) {
+        _receiveRateTimer.start();
+    } else if (_receiveRateTimer.elapsed() > RATE_WINDOW_MS) {
+        _busyOutput = _receiveWindowBytes >= BUSY_THRESHOLD_BYTES;
+        _receiveWindowBytes = 0;
+        _receiveRateTimer.restart();
+    }
+
+    _receiveWindowBytes += length;
+    if (_receiveWindowBytes >= BUSY_THRESHOLD_BYTES) {
+        _busyOutput = true;
+    }
+}
+
 void Emulation::bufferedUpdate()
 {
     if (_synchronizedUpdate)
         return;
 
-    static const int BULK_TIMEOUT1 = 10;
-    static const int BULK_TIMEOUT2 = 40;
+    // Maximum latency before a pending update is shown regardless of
+    // further output arriving.
+    static const int BULK_TIMEOUT_MAX = 40;
+
+    // Interactive echo is flushed on the next timer tick; busy streams are
+    // debounced to the display refresh period.
+    const int debounceTimeout = _busyOutput ? busyUpdateInterval() : 1;
 
     _bulkTimer1.setSingleShot(true);
-    _bulkTimer1.start(BULK_TIMEOUT1);
+    _bulkTimer1.start(debounceTimeout);
     if (!_bulkTimer2.isActive()) {
         _bulkTimer2.setSingleShot(true);
-        _bulkTimer2.start(BULK_TIMEOUT2);
+        _bulkTimer2.start(BULK_TIMEOUT_MAX);
     }
 }
 
@@ -383,6 +647,8 @@ void Emulation::setImageSize(int lines, int columns)
             Q_EMIT imageSizeChanged(lines, columns);
         }
     } else {
+        Q_EMIT contentsAboutToChange();
+
         _screen[0]->resizeImage(lines, columns);
         _screen[1]->resizeImage(lines, columns);
 
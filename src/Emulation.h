@@ -9,6 +9,7 @@
 #define EMULATION_H
 
 // Qt
+#include <QElapsedTimer>
 #include <QSize>
 #include <QStringDecoder>
 #include <QStringEncoder>
@@ -120,8 +121,32 @@ public:
     void setHistory(const HistoryType &);
     /** Returns the history store used by this emulation.  See setHistory() */
     const HistoryType &history() const;
+    /** Approximate number of bytes held by the primary screen's history. */
+    qint64 historySizeBytes() const;
+    /**
+     * Drops the oldest history lines down to @p keepLines where the
+     * backend supports a cheap trim; returns the number of lines dropped.
+     * See Screen::dropOldestHistoryLines().
+     */
+    int dropOldestHistoryLines(int keepLines);
+    /**
+     * Hibernates the primary screen's history to a snapshot at @p path,
+     * freeing its RAM until the next access needing line data.  See
+     * Screen::hibernateHistory().
+     */
+    bool hibernateHistory(const QString &path);
+    /** Restores a hibernated history, if any. */
+    void thawHistory();
+    /** Approximate number of bytes held by both screen images. */
+    qint64 screenBufferSizeBytes() const;
     /** Clears the history scroll. */
     virtual void clearHistory();
+    /**
+     * Keeps an on-disk snapshot of the primary screen's history at
+     * @p path, restoring a previous run's snapshot first if the history
+     * is still empty.  See Screen::setHistorySnapshot().
+     */
+    void setHistorySnapshot(const QString &path);
 
     /**
      * Copies the output history from @p startLine to @p endLine
@@ -170,6 +195,25 @@ public:
     /** Returns the special character used for erasing character. */
     virtual char eraseChar() const;
 
+    /**
+     * Coalescing mode currently used by bufferedUpdate().
+     *
+     * Interactive streams (keystroke echo) are flushed almost immediately;
+     * busy streams (bulk output) are coalesced to roughly the display
+     * refresh period. The mode is chosen adaptively from the measured
+     * incoming byte rate.
+     */
+    enum BufferedUpdateMode {
+        InteractiveUpdate = 0,
+        BusyUpdate = 1,
+    };
+
+    /** Returns the coalescing mode currently used by bufferedUpdate(). */
+    BufferedUpdateMode bufferedUpdateMode() const
+    {
+        return _busyOutput ? BusyUpdate : InteractiveUpdate;
+    }
+
     /**
      * Sets the key bindings used to key events
      * ( received through sendKeyEvent() ) into character
@@ -219,6 +263,13 @@ public Q_SLOTS:
      */
     virtual void sendText(const QString &text) = 0;
 
+    /**
+     * Cancels a large paste which is still being fed to the terminal
+     * in chunks.  Text which has not yet been sent is discarded.
+     * The base implementation does nothing.
+     */
+    virtual void cancelOngoingPaste();
+
     /**
      * Interprets a key press event and emits the sendData() signal with
      * the resulting character stream.
@@ -269,6 +320,14 @@ public Q_SLOTS:
      */
     void receiveData(const char *text, int length);
 
+    /**
+     * Scatter-gather variant of receiveData(). Each buffer is decoded in
+     * sequence into a single batch of characters, so already-framed input
+     * (e.g. decoded tmux %output notifications) is processed in one pass
+     * without first being joined into an intermediate allocation.
+     */
+    void receiveData(const QList<QByteArray> &buffers);
+
     /**
      * Sends information about the focus event to the terminal.
      */
@@ -286,6 +345,13 @@ Q_SIGNALS:
      */
     void sendData(const QByteArray &data);
 
+    /**
+     * Emitted periodically while a large paste is being fed to the
+     * terminal in chunks.  @p percent reaches 100 when the last chunk
+     * has been sent or the paste was cancelled.
+     */
+    void pasteProgress(int percent);
+
     /**
      * Requests that the pty used by the terminal process
      * be set to UTF 8 mode.
@@ -295,9 +361,12 @@ Q_SIGNALS:
     void useUtf8Request(bool);
 
     /**
-     * Emitted when bell appeared
+     * Emitted when bell appeared.  @p count is the number of bell
+     * characters folded into this event; repeat bells arriving within a
+     * short window are coalesced by reportBell() before they cross into
+     * notification and repaint work.
      */
-    void bell();
+    void bell(int count);
 
     /**
      * Emitted when the special sequence indicating the request for data
@@ -338,6 +407,17 @@ Q_SIGNALS:
      */
     void outputChanged();
 
+    /**
+     * Emitted just before the contents of the screens are modified - when
+     * new data is about to be processed, when the image is about to be
+     * resized and when the history is about to be cleared or trimmed.
+     *
+     * Listeners which hold character indexes into a screen (such as the
+     * lazy clipboard data, see SelectionMimeData) use this to read the
+     * text they refer to while it is still intact.
+     */
+    void contentsAboutToChange();
+
     /**
      * Emitted when the program running in the terminal wishes to update
      * certain session attributes. This allows terminal programs to customize
@@ -413,6 +493,21 @@ Q_SIGNALS:
      */
     void primaryScreenInUse(bool use);
 
+    /**
+     * Emitted when shell integration (OSC 133) reports that a command
+     * started producing output.
+     */
+    void commandExecutionStarted();
+
+    /**
+     * Emitted when shell integration (OSC 133) reports that a command
+     * finished.
+     *
+     * @param exitCode The exit status reported by the shell, or 0 when the
+     * mark did not carry one.
+     */
+    void commandExecutionFinished(int exitCode);
+
     /**
      * Emitted when the text selection is changed
      */
@@ -542,6 +637,15 @@ protected Q_SLOTS:
      */
     void bufferedUpdate();
 
+    /**
+     * Registers a bell character.  The first bell of a burst is signalled
+     * immediately; further bells within the coalescing window are only
+     * counted and delivered as one follow-up bell(int) emission, so a
+     * program ringing the bell per output line cannot flood the UI with
+     * per-event notification work.
+     */
+    void reportBell();
+
     // used to emit the primaryScreenInUse(bool) signal
     void checkScreenInUse();
 
@@ -559,15 +663,53 @@ private Q_SLOTS:
 
     void synchronizedUpdateChanged(bool inProgress);
 
+    // triggered by _bellTimer; emits the bells accumulated by
+    // reportBell() since the leading emission as one bell(int) event
+    void flushPendingBells();
+
 private:
     void setScreenInternal(int index);
+
+    // Streaming UTF-8 decode used by receiveData(). Decodes straight from
+    // the PTY read buffer into the reusable _codepointBuffer; an incomplete
+    // multi-byte sequence at the end of a chunk carries over to the next call.
+    void decodeUtf8(const char *text, int length);
+
+    // Appends the decoded form of one buffer to _codepointBuffer; the
+    // scatter-gather receiveData() uses this to fold several buffers into
+    // one receiveChars() batch.
+    void decodeUtf8Append(const char *text, int length);
+
+    // Emits the zmodem indicator signals when @p text contains the markers.
+    void scanForZModem(const char *text, int length);
+
+    // Feeds the incoming byte rate estimate used to pick the coalescing
+    // mode reported by bufferedUpdateMode().
+    void updateReceiveRate(int length);
+
     Q_DISABLE_COPY(Emulation)
 
+    // Reused across receiveData() calls so steady-state decoding does not
+    // allocate; grown once to the largest chunk seen.
+    QVector<uint> _codepointBuffer;
+    uint _utf8Acc = 0;
+    uint _utf8Min = 0;
+    int _utf8Need = 0;
+    bool _decoderIsUtf8 = false;
+
+    // Incoming byte rate tracking for the adaptive bufferedUpdate() modes
+    QElapsedTimer _receiveRateTimer;
+    qint64 _receiveWindowBytes = 0;
+    bool _busyOutput = false;
+
     bool _usesMouseTracking = false;
     bool _bracketedPasteMode = false;
     bool _synchronizedUpdate = false;
     QTimer _bulkTimer1{this};
     QTimer _bulkTimer2{this};
+    // bell coalescing state used by reportBell()
+    QTimer _bellTimer{this};
+    int _pendingBells = 0;
     bool _imageSizeInitialized = false;
     bool _peekingPrimary = false;
     int _activeScreenIndex = 0;
@@ -13,6 +13,10 @@
 
 namespace Konsole
 {
+// upper bound on stored hyperlink records; at roughly a hundred bytes
+// per record this caps the extractor at about a megabyte per session
+static constexpr int MaxHistoryUrls = 10240;
+
 EscapeSequenceUrlExtractor::EscapeSequenceUrlExtractor() = default;
 
 void Konsole::EscapeSequenceUrlExtractor::setScreen(Konsole::Screen *screen)
@@ -72,14 +76,50 @@ void EscapeSequenceUrlExtractor::endUrlInput()
     const int realCcolumn = _screen->getCursorY() + _screen->getHistLines();
     const auto currentPos = Coordinate{realCcolumn, _screen->getCursorX()};
     _currentUrl.end = currentPos;
+    _currentUrl.url = internString(_currentUrl.url);
+    _currentUrl.text = internString(_currentUrl.text);
     _history.append(_currentUrl);
 
+    // drop the oldest, deepest-in-history records once over the cap
+    if (_history.size() > MaxHistoryUrls) {
+        _history.remove(0, _history.size() - MaxHistoryUrls);
+        compactInternPool();
+    }
+
     _currentUrl = ExtractedUrl{};
 }
 
+QString EscapeSequenceUrlExtractor::internString(const QString &text)
+{
+    const auto it = _internPool.constFind(text);
+    if (it != _internPool.constEnd()) {
+        return *it;
+    }
+    _internPool.insert(text);
+    return text;
+}
+
+void EscapeSequenceUrlExtractor::compactInternPool()
+{
+    // two strings per record is the upper bound of what can still be
+    // referenced; a pool well past that is mostly evicted records
+    if (_internPool.size() <= 2 * _history.size() + 64) {
+        return;
+    }
+
+    QSet<QString> pool;
+    pool.reserve(2 * _history.size());
+    for (const auto &url : std::as_const(_history)) {
+        pool.insert(url.url);
+        pool.insert(url.text);
+    }
+    _internPool = pool;
+}
+
 void EscapeSequenceUrlExtractor::clear()
 {
     _history.clear();
+    _internPool.clear();
 }
 
 void EscapeSequenceUrlExtractor::clearBetween(int loca, int loce)
@@ -90,6 +130,7 @@ void EscapeSequenceUrlExtractor::clearBetween(int loca, int loce)
 
         return (loca <= beginLoc && beginLoc <= loce) || (loca <= endLoc && endLoc <= loce);
     });
+    compactInternPool();
 }
 
 void EscapeSequenceUrlExtractor::setAllowedLinkSchema(const QStringList &schema)
@@ -110,6 +151,7 @@ void EscapeSequenceUrlExtractor::historyLinesRemoved(int lines)
                                       return toRemove;
                                   }),
                    std::end(_history));
+    compactInternPool();
 }
 
 QVector<ExtractedUrl> EscapeSequenceUrlExtractor::history() const
@@ -9,6 +9,7 @@
 */
 
 #include <QObject>
+#include <QSet>
 
 #include "konsoleprivate_export.h"
 
@@ -52,15 +53,19 @@ private:
     /* The url / text pair being extracted currently */
     ExtractedUrl _currentUrl{};
 
-    /* The maximum size of url to prevent a bomb
-     * that will take over the history file.
-     * TODO: make it configurable.
+    /* All of the extracted URL's, oldest first.  Capped (see
+     * MaxHistoryUrls in the implementation) so that a hyperlink per
+     * line of a huge build cannot grow the session without bound;
+     * records whose lines scroll off the history are dropped by
+     * historyLinesRemoved().
      */
-    // Not used ATM const int _maximumUrlHistory = 200;
-
-    /* All of the extracted URL's. */
     QVector<ExtractedUrl> _history;
 
+    /* Shared storage for repeated url / text strings; build systems
+     * tend to emit the same hyperlink on thousands of lines.
+     */
+    QSet<QString> _internPool;
+
     /* The URI schema format that's accepted */
     QStringList _allowedUriSchemas;
 
@@ -69,6 +74,14 @@ private:
 
     void appendUrlText_impl(uint c);
 
+    /* Returns the pooled copy of @p text, so equal strings share one
+     * allocation. */
+    QString internString(const QString &text);
+
+    /* Rebuilds the intern pool when removals left it much larger than
+     * the strings still referenced. */
+    void compactInternPool();
+
 public:
     /* This needs to have access to the Session
      * calculate the row / col of the current URL.
@@ -9,10 +9,13 @@
 
 // Qt
 #include <QAction>
+#include <QCoreApplication>
 #include <QDir>
 #include <QKeyEvent>
 #include <QMetaEnum>
+#include <QPointer>
 #include <QStringList>
+#include <QTimer>
 #include <QUrl>
 
 // KDE
@@ -37,7 +40,51 @@
 
 using namespace Konsole;
 
-K_PLUGIN_FACTORY_WITH_JSON(KonsolePartFactory, "konsolepart.json", registerPlugin<Konsole::Part>();)
+K_PLUGIN_FACTORY_WITH_JSON(KonsolePartFactory, "konsolepart.json", registerPlugin<Konsole::Part>(&Konsole::Part::createWithPool);)
+
+// A single part constructed ahead of time once the host has embedded its
+// first terminal, so the next one is handed out without any construction
+// work.  Parented to the application while pooled, so teardown reclaims
+// it; the pty is only spawned later by startProgram()/showShellInDir(),
+// which keeps a pooled skeleton cheap to hold.
+static QPointer<Part> s_pooledPart;
+static bool s_warmScheduled = false;
+
+// Delay before pre-warming, so part construction does not compete with
+// the host finishing its own startup or first paint.
+static const int PartPoolWarmDelay = 1000; // ms
+
+static void scheduleWarmPart()
+{
+    if (s_warmScheduled || !s_pooledPart.isNull()) {
+        return;
+    }
+    s_warmScheduled = true;
+    QTimer::singleShot(PartPoolWarmDelay, QCoreApplication::instance(), []() {
+        s_warmScheduled = false;
+        if (s_pooledPart.isNull()) {
+            s_pooledPart = new Part(QCoreApplication::instance(), QVariantList());
+        }
+    });
+}
+
+QObject *Part::createWithPool(QWidget *parentWidget, QObject *parent, const KPluginMetaData &metaData, const QVariantList &args)
+{
+    Q_UNUSED(parentWidget)
+    Q_UNUSED(metaData)
+
+    Part *part;
+    if (s_pooledPart.isNull()) {
+        part = new Part(parent, args);
+    } else {
+        part = s_pooledPart.data();
+        s_pooledPart.clear();
+        part->setParent(parent);
+    }
+
+    scheduleWarmPart();
+    return part;
+}
 
 Part::Part(QObject *parent, const QVariantList &)
     : KParts::ReadOnlyPart(parent)
@@ -19,6 +19,7 @@
 #include "session/Session.h"
 
 class QKeyEvent;
+class KPluginMetaData;
 
 namespace Konsole
 {
@@ -40,6 +41,14 @@ public:
     explicit Part(QObject *parent, const QVariantList &);
     ~Part() override;
 
+    /**
+     * Factory creator that serves embedding hosts from a pre-warmed pool.
+     * After handing out a part it constructs the next one in idle time, so
+     * every embedded terminal after the first skips profile load and view
+     * setup and appears instantly.
+     */
+    static QObject *createWithPool(QWidget *parentWidget, QObject *parent, const KPluginMetaData &metaData, const QVariantList &args);
+
     /** Reimplemented from TerminalInterface. */
     void startProgram(const QString &program, const QStringList &arguments) override;
     /** Reimplemented from TerminalInterface. */
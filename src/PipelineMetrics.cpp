@@ -0,0 +1,302 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "PipelineMetrics.h"
+
+// Konsole
+#include "AllocationTracker.h"
+
+// Qt
+#include <QAbstractEventDispatcher>
+#include <QDBusConnection>
+
+namespace Konsole
+{
+bool PipelineMetrics::s_enabled = qEnvironmentVariableIntValue("KONSOLE_PIPELINE_METRICS") == 1;
+
+static const char *const stageLabels[PipelineMetrics::StageCount] = {
+    "PtyRead",
+    "ReceiveData",
+    "NotifyDelay",
+    "UpdateImage",
+    "PaintEvent",
+    "GatewayRoundTrip",
+};
+
+// label for the stall-attribution slot no stage accounts for
+static const char *const otherLabel = "Other";
+
+static int bucketFor(qint64 nsecs)
+{
+    const qint64 usecs = nsecs / 1000;
+    int bucket = 0;
+    while (bucket < PipelineMetrics::BucketCount - 1 && (qint64(1) << bucket) <= usecs) {
+        bucket++;
+    }
+    return bucket;
+}
+
+PipelineMetrics *PipelineMetrics::instance()
+{
+    static PipelineMetrics self;
+    return &self;
+}
+
+PipelineMetrics::PipelineMetrics()
+    : m_overlayEnabled(qEnvironmentVariableIntValue("KONSOLE_PIPELINE_OVERLAY") == 1)
+{
+    for (auto &stage : m_buckets) {
+        stage.fill(0);
+    }
+    m_sampleCount.fill(0);
+    for (auto &stage : m_stallBuckets) {
+        stage.fill(0);
+    }
+    m_stallCount.fill(0);
+    m_iterationStageNsecs.fill(0);
+    m_clock.start();
+
+    // the singleton is first touched from a GUI-thread call site, so this
+    // watches the GUI thread's dispatcher
+    if (auto *dispatcher = QAbstractEventDispatcher::instance()) {
+        connect(dispatcher, &QAbstractEventDispatcher::awake, this, &PipelineMetrics::eventLoopAwake);
+        connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this, &PipelineMetrics::eventLoopAboutToBlock);
+    }
+
+    QDBusConnection::sessionBus().registerObject(QStringLiteral("/Metrics"), this, QDBusConnection::ExportScriptableContents | QDBusConnection::ExportAllSlots);
+}
+
+void PipelineMetrics::record(Stage stage, qint64 nsecs)
+{
+    m_buckets[stage][bucketFor(nsecs)]++;
+    m_sampleCount[stage]++;
+}
+
+void PipelineMetrics::recordScope(Stage stage, qint64 nsecs)
+{
+    record(stage, nsecs);
+    m_iterationStageNsecs[stage] += nsecs;
+}
+
+void PipelineMetrics::eventLoopAwake()
+{
+    m_iterationStartNsecs = m_clock.nsecsElapsed();
+    m_iterationStageNsecs.fill(0);
+}
+
+void PipelineMetrics::eventLoopAboutToBlock()
+{
+    if (m_iterationStartNsecs < 0) {
+        return;
+    }
+    const qint64 elapsed = m_clock.nsecsElapsed() - m_iterationStartNsecs;
+    m_iterationStartNsecs = -1;
+
+    if (elapsed <= StallThresholdNsecs) {
+        return;
+    }
+
+    // charge the stall to the stage that dominated the iteration; an
+    // iteration no instrumented scope ran in (or one dominated by
+    // uninstrumented work such as a D-Bus handler) goes to "Other"
+    int attributed = StageCount;
+    qint64 longest = 0;
+    for (int stage = 0; stage < StageCount; stage++) {
+        if (m_iterationStageNsecs[stage] > longest) {
+            longest = m_iterationStageNsecs[stage];
+            attributed = stage;
+        }
+    }
+    m_stallBuckets[attributed][bucketFor(elapsed)]++;
+    m_stallCount[attributed]++;
+}
+
+void PipelineMetrics::markOutputChanged()
+{
+    // Only the first pending notification counts; updateImage() serves all
+    // of them at once.
+    if (m_outputChangedNsecs < 0) {
+        m_outputChangedNsecs = m_clock.nsecsElapsed();
+    }
+}
+
+void PipelineMetrics::recordUpdateImageStart()
+{
+    if (m_outputChangedNsecs >= 0) {
+        record(NotifyDelayStage, m_clock.nsecsElapsed() - m_outputChangedNsecs);
+        m_outputChangedNsecs = -1;
+    }
+}
+
+void PipelineMetrics::recordGatewayBytesIn(qint64 bytes)
+{
+    m_gatewayBytesIn += bytes;
+}
+
+void PipelineMetrics::recordGatewayBytesOut(qint64 bytes)
+{
+    m_gatewayBytesOut += bytes;
+}
+
+void PipelineMetrics::recordGatewayQueueDepth(int depth)
+{
+    m_gatewayQueueDepth = depth;
+    m_gatewayQueueDepthMax = qMax(m_gatewayQueueDepthMax, depth);
+}
+
+bool PipelineMetrics::overlayEnabled() const
+{
+    return m_overlayEnabled;
+}
+
+QString PipelineMetrics::overlayText() const
+{
+    QString text;
+    for (int stage = 0; stage < StageCount; stage++) {
+        if (m_sampleCount[stage] == 0) {
+            continue;
+        }
+        text += QString::asprintf("%-12s p50 %6lld us  p99 %6lld us  n %llu\n",
+                                  stageLabels[stage],
+                                  percentile(Stage(stage), 0.50),
+                                  percentile(Stage(stage), 0.99),
+                                  m_sampleCount[stage]);
+    }
+    return text;
+}
+
+QStringList PipelineMetrics::stageNames() const
+{
+    QStringList names;
+    for (const char *label : stageLabels) {
+        names.append(QLatin1String(label));
+    }
+    return names;
+}
+
+QList<quint64> PipelineMetrics::histogram(const QString &stageName) const
+{
+    QList<quint64> counts;
+    for (int stage = 0; stage < StageCount; stage++) {
+        if (stageName == QLatin1String(stageLabels[stage])) {
+            for (quint64 count : m_buckets[stage]) {
+                counts.append(count);
+            }
+            break;
+        }
+    }
+    return counts;
+}
+
+QList<quint64> PipelineMetrics::stallHistogram(const QString &stageName) const
+{
+    QList<quint64> counts;
+    for (int slot = 0; slot < AttributionCount; slot++) {
+        const char *label = slot < StageCount ? stageLabels[slot] : otherLabel;
+        if (stageName == QLatin1String(label)) {
+            for (quint64 count : m_stallBuckets[slot]) {
+                counts.append(count);
+            }
+            break;
+        }
+    }
+    return counts;
+}
+
+QString PipelineMetrics::stallReport() const
+{
+    QString text = QStringLiteral("stage, stalls, p50 us, p99 us\n");
+    for (int slot = 0; slot < AttributionCount; slot++) {
+        text += QString::asprintf("%s, %llu, %lld, %lld\n",
+                                  slot < StageCount ? stageLabels[slot] : otherLabel,
+                                  m_stallCount[slot],
+                                  percentileOf(m_stallBuckets[slot], m_stallCount[slot], 0.50),
+                                  percentileOf(m_stallBuckets[slot], m_stallCount[slot], 0.99));
+    }
+    return text;
+}
+
+QString PipelineMetrics::report() const
+{
+    QString text = QStringLiteral("stage, samples, p50 us, p90 us, p99 us\n");
+    for (int stage = 0; stage < StageCount; stage++) {
+        text += QString::asprintf("%s, %llu, %lld, %lld, %lld\n",
+                                  stageLabels[stage],
+                                  m_sampleCount[stage],
+                                  percentile(Stage(stage), 0.50),
+                                  percentile(Stage(stage), 0.90),
+                                  percentile(Stage(stage), 0.99));
+    }
+    // empty unless built with -DKONSOLE_ALLOCATION_TRACKING=ON
+    const QString allocations = AllocationTracker::report();
+    if (!allocations.isEmpty()) {
+        text += allocations + QLatin1Char('\n');
+    }
+    return text;
+}
+
+QString PipelineMetrics::gatewayReport() const
+{
+    return QString::asprintf("commands %llu, p50 %lld us, p99 %lld us, bytes in %llu, bytes out %llu, queue depth %d, queue depth max %d\n",
+                             m_sampleCount[GatewayRoundTripStage],
+                             percentile(GatewayRoundTripStage, 0.50),
+                             percentile(GatewayRoundTripStage, 0.99),
+                             m_gatewayBytesIn,
+                             m_gatewayBytesOut,
+                             m_gatewayQueueDepth,
+                             m_gatewayQueueDepthMax);
+}
+
+void PipelineMetrics::reset()
+{
+    for (auto &stage : m_buckets) {
+        stage.fill(0);
+    }
+    m_sampleCount.fill(0);
+    for (auto &stage : m_stallBuckets) {
+        stage.fill(0);
+    }
+    m_stallCount.fill(0);
+    m_gatewayBytesIn = 0;
+    m_gatewayBytesOut = 0;
+    m_gatewayQueueDepth = 0;
+    m_gatewayQueueDepthMax = 0;
+    m_outputChangedNsecs = -1;
+    AllocationTracker::reset();
+}
+
+void PipelineMetrics::setOverlayEnabled(bool enabled)
+{
+    m_overlayEnabled = enabled;
+}
+
+qint64 PipelineMetrics::percentile(Stage stage, double fraction) const
+{
+    return percentileOf(m_buckets[stage], m_sampleCount[stage], fraction);
+}
+
+qint64 PipelineMetrics::percentileOf(const std::array<quint64, BucketCount> &buckets, quint64 samples, double fraction)
+{
+    if (samples == 0) {
+        return 0;
+    }
+
+    const quint64 target = quint64(double(samples) * fraction);
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BucketCount; bucket++) {
+        seen += buckets[bucket];
+        if (seen > target) {
+            // Report the upper bound of the bucket the sample fell into.
+            return bucket == 0 ? 1 : (qint64(1) << bucket);
+        }
+    }
+    return qint64(1) << (BucketCount - 1);
+}
+
+}
+
+#include "moc_PipelineMetrics.cpp"
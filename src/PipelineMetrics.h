@@ -0,0 +1,176 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PIPELINEMETRICS_H
+#define PIPELINEMETRICS_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+
+#include <array>
+
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+/**
+ * Collects per-stage timing histograms for the output pipeline: PTY read,
+ * emulation, the delay between outputChanged() and the view picking it up,
+ * updateImage() and paintEvent().
+ *
+ * Collection is off by default and enabled with KONSOLE_PIPELINE_METRICS=1
+ * in the environment; the enabled() check at the call sites is a single
+ * static bool so the instrumentation costs nothing when off. Results are
+ * exported on the session bus at /Metrics (org.kde.konsole.PipelineMetrics)
+ * so builds can be compared under production load without attaching a
+ * profiler, and an on-screen overlay with the same numbers can be toggled
+ * with KONSOLE_PIPELINE_OVERLAY=1 or over D-Bus.
+ *
+ * Doubles as a stall watchdog: the event dispatcher's awake() and
+ * aboutToBlock() signals bound each event-loop iteration, and an iteration
+ * longer than StallThresholdNsecs is counted against the instrumented
+ * stage that consumed the most time in it (or "Other" when none did).
+ * The per-stage stall histograms turn "Konsole froze" reports into a
+ * statement of which subsystem was running; see stallReport().
+ *
+ * All stages run on the GUI thread, so no locking is needed.
+ */
+class KONSOLEPRIVATE_EXPORT PipelineMetrics : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.konsole.PipelineMetrics")
+
+public:
+    enum Stage {
+        PtyReadStage = 0, // Session::onReceiveBlock
+        ReceiveDataStage, // Emulation::receiveData
+        NotifyDelayStage, // outputChanged() emission until updateImage() runs
+        UpdateImageStage, // TerminalDisplay::updateImage
+        PaintEventStage, // TerminalDisplay::paintEvent
+        GatewayRoundTripStage, // TmuxGateway command send until %end/%error
+        StageCount,
+    };
+
+    // Durations are binned into power-of-two microsecond buckets:
+    // bucket 0 is <1us, bucket i covers [2^(i-1), 2^i) us.
+    static const int BucketCount = 24;
+
+    // an event-loop iteration longer than this misses a 60Hz frame and
+    // counts as a stall
+    static const qint64 StallThresholdNsecs = 16 * 1000 * 1000;
+
+    static PipelineMetrics *instance();
+
+    static bool enabled()
+    {
+        return s_enabled;
+    }
+
+    /** Adds one sample of @p nsecs to the histogram of @p stage. */
+    void record(Stage stage, qint64 nsecs);
+
+    /**
+     * Like record(), but additionally attributes @p nsecs to @p stage
+     * within the current event-loop iteration, so a stall can name the
+     * stage that dominated it.  Used by ScopedTimer, whose scopes are the
+     * GUI-thread work an iteration spends its time in; spans that cross
+     * iterations (notify delay, gateway round trips) go through record().
+     */
+    void recordScope(Stage stage, qint64 nsecs);
+
+    /** Called where outputChanged() is emitted, to time the notify delay. */
+    void markOutputChanged();
+
+    /** Called at the top of updateImage(); folds the pending notify mark. */
+    void recordUpdateImageStart();
+
+    /** Tracks tmux gateway traffic; round trips go through record(). */
+    void recordGatewayBytesIn(qint64 bytes);
+    void recordGatewayBytesOut(qint64 bytes);
+    void recordGatewayQueueDepth(int depth);
+
+    bool overlayEnabled() const;
+
+    /** Short per-stage p50/p99 summary drawn by the on-screen overlay. */
+    QString overlayText() const;
+
+    /**
+     * Measures the enclosing scope into @p stage; no-op while collection
+     * is disabled.
+     */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Stage stage)
+            : m_stage(stage)
+        {
+            if (PipelineMetrics::enabled()) {
+                m_timer.start();
+            }
+        }
+
+        ~ScopedTimer()
+        {
+            if (PipelineMetrics::enabled()) {
+                PipelineMetrics::instance()->recordScope(m_stage, m_timer.nsecsElapsed());
+            }
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        Stage m_stage;
+        QElapsedTimer m_timer;
+    };
+
+public Q_SLOTS:
+    // D-Bus interface
+    QStringList stageNames() const;
+    QList<quint64> histogram(const QString &stageName) const;
+    /** Stall durations for @p stageName, binned like histogram(); "Other" covers unattributed stalls. */
+    QList<quint64> stallHistogram(const QString &stageName) const;
+    QString report() const;
+    QString stallReport() const;
+    QString gatewayReport() const;
+    void reset();
+    void setOverlayEnabled(bool enabled);
+
+private:
+    PipelineMetrics();
+
+    // stalls no instrumented stage accounts for land in the extra slot
+    static const int AttributionCount = StageCount + 1;
+
+    void eventLoopAwake();
+    void eventLoopAboutToBlock();
+
+    qint64 percentile(Stage stage, double fraction) const;
+    static qint64 percentileOf(const std::array<quint64, BucketCount> &buckets, quint64 samples, double fraction);
+
+    static bool s_enabled;
+
+    std::array<std::array<quint64, BucketCount>, StageCount> m_buckets;
+    std::array<quint64, StageCount> m_sampleCount;
+    std::array<std::array<quint64, BucketCount>, AttributionCount> m_stallBuckets;
+    std::array<quint64, AttributionCount> m_stallCount;
+    // per-stage time inside the current event-loop iteration, reset on awake()
+    std::array<qint64, StageCount> m_iterationStageNsecs;
+    qint64 m_iterationStartNsecs = -1;
+    quint64 m_gatewayBytesIn = 0;
+    quint64 m_gatewayBytesOut = 0;
+    int m_gatewayQueueDepth = 0;
+    int m_gatewayQueueDepthMax = 0;
+    qint64 m_outputChangedNsecs = -1;
+    QElapsedTimer m_clock;
+    bool m_overlayEnabled = false;
+};
+
+}
+
+#endif
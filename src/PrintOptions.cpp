@@ -21,6 +21,7 @@ PrintOptions::PrintOptions(QWidget *parent)
     KConfigGroup configGroup(KSharedConfig::openConfig(), QStringLiteral("PrintOptions"));
     printerFriendly->setChecked(configGroup.readEntry("PrinterFriendly", true));
     scaleOutput->setChecked(configGroup.readEntry("ScaleOutput", true));
+    printScrollback->setChecked(configGroup.readEntry("PrintScrollback", false));
 }
 
 PrintOptions::~PrintOptions() = default;
@@ -30,6 +31,7 @@ void PrintOptions::saveSettings()
     KConfigGroup configGroup(KSharedConfig::openConfig(), QStringLiteral("PrintOptions"));
     configGroup.writeEntry("PrinterFriendly", printerFriendly->isChecked());
     configGroup.writeEntry("ScaleOutput", scaleOutput->isChecked());
+    configGroup.writeEntry("PrintScrollback", printScrollback->isChecked());
 }
 
 #include "moc_PrintOptions.cpp"
@@ -78,12 +78,14 @@ ProcessInfo::ProcessInfo(int pid)
     , _parentPid(0)
     , _foregroundPid(0)
     , _userId(0)
+    , _startTime(0)
     , _lastError(NoError)
     , _name(QString())
     , _userName(QString())
     , _userHomeDir(QString())
     , _currentDir(QString())
-    , _userNameRequired(true)
+    , _userNameRead(false)
+    , _argumentsRead(false)
     , _arguments(QVector<QString>())
 {
 }
@@ -106,8 +108,14 @@ void ProcessInfo::update()
 
 void ProcessInfo::refreshArguments()
 {
+    // argv cannot change once the process has called exec, and instances
+    // are cached per (pid, start time), i.e. per exec -- so a single
+    // read remains valid for the lifetime of this instance
+    if (_argumentsRead) {
+        return;
+    }
     clearArguments();
-    readArguments(_pid);
+    _argumentsRead = readArguments(_pid);
 }
 
 QString ProcessInfo::validCurrentDir() const
@@ -224,13 +232,30 @@ int ProcessInfo::userId(bool *ok) const
     return _userId;
 }
 
-QString ProcessInfo::userName() const
+qulonglong ProcessInfo::startTime(bool *ok) const
 {
+    *ok = _fields.testFlag(START_TIME);
+
+    return _startTime;
+}
+
+QString ProcessInfo::userName()
+{
+    // resolved lazily on first access: looking the name up hits the
+    // account database, which is wasted work during periodic refreshes
+    // when nothing displays it.  The flag is set before the read so a
+    // failed lookup is not retried on every call.
+    if (!_userNameRead) {
+        _userNameRead = true;
+        readUserName();
+    }
     return _userName;
 }
 
-QString ProcessInfo::userHomeDir() const
+QString ProcessInfo::userHomeDir()
 {
+    // the home directory is derived from the lazily-read user name
+    userName();
     return _userHomeDir;
 }
 
@@ -251,17 +276,28 @@ void ProcessInfo::setUserId(int uid)
     _fields |= UID;
 }
 
+void ProcessInfo::setStartTime(qulonglong startTime)
+{
+    // a different start time means the pid was reused, so the cached
+    // user name belongs to another process
+    if (_fields.testFlag(START_TIME) && _startTime != startTime) {
+        _userNameRead = false;
+    }
+    _startTime = startTime;
+    _fields |= START_TIME;
+}
+
 void ProcessInfo::setUserName(const QString &name)
 {
     _userName = name;
+    _userNameRead = true;
     setUserHomeDir();
 }
 
 void ProcessInfo::setUserHomeDir()
 {
-    const QString &usersName = userName();
-    if (!usersName.isEmpty()) {
-        _userHomeDir = KUser(usersName).homeDir();
+    if (!_userName.isEmpty()) {
+        _userHomeDir = KUser(_userName).homeDir();
     } else {
         _userHomeDir = QDir::homePath();
     }
@@ -279,16 +315,6 @@ void ProcessInfo::setForegroundPid(int pid)
     _fields |= FOREGROUND_PID;
 }
 
-void ProcessInfo::setUserNameRequired(bool need)
-{
-    _userNameRequired = need;
-}
-
-bool ProcessInfo::userNameRequired() const
-{
-    return _userNameRequired;
-}
-
 QString ProcessInfo::currentDir(bool *ok) const
 {
     if (ok != nullptr) {
@@ -492,10 +518,12 @@ private:
         const int PARENT_PID_FIELD = 3;
         const int PROCESS_NAME_FIELD = 1;
         const int GROUP_PROCESS_FIELD = 7;
+        const int START_TIME_FIELD = 21;
 
         QString parentPidString;
         QString processNameString;
         QString foregroundPidString;
+        QString startTimeString;
         QString uidLine;
         QString uidString;
         QStringList uidStrings;
@@ -528,11 +556,6 @@ private:
             if (ok) {
                 setUserId(uid);
             }
-            // This will cause constant opening of /etc/passwd
-            if (userNameRequired()) {
-                readUserName();
-                setUserNameRequired(false);
-            }
         } else {
             setFileError(statusInfo.error());
             return false;
@@ -576,6 +599,9 @@ private:
                     case GROUP_PROCESS_FIELD:
                         foregroundPidString.append(c);
                         break;
+                    case START_TIME_FIELD:
+                        startTimeString.append(c);
+                        break;
                     }
                 }
 
@@ -598,6 +624,13 @@ private:
             setParentPid(parentPid);
         }
 
+        // the (pid, start time) pair identifies this process even if the
+        // pid is later reused; see ProcessInfo::startTime()
+        const qulonglong startTime = startTimeString.toULongLong(&ok);
+        if (ok) {
+            setStartTime(startTime);
+        }
+
         if (!processNameString.isEmpty()) {
             setName(processNameString);
         }
@@ -975,8 +1008,6 @@ private:
         setUserId(kInfoProc->ki_uid);
 #endif
 
-        readUserName();
-
         return true;
     }
 
@@ -1234,11 +1265,6 @@ private:
             if (ret == sizeof(bsdinfo)) {
                 setUserId(bsdinfo.pbsi_uid);
             }
-            // This will cause constant opening of /etc/passwd
-            if (userNameRequired()) {
-                readUserName();
-                setUserNameRequired(false);
-            }
         }
 
         return true;
@@ -83,7 +83,10 @@ public:
     void update();
 
     /**
-     * Reads the most recent arguments passed to the process.
+     * Ensures the arguments passed to the process have been read.
+     * Since argv cannot change after exec and instances are cached per
+     * (pid, start time), the arguments are read at most once per
+     * instance; later calls are free.
      */
     void refreshArguments();
 
@@ -116,11 +119,26 @@ public:
     /* Returns the user id of the process */
     int userId(bool *ok) const;
 
-    /** Returns the user's name of the process */
-    QString userName() const;
+    /**
+     * Returns the time the process started after system boot, in clock
+     * ticks, as reported by the kernel.  Together with the pid this
+     * uniquely identifies a process, so it can be used to detect pid
+     * reuse when caching ProcessInfo instances.  Only available on
+     * platforms whose readProcessInfo() implementation provides it.
+     */
+    qulonglong startTime(bool *ok) const;
+
+    /**
+     * Returns the user's name of the process.
+     *
+     * The name is resolved lazily on the first call and cached for the
+     * lifetime of the (pid, start time) pair; periodic refreshes never
+     * touch the account database.
+     */
+    QString userName();
 
     /** Returns the user's home directory of the process */
-    QString userHomeDir() const;
+    QString userHomeDir();
 
     /** Returns the local host */
     static QString localHost();
@@ -179,6 +197,7 @@ public:
         NAME = 16,
         CURRENT_DIR = 32,
         UID = 64,
+        START_TIME = 128,
     };
     Q_DECLARE_FLAGS(Fields, Field)
 
@@ -187,8 +206,6 @@ public:
     // space-constrained UI elements (eg. tabs)
     QString formatShortDir(const QString &dirPath) const;
 
-    void setUserNameRequired(bool need);
-
 protected:
     /**
      * Constructs a new process instance.  You should not call the constructor
@@ -238,7 +255,7 @@ protected:
      */
     virtual bool readArguments(int pid) = 0;
 
-    /* Read the user name */
+    /* Read the user name; called lazily from userName() */
     virtual void readUserName(void) = 0;
 
     /** Sets the process id associated with this ProcessInfo instance */
@@ -249,6 +266,8 @@ protected:
     void setForegroundPid(int pid);
     /** Sets the user id associated with this ProcessInfo instance */
     void setUserId(int uid);
+    /** Sets the process start time as returned by startTime() */
+    void setStartTime(qulonglong startTime);
     /** Sets the user name of the process as set by readUserName() */
     void setUserName(const QString &name);
     /** Sets the name of the process as returned by name() */
@@ -274,8 +293,6 @@ protected:
      */
     void clearArguments();
 
-    bool userNameRequired() const;
-
 private:
     Fields _fields;
 
@@ -283,6 +300,7 @@ private:
     int _parentPid;
     int _foregroundPid;
     int _userId;
+    qulonglong _startTime;
 
     Error _lastError;
 
@@ -291,7 +309,8 @@ private:
     QString _userHomeDir;
     QString _currentDir;
 
-    bool _userNameRequired;
+    bool _userNameRead;
+    bool _argumentsRead;
 
     QVector<QString> _arguments;
 
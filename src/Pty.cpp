@@ -11,6 +11,7 @@
 
 // Qt
 #include <QStringList>
+#include <QThread>
 #include <qplatformdefs.h>
 
 #ifndef Q_OS_WIN
@@ -24,6 +25,7 @@
 // KDE
 #include <KPtyDevice>
 #include <KSandbox>
+#include <KUser>
 
 using Konsole::Pty;
 
@@ -97,9 +99,56 @@ Pty::Pty(int masterFd, QObject *aParent)
     setPtyChannels(KPtyProcess::AllChannels);
 
     connect(pty(), &KPtyDevice::readyRead, this, &Konsole::Pty::dataReceived);
+    connect(pty(), &KPtyDevice::bytesWritten, this, &Konsole::Pty::flushSendQueue);
 }
 
-Pty::~Pty() = default;
+Pty::~Pty()
+{
+    unregisterUtmp();
+}
+
+void Pty::setUseUtmp(bool value)
+{
+    // deliberately not forwarded to KPtyProcess, whose registration runs
+    // synchronously during process startup; see registerUtmp()
+    _addToUtmp = value;
+}
+
+bool Pty::isUseUtmp() const
+{
+    return _addToUtmp;
+}
+
+void Pty::registerUtmp()
+{
+    // KPty::login() only reads the tty name from the device, so running
+    // it next to the GUI thread's use of the pty is safe; the thread is
+    // joined before the entry is removed or the device is closed
+    _utmpThread.reset(QThread::create([this]() {
+        pty()->login(KUser(KUser::UseRealUserID).loginName().toLocal8Bit().constData(), qgetenv("DISPLAY").constData());
+        _utmpRegistered = true;
+    }));
+    _utmpThread->start();
+}
+
+void Pty::unregisterUtmp()
+{
+    if (_utmpThread) {
+        _utmpThread->wait();
+        _utmpThread.reset();
+    }
+    if (_utmpRegistered) {
+        pty()->logout();
+        _utmpRegistered = false;
+    }
+}
+
+// how much may sit in the pty device's own write buffer before further
+// input is held back in the coalesced queue; bounds heap growth when a
+// stopped foreground process is not draining the pty
+static constexpr qint64 SendHighWaterMark = 1024 * 1024;
+// size of the batches the queue is drained in
+static constexpr int SendFlushChunk = 256 * 1024;
 
 void Pty::sendData(const QByteArray &data)
 {
@@ -107,9 +156,23 @@ void Pty::sendData(const QByteArray &data)
         return;
     }
 
-    if (pty()->write(data) == -1) {
-        qCDebug(KonsoleDebug) << "Could not send input data to terminal process.";
-        return;
+    _pendingSendData.append(data);
+    flushSendQueue();
+}
+
+void Pty::flushSendQueue()
+{
+    // keystrokes pass straight through; only when the device backs up
+    // (large paste, stopped reader) do chunks pile up here, and they are
+    // then written in coalesced batches as the device drains
+    while (!_pendingSendData.isEmpty() && pty()->bytesToWrite() < SendHighWaterMark) {
+        const int chunk = int(qMin<qint64>(_pendingSendData.size(), SendFlushChunk));
+        if (pty()->write(_pendingSendData.constData(), chunk) == -1) {
+            qCDebug(KonsoleDebug) << "Could not send input data to terminal process.";
+            _pendingSendData.clear();
+            return;
+        }
+        _pendingSendData.remove(0, chunk);
     }
 }
 
@@ -123,6 +186,11 @@ void Pty::dataReceived()
     Q_EMIT receivedData(data.constData(), data.length());
 }
 
+void Pty::setReadSuspended(bool suspended)
+{
+    pty()->setSuspended(suspended);
+}
+
 void Pty::setWindowSize(int columns, int lines, int width, int height)
 {
     _windowColumns = columns;
@@ -300,6 +368,12 @@ int Pty::start(const QString &programName, const QStringList &programArguments,
         if (KSandbox::isFlatpak()) {
             _shellProcessId = getShellProcessId(QLatin1String(pty()->ttyName()));
         }
+
+        // accounting I/O happens off the new-tab-to-prompt path
+        if (_addToUtmp) {
+            registerUtmp();
+        }
+
         return 0;
     } else {
         return -1;
@@ -326,6 +400,7 @@ void Pty::setWriteable(bool writeable)
 
 void Pty::closePty()
 {
+    unregisterUtmp();
     pty()->close();
 }
 
@@ -437,11 +512,21 @@ void Pty::sendData(const QByteArray &data)
 void Pty::dataReceived()
 {
     if (m_proc) {
-        auto data = m_proc->readAll();
-        Q_EMIT receivedData(data.constData(), data.length());
+        // the span is borrowed from the backend's receive buffer;
+        // receivedData() is delivered synchronously, so the bytes have
+        // reached the emulation by the time we acknowledge them
+        const IPtyProcess::ReadSpan span = m_proc->readLease();
+        Q_EMIT receivedData(span.data, span.length);
+        m_proc->readAck();
     }
 }
 
+void Pty::setReadSuspended(bool suspended)
+{
+    // ConPTY offers no way to pause its read loop
+    Q_UNUSED(suspended)
+}
+
 void Pty::setWindowSize(int columns, int lines, int, int)
 {
     if (m_proc && isRunning())
@@ -12,9 +12,14 @@
 #include <QProcess>
 #include <QSize>
 
+// C++
+#include <memory>
+
 // Konsole
 #include "konsoleprivate_export.h"
 
+class QThread;
+
 #ifndef Q_OS_WIN
 // KDE
 #include <KPtyProcess>
@@ -103,6 +108,20 @@ public:
     /** Control whether the pty device is writeable by group members. */
     void setWriteable(bool writeable);
 
+#ifndef Q_OS_WIN
+    /**
+     * Controls whether a utmp entry is created for the pty.
+     *
+     * This intentionally hides the KPtyProcess implementation, which
+     * writes the entry synchronously while the process is being started;
+     * on hosts with audit-logged wtmp that adds tens of milliseconds
+     * before the prompt can appear.  Here the entry is written on a
+     * short-lived background thread once the process is running.
+     */
+    void setUseUtmp(bool value);
+    bool isUseUtmp() const;
+#endif
+
     /**
      * Enables or disables Xon/Xoff flow control.  The flow control setting
      * may be changed later by a terminal application, so flowControlEnabled()
@@ -113,6 +132,14 @@ public:
     /** Queries the terminal state and returns true if Xon/Xoff flow control is enabled. */
     bool flowControlEnabled() const;
 
+    /**
+     * Suspends or resumes delivery of receivedData().  While suspended,
+     * output accumulates in the kernel's pty buffer and the writing
+     * process eventually blocks, which is the backpressure that keeps a
+     * flooding program from starving the event loop.  No data is lost.
+     */
+    void setReadSuspended(bool suspended);
+
     /**
      * Sets the size of the window (in columns and lines of characters,
      * and width and height in pixels) used by this teletype.
@@ -223,6 +250,12 @@ private Q_SLOTS:
     // called when data is received from the terminal process
     void dataReceived();
 
+#ifndef Q_OS_WIN
+    // drains the coalesced send queue into the pty device, bounded by a
+    // device-side high-water mark
+    void flushSendQueue();
+#endif
+
 private:
     void init();
 
@@ -230,6 +263,15 @@ private:
     // to the environment for the process
     void addEnvironmentVariables(const QStringList &environment);
 
+#ifndef Q_OS_WIN
+    // writes the utmp entry on a background thread; called from start()
+    // after the process is running
+    void registerUtmp();
+
+    // joins the registration thread and removes the utmp entry again
+    void unregisterUtmp();
+#endif
+
     int _windowColumns;
     int _windowLines;
     int _windowWidth;
@@ -238,6 +280,17 @@ private:
     bool _xon;
     bool _utf8;
     int _shellProcessId = 0;
+#ifndef Q_OS_WIN
+    // input waiting to enter the pty device once its buffer drains; kept
+    // as one flat buffer so queued chunks stay coalesced
+    QByteArray _pendingSendData;
+
+    bool _addToUtmp = false;
+    bool _utmpRegistered = false;
+    // short-lived worker performing the utmp registration, see registerUtmp()
+    std::unique_ptr<QThread> _utmpThread;
+#endif
+
 #ifdef Q_OS_WIN
     std::unique_ptr<IPtyProcess> m_proc;
 #else
@@ -0,0 +1,183 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "RawLogStream.h"
+
+// Qt
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+// Konsole
+#include "konsoledebug.h"
+
+using namespace Konsole;
+
+// rotate the log once it grows past this size; one previous rotation is
+// kept as "<path>.1"
+static constexpr qint64 RotateSize = 256ll * 1024 * 1024;
+
+class RawLogStream::Worker : public QObject
+{
+public:
+    Worker(const QString &path, Format format, int columns, int lines)
+        : _file(path)
+        , _format(format)
+        , _columns(columns)
+        , _lines(lines)
+    {
+    }
+
+    bool open()
+    {
+        if (!_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            return false;
+        }
+        if (_format == AsciicastV2 && _file.size() == 0) {
+            writeHeader();
+        }
+        return true;
+    }
+
+    void write(const QByteArray &data, double timestamp)
+    {
+        const qint64 written = _format == AsciicastV2 ? writeEvent(data, timestamp) : _file.write(data);
+        if (written == -1) {
+            qCDebug(KonsoleDebug) << "Raw log write to" << _file.fileName() << "failed:" << _file.errorString();
+            return;
+        }
+        if (_file.size() >= RotateSize) {
+            rotate();
+        }
+    }
+
+private:
+    void writeHeader()
+    {
+        QJsonObject header;
+        header.insert(QStringLiteral("version"), 2);
+        header.insert(QStringLiteral("width"), _columns);
+        header.insert(QStringLiteral("height"), _lines);
+        header.insert(QStringLiteral("timestamp"), QDateTime::currentSecsSinceEpoch());
+        _file.write(QJsonDocument(header).toJson(QJsonDocument::Compact) + '\n');
+    }
+
+    qint64 writeEvent(const QByteArray &data, double timestamp)
+    {
+        // asciicast events carry JSON strings, so a chunk must not end
+        // in the middle of a UTF-8 sequence; hold trailing partial
+        // bytes back until the next chunk
+        QByteArray bytes = _utf8Carry + data;
+        _utf8Carry.clear();
+        int complete = bytes.size();
+        for (int i = bytes.size() - 1; i >= 0 && i >= bytes.size() - 3; i--) {
+            const uchar c = uchar(bytes.at(i));
+            if ((c & 0xC0) == 0xC0) {
+                // lead byte: carry it unless its sequence is complete
+                const int sequenceLength = (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : 4;
+                if (i + sequenceLength > bytes.size()) {
+                    complete = i;
+                }
+                break;
+            }
+            if ((c & 0xC0) != 0x80) {
+                break;
+            }
+        }
+        _utf8Carry = bytes.mid(complete);
+        bytes.truncate(complete);
+        if (bytes.isEmpty()) {
+            return 0;
+        }
+
+        QJsonArray event;
+        event.append(timestamp);
+        event.append(QStringLiteral("o"));
+        event.append(QString::fromUtf8(bytes));
+        return _file.write(QJsonDocument(event).toJson(QJsonDocument::Compact) + '\n');
+    }
+
+    void rotate()
+    {
+        const QString path = _file.fileName();
+        const QString rotatedPath = path + QStringLiteral(".1");
+
+        _file.close();
+        QFile::remove(rotatedPath);
+        if (!QFile::rename(path, rotatedPath)) {
+            qCDebug(KonsoleDebug) << "Could not rotate raw log" << path;
+        }
+        _file.setFileName(path);
+        if (!_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qCDebug(KonsoleDebug) << "Could not reopen raw log" << path << "after rotation";
+        } else if (_format == AsciicastV2) {
+            // each rotated segment must be a valid asciicast on its own
+            writeHeader();
+        }
+    }
+
+    QFile _file;
+    Format _format;
+    int _columns;
+    int _lines;
+    QByteArray _utf8Carry;
+};
+
+RawLogStream::RawLogStream(const QString &path, Format format, int columns, int lines, QObject *parent)
+    : QObject(parent)
+    , _worker(new Worker(path, format, columns, lines))
+    , _path(path)
+    , _format(format)
+{
+    _elapsed.start();
+    // open on the calling thread so failure can be reported immediately;
+    // all subsequent access happens on the I/O thread
+    _valid = _worker->open();
+    _worker->moveToThread(&_ioThread);
+    connect(&_ioThread, &QThread::finished, _worker, &QObject::deleteLater);
+    _ioThread.setObjectName(QStringLiteral("RawLogStream"));
+    _ioThread.start();
+}
+
+RawLogStream::~RawLogStream()
+{
+    // lets queued writes drain before the worker is deleted
+    _ioThread.quit();
+    _ioThread.wait();
+}
+
+bool RawLogStream::isValid() const
+{
+    return _valid;
+}
+
+QString RawLogStream::path() const
+{
+    return _path;
+}
+
+void RawLogStream::append(const char *buffer, int length)
+{
+    if (!_valid || length <= 0) {
+        return;
+    }
+
+    // the pty buffer is reused by the caller, so the copy here is
+    // unavoidable; together with one clock read for recordings it is
+    // the only work done on the calling thread
+    const double timestamp = _format == AsciicastV2 ? _elapsed.nsecsElapsed() / 1.0e9 : 0.0;
+    QByteArray data(buffer, length);
+    QMetaObject::invokeMethod(
+        _worker,
+        [worker = _worker, data, timestamp]() {
+            worker->write(data, timestamp);
+        },
+        Qt::QueuedConnection);
+}
@@ -0,0 +1,90 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef RAWLOGSTREAM_H
+#define RAWLOGSTREAM_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QThread>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+/**
+ * Appends the raw pty byte stream of a session to a log file from a
+ * dedicated I/O thread.
+ *
+ * Unlike SaveHistoryAutoTask, which periodically re-decodes the screen
+ * and history through PlainTextDecoder, this taps the byte stream before
+ * it reaches the emulation: append() only copies the block and hands it
+ * to the worker thread, so always-on logging of many sessions adds no
+ * decoding work and no file I/O to the GUI thread.  The log therefore
+ * contains the untranslated stream including escape sequences.
+ *
+ * When the file grows past the rotation limit it is renamed to
+ * "<path>.1" (replacing any previous rotation) and a fresh file is
+ * started.
+ */
+class KONSOLEPRIVATE_EXPORT RawLogStream : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format {
+        /** The untranslated byte stream. */
+        Raw,
+        /**
+         * asciicast v2: a JSON header line followed by one
+         * timestamped output event per chunk, replayable with
+         * asciinema and compatible players.  Timestamps are taken on
+         * the calling thread with nanosecond resolution; JSON
+         * formatting happens on the I/O thread.
+         */
+        AsciicastV2,
+    };
+
+    /**
+     * Creates a stream logging to @p path and starts the I/O thread.
+     * Check isValid() to find out whether the file could be opened.
+     *
+     * @p columns and @p lines describe the terminal size and are only
+     * used for the AsciicastV2 header.
+     */
+    explicit RawLogStream(const QString &path, Format format = Raw, int columns = 80, int lines = 24, QObject *parent = nullptr);
+    ~RawLogStream() override;
+
+    /** Returns true if the log file was opened successfully. */
+    bool isValid() const;
+
+    /** Returns the path the stream logs to. */
+    QString path() const;
+
+    /**
+     * Queues @p length bytes at @p buffer for appending.  The data is
+     * copied before this returns, so the caller's buffer may be reused.
+     */
+    void append(const char *buffer, int length);
+
+private:
+    // performs all file access; lives on _ioThread
+    class Worker;
+
+    QThread _ioThread;
+    Worker *_worker;
+    QString _path;
+    Format _format;
+    // measures event times for AsciicastV2, starting at construction
+    QElapsedTimer _elapsed;
+    bool _valid;
+};
+}
+
+#endif // RAWLOGSTREAM_H
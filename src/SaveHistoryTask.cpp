@@ -11,6 +11,8 @@
 #include <QFileDialog>
 #include <QTextStream>
 
+#include <zlib.h>
+
 #include <KConfig>
 #include <KConfigGroup>
 #include <KIO/TransferJob>
@@ -30,6 +32,26 @@ namespace Konsole
 {
 QString SaveHistoryTask::_saveDialogRecentURL;
 
+/**
+ * Compress @p length bytes of @p input and append the result to
+ * @p output.  @p flushMode is Z_SYNC_FLUSH for intermediate chunks,
+ * which guarantees some output per call, or Z_FINISH for the trailer.
+ */
+static void deflateAppend(z_stream *stream, const char *input, int length, int flushMode, QByteArray &output)
+{
+    stream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input));
+    stream->avail_in = uInt(length);
+
+    int result = Z_OK;
+    do {
+        char block[64 * 1024];
+        stream->next_out = reinterpret_cast<Bytef *>(block);
+        stream->avail_out = uInt(sizeof(block));
+        result = deflate(stream, flushMode);
+        output.append(block, int(sizeof(block)) - int(stream->avail_out));
+    } while (stream->avail_out == 0 && result != Z_STREAM_END);
+}
+
 SaveHistoryTask::SaveHistoryTask(QObject *parent)
     : SessionTask(parent)
 {
@@ -46,7 +68,7 @@ bool SaveHistoryTask::execute()
     QFileDialog *dialog = new QFileDialog(QApplication::activeWindow());
     dialog->setAcceptMode(QFileDialog::AcceptSave);
 
-    QStringList mimeTypes{QStringLiteral("text/plain"), QStringLiteral("text/html")};
+    QStringList mimeTypes{QStringLiteral("text/plain"), QStringLiteral("text/html"), QStringLiteral("application/gzip")};
     dialog->setMimeTypeFilters(mimeTypes);
 
     KSharedConfigPtr konsoleConfig = KSharedConfig::openConfig();
@@ -88,6 +110,23 @@ bool SaveHistoryTask::execute()
         _saveDialogRecentURL = url.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).toString();
         group.writePathEntry("Recent URLs", _saveDialogRecentURL);
 
+        // a trailing .gz requests in-process gzip compression; strip it
+        // so the format checks below still see the real extension
+        const QString fileName = (dialog->selectedFiles()).at(0);
+        const bool compressed = fileName.endsWith(QLatin1String(".gz"), Qt::CaseInsensitive);
+        const QString plainFileName = compressed ? fileName.chopped(3) : fileName;
+
+        z_stream *zStream = nullptr;
+        if (compressed) {
+            zStream = new z_stream{};
+            // 15 window bits plus 16 selects the gzip wrapper
+            if (deflateInit2(zStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                delete zStream;
+                KMessageBox::error(nullptr, i18n("Could not set up compression, the output could not be saved."));
+                continue;
+            }
+        }
+
         KIO::TransferJob *job = KIO::put(url,
                                          -1, // no special permissions
                                          // overwrite existing files
@@ -105,13 +144,17 @@ bool SaveHistoryTask::execute()
         SaveJob jobInfo;
         jobInfo.session = session;
         jobInfo.lastLineFetched = -1; // when each request for data comes in from the KIO subsystem
+        jobInfo.totalLines = 0;
         // lastLineFetched is used to keep track of how much of the history
         // has already been sent, and where the next request should continue
         // from.
         // this is set to -1 to indicate the job has just been started
 
+        jobInfo.zStream = zStream;
+        jobInfo.zStreamFinished = false;
+
         if (((dialog->selectedNameFilter()).contains(QLatin1String("html"), Qt::CaseInsensitive))
-            || ((dialog->selectedFiles()).at(0).endsWith(QLatin1String("html"), Qt::CaseInsensitive))) {
+            || (plainFileName.endsWith(QLatin1String("html"), Qt::CaseInsensitive))) {
             Profile::Ptr profile = SessionManager::instance()->sessionProfile(session);
             const auto schemeName = profile->colorScheme();
             const auto scheme = ColorSchemeManager::instance()->findColorScheme(schemeName);
@@ -137,10 +180,18 @@ bool SaveHistoryTask::execute()
     return true;
 }
 
-void SaveHistoryTask::jobDataRequested(KIO::Job *job, QByteArray &data)
+void SaveHistoryTask::cancel()
 {
-    // TODO - Report progress information for the job
+    // killing a job runs it through jobResult(), so the decoders are
+    // cleaned up and the task completes as usual
+    const QList<KJob *> jobs = _jobSession.keys();
+    for (KJob *job : jobs) {
+        job->kill(KJob::EmitResult);
+    }
+}
 
+void SaveHistoryTask::jobDataRequested(KIO::Job *job, QByteArray &data)
+{
     // PERFORMANCE:  Do some tests and tweak this value to get faster saving
     const int LINES_PER_REQUEST = 500;
 
@@ -154,31 +205,62 @@ void SaveHistoryTask::jobDataRequested(KIO::Job *job, QByteArray &data)
 
         int sessionLines = info.session->emulation()->lineCount();
 
+        if (info.totalLines == 0) {
+            info.totalLines = sessionLines;
+        }
+
         if (sessionLines - 1 == info.lastLineFetched) {
+            if (info.zStream != nullptr && !info.zStreamFinished) {
+                // emit the final deflate block and the gzip trailer; the
+                // job then stops on the next, empty, data request
+                deflateAppend(info.zStream, nullptr, 0, Z_FINISH, data);
+                info.zStreamFinished = true;
+            }
             return; // if there is no more data to transfer then stop the job
         }
 
         int copyUpToLine = qMin(info.lastLineFetched + LINES_PER_REQUEST, sessionLines - 1);
 
-        QTextStream stream(&data, QIODevice::ReadWrite);
-        info.decoder->begin(&stream);
-        info.session->emulation()->writeToStream(info.decoder, info.lastLineFetched + 1, copyUpToLine);
-        info.decoder->end();
+        if (info.zStream != nullptr) {
+            QByteArray text;
+            QTextStream stream(&text, QIODevice::ReadWrite);
+            info.decoder->begin(&stream);
+            info.session->emulation()->writeToStream(info.decoder, info.lastLineFetched + 1, copyUpToLine);
+            info.decoder->end();
+
+            // Z_SYNC_FLUSH guarantees output for every chunk; handing the
+            // job an empty buffer would end the transfer early
+            deflateAppend(info.zStream, text.constData(), int(text.size()), Z_SYNC_FLUSH, data);
+        } else {
+            QTextStream stream(&data, QIODevice::ReadWrite);
+            info.decoder->begin(&stream);
+            info.session->emulation()->writeToStream(info.decoder, info.lastLineFetched + 1, copyUpToLine);
+            info.decoder->end();
+        }
 
         info.lastLineFetched = copyUpToLine;
+
+        if (info.totalLines > 0) {
+            // 64-bit intermediate; multi-million line scrollbacks overflow int * 100
+            Q_EMIT progress(int(qMin<qint64>(100, (qint64(info.lastLineFetched) + 1) * 100 / info.totalLines)));
+        }
     }
 }
 void SaveHistoryTask::jobResult(KJob *job)
 {
-    if (job->error() != 0) {
+    // a kill() through cancel() is not a failure worth a dialog
+    if (job->error() != 0 && job->error() != KJob::KilledJobError) {
         KMessageBox::error(nullptr, i18n("A problem occurred when saving the output.\n%1", job->errorString()));
     }
 
-    TerminalCharacterDecoder *decoder = _jobSession[job].decoder;
+    const SaveJob jobInfo = _jobSession.take(job);
 
-    _jobSession.remove(job);
+    delete jobInfo.decoder;
 
-    delete decoder;
+    if (jobInfo.zStream != nullptr) {
+        deflateEnd(jobInfo.zStream);
+        delete jobInfo.zStream;
+    }
 
     // notify the world that the task is done
     Q_EMIT completed(true);
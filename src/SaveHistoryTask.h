@@ -13,6 +13,8 @@
 
 #include <kio/job.h>
 
+struct z_stream_s;
+
 namespace Konsole
 {
 class TerminalCharacterDecoder;
@@ -35,9 +37,31 @@ public:
      * each session's history to the given URL.
      *
      * The data transfer is performed asynchronously and will continue after execute() returns.
+     * The history is pulled in fixed-size line chunks as the transfer
+     * drains, so no more than one chunk is ever held in memory.
+     *
+     * Choosing a file name ending in .gz streams the output through
+     * gzip in-process, chunk by chunk, instead of requiring a second
+     * pass over the saved file.
      */
     bool execute() override;
 
+    /**
+     * Aborts any transfers still running.  Each aborted job finishes
+     * through the usual result path, so decoders are cleaned up and
+     * completed() is emitted.
+     */
+    void cancel();
+
+Q_SIGNALS:
+    /**
+     * Emitted as chunks of history are written, with an estimate of the
+     * overall completion in percent.  The estimate is against the line
+     * count seen when the transfer started; output produced since then
+     * is still saved, but keeps the estimate at 100 a little longer.
+     */
+    void progress(int percent);
+
 private Q_SLOTS:
     void jobDataRequested(KIO::Job *job, QByteArray &data);
     void jobResult(KJob *job);
@@ -50,9 +74,15 @@ private:
         QPointer<Session> session; // the session associated with a history save job
         int lastLineFetched; // the last line processed in the previous data request
         // set this to -1 at the start of the save job
+        int totalLines; // the session's line count at the first data request,
+        // used to estimate progress; 0 until then
 
         TerminalCharacterDecoder *decoder; // decoder used to convert terminal characters
         // into output
+
+        z_stream_s *zStream; // gzip encoder when saving to a .gz file,
+        // nullptr for plain output
+        bool zStreamFinished; // the gzip trailer has been written
     };
 
     QHash<KJob *, SaveJob> _jobSession;
@@ -13,6 +13,9 @@
 // Qt
 #include <QFile>
 #include <QTextStream>
+#include <QVarLengthArray>
+
+#include <algorithm>
 
 // Konsole decoders
 #include <HTMLDecoder.h>
@@ -23,10 +26,16 @@
 #include "terminalDisplay/TerminalDisplay.h"
 #include "terminalDisplay/TerminalFonts.h"
 
+#include "AllocationTracker.h"
 #include "EscapeSequenceUrlExtractor.h"
 #include "characters/ExtendedCharTable.h"
+#include "history/HistoryScrollConversion.h"
+#include "history/HistoryScrollFile.h"
+#include "history/HistoryScrollHibernated.h"
 #include "history/HistoryScrollNone.h"
+#include "history/HistorySnapshot.h"
 #include "history/HistoryType.h"
+#include "history/HistoryTypeFile.h"
 
 #if HAVE_MALLOC_TRIM
 // For malloc_trim, which is a GNU extension
@@ -68,6 +77,7 @@ Screen::Screen(int lines, int columns)
     , _lastScrolledRegion(QRect())
     , _droppedLines(0)
     , _fastDroppedLines(0)
+    , _totalDroppedLines(0)
     , _oldTotalLines(0)
     , _isResize(false)
     , _enableReflowLines(false)
@@ -101,6 +111,8 @@ Screen::Screen(int lines, int columns)
     , _ignoreWcWidth(false)
 {
     std::fill(_lineProperties.begin(), _lineProperties.end(), LineProperty());
+    reserveLineCapacity();
+    _lineGenerations.assign(_lines + 1, 0);
 
     _graphicsPlacements = std::vector<std::unique_ptr<TerminalGraphicsPlacement_t>>();
     _hasGraphics = false;
@@ -108,9 +120,89 @@ Screen::Screen(int lines, int columns)
     initTabStops();
     clearSelection();
     reset();
+
+    // let the extended char table see this screen's live keys when sweeping
+    ExtendedCharTable::instance.registerUsedCharsProvider(this, [this]() {
+        return usedExtendedChars();
+    });
+}
+
+Screen::~Screen()
+{
+    ExtendedCharTable::instance.unregisterUsedCharsProvider(this);
 }
 
-Screen::~Screen() = default;
+QSet<uint> Screen::usedExtendedChars() const
+{
+    QSet<uint> result;
+    for (int i = 0; i < _lines; ++i) {
+        const ImageLine &il = _screenLines[i];
+        for (int j = 0; j < il.length(); ++j) {
+            if (il[j].rendition.f.extended) {
+                result << il[j].character;
+            }
+        }
+    }
+    // scrollback can reference sequences no longer on the visible image.
+    // A hibernated history carries its definitions inside the snapshot
+    // and re-registers them on thaw, so it needs nothing kept live here
+    // (and scanning it would force the restore this sweep runs to avoid)
+    if (const auto *hibernated = dynamic_cast<const HistoryScrollHibernated *>(_history.get())) {
+        if (hibernated->isFrozen()) {
+            return result;
+        }
+    }
+    const int historyLines = _history->getLines();
+    ImageLine historyLine;
+    for (int i = 0; i < historyLines; ++i) {
+        const int length = _history->getLineLen(i);
+        if (length <= 0) {
+            continue;
+        }
+        historyLine.resize(length);
+        _history->getCells(i, 0, length, historyLine.data());
+        for (int j = 0; j < length; ++j) {
+            if (historyLine[j].rendition.f.extended) {
+                result << historyLine[j].character;
+            }
+        }
+    }
+    return result;
+}
+
+void Screen::markLineDirty(int line)
+{
+    ++_currentGeneration;
+    if (line >= 0 && line < static_cast<int>(_lineGenerations.size())) {
+        _lineGenerations[line] = _currentGeneration;
+    }
+}
+
+void Screen::markRegionDirty(int fromLine, int toLine)
+{
+    ++_currentGeneration;
+    fromLine = qMax(fromLine, 0);
+    toLine = qMin(toLine, static_cast<int>(_lineGenerations.size()) - 1);
+    for (int line = fromLine; line <= toLine; ++line) {
+        _lineGenerations[line] = _currentGeneration;
+    }
+}
+
+void Screen::markAllLinesDirty()
+{
+    _allDirtyGeneration = ++_currentGeneration;
+}
+
+void Screen::reserveLineCapacity()
+{
+    // Keep every line's heap block at full column capacity. The incremental
+    // resize() calls in displayCharacter() then never reallocate, and since
+    // shrinking a QVector keeps its capacity, scrolling and clearImage()
+    // recycle the same blocks instead of churning the allocator.
+    for (auto &line : _screenLines) {
+        line.reserve(_columns + 1);
+    }
+}
 
 void Screen::cursorUp(int n)
 //=CUU
@@ -371,6 +463,7 @@ void Screen::eraseBlock(int y, int x, int height, int width)
     int endCol = x + width;
     height = qBound(0, height, _lines - y - 1);
     Character chr(' ', CharacterColor(COLOR_SPACE_DEFAULT, DEFAULT_FORE_COLOR), CharacterColor(COLOR_SPACE_DEFAULT, DEFAULT_BACK_COLOR), RE_TRANSPARENT, 0);
+    markRegionDirty(y, y + height - 1);
     for (int row = y; row < y + height; row++) {
         QVector<Character> &line = _screenLines[row];
         if (line.size() < endCol + 1) {
@@ -406,14 +499,13 @@ void Screen::deleteChars(int n)
     Q_ASSERT(n >= 0);
     Q_ASSERT(_cuX + n <= _screenLines.at(_cuY).count());
 
+    markLineDirty(_cuY);
     _screenLines[_cuY].remove(_cuX, n);
 
-    // Append space(s) with current attributes
+    // Append space(s) with current attributes as one block write
     Character spaceWithCurrentAttrs(' ', _effectiveForeground, _effectiveBackground, _effectiveRendition.all, 0);
 
-    for (int i = 0; i < n; ++i) {
-        _screenLines[_cuY].append(spaceWithCurrentAttrs);
-    }
+    _screenLines[_cuY].insert(_screenLines[_cuY].size(), n, spaceWithCurrentAttrs);
 }
 
 void Screen::insertChars(int n)
@@ -426,6 +518,7 @@ void Screen::insertChars(int n)
         _screenLines[_cuY].resize(_cuX);
     }
 
+    markLineDirty(_cuY);
     _screenLines[_cuY].insert(_cuX, n, Character(' '));
 
     if (_screenLines.at(_cuY).count() > getScreenLineColumns(_cuY)) {
@@ -446,8 +539,79 @@ void Screen::repeatChars(int n)
     // So, a "normal" program should always use REP immediately after a visible
     // character (those other than escape sequences). So, _lastDrawnChar can be
     // safely used.
+    const uint c = _lastDrawnChar;
+
+    // Fast path: a simple width-1 character repeats as a row fill from
+    // one prototype cell - one width lookup and one wrap check per line
+    // instead of the full displayCharacter() state machine per copy.
+    // Anything that combines, is double-width or needs insert handling
+    // takes the general path below.
+    const bool simple = c >= 0x20 && Character::width(c, _ignoreWcWidth) == 1 && !getMode(MODE_Insert) && !Character::emoji(c)
+        && !Character::emojiPresentation(c) && QChar::category(c) != QChar::Mark_NonSpacing && QChar::category(c) != QChar::Mark_SpacingCombining
+        && !Hangul::isHangul(c);
+    if (simple) {
+        AllocationTracker::Scope allocationScope(AllocationTracker::ScreenSubsystem);
+
+        ExtraFlags cellFlags = setRepl(EF_REAL, _replMode) | SetULColor(0, _currentULColor);
+        if (c <= '~' && c > ' ') {
+            cellFlags |= EF_ASCII_WORD;
+        }
+        if (isBrahmicWordChar(c)) {
+            cellFlags |= EF_BRAHMIC_WORD;
+        }
+
+        while (n > 0) {
+            const int lineColumns = getScreenLineColumns(_cuY);
+            if (_cuX >= lineColumns) {
+                if (getMode(MODE_Wrap)) {
+                    _lineProperties[_cuY].flags.f.wrapped = 1;
+                    nextLine();
+                    continue;
+                }
+                _cuX = qMax(lineColumns - 1, 0);
+            }
+            const int run = qMin(n, lineColumns - _cuX);
+
+            markLineDirty(_cuY);
+
+            // ensure current line vector has enough elements
+            if (_screenLines[_cuY].size() < _cuX + run) {
+                _screenLines[_cuY].resize(_cuX + run);
+            }
+
+            _lastPos = loc(_cuX + run - 1, _cuY);
+            checkSelection(loc(_cuX, _cuY), _lastPos);
+
+            Character *line = _screenLines[_cuY].data();
+            for (int j = 0; j < run; ++j) {
+                Character &cell = line[_cuX + j];
+                cell.character = c;
+                cell.foregroundColor = _effectiveForeground;
+                cell.backgroundColor = _effectiveBackground;
+                cell.rendition = _effectiveRendition;
+                cell.flags = cellFlags;
+            }
+
+            _cuX += run;
+            if (_replMode != REPL_None && std::make_pair(_cuY, _cuX) >= _replModeEnd) {
+                _replModeEnd = std::make_pair(_cuY, _cuX);
+            }
+            if (_lineProperties[_cuY].length < _cuX) {
+                _lineProperties[_cuY].length = _cuX;
+            }
+            if (_escapeSequenceUrlExtractor) {
+                for (int j = 0; j < run; ++j) {
+                    _escapeSequenceUrlExtractor->appendUrlText(c);
+                }
+            }
+
+            n -= run;
+        }
+        return;
+    }
+
     while (n > 0) {
-        displayCharacter(_lastDrawnChar);
+        displayCharacter(c);
         --n;
     }
 }
@@ -612,6 +776,9 @@ void Screen::resizeImage(int new_lines, int new_columns)
     _oldTotalLines = getLines() + getHistLines();
     _isResize = true;
 
+    // reflow renumbers the history lines; rebuild the prompt index lazily
+    invalidatePromptLines();
+
     int cursorLine = getCursorLine();
     const int oldCursorLine = (cursorLine == _lines - 1 || cursorLine > new_lines - 1) ? new_lines - 1 : cursorLine;
 
@@ -730,6 +897,9 @@ void Screen::resizeImage(int new_lines, int new_columns)
     _screenLinesSize = new_lines;
     _lines = new_lines;
     _columns = new_columns;
+    reserveLineCapacity();
+    _lineGenerations.assign(new_lines + 1, 0);
+    markAllLinesDirty();
     _cuX = qMin(_cuX, _columns - 1);
     cursorLine = qBound(0, cursorLine, _lines - 1);
     setCursorLine(cursorLine);
@@ -798,41 +968,61 @@ void Screen::updateEffectiveRendition()
     }
 }
 
+namespace
+{
+// Marks the inclusive column range [firstColumn, lastColumn] of a line of
+// @p width cells as selected, widening the ends so that both halves of a
+// CJK character are always selected together.
+void markSelectedSpan(Character *line, const int width, int firstColumn, int lastColumn)
+{
+    lastColumn = qMin(lastColumn, width - 1);
+    if (firstColumn > lastColumn) {
+        return;
+    }
+    if (firstColumn > 0 && line[firstColumn].isRightHalfOfDoubleWide()) {
+        ++firstColumn;
+    }
+    if (lastColumn + 1 < width && line[lastColumn + 1].isRightHalfOfDoubleWide()) {
+        ++lastColumn;
+    }
+    for (int column = firstColumn; column <= lastColumn; ++column) {
+        line[column].rendition.f.selected = 1;
+    }
+}
+}
+
 void Screen::copyFromHistory(Character *dest, int startLine, int count) const
 {
     const int columns = _columns;
 
     Q_ASSERT(startLine >= 0 && count > 0 && startLine + count <= _history->getLines());
 
-    for (int line = startLine; line < startLine + count; ++line) {
-        const int length = qMin(columns, _history->getLineLen(line));
-        const int destLineOffset = (line - startLine) * columns;
-        const int lastColumn = (_history->getLineProperty(line).flags.f.doublewidth) ? columns / 2 : columns;
-
-        _history->getCells(line, 0, length, dest + destLineOffset);
+    // one bulk fetch per viewport instead of a virtual call per line;
+    // the backend pads short lines with DefaultChar itself
+    _history->getCellsRange(startLine, count, columns, Screen::DefaultChar, dest);
 
-        if (length < columns) {
-            const int begin = destLineOffset + length;
-            const int end = destLineOffset + columns;
-            std::fill(dest + begin, dest + end, Screen::DefaultChar);
+    // invert selected text
+    if (_selBegin != -1) {
+        for (int line = startLine; line < startLine + count; ++line) {
+            int firstSelected = 0;
+            int lastSelected = 0;
+            if (selectedSpan(line, firstSelected, lastSelected)) {
+                const int lastColumn = (_history->getLineProperty(line).flags.f.doublewidth) ? columns / 2 : columns;
+                markSelectedSpan(dest + (line - startLine) * columns, lastColumn, firstSelected, lastSelected);
+            }
         }
+    }
 
-        // invert selected text
-        if (_selBegin != -1) {
-            bool prevSelected = false;
-            for (int column = 0; column < lastColumn; ++column) {
-                const bool selected = isSelected(column, line);
-                if (selected) {
-                    // Make sure to not mark as selected the right half of a CJK character if the left half isn't selected
-                    if (column == 0 || prevSelected || !dest[destLineOffset + column].isRightHalfOfDoubleWide())
-                        dest[destLineOffset + column].rendition.f.selected = 1;
-                    // Make sure to mark as selected the right half of a CJK character if the left half is selected
-                    if (column + 1 < lastColumn && dest[destLineOffset + column + 1].isRightHalfOfDoubleWide())
-                        dest[destLineOffset + column + 1].rendition.f.selected = 1;
-                }
-                prevSelected = selected;
-            }
+    // warm the page the user is scrolling toward, inferring the direction
+    // from the movement of the viewport between successive copies
+    if (startLine != _lastHistoryCopyLine) {
+        const bool scrollingUp = startLine < _lastHistoryCopyLine;
+        const int prefetchStart = scrollingUp ? qMax(0, startLine - count) : startLine + count;
+        const int prefetchCount = scrollingUp ? startLine - prefetchStart : qMin(count, _history->getLines() - prefetchStart);
+        if (prefetchCount > 0) {
+            _history->prefetchRange(prefetchStart, prefetchCount);
         }
+        _lastHistoryCopyLine = startLine;
     }
 }
 
@@ -859,18 +1049,10 @@ void Screen::copyFromScreen(Character *dest, int startLine, int count) const
         }
 
         if (_selBegin != -1) {
-            bool prevSelected = false;
-            for (int column = 0; column < lastColumn; ++column) {
-                const bool selected = isSelected(column, line + historyLines);
-                if (selected) {
-                    // Make sure to not mark as selected the right half of a CJK character if the left half isn't selected
-                    if (column == 0 || prevSelected || !dest[destLineOffset + column].isRightHalfOfDoubleWide())
-                        dest[destLineOffset + column].rendition.f.selected = 1;
-                    // Make sure to mark as selected the right half of a CJK character if the left half is selected
-                    if (column + 1 < lastColumn && dest[destLineOffset + column + 1].isRightHalfOfDoubleWide())
-                        dest[destLineOffset + column + 1].rendition.f.selected = 1;
-                }
-                prevSelected = selected;
+            int firstSelected = 0;
+            int lastSelected = 0;
+            if (selectedSpan(line + historyLines, firstSelected, lastSelected)) {
+                markSelectedSpan(dest + destLineOffset, lastColumn, firstSelected, lastSelected);
             }
         }
     }
@@ -1012,6 +1194,7 @@ void Screen::backspace()
     _cuX = qMax(0, _cuX - 1);
 
     if (_screenLines.at(_cuY).size() < _cuX + 1) {
+        markLineDirty(_cuY);
         _screenLines[_cuY].resize(_cuX + 1);
     }
 }
@@ -1095,8 +1278,20 @@ void Screen::checkSelection(int from, int to)
     }
 }
 
+// characters of Brahmic-derived scripts, which select word-by-word
+// rather than cell-by-cell (see EF_BRAHMIC_WORD)
+static bool isBrahmicWordChar(uint c)
+{
+    return c >= 0x900
+        && (c <= 0x109f || (c >= 0x1700 && c <= 0x18af) || (c >= 0x1900 && c <= 0x1aaf) || (c >= 0x1b00 && c <= 0x1c4f) || (c >= 0xa800 && c <= 0xa82f)
+            || (c >= 0xa840 && c <= 0xa95f) || (c >= 0xa980 && c <= 0xaaff) || (c >= 0xabc0 && c <= 0xabff) || (c >= 0x10a00 && c <= 0x10a5f)
+            || (c >= 0x11000 && c <= 0x11fff));
+}
+
 void Screen::displayCharacter(uint c)
 {
+    AllocationTracker::Scope allocationScope(AllocationTracker::ScreenSubsystem);
+
     // Note that VT100 does wrapping BEFORE putting the character.
     // This has impact on the assumption of valid cursor positions.
     // We indicate the fact that a newline has to be triggered by
@@ -1148,6 +1343,7 @@ void Screen::displayCharacter(uint c)
             }
         }
 
+        markLineDirty(charToCombineWithY);
         Character &currentChar = _screenLines[charToCombineWithY][charToCombineWithX];
 
         if (c == 0x20E3) {
@@ -1215,11 +1411,13 @@ void Screen::displayCharacter(uint c)
             }
         }
 
-        if (Hangul::isHangul(c) && !Hangul::combinesWith(currentChar, c)) {
+        if (Hangul::isHangul(c) && !_hangulComposer.combinesWith(currentChar, c)) {
             w = 2;
             goto notcombine;
         }
 
+        const uint keyBeforeCombine = currentChar.character;
+
         if (currentChar.rendition.f.extended == 0) {
             const char32_t chars[2] = {currentChar.character, c};
             currentChar.rendition.f.extended = 1;
@@ -1256,6 +1454,10 @@ void Screen::displayCharacter(uint c)
                 currentChar.character = ExtendedCharTable::instance.createExtendedChar(chars.get(), extendedCharLength + 1, extChars);
             }
         }
+        if (Hangul::isHangul(c) && currentChar.character != keyBeforeCombine) {
+            // keep the streaming composer in step with the conjoined cell
+            _hangulComposer.advance(c, currentChar.character);
+        }
         return;
     }
 
@@ -1269,6 +1471,8 @@ notcombine:
         }
     }
 
+    markLineDirty(_cuY);
+
     // ensure current line vector has enough elements
     if (_screenLines[_cuY].size() < _cuX + w) {
         _screenLines[_cuY].resize(_cuX + w);
@@ -1296,10 +1500,7 @@ notcombine:
     if (c <= '~' && c > ' ') {
         currentChar.flags |= EF_ASCII_WORD;
     }
-    if (c >= 0x900
-        && (c <= 0x109f || (c >= 0x1700 && c <= 0x18af) || (c >= 0x1900 && c <= 0x1aaf) || (c >= 0x1b00 && c <= 0x1c4f) || (c >= 0xa800 && c <= 0xa82f)
-            || (c >= 0xa840 && c <= 0xa95f) || (c >= 0xa980 && c <= 0xaaff) || (c >= 0xabc0 && c <= 0xabff) || (c >= 0x10a00 && c <= 0x10a5f)
-            || (c >= 0x11000 && c <= 0x11fff))) {
+    if (isBrahmicWordChar(c)) {
         currentChar.flags |= EF_BRAHMIC_WORD;
     }
 
@@ -1336,6 +1537,134 @@ notcombine:
     }
 }
 
+void Screen::displayCharacters(const uint *c, int count)
+{
+    AllocationTracker::Scope allocationScope(AllocationTracker::ScreenSubsystem);
+
+    int i = 0;
+    while (i < count) {
+        // Batch path: printable ASCII is always a simple width-1 cell with no
+        // combining behaviour, so a run of it that fits on the current line
+        // can be written without re-checking wrap state per character.
+        if (!getMode(MODE_Insert) && _cuX < getScreenLineColumns(_cuY)) {
+            const int lineColumns = getScreenLineColumns(_cuY);
+            const int maxRun = qMin(count - i, lineColumns - _cuX);
+            int n = 0;
+            while (n < maxRun && c[i + n] >= 0x20 && c[i + n] <= 0x7E) {
+                ++n;
+            }
+            if (n > 0) {
+                markLineDirty(_cuY);
+
+                // ensure current line vector has enough elements
+                if (_screenLines[_cuY].size() < _cuX + n) {
+                    _screenLines[_cuY].resize(_cuX + n);
+                }
+
+                _lastPos = loc(_cuX + n - 1, _cuY);
+                checkSelection(loc(_cuX, _cuY), _lastPos);
+
+                const ExtraFlags flags = setRepl(EF_REAL, _replMode) | SetULColor(0, _currentULColor);
+                Character *line = _screenLines[_cuY].data();
+                for (int j = 0; j < n; ++j) {
+                    const uint cc = c[i + j];
+                    Character &currentChar = line[_cuX + j];
+                    currentChar.character = cc;
+                    currentChar.foregroundColor = _effectiveForeground;
+                    currentChar.backgroundColor = _effectiveBackground;
+                    currentChar.rendition = _effectiveRendition;
+                    currentChar.flags = (cc > ' ') ? (flags | EF_ASCII_WORD) : flags;
+                }
+
+                _lastDrawnChar = c[i + n - 1];
+                _cuX += n;
+                if (_replMode != REPL_None && std::make_pair(_cuY, _cuX) >= _replModeEnd) {
+                    _replModeEnd = std::make_pair(_cuY, _cuX);
+                }
+                if (_lineProperties[_cuY].length < _cuX) {
+                    _lineProperties[_cuY].length = _cuX;
+                }
+                if (_escapeSequenceUrlExtractor) {
+                    for (int j = 0; j < n; ++j) {
+                        _escapeSequenceUrlExtractor->appendUrlText(c[i + j]);
+                    }
+                }
+
+                i += n;
+                continue;
+            }
+
+            // Batched wide-character path: CJK output arrives as long runs
+            // of double-width glyphs that neither combine nor trigger the
+            // emoji handling, so the width pattern of the run is known up
+            // front and the lead and trailing dummy cells can be placed
+            // with a stride loop instead of re-entering the general case
+            // per glyph.
+            const int maxWide = qMin(count - i, (lineColumns - _cuX) / 2);
+            int m = 0;
+            while (m < maxWide && Character::width(c[i + m], _ignoreWcWidth) == 2 && !Character::emoji(c[i + m])
+                   && !Character::emojiPresentation(c[i + m]) && QChar::category(c[i + m]) != QChar::Mark_SpacingCombining) {
+                ++m;
+            }
+            if (m > 0) {
+                markLineDirty(_cuY);
+
+                // ensure current line vector has enough elements
+                if (_screenLines[_cuY].size() < _cuX + 2 * m) {
+                    _screenLines[_cuY].resize(_cuX + 2 * m);
+                }
+
+                _lastPos = loc(_cuX + 2 * (m - 1), _cuY);
+                checkSelection(loc(_cuX, _cuY), loc(_cuX + 2 * m - 1, _cuY));
+
+                const ExtraFlags leadFlags = setRepl(EF_REAL, _replMode) | SetULColor(0, _currentULColor);
+                const ExtraFlags dummyFlags = setRepl(EF_UNREAL, _replMode);
+                Character *line = _screenLines[_cuY].data();
+                for (int j = 0; j < m; ++j) {
+                    const uint cc = c[i + j];
+
+                    Character &lead = line[_cuX + 2 * j];
+                    lead.character = cc;
+                    lead.foregroundColor = _effectiveForeground;
+                    lead.backgroundColor = _effectiveBackground;
+                    lead.rendition = _effectiveRendition;
+                    lead.flags = isBrahmicWordChar(cc) ? (leadFlags | EF_BRAHMIC_WORD) : leadFlags;
+
+                    Character &dummy = line[_cuX + 2 * j + 1];
+                    dummy.setRightHalfOfDoubleWide();
+                    dummy.foregroundColor = _effectiveForeground;
+                    dummy.backgroundColor = _effectiveBackground;
+                    dummy.rendition = _effectiveRendition;
+                    dummy.flags = dummyFlags;
+                }
+
+                _lastDrawnChar = c[i + m - 1];
+                _cuX += 2 * m;
+                if (_replMode != REPL_None && std::make_pair(_cuY, _cuX) >= _replModeEnd) {
+                    _replModeEnd = std::make_pair(_cuY, _cuX);
+                }
+                if (_lineProperties[_cuY].length < _cuX) {
+                    _lineProperties[_cuY].length = _cuX;
+                }
+                if (_escapeSequenceUrlExtractor) {
+                    for (int j = 0; j < m; ++j) {
+                        _escapeSequenceUrlExtractor->appendUrlText(c[i + j]);
+                    }
+                }
+
+                i += m;
+                continue;
+            }
+        }
+
+        // Anything else (combining marks, pending wrap, insert mode, a
+        // wide character at the last column) takes the full per-character
+        // path.
+        displayCharacter(c[i]);
+        ++i;
+    }
+}
+
 int Screen::scrolledLines() const
 {
     return _scrolledLines;
@@ -1348,6 +1677,10 @@ int Screen::fastDroppedLines() const
 {
     return _fastDroppedLines;
 }
+int Screen::totalDroppedLines() const
+{
+    return _totalDroppedLines;
+}
 void Screen::resetDroppedLines()
 {
     _droppedLines = 0;
@@ -1363,11 +1696,27 @@ void Screen::scrollUp(int n)
     if (n < 1) {
         n = 1; // Default
     }
-    for (int i = 0; i < n; i++) {
-        if (_topMargin == 0) {
-            addHistLine(); // history.history
+    if (_topMargin == 0) {
+        // Hand all scrolled-out lines to the history first, then move the
+        // image once: one n-line shuffle instead of n one-line shuffles.
+        const int batch = qMin(n, _bottomMargin + 1);
+        if (batch > 1 && _selBegin == -1) {
+            addHistLines(batch); // history.history
+        } else {
+            for (int i = 0; i < batch; i++) {
+                addHistLine(i); // history.history
+            }
         }
-        scrollUp(_topMargin, 1);
+        scrollUp(0, batch);
+
+        // More than a screenful was requested: the remaining lines enter
+        // the history as freshly cleared lines, same as before.
+        for (int i = batch; i < n; i++) {
+            addHistLine();
+            scrollUp(0, 1);
+        }
+    } else {
+        scrollUp(_topMargin, n);
     }
 }
 
@@ -1376,6 +1725,20 @@ QRect Screen::lastScrolledRegion() const
     return _lastScrolledRegion;
 }
 
+// Remembers which band of the screen the current update cycle has been
+// scrolling, so the view can blit it instead of re-rendering the moved
+// lines. Scrolls of two different regions within one cycle cannot be
+// described by a single blit; the region degrades to invalid and the
+// view falls back to the plain diff.
+void Screen::recordScrolledRegion(const QRect &region)
+{
+    if (_scrolledLines == 0 || _lastScrolledRegion == region) {
+        _lastScrolledRegion = region;
+    } else {
+        _lastScrolledRegion = QRect();
+    }
+}
+
 void Screen::scrollUp(int from, int n)
 {
     if (n <= 0) {
@@ -1388,8 +1751,8 @@ void Screen::scrollUp(int from, int n)
         n = _bottomMargin + 1 - from;
     }
 
+    recordScrolledRegion(QRect(0, _topMargin, _columns - 1, (_bottomMargin - _topMargin)));
     _scrolledLines -= n;
-    _lastScrolledRegion = QRect(0, _topMargin, _columns - 1, (_bottomMargin - _topMargin));
 
     // FIXME: make sure `topMargin', `bottomMargin', `from', `n' is in bounds.
     moveImage(loc(0, from), loc(0, from + n), loc(_columns, _bottomMargin));
@@ -1420,6 +1783,7 @@ void Screen::scrollDown(int n)
 
 void Screen::scrollDown(int from, int n)
 {
+    recordScrolledRegion(QRect(0, _topMargin, _columns - 1, (_bottomMargin - _topMargin)));
     _scrolledLines += n;
 
     // FIXME: make sure `topMargin', `bottomMargin', `from', `n' is in bounds.
@@ -1506,6 +1870,8 @@ void Screen::clearImage(int loca, int loce, char c, bool resetLineRendition)
         const int endCol = (y == bottomLine) ? loce % _columns : _columns - 1;
         const int startCol = (y == topLine) ? loca % _columns : 0;
 
+        const LineProperty oldProperty = _lineProperties[y];
+
         if (endCol < _columns - 1 || startCol > 0) {
             _lineProperties[y].flags.f.wrapped = 0;
             if (_lineProperties[y].length < endCol && _lineProperties[y].length > startCol) {
@@ -1522,7 +1888,13 @@ void Screen::clearImage(int loca, int loce, char c, bool resetLineRendition)
 
         QVector<Character> &line = _screenLines[y];
 
+        // a line that is already in its cleared state needs neither the
+        // write nor a repaint; full-screen TUIs clear whole regions every
+        // frame, so this keeps the untouched lines out of the update diff
+        bool contentChanged = true;
+
         if (isDefaultCh && endCol == _columns - 1) {
+            contentChanged = line.size() > startCol;
             line.resize(startCol);
         } else {
             if (line.size() < endCol + 1) {
@@ -1537,6 +1909,10 @@ void Screen::clearImage(int loca, int loce, char c, bool resetLineRendition)
                 std::fill(line.begin() + startCol, line.begin() + (endCol + 1), clearCh);
             }
         }
+
+        if (contentChanged || oldProperty.flags.all != _lineProperties[y].flags.all || oldProperty.length != _lineProperties[y].length) {
+            markLineDirty(y);
+        }
     }
 
     if (_escapeSequenceUrlExtractor) {
@@ -1557,6 +1933,7 @@ void Screen::moveImage(int dest, int sourceBegin, int sourceEnd)
     //(search the web for 'memmove implementation' for details)
     const int destY = dest / _columns;
     const int srcY = sourceBegin / _columns;
+    markRegionDirty(qMin(destY, srcY), qMax(destY, srcY) + lines);
     if (dest < sourceBegin) {
         /**
          * This is basically a left rotate.
@@ -1578,7 +1955,9 @@ void Screen::moveImage(int dest, int sourceBegin, int sourceEnd)
         std::rotate(_lineProperties.begin() + destY, _lineProperties.begin() + srcY, _lineProperties.begin() + srcY + lines);
     } else {
         for (int i = lines; i >= 0; --i) {
-            _screenLines[destY + i] = std::move(_screenLines[srcY + i]);
+            // swap rather than move so the vacated source lines keep their
+            // allocations for the clearImage() call that follows a scroll
+            std::swap(_screenLines[destY + i], _screenLines[srcY + i]);
             _lineProperties[destY + i] = _lineProperties.at(srcY + i);
         }
     }
@@ -1834,12 +2213,16 @@ void Screen::setSelectionEnd(const int x, const int y, const bool trimTrailingWh
     if (bottomRow < _history->getLines()) {
         ImageLine histLine;
         const int histLineLen = _history->getLineLen(bottomRow);
-        histLine.resize(histLineLen);
 
-        _history->getCells(bottomRow, 0, histLineLen, histLine.data());
+        const Character *histCells = _history->getCellsSpan(bottomRow, 0, histLineLen);
+        if (histCells == nullptr) {
+            histLine.resize(histLineLen);
+            _history->getCells(bottomRow, 0, histLineLen, histLine.data());
+            histCells = histLine.constData();
+        }
 
         for (int j = bottomColumn; j < histLineLen; j++) {
-            if ((histLine.at(j).flags & EF_REAL) != 0 && (!trimTrailingWhitespace || !QChar::isSpace(histLine.at(j).character))) {
+            if ((histCells[j].flags & EF_REAL) != 0 && (!trimTrailingWhitespace || !QChar::isSpace(histCells[j].character))) {
                 beyondLastColumn = false;
             }
         }
@@ -1868,13 +2251,31 @@ void Screen::setSelectionEnd(const int x, const int y, const bool trimTrailingWh
 
 bool Screen::isSelected(const int x, const int y) const
 {
-    bool columnInSelection = true;
-    if (_blockSelectionMode) {
-        columnInSelection = x >= (_selTopLeft % _columns) && x <= (_selBottomRight % _columns);
+    int firstColumn = 0;
+    int lastColumn = 0;
+    return selectedSpan(y, firstColumn, lastColumn) && x >= firstColumn && x <= lastColumn;
+}
+
+bool Screen::selectedSpan(const int line, int &firstColumn, int &lastColumn) const
+{
+    if (_selBegin == -1) {
+        return false;
+    }
+
+    const int topLine = _selTopLeft / _columns;
+    const int bottomLine = _selBottomRight / _columns;
+    if (line < topLine || line > bottomLine) {
+        return false;
     }
 
-    const int pos = loc(x, y);
-    return pos >= _selTopLeft && pos <= _selBottomRight && columnInSelection;
+    if (_blockSelectionMode) {
+        firstColumn = _selTopLeft % _columns;
+        lastColumn = _selBottomRight % _columns;
+    } else {
+        firstColumn = (line == topLine) ? _selTopLeft % _columns : 0;
+        lastColumn = (line == bottomLine) ? _selBottomRight % _columns : _columns - 1;
+    }
+    return true;
 }
 
 Character Screen::getCharacter(int col, int row) const
@@ -1976,10 +2377,21 @@ void Screen::selectReplContigious(const int x, const int y)
 }
 
 QString Screen::selectedText(const DecodingOptions options) const
+{
+    int startIndex = 0;
+    int endIndex = 0;
+    if (!selectedTextRange(startIndex, endIndex)) {
+        return QString();
+    }
+
+    return text(startIndex, endIndex, options);
+}
+
+bool Screen::selectedTextRange(int &startIndex, int &endIndex) const
 {
     if (!isSelectionValid()) {
         if (!_hasRepl) {
-            return QString();
+            return false;
         }
         int currentStart = (_history->getLines() + _replModeStart.first) * _columns + _replModeStart.second;
         int currentEnd = (_history->getLines() + _replModeEnd.first) * _columns + _replModeEnd.second - 1;
@@ -1989,13 +2401,22 @@ QString Screen::selectedText(const DecodingOptions options) const
             currentStart = (_history->getLines() + _replLastOutputStart.first) * _columns + _replLastOutputStart.second;
             currentEnd = (_history->getLines() + _replLastOutputEnd.first) * _columns + _replLastOutputEnd.second - 1;
         }
-        if (currentEnd >= currentStart) {
-            return text(currentStart, currentEnd, options);
+        if (currentEnd < currentStart) {
+            return false;
         }
-        return QString();
+        startIndex = currentStart;
+        endIndex = currentEnd;
+        return true;
     }
 
-    return text(_selTopLeft, _selBottomRight, options);
+    startIndex = _selTopLeft;
+    endIndex = _selBottomRight;
+    return true;
+}
+
+bool Screen::blockSelectionMode() const
+{
+    return _blockSelectionMode;
 }
 
 QString Screen::text(int startIndex, int endIndex, const DecodingOptions options) const
@@ -2098,6 +2519,7 @@ QList<int> Screen::getCharacterCounts() const
         int count = getLineLength(line);
         bool lineIsWrapped = false;
         Character *characterBuffer = getCharacterBuffer(count - 1);
+        const Character *lineCells = characterBuffer;
 
         Q_ASSERT(count >= 0);
 
@@ -2105,11 +2527,17 @@ QList<int> Screen::getCharacterCounts() const
             // safety checks
             Q_ASSERT(count <= _history->getLineLen(line));
 
-            _history->getCells(line, 0, count, characterBuffer);
+            // read straight out of the history's backing store when it can
+            // hand out a span, avoiding a copy per history line
+            lineCells = _history->getCellsSpan(line, 0, count);
+            if (lineCells == nullptr) {
+                _history->getCells(line, 0, count, characterBuffer);
+                lineCells = characterBuffer;
+            }
 
             // Exclude trailing empty cells from count and don't bother processing them further.
             // See the comment on the similar case for screen lines for an explanation.
-            while (count > 0 && (characterBuffer[count - 1].flags & EF_REAL) == 0) {
+            while (count > 0 && (lineCells[count - 1].flags & EF_REAL) == 0) {
                 count--;
             }
 
@@ -2145,7 +2573,7 @@ QList<int> Screen::getCharacterCounts() const
         }
 
         // If the last character is wide, account for it
-        if (Character::width(characterBuffer[count - 1].character, _ignoreWcWidth) == 2)
+        if (Character::width(lineCells[count - 1].character, _ignoreWcWidth) == 2)
             count++;
 
         // When users ask not to preserve the linebreaks, they usually mean:
@@ -2328,10 +2756,21 @@ void Screen::writeLinesToStream(TerminalCharacterDecoder *decoder, int fromLine,
 
 void Screen::fastAddHistLine()
 {
+    AllocationTracker::Scope allocationScope(AllocationTracker::HistorySubsystem);
+
     const bool removeLine = _history->getLines() == _history->getMaxLines();
     _history->addCellsVector(_screenLines.at(0));
     _history->addLine(linePropertiesAt(0));
 
+    if (_promptLinesValid) {
+        if (removeLine) {
+            promptLinesDropped(1);
+        }
+        if (linePropertiesAt(0).flags.f.prompt_start) {
+            _promptLines.append(_history->getLines() - 1);
+        }
+    }
+
     // If _history size > max history size it will drop a line from _history.
     // We need to verify if we need to remove a URL.
     if (removeLine) {
@@ -2340,26 +2779,38 @@ void Screen::fastAddHistLine()
         }
 
         _fastDroppedLines++;
+        _totalDroppedLines++;
     }
-    // Rotate left + clear the last line
+    markAllLinesDirty();
+
+    // Rotate left + clear the last line, reusing its allocation.
+    // (This previously filled a detached copy of the line, leaving the
+    // moved-out content visible at the bottom of the screen.)
     std::rotate(_screenLines.begin(), _screenLines.begin() + 1, _screenLines.end());
-    auto last = _screenLines.back();
+    ImageLine &last = _screenLines.back();
     Character clearCh(uint(' '), _currentForeground, _currentBackground, DEFAULT_RENDITION, false);
     std::fill(last.begin(), last.end(), clearCh);
 
     _lineProperties.erase(_lineProperties.begin());
 }
 
-void Screen::addHistLine()
+void Screen::addHistLine(int line)
 {
+    AllocationTracker::Scope allocationScope(AllocationTracker::HistorySubsystem);
+
+    // a finished background type conversion hands over its target here,
+    // and output into a hibernated history swaps the restored scroll in
+    HistoryScrollConversion::collapse(_history);
+    HistoryScrollHibernated::collapse(_history);
+
     // add line to history buffer
     // we have to take care about scrolling, too...
     const int oldHistLines = _history->getLines();
     int newHistLines = _history->getLines();
 
     if (hasScroll()) {
-        _history->addCellsVector(_screenLines.at(0));
-        _history->addLine(_lineProperties.at(0));
+        _history->addCellsVector(_screenLines.at(line));
+        _history->addLine(_lineProperties.at(line));
 
         newHistLines = _history->getLines();
 
@@ -2367,6 +2818,7 @@ void Screen::addHistLine()
         // of dropped _lines
         if (newHistLines <= oldHistLines) {
             _droppedLines += oldHistLines - newHistLines + 1;
+            _totalDroppedLines += oldHistLines - newHistLines + 1;
 
             currentTerminalDisplay()->removeLines(oldHistLines - newHistLines + 1);
             // We removed some lines, we need to verify if we need to remove a URL.
@@ -2374,6 +2826,15 @@ void Screen::addHistLine()
                 _escapeSequenceUrlExtractor->historyLinesRemoved(oldHistLines - newHistLines + 1);
             }
         }
+
+        if (_promptLinesValid) {
+            if (newHistLines <= oldHistLines) {
+                promptLinesDropped(oldHistLines - newHistLines + 1);
+            }
+            if (_lineProperties.at(line).flags.f.prompt_start) {
+                _promptLines.append(newHistLines - 1);
+            }
+        }
     }
 
     bool beginIsTL = (_selBegin == _selTopLeft);
@@ -2414,17 +2875,137 @@ void Screen::addHistLine()
     }
 }
 
+void Screen::addHistLines(int count)
+{
+    AllocationTracker::Scope allocationScope(AllocationTracker::HistorySubsystem);
+
+    // a finished background type conversion hands over its target here,
+    // and output into a hibernated history swaps the restored scroll in
+    HistoryScrollConversion::collapse(_history);
+    HistoryScrollHibernated::collapse(_history);
+
+    // Like addHistLine() for lines 0..count-1 at once, minus the
+    // selection bookkeeping (callers only batch without a selection).
+    // The single addLinesMove() call lets the backend trim and compress
+    // once per batch, which matters during `yes`-style floods.
+    if (!hasScroll()) {
+        return;
+    }
+
+    const int oldHistLines = _history->getLines();
+
+    // addLinesMove() may move the properties out, so note the prompt
+    // starts for the index first
+    QVarLengthArray<bool, 128> isPromptStart(_promptLinesValid ? count : 0);
+    for (int i = 0; i < isPromptStart.size(); ++i) {
+        isPromptStart[i] = _lineProperties.at(i).flags.f.prompt_start != 0;
+    }
+
+    _history->addLinesMove(_screenLines.data(), _lineProperties.data(), count);
+
+    const int newHistLines = _history->getLines();
+
+    // If the history is full, count the lines dropped off its top
+    if (newHistLines < oldHistLines + count) {
+        const int dropped = oldHistLines + count - newHistLines;
+        _droppedLines += dropped;
+        _totalDroppedLines += dropped;
+
+        currentTerminalDisplay()->removeLines(dropped);
+        // We removed some lines, we need to verify if we need to remove a URL.
+        if (_escapeSequenceUrlExtractor) {
+            _escapeSequenceUrlExtractor->historyLinesRemoved(dropped);
+        }
+    }
+
+    if (_promptLinesValid) {
+        promptLinesDropped(oldHistLines + count - newHistLines);
+        for (int i = 0; i < count; ++i) {
+            const int histLine = newHistLines - count + i;
+            if (histLine >= 0 && isPromptStart[i]) {
+                _promptLines.append(histLine);
+            }
+        }
+    }
+}
+
 int Screen::getHistLines() const
 {
     return _history->getLines();
 }
 
+int Screen::dropOldestHistoryLines(int keepLines)
+{
+    const int dropped = _history->dropOldestLines(keepLines);
+    if (dropped == 0) {
+        return 0;
+    }
+
+    _droppedLines += dropped;
+    _totalDroppedLines += dropped;
+
+    if (currentTerminalDisplay()) {
+        currentTerminalDisplay()->removeLines(dropped);
+    }
+    if (_escapeSequenceUrlExtractor) {
+        _escapeSequenceUrlExtractor->historyLinesRemoved(dropped);
+    }
+    promptLinesDropped(dropped);
+
+    // every absolute location moved up by the dropped lines
+    if (_selBegin != -1) {
+        const int delta = _columns * dropped;
+        _selTopLeft -= delta;
+        _selBottomRight -= delta;
+        _selBegin -= delta;
+        if (_selBegin < 0 || _selTopLeft < 0) {
+            clearSelection();
+        }
+    }
+
+    return dropped;
+}
+
+qint64 Screen::historySizeBytes() const
+{
+    return _history->sizeBytes();
+}
+
+qint64 Screen::bufferSizeBytes() const
+{
+    qint64 bytes = qint64(_screenLines.capacity()) * sizeof(ImageLine);
+    for (const ImageLine &line : _screenLines) {
+        bytes += qint64(line.capacity()) * sizeof(Character);
+    }
+    bytes += qint64(_lineProperties.capacity()) * sizeof(LineProperty);
+    return bytes;
+}
+
+HistoryTrigramIndex *Screen::historyTrigramIndex() const
+{
+    return _history->trigramIndex();
+}
+
 void Screen::setScroll(const HistoryType &t, bool copyPreviousScroll)
 {
     clearSelection();
 
     if (copyPreviousScroll) {
-        t.scroll(_history);
+        // a hibernated history must be restored before it can be copied,
+        // and it has to happen here rather than on the conversion worker
+        thawHistory();
+        // copying a large history into the new scroll on this (the GUI)
+        // thread freezes the application, so stream it on a worker where
+        // possible; the session stays live, new lines queue up behind the
+        // copy, and the proxy is collapsed once the backfill is done
+        const bool unchanged = dynamic_cast<HistoryScrollFile *>(_history.get()) != nullptr && dynamic_cast<const HistoryTypeFile *>(&t) != nullptr;
+        if (!unchanged && _historySnapshotPath.isEmpty() && HistoryScrollConversion::suitable(*_history, t)) {
+            std::unique_ptr<HistoryScroll> target;
+            t.scroll(target);
+            _history = std::make_unique<HistoryScrollConversion>(std::move(_history), std::move(target));
+        } else {
+            t.scroll(_history);
+        }
     } else {
         // As 't' can be '_history' pointer, move it to a temporary smart pointer
         // making _history = nullptr
@@ -2432,9 +3013,24 @@ void Screen::setScroll(const HistoryType &t, bool copyPreviousScroll)
         if (currentTerminalDisplay()) {
             currentTerminalDisplay()->removeLines(oldHistory->getLines());
         }
-        t.scroll(_history);
+        // when the new type would recreate the same file-backed scroll,
+        // clear the old one in place instead: it keeps its temp files and
+        // their preallocated extents, so clearing the history does not
+        // truncate the files just to regrow them
+        if (dynamic_cast<const HistoryTypeFile *>(&t) != nullptr && oldHistory->clearInPlace()) {
+            _history = std::move(oldHistory);
+        } else {
+            t.scroll(_history);
+            // the old scroll's snapshot writer must close before the new
+            // scroll attaches to the same file below
+            oldHistory.reset();
+        }
+    }
+    if (!_historySnapshotPath.isEmpty()) {
+        applyHistorySnapshot();
     }
     _graphicsPlacements.clear();
+    invalidatePromptLines();
 #if HAVE_MALLOC_TRIM
 
 #ifdef Q_OS_LINUX
@@ -2444,6 +3040,55 @@ void Screen::setScroll(const HistoryType &t, bool copyPreviousScroll)
 #endif
 }
 
+void Screen::setHistorySnapshot(const QString &path)
+{
+    _historySnapshotPath = path;
+    _snapshotRestorePending = !path.isEmpty();
+    if (!path.isEmpty()) {
+        applyHistorySnapshot();
+    }
+}
+
+bool Screen::hibernateHistory(const QString &path)
+{
+    // a snapshot-mirrored history already lives on disk, and the writer
+    // could not follow the scroll being swapped out underneath it
+    if (!_historySnapshotPath.isEmpty()) {
+        return false;
+    }
+    return HistoryScrollHibernated::hibernate(_history, path, [this] {
+        return usedExtendedChars();
+    });
+}
+
+void Screen::thawHistory()
+{
+    if (auto *hibernated = dynamic_cast<HistoryScrollHibernated *>(_history.get())) {
+        hibernated->thaw();
+        HistoryScrollHibernated::collapse(_history);
+    }
+}
+
+void Screen::applyHistorySnapshot()
+{
+    if (!_history->hasScroll()) {
+        // attaching the writer to a scroll that drops every line would
+        // truncate a snapshot that has not been restored yet; wait for
+        // setScroll() to install a real history type
+        return;
+    }
+    if (_snapshotRestorePending) {
+        _snapshotRestorePending = false;
+        if (_history->getLines() == 0) {
+            restoreHistorySnapshot(_historySnapshotPath, *_history, [this] {
+                return usedExtendedChars();
+            });
+            invalidatePromptLines();
+        }
+    }
+    _history->enableSnapshot(_historySnapshotPath);
+}
+
 bool Screen::hasScroll() const
 {
     return _history->hasScroll();
@@ -2503,6 +3148,81 @@ void Screen::setReplMode(int mode)
     }
 }
 
+const QList<int> &Screen::promptLines() const
+{
+    if (!_promptLinesValid) {
+        _promptLines.clear();
+        const int histLines = _history->getLines();
+        for (int i = 0; i < histLines; ++i) {
+            if (_history->getLineProperty(i).flags.f.prompt_start) {
+                _promptLines.append(i);
+            }
+        }
+        _promptLinesValid = true;
+    }
+    return _promptLines;
+}
+
+void Screen::invalidatePromptLines()
+{
+    _promptLines.clear();
+    _promptLinesValid = false;
+}
+
+void Screen::promptLinesDropped(int count)
+{
+    if (!_promptLinesValid || count <= 0) {
+        return;
+    }
+    for (int &line : _promptLines) {
+        line -= count;
+    }
+    while (!_promptLines.isEmpty() && _promptLines.first() < 0) {
+        _promptLines.removeFirst();
+    }
+}
+
+int Screen::findPromptLine(int fromLine, bool forward) const
+{
+    const int histLines = _history->getLines();
+    if (forward) {
+        // prompts in the history come before any on the visible screen
+        const QList<int> &prompts = promptLines();
+        auto it = std::upper_bound(prompts.begin(), prompts.end(), fromLine);
+        if (it != prompts.end()) {
+            return *it;
+        }
+        for (int i = qMax(0, fromLine + 1 - histLines); i < (int)_lineProperties.size(); ++i) {
+            if (_lineProperties.at(i).flags.f.prompt_start) {
+                return histLines + i;
+            }
+        }
+    } else {
+        for (int i = qMin((int)_lineProperties.size() - 1, fromLine - 1 - histLines); i >= 0; --i) {
+            if (_lineProperties.at(i).flags.f.prompt_start) {
+                return histLines + i;
+            }
+        }
+        const QList<int> &prompts = promptLines();
+        auto it = std::lower_bound(prompts.begin(), prompts.end(), fromLine);
+        if (it != prompts.begin()) {
+            return *(it - 1);
+        }
+    }
+    return -1;
+}
+
+std::pair<int, int> Screen::commandExtent(int line) const
+{
+    const int first = findPromptLine(line + 1, false);
+    if (first < 0) {
+        return {-1, -1};
+    }
+    const int next = findPromptLine(first, true);
+    const int last = next < 0 ? _history->getLines() + _lines - 1 : next - 1;
+    return {first, last};
+}
+
 void Screen::setExitCode(int exitCode)
 {
     int y = _cuY - 1;
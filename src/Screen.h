@@ -54,6 +54,7 @@ class TerminalCharacterDecoder;
 class TerminalDisplay;
 class HistoryType;
 class HistoryScroll;
+class HistoryTrigramIndex;
 class EscapeSequenceUrlExtractor;
 
 /**
@@ -407,6 +408,18 @@ public:
      */
     void displayCharacter(uint c);
 
+    /**
+     * Displays a run of characters starting at the current cursor position.
+     *
+     * Equivalent to calling displayCharacter() for each element of @p c, but
+     * runs of simple width-1 characters that fit on the current line are
+     * written in one batch: the line is validated and grown once, the
+     * selection is checked once and the cells are filled in a tight loop.
+     * Wide characters, combining marks and line wraps fall back to the
+     * per-character path.
+     */
+    void displayCharacters(const uint *c, int count);
+
     /**
      * Resizes the image to a new fixed size of @p new_lines by @p new_columns.
      * In the case that @p new_columns is smaller than the current number of columns,
@@ -439,6 +452,28 @@ public:
      */
     QVector<LineProperty> getLineProperties(int startLine, int endLine) const;
 
+    /**
+     * Returns a counter which increases whenever the content of a screen
+     * line changes. Views remember the value at their last image fetch and
+     * compare it against lineGeneration() to skip diffing clean lines.
+     */
+    quint64 contentGeneration() const
+    {
+        return _currentGeneration;
+    }
+
+    /**
+     * Returns the value contentGeneration() had when screen line @p line
+     * (0 = top of the visible screen, history excluded) last changed.
+     */
+    quint64 lineGeneration(int line) const
+    {
+        if (line < 0 || line >= static_cast<int>(_lineGenerations.size())) {
+            return _currentGeneration;
+        }
+        return qMax(_lineGenerations[line], _allDirtyGeneration);
+    }
+
     /** Return the number of lines. */
     int getLines() const
     {
@@ -453,6 +488,24 @@ public:
 
     /** Return the number of lines in the history buffer. */
     int getHistLines() const;
+    /**
+     * Drops the oldest history lines down to @p keepLines where the
+     * history backend supports a cheap trim, adjusting the dropped-line
+     * accounting, selection and prompt index like a history-full drop.
+     * Returns the number of lines dropped.  Used by the memory-pressure
+     * trimmer.
+     */
+    int dropOldestHistoryLines(int keepLines);
+    /** Approximate number of bytes held by the history buffer. */
+    qint64 historySizeBytes() const;
+    /** Approximate number of bytes held by the screen image itself. */
+    qint64 bufferSizeBytes() const;
+    /**
+     * Returns the trigram index maintained over the history buffer, or
+     * nullptr when disabled.  Used by SearchHistoryTask to narrow the
+     * search down to candidate lines.
+     */
+    HistoryTrigramIndex *historyTrigramIndex() const;
     /**
      * Sets the type of storage used to keep lines in the history.
      * If @p copyPreviousScroll is true then the contents of the previous
@@ -461,6 +514,23 @@ public:
     void setScroll(const HistoryType &, bool copyPreviousScroll = true);
     /** Returns the type of storage used to keep lines in the history. */
     const HistoryType &getScroll() const;
+    /**
+     * Keeps an on-disk snapshot of the history buffer at @p path.  If a
+     * snapshot from a previous run exists there and the history is still
+     * empty, its lines are restored first; afterwards every change to the
+     * history is mirrored to the file (see HistorySnapshotWriter).
+     */
+    void setHistorySnapshot(const QString &path);
+    /**
+     * Serializes the history buffer to a snapshot at @p path and frees
+     * its RAM, leaving a stand-in that restores from the file on the
+     * first access needing line data (see HistoryScrollHibernated).
+     * Returns false when the history backend does not support
+     * hibernation or the snapshot cannot be written.
+     */
+    bool hibernateHistory(const QString &path);
+    /** Restores a hibernated history buffer, if any. */
+    void thawHistory();
     /**
      * Returns true if this screen keeps lines that are scrolled off the screen
      * in a history buffer.
@@ -514,12 +584,33 @@ public:
      */
     bool isSelected(const int x, const int y) const;
 
+    /**
+     * Returns in @p firstColumn and @p lastColumn the inclusive column
+     * range of @p line covered by the current selection, or false if the
+     * line has no selected cells.  This is an O(1) query; the image copy
+     * loops use it to mark a whole line's selection as one span instead
+     * of testing every cell.
+     */
+    bool selectedSpan(const int line, int &firstColumn, int &lastColumn) const;
+
     /**
      * Convenience method.  Returns the currently selected text.
      * @param options See Screen::DecodingOptions
      */
     QString selectedText(const DecodingOptions options) const;
 
+    /**
+     * Returns in @p startIndex and @p endIndex the character range that
+     * selectedText() would decode - the current selection, or the REPL
+     * fallback used when nothing is selected.  Returns false if there is
+     * nothing to copy.  The indexes stay valid for passing to text() until
+     * the screen contents change; see SelectionMimeData.
+     */
+    bool selectedTextRange(int &startIndex, int &endIndex) const;
+
+    /** Returns true if the current selection is in column mode. */
+    bool blockSelectionMode() const;
+
     /**
      * Convenience method.  Returns the text between two indices.
      * @param startIndex Specifies the starting text index
@@ -602,6 +693,24 @@ public:
         return _replModeEnd;
     }
 
+    /**
+     * Returns the absolute line (history plus screen coordinates) of the
+     * nearest shell-integration prompt before (@p forward false) or after
+     * (@p forward true) @p fromLine, or -1 if there is none.
+     *
+     * Prompts in the history are answered from a sorted index in O(log n);
+     * only the visible screen lines are scanned.
+     */
+    int findPromptLine(int fromLine, bool forward) const;
+
+    /**
+     * Returns the absolute line range [first, last] covered by the prompt
+     * at or before @p line and the command output following it, ending
+     * before the next prompt or at the last line. Returns {-1, -1} when no
+     * prompt precedes @p line.
+     */
+    std::pair<int, int> commandExtent(int line) const;
+
     /**
      * Returns the number of lines that the image has been scrolled up or down by,
      * since the last call to resetScrolledLines().
@@ -638,6 +747,15 @@ public:
 
     int fastDroppedLines() const;
 
+    /**
+     * Returns the total number of lines dropped from the history since
+     * this screen was created.  Unlike droppedLines() this is never
+     * reset, so consumers holding absolute line references (such as
+     * cached search results) can renumber them by the difference
+     * between two readings.
+     */
+    int totalDroppedLines() const;
+
     /**
      * Resets the count of the number of lines dropped from
      * the history.
@@ -654,19 +772,12 @@ public:
 
     TerminalDisplay *currentTerminalDisplay();
 
-    QSet<uint> usedExtendedChars() const
-    {
-        QSet<uint> result;
-        for (int i = 0; i < _lines; ++i) {
-            const ImageLine &il = _screenLines[i];
-            for (int j = 0; j < il.length(); ++j) {
-                if (il[j].rendition.f.extended) {
-                    result << il[j].character;
-                }
-            }
-        }
-        return result;
-    }
+    /**
+     * Returns the extended-character keys reachable from this screen's
+     * image and scrollback history. Used by ExtendedCharTable to decide
+     * which sequences are still live when sweeping.
+     */
+    QSet<uint> usedExtendedChars() const;
 
     void setEnableUrlExtractor(const bool enable);
 
@@ -753,12 +864,27 @@ private:
     // via Konsole::Vt102Emulation::resetMode that checks for currentTerminalDisplay()
     QPointer<QWidget> _currentTerminalDisplay;
 
-    void addHistLine();
+    // add screen line 'line' to the history; scrollUp() hands over all the
+    // lines that scroll out before moving the image once
+    void addHistLine(int line = 0);
+    // batched variant of addHistLine() for the common case of several
+    // scrolled-out lines and no active selection; hands screen lines
+    // 0..count-1 to the history in one call
+    void addHistLines(int count);
     // add lines from _screen to _history and remove from _screen the added lines (used to resize lines and columns)
     void fastAddHistLine();
 
     void initTabStops();
 
+    // reserve full column capacity for every screen line so that incremental
+    // growth and scrolling reuse the existing heap blocks
+    void reserveLineCapacity();
+
+    // dirty-line tracking; see contentGeneration()
+    void markLineDirty(int line);
+    void markRegionDirty(int fromLine, int toLine);
+    void markAllLinesDirty();
+
     void updateEffectiveRendition();
     void reverseRendition(Character &p) const;
 
@@ -804,11 +930,20 @@ private:
     std::vector<ImageLine> _screenLines; // [lines]
     int _screenLinesSize; // _screenLines.size()
 
+    // per-line content generations; see contentGeneration()
+    std::vector<quint64> _lineGenerations; // [lines]
+    quint64 _currentGeneration = 1;
+    quint64 _allDirtyGeneration = 1;
+
     int _scrolledLines;
+    // see recordScrolledRegion(); invalid when scrolls of different
+    // regions coalesced into the current update cycle
     QRect _lastScrolledRegion;
+    void recordScrolledRegion(const QRect &region);
 
     int _droppedLines;
     int _fastDroppedLines;
+    int _totalDroppedLines;
 
     int _oldTotalLines;
     bool _isResize;
@@ -817,8 +952,28 @@ private:
     std::vector<LineProperty> _lineProperties;
     LineProperty linePropertiesAt(unsigned int line);
 
+    // Sorted absolute lines of prompt starts in the history portion; see
+    // findPromptLine(). Maintained incrementally as lines enter or drop out
+    // of the history and rebuilt lazily after reflow. The visible screen
+    // changes too often to index and is scanned on demand instead.
+    const QList<int> &promptLines() const;
+    void invalidatePromptLines();
+    void promptLinesDropped(int count);
+    mutable QList<int> _promptLines;
+    mutable bool _promptLinesValid = false;
+
+    // restores and/or (re)attaches the snapshot writer to _history
+    void applyHistorySnapshot();
+
     // history buffer ---------------
     std::unique_ptr<HistoryScroll> _history;
+    // history line of the last viewport copy; successive values give the
+    // scroll direction used to prefetch the adjacent page (copyFromHistory)
+    mutable int _lastHistoryCopyLine = 0;
+    // path of the on-disk history snapshot, empty when disabled
+    QString _historySnapshotPath;
+    // restore is attempted once, on the first scroll that can hold lines
+    bool _snapshotRestorePending = false;
 
     // cursor location
     int _cuX;
@@ -896,6 +1051,10 @@ private:
 
     // used in REP (repeating char)
     quint32 _lastDrawnChar;
+
+    // carries Hangul syllable state across consecutive jamo in the
+    // display path
+    Hangul::Composer _hangulComposer;
     std::unique_ptr<EscapeSequenceUrlExtractor> _escapeSequenceUrlExtractor;
     void toggleUrlInput();
 
@@ -16,6 +16,7 @@ ScreenWindow::ScreenWindow(Screen *screen, QObject *parent)
     , _screen(nullptr)
     , _windowBuffer(nullptr)
     , _windowBufferSize(0)
+    , _windowBufferCapacity(0)
     , _bufferNeedsUpdate(true)
     , _windowLines(1)
     , _currentLine(0)
@@ -41,6 +42,8 @@ void ScreenWindow::setScreen(Screen *screen)
 
     Q_EMIT screenAboutToChange();
     _screen = screen;
+    _allLinesDirty = true;
+    _fetchedCurrentLine = -1;
 }
 
 Screen *ScreenWindow::screen() const
@@ -50,12 +53,17 @@ Screen *ScreenWindow::screen() const
 
 Character *ScreenWindow::getImage()
 {
-    // reallocate internal buffer if the window size has changed
+    // grow the internal buffer if the window no longer fits; the
+    // allocation is kept when the window shrinks, as interactive resizing
+    // changes the size once per mouse event
     int size = windowLines() * windowColumns();
-    if (_windowBuffer == nullptr || _windowBufferSize != size) {
+    if (_windowBuffer == nullptr || size > _windowBufferCapacity) {
         delete[] _windowBuffer;
-        _windowBufferSize = size;
         _windowBuffer = new Character[size];
+        _windowBufferCapacity = size;
+    }
+    if (_windowBufferSize != size) {
+        _windowBufferSize = size;
         _bufferNeedsUpdate = true;
     }
 
@@ -63,6 +71,8 @@ Character *ScreenWindow::getImage()
         return _windowBuffer;
     }
 
+    updateDirtyLines();
+
     _screen->getImage(_windowBuffer, size, currentLine(), endWindowLine());
 
     // this window may look beyond the end of the screen, in which
@@ -70,10 +80,132 @@ Character *ScreenWindow::getImage()
     // with blank characters
     fillUnusedArea();
 
+    _fetchedGeneration = _screen->contentGeneration();
+    _fetchedCurrentLine = currentLine();
+    _fetchedCursor = cursorPosition();
+    _fetchedCursorVisible = _screen->getMode(MODE_Cursor);
+    _fetchedReverseVideo = _screen->getMode(MODE_Screen);
+    _fetchedSelectCursor = _screen->getMode(MODE_SelectCursor);
+    int column;
+    int line;
+    _screen->getSelectionStart(column, line);
+    _fetchedSelectionStart = QPoint(column, line);
+    _screen->getSelectionEnd(column, line);
+    _fetchedSelectionEnd = QPoint(column, line);
     _bufferNeedsUpdate = false;
     return _windowBuffer;
 }
 
+bool ScreenWindow::renderStateChanged() const
+{
+    // MODE_SelectCursor paints a second cursor from coordinates the screen
+    // does not expose; never reuse the buffer while it is active, nor the
+    // one fetched while it was (the second cursor is baked into it)
+    if (_screen->getMode(MODE_SelectCursor) || _fetchedSelectCursor) {
+        return true;
+    }
+    if (cursorPosition() != _fetchedCursor || _screen->getMode(MODE_Cursor) != _fetchedCursorVisible || _screen->getMode(MODE_Screen) != _fetchedReverseVideo) {
+        return true;
+    }
+    int column;
+    int line;
+    _screen->getSelectionStart(column, line);
+    if (QPoint(column, line) != _fetchedSelectionStart) {
+        return true;
+    }
+    _screen->getSelectionEnd(column, line);
+    return QPoint(column, line) != _fetchedSelectionEnd;
+}
+
+void ScreenWindow::updateDirtyLines()
+{
+    // Dirty bits accumulate across buffer refreshes until the view calls
+    // resetDirtyLines(); other consumers of getImage() (e.g. the filter
+    // chain) must not eat updates the view has not painted yet.
+    if (_dirtyLines.size() != windowLines()) {
+        _dirtyLines.resize(windowLines());
+        _allLinesDirty = true;
+    }
+
+    // If the window moved (scrolling, new history lines while tracking
+    // output) every line shows different content.
+    if (currentLine() != _fetchedCurrentLine) {
+        _allLinesDirty = true;
+    }
+
+    if (_allLinesDirty) {
+        return;
+    }
+
+    // Screen::getImage() bakes render state into the buffer without
+    // touching any line generation: reverse video inverts every cell, the
+    // cursor rendition flags one cell and the selection flags its span.
+    // A whole-buffer flip dirties everything; cursor and selection moves
+    // dirty the window lines they leave and enter.
+    if (_screen->getMode(MODE_Cursor) != _fetchedCursorVisible //
+        || _screen->getMode(MODE_Screen) != _fetchedReverseVideo //
+        || _screen->getMode(MODE_SelectCursor) || _fetchedSelectCursor) {
+        _allLinesDirty = true;
+        return;
+    }
+
+    const int screenStartLine = _screen->getHistLines();
+
+    const QPoint cursor = cursorPosition();
+    if (cursor != _fetchedCursor) {
+        markWindowLineDirty(screenStartLine + _fetchedCursor.y() - currentLine());
+        markWindowLineDirty(screenStartLine + cursor.y() - currentLine());
+    }
+
+    int column;
+    int line;
+    _screen->getSelectionStart(column, line);
+    const QPoint selectionStart(column, line);
+    _screen->getSelectionEnd(column, line);
+    const QPoint selectionEnd(column, line);
+    if (selectionStart != _fetchedSelectionStart || selectionEnd != _fetchedSelectionEnd) {
+        // the union of the old and new spans, in absolute lines, clipped
+        // to the window
+        const int firstLine = qMin(qMin(selectionStart.y(), selectionEnd.y()), qMin(_fetchedSelectionStart.y(), _fetchedSelectionEnd.y()));
+        const int lastLine = qMax(qMax(selectionStart.y(), selectionEnd.y()), qMax(_fetchedSelectionStart.y(), _fetchedSelectionEnd.y()));
+        const int first = qMax(firstLine - currentLine(), 0);
+        const int last = qMin(lastLine - currentLine(), windowLines() - 1);
+        for (int i = first; i <= last; ++i) {
+            _dirtyLines.setBit(i);
+        }
+    }
+
+    // History lines are immutable while the window stays put; only lines
+    // backed by the visible screen can have changed.
+    for (int i = 0; i < windowLines(); ++i) {
+        const int screenLine = currentLine() + i - screenStartLine;
+        if (screenLine >= 0 && _screen->lineGeneration(screenLine) > _fetchedGeneration) {
+            _dirtyLines.setBit(i);
+        }
+    }
+}
+
+void ScreenWindow::markWindowLineDirty(int line)
+{
+    if (line >= 0 && line < _dirtyLines.size()) {
+        _dirtyLines.setBit(line);
+    }
+}
+
+bool ScreenWindow::isLineDirty(int line) const
+{
+    if (_allLinesDirty || line < 0 || line >= _dirtyLines.size()) {
+        return true;
+    }
+    return _dirtyLines.testBit(line);
+}
+
+void ScreenWindow::resetDirtyLines()
+{
+    _dirtyLines.fill(false);
+    _allLinesDirty = false;
+}
+
 void ScreenWindow::fillUnusedArea()
 {
     int screenEndLine = _screen->getHistLines() + _screen->getLines() - 1;
@@ -120,6 +252,16 @@ QString ScreenWindow::selectedText(const Screen::DecodingOptions options) const
     return _screen->selectedText(options);
 }
 
+int ScreenWindow::findPromptLine(int fromLine, bool forward) const
+{
+    return _screen->findPromptLine(fromLine, forward);
+}
+
+std::pair<int, int> ScreenWindow::commandExtent(int line) const
+{
+    return _screen->commandExtent(line);
+}
+
 void ScreenWindow::getSelectionStart(int &column, int &line)
 {
     _screen->getSelectionStart(column, line);
@@ -168,6 +310,7 @@ void ScreenWindow::clearSelection()
 {
     _screen->clearSelection();
 
+    _bufferNeedsUpdate = true;
     Q_EMIT selectionChanged();
 }
 
@@ -239,26 +382,23 @@ void ScreenWindow::scrollBy(RelativeScrollMode mode, int amount, bool fullPage)
         }
     } else if (mode == ScrollPrompts) {
         int i = currentLine();
-        if (amount < 0) {
-            QVector<LineProperty> properties = _screen->getLineProperties(0, currentLine());
-            while (i > 0 && amount < 0) {
-                i--;
-                if ((properties[i].flags.f.prompt_start) != 0) {
-                    if (++amount == 0) {
-                        break;
-                    }
-                }
+        while (amount < 0) {
+            const int prompt = _screen->findPromptLine(i, false);
+            if (prompt < 0) {
+                i = 0;
+                break;
             }
-        } else if (amount > 0) {
-            QVector<LineProperty> properties = _screen->getLineProperties(currentLine(), _screen->getHistLines());
-            while (i < _screen->getHistLines() && amount > 0) {
-                i++;
-                if ((properties[i - currentLine()].flags.f.prompt_start) != 0) {
-                    if (--amount == 0) {
-                        break;
-                    }
-                }
+            i = prompt;
+            ++amount;
+        }
+        while (amount > 0) {
+            const int prompt = _screen->findPromptLine(i, true);
+            if (prompt < 0 || prompt > _screen->getHistLines()) {
+                i = _screen->getHistLines();
+                break;
             }
+            i = prompt;
+            --amount;
         }
         scrollTo(i);
     }
@@ -347,7 +487,12 @@ void ScreenWindow::notifyOutputChanged()
         _currentLine = qMin(_currentLine, _screen->getHistLines());
     }
 
-    _bufferNeedsUpdate = true;
+    // the buffer is a snapshot of the screen state; refetch it only when
+    // any of that state actually changed, so redundant refresh ticks reuse
+    // the cached image instead of re-copying the whole window
+    if (_screen->contentGeneration() != _fetchedGeneration || currentLine() != _fetchedCurrentLine || renderStateChanged()) {
+        _bufferNeedsUpdate = true;
+    }
 
     Q_EMIT outputChanged();
 }
@@ -8,6 +8,7 @@
 #define SCREENWINDOW_H
 
 // Qt
+#include <QBitArray>
 #include <QObject>
 #include <QPoint>
 #include <QRect>
@@ -223,8 +224,33 @@ public:
      */
     QString selectedText(const Screen::DecodingOptions options) const;
 
+    /**
+     * Returns the line of the nearest shell-integration prompt before or
+     * after @p fromLine, in the same absolute coordinates used by
+     * scrollTo(), or -1 if there is none. See Screen::findPromptLine().
+     */
+    int findPromptLine(int fromLine, bool forward) const;
+
+    /**
+     * Returns the absolute line range covered by the prompt at or before
+     * @p line and its command output. See Screen::commandExtent().
+     */
+    std::pair<int, int> commandExtent(int line) const;
+
     void updateCurrentLine();
 
+    /**
+     * Returns true if window line @p line may have changed since the last
+     * call to resetDirtyLines(). Computed from the screen's per-line
+     * content generations when getImage() refreshes the buffer; views can
+     * skip diffing lines for which this returns false.
+     */
+    bool isLineDirty(int line) const;
+
+    /** Marks all window lines as clean. Called by the view once it has
+     * consumed the image returned by getImage(). */
+    void resetDirtyLines();
+
 public Q_SLOTS:
     /**
      * Notifies the window that the contents of the associated terminal screen have changed.
@@ -256,15 +282,25 @@ Q_SIGNALS:
      */
     void screenAboutToChange();
 
+    /**
+     * Emitted just before the contents of the associated screens are
+     * modified; relayed from Emulation::contentsAboutToChange().
+     */
+    void contentsAboutToChange();
+
 private:
     Q_DISABLE_COPY(ScreenWindow)
 
     int endWindowLine() const;
     void fillUnusedArea();
+    void updateDirtyLines();
+    void markWindowLineDirty(int line);
+    bool renderStateChanged() const;
 
     Screen *_screen; // see setScreen() , screen()
     Character *_windowBuffer;
-    int _windowBufferSize;
+    int _windowBufferSize; // cells the current window uses
+    int _windowBufferCapacity; // cells allocated; grows only
     bool _bufferNeedsUpdate;
 
     int _windowLines;
@@ -273,6 +309,21 @@ private:
     bool _trackOutput; // see setTrackOutput() , trackOutput()
     int _scrollCount; // count of lines which the window has been scrolled by since
     // the last call to resetScrollCount()
+
+    // dirty-line bookkeeping; see isLineDirty()
+    QBitArray _dirtyLines;
+    quint64 _fetchedGeneration = 0; // screen generation at the last buffer fill
+    int _fetchedCurrentLine = -1; // window position at the last buffer fill
+    bool _allLinesDirty = true;
+
+    // state which Screen::getImage() bakes into the buffer beyond the line
+    // content covered by contentGeneration(); see renderStateChanged()
+    QPoint _fetchedCursor = QPoint(-1, -1);
+    QPoint _fetchedSelectionStart = QPoint(-1, -1);
+    QPoint _fetchedSelectionEnd = QPoint(-1, -1);
+    bool _fetchedCursorVisible = false;
+    bool _fetchedReverseVideo = false;
+    bool _fetchedSelectCursor = false;
 };
 }
 #endif // SCREENWINDOW_H
@@ -8,13 +8,53 @@
 #include "SearchHistoryTask.h"
 
 #include <QApplication>
+#include <QMutex>
+#include <QRunnable>
+#include <QSemaphore>
 #include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
 
 #include "../decoders/PlainTextDecoder.h"
 #include "Emulation.h"
+#include "Screen.h"
+#include "history/HistoryTrigramIndex.h"
 
 namespace Konsole
 {
+/**
+ * Returns the literal string the expression matches when its pattern
+ * contains no regular expression constructs beyond escaping, otherwise
+ * an empty string.  Plain-text searches arrive here through
+ * QRegularExpression::escape() and therefore always qualify.
+ */
+static QString exactLiteral(const QRegularExpression &regExp)
+{
+    const QString pattern = regExp.pattern();
+    const QString metaCharacters = QStringLiteral(".[]{}()*+?|^$");
+    QString literal;
+    for (qsizetype i = 0; i < pattern.size(); i++) {
+        const QChar ch = pattern.at(i);
+        if (ch == QLatin1Char('\\')) {
+            if (i + 1 >= pattern.size()) {
+                return QString();
+            }
+            const QChar escaped = pattern.at(++i);
+            // escaped letters and digits are class or assertion
+            // shortcuts (\d, \b, \x ...), not the characters themselves
+            if (escaped.isLetterOrNumber()) {
+                return QString();
+            }
+            literal.append(escaped);
+        } else if (metaCharacters.contains(ch)) {
+            return QString();
+        } else {
+            literal.append(ch);
+        }
+    }
+    return literal;
+}
+
 void SearchHistoryTask::addScreenWindow(Session *session, ScreenWindow *searchWindow)
 {
     _windows.insert(session, searchWindow);
@@ -84,30 +124,21 @@ void SearchHistoryTask::executeOnScreenWindow(const QPointer<Session> &session,
         // of the output and continue from the other
         // end
 
-        QSet<int> matchPositions;
+        if (_hasCandidateLines) {
+            // a narrowing search only has to look at the lines the
+            // previous pattern matched; skip the full history decode
+            findMatchesInCandidates(window, emulation);
+        } else {
+            decoder.begin(&searchStream);
+            emulation->writeToStream(&decoder, 0, lastLine);
+            decoder.end();
+            const QList<int> linePositions = decoder.linePositions();
 
-        decoder.begin(&searchStream);
-        emulation->writeToStream(&decoder, 0, lastLine);
-        decoder.end();
-        const QList<int> linePositions = decoder.linePositions();
+            findAllMatches(string, linePositions, window);
 
-        QRegularExpressionMatchIterator matchIterator = _regExp.globalMatch(string);
-        while (matchIterator.hasNext()) {
-            const QRegularExpressionMatch match = matchIterator.next();
-            const qsizetype startPos = match.capturedStart();
-            if (startPos != -1) {
-                const auto lineMatch = std::upper_bound(linePositions.begin(), linePositions.end(), startPos);
-                if (lineMatch != linePositions.end()) {
-                    const auto lineIdx = qMin(0ll, lastLine) + std::distance(linePositions.begin(), lineMatch) - 1;
-                    matchPositions.insert(static_cast<int>(lineIdx));
-                }
-            }
+            string.clear();
         }
 
-        Q_EMIT searchResults(matchPositions, window->lineCount());
-
-        string.clear();
-
         // loop through history in blocks of <delta> lines.
         do {
             // ensure that application does not appear to hang
@@ -204,6 +235,167 @@ void SearchHistoryTask::executeOnScreenWindow(const QPointer<Session> &session,
 
     Q_EMIT completed(false);
 }
+void SearchHistoryTask::findAllMatches(const QString &string, const QList<int> &linePositions, const ScreenWindowPtr &window)
+{
+    const int lineCount = window->lineCount();
+
+    // A literal search against an indexed history only has to look at
+    // the candidate lines the index proposes, plus the on-screen lines
+    // the index does not cover.  The index guarantees a superset of the
+    // real match start lines as long as lines are wide enough for its
+    // boundary handling, hence the column check; any false candidates
+    // simply fail to match below.
+    Screen *screen = window->screen();
+    const HistoryTrigramIndex *index = (screen != nullptr) ? screen->historyTrigramIndex() : nullptr;
+    if (index != nullptr && window->columnCount() >= 8 && index->lineCount() == screen->getHistLines()) {
+        const QString literal = exactLiteral(_regExp);
+        if (!literal.isEmpty()) {
+            if (const auto candidates = index->candidateLines(literal)) {
+                QList<int> scanLines = *candidates;
+                for (int line = index->lineCount(); line < lineCount; line++) {
+                    scanLines.append(line);
+                }
+
+                QSet<int> matchPositions;
+                for (qsizetype i = 0; i < scanLines.size();) {
+                    // coalesce runs of consecutive lines into one region
+                    qsizetype runEnd = i + 1;
+                    while (runEnd < scanLines.size() && scanLines.at(runEnd) == scanLines.at(runEnd - 1) + 1) {
+                        runEnd++;
+                    }
+                    const int firstLine = scanLines.at(i);
+                    const int lastLine = scanLines.at(runEnd - 1);
+                    i = runEnd;
+                    if (firstLine >= linePositions.size()) {
+                        break;
+                    }
+                    const qsizetype regionStart = linePositions.at(firstLine);
+                    const qsizetype regionEnd = (lastLine + 1 < linePositions.size()) ? linePositions.at(lastLine + 1) : string.size();
+
+                    QRegularExpressionMatchIterator matchIterator = _regExp.globalMatch(string, regionStart);
+                    while (matchIterator.hasNext()) {
+                        const QRegularExpressionMatch match = matchIterator.next();
+                        const qsizetype startPos = match.capturedStart();
+                        if (startPos >= regionEnd) {
+                            break;
+                        }
+                        const auto lineMatch = std::upper_bound(linePositions.begin(), linePositions.end(), startPos);
+                        if (lineMatch != linePositions.end()) {
+                            const auto lineIdx = std::distance(linePositions.begin(), lineMatch) - 1;
+                            matchPositions.insert(static_cast<int>(lineIdx));
+                        }
+                    }
+                }
+                Q_EMIT searchResults(matchPositions, lineCount);
+                return;
+            }
+        }
+    }
+
+    // Scanning the whole decoded history with one regular expression pass
+    // locks the UI for seconds on very large scrollbacks.  The subject
+    // string is immutable here, so the scan is split over the thread pool:
+    // every worker iterates matches starting inside its own offset range
+    // (matches may extend past it, so no boundary is ever missed) and the
+    // scrollbar markers are updated as each range completes instead of
+    // once at the very end.
+    const int threadCount = qMax(1, QThread::idealThreadCount());
+    const qsizetype chunkSize = qMax<qsizetype>(4096, (string.size() + threadCount - 1) / threadCount);
+    const int chunkCount = qMax<qsizetype>(1, (string.size() + chunkSize - 1) / chunkSize);
+
+    QMutex resultMutex;
+    QList<QSet<int>> chunkResults(chunkCount);
+    QSemaphore chunksDone;
+
+    for (int chunk = 0; chunk < chunkCount; chunk++) {
+        const qsizetype chunkStart = chunk * chunkSize;
+        const qsizetype chunkEnd = qMin(string.size(), chunkStart + chunkSize);
+        QThreadPool::globalInstance()->start(QRunnable::create([&, chunk, chunkStart, chunkEnd]() {
+            QSet<int> matches;
+            QRegularExpressionMatchIterator matchIterator = _regExp.globalMatch(string, chunkStart);
+            while (matchIterator.hasNext()) {
+                const QRegularExpressionMatch match = matchIterator.next();
+                const qsizetype startPos = match.capturedStart();
+                if (startPos >= chunkEnd) {
+                    break;
+                }
+                if (startPos != -1) {
+                    const auto lineMatch = std::upper_bound(linePositions.begin(), linePositions.end(), startPos);
+                    if (lineMatch != linePositions.end()) {
+                        const auto lineIdx = std::distance(linePositions.begin(), lineMatch) - 1;
+                        matches.insert(static_cast<int>(lineIdx));
+                    }
+                }
+            }
+            QMutexLocker locker(&resultMutex);
+            chunkResults[chunk] = std::move(matches);
+            chunksDone.release();
+        }));
+    }
+
+    // stream the results back incrementally while the workers run, keeping
+    // the application responsive as in the block search loop below
+    QSet<int> matchPositions;
+    int merged = 0;
+    while (merged < chunkCount) {
+        chunksDone.acquire();
+        int newlyDone = 1 + chunksDone.tryAcquire(chunkCount - merged - 1);
+        {
+            QMutexLocker locker(&resultMutex);
+            while (newlyDone > 0) {
+                // the per-chunk sets arrive in any order, but merging into
+                // one set makes the emission order irrelevant
+                for (int chunk = 0; chunk < chunkCount; chunk++) {
+                    if (!chunkResults[chunk].isEmpty()) {
+                        matchPositions.unite(chunkResults[chunk]);
+                        chunkResults[chunk].clear();
+                    }
+                }
+                merged += newlyDone;
+                newlyDone = 0;
+            }
+        }
+        Q_EMIT searchResults(matchPositions, lineCount);
+        QApplication::processEvents();
+    }
+}
+
+void SearchHistoryTask::findMatchesInCandidates(const ScreenWindowPtr &window, Emulation *emulation)
+{
+    const int lineCount = window->lineCount();
+
+    QSet<int> matchPositions;
+    for (qsizetype i = 0; i < _candidateLines.size();) {
+        // coalesce runs of consecutive lines into one decode region
+        qsizetype runEnd = i + 1;
+        while (runEnd < _candidateLines.size() && _candidateLines.at(runEnd) == _candidateLines.at(runEnd - 1) + 1) {
+            runEnd++;
+        }
+        const int firstLine = qBound(0, _candidateLines.at(i), lineCount - 1);
+        const int lastLine = qBound(0, _candidateLines.at(runEnd - 1), lineCount - 1);
+        i = runEnd;
+
+        QString string;
+        QTextStream searchStream(&string);
+        PlainTextDecoder decoder;
+        decoder.setRecordLinePositions(true);
+        decoder.begin(&searchStream);
+        emulation->writeToStream(&decoder, firstLine, lastLine);
+        decoder.end();
+
+        const QList<int> linePositions = decoder.linePositions();
+        QRegularExpressionMatchIterator matchIterator = _regExp.globalMatch(string);
+        while (matchIterator.hasNext()) {
+            const QRegularExpressionMatch match = matchIterator.next();
+            const auto lineMatch = std::upper_bound(linePositions.begin(), linePositions.end(), match.capturedStart());
+            const auto lineIdx = std::distance(linePositions.begin(), lineMatch) - 1;
+            matchPositions.insert(firstLine + static_cast<int>(lineIdx));
+        }
+    }
+
+    Q_EMIT searchResults(matchPositions, lineCount);
+}
+
 void SearchHistoryTask::highlightResult(const ScreenWindowPtr &window, int findPos)
 {
     // work out how many lines into the current block of text the search result was found
@@ -244,6 +436,12 @@ void SearchHistoryTask::setStartLine(int line)
     _startLine = line;
 }
 
+void SearchHistoryTask::setCandidateLines(const QList<int> &lines)
+{
+    _candidateLines = lines;
+    _hasCandidateLines = true;
+}
+
 Enum::SearchDirection SearchHistoryTask::searchDirection() const
 {
     return _direction;
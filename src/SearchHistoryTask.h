@@ -66,6 +66,17 @@ public:
     /** The line from which the search will be done **/
     void setStartLine(int line);
 
+    /**
+     * Restricts the match-highlight scan to @p lines (sorted absolute
+     * line numbers) instead of decoding and scanning the whole history.
+     * Callers use this when the expression narrows a previous search -
+     * a literal whose text contains the previous literal can only match
+     * on lines that matched before - so incremental search-as-you-type
+     * costs work proportional to the previous result set.  Not valid
+     * for expressions that can match across line boundaries.
+     */
+    void setCandidateLines(const QList<int> &lines);
+
     /**
      * Performs a search through the session's history, starting at the position
      * of the current selection, in the direction specified by setSearchDirection().
@@ -84,11 +95,28 @@ private:
     void executeOnScreenWindow(const QPointer<Session> &session, const ScreenWindowPtr &window);
     void highlightResult(const ScreenWindowPtr &window, int findPos);
 
+    /**
+     * Scans the decoded history for all matches using the global thread
+     * pool, emitting searchResults() incrementally as the chunks complete.
+     * When the expression is a plain literal and the history keeps a
+     * trigram index, only candidate lines reported by the index are
+     * scanned instead.
+     */
+    void findAllMatches(const QString &string, const QList<int> &linePositions, const ScreenWindowPtr &window);
+
+    /**
+     * The candidate-restricted counterpart of findAllMatches(): decodes
+     * and scans only the runs of lines set with setCandidateLines().
+     */
+    void findMatchesInCandidates(const ScreenWindowPtr &window, Emulation *emulation);
+
     QMap<QPointer<Session>, ScreenWindowPtr> _windows;
     QRegularExpression _regExp;
     Enum::SearchDirection _direction;
     bool _noWrap;
     int _startLine;
+    QList<int> _candidateLines;
+    bool _hasCandidateLines = false;
 
 Q_SIGNALS:
     void searchResults(const QSet<int>&, int);
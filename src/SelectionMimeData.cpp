@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "SelectionMimeData.h"
+
+// Konsole
+#include "ScreenWindow.h"
+
+using namespace Konsole;
+
+SelectionMimeData::SelectionMimeData(ScreenWindow *window, int startIndex, int endIndex, Screen::DecodingOptions options, bool withHtml)
+    : _screen(window->screen())
+    , _startIndex(startIndex)
+    , _endIndex(endIndex)
+    , _options(options)
+    , _withHtml(withHtml)
+{
+    connect(window, &ScreenWindow::contentsAboutToChange, this, &SelectionMimeData::materialize);
+    // The windows of an emulation are deleted before its screens, so the
+    // screen can still be read here.
+    connect(window, &QObject::destroyed, this, &SelectionMimeData::materialize);
+}
+
+QStringList SelectionMimeData::formats() const
+{
+    if (!_materialized) {
+        QStringList formats{QStringLiteral("text/plain")};
+        if (_withHtml) {
+            formats.append(QStringLiteral("text/html"));
+        }
+        return formats;
+    }
+    return QMimeData::formats();
+}
+
+bool SelectionMimeData::hasFormat(const QString &mimeType) const
+{
+    if (!_materialized) {
+        return formats().contains(mimeType);
+    }
+    return QMimeData::hasFormat(mimeType);
+}
+
+QVariant SelectionMimeData::retrieveData(const QString &mimeType, QMetaType preferredType) const
+{
+    const_cast<SelectionMimeData *>(this)->materialize();
+    return QMimeData::retrieveData(mimeType, preferredType);
+}
+
+void SelectionMimeData::materialize()
+{
+    if (_materialized) {
+        return;
+    }
+    _materialized = true;
+
+    setText(_screen->text(_startIndex, _endIndex, _options));
+    if (_withHtml) {
+        setHtml(_screen->text(_startIndex, _endIndex, _options | Screen::ConvertToHtml));
+    }
+}
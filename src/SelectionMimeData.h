@@ -0,0 +1,83 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SELECTIONMIMEDATA_H
+#define SELECTIONMIMEDATA_H
+
+// Qt
+#include <QMimeData>
+
+// Konsole
+#include "Screen.h"
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+class ScreenWindow;
+
+/**
+ * Clipboard payload for a terminal selection which defers decoding the
+ * selected cells until a paste target actually requests the data.
+ *
+ * Screen::selectedText() builds the entire selection into one string, so
+ * copying most of a large scrollback allocates hundreds of megabytes and
+ * stalls the GUI even if the text is never pasted.  This class only
+ * captures the character range of the selection at copy time; the text is
+ * decoded on the first retrieveData() call.
+ *
+ * The captured indexes are only meaningful while the screen contents are
+ * unchanged, so the selection is also decoded - once - when the emulation
+ * is about to process new output (see Emulation::contentsAboutToChange())
+ * or when the screen window goes away.  In the common interactive case of
+ * selecting, then selecting something else or copying again, the data is
+ * simply discarded without ever having been decoded.
+ */
+class KONSOLEPRIVATE_EXPORT SelectionMimeData : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructs clipboard data for the range @p startIndex to @p endIndex
+     * (see Screen::selectedTextRange()) of the screen viewed by @p window.
+     *
+     * @param options The options passed to Screen::text() when the plain
+     * text rendering is requested.
+     * @param withHtml True if a text/html rendering (decoded with
+     * Screen::ConvertToHtml added to @p options) should be offered as well.
+     */
+    SelectionMimeData(ScreenWindow *window, int startIndex, int endIndex, Screen::DecodingOptions options, bool withHtml);
+
+    QStringList formats() const override;
+    bool hasFormat(const QString &mimeType) const override;
+
+protected:
+    QVariant retrieveData(const QString &mimeType, QMetaType preferredType) const override;
+
+private Q_SLOTS:
+    /**
+     * Decodes the captured range into the underlying QMimeData.  Called on
+     * the first paste request, and eagerly just before the screen contents
+     * change so that a later paste still sees the text as it was at copy
+     * time.
+     */
+    void materialize();
+
+private:
+    // Valid until the screen window is destroyed; the destroyed()
+    // connection made in the constructor decodes the text just in time,
+    // because Emulation deletes its windows before its screens.
+    const Screen *_screen;
+    int _startIndex;
+    int _endIndex;
+    Screen::DecodingOptions _options;
+    bool _withHtml;
+    bool _materialized = false;
+};
+
+}
+
+#endif // SELECTIONMIMEDATA_H
@@ -0,0 +1,49 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "StartupProfiler.h"
+
+// Qt
+#include <QElapsedTimer>
+#include <QSet>
+
+#include <cstdio>
+
+using namespace Konsole;
+
+static bool s_enabled = false;
+static QElapsedTimer s_clock;
+Q_GLOBAL_STATIC(QSet<QByteArray>, s_reportedPhases)
+
+void StartupProfiler::enable()
+{
+    s_enabled = true;
+    s_clock.start();
+}
+
+bool StartupProfiler::enabled()
+{
+    return s_enabled;
+}
+
+void StartupProfiler::mark(const char *phase)
+{
+    if (!s_enabled) {
+        return;
+    }
+
+    const QByteArray name(phase);
+    if (s_reportedPhases->contains(name)) {
+        return;
+    }
+    s_reportedPhases->insert(name);
+
+    // written to stderr directly rather than through a logging category, so
+    // the trace cannot be filtered away by logging rules while bisecting
+    fprintf(stderr, "konsole-startup: %s +%lld ms\n", phase, static_cast<long long>(s_clock.elapsed()));
+    fflush(stderr);
+}
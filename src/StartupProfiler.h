@@ -0,0 +1,41 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+/**
+ * Timestamped startup-phase instrumentation for bisecting cold-start
+ * regressions across builds.
+ *
+ * Enabled with the --profile-startup command line switch, or with
+ * KONSOLE_PROFILE_STARTUP=1 in the environment for launchers that do not
+ * control the command line. Each phase is reported on its first occurrence
+ * as "konsole-startup: <phase> +<ms>" on standard error; while disabled a
+ * mark() costs a single static bool check.
+ */
+namespace StartupProfiler
+{
+/** Starts the clock and turns reporting on; called once from main(). */
+KONSOLEPRIVATE_EXPORT void enable();
+
+/** Returns true when enable() has been called. */
+KONSOLEPRIVATE_EXPORT bool enabled();
+
+/**
+ * Reports @p phase with the elapsed time since enable(). Only the first
+ * occurrence of each phase is reported, so call sites in per-session or
+ * per-view code can mark "first ..." phases without any bookkeeping.
+ */
+KONSOLEPRIVATE_EXPORT void mark(const char *phase);
+}
+}
+
+#endif // STARTUPPROFILER_H
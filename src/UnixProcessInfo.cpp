@@ -31,7 +31,6 @@ using namespace Konsole;
 UnixProcessInfo::UnixProcessInfo(int pid)
     : ProcessInfo(pid)
 {
-    setUserNameRequired(true);
 }
 
 void UnixProcessInfo::readProcessInfo(int pid)
@@ -13,8 +13,10 @@
 // Qt
 #include <QFile>
 #include <QFileDialog>
+#include <QPointer>
 #include <QStringList>
 #include <QTabBar>
+#include <QTimer>
 
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -36,6 +38,7 @@
 #include <windowadaptor.h>
 #endif
 
+#include "StartupProfiler.h"
 #include "colorscheme/ColorScheme.h"
 #include "colorscheme/ColorSchemeManager.h"
 
@@ -96,6 +99,8 @@ ViewManager::ViewManager(QObject *parent, KActionCollection *collection)
     new WindowAdaptor(this);
     QDBusConnection::sessionBus().registerObject(QLatin1String("/Windows/") + QString::number(_managerId), this);
 #endif
+
+    StartupProfiler::mark("view-manager-created");
 }
 
 ViewManager::~ViewManager() = default;
@@ -654,7 +659,10 @@ Session *ViewManager::forgetTerminal(TerminalDisplay *terminal)
 {
     unregisterTerminal(terminal);
 
-    removeController(terminal->sessionController());
+    // the display is moving to another window; keep its controller alive
+    // so the destination can adopt it (see attachView()) instead of
+    // rebuilding the view plumbing for a session that is already wired up
+    releaseController(terminal->sessionController());
     auto session = _sessionMap.take(terminal);
     if (session != nullptr) {
         disconnect(session, &Konsole::Session::finished, this, &Konsole::ViewManager::sessionFinished);
@@ -981,6 +989,44 @@ void ViewManager::removeController(SessionController *controller)
     controller->deleteLater();
 }
 
+void ViewManager::releaseController(SessionController *controller)
+{
+    // unplug from this window (the MainWindow removes the XMLGUI client)
+    // without deleting anything; should the controller never be adopted,
+    // the view-destroyed connection made in createController() still
+    // deletes it eventually
+    Q_EMIT unplugController(controller);
+
+    if (_pluggedController == controller) {
+        _pluggedController.clear();
+    }
+    disconnect(controller, &Konsole::SessionController::viewFocused, this, &Konsole::ViewManager::controllerChanged);
+    disconnect(controller, &Konsole::SessionController::viewDragAndDropped, this, &Konsole::ViewManager::forgetController);
+    disconnect(controller, &Konsole::SessionController::requestSplitViewLeftRight, this, &Konsole::ViewManager::splitLeftRight);
+    disconnect(controller, &Konsole::SessionController::requestSplitViewTopBottom, this, &Konsole::ViewManager::splitTopBottom);
+    disconnect(this, &Konsole::ViewManager::contextMenuAdditionalActionsChanged, controller, &Konsole::SessionController::setContextMenuAdditionalActions);
+    // detach from this manager's lifetime; adoptController() reparents
+    controller->setParent(nullptr);
+}
+
+void ViewManager::adoptController(SessionController *controller)
+{
+    controller->setParent(this);
+    connect(controller, &Konsole::SessionController::viewFocused, this, &Konsole::ViewManager::controllerChanged);
+    connect(controller, &Konsole::SessionController::viewDragAndDropped, this, &Konsole::ViewManager::forgetController);
+    connect(controller, &Konsole::SessionController::requestSplitViewLeftRight, this, &Konsole::ViewManager::splitLeftRight);
+    connect(controller, &Konsole::SessionController::requestSplitViewTopBottom, this, &Konsole::ViewManager::splitTopBottom);
+    connect(this, &Konsole::ViewManager::contextMenuAdditionalActionsChanged, controller, &Konsole::SessionController::setContextMenuAdditionalActions);
+
+    if (_pluggedController.isNull()) {
+        controllerChanged(controller);
+    }
+
+    if (!contextMenuAdditionalActions.isEmpty()) {
+        controller->setContextMenuAdditionalActions(contextMenuAdditionalActions);
+    }
+}
+
 void ViewManager::controllerChanged(SessionController *controller)
 {
     if (controller == _pluggedController) {
@@ -1010,11 +1056,64 @@ void ViewManager::attachView(TerminalDisplay *terminal, Session *session)
     registerTerminal(terminal);
 
     _sessionMap[terminal] = session;
-    createController(session, terminal);
+
+    // a display arriving from another window still carries the controller
+    // released by forgetTerminal(); adopting it turns a detach into a
+    // plain reparent of the live view — no profile re-application, no
+    // filter re-scan, no new session/display wiring
+    SessionController *controller = terminal->sessionController();
+    if (controller != nullptr && controller->session() == session) {
+        adoptController(controller);
+    } else {
+        createController(session, terminal);
+    }
     toggleActionsBasedOnState();
     _terminalDisplayHistory.append(terminal);
 }
 
+void ViewManager::beginBulkViewCreation()
+{
+    if (_bulkViewCreationDepth++ == 0 && !_viewContainer.isNull()) {
+        // one relayout and repaint when the transaction ends instead of
+        // one per constructed view
+        _viewContainer->setUpdatesEnabled(false);
+    }
+}
+
+void ViewManager::endBulkViewCreation()
+{
+    Q_ASSERT(_bulkViewCreationDepth > 0);
+    if (--_bulkViewCreationDepth > 0) {
+        return;
+    }
+
+    if (!_viewContainer.isNull()) {
+        _viewContainer->setUpdatesEnabled(true);
+    }
+
+    if (_bulkProfileNotificationPending) {
+        _bulkProfileNotificationPending = false;
+        // the per-view emissions skipped by applyProfileToView() collapse
+        // into one window-level notification
+        Q_EMIT updateWindowIcon();
+        if (_bulkLastProfile) {
+            Q_EMIT blurSettingChanged(profileHasBlurEnabled(_bulkLastProfile));
+        }
+        _bulkLastProfile = Profile::Ptr();
+    }
+
+    // perform the focus grab skipped by createView()
+    if (!_viewContainer.isNull()) {
+        auto *splitter = _viewContainer->activeViewSplitter();
+        if (splitter != nullptr) {
+            auto *display = splitter->activeTerminalDisplay();
+            if (display != nullptr) {
+                display->setFocus(Qt::OtherFocusReason);
+            }
+        }
+    }
+}
+
 TerminalDisplay *ViewManager::findTerminalDisplay(int viewId)
 {
     for (auto i = _sessionMap.keyBegin(); i != _sessionMap.keyEnd(); ++i) {
@@ -1059,7 +1158,11 @@ TerminalDisplay *ViewManager::createView(Session *session)
 
     // tell the session whether it has a light or dark background
     session->setDarkBackground(colorSchemeForProfile(profile)->hasDarkBackground());
-    display->setFocus(Qt::OtherFocusReason);
+    if (_bulkViewCreationDepth == 0) {
+        // during a bulk transaction the focus moves once, at the end,
+        // instead of hopping through every view as it is constructed
+        display->setFocus(Qt::OtherFocusReason);
+    }
     //     updateDetachViewState();
     connect(display, &TerminalDisplay::activationRequest, this, &Konsole::ViewManager::activationRequest);
 
@@ -1193,7 +1296,18 @@ bool ViewManager::profileHasBlurEnabled(const Profile::Ptr &profile)
 void ViewManager::applyProfileToView(TerminalDisplay *view, const Profile::Ptr &profile)
 {
     Q_ASSERT(profile);
+    // applyProfile() runs through the font, color scheme and margin
+    // setters, each of which schedules its own repaint; suppress them so
+    // re-enabling updates invalidates the view once with all changes in
+    view->setUpdatesEnabled(false);
     view->applyProfile(profile);
+    view->setUpdatesEnabled(true);
+    if (_bulkViewCreationDepth > 0) {
+        // emitted once for the whole batch from endBulkViewCreation()
+        _bulkProfileNotificationPending = true;
+        _bulkLastProfile = profile;
+        return;
+    }
     Q_EMIT updateWindowIcon();
     Q_EMIT blurSettingChanged(view->colorScheme()->blur());
 }
@@ -1211,15 +1325,27 @@ void ViewManager::updateViewsForSession(Session *session)
 void ViewManager::profileChanged(const Profile::Ptr &profile)
 {
     // update all views associated with this profile
+    bool anyViewChanged = false;
     QHashIterator<TerminalDisplay *, Session *> iter(_sessionMap);
     while (iter.hasNext()) {
         iter.next();
 
-        // if session uses this profile, update the display
+        // if session uses this profile, update the display; repaints are
+        // suppressed per view so each one re-renders exactly once
         if (iter.key() != nullptr && iter.value() != nullptr && SessionManager::instance()->sessionProfile(iter.value()) == profile) {
-            applyProfileToView(iter.key(), profile);
+            iter.key()->setUpdatesEnabled(false);
+            iter.key()->applyProfile(profile);
+            iter.key()->setUpdatesEnabled(true);
+            anyViewChanged = true;
         }
     }
+
+    // the window-level notifications carry no per-view state, so one
+    // emission covers the whole batch of updated views
+    if (anyViewChanged) {
+        Q_EMIT updateWindowIcon();
+        Q_EMIT blurSettingChanged(profileHasBlurEnabled(profile));
+    }
 }
 
 QList<ViewProperties *> ViewManager::viewProperties() const
@@ -1381,6 +1507,40 @@ ViewSplitter *restoreSessionsSplitterRecurse(const QJsonObject &jsonSplitter, Vi
     return currentSplitter;
 }
 
+// Rebuilds one saved tab per event loop iteration. The previously active
+// tab has already been restored by restoreSessions(), so the window is
+// usable while the rest of a large layout trickles in; each tab's shell is
+// forked only once its view exists (see the imageSizeInitialized connection
+// in Session).
+void restoreRemainingTabs(const QPointer<ViewManager> &manager, const QJsonArray &jsonTabs, int baseIndex, int index, int activeTab, const QPointer<QWidget> &activePage)
+{
+    if (manager.isNull()) {
+        return;
+    }
+
+    if (index == activeTab) {
+        ++index;
+    }
+    if (index >= jsonTabs.count()) {
+        return;
+    }
+
+    manager->beginBulkViewCreation();
+    auto *splitter = restoreSessionsSplitterRecurse(jsonTabs.at(index).toObject(), manager.data(), true);
+    manager->activeContainer()->addSplitter(splitter, baseIndex + index);
+
+    // addSplitter() makes the new tab current; keep the restored active tab
+    // in front
+    if (!activePage.isNull()) {
+        manager->activeContainer()->setCurrentWidget(activePage.data());
+    }
+    manager->endBulkViewCreation();
+
+    QTimer::singleShot(0, manager.data(), [manager, jsonTabs, baseIndex, index, activeTab, activePage]() {
+        restoreRemainingTabs(manager, jsonTabs, baseIndex, index + 1, activeTab, activePage);
+    });
+}
+
 } // namespace
 void ViewManager::loadLayout(QString file)
 {
@@ -1396,8 +1556,10 @@ void ViewManager::loadLayout(QString file)
     }
     auto json = QJsonDocument::fromJson(jsonFile.readAll());
     if (!json.isEmpty()) {
+        beginBulkViewCreation();
         auto splitter = restoreSessionsSplitterRecurse(json.object(), this, false);
         _viewContainer->addSplitter(splitter, _viewContainer->count());
+        endBulkViewCreation();
     }
 }
 void ViewManager::loadLayoutFile()
@@ -1412,13 +1574,26 @@ void ViewManager::restoreSessions(const KConfigGroup &group)
 {
     const auto tabList = group.readEntry("Tabs", QByteArray("[]"));
     const auto jsonTabs = QJsonDocument::fromJson(tabList).array();
-    for (const auto &jsonSplitter : jsonTabs) {
-        auto topLevelSplitter = restoreSessionsSplitterRecurse(jsonSplitter.toObject(), this, true);
-        _viewContainer->addSplitter(topLevelSplitter, _viewContainer->count());
-    }
-
-    if (!jsonTabs.isEmpty())
+    if (!jsonTabs.isEmpty()) {
+        // Restore the previously active tab synchronously so its shell is
+        // the first one forked and the window is immediately usable; the
+        // remaining tabs are rebuilt one per event loop iteration instead
+        // of blocking the first paint on the whole layout
+        const int baseIndex = _viewContainer->count();
+        const int activeTab = qBound(0, group.readEntry("Active", 0), int(jsonTabs.count()) - 1);
+
+        beginBulkViewCreation();
+        auto topLevelSplitter = restoreSessionsSplitterRecurse(jsonTabs.at(activeTab).toObject(), this, true);
+        _viewContainer->addSplitter(topLevelSplitter, baseIndex);
+        endBulkViewCreation();
+
+        const QPointer<QWidget> activePage = _viewContainer->currentWidget();
+        const QPointer<ViewManager> manager(this);
+        QTimer::singleShot(0, this, [manager, jsonTabs, baseIndex, activeTab, activePage]() {
+            restoreRemainingTabs(manager, jsonTabs, baseIndex, 0, activeTab, activePage);
+        });
         return;
+    }
 
     // Session file is unusable, try older format
     QList<int> ids = group.readEntry("Sessions", QList<int>());
@@ -1426,6 +1601,7 @@ void ViewManager::restoreSessions(const KConfigGroup &group)
     TerminalDisplay *display = nullptr;
 
     int tab = 1;
+    beginBulkViewCreation();
     for (auto it = ids.cbegin(); it != ids.cend(); ++it) {
         const int &id = *it;
         Session *session = SessionManager::instance()->idToSession(id);
@@ -1445,6 +1621,7 @@ void ViewManager::restoreSessions(const KConfigGroup &group)
             display = qobject_cast<TerminalDisplay *>(activeView());
         }
     }
+    endBulkViewCreation();
 
     if (display != nullptr) {
         activeContainer()->setCurrentWidget(display);
@@ -1485,6 +1662,58 @@ QStringList ViewManager::sessionList()
     return ids;
 }
 
+int ViewManager::sendBatch(const QStringList &sessionIds, const QStringList &texts, bool asCommands)
+{
+    if (sessionIds.size() != texts.size()) {
+        return 0;
+    }
+
+    int delivered = 0;
+    for (int i = 0; i < sessionIds.size(); i++) {
+        Session *session = SessionManager::instance()->idToSession(sessionIds.at(i).toInt());
+        if (session == nullptr) {
+            continue;
+        }
+        if (asCommands) {
+            session->runCommand(texts.at(i));
+        } else {
+            session->sendText(texts.at(i));
+        }
+        delivered++;
+    }
+
+    return delivered;
+}
+
+int ViewManager::sendTextBatch(const QStringList &sessionIds, const QStringList &texts)
+{
+    return sendBatch(sessionIds, texts, false);
+}
+
+int ViewManager::runCommandBatch(const QStringList &sessionIds, const QStringList &commands)
+{
+    return sendBatch(sessionIds, commands, true);
+}
+
+QStringList ViewManager::sessionAttributes()
+{
+    QStringList attributes;
+    const QStringList ids = sessionList();
+    attributes.reserve(ids.size());
+
+    for (const QString &id : ids) {
+        Session *session = SessionManager::instance()->idToSession(id.toInt());
+        if (session == nullptr) {
+            continue;
+        }
+        attributes.append(id + QLatin1Char('\t') + QString::number(session->processId()) + QLatin1Char('\t')
+                          + QString::number(session->foregroundProcessId()) + QLatin1Char('\t') + session->currentWorkingDirectory() + QLatin1Char('\t')
+                          + session->title(Session::DisplayedTitleRole));
+    }
+
+    return attributes;
+}
+
 int ViewManager::currentSession()
 {
     if (_pluggedController != nullptr) {
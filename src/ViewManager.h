@@ -180,6 +180,20 @@ public:
     TerminalDisplay *createView(Session *session);
     void attachView(TerminalDisplay *terminal, Session *session);
 
+    /**
+     * Marks the start of a bulk view construction transaction, used when
+     * several views are built in one go (session restore, layout load,
+     * tmux layout rebuild).  While a transaction is active createView()
+     * skips the per-view focus grab and applyProfileToView() defers the
+     * window-level notifications, and repaints of the view container are
+     * suspended; endBulkViewCreation() then performs the deferred
+     * notifications, focuses the active view and triggers a single
+     * relayout and show.  Transactions may nest; the deferred work runs
+     * when the outermost one ends.
+     */
+    void beginBulkViewCreation();
+    void endBulkViewCreation();
+
     static std::shared_ptr<const ColorScheme> colorSchemeForProfile(const QExplicitlySharedDataPointer<Profile> &profile);
     /** Reorder the terminal display history list */
     void updateTerminalDisplayHistory(TerminalDisplay *terminalDisplay = nullptr, bool remove = false);
@@ -260,6 +274,34 @@ public Q_SLOTS:
      */
     Q_SCRIPTABLE QStringList sessionList();
 
+    /**
+     * DBus slot that sends text to several sessions in one call.
+     * @param sessionIds unique ids of the target sessions, as returned by
+     * sessionList()
+     * @param texts the text to send to the session at the same index in
+     * @p sessionIds
+     * Returns the number of sessions the text was delivered to; unknown
+     * ids and a size mismatch between the lists deliver nothing.  One
+     * call replaces a D-Bus round trip and event-loop wakeup per
+     * session; each text still goes out through its pty's coalescing
+     * send queue.
+     */
+    Q_SCRIPTABLE int sendTextBatch(const QStringList &sessionIds, const QStringList &texts);
+
+    /**
+     * DBus slot that runs a command in several sessions in one call.
+     * Same contract as sendTextBatch(), but each entry is terminated
+     * like Session::runCommand().
+     */
+    Q_SCRIPTABLE int runCommandBatch(const QStringList &sessionIds, const QStringList &commands);
+
+    /**
+     * DBus slot that returns the attributes of every session in this
+     * window in one message, one entry per session in sessionList()
+     * order, formatted as "id\tpid\tforegroundPid\tcwd\ttitle".
+     */
+    Q_SCRIPTABLE QStringList sessionAttributes();
+
     /** DBus slot that returns the current (active) session window */
     Q_SCRIPTABLE int currentSession();
 
@@ -510,6 +552,15 @@ private:
     SessionController *createController(Session *session, TerminalDisplay *view);
     void removeController(SessionController *controller);
 
+    // unplugs a controller from this window without deleting it, so a
+    // display moving to another window keeps its controller (and with it
+    // the filters, caches and profile state already applied to the view)
+    void releaseController(SessionController *controller);
+    // counterpart of releaseController(): wires a controller released by
+    // another window's ViewManager to this one, mirroring the
+    // connections made in createController()
+    void adoptController(SessionController *controller);
+
     // Activates a different terminal when the TerminalDisplay
     // closes or is detached and another one should be focused.
     // It will activate the last used terminal within the same splitView
@@ -521,6 +572,9 @@ private:
     void registerTerminal(TerminalDisplay *terminal);
     void unregisterTerminal(TerminalDisplay *terminal);
 
+    // shared implementation of sendTextBatch()/runCommandBatch()
+    int sendBatch(const QStringList &sessionIds, const QStringList &texts, bool asCommands);
+
 private:
     QPointer<TabbedViewContainer> _viewContainer;
     QPointer<SessionController> _pluggedController;
@@ -536,6 +590,13 @@ private:
     QList<QPointer<TerminalDisplay>> _terminalDisplayHistory;
     int _terminalDisplayHistoryIndex;
 
+    // depth of nested bulk view construction transactions; while > 0,
+    // createView() and applyProfileToView() defer their per-view focus
+    // and notification work to endBulkViewCreation()
+    int _bulkViewCreationDepth = 0;
+    bool _bulkProfileNotificationPending = false;
+    QExplicitlySharedDataPointer<Profile> _bulkLastProfile;
+
     // List of actions that should only be enabled when there are multiple view
     // containers open
     QList<QAction *> _multiTabOnlyActions;
@@ -11,6 +11,12 @@
 // Standard
 #include <cstdio>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 // Qt
 #include <QApplication>
 #include <QAudioOutput>
@@ -134,6 +140,8 @@ Vt102Emulation::~Vt102Emulation()
 
 void Vt102Emulation::clearEntireScreen()
 {
+    Q_EMIT contentsAboutToChange();
+
     _currentScreen->clearEntireScreen();
     bufferedUpdate();
 }
@@ -147,6 +155,7 @@ void Vt102Emulation::clearHistory()
 
 void Vt102Emulation::reset(bool softReset, bool preservePrompt)
 {
+    Q_EMIT contentsAboutToChange();
     Q_EMIT updateDroppedLines(_currentScreen->getLines());
 
     // Save the current codec so we can set it later.
@@ -367,10 +376,26 @@ void Vt102Emulation::addSub()
     params.hasSubParams = true;
 }
 
+// Upper bound on the size of a single OSC/DCS/APC sequence. Sequences with
+// legitimately large payloads (OSC 1337 / OSC 52 / kitty graphics) decode their
+// base64 content incrementally into tokenData and rewind the buffer, so
+// anything hitting this limit is pathological; the excess is dropped.
+const int MAX_TOKEN_LENGTH = 512 * 1024;
+
+// Upper bound on the decoded size of an OSC 52 clipboard write. Remote
+// clipboard syncs are routinely megabytes, so this is generous; a payload
+// beyond it is dropped wholesale rather than applied truncated.
+const int MAX_CLIPBOARD_LENGTH = 8 * 1024 * 1024;
+
 void Vt102Emulation::addToCurrentToken(uint cc)
 {
     if (tokenBuffer.size() <= tokenBufferPos) {
-        tokenBuffer.resize(tokenBufferPos + 1);
+        if (tokenBufferPos >= MAX_TOKEN_LENGTH) {
+            return;
+        }
+        // Double the buffer instead of growing per character; it is never
+        // shrunk, so after warm-up the parse loop does not allocate at all
+        tokenBuffer.resize(qMin(tokenBuffer.size() * 2, qsizetype(MAX_TOKEN_LENGTH)));
     }
     tokenBuffer[tokenBufferPos] = cc;
     tokenBufferPos++;
@@ -621,24 +646,50 @@ void Vt102Emulation::osc_put(const uint cc)
 {
     addToCurrentToken(cc);
 
-    // Special case: iterm file protocol is a long escape sequence
+    // Special cases: the iterm file protocol and OSC 52 clipboard writes
+    // carry base64 payloads of arbitrary length. Both decode incrementally
+    // into tokenData and rewind the buffer (tokenState == -2 below), so the
+    // sequence is never held in full.
     if (tokenState == -1) {
-        tokenStateChange = "1337;File=:";
+        tokenStateChange = tokenBuffer[0] == (uint)'5' ? "52;" : "1337;File=:";
         tokenState = 0;
     }
     if (tokenState >= 0) {
-        if ((uint)tokenStateChange[tokenState] == tokenBuffer[tokenBufferPos - 1]) {
+        // the prefix match is anchored so that a stray occurrence of the
+        // prefix characters inside some other sequence cannot trigger it
+        if (tokenState == tokenBufferPos - 1 && (uint)tokenStateChange[tokenState] == tokenBuffer[tokenBufferPos - 1]) {
             tokenState++;
             tokenPos = tokenBufferPos;
             if ((uint)tokenState == strlen(tokenStateChange)) {
-                tokenState = -2;
+                // the iterm prefix is followed directly by the payload;
+                // OSC 52 still has a selection parameter to skip
+                tokenState = tokenStateChange[0] == '5' ? -3 : -2;
                 tokenData.clear();
             }
             return;
         }
+    } else if (tokenState == -3) {
+        // skip OSC 52's selection parameter ("c", "p", ...); the payload
+        // begins after the ';' terminating it
+        if (tokenBuffer[tokenBufferPos - 1] == (uint)';') {
+            tokenState = -2;
+        }
+        tokenPos = tokenBufferPos;
+        return;
     } else if (tokenState == -2) {
         if (tokenBufferPos - tokenPos == 4) {
             tokenData.append(QByteArray::fromBase64(QString::fromUcs4(&tokenBuffer[tokenPos], 4).toLocal8Bit()));
+            tokenBufferPos -= 4;
+            if (tokenStateChange[0] == '5' && tokenData.size() > MAX_CLIPBOARD_LENGTH) {
+                // oversized clipboard write: drop the data but keep
+                // consuming the payload so the tokenizer stays in sync
+                tokenData.clear();
+                tokenState = -4;
+            }
+            return;
+        }
+    } else if (tokenState == -4) {
+        if (tokenBufferPos - tokenPos == 4) {
             tokenBufferPos -= 4;
             return;
         }
@@ -778,20 +829,20 @@ bool Vt102Emulation::receiveRawData(const char *text, int length)
     // This avoids the lossy UTF-8 → Unicode → UTF-8 round-trip through
     // QStringDecoder, which produces U+FFFD at chunk boundaries when a
     // multi-byte UTF-8 sequence is split across PTY reads.
-    for (int i = 0; i < length; ++i) {
-        unsigned char c = static_cast<unsigned char>(text[i]);
-
-        if (c == 0x1B && m_tmuxRawEscSeen) {
-            // Two ESCs in a row: first was data, buffer it
-            m_tmuxLineBuffer.append('\x1B');
-            // Keep m_tmuxRawEscSeen true for this new ESC
-            continue;
-        }
-
+    //
+    // Only ESC, CR and LF need byte-at-a-time handling; everything in
+    // between is copied as one span. When a whole line (terminated by
+    // LF or CRLF) sits inside this chunk and nothing is buffered from a
+    // previous read, the line is handed out as a zero-copy view of the
+    // read buffer instead — valid only for the duration of the emit,
+    // which is fine since processLine() does not retain it.
+    int i = 0;
+    while (i < length) {
         if (m_tmuxRawEscSeen) {
-            m_tmuxRawEscSeen = false;
+            const unsigned char c = static_cast<unsigned char>(text[i]);
             if (c == 0x5C) {
                 // ESC \ = ST — exit tmux control mode
+                m_tmuxRawEscSeen = false;
                 unhook();
                 _state = Ground;
                 // Process remaining bytes normally (they're post-tmux)
@@ -800,34 +851,163 @@ bool Vt102Emulation::receiveRawData(const char *text, int length)
                 }
                 return true;
             }
-            // ESC followed by something else — both are data
+            // ESC followed by another ESC: the first was data; buffer it
+            // and stay in the escape state for the new one. Anything
+            // else: both bytes are data.
             m_tmuxLineBuffer.append('\x1B');
-            m_tmuxLineBuffer.append(static_cast<char>(c));
+            if (c != 0x1B) {
+                m_tmuxRawEscSeen = false;
+                m_tmuxLineBuffer.append(static_cast<char>(c));
+            }
+            ++i;
             continue;
         }
 
-        if (c == 0x1B) {
-            m_tmuxRawEscSeen = true;
-            continue;
+        int runEnd = i;
+        while (runEnd < length) {
+            const unsigned char c = static_cast<unsigned char>(text[runEnd]);
+            if (c == 0x1B || c == '\n' || c == '\r') {
+                break;
+            }
+            ++runEnd;
         }
 
+        if (runEnd == length) {
+            // Chunk ends mid-line; keep the partial line for the next read
+            m_tmuxLineBuffer.append(text + i, length - i);
+            break;
+        }
+
+        const unsigned char c = static_cast<unsigned char>(text[runEnd]);
         if (c == '\n') {
-            Q_EMIT tmuxControlModeLineReceived(m_tmuxLineBuffer);
-            m_tmuxLineBuffer.clear();
-        } else if (c != '\r') {
-            m_tmuxLineBuffer.append(static_cast<char>(c));
+            if (m_tmuxLineBuffer.isEmpty()) {
+                Q_EMIT tmuxControlModeLineReceived(QByteArray::fromRawData(text + i, runEnd - i));
+            } else {
+                m_tmuxLineBuffer.append(text + i, runEnd - i);
+                Q_EMIT tmuxControlModeLineReceived(m_tmuxLineBuffer);
+                m_tmuxLineBuffer.clear();
+            }
+            i = runEnd + 1;
+        } else if (c == '\r') {
+            if (runEnd + 1 < length && text[runEnd + 1] == '\n' && m_tmuxLineBuffer.isEmpty()) {
+                // Complete CRLF-terminated line inside the chunk
+                Q_EMIT tmuxControlModeLineReceived(QByteArray::fromRawData(text + i, runEnd - i));
+                i = runEnd + 2;
+            } else {
+                // Lone CR (or CR at a chunk boundary): drop it, as before
+                m_tmuxLineBuffer.append(text + i, runEnd - i);
+                i = runEnd + 1;
+            }
+        } else {
+            // ESC
+            m_tmuxLineBuffer.append(text + i, runEnd - i);
+            m_tmuxRawEscSeen = true;
+            i = runEnd + 1;
         }
     }
 
     return true;
 }
 
+// A character that the Ground state passes straight to the screen: anything
+// that is neither a C0/C1 control nor DEL. These make up virtually the whole
+// stream when displaying bulk output, so scanning for the longest such run
+// in one pass keeps the tokenizer state machine off the hot path.
+static inline bool isPlainDisplayable(uint cc)
+{
+    return (cc >= 0x20 && cc <= 0x7E) || cc >= 0xA0;
+}
+
+// Returns the length of the leading run of plain displayable codepoints in
+// buf[0..count). buf[0] is assumed to already satisfy isPlainDisplayable().
+static int scanDisplayableRun(const uint *buf, int count)
+{
+    int i = 1;
+#if defined(__SSE2__)
+    // SSE2 has only signed 32-bit compares; bias by 0x80000000 to get
+    // unsigned semantics. Displayable <=> (0x20 <= cc <= 0x7E) || cc >= 0xA0.
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i below0x20 = _mm_set1_epi32(static_cast<int>(0x20u ^ 0x80000000u));
+    const __m128i above0x7E = _mm_set1_epi32(static_cast<int>(0x7Eu ^ 0x80000000u));
+    const __m128i above0x9F = _mm_set1_epi32(static_cast<int>(0x9Fu ^ 0x80000000u));
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + i)), bias);
+        const __m128i outsideAscii = _mm_or_si128(_mm_cmplt_epi32(v, below0x20), _mm_cmpgt_epi32(v, above0x7E));
+        const __m128i nonPrintable = _mm_andnot_si128(_mm_cmpgt_epi32(v, above0x9F), outsideAscii);
+        const int mask = _mm_movemask_ps(_mm_castsi128_ps(nonPrintable));
+        if (mask != 0) {
+            return i + qCountTrailingZeroBits(static_cast<quint32>(mask));
+        }
+    }
+#elif defined(__aarch64__)
+    // vminvq_u32 (horizontal minimum) is only available on AArch64.
+    const uint32x4_t min0x20 = vdupq_n_u32(0x20);
+    const uint32x4_t max0x7E = vdupq_n_u32(0x7E);
+    const uint32x4_t min0xA0 = vdupq_n_u32(0xA0);
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4_t v = vld1q_u32(buf + i);
+        const uint32x4_t ascii = vandq_u32(vcgeq_u32(v, min0x20), vcleq_u32(v, max0x7E));
+        const uint32x4_t printable = vorrq_u32(ascii, vcgeq_u32(v, min0xA0));
+        if (vminvq_u32(printable) == 0) {
+            break;
+        }
+    }
+#endif
+    while (i < count && isPlainDisplayable(buf[i])) {
+        ++i;
+    }
+    return i;
+}
+
+// A sixel picture data character ('?'..'~'); each encodes one six-pixel
+// column of the current band.
+static inline bool isSixelData(uint cc)
+{
+    return cc >= '?' && cc <= '~';
+}
+
+// Returns the length of the leading run of sixel data characters in
+// buf[0..count). buf[0] is assumed to already satisfy isSixelData().
+static int scanSixelDataRun(const uint *buf, int count)
+{
+    int i = 1;
+    while (i < count && isSixelData(buf[i])) {
+        ++i;
+    }
+    return i;
+}
+
 void Vt102Emulation::receiveChars(const QVector<uint> &chars)
 {
-    for (uint cc : chars) {
-        // early out for displayable characters
-        if (_state == Ground && ((cc >= 0x20 && cc <= 0x7E) || cc >= 0xA0)) {
-            _currentScreen->displayCharacter(applyCharset(cc));
+    const uint *const data = chars.constData();
+    const int length = chars.size();
+    for (int n = 0; n < length; ++n) {
+        uint cc = data[n];
+
+        // early out for displayable characters: scan the whole run at once
+        // and feed it to the screen without re-entering the state machine
+        if (_state == Ground && isPlainDisplayable(cc)) {
+            const int run = scanDisplayableRun(data + n, length - n);
+            const CharCodes &charset = _charset[_currentScreen == _screen[1]];
+            if (!charset.graphic && !charset.pound) {
+                // applyCharset() is the identity here, hand over the whole run
+                _currentScreen->displayCharacters(data + n, run);
+            } else {
+                for (int j = 0; j < run; ++j) {
+                    _currentScreen->displayCharacter(applyCharset(data[n + j]));
+                }
+            }
+            n += run - 1;
+            continue;
+        }
+
+        // Same idea for sixel picture data: bands are long runs of data
+        // characters, so decode them in one batch instead of routing every
+        // byte through put() and the sixel tokenizer
+        if (_state == DcsPassthrough && m_SixelStarted && tokenBufferPos == 0 && isSixelData(cc)) {
+            const int run = scanSixelDataRun(data + n, length - n);
+            SixelCharacterRunAdd(data + n, run);
+            n += run - 1;
             continue;
         }
 
@@ -1309,11 +1489,13 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
         }
         if (value[0] == QLatin1Char('C')) {
             _currentScreen->setReplMode(REPL_OUTPUT);
+            Q_EMIT commandExecutionStarted();
         }
         if (value[0] == QLatin1Char('D')) {
             _currentScreen->setReplMode(REPL_None);
         }
         QMap<QString, QString> params;
+        int reportedExitCode = 0;
         auto list = value.split(QLatin1Char(';'));
         for (int i = 1; i < list.size(); i++) {
             int eq = list.at(i).indexOf(QLatin1Char('='));
@@ -1324,10 +1506,14 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
                 if (exitCode) {
                     _currentScreen->setExitCode(exitCode);
                 }
+                reportedExitCode = exitCode;
             } else if (eq > 0) {
                 params[list.at(i).mid(0, eq)] = list.at(i).mid(eq + 1);
             }
         }
+        if (value[0] == QLatin1Char('D')) {
+            Q_EMIT commandExecutionFinished(reportedExitCode);
+        }
     }
     if (attribute == ReportColors) {
         // RGB colors
@@ -1406,13 +1592,27 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
         }
 
         if (params.length() == 2) {
-            // Copy to clipboard
-            if (clipboard) {
-                QApplication::clipboard()->setText(QString::fromUtf8(QByteArray::fromBase64(params[1].toUtf8())), QClipboard::Clipboard);
-            }
-            if (selection) {
-                QApplication::clipboard()->setText(QString::fromUtf8(QByteArray::fromBase64(params[1].toUtf8())), QClipboard::Selection);
+            if (tokenState == -4) {
+                // the payload exceeded MAX_CLIPBOARD_LENGTH and was dropped
+                return;
             }
+            // Copy to clipboard. The payload was decoded incrementally into
+            // tokenData by osc_put(); params[1] only holds an unpadded tail.
+            tokenData.append(QByteArray::fromBase64(params[1].toUtf8()));
+            // Converting a multi-megabyte payload to UTF-16 and handing it
+            // to the clipboard manager is too expensive for the middle of a
+            // PTY batch; apply it from the event loop instead. Capturing the
+            // byte array only bumps a reference count.
+            QTimer::singleShot(0, this, [data = tokenData, clipboard, selection]() {
+                const QString text = QString::fromUtf8(data);
+                if (clipboard) {
+                    QApplication::clipboard()->setText(text, QClipboard::Clipboard);
+                }
+                if (selection) {
+                    QApplication::clipboard()->setText(text, QClipboard::Selection);
+                }
+            });
+            tokenData.clear();
         } else {
             // Clear clipboard
             if (clipboard) {
@@ -1987,7 +2187,14 @@ void Vt102Emulation::processSessionAttributeRequest(const int tokenSize, const u
     }
 
     _pendingSessionAttributesUpdates[attribute] = value;
-    _sessionAttributesUpdateTimer->start(20);
+    // Do not restart a running timer: a stream of per-line title changes
+    // would keep pushing the timeout ahead and starve the UI update until
+    // the output pauses. Letting the pending shot fire caps the cost of a
+    // flood of attribute changes at one emission per interval,
+    // last-writer-wins.
+    if (!_sessionAttributesUpdateTimer->isActive()) {
+        _sessionAttributesUpdateTimer->start(20);
+    }
 }
 
 void Vt102Emulation::deletePlayer(QMediaPlayer::MediaStatus mediaStatus)
@@ -2028,8 +2235,53 @@ void Vt102Emulation::updateSessionAttributes()
    about this mapping.
 */
 
+/* clang-format off */
+// The C0 controls are by far the most frequent tokens: every NL/CR/TAB of
+// bulk output takes this path, one byte at a time, between printable runs.
+// Give them a dense precomputed action table (indexed load + small jump
+// table) instead of a walk through the sparse composite-token switch below,
+// which also keeps its rarely-used branches out of the hot I-cache.
+enum class CtlAction : quint8 {
+    Ignore, AnswerBack, Bell, Backspace, Tab, NewLine, ToStartOfLine, ShiftOut, ShiftIn, ShowGlitch,
+};
+static constexpr CtlAction ctlAction[32] = {
+    /* NUL */ CtlAction::Ignore,        /* SOH */ CtlAction::Ignore,
+    /* STX */ CtlAction::Ignore,        /* ETX */ CtlAction::Ignore,
+    /* EOT */ CtlAction::Ignore,        /* ENQ */ CtlAction::AnswerBack,    //VT100
+    /* ACK */ CtlAction::Ignore,        /* BEL */ CtlAction::Bell,          //VT100
+    /* BS  */ CtlAction::Backspace,     /* HT  */ CtlAction::Tab,           //VT100
+    /* LF  */ CtlAction::NewLine,       /* VT  */ CtlAction::NewLine,       //VT100
+    /* FF  */ CtlAction::NewLine,       /* CR  */ CtlAction::ToStartOfLine, //VT100
+    /* SO  */ CtlAction::ShiftOut,      /* SI  */ CtlAction::ShiftIn,       //VT100
+    /* DLE */ CtlAction::Ignore,        /* DC1 */ CtlAction::Ignore,        // DC1: XON continue
+    /* DC2 */ CtlAction::Ignore,        /* DC3 */ CtlAction::Ignore,        // DC3: XOFF halt
+    /* DC4 */ CtlAction::Ignore,        /* NAK */ CtlAction::Ignore,
+    /* SYN */ CtlAction::Ignore,        /* ETB */ CtlAction::Ignore,
+    /* CAN */ CtlAction::ShowGlitch,    /* EM  */ CtlAction::Ignore,        //VT100
+    /* SUB */ CtlAction::ShowGlitch,    /* ESC */ CtlAction::Ignore,        // ESC: cannot be seen here.
+    /* FS  */ CtlAction::Ignore,        /* GS  */ CtlAction::Ignore,
+    /* RS  */ CtlAction::Ignore,        /* US  */ CtlAction::Ignore,
+};
+/* clang-format on */
+
 void Vt102Emulation::processToken(int token, int p, int q)
 {
+    if ((token & 0xff) == 1) { // token_ctl(), see table above
+        switch (ctlAction[((token >> 8) - '@') & 0x1f]) {
+        case CtlAction::Ignore:                                          break;
+        case CtlAction::AnswerBack:    reportAnswerBack();               break;
+        case CtlAction::Bell:          reportBell();                     break;
+        case CtlAction::Backspace:     _currentScreen->backspace();      break;
+        case CtlAction::Tab:           _currentScreen->tab();            break;
+        case CtlAction::NewLine:       _currentScreen->newLine();        break;
+        case CtlAction::ToStartOfLine: _currentScreen->toStartOfLine();  break;
+        case CtlAction::ShiftOut:      useCharset(1);                    break;
+        case CtlAction::ShiftIn:       useCharset(0);                    break;
+        case CtlAction::ShowGlitch:    _currentScreen->displayCharacter(0x2592); break;
+        }
+        return;
+    }
+
     /* clang-format off */
     switch (token) {
     case token_chr(         ) :
@@ -2037,42 +2289,6 @@ void Vt102Emulation::processToken(int token, int p, int q)
 
     //             127 DEL    : ignored on input
 
-    case token_ctl('@'      ) : /* NUL: ignored                      */ break;
-    case token_ctl('A'      ) : /* SOH: ignored                      */ break;
-    case token_ctl('B'      ) : /* STX: ignored                      */ break;
-    case token_ctl('C'      ) : /* ETX: ignored                      */ break;
-    case token_ctl('D'      ) : /* EOT: ignored                      */ break;
-    case token_ctl('E'      ) :      reportAnswerBack     (          ); break; //VT100
-    case token_ctl('F'      ) : /* ACK: ignored                      */ break;
-    case token_ctl('G'      ) : Q_EMIT bell();
-                                break; //VT100
-    case token_ctl('H'      ) : _currentScreen->backspace            (          ); break; //VT100
-    case token_ctl('I'      ) : _currentScreen->tab                  (          ); break; //VT100
-    case token_ctl('J'      ) : _currentScreen->newLine              (          ); break; //VT100
-    case token_ctl('K'      ) : _currentScreen->newLine              (          ); break; //VT100
-    case token_ctl('L'      ) : _currentScreen->newLine              (          ); break; //VT100
-    case token_ctl('M'      ) : _currentScreen->toStartOfLine        (          ); break; //VT100
-
-    case token_ctl('N'      ) :      useCharset           (         1); break; //VT100
-    case token_ctl('O'      ) :      useCharset           (         0); break; //VT100
-
-    case token_ctl('P'      ) : /* DLE: ignored                      */ break;
-    case token_ctl('Q'      ) : /* DC1: XON continue                 */ break; //VT100
-    case token_ctl('R'      ) : /* DC2: ignored                      */ break;
-    case token_ctl('S'      ) : /* DC3: XOFF halt                    */ break; //VT100
-    case token_ctl('T'      ) : /* DC4: ignored                      */ break;
-    case token_ctl('U'      ) : /* NAK: ignored                      */ break;
-    case token_ctl('V'      ) : /* SYN: ignored                      */ break;
-    case token_ctl('W'      ) : /* ETB: ignored                      */ break;
-    case token_ctl('X'      ) : _currentScreen->displayCharacter     (    0x2592); break; //VT100
-    case token_ctl('Y'      ) : /* EM : ignored                      */ break;
-    case token_ctl('Z'      ) : _currentScreen->displayCharacter     (    0x2592); break; //VT100
-    case token_ctl('['      ) : /* ESC: cannot be seen here.         */ break;
-    case token_ctl('\\'     ) : /* FS : ignored                      */ break;
-    case token_ctl(']'      ) : /* GS : ignored                      */ break;
-    case token_ctl('^'      ) : /* RS : ignored                      */ break;
-    case token_ctl('_'      ) : /* US : ignored                      */ break;
-
     case token_esc('D'      ) : _currentScreen->index                (          ); break; //VT100
     case token_esc('E'      ) : _currentScreen->nextLine             (          ); break; //VT100
     case token_esc('H'      ) : _currentScreen->changeTabStop        (true      ); break; //VT100
@@ -2977,7 +3193,7 @@ void Vt102Emulation::sendMouseEvent(int cb, int cx, int cy, int eventType)
         snprintf(command, sizeof(command), "\033[M%c%c%c", cb + 0x20, cx + 0x20, cy + 0x20);
     }
 
-    sendString(command);
+    sendMouseReport(command, eventType);
 }
 
 void Vt102Emulation::sendExactMouseEvent(int cb, int x, int y, int eventType)
@@ -3010,7 +3226,49 @@ void Vt102Emulation::sendExactMouseEvent(int cb, int x, int y, int eventType)
     command[0] = '\0';
     snprintf(command, sizeof(command), "\033[<%d;%d;%d%c", cb, x, y, eventType == 2 ? 'm' : 'M');
 
+    sendMouseReport(command, eventType);
+}
+
+void Vt102Emulation::sendMouseReport(const char *command, int eventType)
+{
+    if (command[0] == '\0') {
+        return;
+    }
+
+    if (eventType != 1) {
+        // presses and releases go out immediately, but must not overtake
+        // a motion report still waiting for its frame tick
+        flushMouseMotion();
+        sendString(command);
+        return;
+    }
+
+    if (_mouseMotionTimer == nullptr) {
+        _mouseMotionTimer = new QTimer(this);
+        _mouseMotionTimer->setSingleShot(true);
+        QObject::connect(_mouseMotionTimer, &QTimer::timeout, this, &Konsole::Vt102Emulation::flushMouseMotion);
+    }
+
+    if (_mouseMotionTimer->isActive()) {
+        // latest position wins within a frame; a 1kHz mouse collapses to
+        // one report per displayed frame
+        _pendingMouseMotion = command;
+        return;
+    }
+
     sendString(command);
+    _mouseMotionTimer->start(TerminalDisplay::frameIntervalMsecs());
+}
+
+void Vt102Emulation::flushMouseMotion()
+{
+    if (_pendingMouseMotion.isEmpty()) {
+        return;
+    }
+
+    sendString(_pendingMouseMotion);
+    _pendingMouseMotion.clear();
+    _mouseMotionTimer->start(TerminalDisplay::frameIntervalMsecs());
 }
 
 void Vt102Emulation::emulateUpDown(int up, KeyboardTranslator::Entry entry, QByteArray &textToSend, int toCol)
@@ -3065,12 +3323,82 @@ void Vt102Emulation::focusChanged(bool focused)
     }
 }
 
+// pastes larger than this are fed to the terminal in chunks of this many
+// characters from the event loop, so the GUI stays responsive while the
+// pty drains.  The pty's own send queue provides the downstream buffering.
+constexpr qsizetype PasteChunkSize = 64 * 1024;
+
 void Vt102Emulation::sendText(const QString &text)
 {
-    if (!text.isEmpty()) {
+    if (text.isEmpty()) {
+        return;
+    }
+
+    if (text.size() <= PasteChunkSize && _pendingPaste.isEmpty()) {
         QKeyEvent event(QEvent::KeyPress, 0, Qt::NoModifier, text);
         sendKeyEvent(&event); // expose as a big fat keypress event
+        return;
     }
+
+    // converting and writing multi-megabyte pastes in one go blocks the
+    // GUI thread; queue the text and drain it one chunk per event loop
+    // iteration instead
+    _pendingPaste.append(text);
+    _pendingPasteTotal += text.size();
+    if (_pasteTimer == nullptr) {
+        _pasteTimer = new QTimer(this);
+        _pasteTimer->setInterval(0);
+        connect(_pasteTimer, &QTimer::timeout, this, &Vt102Emulation::sendPasteChunk);
+    }
+    _pasteTimer->start();
+}
+
+void Vt102Emulation::sendPasteChunk()
+{
+    qsizetype chunk = qMin(PasteChunkSize, _pendingPaste.size());
+    // never split a surrogate pair across chunks; the codec would
+    // replace both halves with replacement characters
+    if (chunk < _pendingPaste.size() && _pendingPaste.at(chunk - 1).isHighSurrogate()) {
+        chunk--;
+    }
+
+    if (chunk > 0) {
+        const QString text = _pendingPaste.left(chunk);
+        QKeyEvent event(QEvent::KeyPress, 0, Qt::NoModifier, text);
+        sendKeyEvent(&event);
+        _pendingPaste.remove(0, chunk);
+    }
+
+    Q_EMIT pasteProgress(int((_pendingPasteTotal - _pendingPaste.size()) * 100 / _pendingPasteTotal));
+
+    if (_pendingPaste.isEmpty()) {
+        _pasteTimer->stop();
+        _pendingPasteTotal = 0;
+    }
+}
+
+void Vt102Emulation::cancelOngoingPaste()
+{
+    if (_pendingPaste.isEmpty()) {
+        return;
+    }
+
+    // the opening bracketed paste marker may already be on the wire; if
+    // the unsent remainder carried the closing marker, still send it so
+    // the application's bracketed paste state stays balanced
+    const QLatin1String endMarker("\033[201~");
+    const bool sendEndMarker = _pendingPaste.endsWith(endMarker);
+
+    _pendingPaste.clear();
+    _pendingPasteTotal = 0;
+    _pasteTimer->stop();
+
+    if (sendEndMarker) {
+        QKeyEvent event(QEvent::KeyPress, 0, Qt::NoModifier, endMarker);
+        sendKeyEvent(&event);
+    }
+
+    Q_EMIT pasteProgress(100);
 }
 
 void Vt102Emulation::sendKeyEvent(QKeyEvent *event)
@@ -4038,6 +4366,68 @@ void Vt102Emulation::SixelCharacterAdd(uint8_t character, int repeat)
     }
 }
 
+void Vt102Emulation::SixelCharacterRunAdd(const uint *chars, int count)
+{
+    if (!m_SixelStarted) {
+        return;
+    }
+
+    const int top = m_verticalPosition * 6;
+    const int bottom = (m_verticalPosition + 1) * 6;
+    if (bottom > MAX_IMAGE_DIM) { // Ignore lines below MAX_IMAGE_DIM
+        return;
+    }
+    count = qMin(count, MAX_IMAGE_DIM - m_currentX); // Won't write beyond MAX_IMAGE_DIM
+    if (count <= 0) {
+        return;
+    }
+
+    if (bottom >= m_currentImage.height() - 1 || m_currentX + count >= m_currentImage.width()) {
+        // Grow once for the whole run; if we copy out of bounds it gets filled with 0
+        int extraWidth = 255 + count;
+        int newWidth = qMax(m_currentX + extraWidth, m_currentImage.width() + extraWidth);
+        int newHeight = (qMax(bottom + 256, m_currentImage.height() + 256) / 6 + 1) * 6;
+        newWidth = qMin(newWidth, MAX_IMAGE_DIM);
+        newHeight = qMin(newHeight, MAX_IMAGE_DIM);
+        if (newWidth != m_currentImage.width() || newHeight != m_currentImage.height()) {
+            m_currentImage = m_currentImage.copy(0, 0, newWidth, newHeight);
+        }
+        if (m_currentImage.isNull()) {
+            m_SixelStarted = false;
+            return;
+        }
+    }
+
+    const ptrdiff_t bpl = m_currentImage.bytesPerLine();
+    uchar *base = m_currentImage.bits() + top * bpl + m_currentX;
+
+    // Expand row-major: walk the whole run for each of the six scanlines, so
+    // the image writes are sequential in memory instead of striding by
+    // bytesPerLine for every data character as SixelCharacterAdd() does.
+    for (int i = 0; i < 6; i++, base += bpl) {
+        const uint bit = 1u << i;
+        if (m_preserveBackground) {
+            for (int j = 0; j < count; j++) {
+                if ((chars[j] - '?') & bit) {
+                    base[j] = m_currentColor;
+                }
+            }
+        } else {
+            for (int j = 0; j < count; j++) {
+                base[j] = ((chars[j] - '?') & bit) * m_currentColor;
+            }
+        }
+    }
+    m_currentX += count;
+
+    if (m_currentX > m_actualSize.width()) {
+        m_actualSize.setWidth(m_currentX);
+    }
+    if (bottom > m_actualSize.height()) {
+        m_actualSize.setHeight(bottom);
+    }
+}
+
 bool Vt102Emulation::processSixel(uint cc)
 {
     switch (cc) {
@@ -89,6 +89,7 @@ public Q_SLOTS:
     // reimplemented from Emulation
     void sendString(const QByteArray &string) override;
     void sendText(const QString &text) override;
+    void cancelOngoingPaste() override;
     void sendKeyEvent(QKeyEvent *) override;
     void sendMouseEvent(int buttons, int column, int line, int eventType) override;
     void sendExactMouseEvent(int buttons, int x, int y, int eventType) override;
@@ -114,6 +115,15 @@ private Q_SLOTS:
     void updateSessionAttributes();
     void deletePlayer(QMediaPlayer::MediaStatus);
 
+    // Sends the next chunk of a large paste queued by sendText().
+    // Driven by _pasteTimer so the event loop keeps running while the
+    // pty drains.
+    void sendPasteChunk();
+
+    // Sends the motion report deferred by sendMouseReport(), if any.
+    // Driven by _mouseMotionTimer at the display frame rate.
+    void flushMouseMotion();
+
 private:
     unsigned int applyCharset(uint c);
     void setCharset(int n, int cs);
@@ -127,6 +137,12 @@ private:
     // set margins for all screens back to their defaults
     void setDefaultMargins();
 
+    // Hands an encoded mouse report to the pty.  Presses and releases go
+    // out immediately; motion reports (eventType 1) are throttled to the
+    // display frame rate with the latest position winning within a frame,
+    // so high-rate mice do not flood the pty and the remote application.
+    void sendMouseReport(const char *command, int eventType);
+
     // returns true if 'mode' is set or false otherwise
     bool getMode(int mode);
     // saves the current boolean value of 'mode'
@@ -342,6 +358,17 @@ private:
     QHash<int, QString> _pendingSessionAttributesUpdates;
     QTimer *_sessionAttributesUpdateTimer;
 
+    // Remainder of a large paste which is being fed to the terminal in
+    // chunks by sendPasteChunk(); see sendText()
+    QString _pendingPaste;
+    qint64 _pendingPasteTotal = 0;
+    QTimer *_pasteTimer = nullptr;
+
+    // Encoded mouse motion report waiting for the next frame tick; see
+    // sendMouseReport()
+    QByteArray _pendingMouseMotion;
+    QTimer *_mouseMotionTimer = nullptr;
+
     bool _reportFocusEvents;
 
     QColor colorTable[256];
@@ -357,6 +384,7 @@ private:
     void SixelColorChangeRGB(const int index, int red, int green, int blue);
     void SixelColorChangeHSL(const int index, int hue, int saturation, int value);
     void SixelCharacterAdd(uint8_t character, int repeat = 1);
+    void SixelCharacterRunAdd(const uint *chars, int count);
     bool m_SixelPictureDefinition = false;
     bool m_SixelStarted = false;
     QImage m_currentImage;
@@ -53,6 +53,13 @@ void CharacterWidthTest::testWidth_data()
     QTest::newRow("0x2615  hot beverage (BUG 392171)") << uint(0x02615) << 2;
     QTest::newRow("0x26EA  church (BUG 392171)") << uint(0x026EA) << 2;
     QTest::newRow("0x1D11E musical symbol g clef (BUG 339439)") << uint(0x1D11E) << 1;
+
+    /* Boundaries of the two-level lookup table */
+    QTest::newRow("0x00FF  last direct LUT entry") << uint(0x00FF) << 1;
+    QTest::newRow("0x0100  first paged entry") << uint(0x0100) << 1;
+    QTest::newRow("0xD800  surrogate") << uint(0xD800) << -1;
+    QTest::newRow("0x10FFFF last code point") << uint(0x10FFFF) << 1;
+    QTest::newRow("0x110000 out of range") << uint(0x110000) << 1;
 }
 
 void CharacterWidthTest::testWidth()
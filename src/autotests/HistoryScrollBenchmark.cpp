@@ -0,0 +1,275 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "HistoryScrollBenchmark.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTest>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include "../history/HistoryScroll.h"
+#include "../history/HistoryTypeFile.h"
+#include "../history/HistoryTypeNone.h"
+#include "../history/compact/CompactHistoryType.h"
+
+using namespace Konsole;
+
+// Each scenario runs for at least this long so the numbers are stable.
+static const qint64 MinimumRunNsecs = 500 * 1000 * 1000;
+
+// Enough lines that the compact backend compresses most of them and the
+// file backend leaves the page cache warm-up behind.
+static const int FillLines = 50000;
+
+static std::unique_ptr<HistoryScroll> makeScroll(const QString &backend, int maxLines)
+{
+    std::unique_ptr<HistoryScroll> scroll;
+    if (backend == QLatin1String("compact")) {
+        CompactHistoryType(maxLines).scroll(scroll);
+    } else if (backend == QLatin1String("file")) {
+        HistoryTypeFile().scroll(scroll);
+    } else {
+        HistoryTypeNone().scroll(scroll);
+    }
+    return scroll;
+}
+
+// Variable-length lines of running text, like build or server logs.
+static QVector<QVector<Character>> logCorpus()
+{
+    QVector<QVector<Character>> lines;
+    for (int i = 0; i < 2000; ++i) {
+        const int length = 20 + (i * 37) % 100;
+        QVector<Character> line(length);
+        for (int c = 0; c < length; ++c) {
+            line[c] = Character((uint)('a' + (i + c) % 26));
+        }
+        lines.append(line);
+    }
+    return lines;
+}
+
+// A full-screen frame redrawn over and over with only the status line
+// changing; highly repetitive, like a TUI under a pager or monitor.
+static QVector<QVector<Character>> tuiCorpus()
+{
+    QVector<QVector<Character>> lines;
+    for (int i = 0; i < 2000; ++i) {
+        QVector<Character> line(80);
+        const int row = i % 25;
+        for (int c = 0; c < 80; ++c) {
+            line[c] = Character((uint)(row == 24 ? '0' + (i + c) % 10 : ' ' + (row + c) % 64));
+        }
+        lines.append(line);
+    }
+    return lines;
+}
+
+// Double-width CJK text: each character occupies a wide cell followed by
+// the zero right-half cell.
+static QVector<QVector<Character>> wideCorpus()
+{
+    QVector<QVector<Character>> lines;
+    for (int i = 0; i < 2000; ++i) {
+        QVector<Character> line(80);
+        for (int c = 0; c < 80; c += 2) {
+            line[c] = Character((uint)(0x4E00 + (i + c) % 256));
+            line[c + 1] = Character((uint)0);
+        }
+        lines.append(line);
+    }
+    return lines;
+}
+
+static QVector<QVector<Character>> corpusByName(const QString &name)
+{
+    if (name == QLatin1String("log")) {
+        return logCorpus();
+    }
+    if (name == QLatin1String("tui")) {
+        return tuiCorpus();
+    }
+    return wideCorpus();
+}
+
+static qint64 residentBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile statm(QStringLiteral("/proc/self/statm"));
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1) {
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return -1;
+}
+
+void HistoryScrollBenchmark::benchmarkAdd_data()
+{
+    QTest::addColumn<QString>("backend");
+    QTest::addColumn<QString>("corpus");
+
+    const QStringList backends = {QStringLiteral("compact"), QStringLiteral("file"), QStringLiteral("none")};
+    const QStringList corpora = {QStringLiteral("log"), QStringLiteral("tui"), QStringLiteral("wide")};
+    for (const QString &backend : backends) {
+        for (const QString &corpus : corpora) {
+            QTest::newRow(qPrintable(backend + QLatin1Char('/') + corpus)) << backend << corpus;
+        }
+    }
+}
+
+void HistoryScrollBenchmark::benchmarkAdd()
+{
+    QFETCH(QString, backend);
+    QFETCH(QString, corpus);
+
+    const auto lines = corpusByName(corpus);
+    auto scroll = makeScroll(backend, FillLines);
+
+    qint64 cells = 0;
+    int passes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        for (const auto &line : lines) {
+            scroll->addCells(line.constData(), line.size());
+            scroll->addLine();
+            cells += line.size();
+        }
+        ++passes;
+    } while (timer.nsecsElapsed() < MinimumRunNsecs);
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    qInfo("%s: %.1f Mcells/s", QTest::currentDataTag(), cells / seconds / 1e6);
+    QTest::setBenchmarkResult(seconds * 1000.0 / passes, QTest::WalltimeMilliseconds);
+}
+
+void HistoryScrollBenchmark::benchmarkRandomGetCells_data()
+{
+    QTest::addColumn<QString>("backend");
+
+    QTest::newRow("compact") << QStringLiteral("compact");
+    QTest::newRow("file") << QStringLiteral("file");
+}
+
+void HistoryScrollBenchmark::benchmarkRandomGetCells()
+{
+    QFETCH(QString, backend);
+
+    const auto lines = logCorpus();
+    auto scroll = makeScroll(backend, FillLines);
+    for (int i = 0; i < FillLines; ++i) {
+        const auto &line = lines.at(i % lines.size());
+        scroll->addCells(line.constData(), line.size());
+        scroll->addLine();
+    }
+
+    Character buffer[120];
+    quint32 state = 12345;
+    qint64 reads = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        // xorshift; cheap enough not to drown out the read itself
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        const int line = int(state % quint32(scroll->getLines()));
+        scroll->getCells(line, 0, scroll->getLineLen(line), buffer);
+        ++reads;
+    } while ((reads & 1023) != 0 || timer.nsecsElapsed() < MinimumRunNsecs);
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    qInfo("%s: %.0f ns/line", QTest::currentDataTag(), seconds * 1e9 / reads);
+    QTest::setBenchmarkResult(seconds * 1e6 / reads, QTest::WalltimeMilliseconds);
+}
+
+void HistoryScrollBenchmark::benchmarkReflow_data()
+{
+    QTest::addColumn<QString>("backend");
+
+    QTest::newRow("compact") << QStringLiteral("compact");
+    QTest::newRow("file") << QStringLiteral("file");
+}
+
+void HistoryScrollBenchmark::benchmarkReflow()
+{
+    QFETCH(QString, backend);
+
+    // 80-column lines, every second one wrapped, so narrowing joins and
+    // resplits real groups.  Note the compact backend re-wraps its cold
+    // blocks lazily; this measures the eager (hot tail) part both
+    // backends do synchronously, which is what resizes wait on.
+    auto scroll = makeScroll(backend, FillLines * 2);
+    QVector<Character> line(80);
+    for (int c = 0; c < 80; ++c) {
+        line[c] = Character((uint)('a' + c % 26));
+    }
+    LineProperty wrapped;
+    wrapped.flags.f.wrapped = 1;
+    for (int i = 0; i < FillLines; ++i) {
+        scroll->addCells(line.constData(), line.size());
+        scroll->addLine((i % 2) == 0 ? wrapped : LineProperty());
+    }
+
+    int passes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        scroll->reflowLines(40);
+        scroll->reflowLines(80);
+        passes += 2;
+    } while (timer.nsecsElapsed() < MinimumRunNsecs);
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    qInfo("%s: %.1f ms/reflow", QTest::currentDataTag(), seconds * 1000.0 / passes);
+    QTest::setBenchmarkResult(seconds * 1000.0 / passes, QTest::WalltimeMilliseconds);
+}
+
+void HistoryScrollBenchmark::benchmarkResidentMemory_data()
+{
+    QTest::addColumn<QString>("backend");
+
+    QTest::newRow("compact") << QStringLiteral("compact");
+    QTest::newRow("file") << QStringLiteral("file");
+    QTest::newRow("none") << QStringLiteral("none");
+}
+
+void HistoryScrollBenchmark::benchmarkResidentMemory()
+{
+    QFETCH(QString, backend);
+
+    if (residentBytes() < 0) {
+        QSKIP("resident set size is only read from /proc on Linux");
+    }
+
+    const auto lines = logCorpus();
+    const int fill = FillLines * 4;
+    auto scroll = makeScroll(backend, fill);
+
+    const qint64 before = residentBytes();
+    for (int i = 0; i < fill; ++i) {
+        const auto &line = lines.at(i % lines.size());
+        scroll->addCells(line.constData(), line.size());
+        scroll->addLine();
+    }
+    const qint64 after = residentBytes();
+
+    const double perMillion = double(after - before) / fill * 1e6 / (1024.0 * 1024.0);
+    qInfo("%s: %.0f MB resident per million lines", QTest::currentDataTag(), perMillion);
+    QTest::setBenchmarkResult(perMillion, QTest::WalltimeMilliseconds);
+}
+
+QTEST_GUILESS_MAIN(HistoryScrollBenchmark)
+
+#include "moc_HistoryScrollBenchmark.cpp"
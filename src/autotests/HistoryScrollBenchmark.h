@@ -0,0 +1,43 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef HISTORYSCROLLBENCHMARK_H
+#define HISTORYSCROLLBENCHMARK_H
+
+#include <QObject>
+
+namespace Konsole
+{
+/**
+ * Microbenchmark comparing the scrollback backends (HistoryScrollFile,
+ * CompactHistoryScroll, HistoryScrollNone) so the choice of HistoryType
+ * rests on numbers instead of folklore.
+ *
+ * Each backend is measured on add throughput (cells/s), random getCells()
+ * latency, reflowLines() time and resident memory per million lines, over
+ * corpora shaped like the common workloads: variable-length log lines,
+ * fixed-width TUI frames and double-width CJK text.  Run it like any
+ * other autotest; per-pass wall times are also recorded as Qt Test
+ * benchmark results for tracking in CI.
+ */
+class HistoryScrollBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkAdd_data();
+    void benchmarkAdd();
+    void benchmarkRandomGetCells_data();
+    void benchmarkRandomGetCells();
+    void benchmarkReflow_data();
+    void benchmarkReflow();
+    void benchmarkResidentMemory_data();
+    void benchmarkResidentMemory();
+};
+
+}
+
+#endif // HISTORYSCROLLBENCHMARK_H
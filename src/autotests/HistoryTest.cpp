@@ -7,6 +7,8 @@
 // Own
 #include "HistoryTest.h"
 
+#include <QFile>
+#include <QTemporaryDir>
 #include <QTest>
 
 // Konsole
@@ -172,6 +174,377 @@ void HistoryTest::testHistoryReflow()
     QCOMPARE(testChar, testImage[testStringSize - 1]);
 }
 
+void HistoryTest::testCompactHistoryCompression()
+{
+    // enough lines to push several blocks into the compressed cold tier
+    const int lineCount = 8000;
+    auto historyScroll = std::make_unique<CompactHistoryScroll>(lineCount);
+
+    Character lineBuffer[16];
+    for (int line = 0; line < lineCount; line++) {
+        // vary length and content so every line is distinguishable
+        const int len = 1 + line % 16;
+        for (int i = 0; i < len; i++) {
+            lineBuffer[i] = Character((uint)('a' + (line + i) % 26));
+        }
+        historyScroll->addCells(lineBuffer, len);
+        LineProperty property;
+        property.flags.f.wrapped = line % 3 == 0 ? 1 : 0;
+        historyScroll->addLine(property);
+    }
+    QCOMPARE(historyScroll->getLines(), lineCount);
+
+    // every line, cold or hot, must read back unchanged
+    Character readBuffer[16];
+    for (int line = 0; line < lineCount; line += 97) {
+        const int len = 1 + line % 16;
+        QCOMPARE(historyScroll->getLineLen(line), len);
+        QCOMPARE(historyScroll->isWrappedLine(line), line % 3 == 0);
+        historyScroll->getCells(line, 0, len, readBuffer);
+        for (int i = 0; i < len; i++) {
+            QCOMPARE(readBuffer[i], Character((uint)('a' + (line + i) % 26)));
+        }
+    }
+
+    // line properties of compressed lines stay writable
+    LineProperty property;
+    property.flags.f.wrapped = 1;
+    historyScroll->setLineProperty(5, property);
+    QCOMPARE(historyScroll->isWrappedLine(5), true);
+
+    // trimming drops the oldest (compressed) lines first
+    historyScroll->setMaxNbLines(1000);
+    QCOMPARE(historyScroll->getLines(), 1000);
+    const int firstRemaining = lineCount - 1000;
+    QCOMPARE(historyScroll->getLineLen(0), 1 + firstRemaining % 16);
+    historyScroll->getCells(0, 0, 1, readBuffer);
+    QCOMPARE(readBuffer[0], Character((uint)('a' + firstRemaining % 26)));
+}
+
+void HistoryTest::testCompactHistoryLazyReflow()
+{
+    // enough lines to fill several cold blocks
+    const int lineCount = 12000;
+    const int oldColumns = 40;
+    const int newColumns = 20;
+    auto historyScroll = std::make_unique<CompactHistoryScroll>(50000);
+
+    Character lineBuffer[oldColumns];
+    for (int line = 0; line < lineCount; line++) {
+        for (int i = 0; i < oldColumns; i++) {
+            lineBuffer[i] = Character((uint)('a' + (line + i) % 26));
+        }
+        historyScroll->addCells(lineBuffer, oldColumns);
+        historyScroll->addLine(LineProperty());
+    }
+
+    // only the hot tail is re-wrapped here; cold blocks stay at the old
+    // width until appends drain them one block at a time
+    historyScroll->reflowLines(newColumns);
+
+    const Character drainCell((uint)'z');
+    for (int line = 0; line < 16; line++) {
+        historyScroll->addCells(&drainCell, 1);
+        historyScroll->addLine(LineProperty());
+    }
+
+    // every original line must now be split into two halves of the new
+    // width, first half wrapped, contents unchanged
+    QCOMPARE(historyScroll->getLines(), lineCount * 2 + 16);
+    Character readBuffer[newColumns];
+    for (int line = 0; line < lineCount * 2; line += 499) {
+        QCOMPARE(historyScroll->getLineLen(line), newColumns);
+        QCOMPARE(historyScroll->isWrappedLine(line), line % 2 == 0);
+        historyScroll->getCells(line, 0, newColumns, readBuffer);
+        for (int i = 0; i < newColumns; i += 7) {
+            const int cell = line * newColumns + i;
+            QCOMPARE(readBuffer[i], Character((uint)('a' + (cell / oldColumns + cell % oldColumns) % 26)));
+        }
+    }
+    QCOMPARE(historyScroll->getLineLen(lineCount * 2), 1);
+}
+
+void HistoryTest::testCompactHistoryParallelReflow()
+{
+    // with a line observer attached the cold blocks cannot be re-wrapped
+    // lazily; reflowLines() re-wraps them all at once across the thread
+    // pool, and the result must be ready immediately
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const int lineCount = 12000;
+    const int oldColumns = 40;
+    const int newColumns = 20;
+    auto historyScroll = std::make_unique<CompactHistoryScroll>(50000);
+    historyScroll->enableSnapshot(dir.path() + QStringLiteral("/scrollback.khist"));
+
+    Character lineBuffer[oldColumns];
+    for (int line = 0; line < lineCount; line++) {
+        for (int i = 0; i < oldColumns; i++) {
+            lineBuffer[i] = Character((uint)('a' + (line + i) % 26));
+        }
+        historyScroll->addCells(lineBuffer, oldColumns);
+        historyScroll->addLine(LineProperty());
+    }
+
+    historyScroll->reflowLines(newColumns);
+
+    // no appends to drain a lazy re-wrap: every original line is already
+    // split into two halves of the new width, first half wrapped
+    QCOMPARE(historyScroll->getLines(), lineCount * 2);
+    Character readBuffer[newColumns];
+    for (int line = 0; line < lineCount * 2; line += 499) {
+        QCOMPARE(historyScroll->getLineLen(line), newColumns);
+        QCOMPARE(historyScroll->isWrappedLine(line), line % 2 == 0);
+        historyScroll->getCells(line, 0, newColumns, readBuffer);
+        for (int i = 0; i < newColumns; i += 7) {
+            const int cell = line * newColumns + i;
+            QCOMPARE(readBuffer[i], Character((uint)('a' + (cell / oldColumns + cell % oldColumns) % 26)));
+        }
+    }
+}
+
+void HistoryTest::testSlabPool()
+{
+    auto &pool = HistorySlabPool::instance();
+    const std::size_t usedBefore = pool.usedBytes();
+
+    void *first = pool.allocate(512);
+    QVERIFY(first != nullptr);
+    QVERIFY(pool.usedBytes() >= usedBefore + 512);
+    pool.deallocate(first, 512);
+
+    // freed chunks are reused LIFO instead of going back to the heap
+    void *second = pool.allocate(500); // same 512-byte class
+    QCOMPARE(second, first);
+    pool.deallocate(second, 500);
+    QCOMPARE(pool.usedBytes(), usedBefore);
+
+    // containers work through the allocator front-end
+    std::deque<Character, HistorySlabAllocator<Character>> cells;
+    for (int i = 0; i < 10000; i++) {
+        cells.push_back(Character((uint)('a' + i % 26)));
+    }
+    QCOMPARE(cells.size(), std::size_t(10000));
+    QCOMPARE(cells[25], Character((uint)'z'));
+}
+
+void HistoryTest::testTrigramIndex()
+{
+    HistoryTrigramIndex index;
+
+    auto appendText = [&index](const char *text) {
+        Character line[32];
+        const int len = int(qstrlen(text));
+        for (int i = 0; i < len; i++) {
+            line[i] = Character((uint)text[i]);
+        }
+        index.appendLine(line, len);
+    };
+
+    appendText("the quick brown fox");
+    appendText("jumps over the lazy dog");
+    appendText("0123456789abcdef");
+    QCOMPARE(index.lineCount(), 3);
+
+    // too short to consult the index
+    QVERIFY(!index.candidateLines(QStringLiteral("th")).has_value());
+
+    // a literal inside one line leads to that line, case folded
+    auto candidates = index.candidateLines(QStringLiteral("QUICK"));
+    QVERIFY(candidates.has_value());
+    QVERIFY(candidates->contains(0));
+    QVERIFY(!candidates->contains(2));
+
+    // absent literals produce no candidates
+    candidates = index.candidateLines(QStringLiteral("not there"));
+    QVERIFY(candidates.has_value());
+    QVERIFY(candidates->isEmpty());
+
+    // a literal spanning the boundary of lines 0/1 starts on line 0
+    candidates = index.candidateLines(QStringLiteral("foxjumps"));
+    QVERIFY(candidates->contains(0));
+
+    // dropping the newest line shrinks the numbering; after the tail of
+    // the now-last line is restored, boundary windows keep working
+    index.dropLastLine();
+    const Character tail[2] = {Character((uint)'o'), Character((uint)'g')};
+    index.setTail(tail, 2);
+    QCOMPARE(index.lineCount(), 2);
+    appendText("gone fishing");
+    candidates = index.candidateLines(QStringLiteral("doggone"));
+    QVERIFY(candidates->contains(1));
+
+    // dropping the oldest line renumbers the remaining ones
+    index.dropFirstLines(1);
+    QCOMPARE(index.lineCount(), 2);
+    candidates = index.candidateLines(QStringLiteral("lazy"));
+    QVERIFY(candidates->contains(0));
+    candidates = index.candidateLines(QStringLiteral("quick"));
+    QVERIFY(candidates->isEmpty());
+
+    index.clear();
+    QCOMPARE(index.lineCount(), 0);
+}
+
+void HistoryTest::testHistorySnapshot()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.path() + QStringLiteral("/scrollback.khist");
+
+    auto appendText = [](HistoryScroll &scroll, const char *text, LineProperty property = LineProperty()) {
+        Character line[32];
+        const int len = int(qstrlen(text));
+        for (int i = 0; i < len; i++) {
+            line[i] = Character((uint)text[i]);
+        }
+        scroll.addCells(line, len);
+        scroll.addLine(property);
+    };
+
+    {
+        CompactHistoryScroll scroll(100);
+        scroll.enableSnapshot(path);
+
+        LineProperty wrapped;
+        wrapped.flags.f.wrapped = 1;
+        appendText(scroll, "first line", wrapped);
+        appendText(scroll, "second line");
+        appendText(scroll, "doomed line");
+        // a line removed again must not come back on restore
+        scroll.removeCells();
+
+        LineProperty patched;
+        patched.flags.f.error = 1;
+        scroll.setLineProperty(1, patched);
+        // destruction flushes the writer
+    }
+
+    CompactHistoryScroll restored(100);
+    QVERIFY(restoreHistorySnapshot(path, restored, []() {
+        return QSet<uint>();
+    }));
+    QCOMPARE(restored.getLines(), 2);
+    QCOMPARE(restored.getLineLen(0), 10);
+    QVERIFY(restored.isWrappedLine(0));
+    QVERIFY(!restored.isWrappedLine(1));
+    QVERIFY(restored.getLineProperty(1).flags.f.error != 0);
+
+    Character cells[32];
+    restored.getCells(1, 0, restored.getLineLen(1), cells);
+    QCOMPARE(cells[0], Character((uint)'s'));
+    QCOMPARE(cells[10], Character((uint)'e'));
+
+    // a missing file restores nothing and reports it
+    QVERIFY(!restoreHistorySnapshot(dir.path() + QStringLiteral("/absent.khist"), restored, []() {
+        return QSet<uint>();
+    }));
+}
+
+void HistoryTest::testBatchedAddLines()
+{
+    std::unique_ptr<HistoryScroll> scroll(new CompactHistoryScroll(100));
+
+    QVector<Character> lines[3];
+    LineProperty properties[3];
+    for (int i = 0; i < 3; i++) {
+        lines[i] = QVector<Character>(10 + i, Character((uint)('a' + i)));
+        properties[i] = LineProperty();
+    }
+    properties[1].flags.f.wrapped = 1;
+
+    scroll->addLinesMove(lines, properties, 3);
+    QCOMPARE(scroll->getLines(), 3);
+    QCOMPARE(scroll->getLineLen(0), 10);
+    QCOMPARE(scroll->getLineLen(2), 12);
+    QVERIFY(!scroll->isWrappedLine(0));
+    QVERIFY(scroll->isWrappedLine(1));
+    Character cell;
+    scroll->getCells(2, 11, 1, &cell);
+    QCOMPARE(cell, Character((uint)'c'));
+
+    // batches respect the line cap the same way per-line adds do
+    QVector<Character> batch[50];
+    LineProperty batchProperties[50] = {};
+    for (int pass = 0; pass < 4; pass++) {
+        for (int i = 0; i < 50; i++) {
+            batch[i] = QVector<Character>(8, Character((uint)'x'));
+        }
+        scroll->addLinesMove(batch, batchProperties, 50);
+    }
+    QVERIFY(scroll->getLines() <= 101);
+    scroll->getCells(scroll->getLines() - 1, 0, 1, &cell);
+    QCOMPARE(cell, Character((uint)'x'));
+}
+
+void HistoryTest::testGetCellsRange()
+{
+    const Character pad((uint)'.');
+    const int columns = 10;
+
+    // the bulk fetch must agree exactly with per-line getCells() plus
+    // padding, whatever backend and range it is given
+    const auto verify = [&](HistoryScroll &scroll, int startLine, int count) {
+        QVector<Character> bulk(count * columns);
+        scroll.getCellsRange(startLine, count, columns, pad, bulk.data());
+        QVector<Character> expected(columns);
+        for (int i = 0; i < count; i++) {
+            const int length = qMin(columns, scroll.getLineLen(startLine + i));
+            std::fill(expected.begin(), expected.end(), pad);
+            scroll.getCells(startLine + i, 0, length, expected.data());
+            for (int column = 0; column < columns; column++) {
+                QCOMPARE(bulk.at(i * columns + column), expected.at(column));
+            }
+        }
+    };
+
+    const auto fillScroll = [](HistoryScroll &scroll, int lineCount) {
+        Character lineBuffer[16];
+        for (int line = 0; line < lineCount; line++) {
+            const int len = 1 + line % 16;
+            for (int i = 0; i < len; i++) {
+                lineBuffer[i] = Character((uint)('a' + (line + i) % 26));
+            }
+            scroll.addCells(lineBuffer, len);
+            scroll.addLine();
+        }
+    };
+
+    // file backend: the range is served by one contiguous read
+    {
+        HistoryScrollFile scroll;
+        fillScroll(scroll, 200);
+        verify(scroll, 0, 40);
+        verify(scroll, 57, 25);
+        verify(scroll, 160, 40); // includes the last line
+
+        // an overlong line forces the per-line fallback path
+        QVector<Character> longLine(200, Character((uint)'z'));
+        scroll.addCells(longLine.constData(), longLine.size());
+        scroll.addLine();
+        verify(scroll, 198, 3);
+
+        // warming the cache must not disturb subsequent reads
+        scroll.prefetchRange(100, 40);
+        verify(scroll, 100, 40);
+    }
+
+    // compact backend: ranges within the cold tier, within the hot tier
+    // and straddling the boundary between them
+    {
+        const int lineCount = 6000;
+        CompactHistoryScroll scroll(lineCount);
+        fillScroll(scroll, lineCount);
+        verify(scroll, 0, 40);
+        verify(scroll, lineCount - 40, 40);
+        verify(scroll, 1850, 120);
+
+        scroll.prefetchRange(123, 40);
+        verify(scroll, 123, 40);
+    }
+}
+
 void HistoryTest::testHistoryTypeChange()
 {
     std::unique_ptr<HistoryScroll> historyScroll(nullptr);
@@ -218,6 +591,63 @@ void HistoryTest::testHistoryTypeChange()
     QCOMPARE(historyScroll->getLines(), 0);
 }
 
+void HistoryTest::testHistoryHibernation()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.path() + QStringLiteral("/hibernated.khist");
+    const auto noExtendedChars = []() {
+        return QSet<uint>();
+    };
+
+    // the none scroll has nothing to hibernate
+    std::unique_ptr<HistoryScroll> historyScroll = std::make_unique<HistoryScrollNone>();
+    QVERIFY(!HistoryScrollHibernated::hibernate(historyScroll, path, noExtendedChars));
+
+    auto compactHistoryType = std::make_unique<CompactHistoryType>(100);
+    compactHistoryType->scroll(historyScroll);
+
+    const char testString[] = "abcdefghijklmnopqrstuvwxyz1234567890";
+    const int testStringSize = sizeof(testString) / sizeof(char) - 1;
+    Character testImage[testStringSize];
+    for (int i = 0; i < testStringSize; i++) {
+        testImage[i] = Character((uint)testString[i]);
+    }
+    LineProperty wrapped;
+    wrapped.flags.f.wrapped = 1;
+    historyScroll->addCells(testImage, testStringSize);
+    historyScroll->addLine(wrapped);
+    historyScroll->addCells(testImage, 10);
+    historyScroll->addLine();
+
+    QVERIFY(HistoryScrollHibernated::hibernate(historyScroll, path, noExtendedChars));
+    auto *hibernated = dynamic_cast<HistoryScrollHibernated *>(historyScroll.get());
+    QVERIFY(hibernated != nullptr);
+    QVERIFY(QFile::exists(path));
+
+    // metadata queries are answered without touching the snapshot
+    QVERIFY(hibernated->isFrozen());
+    QCOMPARE(historyScroll->getLines(), 2);
+    QCOMPARE(historyScroll->getMaxLines(), 100);
+    QVERIFY(historyScroll->sizeBytes() > 0);
+    QVERIFY(hibernated->isFrozen());
+
+    // the first line data access restores from the snapshot
+    QCOMPARE(historyScroll->getLineLen(0), testStringSize);
+    QVERIFY(!hibernated->isFrozen());
+    QVERIFY(!QFile::exists(path));
+    QVERIFY(historyScroll->isWrappedLine(0));
+    QVERIFY(!historyScroll->isWrappedLine(1));
+    Character testChar;
+    historyScroll->getCells(1, 9, 1, &testChar);
+    QCOMPARE(testChar, testImage[9]);
+
+    // the owner swaps the restored scroll back in
+    HistoryScrollHibernated::collapse(historyScroll);
+    QVERIFY(dynamic_cast<CompactHistoryScroll *>(historyScroll.get()) != nullptr);
+    QCOMPARE(historyScroll->getLines(), 2);
+}
+
 QTEST_MAIN(HistoryTest)
 
 #include "moc_HistoryTest.cpp"
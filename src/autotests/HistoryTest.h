@@ -11,7 +11,11 @@
 
 #include "../characters/Character.h"
 #include "../history/HistoryScrollFile.h"
+#include "../history/HistoryScrollHibernated.h"
 #include "../history/HistoryScrollNone.h"
+#include "../history/HistorySlabAllocator.h"
+#include "../history/HistorySnapshot.h"
+#include "../history/HistoryTrigramIndex.h"
 #include "../history/HistoryTypeFile.h"
 #include "../history/HistoryTypeNone.h"
 #include "../history/compact/CompactHistoryScroll.h"
@@ -32,7 +36,16 @@ private Q_SLOTS:
     void testEmulationHistory();
     void testHistoryScroll();
     void testHistoryReflow();
+    void testCompactHistoryCompression();
+    void testCompactHistoryLazyReflow();
+    void testCompactHistoryParallelReflow();
+    void testSlabPool();
+    void testTrigramIndex();
+    void testHistorySnapshot();
+    void testBatchedAddLines();
+    void testGetCellsRange();
     void testHistoryTypeChange();
+    void testHistoryHibernation();
 
 private:
     static constexpr const char testString[] = "abcdefghijklmnopqrstuvwxyz1234567890";
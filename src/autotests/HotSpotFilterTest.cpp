@@ -6,6 +6,7 @@
 
 #include "HotSpotFilterTest.h"
 #include "filterHotSpots/HotSpot.h"
+#include "filterHotSpots/SessionScanCache.h"
 #include <QTest>
 
 QTEST_GUILESS_MAIN(HotSpotFilterTest)
@@ -199,4 +200,158 @@ void HotSpotFilterTest::testUrlFilter()
     }
 }
 
+void HotSpotFilterTest::testProcessRegion()
+{
+    Konsole::RegExpFilter filter;
+    filter.setRegExp(QRegularExpression(QStringLiteral("foo")));
+
+    const QString buffer = QStringLiteral("foo bar\nbaz foo\nquux\n");
+    const QList<int> linePositions = {0, 8, 16};
+    filter.setBuffer(&buffer, &linePositions);
+
+    // a full process() sees both occurrences; hotspots become visible
+    // once the scan's results are committed
+    filter.process();
+    QCOMPARE(filter.hotSpots().size(), 0);
+    filter.commitHotSpots();
+    QCOMPARE(filter.hotSpots().size(), 2);
+    QCOMPARE(filter.hotSpots().at(1)->startLine(), 1);
+
+    // the interval index answers position queries over the committed set
+    QVERIFY(filter.hotSpotAt(0, 1) != nullptr);
+    QVERIFY(filter.hotSpotAt(1, 4) != nullptr);
+    QVERIFY(filter.hotSpotAt(1, 3) == nullptr);
+    QVERIFY(filter.hotSpotAt(1, 8) == nullptr);
+    QVERIFY(filter.hotSpotAt(2, 0) == nullptr);
+
+    // a region-limited scan only sees the occurrence inside the range
+    filter.reset();
+    filter.processRegion(8, 16, 1);
+    filter.commitHotSpots();
+    QCOMPARE(filter.hotSpots().size(), 1);
+    QSharedPointer<Konsole::HotSpot> spot = filter.hotSpots().first();
+    QCOMPARE(spot->startLine(), 1);
+    QCOMPARE(spot->startColumn(), 4);
+
+    // cached hotspots are relocated when their text scrolls
+    spot->shiftLines(3);
+    QCOMPARE(spot->startLine(), 4);
+    QCOMPARE(spot->endLine(), 4);
+}
+
+void HotSpotFilterTest::testPrefilter()
+{
+    Konsole::UrlFilter filter;
+
+    // no "://", "www." or '@' anywhere, so the prefilter rejects the
+    // region before the URL regex even runs
+    const QString plain = QStringLiteral("make[2]: Entering directory '/tmp/build'\n");
+    const QList<int> plainLines = {0};
+    filter.setBuffer(&plain, &plainLines);
+    filter.process();
+    filter.commitHotSpots();
+    QCOMPARE(filter.hotSpots().size(), 0);
+
+    // candidates still reach the regex, independent of case
+    const QString urls = QStringLiteral("docs at HTTPS://api.kde.org or mail foo@bar.org\n");
+    const QList<int> urlLines = {0};
+    filter.setBuffer(&urls, &urlLines);
+    filter.reset();
+    filter.process();
+    filter.commitHotSpots();
+    QCOMPARE(filter.hotSpots().size(), 2);
+}
+
+void HotSpotFilterTest::testLiteralPrefilter()
+{
+    // the literal derived from a user pattern must never reject text
+    // the pattern would match, whatever quantifiers, classes, groups or
+    // case options surround it
+    const auto countMatches = [](const QRegularExpression &regExp, const QString &buffer) {
+        Konsole::RegExpFilter filter;
+        filter.setRegExp(regExp);
+        const QList<int> linePositions = {0};
+        filter.setBuffer(&buffer, &linePositions);
+        filter.process();
+        filter.commitHotSpots();
+        return filter.hotSpots().size();
+    };
+
+    // optional atom shortens the required literal
+    QCOMPARE(countMatches(QRegularExpression(QStringLiteral("colou?r")), QStringLiteral("my color is red\n")), 1);
+    // character class and quantifier after the literal
+    QCOMPARE(countMatches(QRegularExpression(QStringLiteral("issue-[0-9]+")), QStringLiteral("see issue-42\n")), 1);
+    // escaped metacharacter stays part of the literal
+    QCOMPARE(countMatches(QRegularExpression(QStringLiteral("core\\.\\d+")), QStringLiteral("wrote core.1234\n")), 1);
+    // alternation inside a group; only the trailing literal is required
+    QCOMPARE(countMatches(QRegularExpression(QStringLiteral("(foo|bar)baz")), QStringLiteral("got foobaz\n")), 1);
+    // case-insensitive option carries over to the literal scan
+    QCOMPARE(countMatches(QRegularExpression(QStringLiteral("warning"), QRegularExpression::CaseInsensitiveOption), QStringLiteral("WARNING: disk\n")),
+             1);
+    // and non-matching text still produces nothing
+    QCOMPARE(countMatches(QRegularExpression(QStringLiteral("colou?r")), QStringLiteral("nothing here\n")), 0);
+}
+
+void HotSpotFilterTest::testSessionScanCache()
+{
+    Konsole::SessionScanCache cache;
+
+    // snapshots answer only for the exact viewport they were taken from
+    int screenStandIn = 0;
+    Konsole::SessionScanCache::ViewportKey key;
+    key.screen = &screenStandIn;
+    key.generation = 7;
+    key.currentLine = 100;
+    key.lines = 25;
+    key.columns = 80;
+
+    Konsole::SessionScanCache::Snapshot published;
+    published.key = key;
+    published.buffer = QStringLiteral("hello world\n");
+    published.linePositions = {0};
+    published.chunks = {{0, 0, 12}};
+    cache.publishSnapshot(published);
+
+    Konsole::SessionScanCache::Snapshot fetched;
+    QVERIFY(cache.snapshotFor(key, &fetched));
+    QCOMPARE(fetched.buffer, published.buffer);
+    QCOMPARE(fetched.chunks.size(), 1);
+    QCOMPARE(fetched.chunks.at(0).endPos, 12);
+
+    Konsole::SessionScanCache::ViewportKey scrolled = key;
+    scrolled.currentLine = 99;
+    QVERIFY(!cache.snapshotFor(scrolled, &fetched));
+    Konsole::SessionScanCache::ViewportKey newer = key;
+    newer.generation = 8;
+    QVERIFY(!cache.snapshotFor(newer, &fetched));
+    QVERIFY(!cache.snapshotFor(Konsole::SessionScanCache::ViewportKey(), &fetched));
+
+    // negative results are keyed on the filter-set fingerprint; a
+    // fingerprint change drops them, and empty fingerprints never share
+    const QString fingerprint = QStringLiteral("0:https?://\n");
+    cache.recordEmpty(fingerprint, QStringLiteral("plain text\n"));
+    QVERIFY(cache.isKnownEmpty(fingerprint, QStringLiteral("plain text\n")));
+    QVERIFY(!cache.isKnownEmpty(fingerprint, QStringLiteral("other text\n")));
+    QVERIFY(!cache.isKnownEmpty(QStringLiteral("0:ftp://\n"), QStringLiteral("plain text\n")));
+
+    cache.recordEmpty(QStringLiteral("0:ftp://\n"), QStringLiteral("plain text\n"));
+    QVERIFY(!cache.isKnownEmpty(fingerprint, QStringLiteral("plain text\n")));
+
+    cache.recordEmpty(QString(), QStringLiteral("plain text\n"));
+    QVERIFY(!cache.isKnownEmpty(QString(), QStringLiteral("plain text\n")));
+
+    // equivalently configured filters fingerprint identically, different
+    // patterns or options do not
+    Konsole::RegExpFilter first;
+    first.setRegExp(QRegularExpression(QStringLiteral("issue-[0-9]+")));
+    Konsole::RegExpFilter second;
+    second.setRegExp(QRegularExpression(QStringLiteral("issue-[0-9]+")));
+    QCOMPARE(first.cacheFingerprint(), second.cacheFingerprint());
+
+    second.setRegExp(QRegularExpression(QStringLiteral("issue-[0-9]+"), QRegularExpression::CaseInsensitiveOption));
+    QVERIFY(first.cacheFingerprint() != second.cacheFingerprint());
+    second.setRegExp(QRegularExpression(QStringLiteral("bug-[0-9]+")));
+    QVERIFY(first.cacheFingerprint() != second.cacheFingerprint());
+}
+
 #include "moc_HotSpotFilterTest.cpp"
@@ -19,6 +19,11 @@ private Q_SLOTS:
 
     void testUrlFilter_data();
     void testUrlFilter();
+
+    void testProcessRegion();
+    void testPrefilter();
+    void testLiteralPrefilter();
+    void testSessionScanCache();
 };
 
 #endif // HOTSPOTFILTERTEST_H
@@ -0,0 +1,222 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "PaintBenchmark.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFontDatabase>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QTest>
+
+// Konsole
+#include "../Vt102Emulation.h"
+#include "../terminalDisplay/TerminalDisplay.h"
+#include "../terminalDisplay/TerminalFonts.h"
+#include "../terminalDisplay/TerminalPainter.h"
+
+using namespace Konsole;
+
+// Each scenario runs for at least this long so the numbers are stable.
+static const qint64 MinimumRunNsecs = 500 * 1000 * 1000;
+
+// Plain printable text filling the whole grid; exercises the glyph
+// cache blit path with one fragment per line.
+static QByteArray plainFrame(int columns, int lines)
+{
+    QByteArray frame;
+    for (int y = 0; y < lines; ++y) {
+        for (int x = 0; x < columns - 1; ++x) {
+            frame += char('a' + ((x + y) % 26));
+        }
+        if (y != lines - 1) {
+            frame += "\r\n";
+        }
+    }
+    return frame;
+}
+
+// Short words separated by SGR color and bold changes; every change
+// splits a fragment, so this measures per-fragment overhead.
+static QByteArray sgrHeavyFrame(int columns, int lines)
+{
+    QByteArray frame;
+    for (int y = 0; y < lines; ++y) {
+        for (int x = 0; x + 6 < columns; x += 6) {
+            frame += "\033[" + QByteArray::number(31 + (x / 6) % 7) + (x % 12 == 0 ? ";1m" : "m");
+            frame += "word ";
+        }
+        frame += "\033[0m";
+        if (y != lines - 1) {
+            frame += "\r\n";
+        }
+    }
+    return frame;
+}
+
+// Box-drawing characters mixed with plain text at @p sharePercent;
+// exercises the LineBlockCharacters painting path, which bypasses the
+// glyph cache.
+static QByteArray boxDrawingFrame(int columns, int lines, int sharePercent)
+{
+    static const QChar boxChars[] = {QChar(0x2500), QChar(0x2502), QChar(0x250C), QChar(0x2510), QChar(0x2514), QChar(0x2518), QChar(0x253C)};
+
+    QString frame;
+    for (int y = 0; y < lines; ++y) {
+        for (int x = 0; x < columns - 1; ++x) {
+            if ((x * sharePercent) % 100 < sharePercent) {
+                frame += boxChars[(x + y) % 7];
+            } else {
+                frame += QChar('a' + ((x + y) % 26));
+            }
+        }
+        if (y != lines - 1) {
+            frame += QStringLiteral("\r\n");
+        }
+    }
+    return frame.toUtf8();
+}
+
+// Renders the emulation's current screen through drawContents() until
+// MinimumRunNsecs has passed and returns the average ms/frame.
+//
+// The screen window is deliberately not attached to the display:
+// TerminalDisplay::setScreenWindow() runs the session profile plumbing,
+// which needs a full session controller, while drawContents() itself
+// only needs the display for fonts, colors and geometry.
+static double measurePaintedFrame(Vt102Emulation &emulation, int columns, int lines, double dpr, int *framesOut = nullptr)
+{
+    TerminalDisplay display(nullptr);
+    display.terminalFont()->setVTFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    display.setForcedSize(columns, lines);
+
+    ScreenWindow *window = emulation.createWindow();
+    window->setWindowLines(lines);
+    Character *image = window->getImage();
+    const QVector<LineProperty> lineProperties = window->getLineProperties();
+
+    const int fontWidth = display.terminalFont()->fontWidth();
+    const int fontHeight = display.terminalFont()->fontHeight();
+    QImage frame(int(columns * fontWidth * dpr), int(lines * fontHeight * dpr), QImage::Format_ARGB32_Premultiplied);
+    frame.setDevicePixelRatio(dpr);
+    frame.fill(Qt::black);
+
+    TerminalPainter terminalPainter(&display);
+    const QRect cellRect(0, 0, columns, lines);
+
+    int frames = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        QPainter paint(&frame);
+        terminalPainter.drawContents(image, paint, cellRect, false, columns * lines, false, lineProperties);
+        ++frames;
+    } while (timer.nsecsElapsed() < MinimumRunNsecs);
+
+    if (framesOut != nullptr) {
+        *framesOut = frames;
+    }
+    return timer.nsecsElapsed() / 1e6 / frames;
+}
+
+void PaintBenchmark::benchmarkDrawContents_data()
+{
+    QTest::addColumn<int>("columns");
+    QTest::addColumn<int>("lines");
+    QTest::addColumn<QByteArray>("frame");
+    QTest::addColumn<double>("dpr");
+
+    QTest::newRow("plain 80x25") << 80 << 25 << plainFrame(80, 25) << 1.0;
+    QTest::newRow("plain 240x67") << 240 << 67 << plainFrame(240, 67) << 1.0;
+    QTest::newRow("SGR heavy 80x25") << 80 << 25 << sgrHeavyFrame(80, 25) << 1.0;
+    QTest::newRow("SGR heavy 240x67") << 240 << 67 << sgrHeavyFrame(240, 67) << 1.0;
+    QTest::newRow("box 25% 80x25") << 80 << 25 << boxDrawingFrame(80, 25, 25) << 1.0;
+    QTest::newRow("box 100% 80x25") << 80 << 25 << boxDrawingFrame(80, 25, 100) << 1.0;
+    QTest::newRow("plain 80x25 dpr2") << 80 << 25 << plainFrame(80, 25) << 2.0;
+    QTest::newRow("plain 240x67 dpr2") << 240 << 67 << plainFrame(240, 67) << 2.0;
+}
+
+void PaintBenchmark::benchmarkDrawContents()
+{
+    QFETCH(int, columns);
+    QFETCH(int, lines);
+    QFETCH(QByteArray, frame);
+    QFETCH(double, dpr);
+
+    Vt102Emulation emulation;
+    emulation.reset();
+    emulation.setCodec(Emulation::Utf8Codec);
+    emulation.setImageSize(lines, columns);
+    emulation.receiveData(frame.constData(), frame.size());
+
+    int frames = 0;
+    const double msPerFrame = measurePaintedFrame(emulation, columns, lines, dpr, &frames);
+
+    qInfo("%s: %.2f ms/frame (%d frames)", QTest::currentDataTag(), msPerFrame, frames);
+    QTest::setBenchmarkResult(msPerFrame, QTest::WalltimeMilliseconds);
+}
+
+// Loads either an asciicast v2 file or a raw pty byte log as one
+// contiguous stream; only the final screen matters here, so the chunk
+// boundaries preserved by the recording are irrelevant.
+static QByteArray loadRecordedStream(const QString &path, int &columns, int &lines)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    if (!file.peek(1).startsWith('{')) {
+        return file.readAll();
+    }
+
+    const QJsonObject header = QJsonDocument::fromJson(file.readLine()).object();
+    columns = header.value(QStringLiteral("width")).toInt(columns);
+    lines = header.value(QStringLiteral("height")).toInt(lines);
+
+    QByteArray stream;
+    while (!file.atEnd()) {
+        const QJsonArray event = QJsonDocument::fromJson(file.readLine()).array();
+        if (event.size() >= 3 && event.at(1).toString() == QLatin1String("o")) {
+            stream += event.at(2).toString().toUtf8();
+        }
+    }
+    return stream;
+}
+
+void PaintBenchmark::benchmarkPaintRecording()
+{
+    const QString path = qEnvironmentVariable("KONSOLE_PAINT_RECORDING");
+    if (path.isEmpty()) {
+        QSKIP("Set KONSOLE_PAINT_RECORDING to a session recording (asciicast v2 or raw log) to paint it");
+    }
+
+    int columns = 80;
+    int lines = 25;
+    const QByteArray stream = loadRecordedStream(path, columns, lines);
+    QVERIFY2(!stream.isEmpty(), "recording is empty or could not be parsed");
+
+    Vt102Emulation emulation;
+    emulation.reset();
+    emulation.setCodec(Emulation::Utf8Codec);
+    emulation.setImageSize(lines, columns);
+    emulation.receiveData(stream.constData(), stream.size());
+
+    int frames = 0;
+    const double msPerFrame = measurePaintedFrame(emulation, columns, lines, 1.0, &frames);
+
+    qInfo("paint %s (%dx%d): %.2f ms/frame (%d frames)", qPrintable(path), columns, lines, msPerFrame, frames);
+    QTest::setBenchmarkResult(msPerFrame, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(PaintBenchmark)
+
+#include "moc_PaintBenchmark.cpp"
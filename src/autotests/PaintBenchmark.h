@@ -0,0 +1,45 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PAINTBENCHMARK_H
+#define PAINTBENCHMARK_H
+
+#include <QObject>
+
+namespace Konsole
+{
+/**
+ * Headless benchmark for the painting pipeline.
+ *
+ * Each scenario feeds a synthetic byte stream through Vt102Emulation
+ * and then renders the resulting screen repeatedly through
+ * TerminalPainter::drawContents() into an offscreen QImage, reporting
+ * ms/frame.  The matrix covers grid size, attribute density,
+ * box-drawing share and device pixel ratio, so glyph cache and painter
+ * changes can be evaluated (and regressions caught) without a window
+ * system.  The DPR is applied to the target image, which drives the
+ * QPainter scaling the same way a highdpi backing store does.
+ *
+ * benchmarkPaintRecording() paints a real session instead of a
+ * synthetic frame: point KONSOLE_PAINT_RECORDING at an asciicast v2
+ * recording (as written by the session recorder) or a raw pty log, and
+ * the final screen of the replay is rendered in a loop.  Companion to
+ * KONSOLE_REPLAY_RECORDING in Vt102EmulationBenchmark, which measures
+ * the emulation side of the same corpus.
+ */
+class PaintBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkDrawContents_data();
+    void benchmarkDrawContents();
+    void benchmarkPaintRecording();
+};
+
+}
+
+#endif // PAINTBENCHMARK_H
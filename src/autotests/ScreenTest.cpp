@@ -7,6 +7,9 @@
 // Own
 #include "ScreenTest.h"
 
+// Konsole
+#include "../history/compact/CompactHistoryType.h"
+
 // Qt
 #include <QString>
 
@@ -242,6 +245,135 @@ void ScreenTest::testCursorPosition()
     delete screen;
 }
 
+// Test: displayCharacters produces the same image as repeated
+// displayCharacter calls, including wide characters and wrapping
+void ScreenTest::testDisplayCharactersBatch()
+{
+    // mixes ASCII runs, isolated wide characters and a long CJK run so
+    // both batch fast paths and the wrap fallback between them are hit
+    const QString putToScreen =
+        QStringLiteral("plain ascii 위 mixed 트 with wide characters and a line longer than the screen 0123456789 0123456789 端末のスクロールバックを全部印刷する作業は時間がかかる");
+
+    QVector<uint> codepoints;
+    for (const QChar &c : putToScreen) {
+        codepoints.append(c.unicode());
+    }
+
+    Screen perCharScreen(largeScreenLines, 40);
+    for (uint c : codepoints) {
+        perCharScreen.displayCharacter(c);
+    }
+
+    Screen batchScreen(largeScreenLines, 40);
+    batchScreen.displayCharacters(codepoints.constData(), codepoints.size());
+
+    QCOMPARE(batchScreen.getCursorY(), perCharScreen.getCursorY());
+    QCOMPARE(batchScreen.getCursorX(), perCharScreen.getCursorX());
+
+    perCharScreen.setSelectionStart(0, 0, false);
+    perCharScreen.setSelectionEnd(40, largeScreenLines - 1, false);
+    batchScreen.setSelectionStart(0, 0, false);
+    batchScreen.setSelectionEnd(40, largeScreenLines - 1, false);
+    QCOMPARE(batchScreen.selectedText(Screen::PlainText), perCharScreen.selectedText(Screen::PlainText));
+}
+
+void ScreenTest::testRepeatChars()
+{
+    // the bulk REP fill must leave the screen exactly as repeating
+    // displayCharacter() would, including wraps onto following lines
+    auto compareAgainstPerChar = [this](uint c, int count) {
+        Screen perCharScreen(largeScreenLines, 40);
+        perCharScreen.displayCharacter(c);
+        for (int i = 0; i < count; i++) {
+            perCharScreen.displayCharacter(c);
+        }
+
+        Screen repScreen(largeScreenLines, 40);
+        repScreen.displayCharacter(c);
+        repScreen.repeatChars(count);
+
+        QCOMPARE(repScreen.getCursorY(), perCharScreen.getCursorY());
+        QCOMPARE(repScreen.getCursorX(), perCharScreen.getCursorX());
+
+        perCharScreen.setSelectionStart(0, 0, false);
+        perCharScreen.setSelectionEnd(40, largeScreenLines - 1, false);
+        repScreen.setSelectionStart(0, 0, false);
+        repScreen.setSelectionEnd(40, largeScreenLines - 1, false);
+        QCOMPARE(repScreen.selectedText(Screen::PlainText), perCharScreen.selectedText(Screen::PlainText));
+    };
+
+    compareAgainstPerChar('=', 10); // within one line
+    compareAgainstPerChar('#', 100); // wraps across several lines
+    compareAgainstPerChar(0x2500, 90); // box drawing, the progress-bar case
+    compareAgainstPerChar(0x7AEF, 10); // double-width takes the general path
+}
+
+void ScreenTest::testPromptNavigation()
+{
+    Screen screen(4, 10);
+    screen.setScroll(CompactHistoryType(100), false);
+
+    // Three commands of three lines each, the prompt flag on the first
+    // line; most of them scroll into the history.
+    auto runCommand = [&screen]() {
+        screen.setLineProperty(LINE_PROMPT_START, true);
+        for (int line = 0; line < 3; ++line) {
+            screen.displayCharacter('a');
+            screen.newLine();
+        }
+    };
+    for (int command = 0; command < 3; ++command) {
+        runCommand();
+    }
+
+    // prompts sit at absolute lines 0, 3 and 6; the history holds 6 lines
+    QCOMPARE(screen.findPromptLine(10, false), 6);
+    QCOMPARE(screen.findPromptLine(6, false), 3);
+    QCOMPARE(screen.findPromptLine(3, false), 0);
+    QCOMPARE(screen.findPromptLine(0, false), -1);
+    QCOMPARE(screen.findPromptLine(0, true), 3);
+    QCOMPARE(screen.findPromptLine(6, true), -1);
+
+    const std::pair<int, int> extent = screen.commandExtent(4);
+    QCOMPARE(extent.first, 3);
+    QCOMPARE(extent.second, 5);
+
+    // another command exercises the incremental index maintenance as its
+    // lines scroll into the history
+    runCommand();
+    QCOMPARE(screen.findPromptLine(13, false), 9);
+    QCOMPARE(screen.findPromptLine(6, true), 9);
+
+    const std::pair<int, int> lastExtent = screen.commandExtent(12);
+    QCOMPARE(lastExtent.first, 9);
+    QCOMPARE(lastExtent.second, 12);
+}
+
+void ScreenTest::testScrolledRegionTracking()
+{
+    Screen screen(10, 20);
+
+    // DECSTBM region leaving two status lines at the bottom
+    screen.setMargins(1, 8);
+    screen.scrollUp(1);
+    QCOMPARE(screen.lastScrolledRegion(), QRect(0, 0, 19, 7));
+
+    // same-region scrolls coalesce and keep the blit region
+    screen.scrollUp(1);
+    QCOMPARE(screen.lastScrolledRegion(), QRect(0, 0, 19, 7));
+
+    // a scroll of a different region in the same update cycle cannot be
+    // described by a single blit
+    screen.setMargins(2, 9);
+    screen.scrollUp(1);
+    QCOMPARE(screen.lastScrolledRegion(), QRect());
+
+    // the next update cycle starts fresh, also for reverse scrolls
+    screen.resetScrolledLines();
+    screen.scrollDown(1);
+    QCOMPARE(screen.lastScrolledRegion(), QRect(0, 1, 19, 7));
+}
+
 QTEST_GUILESS_MAIN(ScreenTest)
 
 #include "moc_ScreenTest.cpp"
@@ -24,6 +24,10 @@ private Q_SLOTS:
     void testBlockSelection();
     void testCJKBlockSelection();
     void testCursorPosition();
+    void testDisplayCharactersBatch();
+    void testRepeatChars();
+    void testPromptNavigation();
+    void testScrolledRegionTracking();
 
 private:
     void doLargeScreenCopyVerification(const QString &putToScreen, const QString &expectedSelection);
@@ -48,6 +48,78 @@ void ScreenWindowTest::testAtEndOfOutputWithSmallLineCount()
     QVERIFY(window.atEndOfOutput());
 }
 
+void ScreenWindowTest::testCursorMoveDirtiesLines()
+{
+    Screen screen(10, 20);
+    ScreenWindow window(&screen);
+    window.setWindowLines(10);
+
+    window.getImage();
+    window.resetDirtyLines();
+
+    // pure cursor movement changes no line generation, but the cursor
+    // rendition is baked into the window buffer; both the line the cursor
+    // left and the one it entered must repaint
+    screen.cursorDown(3);
+    window.notifyOutputChanged();
+    window.getImage();
+
+    QVERIFY(window.isLineDirty(0));
+    QVERIFY(window.isLineDirty(3));
+    QVERIFY(!window.isLineDirty(7));
+}
+
+void ScreenWindowTest::testSelectionChangeDirtiesLines()
+{
+    Screen screen(10, 20);
+    ScreenWindow window(&screen);
+    window.setWindowLines(10);
+
+    window.setSelectionStart(0, 4, false);
+    window.setSelectionEnd(10, 4, false);
+    window.getImage();
+    window.resetDirtyLines();
+
+    // extending the selection dirties the lines the highlight spreads
+    // across, and nothing outside the union of the old and new spans
+    window.setSelectionEnd(10, 6, false);
+    window.getImage();
+
+    QVERIFY(window.isLineDirty(4));
+    QVERIFY(window.isLineDirty(5));
+    QVERIFY(window.isLineDirty(6));
+    QVERIFY(!window.isLineDirty(2));
+    QVERIFY(!window.isLineDirty(8));
+
+    // clearing the selection dirties the span it vacated
+    window.resetDirtyLines();
+    window.clearSelection();
+    window.getImage();
+
+    QVERIFY(window.isLineDirty(4));
+    QVERIFY(window.isLineDirty(6));
+    QVERIFY(!window.isLineDirty(8));
+}
+
+void ScreenWindowTest::testReverseVideoDirtiesAllLines()
+{
+    Screen screen(10, 20);
+    ScreenWindow window(&screen);
+    window.setWindowLines(10);
+
+    window.getImage();
+    window.resetDirtyLines();
+
+    // DECSCNM inverts every cell of the buffer
+    screen.setMode(MODE_Screen);
+    window.notifyOutputChanged();
+    window.getImage();
+
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY(window.isLineDirty(i));
+    }
+}
+
 QTEST_GUILESS_MAIN(ScreenWindowTest)
 
 #include "moc_ScreenWindowTest.cpp"
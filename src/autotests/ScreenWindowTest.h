@@ -19,6 +19,9 @@ class ScreenWindowTest : public QObject
 private Q_SLOTS:
     void testScrollToWithSmallLineCount();
     void testAtEndOfOutputWithSmallLineCount();
+    void testCursorMoveDirtiesLines();
+    void testSelectionChangeDirtiesLines();
+    void testReverseVideoDirtiesAllLines();
 };
 
 }
@@ -0,0 +1,230 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "TmuxIntegrationBenchmark.h"
+#include "TmuxTestDSL.h"
+
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QScopeGuard>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+
+#include "../Emulation.h"
+#include "../MainWindow.h"
+#include "../Screen.h"
+#include "../ScreenWindow.h"
+#include "../ViewManager.h"
+#include "../session/Session.h"
+#include "../terminalDisplay/TerminalDisplay.h"
+#include "../widgets/ViewContainer.h"
+
+using namespace Konsole;
+
+void TmuxIntegrationBenchmark::initTestCase()
+{
+    QVERIFY(m_tmuxTmpDir.isValid());
+    qputenv("TMUX_TMPDIR", m_tmuxTmpDir.path().toUtf8());
+}
+
+void TmuxIntegrationBenchmark::cleanupTestCase()
+{
+    const QString tmuxPath = QStandardPaths::findExecutable(QStringLiteral("tmux"));
+    if (!tmuxPath.isEmpty()) {
+        QProcess kill;
+        kill.start(tmuxPath, {QStringLiteral("kill-server")});
+        kill.waitForFinished(5000);
+    }
+}
+
+// Read all visible text from a Session's screen
+static QString readSessionScreenText(Session *session)
+{
+    ScreenWindow *window = session->emulation()->createWindow();
+    Screen *screen = window->screen();
+
+    int lines = screen->getLines();
+    int columns = screen->getColumns();
+
+    screen->setSelectionStart(0, 0, false);
+    screen->setSelectionEnd(columns, lines - 1, false);
+    return screen->selectedText(Screen::PlainText);
+}
+
+static Session *findPaneSession(const TmuxTestDSL::AttachResult &attach)
+{
+    const auto sessions = attach.mw->viewManager()->sessions();
+    for (Session *s : sessions) {
+        if (s != attach.gatewaySession) {
+            return s;
+        }
+    }
+    return nullptr;
+}
+
+static void teardown(TmuxTestDSL::AttachResult &attach)
+{
+    const auto sessions = attach.mw->viewManager()->sessions();
+    for (Session *s : sessions) {
+        if (s != attach.gatewaySession) {
+            s->closeInNormalWay();
+        }
+    }
+    attach.gatewaySession->closeInNormalWay();
+    QTRY_VERIFY_WITH_TIMEOUT(!attach.mw, 10000);
+    delete attach.mw.data();
+}
+
+void TmuxIntegrationBenchmark::benchmarkAttachLatency()
+{
+    const QString tmuxPath = TmuxTestDSL::findTmuxOrSkip();
+
+    // The pane prints a sentinel on startup; attach is "done" once that
+    // sentinel has travelled server → gateway → capture-pane recovery →
+    // virtual session screen, i.e. the user sees their content.
+    TmuxTestDSL::SessionContext ctx;
+    TmuxTestDSL::setupTmuxSession(TmuxTestDSL::parse(QStringLiteral(R"(
+        ┌────────────────────────────────────────────────────────────────────────────────┐
+        │ cmd: echo BENCH_READY && sleep 30                                              │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        └────────────────────────────────────────────────────────────────────────────────┘
+    )")), tmuxPath, ctx);
+    auto cleanup = qScopeGuard([&] { TmuxTestDSL::killTmuxSession(tmuxPath, ctx.sessionName); });
+
+    QElapsedTimer timer;
+    timer.start();
+
+    TmuxTestDSL::AttachResult attach;
+    TmuxTestDSL::attachKonsole(tmuxPath, ctx.sessionName, attach);
+
+    Session *paneSession = findPaneSession(attach);
+    QVERIFY(paneSession);
+    QTRY_VERIFY_WITH_TIMEOUT(readSessionScreenText(paneSession).contains(QLatin1String("BENCH_READY")), 15000);
+
+    const double msecs = timer.nsecsElapsed() / 1e6;
+    qInfo("attach-to-first-content: %.0f ms", msecs);
+    QTest::setBenchmarkResult(msecs, QTest::WalltimeMilliseconds);
+
+    teardown(attach);
+}
+
+void TmuxIntegrationBenchmark::benchmarkOutputThroughput()
+{
+    const QString tmuxPath = TmuxTestDSL::findTmuxOrSkip();
+
+    TmuxTestDSL::SessionContext ctx;
+    TmuxTestDSL::setupTmuxSession(TmuxTestDSL::parse(QStringLiteral(R"(
+        ┌────────────────────────────────────────────────────────────────────────────────┐
+        │ cmd: sh                                                                        │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        │                                                                                │
+        └────────────────────────────────────────────────────────────────────────────────┘
+    )")), tmuxPath, ctx);
+    auto cleanup = qScopeGuard([&] { TmuxTestDSL::killTmuxSession(tmuxPath, ctx.sessionName); });
+
+    TmuxTestDSL::AttachResult attach;
+    TmuxTestDSL::attachKonsole(tmuxPath, ctx.sessionName, attach);
+
+    Session *paneSession = findPaneSession(attach);
+    QVERIFY(paneSession);
+
+    // 200k lines of 16 chars + newline = 3.4 MB through %output decode,
+    // coalescing and emulation, finished by a sentinel on the screen.
+    const qint64 bytes = 200000ll * 17;
+    QElapsedTimer timer;
+    timer.start();
+    QProcess::execute(tmuxPath,
+                      {QStringLiteral("send-keys"),
+                       QStringLiteral("-t"),
+                       ctx.sessionName,
+                       QStringLiteral("yes 0123456789abcdef | head -n 200000; echo BENCH_DONE"),
+                       QStringLiteral("Enter")});
+    QTRY_VERIFY_WITH_TIMEOUT(readSessionScreenText(paneSession).contains(QLatin1String("BENCH_DONE")), 60000);
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    qInfo("%%output throughput: %.1f MB/s", bytes / seconds / 1e6);
+    QTest::setBenchmarkResult(seconds * 1000.0, QTest::WalltimeMilliseconds);
+
+    teardown(attach);
+}
+
+void TmuxIntegrationBenchmark::benchmarkLayoutChangeSettle()
+{
+    const QString tmuxPath = TmuxTestDSL::findTmuxOrSkip();
+
+    TmuxTestDSL::SessionContext ctx;
+    TmuxTestDSL::setupTmuxSession(TmuxTestDSL::parse(QStringLiteral(R"(
+        ┌────────────────────────────────────────┬────────────────────────────────────────┐
+        │ cmd: sleep 30                          │ cmd: sleep 30                          │
+        │                                        │                                        │
+        │                                        │                                        │
+        │                                        │                                        │
+        │                                        │                                        │
+        │                                        │                                        │
+        │                                        │                                        │
+        │                                        │                                        │
+        │                                        │                                        │
+        │                                        │                                        │
+        └────────────────────────────────────────┴────────────────────────────────────────┘
+    )")), tmuxPath, ctx);
+    auto cleanup = qScopeGuard([&] { TmuxTestDSL::killTmuxSession(tmuxPath, ctx.sessionName); });
+
+    TmuxTestDSL::AttachResult attach;
+    TmuxTestDSL::attachKonsole(tmuxPath, ctx.sessionName, attach);
+
+    // Fire a storm of out-of-band resizes; each one comes back to Konsole
+    // as a %layout-change. Settled means some pane display shows the final
+    // 30-column grid (the split starts at 40/40 and moves by 10).
+    const int resizes = 10;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < resizes; ++i) {
+        QProcess::execute(tmuxPath, {QStringLiteral("resize-pane"), QStringLiteral("-t"), ctx.sessionName, QStringLiteral("-L"), QStringLiteral("1")});
+    }
+
+    const auto paneHasColumns = [&](int columns) {
+        const auto sessions = attach.mw->viewManager()->sessions();
+        for (Session *s : sessions) {
+            if (s == attach.gatewaySession) {
+                continue;
+            }
+            const auto views = s->views();
+            for (TerminalDisplay *view : views) {
+                if (view->columns() == columns) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    QTRY_VERIFY_WITH_TIMEOUT(paneHasColumns(30), 15000);
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    qInfo("layout-change settle: %d resizes in %.0f ms (%.1f layouts/s)", resizes, seconds * 1000.0, resizes / seconds);
+    QTest::setBenchmarkResult(seconds * 1000.0, QTest::WalltimeMilliseconds);
+
+    teardown(attach);
+}
+
+QTEST_MAIN(TmuxIntegrationBenchmark)
+
+#include "moc_TmuxIntegrationBenchmark.cpp"
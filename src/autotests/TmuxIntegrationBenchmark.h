@@ -0,0 +1,44 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef TMUXINTEGRATIONBENCHMARK_H
+#define TMUXINTEGRATIONBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+namespace Konsole
+{
+/**
+ * Timing scenarios for tmux control mode against a real tmux server,
+ * built on the same TmuxTestDSL scaffolding as TmuxIntegrationTest:
+ * attach-to-first-content latency, %output throughput into a pane and
+ * the settle time of a %layout-change storm.
+ *
+ * Each scenario prints its headline number with qInfo() and records the
+ * wall time as a Qt Test benchmark result, so CI can parse either the
+ * log line or the usual -csv/-xml benchmark output and gate releases on
+ * regressions. Scenarios skip when tmux is not installed, like the
+ * integration test.
+ */
+class TmuxIntegrationBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchmarkAttachLatency();
+    void benchmarkOutputThroughput();
+    void benchmarkLayoutChangeSettle();
+
+private:
+    QTemporaryDir m_tmuxTmpDir;
+};
+
+}
+
+#endif // TMUXINTEGRATIONBENCHMARK_H
@@ -10,7 +10,10 @@
 
 #include "../MainWindow.h"
 #include "../ViewManager.h"
+#include "../session/SessionController.h"
+#include "../terminalDisplay/TerminalDisplay.h"
 #include "../widgets/ViewContainer.h"
+#include "../widgets/ViewSplitter.h"
 #include <QStandardPaths>
 
 using namespace Konsole;
@@ -57,6 +60,32 @@ void ViewManagerTest::testLoadLayout()
     QCOMPARE(mw.viewManager()->viewHierarchy(), expectedHierarchy);
 }
 
+void ViewManagerTest::testDetachKeepsController()
+{
+    // detaching moves the live display together with its controller; the
+    // receiving ViewManager must adopt the existing controller instead of
+    // constructing a new one (which would rebuild filters and re-scan)
+    auto mw = MainWindow();
+    mw.viewManager()->newSession(mw.viewManager()->defaultProfile(), m_testDir->path());
+
+    auto *splitter = mw.viewManager()->activeContainer()->viewSplitterAt(0);
+    auto *display = splitter->findChildren<TerminalDisplay *>().constFirst();
+    auto *controller = display->sessionController();
+    QVERIFY(controller != nullptr);
+
+    QHash<TerminalDisplay *, Session *> sessionsMap = mw.viewManager()->forgetAll(splitter);
+
+    auto mw2 = MainWindow();
+    const QList<TerminalDisplay *> displays = splitter->findChildren<TerminalDisplay *>();
+    for (TerminalDisplay *terminal : displays) {
+        mw2.viewManager()->attachView(terminal, sessionsMap[terminal]);
+    }
+    mw2.viewManager()->activeContainer()->addSplitter(splitter);
+
+    QCOMPARE(display->sessionController(), controller);
+    QCOMPARE(controller->parent(), mw2.viewManager());
+}
+
 QTEST_MAIN(ViewManagerTest)
 
 #include "moc_ViewManagerTest.cpp"
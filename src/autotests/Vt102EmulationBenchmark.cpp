@@ -0,0 +1,311 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "Vt102EmulationBenchmark.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "../history/compact/CompactHistoryType.h"
+
+using namespace Konsole;
+
+// Allocation accounting for the replay scenario.  The counting allocator
+// below replaces the global one for the whole test binary; through ELF
+// symbol interposition it also covers allocations made inside the konsole
+// libraries.  Counting is switched on only around the measured loop so
+// corpus loading does not pollute the numbers.
+static std::atomic<qint64> s_allocationCount{0};
+static std::atomic<qint64> s_allocationBytes{0};
+static bool s_countAllocations = false;
+
+static void *countedAlloc(std::size_t size)
+{
+    if (s_countAllocations) {
+        s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+        s_allocationBytes.fetch_add(qint64(size), std::memory_order_relaxed);
+    }
+    return std::malloc(size);
+}
+
+void *operator new(std::size_t size)
+{
+    void *pointer = countedAlloc(size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void *operator new[](std::size_t size)
+{
+    void *pointer = countedAlloc(size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+// Feed the corpus in pty-sized chunks; receiveData() is never called with
+// arbitrarily large buffers in production.
+static const int ChunkSize = 4096;
+
+// Each scenario runs for at least this long so the numbers are stable.
+static const qint64 MinimumRunNsecs = 500 * 1000 * 1000;
+
+// 80 columns of plain printable text per line; exercises the printable
+// fast path and ordinary line feeds.
+static QByteArray asciiFloodCorpus()
+{
+    QByteArray line;
+    for (int i = 0; i < 79; ++i) {
+        line += char('a' + (i % 26));
+    }
+    line += "\r\n";
+
+    QByteArray corpus;
+    for (int i = 0; i < 2000; ++i) {
+        corpus += line;
+    }
+    return corpus;
+}
+
+// Short words separated by SGR color and attribute changes; exercises the
+// CSI tokenizer and rendition updates.
+static QByteArray sgrHeavyCorpus()
+{
+    QByteArray corpus;
+    for (int i = 0; i < 2000; ++i) {
+        for (int word = 0; word < 10; ++word) {
+            corpus += "\033[" + QByteArray::number(30 + (word % 8)) + ";1m";
+            corpus += "word";
+            corpus += "\033[0m ";
+        }
+        corpus += "\r\n";
+    }
+    return corpus;
+}
+
+// Single-character lines well past the screen height; exercises scrollUp()
+// and the history handoff.
+static QByteArray scrollingCorpus()
+{
+    QByteArray corpus;
+    for (int i = 0; i < 20000; ++i) {
+        corpus += "y\r\n";
+    }
+    return corpus;
+}
+
+// A DCS sixel image repeated a few times; exercises the DCS path and the
+// sixel decoder.
+static QByteArray sixelCorpus()
+{
+    QByteArray image = "\033Pq\"1;1;96;60#0;2;0;0;0#1;2;100;100;0";
+    for (int band = 0; band < 10; ++band) {
+        image += "#1";
+        for (int i = 0; i < 96; ++i) {
+            image += char('?' + (i % 63));
+        }
+        image += '-';
+    }
+    image += "\033\\";
+
+    QByteArray corpus;
+    for (int i = 0; i < 50; ++i) {
+        corpus += image;
+    }
+    return corpus;
+}
+
+// Lines of double-width CJK characters; exercises the UTF-8 decoder and
+// wide-character handling in Screen.
+static QByteArray wideCjkCorpus()
+{
+    QString line;
+    for (int i = 0; i < 40; ++i) {
+        line += QChar(0x4E00 + (i % 256));
+    }
+    line += QStringLiteral("\r\n");
+
+    QByteArray corpus;
+    const QByteArray utf8Line = line.toUtf8();
+    for (int i = 0; i < 2000; ++i) {
+        corpus += utf8Line;
+    }
+    return corpus;
+}
+
+struct Recording {
+    // the output stream split at the chunk boundaries the recording
+    // preserved, so replay sees the same receiveData() call pattern
+    QList<QByteArray> chunks;
+    qint64 totalBytes = 0;
+    int columns = 80;
+    int lines = 25;
+};
+
+// Loads either an asciicast v2 file as written by the session recorder
+// (a JSON header line followed by one [time, "o", data] event per chunk)
+// or a raw pty byte log, which is chunked at pty read size.
+static Recording loadRecording(const QString &path)
+{
+    Recording recording;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return recording;
+    }
+
+    const QByteArray firstLine = file.peek(1);
+    if (firstLine.startsWith('{')) {
+        const QJsonObject header = QJsonDocument::fromJson(file.readLine()).object();
+        recording.columns = header.value(QStringLiteral("width")).toInt(recording.columns);
+        recording.lines = header.value(QStringLiteral("height")).toInt(recording.lines);
+        while (!file.atEnd()) {
+            const QJsonArray event = QJsonDocument::fromJson(file.readLine()).array();
+            if (event.size() < 3 || event.at(1).toString() != QLatin1String("o")) {
+                continue;
+            }
+            const QByteArray chunk = event.at(2).toString().toUtf8();
+            if (!chunk.isEmpty()) {
+                recording.chunks.append(chunk);
+                recording.totalBytes += chunk.size();
+            }
+        }
+    } else {
+        while (!file.atEnd()) {
+            const QByteArray chunk = file.read(ChunkSize);
+            recording.chunks.append(chunk);
+            recording.totalBytes += chunk.size();
+        }
+    }
+    return recording;
+}
+
+void Vt102EmulationBenchmark::benchmarkReplayRecording()
+{
+    const QString path = qEnvironmentVariable("KONSOLE_REPLAY_RECORDING");
+    if (path.isEmpty()) {
+        QSKIP("Set KONSOLE_REPLAY_RECORDING to a session recording (asciicast v2 or raw log) to replay it");
+    }
+
+    const Recording recording = loadRecording(path);
+    QVERIFY2(!recording.chunks.isEmpty(), "recording is empty or could not be parsed");
+
+    BenchmarkEmulation em;
+    em.reset();
+    em.setCodec(Emulation::Utf8Codec);
+    em.setImageSize(recording.lines, recording.columns);
+    em.setHistory(CompactHistoryType(1000));
+
+    s_allocationCount = 0;
+    s_allocationBytes = 0;
+    s_countAllocations = true;
+
+    int passes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        for (const QByteArray &chunk : recording.chunks) {
+            em.receiveData(chunk.constData(), chunk.size());
+        }
+        ++passes;
+    } while (timer.nsecsElapsed() < MinimumRunNsecs);
+
+    s_countAllocations = false;
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    const double megabytes = double(passes) * recording.totalBytes / (1024.0 * 1024.0);
+    qInfo("replay %s: %.1f MB/s, %.0f ktokens/s, %lld allocations (%.1f MB) per pass",
+          qPrintable(path),
+          megabytes / seconds,
+          em.tokenCount / seconds / 1000.0,
+          qlonglong(s_allocationCount.load() / passes),
+          double(s_allocationBytes.load()) / passes / (1024.0 * 1024.0));
+
+    QTest::setBenchmarkResult(seconds * 1000.0 / passes, QTest::WalltimeMilliseconds);
+}
+
+void Vt102EmulationBenchmark::benchmarkReceiveData_data()
+{
+    QTest::addColumn<QByteArray>("corpus");
+
+    QTest::newRow("ascii flood") << asciiFloodCorpus();
+    QTest::newRow("SGR heavy") << sgrHeavyCorpus();
+    QTest::newRow("scrolling") << scrollingCorpus();
+    QTest::newRow("sixel") << sixelCorpus();
+    QTest::newRow("wide CJK") << wideCjkCorpus();
+}
+
+void Vt102EmulationBenchmark::benchmarkReceiveData()
+{
+    QFETCH(QByteArray, corpus);
+
+    BenchmarkEmulation em;
+    em.reset();
+    em.setCodec(Emulation::Utf8Codec);
+    em.setImageSize(25, 80);
+    em.setHistory(CompactHistoryType(1000));
+
+    int passes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        for (qsizetype offset = 0; offset < corpus.size(); offset += ChunkSize) {
+            em.receiveData(corpus.constData() + offset, qMin<qsizetype>(ChunkSize, corpus.size() - offset));
+        }
+        ++passes;
+    } while (timer.nsecsElapsed() < MinimumRunNsecs);
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    const double megabytes = double(passes) * corpus.size() / (1024.0 * 1024.0);
+    qInfo("%s: %.1f MB/s, %.0f ktokens/s", QTest::currentDataTag(), megabytes / seconds, em.tokenCount / seconds / 1000.0);
+
+    QTest::setBenchmarkResult(seconds * 1000.0 / passes, QTest::WalltimeMilliseconds);
+}
+
+QTEST_GUILESS_MAIN(Vt102EmulationBenchmark)
+
+#include "moc_Vt102EmulationBenchmark.cpp"
@@ -0,0 +1,60 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef VT102EMULATIONBENCHMARK_H
+#define VT102EMULATIONBENCHMARK_H
+
+#include <QObject>
+
+#include "Vt102Emulation.h"
+
+namespace Konsole
+{
+/**
+ * Throughput benchmark for the emulation pipeline (vtebench-style).
+ *
+ * Each scenario drives Vt102Emulation::receiveData() with a synthetic
+ * corpus and reports MB/s and tokens/s, so regressions in the tokenizer
+ * or screen code show up as numbers rather than as user bug reports.
+ * Run it like any other autotest; the per-pass wall time is also
+ * recorded as a Qt Test benchmark result for tracking in CI.
+ *
+ * benchmarkReplayRecording() replays a real session instead of a
+ * synthetic corpus: point KONSOLE_REPLAY_RECORDING at an asciicast v2
+ * recording (as written by the session recorder) or a raw pty log, and
+ * the recorded chunks are fed through the emulation at full speed,
+ * reporting MB/s and heap allocation counts.  This turns "konsole got
+ * slow rendering our output" into a file that can be benchmarked and
+ * bisected.
+ */
+class Vt102EmulationBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmarkReceiveData_data();
+    void benchmarkReceiveData();
+    void benchmarkReplayRecording();
+};
+
+class BenchmarkEmulation : public Vt102Emulation
+{
+    Q_OBJECT
+
+public:
+    qint64 tokenCount = 0;
+
+protected:
+    void processToken(int code, int p, int q) override
+    {
+        ++tokenCount;
+        Vt102Emulation::processToken(code, p, q);
+    }
+};
+
+}
+
+#endif // VT102EMULATIONBENCHMARK_H
@@ -765,6 +765,42 @@ void Vt102EmulationTest::testTmuxControlModeRawBytePassthrough()
     QCOMPARE(received, expected);
 }
 
+void Vt102EmulationTest::testTmuxControlModeBulkLines()
+{
+    // A capture-pane flood delivers many protocol lines in one PTY read.
+    // receiveRawData() frames complete LF/CRLF-terminated lines as
+    // zero-copy views of the read buffer; only lines split across reads
+    // go through the line buffer. Verify both paths deliver identical
+    // lines, including the CRLF terminators tmux uses.
+    TestEmulation em;
+    em.reset();
+    em.setCodec(TestEmulation::Utf8Codec);
+
+    QSignalSpy lineSpy(&em, &Vt102Emulation::tmuxControlModeLineReceived);
+
+    const QByteArray dcs("\033P1000p");
+    em.receiveData(dcs.constData(), dcs.size());
+
+    // Three lines in one chunk: LF-, CRLF- and LF-terminated
+    const QByteArray chunk("%output %1 one\n%output %1 two\r\n%output %1 three\n");
+    em.receiveData(chunk.constData(), chunk.size());
+
+    QCOMPARE(lineSpy.count(), 3);
+    QCOMPARE(lineSpy.at(0).at(0).toByteArray(), QByteArrayLiteral("%output %1 one"));
+    QCOMPARE(lineSpy.at(1).at(0).toByteArray(), QByteArrayLiteral("%output %1 two"));
+    QCOMPARE(lineSpy.at(2).at(0).toByteArray(), QByteArrayLiteral("%output %1 three"));
+
+    // A CRLF split across two reads must still frame one line
+    const QByteArray chunk1("%output %1 four\r");
+    const QByteArray chunk2("\n%output %1 five\r\n");
+    em.receiveData(chunk1.constData(), chunk1.size());
+    em.receiveData(chunk2.constData(), chunk2.size());
+
+    QCOMPARE(lineSpy.count(), 5);
+    QCOMPARE(lineSpy.at(3).at(0).toByteArray(), QByteArrayLiteral("%output %1 four"));
+    QCOMPARE(lineSpy.at(4).at(0).toByteArray(), QByteArrayLiteral("%output %1 five"));
+}
+
 QTEST_GUILESS_MAIN(Vt102EmulationTest)
 
 #include "moc_Vt102EmulationTest.cpp"
@@ -43,6 +43,7 @@ private Q_SLOTS:
     void testTmuxControlModeUtf8ChunkBoundary();
     void testTmuxControlModeUtf8OutputBoundary();
     void testTmuxControlModeRawBytePassthrough();
+    void testTmuxControlModeBulkLines();
 
 private:
     static void sendAndCompare(TestEmulation *em, const char *input, size_t inputLen, const QString &expectedPrint, const QByteArray &expectedSent);
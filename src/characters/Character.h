@@ -18,6 +18,8 @@
 // Qt
 #include <QVector>
 
+#include <type_traits>
+
 /* clang-format off */
 const int LINE_WRAPPED              = (1 << 0);
 const int LINE_DOUBLEWIDTH          = (1 << 1);
@@ -440,6 +442,18 @@ constexpr bool Character::equalsFormat(const Character &other) const
 {
     return backgroundColor == other.backgroundColor && foregroundColor == other.foregroundColor && rendition.all == other.rendition.all;
 }
+
+// Cells are copied by the row with memcpy/memcmp through _screenLines, the
+// display image, history scrolls and the on-disk scrollback, so Character
+// must stay a padding-free POD: 4 (character) + 2 (rendition) + 4 + 4
+// (colors) + 2 (flags) = 16 bytes. All 16 rendition bits are in use and a
+// CharacterColor cannot drop below four bytes without moving truecolor
+// cells out-of-line, so this is the floor for a directly-addressable cell;
+// ExtraFlags still has six spare bits for future per-cell state.
+static_assert(sizeof(RenditionFlagsC) == 2, "RenditionFlagsC must pack to two bytes");
+static_assert(sizeof(CharacterColor) == 4, "CharacterColor must pack to four bytes");
+static_assert(sizeof(Character) == 16, "Character must stay a 16-byte padding-free cell");
+static_assert(std::is_trivially_copyable<Character>::value, "history and the display image copy Character with memcpy");
 }
 Q_DECLARE_TYPEINFO(Konsole::Character, Q_MOVABLE_TYPE);
 
@@ -180,6 +180,14 @@ public:
      */
     constexpr QColor color(const QColor *base) const;
 
+    /**
+     * Returns the color within the specified color @p base, resolving
+     * 256-color indexes through the pre-computed @p map256 table (256
+     * entries, see TerminalColor::color256Table()) instead of recomputing
+     * the color cube entry.
+     */
+    constexpr QColor color(const QColor *base, const QColor *map256) const;
+
     /**
      * Compares two colors and returns true if they represent the same color value and
      * use the same color space.
@@ -252,6 +260,14 @@ constexpr QColor CharacterColor::color(const QColor *base) const
     return QColor();
 }
 
+constexpr QColor CharacterColor::color(const QColor *base, const QColor *map256) const
+{
+    if (_colorSpace == COLOR_SPACE_256) {
+        return map256[_u];
+    }
+    return color(base);
+}
+
 inline void CharacterColor::setIntensive()
 {
     if (_colorSpace == COLOR_SPACE_SYSTEM || _colorSpace == COLOR_SPACE_DEFAULT) {
@@ -35,58 +35,37 @@
 
 #include "CharacterWidth.h"
 
-struct Range {
-    uint first, last;
-};
-/* clang-format on */
-
-struct RangeLut {
-    int8_t width;
-    const Range *const lut;
-    int size;
-};
-
-enum {
-    InvalidWidth = INT8_MIN,
-};
-
-/* clang-format off */
 static constexpr const int8_t DIRECT_LUT[] = {«!fmt "% d":«direct-lut:
     «!repeat 32:«:«»,»»
 »»};
 
-«ranges-luts:«:
-static constexpr const Range «name»[] = {«!fmt "%#.6x":«ranges:
-    «!repeat 8:«:{«first»,«last»},»»
+// Two-level width lookup for everything above the direct LUT. Pages of
+// (1 << PageShift) code points are deduplicated; PAGE_INDEX maps a code
+// point's page number to its shared page in PAGE_DATA.
+static constexpr const uint8_t PAGE_INDEX[] = {«!fmt "%3d":«page-index:
+    «!repeat 16:«:«»,»»
 »»};
-»»
 
-static constexpr const RangeLut RANGE_LUT_LIST[] = {«ranges-lut-list:
-    «:{«!fmt "% d":«width»», «!fmt "%-16s":«name»», «size»},»
-»};
-static constexpr const int RANGE_LUT_LIST_SIZE = «ranges-lut-list-size»;
+static constexpr const int8_t PAGE_DATA[] = {«!fmt "% d":«page-data:
+    «!repeat 32:«:«»,»»
+»»};
 /* clang-format on */
 
+enum {
+    PageShift = «page-shift»,
+    PageMask = (1 << PageShift) - 1,
+    CodePointsNum = 0x110000,
+};
+
 int characterWidth(uint ucs4)
 {
+    // ASCII and Latin-1 short-circuit - the vast majority of terminal output
     if (Q_LIKELY(ucs4 < sizeof(DIRECT_LUT))) {
         return DIRECT_LUT[ucs4];
     }
-
-    for (auto rl = RANGE_LUT_LIST; rl->lut != nullptr; ++rl) {
-        int l = 0;
-        int r = rl->size - 1;
-        while (l <= r) {
-            const int m = (l + r) / 2;
-            if (rl->lut[m].last < ucs4) {
-                l = m + 1;
-            } else if (rl->lut[m].first > ucs4) {
-                r = m - 1;
-            } else {
-                return rl->width;
-            }
-        }
+    if (Q_UNLIKELY(ucs4 >= CodePointsNum)) {
+        return 1;
     }
-
-    return RANGE_LUT_LIST[RANGE_LUT_LIST_SIZE - 1].width;
+    // Branch-free two-level lookup: page id, then offset within the page
+    return PAGE_DATA[(uint(PAGE_INDEX[ucs4 >> PageShift]) << PageShift) | (ucs4 & PageMask)];
 }
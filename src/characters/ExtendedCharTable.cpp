@@ -9,23 +9,218 @@
 
 #include "charactersdebug.h"
 
+#include <QMutexLocker>
+
 using namespace Konsole;
 
-ExtendedCharTable::ExtendedCharTable() = default;
+ExtendedCharTable::ExtendedCharTable()
+{
+    for (Shard &shard : _shards) {
+        shard.table.store(allocateTable(InitialShardCapacity), std::memory_order_relaxed);
+    }
+}
 
 ExtendedCharTable::~ExtendedCharTable()
 {
-    // free all allocated character buffers
-    QHashIterator<uint, char32_t *> iter(_extendedCharTable);
-    while (iter.hasNext()) {
-        iter.next();
-        delete[] iter.value();
+    // character buffers live in the arena blocks; only the entry structs
+    // and slot arrays are freed individually
+    for (Shard &shard : _shards) {
+        Table *table = shard.table.load(std::memory_order_relaxed);
+        for (int i = 0; i < table->capacity; ++i) {
+            Entry *entry = table->slots[i].load(std::memory_order_relaxed);
+            if (entry != nullptr) {
+                delete entry;
+            }
+        }
+        delete[] table->slots;
+        delete table;
+    }
+    // retired tables only hold slot arrays - their entries are either live
+    // in a current table or sit in the retired entries list
+    for (Table *table : std::as_const(_retiredTables)) {
+        delete[] table->slots;
+        delete table;
+    }
+    for (Entry *entry : std::as_const(_retiredEntries)) {
+        delete entry;
+    }
+    for (char32_t *block : std::as_const(_arenaBlocks)) {
+        delete[] block;
+    }
+    for (char32_t *block : std::as_const(_retiredArenaBlocks)) {
+        delete[] block;
     }
 }
 
 // global instance
 ExtendedCharTable ExtendedCharTable::instance;
 
+ExtendedCharTable::Table *ExtendedCharTable::allocateTable(int capacity)
+{
+    auto *table = new Table;
+    table->capacity = capacity;
+    table->slots = new std::atomic<Entry *>[capacity];
+    for (int i = 0; i < capacity; ++i) {
+        table->slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+    return table;
+}
+
+void ExtendedCharTable::placeEntry(Table *table, Entry *entry)
+{
+    const int mask = table->capacity - 1;
+    int index = int((entry->hash >> ShardBits) & uint(mask));
+    while (table->slots[index].load(std::memory_order_relaxed) != nullptr) {
+        index = (index + 1) & mask;
+    }
+    // release publishes the entry's fields and buffer contents to
+    // concurrent lock-free readers
+    table->slots[index].store(entry, std::memory_order_release);
+}
+
+void ExtendedCharTable::growShard(Shard &shard)
+{
+    Table *old = shard.table.load(std::memory_order_relaxed);
+    Table *bigger = allocateTable(old->capacity * 2);
+    for (int i = 0; i < old->capacity; ++i) {
+        Entry *entry = old->slots[i].load(std::memory_order_relaxed);
+        if (entry != nullptr) {
+            placeEntry(bigger, entry);
+        }
+    }
+    shard.table.store(bigger, std::memory_order_release);
+    // readers may still probe the old table; keep it until destruction.
+    // Growth is geometric, so retired slot arrays stay bounded by the
+    // size of the current ones.
+    _retiredTables.append(old);
+}
+
+char32_t *ExtendedCharTable::arenaAllocate(int length)
+{
+    if (_arenaBlocks.isEmpty() || _arenaBlockUsed + length > _arenaBlockCapacity) {
+        _arenaBlockCapacity = qMax(int(ArenaBlockSize), length);
+        _arenaBlocks.append(new char32_t[_arenaBlockCapacity]);
+        _arenaBlockUsed = 0;
+    }
+    char32_t *run = _arenaBlocks.last() + _arenaBlockUsed;
+    _arenaBlockUsed += length;
+    return run;
+}
+
+QSet<uint> ExtendedCharTable::collectUsedChars(const pExtendedChars &extraChars) const
+{
+    QSet<uint> used;
+    for (const pExtendedChars &provider : _usedCharsProviders) {
+        used.unite(provider());
+    }
+    if (extraChars) {
+        used.unite(extraChars());
+    }
+    return used;
+}
+
+void ExtendedCharTable::removeUnusedEntries(const QSet<uint> &usedExtendedChars)
+{
+    // surviving sequences move into a fresh arena so the storage stays
+    // compact; the old blocks are retired with the old entries
+    const QList<char32_t *> oldBlocks = _arenaBlocks;
+    _arenaBlocks.clear();
+    _arenaBlockUsed = 0;
+    _arenaBlockCapacity = 0;
+
+    int live = 0;
+    for (Shard &shard : _shards) {
+        Table *old = shard.table.load(std::memory_order_relaxed);
+        Table *rebuilt = allocateTable(old->capacity);
+        int kept = 0;
+        for (int i = 0; i < old->capacity; ++i) {
+            Entry *entry = old->slots[i].load(std::memory_order_relaxed);
+            if (entry == nullptr) {
+                continue;
+            }
+            if (usedExtendedChars.contains(entry->hash)) {
+                // readers may still hold the old entry and buffer; publish
+                // a fresh entry with an arena copy instead of mutating
+                const int run = int(entry->buffer[0]) + 1;
+                auto *survivor = new Entry;
+                survivor->hash = entry->hash;
+                survivor->buffer = arenaAllocate(run);
+                std::copy_n(entry->buffer, run, survivor->buffer);
+                placeEntry(rebuilt, survivor);
+                ++kept;
+            }
+            _retiredEntries.append(entry);
+        }
+        shard.size = kept;
+        live += kept;
+        shard.table.store(rebuilt, std::memory_order_release);
+        _retiredTables.append(old);
+    }
+    _liveEntries = live;
+    _retiredArenaBlocks.append(oldBlocks);
+}
+
+void ExtendedCharTable::maybeSweep(uint keepHash)
+{
+    if (_liveEntries < MinEntriesForSweep || _liveEntries < 2 * _entriesAfterLastSweep) {
+        return;
+    }
+    QSet<uint> used = collectUsedChars(nullptr);
+    // the entry just created is not stored in any screen cell yet; keep it
+    used.insert(keepHash);
+    removeUnusedEntries(used);
+    _entriesAfterLastSweep = _liveEntries;
+}
+
+void ExtendedCharTable::registerUsedCharsProvider(const void *owner, const pExtendedChars &provider)
+{
+    QMutexLocker locker(&_writerMutex);
+    _usedCharsProviders.insert(owner, provider);
+}
+
+void ExtendedCharTable::unregisterUsedCharsProvider(const void *owner)
+{
+    QMutexLocker locker(&_writerMutex);
+    _usedCharsProviders.remove(owner);
+}
+
+qint64 ExtendedCharTable::sizeBytes()
+{
+    QMutexLocker locker(&_writerMutex);
+
+    qint64 bytes = qint64(_arenaBlocks.size() + _retiredArenaBlocks.size()) * ArenaBlockSize * sizeof(char32_t);
+    for (const Shard &shard : _shards) {
+        const Table *table = shard.table.load(std::memory_order_acquire);
+        if (table != nullptr) {
+            bytes += qint64(table->capacity) * sizeof(std::atomic<Entry *>);
+        }
+    }
+    for (const Table *table : std::as_const(_retiredTables)) {
+        bytes += qint64(table->capacity) * sizeof(std::atomic<Entry *>);
+    }
+    bytes += qint64(_liveEntries + _retiredEntries.size()) * sizeof(Entry);
+    return bytes;
+}
+
+ExtendedCharTable::Entry *ExtendedCharTable::findEntry(uint hash) const
+{
+    const Shard &shard = _shards[hash & uint(ShardCount - 1)];
+    const Table *table = shard.table.load(std::memory_order_acquire);
+    const int mask = table->capacity - 1;
+    int index = int((hash >> ShardBits) & uint(mask));
+    for (int probe = 0; probe <= mask; ++probe) {
+        Entry *entry = table->slots[index].load(std::memory_order_acquire);
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        if (entry->hash == hash) {
+            return entry;
+        }
+        index = (index + 1) & mask;
+    }
+    return nullptr;
+}
+
 char32_t ExtendedCharTable::createExtendedChar(const char32_t *unicodePoints, ushort length, const pExtendedChars extendedChars)
 {
     // look for this sequence of points in the table
@@ -33,9 +228,15 @@ char32_t ExtendedCharTable::createExtendedChar(const char32_t *unicodePoints, us
     const uint initialHash = hash;
     bool triedCleaningSolution = false;
 
+    QMutexLocker locker(&_writerMutex);
+
     // check existing entry for match
-    while (_extendedCharTable.contains(hash) && hash != 0) { // 0 has a special meaning for chars so we don't use it
-        if (extendedCharMatch(hash, unicodePoints, length)) {
+    while (hash != 0) { // 0 has a special meaning for chars so we don't use it
+        Entry *entry = findEntry(hash);
+        if (entry == nullptr) {
+            break;
+        }
+        if (extendedCharMatch(entry, unicodePoints, length)) {
             // this sequence already has an entry in the table,
             // return its hash
             return hash;
@@ -49,17 +250,7 @@ char32_t ExtendedCharTable::createExtendedChar(const char32_t *unicodePoints, us
                 triedCleaningSolution = true;
                 // All the hashes are full, go to all Screens and try to free any
                 // This is slow but should happen very rarely
-                QSet<uint> usedExtendedChars = extendedChars();
-
-                QHash<uint, char32_t *>::iterator it = _extendedCharTable.begin();
-                QHash<uint, char32_t *>::iterator itEnd = _extendedCharTable.end();
-                while (it != itEnd) {
-                    if (usedExtendedChars.contains(it.key())) {
-                        ++it;
-                    } else {
-                        it = _extendedCharTable.erase(it);
-                    }
-                }
+                removeUnusedEntries(collectUsedChars(extendedChars));
             } else {
                 qCDebug(CharactersDebug) << "Using all the extended char hashes, going to miss this extended character";
                 return 0;
@@ -69,11 +260,26 @@ char32_t ExtendedCharTable::createExtendedChar(const char32_t *unicodePoints, us
 
     // add the new sequence to the table and
     // return that index
-    auto buffer = new char32_t[length + 1];
+    char32_t *buffer = arenaAllocate(length + 1);
     buffer[0] = length;
     std::copy_n(unicodePoints, length, &buffer[1]);
 
-    _extendedCharTable.insert(hash, buffer);
+    auto *entry = new Entry;
+    entry->hash = hash;
+    entry->buffer = buffer;
+
+    Shard &shard = _shards[hash & uint(ShardCount - 1)];
+    Table *table = shard.table.load(std::memory_order_relaxed);
+    // keep the load factor below 3/4 so lock-free probes stay short
+    if ((shard.size + 1) * 4 > table->capacity * 3) {
+        growShard(shard);
+        table = shard.table.load(std::memory_order_relaxed);
+    }
+    placeEntry(table, entry);
+    shard.size++;
+    _liveEntries++;
+
+    maybeSweep(hash);
 
     return hash;
 }
@@ -83,10 +289,10 @@ char32_t *ExtendedCharTable::lookupExtendedChar(uint hash, ushort &length) const
     // look up index in table and if found, set the length
     // argument and return a pointer to the character sequence
 
-    char32_t *buffer = _extendedCharTable[hash];
-    if (buffer != nullptr) {
-        length = ushort(buffer[0]);
-        return buffer + 1;
+    Entry *entry = findEntry(hash);
+    if (entry != nullptr) {
+        length = ushort(entry->buffer[0]);
+        return entry->buffer + 1;
     }
     length = 0;
     return nullptr;
@@ -101,19 +307,17 @@ uint ExtendedCharTable::extendedCharHash(const char32_t *unicodePoints, ushort l
     return hash;
 }
 
-bool ExtendedCharTable::extendedCharMatch(uint hash, const char32_t *unicodePoints, ushort length) const
+bool ExtendedCharTable::extendedCharMatch(const Entry *entry, const char32_t *unicodePoints, ushort length) const
 {
-    char32_t *entry = _extendedCharTable[hash];
-
-    // compare given length with stored sequence length ( given as the first ushort in the
-    // stored buffer )
-    if (entry == nullptr || entry[0] != length) {
+    // compare given length with stored sequence length ( given as the first
+    // char32_t in the stored buffer )
+    if (entry->buffer[0] != length) {
         return false;
     }
     // if the lengths match, each character must be checked.  the stored buffer starts at
-    // entry[1]
+    // entry->buffer[1]
     for (int i = 0; i < length; i++) {
-        if (entry[i + 1] != unicodePoints[i]) {
+        if (entry->buffer[i + 1] != unicodePoints[i]) {
             return false;
         }
     }
@@ -9,8 +9,11 @@
 
 // Qt
 #include <QHash>
+#include <QList>
+#include <QMutex>
 #include <QSet>
 
+#include <atomic>
 #include <functional>
 
 namespace Konsole
@@ -20,6 +23,22 @@ namespace Konsole
  * by hash keys.  The hash key itself is the same size as a unicode
  * character ( char32_t ) so that it can occupy the same space in
  * a structure.
+ *
+ * The table is consulted on the paint and decode paths for every cell
+ * carrying combining characters, potentially from several threads. It is
+ * therefore sharded into small open-addressing tables with atomically
+ * published snapshots: lookups are lock-free and never block, while
+ * insertions serialize on a writer mutex and publish grown or rebuilt
+ * shard tables RCU-style. Entry buffers are immutable once published, so
+ * pointers returned by lookupExtendedChar() stay valid for the lifetime
+ * of the table.
+ *
+ * Sequences unreachable from any live screen image or history are swept
+ * periodically: screens register a provider of their in-use keys, and
+ * once the table doubles since the last sweep the unreferenced entries
+ * are dropped and the surviving sequences compacted into a fresh arena,
+ * so long-running emoji-heavy sessions do not accumulate entries without
+ * bound.
  */
 class ExtendedCharTable
 {
@@ -46,6 +65,9 @@ public:
      * Looks up and returns a pointer to a sequence of unicode characters
      * which was added to the table using createExtendedChar().
      *
+     * This is lock-free and safe to call concurrently with
+     * createExtendedChar() from any thread.
+     *
      * @param hash The hash key returned by createExtendedChar()
      * @param length This variable is set to the length of the
      * character sequence.
@@ -54,19 +76,98 @@ public:
      */
     char32_t *lookupExtendedChar(uint hash, ushort &length) const;
 
+    /**
+     * Registers a provider of extended-character keys reachable from
+     * @p owner (typically a Screen, covering its image and history).
+     * The periodic sweep treats the union of all registered providers
+     * as the live set; everything else is reclaimed.
+     */
+    void registerUsedCharsProvider(const void *owner, const pExtendedChars &provider);
+    /** Removes the provider registered for @p owner. */
+    void unregisterUsedCharsProvider(const void *owner);
+
+    /**
+     * Approximate number of bytes held by the table, including retired
+     * tables and arena blocks that are kept alive for concurrent readers.
+     * The table is shared by every session in the process.
+     */
+    qint64 sizeBytes();
+
     /** The global ExtendedCharTable instance. */
     static ExtendedCharTable instance;
 
 private:
+    // an immutable published entry; buffer[0] is the sequence length,
+    // followed by the character sequence itself
+    struct Entry {
+        uint hash;
+        char32_t *buffer;
+    };
+    // a shard's open-addressing slot array, published atomically as a whole.
+    // Entries are never removed from a published table, so probing may stop
+    // at the first empty slot.
+    struct Table {
+        int capacity; // power of two
+        std::atomic<Entry *> *slots;
+    };
+    struct Shard {
+        std::atomic<Table *> table{nullptr};
+        int size = 0; // only accessed under _writerMutex
+    };
+
+    // low bits of the hash key select the shard, the remaining bits probe
+    // within its table
+    static const int ShardBits = 4;
+    static const int ShardCount = 1 << ShardBits;
+    static const int InitialShardCapacity = 16;
+
+    // sequence storage granularity, in char32_t units
+    static const int ArenaBlockSize = 4096;
+    // no sweep below this many entries, and only once the table has
+    // doubled since the previous sweep
+    static const int MinEntriesForSweep = 256;
+
     // calculates the hash key of a sequence of unicode points of size 'length'
     uint extendedCharHash(const char32_t *unicodePoints, ushort length) const;
-    // tests whether the entry in the table specified by 'hash' matches the
-    // character sequence 'unicodePoints' of size 'length'
-    bool extendedCharMatch(uint hash, const char32_t *unicodePoints, ushort length) const;
-    // internal, maps hash keys to character sequence buffers.  The first uint
-    // in each value is the length of the buffer, followed by the uints in the buffer
-    // themselves.
-    QHash<uint, char32_t *> _extendedCharTable;
+    // tests whether the given entry matches the character sequence
+    // 'unicodePoints' of size 'length'
+    bool extendedCharMatch(const Entry *entry, const char32_t *unicodePoints, ushort length) const;
+    // lock-free probe for the entry with the exact key 'hash'
+    Entry *findEntry(uint hash) const;
+
+    static Table *allocateTable(int capacity);
+    // writer-side probe-and-store into 'table'
+    static void placeEntry(Table *table, Entry *entry);
+    // replaces a shard's table with a doubled copy; the old table is retired,
+    // not freed, so concurrent readers stay valid
+    void growShard(Shard &shard);
+    // bump-allocates a run of 'length' char32_t from the arena
+    char32_t *arenaAllocate(int length);
+    // union of all registered providers plus 'extraChars' (if set)
+    QSet<uint> collectUsedChars(const pExtendedChars &extraChars) const;
+    // rebuilds every shard without the entries absent from
+    // 'usedExtendedChars', compacting the survivors into a fresh arena
+    void removeUnusedEntries(const QSet<uint> &usedExtendedChars);
+    // runs removeUnusedEntries() when the table has outgrown the live set;
+    // 'keepHash' is the just-created key, not yet stored in any cell
+    void maybeSweep(uint keepHash);
+
+    Shard _shards[ShardCount];
+    // serializes all insertions and rebuilds
+    QMutex _writerMutex;
+    // sequence storage; entries point into these blocks
+    QList<char32_t *> _arenaBlocks;
+    int _arenaBlockUsed = 0;
+    int _arenaBlockCapacity = 0;
+    // entry count across all shards, and its value after the last sweep
+    int _liveEntries = 0;
+    int _entriesAfterLastSweep = 0;
+    QHash<const void *, pExtendedChars> _usedCharsProviders;
+    // tables, entries and arena blocks replaced while readers may still hold
+    // pointers into them; reclaimed only on destruction
+    QList<Table *> _retiredTables;
+    QList<Entry *> _retiredEntries;
+    QList<char32_t *> _retiredArenaBlocks;
 };
 
 }
@@ -151,4 +151,42 @@ bool Hangul::combinesWith(Character prevChar, uint c)
     return validSyllableContinuation(syllablePos, c);
 }
 
+bool Hangul::Composer::combinesWith(Character prevChar, uint c)
+{
+    if (_primed && prevChar.character == _cellKey) {
+        // same sequence as last time - the cached position is its walk
+        return validSyllableContinuation(_pos, c);
+    }
+
+    // cold path: derive the syllable position by walking the cell's sequence
+    _pos = NotInSyllable;
+    _primed = false;
+
+    if (prevChar.rendition.f.extended == 0) {
+        updateHangulSyllablePos(_pos, prevChar.character);
+    } else {
+        ushort extendedCharLength;
+        const char32_t *oldChars = ExtendedCharTable::instance.lookupExtendedChar(prevChar.character, extendedCharLength);
+        if (oldChars == nullptr) {
+            return false;
+        }
+        for (int i = 0; i < extendedCharLength; i++) {
+            updateHangulSyllablePos(_pos, oldChars[i]);
+        }
+    }
+
+    _cellKey = prevChar.character;
+    _primed = true;
+    return validSyllableContinuation(_pos, c);
+}
+
+void Hangul::Composer::advance(uint c, uint newCellKey)
+{
+    if (!_primed) {
+        return;
+    }
+    updateHangulSyllablePos(_pos, c);
+    _cellKey = newCellKey;
+}
+
 }
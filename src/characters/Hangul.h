@@ -38,6 +38,35 @@ public:
     static int width(uint c, int widthFromTable, enum SyllablePos &syllablePos);
     static bool combinesWith(Character prevChar, uint c);
 
+    /**
+     * Streaming composer for runs of Korean text. combinesWith() has to
+     * re-derive the syllable position by walking the target cell's whole
+     * jamo sequence for every incoming code point; the composer carries
+     * that position across consecutive calls instead, so a run of jamo
+     * streaming through the display path classifies each code point once.
+     *
+     * The cache is keyed on the target cell's character value (the
+     * extended-char hash after the first conjoined jamo), which uniquely
+     * identifies the sequence, so it self-invalidates whenever the screen
+     * is mutated in between and falls back to the full walk.
+     */
+    class Composer
+    {
+    public:
+        /** Cached equivalent of Hangul::combinesWith(). */
+        bool combinesWith(Character prevChar, uint c);
+        /**
+         * Advances the cached syllable position after @p c has been
+         * conjoined into the cell, which now stores @p newCellKey.
+         */
+        void advance(uint c, uint newCellKey);
+
+    private:
+        SyllablePos _pos = NotInSyllable;
+        uint _cellKey = 0;
+        bool _primed = false;
+    };
+
     static bool isHangul(const uint c)
     {
         return (c >= 0x1100 && c <= 0x11ff) || (c >= 0xa960 && c <= 0xa97f) || (c >= 0xd7b0 && c <= 0xd7ff) || (c >= 0xac00 && c <= 0xd7a3);
@@ -12,6 +12,7 @@
 
 // Qt
 #include <QPainterPath>
+#include <QPixmapCache>
 
 namespace Konsole
 {
@@ -839,18 +840,13 @@ static inline bool drawBrailleCharacter(QPainter &paint, int x, int y, int w, in
     return true;
 }
 
-void draw(QPainter &paint, const QRect &cellRect, const uint &chr, bool bold)
+static void drawCharacter(QPainter &paint, int x, int y, int w, int h, uint chr, bool bold)
 {
     static const ushort FirstBoxDrawingCharacterCodePoint = 0x2500;
     static const ushort FirstBrailleCodePoint = 0x2800;
     static const uint FirstLegacyCharacterCodePoint = 0x1fb00;
     uint code;
 
-    int x = cellRect.x();
-    int y = cellRect.y();
-    int w = cellRect.width();
-    int h = cellRect.height();
-
     if (chr >= FirstLegacyCharacterCodePoint) {
         drawLegacyCharacter(paint, x, y, w, h, chr - FirstLegacyCharacterCodePoint + 0x100, bold);
         return;
@@ -867,5 +863,46 @@ void draw(QPainter &paint, const QRect &cellRect, const uint &chr, bool bold)
         || drawBlockCharacter(paint, x, y, w, h, code, bold);
 }
 
+void draw(QPainter &paint, const QRect &cellRect, const uint &chr, bool bold)
+{
+    // Rendering these glyphs walks through a fair amount of QPainterPath
+    // work, and TUI dashboards are wall-to-wall box characters, so cache
+    // the rendered result per (codepoint, cell size, color, bold, DPR).
+    // The cache is shared across displays; a font change alters the cell
+    // size and so simply stops hitting the old entries, which QPixmapCache
+    // evicts under its global memory cap.
+    if (paint.combinedTransform().type() > QTransform::TxTranslate) {
+        // scaled painters (double-width/height lines) render directly so
+        // the vector output stays crisp
+        drawCharacter(paint, cellRect.x(), cellRect.y(), cellRect.width(), cellRect.height(), chr, bold);
+        return;
+    }
+
+    const QColor color = paint.pen().color();
+    const qreal dpr = paint.device()->devicePixelRatioF();
+    const bool antialias = paint.testRenderHint(QPainter::Antialiasing);
+
+    const QString key = QLatin1String("konsole-lineblock ") + QString::number(chr, 16) + QLatin1Char(' ') + QString::number(cellRect.width())
+        + QLatin1Char('x') + QString::number(cellRect.height()) + QLatin1Char(' ') + QString::number(color.rgba(), 16) + QLatin1Char(' ')
+        + QString::number(dpr) + (bold ? QLatin1Char('b') : QLatin1Char('-')) + (antialias ? QLatin1Char('a') : QLatin1Char('-'));
+
+    QPixmap glyph;
+    if (!QPixmapCache::find(key, &glyph)) {
+        glyph = QPixmap(QSize(qRound(cellRect.width() * dpr), qRound(cellRect.height() * dpr)));
+        glyph.setDevicePixelRatio(dpr);
+        glyph.fill(Qt::transparent);
+
+        QPainter glyphPainter(&glyph);
+        glyphPainter.setPen(color);
+        glyphPainter.setRenderHint(QPainter::Antialiasing, antialias);
+        drawCharacter(glyphPainter, 0, 0, cellRect.width(), cellRect.height(), chr, bold);
+        glyphPainter.end();
+
+        QPixmapCache::insert(key, glyph);
+    }
+
+    paint.drawPixmap(cellRect.topLeft(), glyph);
+}
+
 } // namespace LineBlockCharacters
 } // namespace Konsole
@@ -13,6 +13,7 @@
 
 // Qt
 #include <QApplication>
+#include <QDataStream>
 #include <QMetaEnum>
 
 // KDE
@@ -248,6 +249,8 @@ void ColorScheme::setColorTableEntry(int index, const QColor &entry)
         _table[index] = defaultTable[index];
         qCDebug(ColorSchemeDebug) << "ColorScheme" << name() << "has an invalid color index" << index << ", using default table color";
     }
+
+    _paletteGeneration++;
 }
 
 QColor ColorScheme::colorEntry(int index, uint sessionId) const
@@ -335,9 +338,22 @@ QColor ColorScheme::colorEntry(int index, uint sessionId) const
 
 void ColorScheme::getColorTable(QColor *table, uint sessionId) const
 {
-    for (int i = 0; i < TABLE_COLORS; i++) {
-        table[i] = colorEntry(i, sessionId);
+    // without randomization every entry is the base palette color
+    const bool randomized = _colorRandomization && sessionId != 0 && _randomTable != nullptr;
+    if (!randomized) {
+        std::copy_n(colorTable(), TABLE_COLORS, table);
+        return;
     }
+
+    CachedPalette &cached = _randomizedTables[sessionId];
+    if (cached.generation != _paletteGeneration) {
+        cached.generation = _paletteGeneration;
+        cached.colors.resize(TABLE_COLORS);
+        for (int i = 0; i < TABLE_COLORS; i++) {
+            cached.colors[i] = colorEntry(i, sessionId);
+        }
+    }
+    std::copy_n(cached.colors.constData(), TABLE_COLORS, table);
 }
 
 bool ColorScheme::isColorRandomizationEnabled() const
@@ -348,6 +364,7 @@ bool ColorScheme::isColorRandomizationEnabled() const
 void ColorScheme::setColorRandomization(bool randomize)
 {
     _colorRandomization = randomize;
+    _paletteGeneration++;
     if (randomize) {
         bool hasAnyRandomizationEntries = false;
         if (_randomTable != nullptr) {
@@ -384,6 +401,8 @@ void ColorScheme::setRandomizationRange(int index, double hue, double saturation
     _randomTable[index].hue = hue;
     _randomTable[index].saturation = saturation;
     _randomTable[index].lightness = lightness;
+
+    _paletteGeneration++;
 }
 
 const QColor *ColorScheme::colorTable() const
@@ -465,6 +484,8 @@ void ColorScheme::read(const KConfig &config)
         readColorEntry(config, i);
     }
 
+    _paletteGeneration++;
+
 #ifdef DEBUG_LOADING_TIME
     qDebug() << name() << "loaded in" << t.elapsed() << "ms";
 #endif
@@ -530,6 +551,68 @@ void ColorScheme::write(KConfig &config) const
     }
 }
 
+void ColorScheme::read(QDataStream &stream)
+{
+    stream >> _name >> _description >> _opacity >> _blur >> _colorRandomization;
+
+    bool hasTable = false;
+    stream >> hasTable;
+    if (hasTable) {
+        for (int i = 0; i < TABLE_COLORS; i++) {
+            QColor entry;
+            stream >> entry;
+            setColorTableEntry(i, entry);
+        }
+    }
+
+    bool hasRandomTable = false;
+    stream >> hasRandomTable;
+    if (hasRandomTable) {
+        for (int i = 0; i < TABLE_COLORS; i++) {
+            double hue = 0.0;
+            double saturation = 0.0;
+            double lightness = 0.0;
+            stream >> hue >> saturation >> lightness;
+            setRandomizationRange(i, hue, saturation, lightness);
+        }
+    }
+
+    QString wallpaperPath;
+    qint32 wallpaperStyle = ColorSchemeWallpaper::Tile;
+    QPointF wallpaperAnchor;
+    qreal wallpaperOpacity = 1.0;
+    qint32 wallpaperFlipType = ColorSchemeWallpaper::NoFlip;
+    stream >> wallpaperPath >> wallpaperStyle >> wallpaperAnchor >> wallpaperOpacity >> wallpaperFlipType;
+    setWallpaper(wallpaperPath,
+                 static_cast<ColorSchemeWallpaper::FillStyle>(wallpaperStyle),
+                 wallpaperAnchor,
+                 wallpaperOpacity,
+                 static_cast<ColorSchemeWallpaper::FlipType>(wallpaperFlipType));
+
+    _paletteGeneration++;
+}
+
+void ColorScheme::write(QDataStream &stream) const
+{
+    stream << _name << _description << _opacity << _blur << _colorRandomization;
+
+    stream << (_table != nullptr);
+    if (_table != nullptr) {
+        for (int i = 0; i < TABLE_COLORS; i++) {
+            stream << _table[i];
+        }
+    }
+
+    stream << (_randomTable != nullptr);
+    if (_randomTable != nullptr) {
+        for (int i = 0; i < TABLE_COLORS; i++) {
+            stream << _randomTable[i].hue << _randomTable[i].saturation << _randomTable[i].lightness;
+        }
+    }
+
+    stream << _wallpaper->path() << qint32(_wallpaper->style()) << _wallpaper->anchor() << _wallpaper->opacity() << qint32(_wallpaper->flipType());
+}
+
 void ColorScheme::writeColorEntry(KConfig &config, int index) const
 {
     KConfigGroup configGroup = config.group(colorNameForIndex(index));
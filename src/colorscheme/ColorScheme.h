@@ -10,8 +10,10 @@
 #define COLORSCHEME_H
 
 // Qt
+#include <QHash>
 #include <QMetaType>
 #include <QSharedData>
+#include <QVector>
 
 // C++
 #include <memory>
@@ -24,6 +26,7 @@
 class KConfig;
 class QPixmap;
 class QPainter;
+class QDataStream;
 
 namespace Konsole
 {
@@ -61,6 +64,15 @@ public:
     /** Writes the color scheme to the specified configuration source */
     void write(KConfig &config) const;
 
+    /**
+     * Reads the color scheme from a binary stream previously produced by
+     * write(QDataStream&). Used by ColorSchemeManager's on-disk index to
+     * avoid re-parsing every .colorscheme file.
+     */
+    void read(QDataStream &stream);
+    /** Writes the color scheme to a binary stream, see read(QDataStream&) */
+    void write(QDataStream &stream) const;
+
     /** Sets a single entry within the color palette. */
     void setColorTableEntry(int index, const QColor &entry);
 
@@ -70,6 +82,13 @@ public:
      *
      * @param table Array into which the color entries for this color scheme
      * are copied.
+     *
+     * When color randomization is enabled, the resolved table for each
+     * @p sessionId is memoized, so repeated requests for the same session
+     * (profile re-application, new views) copy the cached palette instead
+     * of re-running the HSLuv adjustment per entry.  Any mutation of the
+     * scheme (reload through read(), palette or randomization changes)
+     * invalidates the memoized tables by bumping a generation counter.
      */
     void getColorTable(QColor *table, uint sessionId = 0) const;
 
@@ -181,6 +200,20 @@ private:
     // scheme support randomization
     RandomizationRange *_randomTable;
 
+    // one memoized randomized palette per session seed, each valid for
+    // the generation it was computed at; see getColorTable()
+    struct CachedPalette {
+        quint64 generation = 0;
+        QVector<QColor> colors;
+    };
+    mutable QHash<uint, CachedPalette> _randomizedTables;
+
+    // bumped by every mutation that can change resolved colors, so a
+    // reloaded scheme invalidates its memoized palettes without the
+    // object being recreated; starts at 1 so a default-constructed
+    // CachedPalette is always stale
+    quint64 _paletteGeneration = 1;
+
     qreal _opacity;
 
     // enables blur behind the terminal window
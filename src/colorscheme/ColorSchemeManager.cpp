@@ -11,17 +11,116 @@
 #include "ColorSchemeManager.h"
 
 #include "colorschemedebug.h"
+#include "config-konsole.h"
 
 // Qt
+#include <QDataStream>
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QLocale>
+#include <QSaveFile>
+#include <QStandardPaths>
 
 // KDE
 #include <KConfig>
 
 using namespace Konsole;
 
+namespace
+{
+/* On-disk index of parsed color schemes so that enumerating the scheme
+ * list (the appearance page of the profile dialog, the Set Encoding-style
+ * scheme menus) does not have to KConfig-parse every .colorscheme file.
+ *
+ * Entries are keyed by path and validated against the file's modification
+ * time and size; any mismatch falls back to the normal parser and the
+ * index is rewritten. The header additionally records the application
+ * version, which covers the bundled qrc schemes (no usable mtime), and the
+ * language, since descriptions are stored already translated. Bump
+ * ColorSchemeIndexVersion when the ColorScheme binary format changes.
+ */
+const quint32 ColorSchemeIndexMagic = 0x4B434958; // 'KCIX'
+const quint32 ColorSchemeIndexVersion = 1;
+
+struct ColorSchemeIndexEntry {
+    qint64 lastModified = 0;
+    qint64 size = 0;
+    std::shared_ptr<const ColorScheme> scheme;
+};
+
+QString colorSchemeIndexPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/color-schemes.index");
+}
+
+QHash<QString, ColorSchemeIndexEntry> loadColorSchemeIndex()
+{
+    QHash<QString, ColorSchemeIndexEntry> index;
+
+    QFile file(colorSchemeIndexPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return index;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString appVersion;
+    QString language;
+    stream >> magic >> version >> appVersion >> language;
+    if (magic != ColorSchemeIndexMagic || version != ColorSchemeIndexVersion || appVersion != QLatin1String(KONSOLE_VERSION)
+        || language != QLocale().name()) {
+        return index;
+    }
+
+    qint32 count = 0;
+    stream >> count;
+    for (qint32 i = 0; i < count; i++) {
+        QString path;
+        ColorSchemeIndexEntry entry;
+        stream >> path >> entry.lastModified >> entry.size;
+
+        auto scheme = std::make_shared<ColorScheme>();
+        scheme->read(stream);
+        entry.scheme = scheme;
+
+        if (stream.status() != QDataStream::Ok) {
+            index.clear();
+            return index;
+        }
+        index.insert(path, entry);
+    }
+
+    return index;
+}
+
+void saveColorSchemeIndex(const QHash<QString, ColorSchemeIndexEntry> &index)
+{
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+
+    QSaveFile file(colorSchemeIndexPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << ColorSchemeIndexMagic << ColorSchemeIndexVersion << QString::fromLatin1(KONSOLE_VERSION) << QLocale().name();
+
+    stream << qint32(index.size());
+    for (auto it = index.cbegin(); it != index.cend(); ++it) {
+        stream << it.key() << it.value().lastModified << it.value().size;
+        it.value().scheme->write(stream);
+    }
+
+    file.commit();
+}
+}
+
 ColorSchemeManager::ColorSchemeManager()
 {
 }
@@ -38,14 +137,38 @@ QList<std::shared_ptr<const ColorScheme>> ColorSchemeManager::allColorSchemes()
     int failed = 0;
 
     QList<std::shared_ptr<const ColorScheme>> ret;
+    const QHash<QString, ColorSchemeIndexEntry> index = loadColorSchemeIndex();
+    QHash<QString, ColorSchemeIndexEntry> freshIndex;
+    bool indexDirty = false;
+
     const auto schemes = listColorSchemes();
-    for (const QString &name : schemes) {
-        std::shared_ptr<const ColorScheme> scheme = findColorScheme(colorSchemeNameFromPath(name));
+    for (const QString &path : schemes) {
+        const QFileInfo info(path);
+        const qint64 lastModified = info.lastModified().isValid() ? info.lastModified().toMSecsSinceEpoch() : 0;
+        const qint64 size = info.size();
+
+        const auto it = index.constFind(path);
+        if (it != index.constEnd() && it->lastModified == lastModified && it->size == size) {
+            // serve from the index; keep the scheme findable by name too
+            _colorSchemes[it->scheme->name()] = it->scheme;
+            ret.append(it->scheme);
+            freshIndex.insert(path, *it);
+            continue;
+        }
+
+        std::shared_ptr<const ColorScheme> scheme = loadColorScheme(path);
         if (!scheme) {
             failed++;
             continue;
         }
         ret.append(scheme);
+        freshIndex.insert(path, {lastModified, size, scheme});
+        indexDirty = true;
+    }
+
+    // rewrite the index when files were (re)parsed or removed
+    if (indexDirty || freshIndex.size() != index.size()) {
+        saveColorSchemeIndex(freshIndex);
     }
 
     if (failed > 0) {
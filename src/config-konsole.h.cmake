@@ -15,5 +15,8 @@
 /* Defined if system has the malloc_trim function, which is a GNU extension */
 #cmakedefine01 HAVE_MALLOC_TRIM
 
+/* If defined, heap allocations are counted per subsystem (AllocationTracker) */
+#cmakedefine01 KONSOLE_ALLOCATION_TRACKING
+
 /* Defined if libkapsule-qt is available for Kapsule container support */
 #cmakedefine01 HAVE_KAPSULE
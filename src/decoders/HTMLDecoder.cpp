@@ -12,6 +12,7 @@
 
 // Qt
 #include <QTextStream>
+#include <QVarLengthArray>
 
 using namespace Konsole;
 
@@ -65,6 +66,19 @@ void HTMLDecoder::decodeLine(const Character *const characters, int count, LineP
     Q_ASSERT(_output);
 
     QString text;
+    // typical lines are mostly plain characters with a handful of style
+    // changes; reserving up front avoids repeated mid-line growth
+    text.reserve(count + 64);
+
+    // plain characters are collected here and appended with a single
+    // conversion per run instead of a QString::fromUcs4 per cell
+    QVarLengthArray<char32_t, 128> plainRun;
+    const auto flushPlainRun = [&text, &plainRun]() {
+        if (!plainRun.isEmpty()) {
+            text.append(QString::fromUcs4(plainRun.constData(), plainRun.size()));
+            plainRun.clear();
+        }
+    };
 
     int spaceCount = 0;
 
@@ -72,6 +86,7 @@ void HTMLDecoder::decodeLine(const Character *const characters, int count, LineP
         // check if appearance of character is different from previous char
         if (characters[i].rendition.all != _lastRendition || characters[i].foregroundColor != _lastForeColor
             || characters[i].backgroundColor != _lastBackColor) {
+            flushPlainRun();
             if (_innerSpanOpen) {
                 closeSpan(text);
                 _innerSpanOpen = false;
@@ -118,30 +133,37 @@ void HTMLDecoder::decodeLine(const Character *const characters, int count, LineP
                 ushort extendedCharLength = 0;
                 const char32_t *chars = ExtendedCharTable::instance.lookupExtendedChar(characters[i].character, extendedCharLength);
                 if (chars != nullptr) {
+                    flushPlainRun();
                     text.append(QString::fromUcs4(chars, extendedCharLength));
                 }
             } else {
                 // escape HTML tag characters and just display others as they are
                 const char32_t ch = characters[i].character;
                 if (ch == U'<') {
+                    flushPlainRun();
                     text.append(QLatin1String("&lt;"));
                 } else if (ch == U'>') {
+                    flushPlainRun();
                     text.append(QLatin1String("&gt;"));
                 } else if (ch == U'&') {
+                    flushPlainRun();
                     text.append(QLatin1String("&amp;"));
                 } else if (ch == U'\0') {
                     // do nothing for the right half of double-width character
                 } else {
-                    text.append(QString::fromUcs4(&characters[i].character, 1));
+                    plainRun.append(ch);
                 }
             }
         } else {
             // HTML truncates multiple spaces, so use a space marker instead
             // Use &#160 instead of &nbsp so xmllint will work.
+            flushPlainRun();
             text.append(QLatin1String("&#160;"));
         }
     }
 
+    flushPlainRun();
+
     // close any remaining open inner spans
     if (_innerSpanOpen) {
         closeSpan(text);
@@ -65,14 +65,23 @@ void PlainTextDecoder::decodeLine(const Character *const characters, int count,
         return;
     }
 
-    // find out the last technically real character in the line
+    // find out the last technically real character in the line; blocks
+    // of trailing filler cells are the common case (cleared line tails),
+    // so skip over them four at a time and only inspect cells inside a
+    // block that has a real one
     int realCharacterGuard = -1;
-    for (int i = count - 1; i >= start; i--) {
+    int tail = count - 1;
+    for (; tail >= start + 3; tail -= 4) {
+        if (((characters[tail].flags | characters[tail - 1].flags | characters[tail - 2].flags | characters[tail - 3].flags) & EF_REAL) != 0) {
+            break;
+        }
+    }
+    for (; tail >= start; tail--) {
         // FIXME: the special case of '\n' here is really ugly
         // Maybe the '\n' should be added after calling this method in
         // Screen::copyLineToStream()
-        if ((characters[i].flags & EF_REAL) != 0 && characters[i].character != '\n') {
-            realCharacterGuard = i;
+        if ((characters[tail].flags & EF_REAL) != 0 && characters[tail].character != '\n') {
+            realCharacterGuard = tail;
             break;
         }
     }
@@ -83,7 +92,30 @@ void PlainTextDecoder::decodeLine(const Character *const characters, int count,
     QVector<char32_t> characterBuffer;
     characterBuffer.reserve(count);
 
+    // printable ASCII cells need no extended-char lookup and no width
+    // computation, and make up the bulk of ordinary output
+    const auto isPlainAscii = [characters, realCharacterGuard](int n) {
+        return characters[n].rendition.f.extended == 0 && characters[n].character >= 0x20 && characters[n].character < 0x7F
+            && ((characters[n].flags & EF_REAL) != 0 || n <= realCharacterGuard);
+    };
+
     for (int i = start; i < outputCount;) {
+        if (isPlainAscii(i)) {
+            // gather the whole run in one narrowing pass over the
+            // 16-byte cells rather than a branchy cell at a time
+            const int runStart = i;
+            do {
+                i++;
+            } while (i < outputCount && isPlainAscii(i));
+
+            const int oldSize = characterBuffer.size();
+            characterBuffer.resize(oldSize + (i - runStart));
+            char32_t *gathered = characterBuffer.data() + oldSize;
+            for (int n = runStart; n < i; n++) {
+                gathered[n - runStart] = characters[n].character;
+            }
+            continue;
+        }
         if (characters[i].rendition.f.extended != 0) {
             ushort extendedCharLength = 0;
             const char32_t *chars = ExtendedCharTable::instance.lookupExtendedChar(characters[i].character, extendedCharLength);
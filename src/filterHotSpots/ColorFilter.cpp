@@ -25,6 +25,26 @@ ColorFilter::ColorFilter()
     setRegExp(ColorRegExp);
 }
 
+bool ColorFilter::prefilterRegion(QStringView text) const
+{
+    // a match needs either a '#' (hex form) or at least three letters in
+    // a row (named color); purely numeric output has neither
+    int letterRun = 0;
+    for (const QChar c : text) {
+        if (c == QLatin1Char('#')) {
+            return true;
+        }
+        if (c.isLetter()) {
+            if (++letterRun >= 3) {
+                return true;
+            }
+        } else {
+            letterRun = 0;
+        }
+    }
+    return false;
+}
+
 QSharedPointer<HotSpot> ColorFilter::newHotSpot(int startLine, int startColumn, int endLine, int endColumn, const QStringList &capturedTexts)
 {
     QColor color(capturedTexts.at(1));
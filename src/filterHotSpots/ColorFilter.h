@@ -20,6 +20,9 @@ public:
 
 protected:
     QSharedPointer<HotSpot> newHotSpot(int startLine, int startColumn, int endLine, int endColumn, const QStringList &capturedTexts) override;
+
+    /** Reimplemented to reject regions with no '#' and no run of three letters. */
+    bool prefilterRegion(QStringView text) const override;
 };
 }
 
@@ -8,6 +8,7 @@
 #include "FileFilter.h"
 
 #include <QDir>
+#include <QFileInfo>
 
 #include "profile/Profile.h"
 #include "session/Session.h"
@@ -103,29 +104,17 @@ QSharedPointer<HotSpot> FileFilter::newHotSpot(int startLine, int startColumn, i
 
     const bool absolute = filename.startsWith(QLatin1Char('/'));
     if (!absolute) {
-        auto match = std::find_if(_currentDirContents.cbegin(), _currentDirContents.cend(), [filename](const QString &s) {
-            // early out if first char doesn't match
-            if (!s.isEmpty() && filename.at(0) != s.at(0)) {
-                return false;
+        // the matched entry is either the whole candidate or the part in
+        // front of a ':' (line number) or '/' (subpath), so only those
+        // cut points need an existence lookup
+        bool exists = _currentDirContents.contains(filename.toString());
+        for (qsizetype i = 0; !exists && i < filename.size(); i++) {
+            if (filename.at(i) == QLatin1Char(':') || filename.at(i) == QLatin1Char('/')) {
+                exists = _currentDirContents.contains(filename.left(i).toString());
             }
+        }
 
-            const bool startsWith = filename.startsWith(s);
-            if (startsWith) {
-                // are we equal ?
-                if (filename.size() == s.size()) {
-                    return true;
-                }
-                int onePast = s.size();
-                if (onePast < filename.size()) {
-                    if (filename.at(onePast) == QLatin1Char(':') || filename.at(onePast) == QLatin1Char('/')) {
-                        return true;
-                    }
-                }
-            }
-            return false;
-        });
-
-        if (match == _currentDirContents.cend()) {
+        if (!exists) {
             return nullptr;
         }
     }
@@ -141,15 +130,41 @@ QSharedPointer<HotSpot> FileFilter::newHotSpot(int startLine, int startColumn, i
 
 void FileFilter::process()
 {
+    updateState();
+
+    RegExpFilter::process();
+}
+
+bool FileFilter::updateState()
+{
+    if (_session.isNull()) {
+        return RegExpFilter::updateState();
+    }
+
     const QDir dir(_session->currentWorkingDirectory());
-    // Do not re-process.
-    if (_dirPath != dir.canonicalPath() + QLatin1Char('/')) {
-        _dirPath = dir.canonicalPath() + QLatin1Char('/');
+    const QString dirPath = dir.canonicalPath() + QLatin1Char('/');
+    // the directory's mtime moves whenever an entry is created, renamed
+    // or deleted, so one stat decides whether the listing is still good
+    const QDateTime dirMTime = QFileInfo(dir.absolutePath()).lastModified();
+
+    // Do not re-read an unchanged directory.
+    if (_dirPath != dirPath || _dirMTime != dirMTime) {
+        _dirPath = dirPath;
+        _dirMTime = dirMTime;
+
+        const QStringList entries = dir.entryList(QDir::Dirs | QDir::Files);
+        _currentDirContents = QSet<QString>(entries.cbegin(), entries.cend());
 
-        _currentDirContents = dir.entryList(QDir::Dirs | QDir::Files);
+        RegExpFilter::updateState();
+        return false;
     }
 
-    RegExpFilter::process();
+    return RegExpFilter::updateState();
+}
+
+QString FileFilter::cacheFingerprint() const
+{
+    return RegExpFilter::cacheFingerprint() + QLatin1Char('|') + _dirPath + QLatin1Char('|') + _dirMTime.toString(Qt::ISODateWithMs);
 }
 
 void FileFilter::updateRegex(const QString &wordCharacters)
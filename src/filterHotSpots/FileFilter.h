@@ -8,7 +8,9 @@
 #ifndef FILE_FILTER
 #define FILE_FILTER
 
+#include <QDateTime>
 #include <QPointer>
+#include <QSet>
 #include <QString>
 
 #include "RegExpFilter.h"
@@ -30,6 +32,23 @@ public:
 
     void process() override;
 
+    /**
+     * Reimplemented to refresh the working directory listing; cached
+     * hotspots are invalidated when the directory changed, since match
+     * validity depends on its contents.  The listing is re-read only
+     * when the directory's path or modification time moved, so an
+     * unchanged directory costs one stat per update instead of a
+     * stat per candidate path.
+     */
+    bool updateState() override;
+
+    /**
+     * Reimplemented to include the working directory and its modification
+     * time: whether a match becomes a hotspot depends on which files
+     * exist there, not on the text alone.
+     */
+    QString cacheFingerprint() const override;
+
     void updateRegex(const QString &wordCharacters);
 
 protected:
@@ -40,7 +59,10 @@ private:
 
     QPointer<Session> _session;
     QString _dirPath;
-    QList<QString> _currentDirContents;
+    QDateTime _dirMTime;
+    // existence cache for relative candidates: one readdir per directory
+    // change replaces a stat per match
+    QSet<QString> _currentDirContents;
     static QRegularExpression _regex;
 };
 
@@ -11,7 +11,9 @@
 #include <QApplication>
 #include <QBuffer>
 #include <QClipboard>
+#include <QDateTime>
 #include <QDrag>
+#include <QFileInfo>
 #include <QKeyEvent>
 #include <QMenu>
 #include <QMimeData>
@@ -204,6 +206,9 @@ QList<QAction *> FileFilterHotSpot::setupMenu(QMenu *menu)
 // Static variables for the HotSpot
 bool FileFilterHotSpot::_canGenerateThumbnail = false;
 QPointer<KIO::PreviewJob> FileFilterHotSpot::_previewJob;
+// Cost is kilobytes of pixel data; enough for a few dozen thumbnails to
+// stay warm without the cache growing with the number of hotspots
+QCache<QString, QPixmap> FileFilterHotSpot::_thumbnailCache(8 * 1024);
 
 void FileFilterHotSpot::requestThumbnail(Qt::KeyboardModifiers modifiers, const QPoint &pos)
 {
@@ -225,7 +230,9 @@ void FileFilterHotSpot::stopThumbnailGeneration()
 {
     _canGenerateThumbnail = false;
     if (_previewJob != nullptr) {
-        _previewJob->deleteLater();
+        // kill() rather than deleteLater() so the I/O worker stops
+        // reading the file instead of finishing into the void
+        _previewJob->kill();
         QToolTip::hideText();
     }
 }
@@ -237,6 +244,15 @@ void FileFilterHotSpot::showThumbnail(const KFileItem &item, const QPixmap &prev
     }
     _thumbnailFinished = true;
     Q_UNUSED(item)
+
+    auto *cached = new QPixmap(preview);
+    _thumbnailCache.insert(thumbnailCacheKey(), cached, qMax(1, cached->width() * cached->height() * cached->depth() / 8 / 1024));
+
+    showThumbnailTooltip(preview);
+}
+
+void FileFilterHotSpot::showThumbnailTooltip(const QPixmap &preview)
+{
     QByteArray data;
     QBuffer buffer(&data);
     preview.save(&buffer, "PNG", 100);
@@ -246,6 +262,13 @@ void FileFilterHotSpot::showThumbnail(const KFileItem &item, const QPixmap &prev
     QToolTip::showText(_thumbnailPos, tooltipString, qApp->focusWidget());
 }
 
+QString FileFilterHotSpot::thumbnailCacheKey() const
+{
+    const QFileInfo info(_filePath);
+    return _filePath + QLatin1Char('|') + QString::number(info.lastModified().toSecsSinceEpoch()) + QLatin1Char('|')
+        + QString::number(KonsoleSettings::thumbnailSize());
+}
+
 void FileFilterHotSpot::thumbnailRequested()
 {
     if (!_canGenerateThumbnail) {
@@ -264,9 +287,17 @@ void FileFilterHotSpot::thumbnailRequested()
 
     _thumbnailPos = QPoint(_eventPos.x() + 100, _eventPos.y() - settings->thumbnailSize() / 2);
 
+    // A preview generated earlier for this (path, mtime, size) renders
+    // straight from the cache without touching the filesystem again.
+    if (const QPixmap *cachedPreview = _thumbnailCache.object(thumbnailCacheKey())) {
+        _thumbnailFinished = true;
+        showThumbnailTooltip(*cachedPreview);
+        return;
+    }
+
     const int size = KonsoleSettings::thumbnailSize();
     if (_previewJob != nullptr) {
-        _previewJob->deleteLater();
+        _previewJob->kill();
     }
 
     _thumbnailFinished = false;
@@ -10,6 +10,7 @@
 
 #include "RegExpFilterHotspot.h"
 
+#include <QCache>
 #include <QList>
 #include <QPoint>
 #include <QString>
@@ -66,6 +67,15 @@ private:
     void openWithEditorFromProfile(const QString &fullCmd, const QString &path) const;
 
     void showThumbnail(const KFileItem &item, const QPixmap &preview);
+
+    // Renders @p preview as the hover tooltip at _thumbnailPos.
+    void showThumbnailTooltip(const QPixmap &preview);
+
+    // Key into _thumbnailCache: path, mtime and requested thumbnail size,
+    // so edited files and size changes regenerate instead of hitting stale
+    // entries.
+    QString thumbnailCacheKey() const;
+
     QString _filePath = QString();
     Session *_session = nullptr;
 
@@ -85,6 +95,12 @@ private:
     static qintptr currentThumbnailHotspot;
     static bool _canGenerateThumbnail;
     static QPointer<KIO::PreviewJob> _previewJob;
+
+    /* LRU cache of generated previews, shared by all hotspots, so
+     * re-hovering a path (or hovering it from another hotspot) never runs
+     * a preview job or touches the filesystem twice for the same file.
+     */
+    static QCache<QString, QPixmap> _thumbnailCache;
 };
 
 }
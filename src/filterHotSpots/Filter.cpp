@@ -9,6 +9,9 @@
 
 #include "HotSpot.h"
 
+#include <algorithm>
+#include <limits>
+
 using namespace Konsole;
 
 Filter::Filter()
@@ -24,8 +27,39 @@ Filter::~Filter()
 
 void Filter::reset()
 {
-    _hotspots.clear();
+    _stagedHotspots.clear();
+}
+
+void Filter::commitHotSpots()
+{
     _hotspotList.clear();
+    _hotspotIndex.clear();
+
+    for (const auto &spot : std::as_const(_stagedHotspots)) {
+        _hotspotList << spot;
+        for (int line = spot->startLine(); line <= spot->endLine(); line++) {
+            const int startColumn = line == spot->startLine() ? spot->startColumn() : 0;
+            const int endColumn = line == spot->endLine() ? spot->endColumn() : std::numeric_limits<int>::max();
+            _hotspotIndex.push_back({line, startColumn, endColumn, endColumn, spot});
+        }
+    }
+    _stagedHotspots.clear();
+
+    std::sort(_hotspotIndex.begin(), _hotspotIndex.end(), [](const HotSpotInterval &a, const HotSpotInterval &b) {
+        return a.line != b.line ? a.line < b.line : a.startColumn < b.startColumn;
+    });
+
+    // running maximum of endColumn within each line, for hotSpotAt()
+    for (size_t i = 1; i < _hotspotIndex.size(); i++) {
+        if (_hotspotIndex[i].line == _hotspotIndex[i - 1].line) {
+            _hotspotIndex[i].maxEndColumn = qMax(_hotspotIndex[i].maxEndColumn, _hotspotIndex[i - 1].maxEndColumn);
+        }
+    }
+}
+
+QList<QSharedPointer<HotSpot>> Filter::stagedHotSpots() const
+{
+    return _stagedHotspots;
 }
 
 void Filter::setBuffer(const QString *buffer, const QList<int> *linePositions)
@@ -54,13 +88,23 @@ const QString *Filter::buffer()
     return _buffer;
 }
 
-void Filter::addHotSpot(QSharedPointer<HotSpot> spot)
+void Filter::processRegion(int start, int end, int firstLine)
 {
-    _hotspotList << spot;
+    // only filters that claim processIncrementally() are asked to scan
+    // a sub-range; everything else runs process() over the whole buffer
+    Q_UNUSED(start)
+    Q_UNUSED(end)
+    Q_UNUSED(firstLine)
+}
 
-    for (int line = spot->startLine(); line <= spot->endLine(); line++) {
-        _hotspots.insert(line, spot);
-    }
+void Filter::adoptHotSpot(QSharedPointer<HotSpot> spot)
+{
+    addHotSpot(spot);
+}
+
+void Filter::addHotSpot(QSharedPointer<HotSpot> spot)
+{
+    _stagedHotspots << spot;
 }
 
 QList<QSharedPointer<HotSpot>> Filter::hotSpots() const
@@ -68,19 +112,39 @@ QList<QSharedPointer<HotSpot>> Filter::hotSpots() const
     return _hotspotList;
 }
 
-QSharedPointer<HotSpot> Filter::hotSpotAt(int line, int column) const
+void Filter::spansForLine(int line, HotSpot::Type type, QList<QPair<int, int>> *spans) const
 {
-    const auto hotspots = _hotspots.values(line);
+    auto it = std::lower_bound(_hotspotIndex.cbegin(), _hotspotIndex.cend(), line, [](const HotSpotInterval &interval, int queryLine) {
+        return interval.line < queryLine;
+    });
 
-    for (auto &spot : hotspots) {
-        if (spot->startLine() == line && spot->startColumn() > column) {
-            continue;
-        }
-        if (spot->endLine() == line && spot->endColumn() < column) {
-            continue;
+    for (; it != _hotspotIndex.cend() && it->line == line; ++it) {
+        if (it->spot->type() == type) {
+            spans->append({it->startColumn, it->endColumn});
         }
+    }
+}
 
-        return spot;
+QSharedPointer<HotSpot> Filter::hotSpotAt(int line, int column) const
+{
+    // first interval past the query position ...
+    auto it = std::upper_bound(_hotspotIndex.cbegin(),
+                               _hotspotIndex.cend(),
+                               std::make_pair(line, column),
+                               [](const std::pair<int, int> &key, const HotSpotInterval &interval) {
+                                   return key.first != interval.line ? key.first < interval.line : key.second < interval.startColumn;
+                               });
+
+    // ... then walk back over the intervals starting at or before it; the
+    // prefix maximum bounds how far a covering interval can be
+    while (it != _hotspotIndex.cbegin()) {
+        --it;
+        if (it->line != line || it->maxEndColumn < column) {
+            break;
+        }
+        if (it->endColumn >= column) {
+            return it->spot;
+        }
     }
 
     return nullptr;
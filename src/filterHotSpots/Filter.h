@@ -10,16 +10,17 @@
 
 // Qt
 #include <QList>
-#include <QMultiHash>
 #include <QPoint>
 
 // KDE
 #include <KFileItem>
 
 #include <memory>
+#include <vector>
 
 // Konsole
 #include "../characters/Character.h"
+#include "HotSpot.h"
 #include "konsoleprivate_export.h"
 
 class QAction;
@@ -29,7 +30,6 @@ class QMouseEvent;
 namespace Konsole
 {
 class Session;
-class HotSpot;
 
 /**
  * A filter processes blocks of text looking for certain patterns (such as URLs or keywords from a list)
@@ -60,17 +60,81 @@ public:
     virtual void process() = 0;
 
     /**
-     * Empties the filters internal buffer and resets the line count back to 0.
-     * All hotspots are deleted.
+     * Returns true when the filter's matches derive from the text alone,
+     * so the chain may cache its hotspots per run of wrapped lines and
+     * re-run it through processRegion() on changed runs only.
+     */
+    virtual bool processIncrementally() const
+    {
+        return false;
+    }
+
+    /**
+     * Called once per frame before incremental processing.  Returns
+     * false when state outside the text changed and hotspots cached from
+     * earlier frames must be discarded.
+     */
+    virtual bool updateState()
+    {
+        return true;
+    }
+
+    /**
+     * Returns a string identifying everything this filter's results
+     * depend on besides the text itself, so that equivalently configured
+     * filters in different chains (several views of one session) can
+     * share negative results: a chunk of text known to produce no
+     * hotspots under one fingerprint produces none under an equal one.
+     * Returns an empty string when the filter cannot be fingerprinted
+     * (the default), which disables sharing for the whole chain.
+     */
+    virtual QString cacheFingerprint() const
+    {
+        return QString();
+    }
+
+    /**
+     * Like process(), but only examines the buffer range
+     * [@p start, @p end), whose first line is @p firstLine.  Only called
+     * on filters that processIncrementally().
+     */
+    virtual void processRegion(int start, int end, int firstLine);
+
+    /** Re-adds a hotspot cached from an earlier frame. */
+    void adoptHotSpot(QSharedPointer<HotSpot> spot);
+
+    /**
+     * Discards hotspots staged by the current scan and resets the filter
+     * for a new one.  Hotspots already committed stay visible until the
+     * next commitHotSpots(), so readers never see a half-built set.
      */
     void reset();
 
+    /**
+     * Publishes the hotspots staged since the last reset(), replacing
+     * the committed set that hotSpots()/hotSpotAt() serve.  Must be
+     * called on the thread that reads the committed set.
+     */
+    void commitHotSpots();
+
+    /** Returns the hotspots staged by the current scan, in scan order. */
+    QList<QSharedPointer<HotSpot>> stagedHotSpots() const;
+
     /** Returns the hotspot which covers the given @p line and @p column, or 0 if no hotspot covers that area */
     QSharedPointer<HotSpot> hotSpotAt(int line, int column) const;
 
     /** Returns the list of hotspots identified by the filter */
     QList<QSharedPointer<HotSpot>> hotSpots() const;
 
+    /**
+     * Appends the (startColumn, endColumn) column spans of committed
+     * hotspots of @p type covering @p line to @p spans, in column order,
+     * using a binary search over the interval index.  endColumn is
+     * exclusive; middle lines of multi-line hotspots report INT_MAX as
+     * their end and must be clamped by the caller.
+     */
+    void spansForLine(int line, HotSpot::Type type, QList<QPair<int, int>> *spans) const;
+
     /** Returns the list of hotspots identified by the filter which occur on a given line */
 
     /**
@@ -89,8 +153,25 @@ protected:
 private:
     Q_DISABLE_COPY(Filter)
 
-    QMultiHash<int, QSharedPointer<HotSpot>> _hotspots;
+    // one line's slice of a committed hotspot; multi-line hotspots
+    // contribute one interval per covered line
+    struct HotSpotInterval {
+        int line;
+        int startColumn;
+        int endColumn;
+        // largest endColumn among this line's preceding intervals and
+        // this one, so a backwards walk in hotSpotAt() can stop early
+        int maxEndColumn;
+        QSharedPointer<HotSpot> spot;
+    };
+
+    // committed set, read by hotSpots(); _hotspotIndex is the same set
+    // flattened into intervals sorted by (line, startColumn) so that
+    // hotSpotAt() can binary-search instead of walking a hash bucket
     QList<QSharedPointer<HotSpot>> _hotspotList;
+    std::vector<HotSpotInterval> _hotspotIndex;
+    // set being built by the current scan, possibly off-thread
+    QList<QSharedPointer<HotSpot>> _stagedHotspots;
 
     const QList<int> *_linePositions;
     const QString *_buffer;
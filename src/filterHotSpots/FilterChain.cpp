@@ -8,6 +8,7 @@
 #include "FilterChain.h"
 #include "Filter.h"
 
+#include "AllocationTracker.h"
 #include "terminalDisplay/TerminalColor.h"
 #include "terminalDisplay/TerminalDisplay.h"
 #include "terminalDisplay/TerminalFonts.h"
@@ -36,11 +37,13 @@ FilterChain::~FilterChain()
 void FilterChain::addFilter(Filter *filter)
 {
     _filters.append(filter);
+    ++_hotSpotGeneration;
 }
 
 void FilterChain::removeFilter(Filter *filter)
 {
     _filters.removeAll(filter);
+    ++_hotSpotGeneration;
 }
 
 void FilterChain::reset()
@@ -59,14 +62,19 @@ void FilterChain::setBuffer(const QString *buffer, const QList<int> *linePositio
 
 void FilterChain::process()
 {
+    AllocationTracker::Scope allocationScope(AllocationTracker::FilterSubsystem);
+
     for (auto *filter : std::as_const(_filters)) {
         filter->process();
+        filter->commitHotSpots();
     }
+    ++_hotSpotGeneration;
 }
 
 void FilterChain::clear()
 {
     _filters.clear();
+    ++_hotSpotGeneration;
 }
 
 QSharedPointer<HotSpot> FilterChain::hotSpotAt(int line, int column) const
@@ -121,6 +129,15 @@ QRegion FilterChain::hotSpotRegion() const
     return region;
 }
 
+QList<QPair<int, int>> FilterChain::markerSpansForLine(int line) const
+{
+    QList<QPair<int, int>> spans;
+    for (const auto *filter : _filters) {
+        filter->spansForLine(line, HotSpot::Marker, &spans);
+    }
+    return spans;
+}
+
 int FilterChain::count(HotSpot::Type type) const
 {
     const auto hSpots = hotSpots();
@@ -229,7 +246,43 @@ void FilterChain::paint(TerminalDisplay *td, QPainter &painter)
     auto [cursorLine, cursorColumn] = td->getCharacterPosition(cursorPos, false);
 
     Character cursorCharacter = td->getCursorCharacter(std::min(cursorColumn, td->columns() - 1), cursorLine);
-    painter.setPen(QPen(cursorCharacter.foregroundColor.color(td->terminalColor()->colorTable())));
+    const QColor penColor = cursorCharacter.foregroundColor.color(td->terminalColor()->colorTable());
+
+    // re-render the overlay only when something it depends on changed;
+    // the hover underline is cell-aligned, so the hovered cell (rather
+    // than the exact pixel position) is enough of a mouse key
+    const QPoint mouseCell(cursorColumn, cursorLine);
+    const qreal dpr = td->devicePixelRatioF();
+    const bool stale = _hintOverlayGeneration != _hotSpotGeneration || _hintOverlaySize != td->size() || _hintOverlayDpr != dpr
+        || _hintOverlayShowUrlHint != _showUrlHint || _hintOverlayMouseCell != mouseCell || _hintOverlayPenColor != penColor.rgba();
+
+    if (stale) {
+        if (_hintOverlay.size() != td->size() * dpr) {
+            _hintOverlay = QPixmap(td->size() * dpr);
+            _hintOverlay.setDevicePixelRatio(dpr);
+        }
+        _hintOverlay.fill(Qt::transparent);
+
+        QPainter overlayPainter(&_hintOverlay);
+        overlayPainter.setPen(QPen(penColor));
+        _hintOverlayEmpty = !renderHintOverlay(td, overlayPainter);
+
+        _hintOverlayGeneration = _hotSpotGeneration;
+        _hintOverlaySize = td->size();
+        _hintOverlayDpr = dpr;
+        _hintOverlayShowUrlHint = _showUrlHint;
+        _hintOverlayMouseCell = mouseCell;
+        _hintOverlayPenColor = penColor.rgba();
+    }
+
+    if (!_hintOverlayEmpty) {
+        painter.drawPixmap(0, 0, _hintOverlay);
+    }
+}
+
+bool FilterChain::renderHintOverlay(TerminalDisplay *td, QPainter &painter)
+{
+    bool drewAnything = false;
 
     // iterate over hotspots identified by the display's currently active filters
     // and draw appropriate visuals to indicate the presence of the hotspot
@@ -252,6 +305,13 @@ void FilterChain::paint(TerminalDisplay *td, QPainter &painter)
     }
 
     for (const auto &spot : spots) {
+        // Marker hotspots (highlight-all search matches) are rendered per
+        // repainted line by TerminalPainter::drawContents() from the
+        // interval index, so walking them here per repaint is not needed
+        if (spot->type() == HotSpot::Marker) {
+            continue;
+        }
+
         QRegion region;
         if (spot->type() == HotSpot::Link || spot->type() == HotSpot::EMailAddress || spot->type() == HotSpot::EscapedUrl || spot->type() == HotSpot::File) {
             QPair<QRegion, QRect> spotRegion =
@@ -270,6 +330,7 @@ void FilterChain::paint(TerminalDisplay *td, QPainter &painter)
                     painter.setPen(Qt::white);
                     painter.drawRect(hintRect.adjusted(0, 0, -1, -1));
                     painter.drawText(hintRect, Qt::AlignCenter, QString::number(urlNumber));
+                    drewAnything = true;
                 }
                 urlNumber += urlNumInc;
             }
@@ -338,22 +399,18 @@ void FilterChain::paint(TerminalDisplay *td, QPainter &painter)
                 // find the position of the underline below that
                 const qreal underlinePos = baseline + metrics.underlinePos();
                 painter.drawLine(QLineF(r.left(), underlinePos, r.right(), underlinePos));
-
-                // Marker hotspots simply have a transparent rectangular shape
-                // drawn on top of them
-            } else if (spot->type() == HotSpot::Marker) {
-                // TODO - Do not use a hardcoded color for this
-                const bool isCurrentResultLine = (td->screenWindow()->currentResultLine() == (spot->startLine() + td->screenWindow()->currentLine()));
-                QColor color = isCurrentResultLine ? QColor(255, 255, 0, 120) : QColor(255, 0, 0, 120);
-                painter.fillRect(r, color);
+                drewAnything = true;
             }
         }
     }
+
+    return drewAnything;
 }
 
 void FilterChain::setReverseUrlHints(bool value)
 {
     _reverseUrlHints = value;
+    ++_hotSpotGeneration;
 }
 
 void FilterChain::setUrlHintsModifiers(Qt::KeyboardModifiers value)
@@ -8,7 +8,9 @@
 #ifndef FILTER_CHAIN
 #define FILTER_CHAIN
 
+#include <QColor>
 #include <QList>
+#include <QPixmap>
 #include <QRegion>
 #include <QSharedPointer>
 #include <QString>
@@ -49,18 +51,18 @@ public:
     virtual ~FilterChain();
 
     /** Adds a new filter to the chain.  The chain will delete this filter when it is destroyed */
-    void addFilter(Filter *filter);
+    virtual void addFilter(Filter *filter);
     /** Removes a filter from the chain.  The chain will no longer delete the filter when destroyed */
-    void removeFilter(Filter *filter);
+    virtual void removeFilter(Filter *filter);
     /** Removes all filters from the chain */
-    void clear();
+    virtual void clear();
 
     /** Resets each filter in the chain */
     void reset();
     /**
      * Processes each filter in the chain
      */
-    void process();
+    virtual void process();
 
     /** Sets the buffer for each filter in the chain to process. */
     void setBuffer(const QString *buffer, const QList<int> *linePositions);
@@ -73,6 +75,14 @@ public:
     /* Returns the region of the hotspot inside of the TerminalDisplay */
     QRegion hotSpotRegion() const;
 
+    /**
+     * The (startColumn, endColumn) spans of committed Marker hotspots
+     * covering @p line.  TerminalPainter renders the highlight-all search
+     * matches from these per repainted line, so paint() does not have to
+     * walk every hotspot on every repaint.  endColumn is exclusive.
+     */
+    QList<QPair<int, int>> markerSpansForLine(int line) const;
+
     /* Returns the amount of hotspots of the given type */
     int count(HotSpot::Type type) const;
     QList<QSharedPointer<HotSpot>> filterBy(HotSpot::Type type) const;
@@ -83,6 +93,14 @@ public:
     void keyReleaseEvent(TerminalDisplay *td, QKeyEvent *ev, int charLine, int charColumn);
     void leaveEvent(TerminalDisplay *td, QEvent *ev);
 
+    /**
+     * Composites the hotspot underlines and URL hint badges over the
+     * frame.  The overlay is kept as a cached translucent pixmap and
+     * only re-rendered when the hotspot set, the hint key state, the
+     * hovered cell or the display geometry changes, so holding the URL
+     * hints modifier during heavy output costs one blit per frame
+     * rather than a full re-render.
+     */
     void paint(TerminalDisplay *td, QPainter &painter);
 
     void setReverseUrlHints(bool value);
@@ -104,6 +122,26 @@ protected:
     bool _showUrlHint;
     bool _reverseUrlHints;
     Qt::KeyboardModifiers _urlHintsModifiers;
+
+private:
+    // renders the underlines and hint badges into @p painter; returns
+    // false when there was nothing to draw, so paint() can skip the
+    // per-frame composite entirely
+    bool renderHintOverlay(TerminalDisplay *td, QPainter &painter);
+
+    // Cached hint/underline overlay plus the state it was rendered
+    // from; paint() re-renders it only when one of these changes.
+    // _hotSpotGeneration is bumped whenever the hotspot set can have
+    // changed (process(), filter list edits, hint ordering).
+    QPixmap _hintOverlay;
+    bool _hintOverlayEmpty = true;
+    quint64 _hotSpotGeneration = 0;
+    quint64 _hintOverlayGeneration = 0;
+    QSize _hintOverlaySize;
+    qreal _hintOverlayDpr = 0;
+    bool _hintOverlayShowUrlHint = false;
+    QPoint _hintOverlayMouseCell = QPoint(-1, -1);
+    QRgb _hintOverlayPenColor = 0;
 };
 
 }
@@ -57,6 +57,12 @@ int HotSpot::endColumn() const
     return _endColumn;
 }
 
+void HotSpot::shiftLines(int delta)
+{
+    _startLine += delta;
+    _endLine += delta;
+}
+
 HotSpot::Type HotSpot::type() const
 {
     return _type;
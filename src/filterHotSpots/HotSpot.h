@@ -76,6 +76,11 @@ public:
     int startColumn() const;
     /** Returns the column on endLine() where the hotspot area ends */
     int endColumn() const;
+    /**
+     * Moves the hotspot @p delta lines down (up for negative values).
+     * Used when a cached hotspot is re-attached to text that scrolled.
+     */
+    void shiftLines(int delta);
     /**
      * Returns the type of the hotspot.  This is usually used as a hint for views on how to represent
      * the hotspot graphically.  eg.  Link hotspots are typically underlined when the user mouses over them
@@ -8,9 +8,126 @@
 #include "RegExpFilter.h"
 
 #include "RegExpFilterHotspot.h"
+#include "konsoledebug.h"
+
+#include <QElapsedTimer>
 
 using namespace Konsole;
 
+// A single region scan that takes longer than this is aborted with a
+// diagnostic naming the pattern; see processRegion().
+static const qint64 ScanBudgetMsecs = 50;
+
+/**
+ * Derives the longest literal substring that every match of @p pattern
+ * must contain, or an empty string when none can be proven.  The walk
+ * is deliberately conservative: groups and character classes are
+ * treated as opaque atoms, escapes of word characters (class
+ * shorthands, anchors, backreferences) end the current run, and any
+ * top-level alternation gives up entirely, so the result is only ever
+ * used to reject text - never to accept it.
+ */
+static QString requiredLiteralForPattern(const QString &pattern)
+{
+    QString best;
+    QString current;
+
+    const auto commit = [&best, &current]() {
+        if (current.size() > best.size()) {
+            best = current;
+        }
+        current.clear();
+    };
+
+    // advances past a [...] character class, assuming pattern[i] == '[';
+    // returns the index of the closing ']' (or the end of the pattern)
+    const auto skipClass = [&pattern](qsizetype i) {
+        ++i;
+        if (i < pattern.size() && pattern.at(i) == QLatin1Char('^')) {
+            ++i;
+        }
+        if (i < pattern.size() && pattern.at(i) == QLatin1Char(']')) {
+            ++i; // a ']' right after the opening bracket is a literal
+        }
+        while (i < pattern.size() && pattern.at(i) != QLatin1Char(']')) {
+            if (pattern.at(i) == QLatin1Char('\\')) {
+                ++i;
+            }
+            ++i;
+        }
+        return i;
+    };
+
+    qsizetype i = 0;
+    while (i < pattern.size()) {
+        const QChar c = pattern.at(i);
+
+        if (c == QLatin1Char('|')) {
+            // top-level alternation: nothing is unconditionally required
+            return QString();
+        } else if (c == QLatin1Char('(')) {
+            // opaque group; its contents may be optional or alternated
+            commit();
+            int depth = 1;
+            while (++i < pattern.size() && depth > 0) {
+                const QChar g = pattern.at(i);
+                if (g == QLatin1Char('\\')) {
+                    ++i;
+                } else if (g == QLatin1Char('[')) {
+                    i = skipClass(i);
+                } else if (g == QLatin1Char('(')) {
+                    ++depth;
+                } else if (g == QLatin1Char(')')) {
+                    --depth;
+                }
+            }
+            continue;
+        } else if (c == QLatin1Char('[')) {
+            commit();
+            i = skipClass(i);
+        } else if (c == QLatin1Char('?') || c == QLatin1Char('*')) {
+            // the previous atom is optional
+            if (!current.isEmpty()) {
+                current.chop(1);
+            }
+            commit();
+        } else if (c == QLatin1Char('+')) {
+            // at least one copy is required, but the run cannot extend
+            // across the repetition
+            commit();
+        } else if (c == QLatin1Char('{')) {
+            const qsizetype close = pattern.indexOf(QLatin1Char('}'), i + 1);
+            if (close < 0) {
+                current += c; // no quantifier; a lone brace matches itself
+            } else {
+                const QString bounds = pattern.mid(i + 1, close - i - 1);
+                if (bounds.isEmpty() || !bounds.at(0).isDigit() || bounds.at(0) == QLatin1Char('0')) {
+                    if (!current.isEmpty()) {
+                        current.chop(1);
+                    }
+                }
+                commit();
+                i = close;
+            }
+        } else if (c == QLatin1Char('\\')) {
+            ++i;
+            if (i < pattern.size() && !pattern.at(i).isLetterOrNumber()) {
+                current += pattern.at(i); // escaped metacharacter, e.g. \.
+            } else {
+                commit(); // class shorthand, anchor or backreference
+            }
+        } else if (c == QLatin1Char('^') || c == QLatin1Char('$') || c == QLatin1Char('.')) {
+            commit();
+        } else {
+            current += c;
+        }
+        ++i;
+    }
+
+    commit();
+    return best;
+}
+
 RegExpFilter::RegExpFilter()
     : _searchText(QRegularExpression())
 {
@@ -20,6 +137,22 @@ void RegExpFilter::setRegExp(const QRegularExpression &regExp)
 {
     _searchText = regExp;
     _searchText.optimize();
+    _patternChanged = true;
+    _budgetWarned = false;
+
+    // a one-character literal gates too little to be worth the scan
+    _requiredLiteral = requiredLiteralForPattern(regExp.pattern());
+    if (_requiredLiteral.size() < 2) {
+        _requiredLiteral.clear();
+    }
+    _literalCase = (regExp.patternOptions() & QRegularExpression::CaseInsensitiveOption) != 0 ? Qt::CaseInsensitive : Qt::CaseSensitive;
+}
+
+bool RegExpFilter::updateState()
+{
+    const bool unchanged = !_patternChanged;
+    _patternChanged = false;
+    return unchanged;
 }
 
 QRegularExpression RegExpFilter::regExp() const
@@ -27,26 +160,68 @@ QRegularExpression RegExpFilter::regExp() const
     return _searchText;
 }
 
+QString RegExpFilter::cacheFingerprint() const
+{
+    return QString::number(int(_searchText.patternOptions()), 16) + QLatin1Char(':') + _searchText.pattern();
+}
+
+bool RegExpFilter::prefilterRegion(QStringView text) const
+{
+    if (_requiredLiteral.isEmpty()) {
+        return true;
+    }
+    return text.contains(_requiredLiteral, _literalCase);
+}
+
 void RegExpFilter::process()
 {
     const QString *text = buffer();
 
     Q_ASSERT(text);
 
+    processRegion(0, text->length(), 0);
+}
+
+void RegExpFilter::processRegion(int start, int end, int firstLine)
+{
+    const QString *text = buffer();
+
+    Q_ASSERT(text);
+
     if (!_searchText.isValid() || _searchText.pattern().isEmpty()) {
         return;
     }
 
-    QRegularExpressionMatchIterator iterator(_searchText.globalMatch(*text));
-    int prevline = 0;
+    // cheap candidate scan first; most regions of ordinary output contain
+    // nothing that could start a match
+    if (!prefilterRegion(QStringView(*text).mid(start, end - start))) {
+        return;
+    }
+
+    QElapsedTimer budget;
+    budget.start();
+
+    QRegularExpressionMatchIterator iterator(_searchText.globalMatch(*text, start));
+    int prevline = firstLine;
     while (iterator.hasNext()) {
+        if (budget.elapsed() > ScanBudgetMsecs) {
+            if (!_budgetWarned) {
+                _budgetWarned = true;
+                qCWarning(KonsoleDebug) << "RegExpFilter pattern" << _searchText.pattern() << "exceeded its" << ScanBudgetMsecs
+                                        << "ms scan budget; skipping the rest of the region";
+            }
+            break;
+        }
         QRegularExpressionMatch match(iterator.next());
-        std::pair<int, int> start = getLineColumn(prevline, match.capturedStart());
-        prevline = start.first;
-        std::pair<int, int> end = getLineColumn(prevline, match.capturedEnd());
-        prevline = end.first;
+        if (match.capturedStart() >= end) {
+            break;
+        }
+        std::pair<int, int> matchStart = getLineColumn(prevline, match.capturedStart());
+        prevline = matchStart.first;
+        std::pair<int, int> matchEnd = getLineColumn(prevline, match.capturedEnd());
+        prevline = matchEnd.first;
 
-        QSharedPointer<HotSpot> spot(newHotSpot(start.first, start.second, end.first, end.second, match.capturedTexts()));
+        QSharedPointer<HotSpot> spot(newHotSpot(matchStart.first, matchStart.second, matchEnd.first, matchEnd.second, match.capturedTexts()));
 
         if (spot == nullptr) {
             continue;
@@ -13,6 +13,7 @@
 #include "konsoleprivate_export.h"
 #include <QRegularExpression>
 #include <QSharedPointer>
+#include <QStringView>
 
 namespace Konsole
 {
@@ -48,6 +49,21 @@ public:
      */
     void process() override;
 
+    /** Matches depend on the text alone, so results can be cached per line run. */
+    bool processIncrementally() const override
+    {
+        return true;
+    }
+
+    /** Reimplemented to invalidate cached results after setRegExp(). */
+    bool updateState() override;
+
+    /** Reimplemented to identify the filter by its pattern and options. */
+    QString cacheFingerprint() const override;
+
+    /** Reimplemented to search only the given buffer range. */
+    void processRegion(int start, int end, int firstLine) override;
+
 protected:
     /**
      * Called when a match for the regular expression is encountered.  Subclasses should reimplement this
@@ -55,8 +71,31 @@ protected:
      */
     virtual QSharedPointer<HotSpot> newHotSpot(int startLine, int startColumn, int endLine, int endColumn, const QStringList &capturedTexts);
 
+    /**
+     * Quick single-pass test for whether @p text can contain a match at
+     * all, run before the (much more expensive) regular expression.
+     * Subclasses whose pattern needs a distinctive trigger character can
+     * reimplement this to reject candidate-free regions cheaply; it must
+     * never reject text that regExp() would match.
+     *
+     * The default implementation scans for a literal substring that
+     * setRegExp() extracted from the pattern, so arbitrary user-supplied
+     * patterns get a fast candidate gate without a hand-written
+     * prefilter; when no required literal could be derived it accepts
+     * everything.
+     */
+    virtual bool prefilterRegion(QStringView text) const;
+
 private:
     QRegularExpression _searchText;
+    bool _patternChanged = true;
+
+    // longest literal substring every match must contain, derived from
+    // the pattern by setRegExp(); empty when none could be extracted
+    QString _requiredLiteral;
+    Qt::CaseSensitivity _literalCase = Qt::CaseSensitive;
+    // one warning per pattern when the scan budget is exceeded
+    bool _budgetWarned = false;
 };
 
 }
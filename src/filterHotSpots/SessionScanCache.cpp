@@ -0,0 +1,79 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "SessionScanCache.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace Konsole;
+
+// cap on remembered empty chunk texts; matches the per-chain chunk cache
+// and covers minutes of scrollback for the cost of the decoded text
+static constexpr int MaxKnownEmpty = 4096;
+
+bool SessionScanCache::snapshotFor(const ViewportKey &key, Snapshot *out) const
+{
+    QMutexLocker locker(&_mutex);
+
+    if (!key.isValid() || !(_snapshot.key == key)) {
+        return false;
+    }
+    *out = _snapshot;
+    return true;
+}
+
+void SessionScanCache::publishSnapshot(const Snapshot &snapshot)
+{
+    if (!snapshot.key.isValid()) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+    _snapshot = snapshot;
+}
+
+bool SessionScanCache::isKnownEmpty(const QString &fingerprint, const QString &text) const
+{
+    if (fingerprint.isEmpty()) {
+        return false;
+    }
+
+    QMutexLocker locker(&_mutex);
+    return fingerprint == _emptyFingerprint && _knownEmpty.contains(text);
+}
+
+void SessionScanCache::recordEmpty(const QString &fingerprint, const QString &text)
+{
+    if (fingerprint.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+
+    if (fingerprint != _emptyFingerprint) {
+        _knownEmpty.clear();
+        _emptyFingerprint = fingerprint;
+    }
+    _knownEmpty.insert(text, ++_useCounter);
+
+    // evict the least recently recorded half once over the cap, the same
+    // generation-ordered eviction the per-chain chunk cache uses
+    if (_knownEmpty.size() > MaxKnownEmpty) {
+        std::vector<quint64> counters;
+        counters.reserve(_knownEmpty.size());
+        for (const quint64 counter : std::as_const(_knownEmpty)) {
+            counters.push_back(counter);
+        }
+        const auto nth = counters.begin() + (_knownEmpty.size() - MaxKnownEmpty / 2);
+        std::nth_element(counters.begin(), nth, counters.end());
+        const quint64 cutoff = *nth;
+
+        for (auto it = _knownEmpty.begin(); it != _knownEmpty.end();) {
+            it = it.value() < cutoff ? _knownEmpty.erase(it) : std::next(it);
+        }
+    }
+}
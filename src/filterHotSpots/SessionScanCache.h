@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SESSION_SCAN_CACHE_H
+#define SESSION_SCAN_CACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+/**
+ * Filter-scan state shared by every display attached to one session.
+ *
+ * When a session is shown in several split views, each view's
+ * TerminalImageFilterChain decodes the visible image to text and runs
+ * the filter regexes over it independently, even though views at the
+ * same scroll position see identical content.  Session installs one
+ * instance of this cache on all of its views so that work done by the
+ * first chain to process a frame can be reused by the others:
+ *
+ * - the decoded text snapshot (buffer, line positions, chunk bounds) is
+ *   published keyed by the exact viewport it was built from, so a second
+ *   view at the same position adopts it instead of decoding again;
+ * - chunk texts that produced no hotspots are remembered together with a
+ *   fingerprint of the filter set that scanned them (see
+ *   Filter::cacheFingerprint()), so other views skip the regexes for
+ *   those chunks entirely.  Only empty results are shared: hotspot
+ *   objects belong to one chain and cannot sit in two committed sets.
+ *
+ * All methods are thread-safe; chains consult the cache from their scan
+ * worker threads.
+ */
+class KONSOLEPRIVATE_EXPORT SessionScanCache
+{
+public:
+    /**
+     * Identifies the viewport a snapshot was decoded from.  Two windows
+     * produce the same text exactly when all fields agree: same screen,
+     * same content generation, same position and same size.
+     */
+    struct ViewportKey {
+        const void *screen = nullptr;
+        quint64 generation = 0;
+        int currentLine = -1;
+        int lines = 0;
+        int columns = 0;
+
+        bool operator==(const ViewportKey &other) const
+        {
+            return screen == other.screen && generation == other.generation && currentLine == other.currentLine && lines == other.lines
+                && columns == other.columns;
+        }
+        bool isValid() const
+        {
+            return screen != nullptr;
+        }
+    };
+
+    /** One run of wrapped lines; mirrors the chain's chunking. */
+    struct ChunkBounds {
+        int startLine;
+        int startPos;
+        int endPos;
+    };
+
+    /** The decoded form of one viewport. */
+    struct Snapshot {
+        ViewportKey key;
+        QString buffer;
+        QList<int> linePositions;
+        QList<ChunkBounds> chunks;
+    };
+
+    /**
+     * Copies the published snapshot into @p out and returns true when one
+     * matching @p key is available.  The copy is cheap: the contained
+     * containers are implicitly shared.
+     */
+    bool snapshotFor(const ViewportKey &key, Snapshot *out) const;
+
+    /** Publishes @p snapshot as the decoded form of its viewport. */
+    void publishSnapshot(const Snapshot &snapshot);
+
+    /**
+     * Returns true when @p text is known to produce no hotspots under the
+     * filter set identified by @p fingerprint.
+     */
+    bool isKnownEmpty(const QString &fingerprint, const QString &text) const;
+
+    /** Records that @p text produced no hotspots under @p fingerprint. */
+    void recordEmpty(const QString &fingerprint, const QString &text);
+
+private:
+    mutable QMutex _mutex;
+
+    // the one most recent snapshot; views of a session process the same
+    // frame back to back, so depth beyond one buys nothing
+    Snapshot _snapshot;
+
+    // chunk text -> last-use counter, valid for _emptyFingerprint only;
+    // a fingerprint change (filter set or external filter state moved)
+    // drops the whole set
+    QString _emptyFingerprint;
+    QHash<QString, quint64> _knownEmpty;
+    quint64 _useCounter = 0;
+};
+
+}
+#endif
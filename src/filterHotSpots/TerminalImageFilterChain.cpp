@@ -5,47 +5,110 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "TerminalImageFilterChain.h"
+#include "Filter.h"
 #include "profile/Profile.h"
 
+#include <QRunnable>
 #include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <vector>
 
 #include "../decoders/PlainTextDecoder.h"
 
+#include "AllocationTracker.h"
 #include "terminalDisplay/TerminalDisplay.h"
 
 using namespace Konsole;
 
+// how many chunk results to keep cached, including those that scrolled
+// out of the snapshot; a few thousand covers minutes of scrollback for
+// the cost of the decoded text plus the hotspots found on it
+static constexpr int MaxRetainedChunks = 4096;
+
 TerminalImageFilterChain::TerminalImageFilterChain(TerminalDisplay *terminalDisplay)
     : FilterChain(terminalDisplay)
-    , _buffer(nullptr)
-    , _linePositions(nullptr)
 {
+    // one worker; scans are single-flight, a newer image cancels the
+    // previous scan instead of queueing behind it
+    _scanPool.setMaxThreadCount(1);
+}
+
+TerminalImageFilterChain::~TerminalImageFilterChain()
+{
+    waitForScan();
+}
+
+void TerminalImageFilterChain::addFilter(Filter *filter)
+{
+    waitForScan();
+    FilterChain::addFilter(filter);
 }
 
-TerminalImageFilterChain::~TerminalImageFilterChain() = default;
+void TerminalImageFilterChain::removeFilter(Filter *filter)
+{
+    waitForScan();
+    FilterChain::removeFilter(filter);
+}
 
-void TerminalImageFilterChain::setImage(const Character *const image, int lines, int columns, const QVector<LineProperty> &lineProperties)
+void TerminalImageFilterChain::clear()
+{
+    waitForScan();
+    FilterChain::clear();
+}
+
+void TerminalImageFilterChain::setImage(const Character *const image,
+                                        int lines,
+                                        int columns,
+                                        const QVector<LineProperty> &lineProperties,
+                                        const SessionScanCache::ViewportKey &viewportKey)
 {
     if (_filters.empty()) {
         return;
     }
 
+    AllocationTracker::Scope allocationScope(AllocationTracker::FilterSubsystem);
+
     // reset all filters and hotspots
     reset();
 
-    PlainTextDecoder decoder;
+    // another view of the same session may have decoded this exact
+    // viewport already; adopt its snapshot instead of decoding again.
+    // The containers are implicitly shared, so this costs a few refcounts
+    if (_sessionCache) {
+        SessionScanCache::Snapshot snapshot;
+        if (_sessionCache->snapshotFor(viewportKey, &snapshot)) {
+            // adopting drops the inactive pair's reserved capacity, but a
+            // cache hit means another view decoded this frame for us
+            SnapshotBuffer &snap = _snapshots[1 - _activeSnapshot];
+            snap.text = snapshot.buffer;
+            snap.linePositions = snapshot.linePositions;
+            _activeSnapshot = 1 - _activeSnapshot;
+            _hasImage = true;
+            setBuffer(&snap.text, &snap.linePositions);
+            _chunks = snapshot.chunks;
+            return;
+        }
+    }
 
-    // setup new shared buffers for the filters to process on
-    _buffer.reset(new QString());
-    _linePositions.reset(new QList<int>());
+    PlainTextDecoder decoder;
 
-    setBuffer(_buffer.get(), _linePositions.get());
+    // decode into the inactive pair, reusing its allocations; resize(0)
+    // rather than clear() keeps the QString's capacity
+    SnapshotBuffer &snap = _snapshots[1 - _activeSnapshot];
+    snap.text.resize(0);
+    snap.linePositions.clear();
 
-    QTextStream lineStream(_buffer.get());
+    QTextStream lineStream(&snap.text);
     decoder.begin(&lineStream);
 
+    _chunks.clear();
+    int chunkStartLine = 0;
+    int chunkStartPos = 0;
+
     for (int i = 0; i < lines; i++) {
-        _linePositions->append(_buffer->length());
+        snap.linePositions.append(snap.text.length());
         decoder.decodeLine(image + i * columns, columns, LineProperty());
 
         // pretend that each non-wrapped line ends with a newline character.
@@ -53,7 +116,262 @@ void TerminalImageFilterChain::setImage(const Character *const image, int lines,
         // being treated as part of a link that occurs at the start of the next line
         if ((lineProperties.value(i, LineProperty()).flags.f.wrapped) == 0) {
             lineStream << QLatin1Char('\n');
+
+            // a hard newline closes the current run of wrapped lines
+            _chunks.append({chunkStartLine, chunkStartPos, int(snap.text.length())});
+            chunkStartLine = i + 1;
+            chunkStartPos = snap.text.length();
         }
     }
     decoder.end();
+
+    // trailing run still wrapped at the bottom of the image
+    if (chunkStartLine < lines) {
+        _chunks.append({chunkStartLine, chunkStartPos, int(snap.text.length())});
+    }
+
+    _activeSnapshot = 1 - _activeSnapshot;
+    _hasImage = true;
+    setBuffer(&snap.text, &snap.linePositions);
+
+    // publish the decoded form for the session's other views
+    if (_sessionCache && viewportKey.isValid()) {
+        SessionScanCache::Snapshot snapshot;
+        snapshot.key = viewportKey;
+        snapshot.buffer = snap.text;
+        snapshot.linePositions = snap.linePositions;
+        snapshot.chunks = _chunks;
+        _sessionCache->publishSnapshot(snapshot);
+    }
+}
+
+void TerminalImageFilterChain::setSessionScanCache(const QSharedPointer<SessionScanCache> &cache)
+{
+    waitForScan();
+    _sessionCache = cache;
+}
+
+void TerminalImageFilterChain::process()
+{
+    if (!_hasImage) {
+        FilterChain::process();
+        return;
+    }
+
+    scanChunks(nullptr);
+    commitScan();
+}
+
+bool TerminalImageFilterChain::scanChunks(ScanState *state)
+{
+    _pendingShifts.clear();
+
+    QList<Filter *> incremental;
+    QList<Filter *> wholeBuffer;
+    for (auto *filter : std::as_const(_filters)) {
+        (filter->processIncrementally() ? incremental : wholeBuffer).append(filter);
+    }
+
+    // a changed filter set or a filter whose external state moved (new
+    // regexp, new working directory) makes every cached result suspect
+    bool cacheUsable = (incremental == _cacheFilters);
+    for (auto *filter : std::as_const(incremental)) {
+        if (!filter->updateState()) {
+            cacheUsable = false;
+        }
+    }
+    if (!cacheUsable) {
+        _chunkCache.clear();
+    }
+    _cacheFilters = incremental;
+
+    // fingerprint of the incremental filter set, used to exchange
+    // negative results with the session's other views; one filter that
+    // cannot be fingerprinted disables the exchange.  Computed after the
+    // updateState() calls above so external state (e.g. FileFilter's
+    // working directory) is current
+    QString sharedFingerprint;
+    if (_sessionCache) {
+        for (auto *filter : std::as_const(incremental)) {
+            const QString fingerprint = filter->cacheFingerprint();
+            if (fingerprint.isEmpty()) {
+                sharedFingerprint.clear();
+                break;
+            }
+            sharedFingerprint += fingerprint + QLatin1Char('\n');
+        }
+    }
+
+    _scanGeneration++;
+
+    QMultiHash<QString, CachedChunk> newCache;
+    for (const auto &chunk : std::as_const(_chunks)) {
+        if (state != nullptr && state->canceled.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        const QString text = _snapshots[_activeSnapshot].text.mid(chunk.startPos, chunk.endPos - chunk.startPos);
+
+        CachedChunk entry;
+        entry.startLine = chunk.startLine;
+        entry.generation = _scanGeneration;
+
+        const auto it = _chunkCache.find(text);
+        if (it != _chunkCache.end()) {
+            // clean chunk: splice last frame's hotspots back in, moved to
+            // the chunk's current position.  The objects are still live
+            // in the committed set, so the move is deferred to
+            // commitScan() rather than applied under a reader's feet
+            const int delta = chunk.startLine - it->startLine;
+            for (const auto &cached : std::as_const(it->spots)) {
+                if (delta != 0) {
+                    _pendingShifts.append({cached.second, delta});
+                }
+                cached.first->adoptHotSpot(cached.second);
+            }
+            entry.spots = it->spots;
+            if (!entry.spots.isEmpty()) {
+                // a hotspot object can only sit at one position, so an
+                // identical chunk further down re-runs the regexes; empty
+                // results can serve any number of identical chunks
+                _chunkCache.erase(it);
+            }
+        } else if (!sharedFingerprint.isEmpty() && _sessionCache->isKnownEmpty(sharedFingerprint, text)) {
+            // another view's chain already scanned this text and found
+            // nothing; empty results carry no hotspot objects, so they
+            // can be shared across chains directly
+        } else {
+            // dirty chunk: run the regexes over this range only
+            for (auto *filter : std::as_const(incremental)) {
+                const int before = filter->stagedHotSpots().size();
+                filter->processRegion(chunk.startPos, chunk.endPos, chunk.startLine);
+                const auto spots = filter->stagedHotSpots();
+                for (int i = before; i < spots.size(); i++) {
+                    entry.spots.append({filter, spots.at(i)});
+                }
+            }
+            if (entry.spots.isEmpty() && !sharedFingerprint.isEmpty()) {
+                _sessionCache->recordEmpty(sharedFingerprint, text);
+            }
+        }
+        newCache.insert(text, entry);
+    }
+
+    // retain results for chunks that scrolled out of the snapshot, so
+    // revisiting them later is a cache hit; entries consumed above were
+    // already erased from _chunkCache
+    for (auto it = _chunkCache.cbegin(); it != _chunkCache.cend(); ++it) {
+        if (!newCache.contains(it.key())) {
+            newCache.insert(it.key(), it.value());
+        }
+    }
+
+    // evict the entries from the oldest scans once over the cap; the
+    // current snapshot's entries carry the newest generation and survive
+    if (newCache.size() > MaxRetainedChunks) {
+        std::vector<quint64> generations;
+        generations.reserve(newCache.size());
+        for (const auto &entry : std::as_const(newCache)) {
+            generations.push_back(entry.generation);
+        }
+        const auto nth = generations.begin() + (newCache.size() - MaxRetainedChunks);
+        std::nth_element(generations.begin(), nth, generations.end());
+        const quint64 cutoff = *nth;
+
+        for (auto it = newCache.begin(); it != newCache.end();) {
+            it = it->generation < cutoff ? newCache.erase(it) : std::next(it);
+        }
+    }
+    _chunkCache = newCache;
+
+    // filters whose results do not derive from the text alone still scan
+    // every frame
+    for (auto *filter : std::as_const(wholeBuffer)) {
+        if (state != nullptr && state->canceled.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        filter->process();
+    }
+    return true;
+}
+
+void TerminalImageFilterChain::commitScan()
+{
+    for (const auto &pending : std::as_const(_pendingShifts)) {
+        pending.first->shiftLines(pending.second);
+    }
+    _pendingShifts.clear();
+
+    for (auto *filter : std::as_const(_filters)) {
+        filter->commitHotSpots();
+    }
+}
+
+void TerminalImageFilterChain::processAsync(TerminalDisplay *display)
+{
+    Q_ASSERT(!_scanInFlight);
+
+    if (!_hasImage) {
+        process();
+        return;
+    }
+
+    _scanState = std::make_shared<ScanState>();
+    _scanInFlight = true;
+
+    auto state = _scanState;
+    auto *guiThread = QThread::currentThread();
+    _scanPool.start(QRunnable::create([this, display, state, guiThread]() {
+        const bool completed = scanChunks(state.get());
+
+        if (completed) {
+            // hotspots are QObjects created on this worker; hand them to
+            // the thread that will own and read them
+            for (auto *filter : std::as_const(_filters)) {
+                const auto spots = filter->stagedHotSpots();
+                for (const auto &spot : spots) {
+                    if (spot->thread() != guiThread) {
+                        spot->moveToThread(guiThread);
+                    }
+                }
+            }
+        }
+
+        // commit on the display's thread; using the display as context
+        // drops the call if it is destroyed first
+        QMetaObject::invokeMethod(
+            display,
+            [this, display, completed]() {
+                _scanInFlight = false;
+                if (completed) {
+                    const QRegion preUpdateHotSpots = hotSpotRegion();
+                    commitScan();
+                    display->update(preUpdateHotSpots | hotSpotRegion());
+                }
+                // pick up an image that arrived (and canceled us) mid-scan
+                display->processFilters();
+            },
+            Qt::QueuedConnection);
+    }));
+}
+
+bool TerminalImageFilterChain::scanInFlight() const
+{
+    return _scanInFlight;
+}
+
+void TerminalImageFilterChain::cancelScan()
+{
+    if (_scanState) {
+        _scanState->canceled = true;
+    }
+}
+
+void TerminalImageFilterChain::waitForScan()
+{
+    cancelScan();
+    _scanPool.waitForDone();
+    // the queued completion may never run (e.g. display being destroyed
+    // with us); don't leave the chain looking busy
+    _scanInFlight = false;
 }
@@ -8,11 +8,18 @@
 #ifndef TERMINAL_IMAGE_FILTER_CHAIN
 #define TERMINAL_IMAGE_FILTER_CHAIN
 
+#include <QMultiHash>
+#include <QPair>
+#include <QSharedPointer>
 #include <QString>
+#include <QThreadPool>
+
+#include <atomic>
 #include <memory>
 
 #include "../characters/Character.h"
 #include "FilterChain.h"
+#include "SessionScanCache.h"
 
 namespace Konsole
 {
@@ -32,16 +39,139 @@ public:
      * @param lines The number of lines in the terminal image
      * @param columns The number of columns in the terminal image
      * @param lineProperties The line properties to set for image
+     * @param viewportKey Identifies the viewport @p image was taken from.
+     * When a session scan cache is installed and another view's chain has
+     * already decoded the same viewport, its snapshot is adopted instead
+     * of decoding @p image again; an invalid key disables the snapshot
+     * exchange for this frame.
+     */
+    void setImage(const Character *const image,
+                  int lines,
+                  int columns,
+                  const QVector<LineProperty> &lineProperties,
+                  const SessionScanCache::ViewportKey &viewportKey = SessionScanCache::ViewportKey());
+
+    /**
+     * Installs the scan cache shared by every view attached to the
+     * session this chain's display shows, or detaches it when @p cache is
+     * null; see SessionScanCache.
+     */
+    void setSessionScanCache(const QSharedPointer<SessionScanCache> &cache);
+
+    /**
+     * Reimplemented to process incrementally: hotspots found on a run of
+     * wrapped lines are cached keyed by the run's decoded text, so only
+     * runs whose content changed since the last frame re-run the
+     * regexes.  Filters whose results do not derive from the text alone
+     * (see Filter::processIncrementally()) still scan every frame.
+     */
+    void process() override;
+
+    /**
+     * Like process(), but scans on a worker thread.  The buffer built by
+     * setImage() is a snapshot, so the emulation can keep running while
+     * the regexes work through it.  When the scan completes, the new
+     * hotspot set is committed on @p display's thread and
+     * @p display->processFilters() is called again to pick up any image
+     * that arrived in the meantime.
+     *
+     * Only one scan runs at a time; while scanInFlight(), the chain must
+     * not be mutated (no setImage(), no filter changes) other than
+     * through cancelScan().
+     */
+    void processAsync(TerminalDisplay *display);
+
+    /** Returns true while a scan started by processAsync() is running. */
+    bool scanInFlight() const;
+
+    /**
+     * Asks an in-flight scan to stop after the current chunk.  The
+     * completion callback still runs, but discards the partial results
+     * instead of committing them.
      */
-    void setImage(const Character *const image, int lines, int columns, const QVector<LineProperty> &lineProperties);
+    void cancelScan();
+
+    /** Reimplemented to wait for an in-flight scan before mutating the filter list. */
+    void addFilter(Filter *filter) override;
+    void removeFilter(Filter *filter) override;
+    void clear() override;
 
 private:
     Q_DISABLE_COPY(TerminalImageFilterChain)
 
-    /* usually QStrings and QLists are not supposed to be in the heap, here we have a problem:
-        we need a shared memory space between many filter objeccts, defined by this TerminalImage. */
-    std::unique_ptr<QString> _buffer;
-    std::unique_ptr<QList<int>> _linePositions;
+    // a run of wrapped lines ending at a hard newline; the unit of
+    // incremental processing, since hotspots never cross one.  Uses the
+    // cache's bounds type so snapshots exchange chunk lists wholesale
+    using Chunk = SessionScanCache::ChunkBounds;
+
+    // hotspots one chunk produced on an earlier scan, with the filter
+    // that owns each; startLine locates the spots so they can be shifted
+    // when the same text reappears elsewhere (scrolling), and the
+    // generation of the scan that last saw the chunk decides eviction
+    struct CachedChunk {
+        int startLine;
+        quint64 generation = 0;
+        QList<QPair<Filter *, QSharedPointer<HotSpot>>> spots;
+    };
+
+    // flag shared with the worker of one scan; a newer snapshot sets
+    // canceled and starts over rather than waiting for stale results
+    struct ScanState {
+        std::atomic<bool> canceled{false};
+    };
+
+    /**
+     * Runs the filters over the current buffer, staging hotspots but not
+     * committing them.  Returns false when @p state was canceled
+     * mid-scan.  Called on the worker thread by processAsync() and
+     * directly by the synchronous process().
+     */
+    bool scanChunks(ScanState *state);
+
+    /**
+     * Publishes the staged hotspots: applies the line shifts recorded
+     * for cached spots (which are still live in the committed set until
+     * now) and commits every filter.  Must run on the thread that reads
+     * hotSpotAt()/hotSpots().
+     */
+    void commitScan();
+
+    /** Cancels any in-flight scan and blocks until the worker exits. */
+    void waitForScan();
+
+    // double-buffered decoded snapshot; the active pair is what the
+    // filters read through setBuffer(), decoding reuses the inactive
+    // pair's capacity.  Two pairs rather than one because publishing to
+    // the session cache aliases the active containers (implicit
+    // sharing); by the time a pair becomes the decode target again the
+    // cache aliases the other one, so writing into it does not detach
+    struct SnapshotBuffer {
+        QString text;
+        QList<int> linePositions;
+    };
+    SnapshotBuffer _snapshots[2];
+    int _activeSnapshot = 0;
+    // whether setImage() has built a snapshot yet; process() falls back
+    // to the plain whole-buffer scan until then
+    bool _hasImage = false;
+    QList<Chunk> _chunks;
+    // keeps results for the chunks of the current snapshot and, up to a
+    // cap, for chunks that have scrolled out of it, so revisiting a
+    // scrolled region is answered without running the regexes again
+    QMultiHash<QString, CachedChunk> _chunkCache;
+    QList<Filter *> _cacheFilters;
+    quint64 _scanGeneration = 0;
+
+    // shifts for hotspots adopted from the cache, deferred to
+    // commitScan() because the objects are shared with the committed set
+    QList<QPair<QSharedPointer<HotSpot>, int>> _pendingShifts;
+
+    QThreadPool _scanPool;
+    std::shared_ptr<ScanState> _scanState;
+    bool _scanInFlight = false;
+
+    // shared with the chains of the session's other views, if any
+    QSharedPointer<SessionScanCache> _sessionCache;
 };
 
 }
@@ -92,6 +92,28 @@ UrlFilter::UrlFilter()
     setRegExp(CompleteUrlRegExp);
 }
 
+bool UrlFilter::prefilterRegion(QStringView text) const
+{
+    // every match of CompleteUrlRegExp contains one of these triggers:
+    // "://" (scheme), "www." (suffix form) or '@' (email address)
+    for (qsizetype i = 0; i < text.size(); i++) {
+        const QChar c = text.at(i);
+        if (c == QLatin1Char('@')) {
+            return true;
+        }
+        if (c == QLatin1Char(':')) {
+            if (text.mid(i + 1, 2) == QLatin1String("//")) {
+                return true;
+            }
+        } else if (c == QLatin1Char('w') || c == QLatin1Char('W')) {
+            if (text.mid(i + 1, 3).compare(QLatin1String("ww."), Qt::CaseInsensitive) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 QSharedPointer<HotSpot> UrlFilter::newHotSpot(int startLine, int startColumn, int endLine, int endColumn, const QStringList &capturedTexts)
 {
     QStringList texts{};
@@ -15,12 +15,15 @@
 // System
 #include <cerrno>
 #ifndef Q_OS_WIN
+#include <fcntl.h>
 #include <unistd.h>
 #endif
 
 // Qt
 #include <QDir>
+#include <QThread>
 #include <QUrl>
+#include <QWaitCondition>
 
 // KDE
 #include <KConfigGroup>
@@ -30,6 +33,93 @@ using namespace Konsole;
 
 Q_GLOBAL_STATIC(QString, historyFileLocation)
 
+namespace Konsole
+{
+/**
+ * One shared low-priority thread that writes the queued appends of every
+ * HistoryFile to disk, so a slow filesystem never blocks the emulation.
+ */
+class HistoryFileFlusher : public QThread
+{
+public:
+    static HistoryFileFlusher *instance();
+
+    ~HistoryFileFlusher() override
+    {
+        {
+            QMutexLocker locker(&_mutex);
+            _quit = true;
+            _condition.wakeAll();
+        }
+        wait();
+    }
+
+    void enqueue(HistoryFile *file)
+    {
+        QMutexLocker locker(&_mutex);
+        if (!_queue.contains(file)) {
+            _queue.append(file);
+        }
+        _condition.wakeAll();
+    }
+
+    /**
+     * Drops @p file from the queue and blocks until the thread is done
+     * with it; afterwards the flusher won't touch the file again until
+     * its next enqueue().
+     */
+    void forget(HistoryFile *file)
+    {
+        QMutexLocker locker(&_mutex);
+        _queue.removeAll(file);
+        while (_current == file) {
+            _currentDone.wait(&_mutex);
+        }
+    }
+
+protected:
+    void run() override
+    {
+        QMutexLocker locker(&_mutex);
+        while (true) {
+            while (_queue.isEmpty() && !_quit) {
+                _condition.wait(&_mutex);
+            }
+            if (_quit) {
+                return;
+            }
+            HistoryFile *const file = _queue.takeFirst();
+            _current = file;
+            locker.unlock();
+            file->flushPending();
+            locker.relock();
+            _current = nullptr;
+            _currentDone.wakeAll();
+        }
+    }
+
+private:
+    QMutex _mutex;
+    QWaitCondition _condition;
+    QWaitCondition _currentDone;
+    QList<HistoryFile *> _queue;
+    HistoryFile *_current = nullptr;
+    bool _quit = false;
+};
+
+}
+
+Q_GLOBAL_STATIC(HistoryFileFlusher, historyFileFlusher)
+
+HistoryFileFlusher *HistoryFileFlusher::instance()
+{
+    HistoryFileFlusher *flusher = historyFileFlusher();
+    if (!flusher->isRunning()) {
+        flusher->start(QThread::LowPriority);
+    }
+    return flusher;
+}
+
 // History File ///////////////////////////////////////////
 HistoryFile::HistoryFile()
     : _length(0)
@@ -104,11 +194,66 @@ HistoryFile::HistoryFile()
 
 HistoryFile::~HistoryFile()
 {
+    // the queued data can be discarded, but the flusher thread must not
+    // touch this object once it is gone
+    if (!historyFileFlusher.isDestroyed()) {
+        historyFileFlusher()->forget(this);
+    }
+
     if (_fileMap != nullptr) {
         unmap();
     }
 }
 
+void HistoryFile::flushPending()
+{
+    // The data stays in the queue while it is written so concurrent reads
+    // never hit a window where it is neither in memory nor on disk; it is
+    // trimmed from the queue only after the write.
+    QByteArray chunk;
+    qint64 chunkStart;
+    quint64 chunkGeneration;
+    {
+        QMutexLocker locker(&_pendingMutex);
+        if (_pending.isEmpty()) {
+            return;
+        }
+        chunk = _pending;
+        chunkStart = _pendingStart;
+        chunkGeneration = _pendingGeneration;
+    }
+
+    {
+        QMutexLocker locker(&_fileMutex);
+        if (!_tmpFile.seek(chunkStart)) {
+            perror("HistoryFile::flushPending.seek");
+            return;
+        }
+        if (_tmpFile.write(chunk.constData(), chunk.size()) < 0) {
+            perror("HistoryFile::flushPending.write");
+            return;
+        }
+    }
+
+    QMutexLocker locker(&_pendingMutex);
+    // removeLast() or clear() may have discarded queued bytes in the
+    // meantime; a truncate-then-append leaves _pendingStart unchanged but
+    // puts different bytes there, so the start alone cannot tell.  Trim
+    // only if the snapshot is still from the current generation
+    if (_pendingGeneration == chunkGeneration && _pendingStart == chunkStart) {
+        _pending.remove(0, qMin<qint64>(chunk.size(), _pending.size()));
+        _pendingStart += chunk.size();
+    }
+}
+
+void HistoryFile::flushSync()
+{
+    if (!historyFileFlusher.isDestroyed()) {
+        historyFileFlusher()->forget(this);
+    }
+    flushPending();
+}
+
 // TODO:  Mapping the entire file in will cause problems if the history file becomes exceedingly large,
 //(ie. larger than available memory).  HistoryFile::map() should only map in sections of the file at a time,
 // to avoid this.
@@ -116,6 +261,9 @@ void HistoryFile::map()
 {
     Q_ASSERT(_fileMap == nullptr);
 
+    // everything queued has to be on disk before it can be mapped
+    flushSync();
+
     if (_tmpFile.flush()) {
         Q_ASSERT(_tmpFile.size() >= _length);
         _fileMap = _tmpFile.map(0, _length);
@@ -149,18 +297,67 @@ void HistoryFile::add(const char *buffer, qint64 count)
         _readWriteBalance++;
     }
 
-    qint64 rc = 0;
+    // only queue the data; the flusher thread writes it to disk so a slow
+    // filesystem never blocks the emulation here
+    bool overfull;
+    {
+        QMutexLocker locker(&_pendingMutex);
+        if (_pending.isEmpty()) {
+            _pendingStart = _length;
+        }
+        _pending.append(buffer, count);
+        // backpressure: if the disk cannot keep up at all, block here
+        // rather than growing the queue without bound
+        overfull = _pending.size() > MAX_PENDING_BYTES;
+    }
+    _length += count;
 
-    if (!_tmpFile.seek(_length)) {
-        perror("HistoryFile::add.seek");
-        return;
+#ifdef Q_OS_LINUX
+    // grow the file in large extents ahead of the writes; this keeps it
+    // contiguous on disk and takes the block allocation out of the output
+    // flood path.  Exponential growth with a capped step.  If the
+    // filesystem does not support preallocation, never try again.
+    if (_allocated >= 0 && _length > _allocated) {
+        qint64 newAllocation = qMax(_allocated, PREALLOC_MIN_BYTES);
+        while (newAllocation < _length) {
+            newAllocation += qMin(newAllocation, PREALLOC_MAX_STEP_BYTES);
+        }
+        QMutexLocker locker(&_fileMutex);
+        if (_tmpFile.handle() >= 0 && posix_fallocate(_tmpFile.handle(), 0, newAllocation) == 0) {
+            _allocated = newAllocation;
+        } else {
+            _allocated = -1;
+        }
     }
-    rc = _tmpFile.write(buffer, count);
-    if (rc < 0) {
-        perror("HistoryFile::add.write");
-        return;
+#endif
+
+    if (overfull) {
+        flushSync();
+    } else {
+        HistoryFileFlusher::instance()->enqueue(this);
+    }
+}
+
+void HistoryFile::clear()
+{
+    // forget everything queued, mapped and cached, but keep the file: it
+    // stays preallocated for the next fill
+    if (!historyFileFlusher.isDestroyed()) {
+        historyFileFlusher()->forget(this);
+    }
+    {
+        QMutexLocker locker(&_pendingMutex);
+        _pending.clear();
+        _pendingStart = 0;
+        _pendingGeneration++;
+    }
+    if (_fileMap != nullptr) {
+        unmap();
     }
-    _length += rc;
+    _readCache.clear();
+    _readCacheStart = -1;
+    _readWriteBalance = 0;
+    _length = 0;
 }
 
 void HistoryFile::get(char *buffer, qint64 size, qint64 loc)
@@ -184,13 +381,56 @@ void HistoryFile::get(char *buffer, qint64 size, qint64 loc)
     if (_fileMap != nullptr) {
         memcpy(buffer, _fileMap + loc, size);
     } else {
+        // serve the tail that still sits in the write-behind queue directly
+        // from memory; only the rest has to come from the file
+        qint64 sizeFromFile = size;
+        {
+            QMutexLocker locker(&_pendingMutex);
+            if (!_pending.isEmpty() && loc + size > _pendingStart) {
+                const qint64 bufferOffset = qMax(Q_INT64_C(0), _pendingStart - loc);
+                const qint64 pendingOffset = qMax(Q_INT64_C(0), loc - _pendingStart);
+                memcpy(buffer + bufferOffset, _pending.constData() + pendingOffset, size - bufferOffset);
+                sizeFromFile = bufferOffset;
+            }
+        }
+        if (sizeFromFile == 0) {
+            return;
+        }
+
+        if (_readCacheStart >= 0 && loc >= _readCacheStart && loc + sizeFromFile <= _readCacheStart + _readCache.size()) {
+            memcpy(buffer, _readCache.constData() + (loc - _readCacheStart), sizeFromFile);
+            return;
+        }
+
+        QMutexLocker locker(&_fileMutex);
+
+        // scrolling back through the history issues small reads at
+        // descending offsets, which the kernel's (forward) readahead cannot
+        // help with; on a miss, fetch one sequential window that ends at
+        // the requested range so the preceding reads become cache hits
+        if (sizeFromFile <= READ_CACHE_WINDOW) {
+            const qint64 end = loc + sizeFromFile;
+            const qint64 windowStart = qMax(Q_INT64_C(0), end - READ_CACHE_WINDOW);
+            if (_tmpFile.seek(windowStart)) {
+                _readCache.resize(end - windowStart);
+                if (_tmpFile.read(_readCache.data(), _readCache.size()) == _readCache.size()) {
+                    _readCacheStart = windowStart;
+                    memcpy(buffer, _readCache.constData() + (loc - windowStart), sizeFromFile);
+                    return;
+                }
+            }
+            // a failed or short window read falls back to the plain path
+            _readCache.clear();
+            _readCacheStart = -1;
+        }
+
         qint64 rc = 0;
 
         if (!_tmpFile.seek(loc)) {
             perror("HistoryFile::get.seek");
             return;
         }
-        rc = _tmpFile.read(buffer, size);
+        rc = _tmpFile.read(buffer, sizeFromFile);
         if (rc < 0) {
             perror("HistoryFile::get.read");
             return;
@@ -198,6 +438,30 @@ void HistoryFile::get(char *buffer, qint64 size, qint64 loc)
     }
 }
 
+const char *HistoryFile::mapped(qint64 size, qint64 loc)
+{
+    if (loc < 0 || size < 0 || loc + size > _length) {
+        return nullptr;
+    }
+
+    // while appends are queued the map (if any) is stale for the tail;
+    // add() unmaps, so a non-null _fileMap implies an empty queue
+
+    // participate in the same read/write balance bookkeeping as get(), so
+    // span readers also trigger the automatic mmap of the file
+    if (_readWriteBalance > INT_MIN) {
+        _readWriteBalance--;
+    }
+    if ((_fileMap == nullptr) && _readWriteBalance < MAP_THRESHOLD) {
+        map();
+    }
+
+    if (_fileMap == nullptr) {
+        return nullptr;
+    }
+    return reinterpret_cast<const char *>(_fileMap + loc);
+}
+
 void HistoryFile::set(char *buffer, qint64 size, qint64 loc)
 {
     if (loc < 0 || size < 0 || loc + size > qint64(_length * sizeof(LineProperty))) {
@@ -205,6 +469,12 @@ void HistoryFile::set(char *buffer, qint64 size, qint64 loc)
         return;
     }
 
+    // drop the read cache if the in-place write touches it
+    if (_readCacheStart >= 0 && loc < _readCacheStart + _readCache.size() && loc + size > _readCacheStart) {
+        _readCache.clear();
+        _readCacheStart = -1;
+    }
+
     // count number of get() calls vs. number of add() calls.
     // If there are many more get() calls compared with add()
     // calls (decided by using MAP_THRESHOLD) then mmap the log
@@ -219,6 +489,10 @@ void HistoryFile::set(char *buffer, qint64 size, qint64 loc)
     if (_fileMap != nullptr) {
         memcpy(_fileMap + loc, buffer, size);
     } else {
+        // in-place writes are rare (line property updates); flushing first
+        // keeps them ordered with the queued appends
+        flushSync();
+
         qint64 rc = 0;
 
         if (!_tmpFile.seek(loc)) {
@@ -239,6 +513,28 @@ void HistoryFile::removeLast(qint64 loc)
         fprintf(stderr, "removeLast(%lld): invalid args.\n", loc);
         return;
     }
+
+    // drop the read cache if it extends beyond the new end
+    if (_readCacheStart >= 0 && _readCacheStart + _readCache.size() > loc) {
+        _readCache.clear();
+        _readCacheStart = -1;
+    }
+
+    // drop any queued data beyond the new end; the generation bump keeps
+    // a concurrent flushPending() from trimming bytes re-appended at the
+    // same offset afterwards
+    {
+        QMutexLocker locker(&_pendingMutex);
+        if (!_pending.isEmpty()) {
+            if (loc >= _pendingStart) {
+                _pending.truncate(loc - _pendingStart);
+            } else {
+                _pending.clear();
+            }
+            _pendingGeneration++;
+        }
+    }
+
     _length = loc;
 }
 
@@ -8,14 +8,23 @@
 #define HISTORYFILE_H
 
 // Qt
+#include <QByteArray>
+#include <QMutex>
 #include <QTemporaryFile>
 
 #include "konsoleprivate_export.h"
 
 namespace Konsole
 {
+class HistoryFileFlusher;
+
 /*
    An extendable tmpfile(1) based buffer.
+
+   Appends are write-behind: add() only queues the data in memory and a
+   shared background thread writes it to disk, so slow storage (NFS home
+   directories) no longer stalls the emulation path. Reads serve any
+   still-queued tail straight from the queue.
 */
 class HistoryFile
 {
@@ -25,6 +34,13 @@ public:
 
     virtual void add(const char *buffer, qint64 count);
     virtual void get(char *buffer, qint64 size, qint64 loc);
+    // drops all content but keeps the file itself, so its preallocated
+    // extent is reused by the next fill
+    void clear();
+    // returns a pointer directly into the mmap'ed file data covering
+    // [loc, loc + size), or nullptr when the file is not currently mapped;
+    // the pointer is only valid until the file is next modified
+    const char *mapped(qint64 size, qint64 loc);
     virtual void set(char *buffer, qint64 size, qint64 loc);
     virtual void removeLast(qint64 loc);
     virtual qint64 len() const;
@@ -35,9 +51,33 @@ public:
     void unmap();
 
 private:
+    friend class HistoryFileFlusher;
+
+    // writes the queued appends to the file; called from the flusher
+    // thread, or from flushSync() on the calling thread
+    void flushPending();
+
+    // makes sure nothing is queued and the flusher thread is not touching
+    // this file; needed before in-place writes, mapping and destruction
+    void flushSync();
+
     qint64 _length;
     QTemporaryFile _tmpFile;
 
+    // appends not yet written to the file; covers the logical range
+    // [_pendingStart, _pendingStart + _pending.size())
+    QByteArray _pending;
+    qint64 _pendingStart = 0;
+    // bumped whenever queued bytes are discarded (removeLast(), clear());
+    // flushPending() trims the queue only if its snapshot is still from
+    // the current generation, since a truncate-then-append can put
+    // different bytes at the same _pendingStart
+    quint64 _pendingGeneration = 0;
+    mutable QMutex _pendingMutex;
+
+    // serializes file access between the flusher thread and readers
+    QMutex _fileMutex;
+
     // pointer to start of mmap'ed file data, or 0 if the file is not mmap'ed
     uchar *_fileMap;
 
@@ -49,6 +89,29 @@ private:
 
     // when _readWriteBalance goes below this threshold, the file will be mmap'ed automatically
     static const int MAP_THRESHOLD = -1000;
+
+    // appends beyond this many queued bytes are flushed synchronously, so a
+    // stalled disk caps the queue instead of growing it without bound
+    static const qint64 MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
+    // read cache for the non-mmap'ed path: one contiguous window of the
+    // file ending at the range of the last cache miss, so the small
+    // descending reads issued while scrolling back through the history
+    // are served from memory at the cost of one sequential read per window
+    QByteArray _readCache;
+    qint64 _readCacheStart = -1; // file offset of _readCache[0], or -1 if empty
+
+    // bytes fetched per cache miss; also the largest read served through
+    // the cache
+    static const qint64 READ_CACHE_WINDOW = 64 * 1024;
+
+    // bytes preallocated on disk for the file, or -1 once preallocation
+    // turned out to be unsupported; see add()
+    qint64 _allocated = 0;
+
+    // first preallocated extent, and the largest single growth step
+    static const qint64 PREALLOC_MIN_BYTES = 1024 * 1024;
+    static const qint64 PREALLOC_MAX_STEP_BYTES = 64 * 1024 * 1024;
 };
 
 }
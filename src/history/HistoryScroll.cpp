@@ -7,13 +7,20 @@
 // Own
 #include "HistoryScroll.h"
 
+#include "HistorySnapshot.h"
+#include "HistoryTrigramIndex.h"
 #include "HistoryType.h"
 
+#include <algorithm>
+
 using namespace Konsole;
 
 HistoryScroll::HistoryScroll(HistoryType *t)
     : _historyType(t)
 {
+    if (HistoryTrigramIndex::enabled()) {
+        _trigramIndex = std::make_unique<HistoryTrigramIndex>();
+    }
 }
 
 HistoryScroll::~HistoryScroll() = default;
@@ -22,3 +29,138 @@ bool HistoryScroll::hasScroll() const
 {
     return true;
 }
+
+void HistoryScroll::getCellsRange(const int lineno, const int count, const int columns, const Character &pad, Character dest[]) const
+{
+    for (int i = 0; i < count; i++) {
+        const int length = qMin(columns, getLineLen(lineno + i));
+        Character *line = dest + qint64(i) * columns;
+        getCells(lineno + i, 0, length, line);
+        std::fill(line + length, line + columns, pad);
+    }
+}
+
+void HistoryScroll::addLinesMove(QVector<Character> lines[], const LineProperty properties[], int count)
+{
+    for (int i = 0; i < count; i++) {
+        addCellsMove(lines[i].data(), lines[i].size());
+        addLine(properties[i]);
+    }
+}
+
+HistoryTrigramIndex *HistoryScroll::trigramIndex() const
+{
+    return _trigramIndex.get();
+}
+
+void HistoryScroll::enableSnapshot(const QString &path)
+{
+    // an earlier writer on the same file must flush and close before the
+    // new one truncates it
+    _snapshotWriter.reset();
+    _snapshotWriter = std::make_unique<HistorySnapshotWriter>(path);
+    if (!_snapshotWriter->isOpen()) {
+        _snapshotWriter.reset();
+        return;
+    }
+    snapshotRewrite();
+}
+
+void HistoryScroll::snapshotRewrite()
+{
+    _snapshotWriter->rewriteStart();
+
+    QVector<Character> buffer;
+    const int lines = getLines();
+    for (int line = 0; line < lines; line++) {
+        const int length = getLineLen(line);
+        buffer.resize(length);
+        getCells(line, 0, length, buffer.data());
+        _snapshotWriter->appendLine(buffer.constData(), length, getLineProperty(line));
+    }
+    _snapshotWriter->flush();
+    _snapshotCompactPending = false;
+}
+
+void HistoryScroll::lineAppended(const Character a[], int count)
+{
+    if (_trigramIndex) {
+        _trigramIndex->appendLine(a, count);
+    }
+    if (_snapshotWriter) {
+        // dropped lines decided the compaction; they are gone by now and
+        // this hook runs before the new line is inserted, so a rewrite
+        // here sees exactly the lines preceding it
+        if (_snapshotCompactPending) {
+            snapshotRewrite();
+        }
+        _snapshotWriter->appendLine(a, count, LineProperty());
+    }
+}
+
+void HistoryScroll::linePropertyChanged(int lineno, LineProperty prop)
+{
+    if (_snapshotWriter) {
+        _snapshotWriter->setLineProperty(lineno, prop);
+    }
+}
+
+void HistoryScroll::firstLinesDropped(int lines)
+{
+    if (_trigramIndex) {
+        _trigramIndex->dropFirstLines(lines);
+    }
+    if (_snapshotWriter) {
+        _snapshotWriter->dropFirstLines(lines);
+        if (_snapshotWriter->compactionNeeded()) {
+            _snapshotCompactPending = true;
+        }
+    }
+}
+
+void HistoryScroll::lastLineDropped()
+{
+    if (_snapshotWriter) {
+        _snapshotWriter->dropLastLine();
+    }
+    if (!_trigramIndex) {
+        return;
+    }
+    _trigramIndex->dropLastLine();
+
+    // re-read the trailing cells of what becomes the last line so that
+    // windows straddling the next line boundary can still be built
+    const int lines = getLines();
+    Character tail[4];
+    int tailLen = 0;
+    if (lines >= 2) {
+        const int length = getLineLen(lines - 2);
+        tailLen = qMin(length, 4);
+        getCells(lines - 2, length - tailLen, tailLen, tail);
+    }
+    _trigramIndex->setTail(tail, tailLen);
+}
+
+bool HistoryScroll::hasLineObservers() const
+{
+    return _trigramIndex != nullptr || _snapshotWriter != nullptr;
+}
+
+void HistoryScroll::linesRewritten()
+{
+    if (_trigramIndex) {
+        _trigramIndex->clear();
+
+        QVector<Character> buffer;
+        const int lines = getLines();
+        for (int line = 0; line < lines; line++) {
+            const int length = getLineLen(line);
+            buffer.resize(length);
+            getCells(line, 0, length, buffer.data());
+            _trigramIndex->appendLine(buffer.constData(), length);
+        }
+    }
+    if (_snapshotWriter) {
+        snapshotRewrite();
+    }
+}
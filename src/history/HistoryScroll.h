@@ -16,6 +16,7 @@
 #include "../characters/Character.h"
 
 // Qt
+#include <QString>
 #include <QVector>
 
 namespace Konsole
@@ -24,6 +25,8 @@ namespace Konsole
 // Abstract base class for file and buffer versions
 //////////////////////////////////////////////////////////////////////
 class HistoryType;
+class HistoryTrigramIndex;
+class HistorySnapshotWriter;
 
 class KONSOLEPRIVATE_EXPORT HistoryScroll
 {
@@ -36,8 +39,44 @@ public:
     // access to history
     virtual int getLines() const = 0;
     virtual int getMaxLines() const = 0;
+    /**
+     * Approximate number of bytes this scroll currently occupies (memory
+     * for the compact scroll, disk for the file-backed one); used by the
+     * per-session diagnostics reported over D-Bus.
+     */
+    virtual qint64 sizeBytes() const = 0;
     virtual int getLineLen(const int lineno) const = 0;
     virtual void getCells(const int lineno, const int colno, const int count, Character res[]) const = 0;
+    /**
+     * Returns a pointer to the requested cells directly inside the backing
+     * store, or nullptr when the implementation cannot hand one out (storage
+     * not memory-mapped or not contiguous).  The span is only valid until
+     * the history is next modified; callers must consume it immediately and
+     * fall back to getCells() on nullptr.
+     */
+    virtual const Character *getCellsSpan(const int /*lineno*/, const int /*colno*/, const int /*count*/) const
+    {
+        return nullptr;
+    }
+    /**
+     * Fills @p count whole lines starting at @p lineno into @p dest at
+     * @p columns cells per line; lines shorter than @p columns are padded
+     * with @p pad, longer ones are truncated.  Equivalent to calling
+     * getLineLen()/getCells() per line, which is what the base
+     * implementation does; backends override it to serve the whole range
+     * with one pass over their backing store instead of a virtual call
+     * per line.
+     */
+    virtual void getCellsRange(const int lineno, const int count, const int columns, const Character &pad, Character dest[]) const;
+    /**
+     * Hints that the @p count lines starting at @p lineno are likely to
+     * be read soon (the page adjacent to the viewport in the current
+     * scroll direction).  Backends with a slow path to their storage can
+     * warm it up; the default does nothing.
+     */
+    virtual void prefetchRange(const int /*lineno*/, const int /*count*/) const
+    {
+    }
     virtual bool isWrappedLine(const int lineNumber) const = 0;
     virtual LineProperty getLineProperty(const int lineno) const = 0;
     virtual void setLineProperty(const int lineno, LineProperty prop) = 0;
@@ -54,23 +93,95 @@ public:
 
     virtual void addLine(const LineProperty lineProperty = LineProperty()) = 0;
 
+    /**
+     * Bulk handoff: appends @p count finished lines together with their
+     * properties, consuming the cell arrays.  Equivalent to calling
+     * addCellsMove()/addLine() per line, which is what the base
+     * implementation does; backends override it to pay bookkeeping
+     * (trimming, compression) once per batch instead of once per line.
+     */
+    virtual void addLinesMove(QVector<Character> lines[], const LineProperty properties[], int count);
+
     // modify history
     virtual void removeCells() = 0;
     virtual int reflowLines(const int columns, std::map<int, int> *deltas = nullptr) = 0;
 
+    /**
+     * Drops every line while keeping the backing storage, so clearing the
+     * history does not tear the storage down just to regrow it.  Returns
+     * false when the implementation cannot clear in place (the default),
+     * in which case the caller replaces the scroll instead.
+     */
+    virtual bool clearInPlace()
+    {
+        return false;
+    }
+
+    /**
+     * Drops the oldest lines down to @p keepLines where the backend can do
+     * so cheaply, and returns the number of lines dropped.  Used by the
+     * memory-pressure trimmer; backends without a cheap trim keep
+     * everything (the default).
+     */
+    virtual int dropOldestLines(int /*keepLines*/)
+    {
+        return 0;
+    }
+
     //
     // FIXME:  Passing around constant references to HistoryType instances
     // is very unsafe, because those references will no longer
     // be valid if the history scroll is deleted.
     //
-    const HistoryType &getType() const
+    virtual const HistoryType &getType() const
     {
         return *_historyType;
     }
 
+    /**
+     * Returns the trigram index kept in sync with this scroll's lines,
+     * or nullptr when index maintenance is disabled (the default; see
+     * HistoryTrigramIndex::enabled()).
+     */
+    HistoryTrigramIndex *trigramIndex() const;
+
+    /**
+     * Starts maintaining a binary snapshot of this scroll's lines in the
+     * file at @p path (see HistorySnapshotWriter).  The current contents
+     * are written out immediately and every later change is appended or
+     * patched incrementally.
+     */
+    void enableSnapshot(const QString &path);
+
 protected:
+    // hooks implementations call at the points where lines are added,
+    // removed or rewritten so the trigram index and the snapshot writer
+    // stay in sync; all of them are no-ops when both are disabled
+    void lineAppended(const Character a[], int count);
+    void linePropertyChanged(int lineno, LineProperty prop);
+    void firstLinesDropped(int lines);
+    // must run before the line is actually removed so the preceding
+    // line can still be read to restore the index boundary tail
+    void lastLineDropped();
+    // rebuilds index and snapshot from scratch; for operations that
+    // rewrite the line layout wholesale (reflow)
+    void linesRewritten();
+    // true when a consumer (trigram index or snapshot writer) mirrors
+    // the line layout and cannot follow piecemeal renumbering
+    bool hasLineObservers() const;
+
     std::unique_ptr<HistoryType> _historyType;
     const int MAX_REFLOW_LINES = 20000;
+
+private:
+    // full snapshot rewrite from the current scroll contents
+    void snapshotRewrite();
+
+    std::unique_ptr<HistoryTrigramIndex> _trigramIndex;
+    std::unique_ptr<HistorySnapshotWriter> _snapshotWriter;
+    // a compaction decision is made when old lines are dropped, but the
+    // rewrite has to wait until they are actually gone from the scroll
+    bool _snapshotCompactPending = false;
 };
 
 }
@@ -0,0 +1,273 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "HistoryScrollConversion.h"
+
+// History
+#include "HistoryTrigramIndex.h"
+#include "HistoryType.h"
+
+using namespace Konsole;
+
+bool HistoryScrollConversion::suitable(const HistoryScroll &oldScroll, const HistoryType &type)
+{
+    // a limited target would trim its oldest lines while the backfill is
+    // still running, which the combined view does not model; the trigram
+    // index mirrors the line layout per scroll and cannot follow the
+    // handover, so those sessions keep the synchronous conversion
+    return oldScroll.getLines() >= MIN_LINES && type.maximumLineCount() < 0 && !HistoryTrigramIndex::enabled();
+}
+
+void HistoryScrollConversion::collapse(std::unique_ptr<HistoryScroll> &scroll)
+{
+    auto *conversion = dynamic_cast<HistoryScrollConversion *>(scroll.get());
+    if (conversion == nullptr) {
+        return;
+    }
+    {
+        QMutexLocker locker(&conversion->_mutex);
+        if (!conversion->_backfillDone) {
+            return;
+        }
+    }
+    conversion->_worker->wait();
+    // move the target out before the assignment destroys the proxy
+    auto target = std::move(conversion->_target);
+    scroll = std::move(target);
+}
+
+HistoryScrollConversion::HistoryScrollConversion(std::unique_ptr<HistoryScroll> source, std::unique_ptr<HistoryScroll> target)
+    : HistoryScroll(nullptr)
+    , _source(std::move(source))
+    , _target(std::move(target))
+    , _sourceLineCount(_source->getLines())
+{
+    _worker.reset(QThread::create([this] {
+        backfill();
+    }));
+    _worker->start(QThread::LowPriority);
+}
+
+HistoryScrollConversion::~HistoryScrollConversion()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        _stop = true;
+    }
+    _worker->wait();
+}
+
+void HistoryScrollConversion::backfill()
+{
+    QVector<Character> buffer;
+    while (true) {
+        QMutexLocker locker(&_mutex);
+        if (_stop) {
+            return;
+        }
+        if (_converted == _sourceLineCount) {
+            // caught up; hand the pending lines over and switch every
+            // later call to the target
+            for (int i = 0; i < _pendingLines.size(); ++i) {
+                _target->addCellsMove(_pendingLines[i].data(), _pendingLines[i].size());
+                _target->addLine(_pendingProperties.at(i));
+            }
+            _pendingLines.clear();
+            _pendingProperties.clear();
+            _backfillDone = true;
+            return;
+        }
+        const int end = qMin(_sourceLineCount, _converted + BLOCK_LINES);
+        for (; _converted < end; ++_converted) {
+            const int length = _source->getLineLen(_converted);
+            buffer.resize(length);
+            _source->getCells(_converted, 0, length, buffer.data());
+            _target->addCells(buffer.constData(), length);
+            _target->addLine(_source->getLineProperty(_converted));
+        }
+        // the lock is dropped between blocks so appends and reads on the
+        // GUI thread interleave with the copy
+    }
+}
+
+void HistoryScrollConversion::waitForBackfill() const
+{
+    _worker->wait();
+}
+
+int HistoryScrollConversion::getLines() const
+{
+    QMutexLocker locker(&_mutex);
+    if (_backfillDone) {
+        return _target->getLines();
+    }
+    return _sourceLineCount + _pendingLines.size();
+}
+
+int HistoryScrollConversion::getMaxLines() const
+{
+    QMutexLocker locker(&_mutex);
+    if (_backfillDone) {
+        return _target->getMaxLines();
+    }
+    // the target is unlimited (see suitable())
+    return _sourceLineCount + _pendingLines.size();
+}
+
+qint64 HistoryScrollConversion::sizeBytes() const
+{
+    QMutexLocker locker(&_mutex);
+    qint64 pendingBytes = 0;
+    for (const QVector<Character> &line : _pendingLines) {
+        pendingBytes += line.size() * sizeof(Character);
+    }
+    return _source->sizeBytes() + _target->sizeBytes() + pendingBytes;
+}
+
+int HistoryScrollConversion::getLineLen(const int lineno) const
+{
+    QMutexLocker locker(&_mutex);
+    if (_backfillDone) {
+        return _target->getLineLen(lineno);
+    }
+    if (lineno < _sourceLineCount) {
+        return _source->getLineLen(lineno);
+    }
+    return _pendingLines.at(lineno - _sourceLineCount).size();
+}
+
+void HistoryScrollConversion::getCells(const int lineno, const int colno, const int count, Character res[]) const
+{
+    QMutexLocker locker(&_mutex);
+    if (_backfillDone) {
+        _target->getCells(lineno, colno, count, res);
+        return;
+    }
+    if (lineno < _sourceLineCount) {
+        _source->getCells(lineno, colno, count, res);
+        return;
+    }
+    const QVector<Character> &line = _pendingLines.at(lineno - _sourceLineCount);
+    std::copy(line.cbegin() + colno, line.cbegin() + colno + count, res);
+}
+
+const Character *HistoryScrollConversion::getCellsSpan(const int lineno, const int colno, const int count) const
+{
+    QMutexLocker locker(&_mutex);
+    if (_backfillDone) {
+        return _target->getCellsSpan(lineno, colno, count);
+    }
+    // the source's storage is frozen while the backfill runs, so its spans
+    // outlive the lock like any other span (until the history is modified)
+    if (lineno < _sourceLineCount) {
+        return _source->getCellsSpan(lineno, colno, count);
+    }
+    return nullptr;
+}
+
+bool HistoryScrollConversion::isWrappedLine(const int lineno) const
+{
+    return getLineProperty(lineno).flags.f.wrapped > 0;
+}
+
+LineProperty HistoryScrollConversion::getLineProperty(const int lineno) const
+{
+    QMutexLocker locker(&_mutex);
+    if (_backfillDone) {
+        return _target->getLineProperty(lineno);
+    }
+    if (lineno < _sourceLineCount) {
+        return _source->getLineProperty(lineno);
+    }
+    return _pendingProperties.at(lineno - _sourceLineCount);
+}
+
+void HistoryScrollConversion::setLineProperty(const int lineno, LineProperty prop)
+{
+    QMutexLocker locker(&_mutex);
+    if (_backfillDone) {
+        _target->setLineProperty(lineno, prop);
+        return;
+    }
+    if (lineno < _sourceLineCount) {
+        // the source keeps serving reads for this line, and the copy may
+        // already have reached it
+        _source->setLineProperty(lineno, prop);
+        if (lineno < _converted) {
+            _target->setLineProperty(lineno, prop);
+        }
+        return;
+    }
+    _pendingProperties[lineno - _sourceLineCount] = prop;
+}
+
+void HistoryScrollConversion::addCells(const Character a[], const int count)
+{
+    QMutexLocker locker(&_mutex);
+    if (_backfillDone) {
+        _target->addCells(a, count);
+        return;
+    }
+    _openLineCells.append(a, count);
+}
+
+void HistoryScrollConversion::addCellsMove(Character a[], const int count)
+{
+    addCells(a, count);
+}
+
+void HistoryScrollConversion::addLine(const LineProperty lineProperty)
+{
+    QMutexLocker locker(&_mutex);
+    if (_backfillDone) {
+        _target->addLine(lineProperty);
+        return;
+    }
+    _pendingLines.append(std::move(_openLineCells));
+    _pendingProperties.append(lineProperty);
+    _openLineCells = QVector<Character>();
+}
+
+void HistoryScrollConversion::removeCells()
+{
+    {
+        QMutexLocker locker(&_mutex);
+        if (_backfillDone) {
+            _target->removeCells();
+            return;
+        }
+        if (!_pendingLines.isEmpty()) {
+            _pendingLines.removeLast();
+            _pendingProperties.removeLast();
+            return;
+        }
+    }
+    // removing a source line would have to be replayed against the copy;
+    // it only happens when the screen shrinks, so just let the backfill
+    // complete first
+    waitForBackfill();
+    _target->removeCells();
+}
+
+int HistoryScrollConversion::reflowLines(const int columns, std::map<int, int> *deltas)
+{
+    // a reflow rewrites the whole line layout; it cannot run against the
+    // combined view, so the (rare) resize during a conversion waits
+    waitForBackfill();
+    return _target->reflowLines(columns, deltas);
+}
+
+bool HistoryScrollConversion::clearInPlace()
+{
+    waitForBackfill();
+    return _target->clearInPlace();
+}
+
+const HistoryType &HistoryScrollConversion::getType() const
+{
+    return _target->getType();
+}
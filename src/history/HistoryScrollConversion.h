@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef HISTORYSCROLLCONVERSION_H
+#define HISTORYSCROLLCONVERSION_H
+
+#include "konsoleprivate_export.h"
+
+// History
+#include "HistoryScroll.h"
+
+// Qt
+#include <QMutex>
+#include <QThread>
+
+namespace Konsole
+{
+class HistoryType;
+
+/**
+ * Converts a scroll to a different history type in the background while the
+ * session stays live.
+ *
+ * Switching the scrollback type used to copy every line through the
+ * HistoryScroll interface on the GUI thread, freezing the application for
+ * sessions with a large history.  This scroll stands in for the target
+ * during the conversion: a worker thread streams the old scroll's lines
+ * into the target block by block, lines appended in the meantime are kept
+ * in a pending buffer, and reads are served from the combined view.  Once
+ * the backfill is done the pending lines are drained and every call
+ * forwards to the target; the owner then swaps the proxy out via
+ * collapse().
+ *
+ * Only used for conversions to an unlimited target (see suitable()), so
+ * the combined view never has to model the target trimming its oldest
+ * lines mid-conversion.
+ */
+class KONSOLEPRIVATE_EXPORT HistoryScrollConversion : public HistoryScroll
+{
+public:
+    /**
+     * Whether converting @p oldScroll to type @p type is worth doing in the
+     * background and supported by this class: a large source, an unlimited
+     * target, and no trigram index mirroring the line layout.
+     */
+    static bool suitable(const HistoryScroll &oldScroll, const HistoryType &type);
+
+    /**
+     * If @p scroll is a finished conversion, replaces it by the conversion
+     * target; otherwise leaves it alone.  Callers invoke this from points
+     * where the history is touched anyway (e.g. when lines scroll out).
+     */
+    static void collapse(std::unique_ptr<HistoryScroll> &scroll);
+
+    /** Starts converting @p source into the empty @p target. */
+    HistoryScrollConversion(std::unique_ptr<HistoryScroll> source, std::unique_ptr<HistoryScroll> target);
+    ~HistoryScrollConversion() override;
+
+    int getLines() const override;
+    int getMaxLines() const override;
+    qint64 sizeBytes() const override;
+    int getLineLen(const int lineno) const override;
+    void getCells(const int lineno, const int colno, const int count, Character res[]) const override;
+    const Character *getCellsSpan(const int lineno, const int colno, const int count) const override;
+    bool isWrappedLine(const int lineno) const override;
+    LineProperty getLineProperty(const int lineno) const override;
+    void setLineProperty(const int lineno, LineProperty prop) override;
+
+    void addCells(const Character a[], const int count) override;
+    void addCellsMove(Character a[], const int count) override;
+    void addLine(const LineProperty lineProperty = LineProperty()) override;
+
+    void removeCells() override;
+    int reflowLines(const int columns, std::map<int, int> *deltas = nullptr) override;
+    bool clearInPlace() override;
+
+    const HistoryType &getType() const override;
+
+private:
+    // runs on the worker thread; copies the source into the target block
+    // by block, then drains the pending lines
+    void backfill();
+    // blocks until the backfill is complete; for the rare operations that
+    // need the fully converted target (reflow, removing a source line)
+    void waitForBackfill() const;
+
+    // protects every member below against the worker
+    mutable QMutex _mutex;
+
+    std::unique_ptr<HistoryScroll> _source; // frozen; only line properties may still change
+    std::unique_ptr<HistoryScroll> _target;
+
+    // lines appended while the backfill is running; logically they follow
+    // the source lines and are drained into the target once it catches up
+    QVector<QVector<Character>> _pendingLines;
+    QVector<LineProperty> _pendingProperties;
+    QVector<Character> _openLineCells; // cells added before the addLine() that closes the line
+
+    int _sourceLineCount = 0; // lines in _source at construction; _source does not grow
+    int _converted = 0; // source lines already copied into _target
+    bool _backfillDone = false; // pending lines drained, every call forwards to _target
+    bool _stop = false; // abandon the backfill (destruction only)
+
+    std::unique_ptr<QThread> _worker;
+
+    // source lines below which a synchronous conversion is cheap enough
+    static const int MIN_LINES = 10000;
+    // source lines copied per lock acquisition
+    static const int BLOCK_LINES = 1024;
+};
+
+}
+
+#endif
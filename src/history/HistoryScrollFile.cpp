@@ -8,6 +8,10 @@
 
 #include "HistoryTypeFile.h"
 
+#include <QVarLengthArray>
+
+#include <algorithm>
+
 /*
    The history scroll makes a Row(Row(Cell)) from
    two history buffers. The index buffer contains
@@ -38,6 +42,13 @@ int HistoryScrollFile::getMaxLines() const
     return getLines();
 }
 
+qint64 HistoryScrollFile::sizeBytes() const
+{
+    // bytes on disk (or still pending in the write buffers) across the
+    // three backing files
+    return _index.len() + _cells.len() + _lineflags.len();
+}
+
 int HistoryScrollFile::getLineLen(const int lineno) const
 {
     return (startOfLine(lineno + 1) - startOfLine(lineno)) / sizeof(Character);
@@ -62,6 +73,7 @@ void HistoryScrollFile::setLineProperty(const int lineno, LineProperty prop)
 {
     if (lineno >= 0 && lineno <= getLines()) {
         _lineflags.set(reinterpret_cast<char *>(&prop), sizeof(LineProperty), (lineno) * sizeof(LineProperty));
+        linePropertyChanged(lineno, prop);
     }
 }
 
@@ -85,8 +97,83 @@ void HistoryScrollFile::getCells(const int lineno, const int colno, const int co
     _cells.get(reinterpret_cast<char *>(res), count * sizeof(Character), startOfLine(lineno) + colno * sizeof(Character));
 }
 
+const Character *HistoryScrollFile::getCellsSpan(const int lineno, const int colno, const int count) const
+{
+    return reinterpret_cast<const Character *>(_cells.mapped(count * sizeof(Character), startOfLine(lineno) + colno * sizeof(Character)));
+}
+
+void HistoryScrollFile::getCellsRange(const int lineno, const int count, const int columns, const Character &pad, Character dest[]) const
+{
+    if (count <= 0) {
+        return;
+    }
+
+    const int lines = getLines();
+    Q_ASSERT(lineno >= 0 && lineno + count <= lines);
+
+    // the line starts are one contiguous slice of the index file, and the
+    // lines themselves one contiguous slice of the cells file; fetch each
+    // with a single read instead of two single-entry reads per line
+    QVarLengthArray<qint64, 65> starts(count + 1);
+    const int firstEntry = qMax(0, lineno - 1);
+    const int lastEntry = qMin(lines - 2, lineno + count - 1);
+    if (lastEntry >= firstEntry) {
+        _index.get(reinterpret_cast<char *>(starts.data() + (firstEntry - lineno + 1)), (lastEntry - firstEntry + 1) * sizeof(qint64), firstEntry * sizeof(qint64));
+    }
+    if (lineno == 0) {
+        starts[0] = 0;
+    }
+    if (lineno + count == lines) {
+        starts[count] = _cells.len();
+    }
+
+    const qint64 rangeBegin = starts[0];
+    const qint64 rangeBytes = starts[count] - rangeBegin;
+
+    // a pathologically long unreflowed line would make the contiguous
+    // slice much larger than the viewport; read per line in that case
+    if (rangeBytes > qint64(count) * columns * qint64(sizeof(Character)) * 4) {
+        HistoryScroll::getCellsRange(lineno, count, columns, pad, dest);
+        return;
+    }
+
+    QVarLengthArray<Character, 1024> scratch;
+    const Character *cells = reinterpret_cast<const Character *>(_cells.mapped(rangeBytes, rangeBegin));
+    if (cells == nullptr) {
+        scratch.resize(rangeBytes / sizeof(Character));
+        _cells.get(reinterpret_cast<char *>(scratch.data()), rangeBytes, rangeBegin);
+        cells = scratch.constData();
+    }
+
+    for (int i = 0; i < count; i++) {
+        const Character *src = cells + (starts[i] - rangeBegin) / sizeof(Character);
+        const int length = qMin<qint64>(columns, (starts[i + 1] - starts[i]) / sizeof(Character));
+        Character *line = dest + qint64(i) * columns;
+        std::copy(src, src + length, line);
+        std::fill(line + length, line + columns, pad);
+    }
+}
+
+void HistoryScrollFile::prefetchRange(const int lineno, const int count) const
+{
+    if (count <= 0 || lineno < 0 || lineno + count > getLines()) {
+        return;
+    }
+
+    // touching the end of the range is enough: a read cache miss fills
+    // one window ending at the missed location, which covers the page
+    // being prefetched (see HistoryFile::READ_CACHE_WINDOW)
+    const qint64 end = startOfLine(lineno + count);
+    if (end >= qint64(sizeof(Character))) {
+        Character probe;
+        _cells.get(reinterpret_cast<char *>(&probe), sizeof(Character), end - sizeof(Character));
+    }
+}
+
 void HistoryScrollFile::addCells(const Character text[], const int count)
 {
+    lineAppended(text, count);
+
     _cells.add(reinterpret_cast<const char *>(text), count * sizeof(Character));
 }
 
@@ -95,10 +182,13 @@ void HistoryScrollFile::addLine(LineProperty lineProperty)
     qint64 locn = _cells.len();
     _index.add(reinterpret_cast<char *>(&locn), sizeof(qint64));
     _lineflags.add(reinterpret_cast<char *>(&lineProperty), sizeof(LineProperty));
+    linePropertyChanged(getLines() - 1, lineProperty);
 }
 
 void HistoryScrollFile::removeCells()
 {
+    lastLineDropped();
+
     qint64 res = (getLines() - 2) * sizeof(qint64);
     if (getLines() < 2) {
         _cells.removeLast(0);
@@ -111,6 +201,17 @@ void HistoryScrollFile::removeCells()
     _lineflags.removeLast(res * sizeof(LineProperty));
 }
 
+bool HistoryScrollFile::clearInPlace()
+{
+    _index.clear();
+    _cells.clear();
+    _lineflags.clear();
+
+    // the trigram index and the snapshot mirror the (now empty) layout
+    linesRewritten();
+    return true;
+}
+
 int Konsole::HistoryScrollFile::reflowLines(const int columns, std::map<int, int> *)
 {
     auto reflowFile = std::make_unique<HistoryFile>();
@@ -175,5 +276,8 @@ int Konsole::HistoryScrollFile::reflowLines(const int columns, std::map<int, int
         currentPos++;
     }
 
+    // every line may have moved or split
+    linesRewritten();
+
     return 0;
 }
@@ -27,8 +27,12 @@ public:
 
     int getLines() const override;
     int getMaxLines() const override;
+    qint64 sizeBytes() const override;
     int getLineLen(const int lineno) const override;
     void getCells(const int lineno, const int colno, const int count, Character res[]) const override;
+    const Character *getCellsSpan(const int lineno, const int colno, const int count) const override;
+    void getCellsRange(const int lineno, const int count, const int columns, const Character &pad, Character dest[]) const override;
+    void prefetchRange(const int lineno, const int count) const override;
     bool isWrappedLine(const int lineno) const override;
     LineProperty getLineProperty(const int lineno) const override;
     void setLineProperty(const int lineno, LineProperty prop) override;
@@ -43,6 +47,7 @@ public:
     // Modify history
     void removeCells() override;
     int reflowLines(const int columns, std::map<int, int> * = nullptr) override;
+    bool clearInPlace() override;
 
 private:
     qint64 startOfLine(const int lineno) const;
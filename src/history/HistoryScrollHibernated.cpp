@@ -0,0 +1,206 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "HistoryScrollHibernated.h"
+
+// History
+#include "HistorySnapshot.h"
+#include "HistoryTrigramIndex.h"
+#include "compact/CompactHistoryScroll.h"
+#include "compact/CompactHistoryType.h"
+
+// Konsole
+#include "konsoledebug.h"
+
+// Qt
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+
+using namespace Konsole;
+
+bool HistoryScrollHibernated::hibernate(std::unique_ptr<HistoryScroll> &scroll, const QString &path, const ExtendedCharTable::pExtendedChars &extendedChars)
+{
+    // only the compact scroll holds its lines in RAM; the file-backed one
+    // already lives on disk, and the trigram index mirrors the line
+    // layout per scroll and would be lost across the handover
+    auto *compact = dynamic_cast<CompactHistoryScroll *>(scroll.get());
+    if (compact == nullptr || compact->getLines() == 0 || HistoryTrigramIndex::enabled()) {
+        return false;
+    }
+
+    {
+        HistorySnapshotWriter writer(path);
+        if (!writer.isOpen()) {
+            return false;
+        }
+        const int lines = compact->getLines();
+        QVector<Character> cells;
+        for (int i = 0; i < lines; i++) {
+            const int length = compact->getLineLen(i);
+            cells.resize(length);
+            if (length > 0) {
+                compact->getCells(i, 0, length, cells.data());
+            }
+            writer.appendLine(cells.constData(), length, compact->getLineProperty(i));
+        }
+        // the writer flushes on destruction
+    }
+
+    auto hibernated =
+        std::make_unique<HistoryScrollHibernated>(path, compact->getLines(), compact->getMaxLines(), QFileInfo(path).size(), extendedChars);
+    scroll = std::move(hibernated);
+    return true;
+}
+
+void HistoryScrollHibernated::collapse(std::unique_ptr<HistoryScroll> &scroll)
+{
+    auto *hibernated = dynamic_cast<HistoryScrollHibernated *>(scroll.get());
+    if (hibernated == nullptr || hibernated->_live == nullptr) {
+        return;
+    }
+    // move the restored scroll out before the assignment destroys the
+    // stand-in
+    auto live = std::move(hibernated->_live);
+    scroll = std::move(live);
+}
+
+HistoryScrollHibernated::HistoryScrollHibernated(const QString &path,
+                                                 int lines,
+                                                 int maxLines,
+                                                 qint64 snapshotBytes,
+                                                 const ExtendedCharTable::pExtendedChars &extendedChars)
+    : HistoryScroll(new CompactHistoryType(maxLines))
+    , _path(path)
+    , _lines(lines)
+    , _maxLines(maxLines)
+    , _snapshotBytes(snapshotBytes)
+    , _extendedChars(extendedChars)
+{
+}
+
+HistoryScrollHibernated::~HistoryScrollHibernated()
+{
+    // a stand-in destroyed without collapsing (session closed, history
+    // cleared) takes its snapshot with it
+    QFile::remove(_path);
+}
+
+bool HistoryScrollHibernated::isFrozen() const
+{
+    return _live == nullptr;
+}
+
+void HistoryScrollHibernated::thaw() const
+{
+    if (_live != nullptr) {
+        return;
+    }
+    CompactHistoryType(_maxLines).scroll(_live);
+    if (!restoreHistorySnapshot(_path, *_live, _extendedChars)) {
+        qCWarning(KonsoleDebug) << "Restoring hibernated scrollback from" << _path << "failed; the history is lost";
+    }
+    QFile::remove(_path);
+}
+
+int HistoryScrollHibernated::getLines() const
+{
+    return _live != nullptr ? _live->getLines() : _lines;
+}
+
+int HistoryScrollHibernated::getMaxLines() const
+{
+    return _live != nullptr ? _live->getMaxLines() : _maxLines;
+}
+
+qint64 HistoryScrollHibernated::sizeBytes() const
+{
+    // disk while frozen, like the file-backed scroll
+    return _live != nullptr ? _live->sizeBytes() : _snapshotBytes;
+}
+
+int HistoryScrollHibernated::getLineLen(const int lineno) const
+{
+    thaw();
+    return _live->getLineLen(lineno);
+}
+
+void HistoryScrollHibernated::getCells(const int lineno, const int colno, const int count, Character res[]) const
+{
+    thaw();
+    _live->getCells(lineno, colno, count, res);
+}
+
+const Character *HistoryScrollHibernated::getCellsSpan(const int lineno, const int colno, const int count) const
+{
+    thaw();
+    return _live->getCellsSpan(lineno, colno, count);
+}
+
+bool HistoryScrollHibernated::isWrappedLine(const int lineno) const
+{
+    thaw();
+    return _live->isWrappedLine(lineno);
+}
+
+LineProperty HistoryScrollHibernated::getLineProperty(const int lineno) const
+{
+    thaw();
+    return _live->getLineProperty(lineno);
+}
+
+void HistoryScrollHibernated::setLineProperty(const int lineno, LineProperty prop)
+{
+    thaw();
+    _live->setLineProperty(lineno, prop);
+}
+
+void HistoryScrollHibernated::addCells(const Character a[], const int count)
+{
+    thaw();
+    _live->addCells(a, count);
+}
+
+void HistoryScrollHibernated::addCellsMove(Character a[], const int count)
+{
+    thaw();
+    _live->addCellsMove(a, count);
+}
+
+void HistoryScrollHibernated::addLine(const LineProperty lineProperty)
+{
+    thaw();
+    _live->addLine(lineProperty);
+}
+
+void HistoryScrollHibernated::addLinesMove(QVector<Character> lines[], const LineProperty properties[], int count)
+{
+    thaw();
+    _live->addLinesMove(lines, properties, count);
+}
+
+void HistoryScrollHibernated::removeCells()
+{
+    thaw();
+    _live->removeCells();
+}
+
+int HistoryScrollHibernated::reflowLines(const int columns, std::map<int, int> *deltas)
+{
+    thaw();
+    return _live->reflowLines(columns, deltas);
+}
+
+int HistoryScrollHibernated::dropOldestLines(int keepLines)
+{
+    // a frozen scroll holds no RAM worth trimming; do not restore it
+    // just to shrink it again
+    if (_live == nullptr) {
+        return 0;
+    }
+    return _live->dropOldestLines(keepLines);
+}
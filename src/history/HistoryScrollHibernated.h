@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef HISTORYSCROLLHIBERNATED_H
+#define HISTORYSCROLLHIBERNATED_H
+
+#include "konsoleprivate_export.h"
+
+// History
+#include "HistoryScroll.h"
+
+// Konsole
+#include "../characters/ExtendedCharTable.h"
+
+// Qt
+#include <QString>
+
+namespace Konsole
+{
+/**
+ * A compact scroll hibernated to a disk snapshot.
+ *
+ * Long-lived but idle sessions pin their whole scrollback in RAM
+ * forever.  hibernate() serializes a CompactHistoryScroll into a
+ * snapshot file (the same format the persistent scrollback feature
+ * writes) and replaces it with this stand-in, which answers the line
+ * count, limit and size queries from cached metadata and only rebuilds
+ * the real scroll -- restoring from the mapped snapshot -- on the first
+ * access that actually needs line data: new output scrolling into the
+ * history, a read of a line, a reflow.  The owner swaps the thawed
+ * scroll back in via collapse().
+ *
+ * While hibernated the snapshot file holds the line data and the
+ * extended character definitions it needs, so the session contributes
+ * nothing to the extended character table's live set either.
+ */
+class KONSOLEPRIVATE_EXPORT HistoryScrollHibernated : public HistoryScroll
+{
+public:
+    /**
+     * Serializes @p scroll into a snapshot at @p path and replaces it
+     * with a hibernated stand-in, freeing the scroll's RAM.  Only
+     * compact scrolls with lines and no trigram index are worth
+     * hibernating (file-backed scrolls already live on disk); returns
+     * false and leaves @p scroll alone otherwise, or when the snapshot
+     * cannot be written.  @p extendedChars is the owner's used-chars
+     * collector, needed to re-register extended characters on thaw.
+     */
+    static bool hibernate(std::unique_ptr<HistoryScroll> &scroll, const QString &path, const ExtendedCharTable::pExtendedChars &extendedChars);
+
+    /**
+     * If @p scroll is a hibernated stand-in that has thawed, replaces it
+     * by the restored scroll; otherwise leaves it alone.  Callers invoke
+     * this from points where the history is touched anyway.
+     */
+    static void collapse(std::unique_ptr<HistoryScroll> &scroll);
+
+    HistoryScrollHibernated(const QString &path, int lines, int maxLines, qint64 snapshotBytes, const ExtendedCharTable::pExtendedChars &extendedChars);
+    ~HistoryScrollHibernated() override;
+
+    /** True while the line data only exists in the snapshot file. */
+    bool isFrozen() const;
+
+    /** Restores the scroll from the snapshot if still frozen. */
+    void thaw() const;
+
+    int getLines() const override;
+    int getMaxLines() const override;
+    qint64 sizeBytes() const override;
+    int getLineLen(const int lineno) const override;
+    void getCells(const int lineno, const int colno, const int count, Character res[]) const override;
+    const Character *getCellsSpan(const int lineno, const int colno, const int count) const override;
+    bool isWrappedLine(const int lineno) const override;
+    LineProperty getLineProperty(const int lineno) const override;
+    void setLineProperty(const int lineno, LineProperty prop) override;
+
+    void addCells(const Character a[], const int count) override;
+    void addCellsMove(Character a[], const int count) override;
+    void addLine(const LineProperty lineProperty = LineProperty()) override;
+    void addLinesMove(QVector<Character> lines[], const LineProperty properties[], int count) override;
+
+    void removeCells() override;
+    int reflowLines(const int columns, std::map<int, int> *deltas = nullptr) override;
+    int dropOldestLines(int keepLines) override;
+
+private:
+    QString _path;
+    // metadata served while frozen, so line count and size queries do
+    // not force a restore
+    int _lines;
+    int _maxLines;
+    qint64 _snapshotBytes;
+    ExtendedCharTable::pExtendedChars _extendedChars;
+    // the restored scroll once any access needed real line data
+    mutable std::unique_ptr<HistoryScroll> _live;
+};
+
+}
+
+#endif
@@ -35,6 +35,11 @@ int HistoryScrollNone::getMaxLines() const
     return 0;
 }
 
+qint64 HistoryScrollNone::sizeBytes() const
+{
+    return 0;
+}
+
 int HistoryScrollNone::getLineLen(int) const
 {
     return 0;
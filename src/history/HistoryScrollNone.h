@@ -26,6 +26,7 @@ public:
 
     int getLines() const override;
     int getMaxLines() const override;
+    qint64 sizeBytes() const override;
     int getLineLen(const int lineno) const override;
     void getCells(const int lineno, const int colno, const int count, Character res[]) const override;
     bool isWrappedLine(const int lineno) const override;
@@ -0,0 +1,96 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "HistorySlabAllocator.h"
+
+// STD
+#include <new>
+
+using namespace Konsole;
+
+HistorySlabPool &HistorySlabPool::instance()
+{
+    static HistorySlabPool pool;
+    return pool;
+}
+
+int HistorySlabPool::chunkClass(std::size_t bytes)
+{
+    std::size_t chunk = MinChunkBytes;
+    int chunkClass = 0;
+    while (chunk < bytes) {
+        chunk *= 2;
+        chunkClass++;
+    }
+    return chunkClass;
+}
+
+void *HistorySlabPool::allocate(std::size_t bytes)
+{
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    if (bytes > MaxChunkBytes) {
+        return ::operator new(bytes);
+    }
+
+    const int c = chunkClass(bytes);
+    const std::size_t chunkBytes = MinChunkBytes << c;
+
+    QMutexLocker locker(&_mutex);
+    if (_freeLists[c] == nullptr) {
+        // carve a fresh slab into chunks of this class
+        auto slab = std::make_unique<char[]>(SlabBytes);
+        char *base = slab.get();
+        for (std::size_t offset = 0; offset + chunkBytes <= SlabBytes; offset += chunkBytes) {
+            auto *node = reinterpret_cast<FreeNode *>(base + offset);
+            node->next = _freeLists[c];
+            _freeLists[c] = node;
+        }
+        _slabs.push_back(std::move(slab));
+        _reserved += SlabBytes;
+    }
+
+    FreeNode *node = _freeLists[c];
+    _freeLists[c] = node->next;
+    _used += chunkBytes;
+    return node;
+}
+
+void HistorySlabPool::deallocate(void *p, std::size_t bytes)
+{
+    if (p == nullptr) {
+        return;
+    }
+    if (bytes == 0) {
+        bytes = 1;
+    }
+    if (bytes > MaxChunkBytes) {
+        ::operator delete(p);
+        return;
+    }
+
+    const int c = chunkClass(bytes);
+
+    QMutexLocker locker(&_mutex);
+    auto *node = static_cast<FreeNode *>(p);
+    node->next = _freeLists[c];
+    _freeLists[c] = node;
+    _used -= MinChunkBytes << c;
+}
+
+std::size_t HistorySlabPool::reservedBytes() const
+{
+    QMutexLocker locker(&_mutex);
+    return _reserved;
+}
+
+std::size_t HistorySlabPool::usedBytes() const
+{
+    QMutexLocker locker(&_mutex);
+    return _used;
+}
@@ -0,0 +1,105 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef HISTORYSLABALLOCATOR_H
+#define HISTORYSLABALLOCATOR_H
+
+// STD
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Qt
+#include <QMutex>
+
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+/**
+ * A pool of large slabs carved into power-of-two chunks, shared by all
+ * history scrolls in the process.  std::deque allocates its cell storage
+ * in small fixed-size nodes; over week-long sessions those nodes churn
+ * through the global heap and fragment it.  The pool hands nodes out of
+ * 256 KiB slabs and keeps freed chunks on per-size freelists for reuse,
+ * so history growth and trimming stop touching the heap at all once the
+ * pool is warm.  Slabs are never returned to the system.
+ *
+ * Requests larger than the biggest chunk class fall through to the
+ * global heap; those are the rare, large allocations (e.g. a deque's
+ * pointer map) that do not fragment.
+ */
+class KONSOLEPRIVATE_EXPORT HistorySlabPool
+{
+public:
+    static HistorySlabPool &instance();
+
+    void *allocate(std::size_t bytes);
+    void deallocate(void *p, std::size_t bytes);
+
+    /** Bytes of slab memory obtained from the system. */
+    std::size_t reservedBytes() const;
+    /** Bytes of slab memory currently handed out. */
+    std::size_t usedBytes() const;
+
+private:
+    struct FreeNode {
+        FreeNode *next;
+    };
+
+    static constexpr std::size_t SlabBytes = 256 * 1024;
+    static constexpr std::size_t MinChunkBytes = 64;
+    static constexpr std::size_t MaxChunkBytes = 8192;
+    static constexpr int ClassCount = 8; // 64, 128, ..., 8192
+
+    static int chunkClass(std::size_t bytes);
+
+    std::vector<std::unique_ptr<char[]>> _slabs;
+    FreeNode *_freeLists[ClassCount] = {};
+    mutable QMutex _mutex;
+    std::size_t _reserved = 0;
+    std::size_t _used = 0;
+};
+
+/**
+ * Minimal STL allocator routing through HistorySlabPool; plug into the
+ * history containers whose nodes would otherwise fragment the heap.
+ */
+template<typename T>
+class HistorySlabAllocator
+{
+public:
+    using value_type = T;
+
+    HistorySlabAllocator() noexcept = default;
+    template<typename U>
+    HistorySlabAllocator(const HistorySlabAllocator<U> &) noexcept
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(HistorySlabPool::instance().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+        HistorySlabPool::instance().deallocate(p, n * sizeof(T));
+    }
+
+    friend bool operator==(const HistorySlabAllocator &, const HistorySlabAllocator &) noexcept
+    {
+        return true;
+    }
+    friend bool operator!=(const HistorySlabAllocator &, const HistorySlabAllocator &) noexcept
+    {
+        return false;
+    }
+};
+
+}
+
+#endif
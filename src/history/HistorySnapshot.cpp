@@ -0,0 +1,308 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "HistorySnapshot.h"
+
+#include "HistoryScroll.h"
+
+// Qt
+#include <QVector>
+
+// STD
+#include <cstring>
+
+using namespace Konsole;
+
+/*
+   Snapshot layout (all integers little-endian host format; the file is
+   only meant to be read back by the same installation):
+
+   header:  char[8] magic, quint32 version, quint32 skipLines, 8 pad bytes
+   records: quint32 type, then
+     type 0 (line):     quint32 cellCount, LineProperty (6 bytes), 2 pad
+                        bytes, cellCount * sizeof(Character) cells
+     type 1 (extended): quint32 key, quint32 length, length * char32_t
+
+   Record payloads stay 4-byte aligned so cells can be used directly out
+   of the mapping on restore.
+*/
+
+static const char SnapshotMagic[8] = {'K', 'O', 'N', 'S', 'H', 'I', 'S', 'T'};
+static const quint32 SnapshotVersion = 1;
+static const qint64 HeaderBytes = 24;
+static const int SkipLinesOffset = 12;
+
+static const quint32 LineRecord = 0;
+static const quint32 ExtendedCharRecord = 1;
+
+static const int PropertyBytes = 8; // sizeof(LineProperty) == 6, padded
+static const qsizetype FlushThreshold = 256 * 1024;
+
+// skipped prefixes shorter than this are not worth a rewrite
+static const int CompactionMinSkip = 4096;
+
+HistorySnapshotWriter::HistorySnapshotWriter(const QString &path)
+    : _file(path)
+{
+    if (_file.open(QIODevice::ReadWrite)) {
+        rewriteStart();
+    }
+}
+
+HistorySnapshotWriter::~HistorySnapshotWriter()
+{
+    if (isOpen()) {
+        flush();
+    }
+}
+
+bool HistorySnapshotWriter::isOpen() const
+{
+    return _file.isOpen();
+}
+
+void HistorySnapshotWriter::writeHeader()
+{
+    _buffer.append(SnapshotMagic, sizeof(SnapshotMagic));
+    const quint32 version = SnapshotVersion;
+    _buffer.append(reinterpret_cast<const char *>(&version), sizeof(version));
+    const quint32 skipLines = 0;
+    _buffer.append(reinterpret_cast<const char *>(&skipLines), sizeof(skipLines));
+    _buffer.append(8, '\0');
+}
+
+void HistorySnapshotWriter::rewriteStart()
+{
+    if (!isOpen()) {
+        return;
+    }
+    _file.resize(0);
+    _file.seek(0);
+    _flushedBytes = 0;
+    _buffer.clear();
+    _lineOffsets.clear();
+    _skipLines = 0;
+    _headerDirty = false;
+    _writtenExtended.clear();
+    writeHeader();
+}
+
+void HistorySnapshotWriter::writeExtendedChar(quint32 key)
+{
+    ushort length = 0;
+    const char32_t *chars = ExtendedCharTable::instance.lookupExtendedChar(key, length);
+    if (chars == nullptr) {
+        return;
+    }
+    const quint32 type = ExtendedCharRecord;
+    const quint32 charCount = length;
+    _buffer.append(reinterpret_cast<const char *>(&type), sizeof(type));
+    _buffer.append(reinterpret_cast<const char *>(&key), sizeof(key));
+    _buffer.append(reinterpret_cast<const char *>(&charCount), sizeof(charCount));
+    _buffer.append(reinterpret_cast<const char *>(chars), length * sizeof(char32_t));
+    _writtenExtended.insert(key);
+}
+
+void HistorySnapshotWriter::appendLine(const Character cells[], int count, LineProperty property)
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    // definitions must precede the first line referencing them
+    for (int i = 0; i < count; i++) {
+        if (cells[i].rendition.f.extended != 0 && !_writtenExtended.contains(quint32(cells[i].character))) {
+            writeExtendedChar(quint32(cells[i].character));
+        }
+    }
+
+    _lineOffsets.append(_flushedBytes + _buffer.size());
+
+    const quint32 type = LineRecord;
+    const quint32 cellCount = count;
+    _buffer.append(reinterpret_cast<const char *>(&type), sizeof(type));
+    _buffer.append(reinterpret_cast<const char *>(&cellCount), sizeof(cellCount));
+    _buffer.append(reinterpret_cast<const char *>(&property), sizeof(property));
+    _buffer.append(PropertyBytes - int(sizeof(property)), '\0');
+    _buffer.append(reinterpret_cast<const char *>(cells), count * qint64(sizeof(Character)));
+
+    maybeFlush();
+}
+
+void HistorySnapshotWriter::patchBytes(qint64 offset, const char *data, int size)
+{
+    if (offset >= _flushedBytes) {
+        std::memcpy(_buffer.data() + (offset - _flushedBytes), data, size);
+        return;
+    }
+    _file.seek(offset);
+    _file.write(data, size);
+    _file.seek(_flushedBytes);
+}
+
+void HistorySnapshotWriter::setLineProperty(int line, LineProperty property)
+{
+    // @p line counts live lines; skipped records still sit in front
+    const int record = line + _skipLines;
+    if (!isOpen() || line < 0 || record >= _lineOffsets.size()) {
+        return;
+    }
+    // the property sits behind the two leading quint32 of the record
+    patchBytes(_lineOffsets.at(record) + 2 * sizeof(quint32), reinterpret_cast<const char *>(&property), sizeof(property));
+}
+
+void HistorySnapshotWriter::dropFirstLines(int lines)
+{
+    if (!isOpen()) {
+        return;
+    }
+    _skipLines += lines;
+    _headerDirty = true;
+}
+
+void HistorySnapshotWriter::dropLastLine()
+{
+    if (!isOpen() || _lineOffsets.isEmpty()) {
+        return;
+    }
+    const qint64 offset = _lineOffsets.takeLast();
+    if (offset >= _flushedBytes) {
+        _buffer.truncate(offset - _flushedBytes);
+    } else {
+        _file.resize(offset);
+        _file.seek(offset);
+        _flushedBytes = offset;
+        _buffer.clear();
+    }
+}
+
+bool HistorySnapshotWriter::compactionNeeded() const
+{
+    return _skipLines > CompactionMinSkip && _skipLines > (_lineOffsets.size() - _skipLines);
+}
+
+void HistorySnapshotWriter::maybeFlush()
+{
+    if (_buffer.size() >= FlushThreshold) {
+        flush();
+    }
+}
+
+void HistorySnapshotWriter::flush()
+{
+    if (!isOpen()) {
+        return;
+    }
+    if (!_buffer.isEmpty()) {
+        _file.seek(_flushedBytes);
+        _file.write(_buffer);
+        _flushedBytes += _buffer.size();
+        _buffer.clear();
+    }
+    if (_headerDirty) {
+        const quint32 skipLines = _skipLines;
+        patchBytes(SkipLinesOffset, reinterpret_cast<const char *>(&skipLines), sizeof(skipLines));
+        _headerDirty = false;
+    }
+}
+
+bool Konsole::restoreHistorySnapshot(const QString &path, HistoryScroll &scroll, const ExtendedCharTable::pExtendedChars &extendedChars)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() < HeaderBytes) {
+        return false;
+    }
+    const uchar *map = file.map(0, file.size());
+    if (map == nullptr) {
+        return false;
+    }
+    const char *data = reinterpret_cast<const char *>(map);
+    const qint64 size = file.size();
+
+    if (std::memcmp(data, SnapshotMagic, sizeof(SnapshotMagic)) != 0) {
+        return false;
+    }
+    quint32 version;
+    std::memcpy(&version, data + sizeof(SnapshotMagic), sizeof(version));
+    if (version != SnapshotVersion) {
+        return false;
+    }
+    quint32 skipLines;
+    std::memcpy(&skipLines, data + SkipLinesOffset, sizeof(skipLines));
+
+    QHash<quint32, char32_t> keyMap;
+    QVector<Character> remapped;
+
+    qint64 pos = HeaderBytes;
+    while (pos + qint64(sizeof(quint32)) <= size) {
+        quint32 type;
+        std::memcpy(&type, data + pos, sizeof(type));
+        pos += sizeof(type);
+
+        if (type == ExtendedCharRecord) {
+            quint32 key;
+            quint32 charCount;
+            if (pos + qint64(2 * sizeof(quint32)) > size) {
+                return false;
+            }
+            std::memcpy(&key, data + pos, sizeof(key));
+            std::memcpy(&charCount, data + pos + sizeof(key), sizeof(charCount));
+            pos += 2 * sizeof(quint32);
+            if (pos + qint64(charCount) * qint64(sizeof(char32_t)) > size) {
+                return false;
+            }
+            const auto *chars = reinterpret_cast<const char32_t *>(data + pos);
+            pos += qint64(charCount) * sizeof(char32_t);
+            keyMap.insert(key, ExtendedCharTable::instance.createExtendedChar(chars, ushort(charCount), extendedChars));
+        } else if (type == LineRecord) {
+            quint32 cellCount;
+            LineProperty property;
+            if (pos + qint64(sizeof(cellCount)) + PropertyBytes > size) {
+                return false;
+            }
+            std::memcpy(&cellCount, data + pos, sizeof(cellCount));
+            std::memcpy(&property, data + pos + sizeof(cellCount), sizeof(property));
+            pos += sizeof(cellCount) + PropertyBytes;
+            if (pos + qint64(cellCount) * qint64(sizeof(Character)) > size) {
+                return false;
+            }
+            const auto *cells = reinterpret_cast<const Character *>(data + pos);
+            pos += qint64(cellCount) * sizeof(Character);
+
+            if (skipLines > 0) {
+                skipLines--;
+                continue;
+            }
+
+            // the table keys may differ in this process; remap on a copy
+            bool hasExtended = false;
+            for (quint32 i = 0; i < cellCount; i++) {
+                if (cells[i].rendition.f.extended != 0) {
+                    hasExtended = true;
+                    break;
+                }
+            }
+            if (hasExtended) {
+                remapped.resize(cellCount);
+                std::memcpy(remapped.data(), cells, cellCount * sizeof(Character));
+                for (auto &cell : remapped) {
+                    if (cell.rendition.f.extended != 0) {
+                        cell.character = keyMap.value(quint32(cell.character), cell.character);
+                    }
+                }
+                scroll.addCells(remapped.constData(), int(cellCount));
+            } else {
+                scroll.addCells(cells, int(cellCount));
+            }
+            scroll.addLine(property);
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,105 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef HISTORYSNAPSHOT_H
+#define HISTORYSNAPSHOT_H
+
+// Qt
+#include <QFile>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+#include "konsoleprivate_export.h"
+
+// Konsole
+#include "../characters/Character.h"
+#include "../characters/ExtendedCharTable.h"
+
+namespace Konsole
+{
+class HistoryScroll;
+
+/**
+ * Maintains a versioned binary snapshot of a history scroll on disk so a
+ * restored session gets its scrollback back with attributes intact,
+ * without parsing text.
+ *
+ * The file is a small header followed by a stream of records: line
+ * records carry the raw Character cells plus the LineProperty, and an
+ * extended character's sequence is written once as a definition record
+ * before the first line referencing it.  Lines removed from the top only
+ * bump a skip counter in the header; the owner rewrites the snapshot
+ * through rewriteStart()/appendLine() when compactionNeeded() says the
+ * skipped prefix dominates the file.
+ *
+ * Appends are buffered and flushed in chunks, so steady output costs one
+ * sequential write per few hundred lines.
+ */
+class KONSOLEPRIVATE_EXPORT HistorySnapshotWriter
+{
+public:
+    explicit HistorySnapshotWriter(const QString &path);
+    ~HistorySnapshotWriter();
+
+    bool isOpen() const;
+
+    /** Appends one line record (plus any new extended char definitions). */
+    void appendLine(const Character cells[], int count, LineProperty property);
+
+    /** Patches the property of an already written line. */
+    void setLineProperty(int line, LineProperty property);
+
+    /** Marks the oldest @p lines line records as skipped. */
+    void dropFirstLines(int lines);
+
+    /** Removes the newest line record. */
+    void dropLastLine();
+
+    /** True when the skipped prefix is worth rewriting away. */
+    bool compactionNeeded() const;
+
+    /** Truncates the file for a full rewrite via appendLine(). */
+    void rewriteStart();
+
+    /** Writes buffered records and the header out to disk. */
+    void flush();
+
+private:
+    void writeHeader();
+    void writeExtendedChar(quint32 key);
+    void patchBytes(qint64 offset, const char *data, int size);
+    void maybeFlush();
+
+    QFile _file;
+    // bytes already written to the file; everything after sits in _buffer
+    qint64 _flushedBytes = 0;
+    QByteArray _buffer;
+    // start offset of every line record, for property patches and
+    // dropLastLine()
+    QList<qint64> _lineOffsets;
+    int _skipLines = 0;
+    bool _headerDirty = false;
+    QSet<quint32> _writtenExtended;
+};
+
+/**
+ * Replays the snapshot at @p path into @p scroll.  The file is mapped
+ * read-only and lines without extended characters are appended straight
+ * from the mapping; extended character sequences are re-registered with
+ * the global table and their keys remapped.  @p extendedChars is the
+ * usual in-use key collector passed to ExtendedCharTable.
+ *
+ * Returns false (leaving @p scroll untouched or partially filled) when
+ * the file is missing, from a different format version or truncated
+ * mid-record.
+ */
+KONSOLEPRIVATE_EXPORT bool
+restoreHistorySnapshot(const QString &path, HistoryScroll &scroll, const ExtendedCharTable::pExtendedChars &extendedChars);
+
+}
+
+#endif
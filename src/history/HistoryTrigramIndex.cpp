@@ -0,0 +1,220 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "HistoryTrigramIndex.h"
+
+// Konsole characters
+#include <ExtendedCharTable.h>
+
+// Qt
+#include <QChar>
+
+// STD
+#include <algorithm>
+
+using namespace Konsole;
+
+// lazy prefix removal from the posting lists runs once this many dropped
+// line ids have accumulated
+static const int COMPACT_THRESHOLD = 8192;
+
+/**
+ * Appends the codepoints of @p cells to @p out, mirroring
+ * PlainTextDecoder::decodeLine(): extended characters are resolved, the
+ * right half of double-width characters is skipped and trailing
+ * non-real cells are dropped.  The windows built from the result must
+ * line up with the decoded text SearchHistoryTask searches through.
+ */
+static void decodeCells(const Character cells[], int count, QVarLengthArray<char32_t, 256> &out)
+{
+    int realCharacterGuard = -1;
+    for (int i = count - 1; i >= 0; i--) {
+        if ((cells[i].flags & EF_REAL) != 0 && cells[i].character != '\n') {
+            realCharacterGuard = i;
+            break;
+        }
+    }
+
+    for (int i = 0; i < count;) {
+        if (cells[i].rendition.f.extended != 0) {
+            ushort extendedCharLength = 0;
+            const char32_t *chars = ExtendedCharTable::instance.lookupExtendedChar(cells[i].character, extendedCharLength);
+            if (chars != nullptr) {
+                for (uint nchar = 0; nchar < extendedCharLength; nchar++) {
+                    out.append(QChar::toCaseFolded(chars[nchar]));
+                }
+                i += qMax(1, Character::stringWidth(chars, extendedCharLength));
+            } else {
+                ++i;
+            }
+        } else if ((cells[i].flags & EF_REAL) != 0 || i <= realCharacterGuard) {
+            if (cells[i].isRightHalfOfDoubleWide()) {
+                i += 1;
+            } else {
+                out.append(QChar::toCaseFolded(cells[i].character));
+                i += qMax(1, Character::stringWidth(&cells[i].character, 1));
+            }
+        } else {
+            ++i;
+        }
+    }
+}
+
+bool HistoryTrigramIndex::enabled()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("KONSOLE_TRIGRAM_INDEX") == 1;
+    return enabled;
+}
+
+quint32 HistoryTrigramIndex::trigramKey(char32_t a, char32_t b, char32_t c)
+{
+    quint32 key = quint32(a);
+    key = key * 0x9E3779B1u ^ quint32(b);
+    key = key * 0x9E3779B1u ^ quint32(c);
+    return key;
+}
+
+void HistoryTrigramIndex::post(quint32 key, int line)
+{
+    QVector<int> &posting = _postings[key];
+    // lines arrive in increasing order; dropLastLine() may hand an id
+    // out twice, hence the duplicate check
+    if (posting.isEmpty() || posting.last() < line) {
+        posting.append(line);
+    }
+}
+
+void HistoryTrigramIndex::appendLine(const Character cells[], int count)
+{
+    const int line = _nextLine;
+    _nextLine++;
+
+    QVarLengthArray<char32_t, 256> cps;
+    for (const char32_t tailCp : _tail) {
+        cps.append(tailCp);
+    }
+    const int boundary = cps.size();
+    decodeCells(cells, count, cps);
+
+    // windows starting inside the previous line's tail belong to that
+    // line, interior ones to this line
+    for (int i = 0; i + 2 < cps.size(); i++) {
+        post(trigramKey(cps[i], cps[i + 1], cps[i + 2]), i < boundary ? line - 1 : line);
+    }
+
+    _tail.clear();
+    for (int i = qMax(0, cps.size() - 2); i < cps.size(); i++) {
+        _tail.append(cps[i]);
+    }
+}
+
+void HistoryTrigramIndex::dropFirstLines(int lines)
+{
+    _firstLine += lines;
+    if (_firstLine - _compactedBelow > COMPACT_THRESHOLD) {
+        compactPostings();
+    }
+}
+
+void HistoryTrigramIndex::dropLastLine()
+{
+    if (_nextLine > _firstLine) {
+        _nextLine--;
+    }
+    _tail.clear();
+}
+
+void HistoryTrigramIndex::setTail(const Character cells[], int count)
+{
+    QVarLengthArray<char32_t, 256> cps;
+    decodeCells(cells, count, cps);
+
+    _tail.clear();
+    for (int i = qMax(0, cps.size() - 2); i < cps.size(); i++) {
+        _tail.append(cps[i]);
+    }
+}
+
+void HistoryTrigramIndex::clear()
+{
+    _postings.clear();
+    _firstLine = 0;
+    _nextLine = 0;
+    _compactedBelow = 0;
+    _tail.clear();
+}
+
+int HistoryTrigramIndex::lineCount() const
+{
+    return _nextLine - _firstLine;
+}
+
+void HistoryTrigramIndex::compactPostings()
+{
+    for (auto it = _postings.begin(); it != _postings.end();) {
+        QVector<int> &posting = it.value();
+        const auto firstKept = std::lower_bound(posting.begin(), posting.end(), _firstLine);
+        if (firstKept == posting.end()) {
+            it = _postings.erase(it);
+            continue;
+        }
+        posting.erase(posting.begin(), firstKept);
+        ++it;
+    }
+    _compactedBelow = _firstLine;
+}
+
+std::optional<QList<int>> HistoryTrigramIndex::candidateLines(const QString &literal) const
+{
+    // fold the literal into codepoints; these windows must line up with
+    // the ones appendLine() produced
+    QVarLengthArray<char32_t, 8> cps;
+    for (qsizetype i = 0; i < literal.size() && cps.size() < 8; i++) {
+        char32_t cp = literal.at(i).unicode();
+        if (literal.at(i).isHighSurrogate() && i + 1 < literal.size() && literal.at(i + 1).isLowSurrogate()) {
+            cp = QChar::surrogateToUcs4(literal.at(i), literal.at(i + 1));
+            i++;
+        }
+        cps.append(QChar::toCaseFolded(cp));
+    }
+    if (cps.size() < 3) {
+        return std::nullopt;
+    }
+
+    // gather the posting lists; a window that was never posted means no
+    // line can match
+    QVarLengthArray<const QVector<int> *, 6> postings;
+    for (int i = 0; i + 2 < cps.size(); i++) {
+        const auto it = _postings.constFind(trigramKey(cps[i], cps[i + 1], cps[i + 2]));
+        if (it == _postings.constEnd() || it.value().isEmpty()) {
+            return QList<int>{};
+        }
+        postings.append(&it.value());
+    }
+
+    // the first window always sits on the exact start line (straddling
+    // windows are attributed to the line they start on); later windows
+    // may have spilled into the following line
+    QList<int> result;
+    const QVector<int> &seeds = *postings.constFirst();
+    for (auto it = std::lower_bound(seeds.constBegin(), seeds.constEnd(), _firstLine); it != seeds.constEnd(); ++it) {
+        const int line = *it;
+        if (line >= _nextLine) {
+            break;
+        }
+        bool ok = true;
+        for (int p = 1; p < postings.size() && ok; p++) {
+            const QVector<int> &posting = *postings.at(p);
+            ok = std::binary_search(posting.constBegin(), posting.constEnd(), line) //
+                || std::binary_search(posting.constBegin(), posting.constEnd(), line + 1);
+        }
+        if (ok) {
+            result.append(line - _firstLine);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,109 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef HISTORYTRIGRAMINDEX_H
+#define HISTORYTRIGRAMINDEX_H
+
+// Qt
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVarLengthArray>
+#include <QVector>
+
+// STD
+#include <optional>
+
+#include "konsoleprivate_export.h"
+
+// Konsole
+#include "../characters/Character.h"
+
+namespace Konsole
+{
+/**
+ * An incrementally maintained trigram index over the lines of a history
+ * scroll.  SearchHistoryTask consults it to jump straight to candidate
+ * lines instead of running the search expression over the whole decoded
+ * scrollback; opt-in via KONSOLE_TRIGRAM_INDEX=1.
+ *
+ * Every line is decoded the same way PlainTextDecoder does and broken
+ * into overlapping three-codepoint windows (case folded); each window's
+ * hash maps to the sorted list of lines it appears on.  Windows that
+ * straddle a line boundary are built from the remembered tail of the
+ * previous line and attributed to it, so a literal running across a
+ * wrapped-line boundary still leads back to the line it starts on.
+ *
+ * Lookups may return lines that do not actually match (hash collisions,
+ * entries left behind by dropLastLine()); callers verify candidates with
+ * the real search expression.  They must never miss a line a match
+ * starts on.
+ *
+ * Lines are stored as monotonically increasing ids internally so that
+ * trimming the oldest lines only moves an offset; the posting lists are
+ * compacted lazily.
+ */
+class KONSOLEPRIVATE_EXPORT HistoryTrigramIndex
+{
+public:
+    /** Whether index maintenance was requested via KONSOLE_TRIGRAM_INDEX=1. */
+    static bool enabled();
+
+    /** Appends the next line's cells to the index. */
+    void appendLine(const Character cells[], int count);
+
+    /** Forgets the oldest @p lines lines; the remaining lines renumber down. */
+    void dropFirstLines(int lines);
+
+    /**
+     * Forgets the newest line.  The caller restores the new last line's
+     * trailing cells through setTail() so boundary windows keep working;
+     * entries already posted for the dropped line are left behind and
+     * only ever produce extra candidates.
+     */
+    void dropLastLine();
+
+    /** Replaces the remembered tail of the last indexed line. */
+    void setTail(const Character cells[], int count);
+
+    /** Drops everything, ready for a rebuild. */
+    void clear();
+
+    /** Number of lines currently covered by the index. */
+    int lineCount() const;
+
+    /**
+     * Lines on which a match for the plain literal @p literal may start,
+     * in increasing order.  Only windows from the literal's first eight
+     * codepoints are consulted, which keeps the result a superset of the
+     * real start lines as long as lines are at least eight columns wide
+     * (a spill into the following line is tolerated, further ones are
+     * not).  Returns std::nullopt when the literal folds to fewer than
+     * three codepoints; the caller then scans everything.
+     */
+    std::optional<QList<int>> candidateLines(const QString &literal) const;
+
+private:
+    static quint32 trigramKey(char32_t a, char32_t b, char32_t c);
+    void post(quint32 key, int line);
+    void compactPostings();
+
+    QHash<quint32, QVector<int>> _postings;
+
+    // id of the line currently numbered 0, and of the next appended line
+    int _firstLine = 0;
+    int _nextLine = 0;
+
+    // ids below this are already gone from every posting list
+    int _compactedBelow = 0;
+
+    // folded trailing codepoints (at most two) of the last indexed line
+    QVarLengthArray<char32_t, 2> _tail;
+};
+
+}
+
+#endif
@@ -22,7 +22,7 @@ bool HistoryTypeFile::isEnabled() const
 
 void HistoryTypeFile::scroll(std::unique_ptr<HistoryScroll> &old) const
 {
-    if (dynamic_cast<HistoryFile *>(old.get()) != nullptr) {
+    if (dynamic_cast<HistoryScrollFile *>(old.get()) != nullptr) {
         return; // Unchanged.
     }
     auto newScroll = std::make_unique<HistoryScrollFile>();
@@ -9,8 +9,55 @@
 #include "CompactHistoryScroll.h"
 #include "CompactHistoryType.h"
 
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <cstring>
+
 using namespace Konsole;
 
+/**
+ * Run-length encode @p count cells and deflate the result.  Log-ish
+ * content is dominated by runs of blanks and identically-attributed
+ * characters, so the RLE pass alone shrinks most lines considerably and
+ * leaves qCompress with highly regular input.
+ */
+static QByteArray compressCells(const Character *cells, const unsigned int count)
+{
+    QByteArray rle;
+    unsigned int i = 0;
+    while (i < count) {
+        quint32 run = 1;
+        while (i + run < count && memcmp(&cells[i], &cells[i + run], sizeof(Character)) == 0) {
+            run++;
+        }
+        rle.append(reinterpret_cast<const char *>(&run), sizeof(run));
+        rle.append(reinterpret_cast<const char *>(&cells[i]), sizeof(Character));
+        i += run;
+    }
+    return qCompress(rle);
+}
+
+static void decompressCells(const QByteArray &compressed, const unsigned int cellCount, std::vector<Character> &cells)
+{
+    const QByteArray rle = qUncompress(compressed);
+    cells.clear();
+    cells.reserve(cellCount);
+
+    const char *p = rle.constData();
+    const char *const end = p + rle.size();
+    while (p + sizeof(quint32) + sizeof(Character) <= end) {
+        quint32 run;
+        memcpy(&run, p, sizeof(run));
+        p += sizeof(run);
+        Character cell;
+        memcpy(&cell, p, sizeof(cell));
+        p += sizeof(cell);
+        cells.insert(cells.end(), run, cell);
+    }
+}
+
 CompactHistoryScroll::CompactHistoryScroll(const unsigned int maxLineCount)
     : HistoryScroll(new CompactHistoryType(maxLineCount))
     , _maxLineCount(0)
@@ -20,6 +67,32 @@ CompactHistoryScroll::CompactHistoryScroll(const unsigned int maxLineCount)
 
 void CompactHistoryScroll::removeLinesFromTop(size_t lines)
 {
+    firstLinesDropped(lines);
+
+    // Trim the cold tier first; only the skip counter moves, blocks are
+    // dropped whole once fully skipped.
+    while (lines > 0 && !_coldBlocks.empty()) {
+        const size_t blockRemaining = _coldBlocks.front().lineDatas.size() - _coldSkipLines;
+        const size_t removing = qMin(lines, blockRemaining);
+        _coldSkipLines += removing;
+        _coldLineCount -= removing;
+        lines -= removing;
+        if (_coldSkipLines == _coldBlocks.front().lineDatas.size()) {
+            if (_cachedBlock == &_coldBlocks.front()) {
+                _cachedBlock = nullptr;
+            }
+            if (_coldBlocks.front().columns != _reflowColumns && _staleColdBlocks > 0) {
+                _staleColdBlocks--;
+            }
+            _coldBlocks.pop_front();
+            _coldSkipLines = 0;
+        }
+    }
+    rebuildColdStarts();
+    if (lines == 0) {
+        return;
+    }
+
     if (_lineDatas.size() > 1) {
         const unsigned int removing = _lineDatas.at(lines - 1).index;
         _lineDatas.erase(_lineDatas.begin(), _lineDatas.begin() + lines);
@@ -32,41 +105,286 @@ void CompactHistoryScroll::removeLinesFromTop(size_t lines)
     }
 }
 
+int CompactHistoryScroll::dropOldestLines(int keepLines)
+{
+    // only lines already in the compressed cold tier are eligible: the hot
+    // tail (anything the user is likely to scroll back to soon) is never
+    // touched, and dropping cold lines just advances the skip counter
+    const qint64 excess = qint64(getLines()) - qMax(0, keepLines);
+    const qint64 droppable = qMin(excess, qint64(_coldLineCount));
+    if (droppable <= 0) {
+        return 0;
+    }
+    removeLinesFromTop(droppable);
+    return int(droppable);
+}
+
 void CompactHistoryScroll::addCells(const Character a[], const int count)
 {
+    lineAppended(a, count);
+
     _cells.insert(_cells.end(), a, a + count);
 
     // store the (biased) start of next line + default flag
     // the flag is later updated when addLine is called
     _lineDatas.push_back({static_cast<unsigned int>(_cells.size() + _indexBias), LineProperty()});
 
-    if (_lineDatas.size() > _maxLineCount + 1) {
+    if (size_t(getLines()) > _maxLineCount + 1) {
         removeLinesFromTop(1);
     }
+    compressOldestHotLines();
+    reflowStep();
 }
 
 void CompactHistoryScroll::addCellsMove(Character characters[], const int count)
 {
+    lineAppended(characters, count);
+
     std::move(characters, characters + count, std::back_inserter(_cells));
 
     // store the (biased) start of next line + default flag
     // the flag is later updated when addLine is called
     _lineDatas.push_back({static_cast<unsigned int>(_cells.size() + _indexBias), LineProperty()});
 
-    if (_lineDatas.size() > _maxLineCount + 1) {
+    if (size_t(getLines()) > _maxLineCount + 1) {
         removeLinesFromTop(1);
     }
+    compressOldestHotLines();
+    reflowStep();
+}
+
+void CompactHistoryScroll::addLinesMove(QVector<Character> lines[], const LineProperty properties[], int count)
+{
+    for (int i = 0; i < count; i++) {
+        lineAppended(lines[i].constData(), lines[i].size());
+        std::move(lines[i].begin(), lines[i].end(), std::back_inserter(_cells));
+        _lineDatas.push_back({static_cast<unsigned int>(_cells.size() + _indexBias), properties[i]});
+        linePropertyChanged(getLines() - 1, properties[i]);
+    }
+
+    // trim, compress and re-wrap once for the whole batch
+    if (size_t(getLines()) > _maxLineCount + 1) {
+        removeLinesFromTop(size_t(getLines()) - _maxLineCount - 1);
+    }
+    compressOldestHotLines();
+    reflowStep();
 }
 
 void CompactHistoryScroll::addLine(const LineProperty lineProperty)
 {
     auto &flag = _lineDatas.back().flag;
     flag = lineProperty;
+    linePropertyChanged(getLines() - 1, lineProperty);
+}
+
+void CompactHistoryScroll::compressOldestHotLines()
+{
+    while (_lineDatas.size() > HotLineCount + BlockLineCount) {
+        CompressedBlock block;
+        block.lineDatas.assign(_lineDatas.begin(), _lineDatas.begin() + BlockLineCount);
+        const unsigned int blockEnd = block.lineDatas.back().index;
+        block.cellCount = blockEnd - _indexBias;
+        // rebase line ends to the start of the block
+        for (auto &lineData : block.lineDatas) {
+            lineData.index -= _indexBias;
+        }
+
+        // the encoder needs contiguous cells; the deque is not
+        const std::vector<Character> cells(_cells.begin(), _cells.begin() + block.cellCount);
+        block.compressedCells = compressCells(cells.data(), block.cellCount);
+        block.columns = _reflowColumns;
+
+        _coldBlocks.push_back(std::move(block));
+        _coldLineCount += BlockLineCount;
+
+        _lineDatas.erase(_lineDatas.begin(), _lineDatas.begin() + BlockLineCount);
+        _cells.erase(_cells.begin(), _cells.begin() + (blockEnd - _indexBias));
+        _indexBias = blockEnd;
+
+        rebuildColdStarts();
+    }
+}
+
+void CompactHistoryScroll::rebuildColdStarts()
+{
+    _coldBlockStarts.resize(_coldBlocks.size());
+    unsigned int start = 0;
+    for (size_t block = 0; block < _coldBlocks.size(); block++) {
+        _coldBlockStarts[block] = start;
+        start += _coldBlocks[block].lineDatas.size() - (block == 0 ? _coldSkipLines : 0);
+    }
+}
+
+void CompactHistoryScroll::reflowStep()
+{
+    if (_staleColdBlocks == 0) {
+        return;
+    }
+    if (hasLineObservers()) {
+        // a snapshot writer can be enabled while a lazy re-wrap is still
+        // in flight; observers cannot follow the per-block renumbering,
+        // so the remaining blocks keep their old width (mirroring the
+        // re-wrap cap of the file history)
+        _staleColdBlocks = 0;
+        return;
+    }
+
+    // stale blocks form a prefix: every block compressed after the last
+    // reflowLines() call already carries the current width
+    size_t blockIndex = _coldBlocks.size();
+    while (blockIndex > 0 && _coldBlocks[blockIndex - 1].columns == _reflowColumns) {
+        blockIndex--;
+    }
+    if (blockIndex == 0) {
+        _staleColdBlocks = 0;
+        return;
+    }
+    CompressedBlock &block = _coldBlocks[blockIndex - 1];
+
+    // re-wrapping never moves cells, it only recomputes the per-line end
+    // offsets, so the compressed payload stays untouched.  Lines already
+    // skipped off the front block are carried over unchanged.
+    const size_t skip = (blockIndex - 1 == 0) ? _coldSkipLines : 0;
+    std::vector<LineData> fresh = rewrapBlockLines(block.lineDatas, skip, _reflowColumns);
+
+    _coldLineCount += fresh.size() - block.lineDatas.size();
+    block.lineDatas = std::move(fresh);
+    block.columns = _reflowColumns;
+    _staleColdBlocks--;
+    rebuildColdStarts();
+
+    if (size_t(getLines()) > _maxLineCount) {
+        removeLinesFromTop(getLines() - _maxLineCount);
+    }
+}
+
+std::vector<CompactHistoryScroll::LineData> CompactHistoryScroll::rewrapBlockLines(const std::vector<LineData> &old, const size_t skip, const int columns)
+{
+    std::vector<LineData> fresh(old.begin(), old.begin() + skip);
+    fresh.reserve(old.size());
+
+    size_t pos = skip;
+    while (pos < old.size()) {
+        unsigned int startCell = pos == 0 ? 0 : old[pos - 1].index;
+        unsigned int endCell = old[pos].index;
+        LineProperty lineProperty = old[pos].flag;
+
+        // join the lines of a wrapped group within this block
+        while (pos < old.size() - 1 && (old[pos].flag.flags.f.wrapped != 0)) {
+            pos++;
+            endCell = old[pos].index;
+        }
+        const LineProperty lastProperty = old[pos].flag;
+
+        while (endCell - startCell > (unsigned int)(columns) && !(lineProperty.flags.f.doubleheight_bottom | lineProperty.flags.f.doubleheight_top)) {
+            startCell += columns;
+            lineProperty.flags.f.wrapped = 1;
+            fresh.push_back({startCell, lineProperty});
+            lineProperty.resetStarts();
+        }
+        // the last chunk keeps the original continuation flag so a group
+        // running into the next block stays linked
+        lineProperty.flags.f.wrapped = lastProperty.flags.f.wrapped;
+        fresh.push_back({endCell, lineProperty});
+        pos++;
+    }
+    return fresh;
+}
+
+void CompactHistoryScroll::reflowColdBlocks()
+{
+    std::vector<size_t> stale;
+    for (size_t blockIndex = 0; blockIndex < _coldBlocks.size(); blockIndex++) {
+        if (_coldBlocks[blockIndex].columns != _reflowColumns) {
+            stale.push_back(blockIndex);
+        }
+    }
+    _staleColdBlocks = 0;
+    if (stale.empty()) {
+        return;
+    }
+
+    // fan the per-block line table recomputation out over the pool the
+    // history search tasks run on; deque elements are address-stable, so
+    // the workers can reference the blocks directly
+    std::vector<std::vector<LineData>> fresh(stale.size());
+    QSemaphore done;
+    for (size_t job = 0; job < stale.size(); job++) {
+        const CompressedBlock &block = _coldBlocks[stale[job]];
+        const size_t skip = stale[job] == 0 ? _coldSkipLines : 0;
+        const int columns = _reflowColumns;
+        std::vector<LineData> *out = &fresh[job];
+        QThreadPool::globalInstance()->start(QRunnable::create([&block, skip, columns, out, &done]() {
+            *out = rewrapBlockLines(block.lineDatas, skip, columns);
+            done.release();
+        }));
+    }
+    done.acquire(int(stale.size()));
+
+    // serial fixup: swap the recomputed tables in and renumber the block
+    // starts; the compressed payloads (and the decompressed-block cache)
+    // are untouched
+    for (size_t job = 0; job < stale.size(); job++) {
+        CompressedBlock &block = _coldBlocks[stale[job]];
+        _coldLineCount += fresh[job].size() - block.lineDatas.size();
+        block.lineDatas = std::move(fresh[job]);
+        block.columns = _reflowColumns;
+    }
+    rebuildColdStarts();
+}
+
+void CompactHistoryScroll::thawAll()
+{
+    if (_coldBlocks.empty()) {
+        return;
+    }
+
+    CellQueue cells;
+    std::vector<LineData> lineDatas;
+    lineDatas.reserve(_coldLineCount + _lineDatas.size());
+
+    std::vector<Character> blockCells;
+    size_t skip = _coldSkipLines;
+    for (const auto &block : _coldBlocks) {
+        decompressCells(block.compressedCells, block.cellCount, blockCells);
+        const unsigned int skipCells = skip == 0 ? 0 : block.lineDatas.at(skip - 1).index;
+        const unsigned int base = cells.size();
+        cells.insert(cells.end(), blockCells.begin() + skipCells, blockCells.end());
+        for (size_t line = skip; line < block.lineDatas.size(); line++) {
+            lineDatas.push_back({base + block.lineDatas.at(line).index - skipCells, block.lineDatas.at(line).flag});
+        }
+        skip = 0;
+    }
+
+    const unsigned int base = cells.size();
+    cells.insert(cells.end(), _cells.begin(), _cells.end());
+    for (const auto &lineData : _lineDatas) {
+        lineDatas.push_back({base + (lineData.index - _indexBias), lineData.flag});
+    }
+
+    _cells = std::move(cells);
+    _lineDatas = std::move(lineDatas);
+    _indexBias = 0;
+    _coldBlocks.clear();
+    _coldBlockStarts.clear();
+    _coldLineCount = 0;
+    _coldSkipLines = 0;
+    _staleColdBlocks = 0;
+    _cachedBlock = nullptr;
+}
+
+void CompactHistoryScroll::ensureBlockCached(const CompressedBlock &block) const
+{
+    if (_cachedBlock == &block) {
+        return;
+    }
+    decompressCells(block.compressedCells, block.cellCount, _blockCache);
+    _cachedBlock = &block;
 }
 
 int CompactHistoryScroll::getLines() const
 {
-    return _lineDatas.size();
+    return _coldLineCount + _lineDatas.size();
 }
 
 int CompactHistoryScroll::getMaxLines() const
@@ -74,13 +392,32 @@ int CompactHistoryScroll::getMaxLines() const
     return _maxLineCount;
 }
 
+qint64 CompactHistoryScroll::sizeBytes() const
+{
+    qint64 bytes = qint64(_cells.size()) * sizeof(Character);
+    bytes += qint64(_lineDatas.capacity()) * sizeof(LineData);
+    for (const CompressedBlock &block : _coldBlocks) {
+        bytes += block.compressedCells.capacity();
+        bytes += qint64(block.lineDatas.capacity()) * sizeof(LineData);
+    }
+    bytes += qint64(_coldBlockStarts.capacity()) * sizeof(unsigned int);
+    bytes += qint64(_blockCache.capacity()) * sizeof(Character);
+    return bytes;
+}
+
 int CompactHistoryScroll::getLineLen(int lineNumber) const
 {
-    if (size_t(lineNumber) >= _lineDatas.size()) {
+    if (size_t(lineNumber) >= size_t(getLines())) {
         return 0;
     }
 
-    return lineLen(lineNumber);
+    if (isColdLine(lineNumber)) {
+        int lineInBlock;
+        const CompressedBlock &block = coldBlockForLine(lineNumber, lineInBlock);
+        return coldLineLen(block, lineInBlock);
+    }
+
+    return lineLen(lineNumber - int(_coldLineCount));
 }
 
 void CompactHistoryScroll::getCells(const int lineNumber, const int startColumn, const int count, Character buffer[]) const
@@ -88,29 +425,102 @@ void CompactHistoryScroll::getCells(const int lineNumber, const int startColumn,
     if (count == 0) {
         return;
     }
-    Q_ASSERT((size_t)lineNumber < _lineDatas.size());
-
+    Q_ASSERT((size_t)lineNumber < size_t(getLines()));
     Q_ASSERT(startColumn >= 0);
-    Q_ASSERT(startColumn <= lineLen(lineNumber) - count);
 
-    auto startCopy = _cells.begin() + startOfLine(lineNumber) + startColumn;
+    if (isColdLine(lineNumber)) {
+        int lineInBlock;
+        const CompressedBlock &block = coldBlockForLine(lineNumber, lineInBlock);
+        Q_ASSERT(startColumn <= coldLineLen(block, lineInBlock) - count);
+
+        ensureBlockCached(block);
+        auto startCopy = _blockCache.begin() + coldStartOfLine(block, lineInBlock) + startColumn;
+        std::copy(startCopy, startCopy + count, buffer);
+        return;
+    }
+
+    const int hotLine = lineNumber - int(_coldLineCount);
+    Q_ASSERT(startColumn <= lineLen(hotLine) - count);
+
+    auto startCopy = _cells.begin() + startOfLine(hotLine) + startColumn;
     auto endCopy = startCopy + count;
     std::copy(startCopy, endCopy, buffer);
 }
 
+void CompactHistoryScroll::getCellsRange(const int lineno, const int count, const int columns, const Character &pad, Character dest[]) const
+{
+    Q_ASSERT(lineno >= 0 && lineno + count <= getLines());
+
+    int line = lineno;
+    int remaining = count;
+    Character *out = dest;
+
+    // cold tier: walk each block's lines in one go, so a block is looked
+    // up and decompressed once per range instead of once per line
+    while (remaining > 0 && isColdLine(line)) {
+        int lineInBlock;
+        const CompressedBlock &block = coldBlockForLine(line, lineInBlock);
+        ensureBlockCached(block);
+        while (remaining > 0 && size_t(lineInBlock) < block.lineDatas.size()) {
+            const int length = qMin(columns, coldLineLen(block, lineInBlock));
+            const auto src = _blockCache.begin() + coldStartOfLine(block, lineInBlock);
+            std::copy(src, src + length, out);
+            std::fill(out + length, out + columns, pad);
+            out += columns;
+            line++;
+            lineInBlock++;
+            remaining--;
+        }
+    }
+
+    // hot tier: sequential copies out of the cell deque
+    while (remaining > 0) {
+        const int hotLine = line - int(_coldLineCount);
+        const int length = qMin(columns, lineLen(hotLine));
+        const auto src = _cells.begin() + startOfLine(hotLine);
+        std::copy(src, src + length, out);
+        std::fill(out + length, out + columns, pad);
+        out += columns;
+        line++;
+        remaining--;
+    }
+}
+
+void CompactHistoryScroll::prefetchRange(const int lineno, const int count) const
+{
+    if (count <= 0 || lineno < 0 || lineno >= getLines()) {
+        return;
+    }
+
+    // decompressing the cold block covering the page is the whole cost of
+    // reading it later; the hot tier needs no warming
+    if (isColdLine(lineno)) {
+        int lineInBlock;
+        ensureBlockCached(coldBlockForLine(lineno, lineInBlock));
+    }
+}
+
 void CompactHistoryScroll::setMaxNbLines(const int lineCount)
 {
     Q_ASSERT(lineCount >= 0);
     _maxLineCount = lineCount;
 
-    if (_lineDatas.size() > _maxLineCount) {
-        int linesToRemove = _lineDatas.size() - _maxLineCount;
+    if (size_t(getLines()) > _maxLineCount) {
+        int linesToRemove = getLines() - _maxLineCount;
         removeLinesFromTop(linesToRemove);
     }
 }
 
 void CompactHistoryScroll::removeCells()
 {
+    lastLineDropped();
+
+    // Removing from the end may reach into the cold tier when the hot
+    // tail runs out; decompress it then, this only happens on resize.
+    if (_lineDatas.size() <= 1 && !_coldBlocks.empty()) {
+        thawAll();
+    }
+
     if (_lineDatas.size() > 1) {
         /** Here we remove a line from the "end" of the buffers **/
 
@@ -130,24 +540,50 @@ void CompactHistoryScroll::removeCells()
 
 bool CompactHistoryScroll::isWrappedLine(const int lineNumber) const
 {
-    Q_ASSERT((size_t)lineNumber < _lineDatas.size());
-    return (_lineDatas.at(lineNumber).flag.flags.f.wrapped) > 0;
+    return (getLineProperty(lineNumber).flags.f.wrapped) > 0;
 }
 
 LineProperty CompactHistoryScroll::getLineProperty(const int lineNumber) const
 {
-    Q_ASSERT((size_t)lineNumber < _lineDatas.size());
-    return _lineDatas.at(lineNumber).flag;
+    Q_ASSERT((size_t)lineNumber < size_t(getLines()));
+    if (isColdLine(lineNumber)) {
+        int lineInBlock;
+        return coldBlockForLine(lineNumber, lineInBlock).lineDatas.at(lineInBlock).flag;
+    }
+    return _lineDatas.at(lineNumber - int(_coldLineCount)).flag;
 }
 
 void CompactHistoryScroll::setLineProperty(const int lineNumber, LineProperty prop)
 {
-    Q_ASSERT((size_t)lineNumber < _lineDatas.size());
-    _lineDatas.at(lineNumber).flag = prop;
+    Q_ASSERT((size_t)lineNumber < size_t(getLines()));
+    linePropertyChanged(lineNumber, prop);
+    if (isColdLine(lineNumber)) {
+        // line data is stored uncompressed, so no block is re-encoded here
+        int lineInBlock;
+        const size_t block = coldBlockIndexForLine(lineNumber, lineInBlock);
+        _coldBlocks[block].lineDatas.at(lineInBlock).flag = prop;
+        return;
+    }
+    _lineDatas.at(lineNumber - int(_coldLineCount)).flag = prop;
 }
 
 int CompactHistoryScroll::reflowLines(const int columns, std::map<int, int> *deltas)
 {
+    _reflowColumns = columns;
+
+    // Only the hot tail (viewport plus thousands of lines of margin) is
+    // re-wrapped eagerly; cold blocks keep their previous width and are
+    // re-wrapped one per appended line by reflowStep().  The trigram
+    // index and the snapshot writer cannot follow that piecemeal
+    // renumbering, so with either enabled the whole cold tier is
+    // re-wrapped here instead — in parallel, the blocks are independent —
+    // and the single linesRewritten() below covers the observers.
+    if (hasLineObservers()) {
+        reflowColdBlocks();
+    } else {
+        _staleColdBlocks = _coldBlocks.size();
+    }
+
     std::vector<LineData> newLineData;
 
     auto reflowLineLen = [](int start, int end) {
@@ -157,16 +593,17 @@ int CompactHistoryScroll::reflowLines(const int columns, std::map<int, int> *del
         change.push_back({index, flag});
     };
 
+    const int hotLines = int(_lineDatas.size());
     int currentPos = 0;
     int newPos = 0;
     int delta = 0;
-    while (currentPos < getLines()) {
+    while (currentPos < hotLines) {
         int startLine = startOfLine(currentPos);
         int endLine = startOfLine(currentPos + 1);
-        LineProperty lineProperty = getLineProperty(currentPos);
+        LineProperty lineProperty = _lineDatas.at(currentPos).flag;
 
         // Join the lines if they are wrapped
-        while (currentPos < getLines() - 1 && isWrappedLine(currentPos)) {
+        while (currentPos < hotLines - 1 && (_lineDatas.at(currentPos).flag.flags.f.wrapped != 0)) {
             currentPos++;
             endLine = startOfLine(currentPos + 1);
         }
@@ -184,7 +621,7 @@ int CompactHistoryScroll::reflowLines(const int columns, std::map<int, int> *del
         currentPos++;
         newPos++;
         if (deltas && delta != newPos - currentPos) {
-            (*deltas)[currentPos - getLines()] = newPos - currentPos - delta;
+            (*deltas)[currentPos - hotLines] = newPos - currentPos - delta;
             delta = newPos - currentPos;
         }
     }
@@ -197,5 +634,10 @@ int CompactHistoryScroll::reflowLines(const int columns, std::map<int, int> *del
         removeLinesFromTop(deletedLines);
     }
 
+    compressOldestHotLines();
+
+    // every line may have moved or split
+    linesRewritten();
+
     return deletedLines;
 }
@@ -9,8 +9,14 @@
 #define COMPACTHISTORYSCROLL_H
 
 #include "history/HistoryScroll.h"
+#include "history/HistorySlabAllocator.h"
 #include "konsoleprivate_export.h"
+
+#include <QByteArray>
+
+#include <algorithm>
 #include <deque>
+#include <vector>
 
 namespace Konsole
 {
@@ -24,27 +30,57 @@ public:
 
     int getLines() const override;
     int getMaxLines() const override;
+    qint64 sizeBytes() const override;
     int getLineLen(const int lineNumber) const override;
     void getCells(const int lineNumber, const int startColumn, const int count, Character buffer[]) const override;
+    void getCellsRange(const int lineno, const int count, const int columns, const Character &pad, Character dest[]) const override;
+    void prefetchRange(const int lineno, const int count) const override;
     bool isWrappedLine(const int lineNumber) const override;
     LineProperty getLineProperty(const int lineNumber) const override;
     void setLineProperty(const int lineNumber, LineProperty prop) override;
 
     void addCells(const Character a[], const int count) override;
     void addCellsMove(Character characters[], const int count) override;
+    void addLinesMove(QVector<Character> lines[], const LineProperty properties[], int count) override;
     void addLine(const LineProperty lineProperty = LineProperty()) override;
 
     void removeCells() override;
 
+    int dropOldestLines(int keepLines) override;
+
     void setMaxNbLines(const int lineCount);
 
     int reflowLines(const int columns, std::map<int, int> *deltas = nullptr) override;
 
 private:
     /**
-     * This is the actual buffer that contains the cells
+     * Number of recent lines kept uncompressed.  Scrolling within this
+     * window behaves exactly as before; only lines older than this are
+     * moved to the compressed cold tier.
+     */
+    static constexpr size_t HotLineCount = 4096;
+
+    /**
+     * Number of lines compressed together into one cold block.  Blocks
+     * start out exactly this size; lazy re-wrapping (reflowStep()) may
+     * change their line count afterwards, so the line -> block mapping
+     * goes through _coldBlockStarts.
+     */
+    static constexpr size_t BlockLineCount = 1024;
+
+    /**
+     * deque node storage comes from the shared slab pool; the constant
+     * node churn of a busy scroll otherwise fragments the global heap
+     * over long sessions.
+     */
+    using CellQueue = std::deque<Character, HistorySlabAllocator<Character>>;
+
+    /**
+     * This is the actual buffer that contains the cells of the hot tail.
+     * Lines older than HotLineCount are compressed into _coldBlocks and
+     * removed from here.
      */
-    std::deque<Character> _cells;
+    CellQueue _cells;
 
     /**
      * Each entry contains the start of the next line and the current line's
@@ -73,6 +109,61 @@ private:
     std::vector<LineData> _lineDatas;
     unsigned int _indexBias = 0;
 
+    /**
+     * A block of BlockLineCount old lines whose cells are stored
+     * run-length encoded and deflated.  The per-line data stays
+     * uncompressed so line lengths and properties can be read (and
+     * properties written) without touching the cell payload; index here
+     * is the end of the line within the block's uncompressed cells,
+     * without any bias.
+     */
+    struct CompressedBlock {
+        QByteArray compressedCells;
+        std::vector<LineData> lineDatas;
+        unsigned int cellCount;
+        // the wrap width the block's lines were last laid out for; blocks
+        // whose width differs from _reflowColumns still await re-wrapping
+        int columns = 0;
+    };
+
+    /**
+     * The cold tier, oldest block first.  Line numbers below
+     * _coldLineCount resolve here, the rest into _cells/_lineDatas.
+     */
+    std::deque<CompressedBlock> _coldBlocks;
+
+    /**
+     * First visible cold line number of each block, kept in step with
+     * _coldBlocks by rebuildColdStarts(); blocks can have different line
+     * counts once lazy re-wrapping ran, hence the lookup table.
+     */
+    std::vector<unsigned int> _coldBlockStarts;
+
+    /** The wrap width requested by the last reflowLines() call (0 = none yet). */
+    int _reflowColumns = 0;
+
+    /** Number of cold blocks still wrapped for a previous width. */
+    size_t _staleColdBlocks = 0;
+
+    /** Visible lines in the cold tier (excludes skipped ones). */
+    size_t _coldLineCount = 0;
+
+    /**
+     * Lines logically removed from the front of the first cold block.
+     * Trimming the history only advances this counter; the block is
+     * dropped once all of its lines are skipped, so no block is ever
+     * re-encoded.
+     */
+    size_t _coldSkipLines = 0;
+
+    /**
+     * The most recently decompressed block; sequential scrolling through
+     * old history decompresses each block once per visit instead of once
+     * per line.
+     */
+    mutable std::vector<Character> _blockCache;
+    mutable const CompressedBlock *_cachedBlock = nullptr;
+
     /**
      * Max number of lines we can hold
      */
@@ -83,6 +174,78 @@ private:
      */
     void removeLinesFromTop(size_t lines);
 
+    /**
+     * Move full blocks of the oldest hot lines into the cold tier while
+     * the hot tail exceeds HotLineCount + BlockLineCount.
+     */
+    void compressOldestHotLines();
+
+    /**
+     * Decompress the whole cold tier back into the hot buffers; used
+     * before operations that rewrite the cell layout.
+     */
+    void thawAll();
+
+    /**
+     * Re-wraps one stale cold block for the width recorded by the last
+     * reflowLines() call.  The cells of a block never move, only its line
+     * boundaries are recomputed, so one step is cheap; called from
+     * addCells()/addCellsMove() until no stale block remains.
+     */
+    void reflowStep();
+
+    /**
+     * Re-wraps every stale cold block for _reflowColumns at once.  Blocks
+     * are partitioned at unwrapped-line boundaries (groups crossing a
+     * block boundary keep their split there) and share no state, so the
+     * line tables are recomputed in parallel on the global thread pool; a
+     * serial fixup pass then swaps them in and renumbers the block
+     * starts.  Used when a full reflow is unavoidable, i.e. when line
+     * observers cannot follow the lazy piecemeal renumbering.
+     */
+    void reflowColdBlocks();
+
+    /**
+     * Computes the line table of one block re-wrapped for @p columns.
+     * Pure function of its arguments (the cells never move), so it is
+     * safe to run concurrently for different blocks; the first @p skip
+     * lines are carried over unchanged.
+     */
+    static std::vector<LineData> rewrapBlockLines(const std::vector<LineData> &old, const size_t skip, const int columns);
+
+    /** Recomputes _coldBlockStarts after any cold tier change. */
+    void rebuildColdStarts();
+
+    void ensureBlockCached(const CompressedBlock &block) const;
+
+    inline bool isColdLine(const int line) const
+    {
+        return size_t(line) < _coldLineCount;
+    }
+
+    inline size_t coldBlockIndexForLine(const int line, int &lineInBlock) const
+    {
+        const auto it = std::upper_bound(_coldBlockStarts.begin(), _coldBlockStarts.end(), (unsigned int)(line));
+        const size_t block = (it - _coldBlockStarts.begin()) - 1;
+        lineInBlock = line - _coldBlockStarts[block] + (block == 0 ? int(_coldSkipLines) : 0);
+        return block;
+    }
+
+    inline const CompressedBlock &coldBlockForLine(const int line, int &lineInBlock) const
+    {
+        return _coldBlocks[coldBlockIndexForLine(line, lineInBlock)];
+    }
+
+    static inline int coldStartOfLine(const CompressedBlock &block, const int lineInBlock)
+    {
+        return lineInBlock == 0 ? 0 : block.lineDatas.at(lineInBlock - 1).index;
+    }
+
+    static inline int coldLineLen(const CompressedBlock &block, const int lineInBlock)
+    {
+        return block.lineDatas.at(lineInBlock).index - coldStartOfLine(block, lineInBlock);
+    }
+
     inline int lineLen(const int line) const
     {
         return line == 0 ? _lineDatas.at(0).index - _indexBias : _lineDatas.at(line).index - _lineDatas.at(line - 1).index;
@@ -324,6 +324,7 @@ void KeyboardTranslator::addEntry(const Entry &entry)
 {
     const int keyCode = entry.keyCode();
     _entries.insert(keyCode, entry);
+    _resolvedEntries.clear();
 }
 
 void KeyboardTranslator::replaceEntry(const Entry &existing, const Entry &replacement)
@@ -333,22 +334,39 @@ void KeyboardTranslator::replaceEntry(const Entry &existing, const Entry &replac
     }
 
     _entries.insert(replacement.keyCode(), replacement);
+    _resolvedEntries.clear();
 }
 
 void KeyboardTranslator::removeEntry(const Entry &entry)
 {
     _entries.remove(entry.keyCode(), entry);
+    _resolvedEntries.clear();
 }
 
 KeyboardTranslator::Entry KeyboardTranslator::findEntry(int keyCode, Qt::KeyboardModifiers modifiers, States state) const
 {
+    const quint64 key = resolvedKey(keyCode, modifiers, state);
+    const auto cached = _resolvedEntries.constFind(key);
+    if (cached != _resolvedEntries.constEnd()) {
+        return cached.value();
+    }
+
+    Entry result; // Stays null if no entry matches
     auto it = _entries.find(keyCode);
     while (it != _entries.constEnd() && it.key() == keyCode) {
         if (it.value().matches(keyCode, modifiers, state)) {
-            return it.value();
+            result = it.value();
+            break;
         }
         ++it;
     }
 
-    return Entry(); // No matching entry
+    // A keyboard can only produce a bounded set of (key, modifiers, state)
+    // combinations, but guard against synthetic floods anyway
+    if (_resolvedEntries.size() >= 4096) {
+        _resolvedEntries.clear();
+    }
+    _resolvedEntries.insert(key, result);
+
+    return result;
 }
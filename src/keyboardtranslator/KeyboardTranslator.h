@@ -284,8 +284,21 @@ public:
     QList<Entry> entries() const;
 
 private:
+    // Packs a lookup triple into a single hash key. Qt's modifier flags only
+    // occupy the high bits of their word and the state flags fit in the low
+    // six bits, so the combination is collision-free.
+    static quint64 resolvedKey(int keyCode, Qt::KeyboardModifiers modifiers, States state)
+    {
+        return (quint64(quint32(keyCode)) << 32) | quint32(modifiers) | quint32(state);
+    }
+
     // All entries in this translator, indexed by their keycode
     QMultiHash<int, Entry> _entries;
+    // Memoized findEntry() results (including misses), so repeated key
+    // sequences - session broadcast, macro replay - skip the candidate scan
+    // and its modifier/state mask matching. Invalidated whenever the entry
+    // table changes.
+    mutable QHash<quint64, Entry> _resolvedEntries;
 
     QString _name;
     QString _description;
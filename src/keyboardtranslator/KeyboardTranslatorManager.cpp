@@ -13,9 +13,13 @@
 #include "KeyboardTranslatorWriter.h"
 
 // Qt
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QSaveFile>
 #include <QStandardPaths>
 
 using namespace Konsole;
@@ -163,6 +167,105 @@ bool KeyboardTranslatorManager::saveTranslator(const KeyboardTranslator *transla
     return true;
 }
 
+/* Binary cache for parsed keytabs.
+
+   Parsing a .keytab is line-by-line text tokenizing; with many profiles
+   referencing different keytabs it adds up on cold start. The parsed entry
+   table is therefore serialized to the cache directory, keyed by a digest
+   of the keytab source (bundled qrc keytabs have no usable mtime), and
+   reloaded from there on subsequent starts. Any mismatch - missing or
+   truncated cache, format change, edited keytab - falls back to the text
+   parser, which rewrites the cache. */
+
+static const quint32 KeytabCacheMagic = 0x4B595442; // 'KYTB'
+static const quint32 KeytabCacheVersion = 1;
+
+static QString keytabCachePath(const QString &name)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/keytabs/") + name + QStringLiteral(".keytab.cache");
+}
+
+static KeyboardTranslator *loadCachedTranslator(const QString &name, const QByteArray &digest)
+{
+    QFile cache(keytabCachePath(name));
+    if (!cache.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    QDataStream in(&cache);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray cachedDigest;
+    in >> magic >> version >> cachedDigest;
+    if (in.status() != QDataStream::Ok || magic != KeytabCacheMagic || version != KeytabCacheVersion || cachedDigest != digest) {
+        return nullptr;
+    }
+
+    QString description;
+    qint32 entryCount = 0;
+    in >> description >> entryCount;
+    if (in.status() != QDataStream::Ok || entryCount < 0) {
+        return nullptr;
+    }
+
+    auto translator = new KeyboardTranslator(name);
+    translator->setDescription(description);
+    for (qint32 i = 0; i < entryCount; i++) {
+        qint32 keyCode = 0;
+        quint32 modifiers = 0;
+        quint32 modifierMask = 0;
+        quint32 state = 0;
+        quint32 stateMask = 0;
+        quint32 command = 0;
+        QByteArray escapedText;
+        in >> keyCode >> modifiers >> modifierMask >> state >> stateMask >> command >> escapedText;
+        if (in.status() != QDataStream::Ok) {
+            delete translator;
+            return nullptr;
+        }
+
+        KeyboardTranslator::Entry entry;
+        entry.setKeyCode(keyCode);
+        entry.setModifiers(Qt::KeyboardModifiers(modifiers));
+        entry.setModifierMask(Qt::KeyboardModifiers(modifierMask));
+        entry.setState(KeyboardTranslator::States(state));
+        entry.setStateMask(KeyboardTranslator::States(stateMask));
+        entry.setCommand(KeyboardTranslator::Command(command));
+        entry.setText(escapedText);
+        translator->addEntry(entry);
+    }
+
+    return translator;
+}
+
+static void saveCachedTranslator(const KeyboardTranslator *translator, const QByteArray &digest)
+{
+    const QString path = keytabCachePath(translator->name());
+    QDir().mkpath(QFileInfo(path).path());
+
+    QSaveFile cache(path);
+    if (!cache.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream out(&cache);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << KeytabCacheMagic << KeytabCacheVersion << digest;
+    out << translator->description();
+
+    const QList<KeyboardTranslator::Entry> entriesList = translator->entries();
+    out << qint32(entriesList.size());
+    for (const KeyboardTranslator::Entry &entry : entriesList) {
+        // the text goes through the same escaping as the .keytab writer, so
+        // restoring it with setText() round-trips exactly like the text format
+        out << qint32(entry.keyCode()) << quint32(entry.modifiers()) << quint32(entry.modifierMask()) << quint32(entry.state()) << quint32(entry.stateMask())
+            << quint32(entry.command()) << entry.escapedText();
+    }
+
+    cache.commit();
+}
+
 KeyboardTranslator *KeyboardTranslatorManager::loadTranslator(const QString &name)
 {
     const QString &path = findTranslatorPath(name);
@@ -172,7 +275,25 @@ KeyboardTranslator *KeyboardTranslatorManager::loadTranslator(const QString &nam
         return nullptr;
     }
 
-    return loadTranslator(&source, name);
+    const QByteArray content = source.readAll();
+    source.close();
+    const QByteArray digest = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+
+    if (KeyboardTranslator *cached = loadCachedTranslator(name, digest)) {
+        return cached;
+    }
+
+    QBuffer buffer;
+    buffer.setData(content);
+    if (!buffer.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    KeyboardTranslator *translator = loadTranslator(&buffer, name);
+    if (translator != nullptr) {
+        saveCachedTranslator(translator, digest);
+    }
+    return translator;
 }
 
 KeyboardTranslator *KeyboardTranslatorManager::loadTranslator(QIODevice *source, const QString &name)
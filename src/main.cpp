@@ -4,14 +4,11 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
-// To time the creation and total launch time (i. e. until window is
-// visible/responsive):
-// #define PROFILE_STARTUP
-
 // Own
 #include "Application.h"
 #include "KonsoleSettings.h"
 #include "MainWindow.h"
+#include "StartupProfiler.h"
 #include "ViewManager.h"
 #include "config-konsole.h"
 #include "widgets/ViewContainer.h"
@@ -22,6 +19,7 @@
 #include <QDir>
 #include <QProxyStyle>
 #include <QStandardPaths>
+#include <QTimer>
 #include <qplatformdefs.h>
 
 // KDE
@@ -44,12 +42,6 @@
 
 using Konsole::Application;
 
-#ifdef PROFILE_STARTUP
-#include <QDebug>
-#include <QElapsedTimer>
-#include <QTimer>
-#endif
-
 // fill the KAboutData structure with information about contributors to Konsole.
 void fillAboutData(KAboutData &aboutData);
 
@@ -137,10 +129,19 @@ static void migrateRenamedConfigKeys()
 // ***
 int main(int argc, char *argv[])
 {
-#ifdef PROFILE_STARTUP
-    QElapsedTimer timer;
-    timer.start();
-#endif
+    // Enable startup phase reporting as early as possible; the command line
+    // has to be scanned manually here since the parser does not run until
+    // after the QApplication exists (same approach as shouldUseNewProcess()).
+    if (qEnvironmentVariableIsSet("KONSOLE_PROFILE_STARTUP")) {
+        Konsole::StartupProfiler::enable();
+    } else {
+        for (int i = 1; i < argc; i++) {
+            if (qstrcmp(argv[i], "--profile-startup") == 0) {
+                Konsole::StartupProfiler::enable();
+                break;
+            }
+        }
+    }
 
     /**
      * trigger initialisation of proper icon theme
@@ -159,7 +160,18 @@ int main(int argc, char *argv[])
     }
 #endif
 
+    // Experimental, opt-in GPU compositing: let Qt flush the widget backing
+    // store through the RHI instead of a software blit, which offloads the
+    // composition of TerminalDisplay's dirty regions to the GPU on large
+    // high-refresh displays. Painting itself stays on the raster path, so
+    // remote X and software-only setups are unaffected unless they opt in.
+    // Must be decided before the QApplication exists.
+    if (qEnvironmentVariableIntValue("KONSOLE_GPU_COMPOSITING") == 1 && !qEnvironmentVariableIsSet("QT_WIDGETS_RHI")) {
+        qputenv("QT_WIDGETS_RHI", "1");
+    }
+
     auto app = new QApplication(argc, argv);
+    Konsole::StartupProfiler::mark("qapplication-created");
 
 #if HAVE_STYLE_MANAGER
     /**
@@ -211,6 +223,15 @@ int main(int argc, char *argv[])
     parser->process(args);
     about.processCommandLine(parser.data());
 
+    // Queries the sessions of already-running Konsole processes over D-Bus,
+    // so it has to run in the invoking process, before KDBusService would
+    // forward the command line to a resident instance.
+    if (parser->isSet(QStringLiteral("diagnose"))) {
+        const int exitCode = Application::printDiagnostics();
+        delete app;
+        return exitCode;
+    }
+
 #if HAVE_DBUS
     // on wayland: init token if we are launched by Konsole and have none
     if (KWindowSystem::isPlatformWayland() && qEnvironmentVariable("XDG_ACTIVATION_TOKEN").isEmpty() && QDBusConnection::sessionBus().interface()) {
@@ -249,6 +270,7 @@ int main(int argc, char *argv[])
     // Ensure that we only launch a new instance if we need to
     // If there is already an instance running, we will quit here
     KDBusService dbusService(startupOption | KDBusService::NoExitOnFailure);
+    Konsole::StartupProfiler::mark("kdbus-service-registered");
 
     needToDeleteQApplication = false;
 #endif
@@ -256,6 +278,7 @@ int main(int argc, char *argv[])
     // If we reach this location, there was no existing copy of Konsole
     // running, so create a new instance.
     Application konsoleApp(parser, customCommand);
+    Konsole::StartupProfiler::mark("application-created");
 
 #if HAVE_DBUS
     // The activateRequested() signal is emitted when a second instance
@@ -276,12 +299,13 @@ int main(int argc, char *argv[])
         }
     }
 
-#ifdef PROFILE_STARTUP
-    qDebug() << "Construction completed in" << timer.elapsed() << "ms";
-    QTimer::singleShot(0, [&timer]() {
-        qDebug() << "Startup complete in" << timer.elapsed() << "ms";
-    });
-#endif
+    Konsole::StartupProfiler::mark("first-window-created");
+    if (Konsole::StartupProfiler::enabled()) {
+        // runs once the event loop has drained the startup work queue
+        QTimer::singleShot(0, []() {
+            Konsole::StartupProfiler::mark("event-loop-idle");
+        });
+    }
 
     // Since we've allocated the QApplication on the heap for the KDBusService workaround,
     // we need to delete it manually before returning from main().
@@ -6,6 +6,7 @@
 */
 
 #include "filtermodel.h"
+#include "quickcommandsmodel.h"
 
 FilterModel::FilterModel(QObject *parent)
     : QSortFilterProxyModel(parent)
@@ -14,6 +15,21 @@ FilterModel::FilterModel(QObject *parent)
 
 FilterModel::~FilterModel() = default;
 
+void FilterModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+
+    // the cached match set goes stale when commands are added, edited
+    // or removed under an unchanged filter text
+    auto dropCache = [this] {
+        m_cachedFilter.clear();
+        m_cachedMatches.clear();
+    };
+    connect(sourceModel, &QAbstractItemModel::dataChanged, this, dropCache);
+    connect(sourceModel, &QAbstractItemModel::rowsInserted, this, dropCache);
+    connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, dropCache);
+}
+
 bool FilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
 {
     auto text = filterRegularExpression().pattern();
@@ -26,7 +42,19 @@ bool FilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParen
         return true;
     }
 
-    bool result = idx.data(Qt::DisplayRole).toString().toLower().contains(text.toLower());
+    bool result;
+    auto *model = qobject_cast<QuickCommandsModel *>(sourceModel());
+    if (model != nullptr) {
+        // resolve the matches once per filter change; each row is then
+        // a constant time membership test
+        if (m_cachedFilter != text) {
+            m_cachedFilter = text;
+            m_cachedMatches = model->itemsMatching(text);
+        }
+        result = m_cachedMatches.contains(model->itemFromIndex(idx));
+    } else {
+        result = idx.data(Qt::DisplayRole).toString().toLower().contains(text.toLower());
+    }
 
     return m_invertFilter == false ? result : !result;
 }
@@ -7,17 +7,27 @@
 
 #pragma once
 
+#include <QSet>
 #include <QSortFilterProxyModel>
 
+class QStandardItem;
+
 class FilterModel : public QSortFilterProxyModel
 {
     Q_OBJECT
 public:
     explicit FilterModel(QObject *parent);
     ~FilterModel() override;
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
     void setInvertFilter(bool invert);
 
 private:
     bool m_invertFilter = false;
+
+    // accepted items for the current filter text, resolved once per
+    // filter change through the model's trigram index instead of
+    // re-matching every row; cleared whenever the source model changes
+    mutable QString m_cachedFilter;
+    mutable QSet<QStandardItem *> m_cachedMatches;
 };
@@ -8,15 +8,67 @@
 #include <KConfig>
 #include <KConfigGroup>
 
+#include <QPointer>
+#include <QRunnable>
+
+// distinct lowercased three character substrings of a command name
+static QStringList trigramsOf(const QString &text)
+{
+    QStringList grams;
+    for (int i = 0; i + 3 <= text.size(); i++) {
+        const QString gram = text.mid(i, 3);
+        if (!grams.contains(gram)) {
+            grams.append(gram);
+        }
+    }
+    return grams;
+}
+
 QuickCommandsModel::QuickCommandsModel(QObject *parent)
     : QStandardItemModel(parent)
 {
-    load();
+    _savePool.setMaxThreadCount(1);
+
+    // catch removals from the tree view (delete, group moves) so the
+    // trigram index stays in sync and the change is written back
+    connect(this, &QStandardItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &parent, int first, int last) {
+        for (int row = first; row <= last; row++) {
+            QStandardItem *item = parent.isValid() ? itemFromIndex(index(row, 0, parent)) : invisibleRootItem()->child(row);
+            if (item == nullptr) {
+                continue;
+            }
+            if (item->rowCount() > 0) {
+                for (int child = 0, end = item->rowCount(); child < end; child++) {
+                    deindexItem(item->child(child));
+                }
+            } else {
+                deindexItem(item);
+            }
+        }
+    });
+    connect(this, &QStandardItemModel::rowsRemoved, this, &QuickCommandsModel::scheduleSave);
+    // covers in-place group renames made through the view's editor
+    connect(this, &QStandardItemModel::itemChanged, this, &QuickCommandsModel::scheduleSave);
 }
 
 QuickCommandsModel::~QuickCommandsModel() noexcept
 {
-    save();
+    // let an in-flight write finish, then flush anything still pending;
+    // re-writing an already saved state is harmless
+    _savePool.clear();
+    _savePool.waitForDone();
+    if (_dirty) {
+        writeSnapshot(snapshot());
+    }
+}
+
+void QuickCommandsModel::ensureLoaded()
+{
+    if (_loaded) {
+        return;
+    }
+    load();
+    _loaded = true;
 }
 
 void QuickCommandsModel::load()
@@ -38,30 +90,77 @@ void QuickCommandsModel::load()
     }
 }
 
-void QuickCommandsModel::save()
+QVector<QuickCommandsModel::SavedCommand> QuickCommandsModel::snapshot() const
 {
-    auto config = KConfig(QStringLiteral("konsolequickcommandsconfig"), KConfig::OpenFlag::SimpleConfig);
-    const auto groupList = config.groupList();
-    for (const QString &groupName : groupList) {
-        config.deleteGroup(groupName);
-    }
+    QVector<SavedCommand> commands;
     for (int i = 0, end = invisibleRootItem()->rowCount(); i < end; i++) {
         QStandardItem *groupItem = invisibleRootItem()->child(i);
         const QString groupName = groupItem->text();
-        KConfigGroup baseGroup = config.group(groupName);
         for (int j = 0, end2 = groupItem->rowCount(); j < end2; j++) {
-            QStandardItem *item = groupItem->child(j);
-            const auto data = item->data(QuickCommandRole).value<QuickCommandData>();
-            KConfigGroup element = baseGroup.group(data.name);
-            element.writeEntry("name", data.name);
-            element.writeEntry("tooltip", data.tooltip);
-            element.writeEntry("command", data.command);
+            const auto data = groupItem->child(j)->data(QuickCommandRole).value<QuickCommandData>();
+            commands.append({groupName, data.name, data.tooltip, data.command});
         }
     }
+    return commands;
+}
+
+void QuickCommandsModel::writeSnapshot(const QVector<SavedCommand> &commands)
+{
+    auto config = KConfig(QStringLiteral("konsolequickcommandsconfig"), KConfig::OpenFlag::SimpleConfig);
+    const auto groupList = config.groupList();
+    for (const QString &groupName : groupList) {
+        config.deleteGroup(groupName);
+    }
+    for (const SavedCommand &command : commands) {
+        KConfigGroup element = config.group(command.group).group(command.name);
+        element.writeEntry("name", command.name);
+        element.writeEntry("tooltip", command.tooltip);
+        element.writeEntry("command", command.command);
+    }
 
     config.sync();
 }
 
+void QuickCommandsModel::scheduleSave()
+{
+    if (!_loaded) {
+        // items streamed in by load() do not need writing back
+        return;
+    }
+    _dirty = true;
+    if (_saveRunning) {
+        _saveQueued = true;
+        return;
+    }
+    _saveRunning = true;
+
+    // copy the state on the GUI thread, write it out on the pool; the
+    // config file sees either the old or the new store, never a partial
+    const auto commands = std::make_shared<QVector<SavedCommand>>(snapshot());
+    QPointer<QuickCommandsModel> self(this);
+    _savePool.start(QRunnable::create([self, commands] {
+        writeSnapshot(*commands);
+        if (!self) {
+            return;
+        }
+        QMetaObject::invokeMethod(
+            self.data(),
+            [self] {
+                if (!self) {
+                    return;
+                }
+                self->_saveRunning = false;
+                if (self->_saveQueued) {
+                    self->_saveQueued = false;
+                    self->scheduleSave();
+                } else {
+                    self->_dirty = false;
+                }
+            },
+            Qt::QueuedConnection);
+    }));
+}
+
 QStringList QuickCommandsModel::groups() const
 {
     QStringList retList;
@@ -132,12 +231,76 @@ bool QuickCommandsModel::editChildItem(const QuickCommandData &data, const QMode
 
 void QuickCommandsModel::updateItem(QStandardItem *item, const QuickCommandData &data)
 {
+    deindexItem(item);
     item->setData(QVariant::fromValue(data), QuickCommandRole);
     item->setText(data.name);
     if (data.tooltip.trimmed().isEmpty())
         item->setToolTip(data.command);
     else
         item->setToolTip(data.tooltip);
+    indexItem(item);
+    scheduleSave();
+}
+
+void QuickCommandsModel::indexItem(QStandardItem *item)
+{
+    const auto grams = trigramsOf(item->text().toLower());
+    for (const QString &gram : grams) {
+        _trigramIndex.insert(gram, item);
+    }
+}
+
+void QuickCommandsModel::deindexItem(QStandardItem *item)
+{
+    const auto grams = trigramsOf(item->text().toLower());
+    for (const QString &gram : grams) {
+        _trigramIndex.remove(gram, item);
+    }
+}
+
+QSet<QStandardItem *> QuickCommandsModel::itemsMatching(const QString &text) const
+{
+    QSet<QStandardItem *> result;
+    const QString needle = text.toLower();
+    const QStringList grams = trigramsOf(needle);
+
+    if (grams.isEmpty()) {
+        // too short for the index; one or two characters match most of
+        // the store anyway, so a scan does no extra work
+        for (int i = 0, end = invisibleRootItem()->rowCount(); i < end; i++) {
+            QStandardItem *groupItem = invisibleRootItem()->child(i);
+            for (int j = 0, end2 = groupItem->rowCount(); j < end2; j++) {
+                QStandardItem *item = groupItem->child(j);
+                if (item->text().toLower().contains(needle)) {
+                    result.insert(item);
+                }
+            }
+        }
+        return result;
+    }
+
+    // every match carries all of the filter's trigrams, so the rarest
+    // one yields the smallest candidate set to verify
+    QString rarest;
+    int rarestCount = 0;
+    for (const QString &gram : grams) {
+        const int count = _trigramIndex.count(gram);
+        if (count == 0) {
+            return result;
+        }
+        if (rarest.isEmpty() || count < rarestCount) {
+            rarest = gram;
+            rarestCount = count;
+        }
+    }
+
+    const auto candidates = _trigramIndex.values(rarest);
+    for (QStandardItem *item : candidates) {
+        if (item->text().toLower().contains(needle)) {
+            result.insert(item);
+        }
+    }
+    return result;
 }
 
 #include "moc_quickcommandsmodel.cpp"
@@ -5,7 +5,10 @@
 #ifndef QUICKCOMMANDSMODEL_H
 #define QUICKCOMMANDSMODEL_H
 
+#include <QMultiHash>
+#include <QSet>
 #include <QStandardItemModel>
+#include <QThreadPool>
 
 class QuickCommandData;
 
@@ -17,15 +20,63 @@ public:
     explicit QuickCommandsModel(QObject *parent = nullptr);
     ~QuickCommandsModel() override;
 
+    /**
+     * Reads the saved commands on first use.  The store can hold
+     * thousands of shared commands, so it is loaded when the widget or
+     * the quick access bar is first opened instead of at plugin
+     * initialization.
+     */
+    void ensureLoaded();
+
     QStringList groups() const;
     bool addChildItem(const QuickCommandData &data, const QString &groupName);
     bool editChildItem(const QuickCommandData &data, const QModelIndex &idx, const QString &groupName);
 
+    /**
+     * Returns the command items whose name contains @p text, case
+     * insensitively.  For filters of three or more characters the
+     * candidates come from the trigram index, so the cost is
+     * proportional to the number of near-matches rather than to the
+     * size of the store; shorter filters fall back to a linear scan.
+     */
+    QSet<QStandardItem *> itemsMatching(const QString &text) const;
+
 private:
     void load();
-    void save();
+
+    /**
+     * Queues a write of the store on the thread pool, coalescing
+     * changes that arrive while a write is in flight, so saving a
+     * command never blocks the GUI.  Any still unwritten state is
+     * flushed synchronously from the destructor.
+     */
+    void scheduleSave();
+
     void updateItem(QStandardItem *item, const QuickCommandData &data);
     QStandardItem *addTopLevelItem(const QString &groupName);
+
+    // trigram index maintenance for itemsMatching(); only command (leaf)
+    // items are indexed, by their lowercased name
+    void indexItem(QStandardItem *item);
+    void deindexItem(QStandardItem *item);
+
+    // plain copy of one command, safe to hand to the writer thread
+    struct SavedCommand {
+        QString group;
+        QString name;
+        QString tooltip;
+        QString command;
+    };
+    QVector<SavedCommand> snapshot() const;
+    static void writeSnapshot(const QVector<SavedCommand> &commands);
+
+    QMultiHash<QString, QStandardItem *> _trigramIndex;
+    // single writer thread so saves of successive edits cannot reorder
+    QThreadPool _savePool;
+    bool _loaded = false;
+    bool _dirty = false;
+    bool _saveRunning = false;
+    bool _saveQueued = false;
 };
 
 #endif // QUICKCOMMANDSMODEL_H
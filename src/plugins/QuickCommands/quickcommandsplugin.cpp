@@ -97,6 +97,7 @@ void QuickCommandsPlugin::activeViewChanged(Konsole::SessionController *controll
         if (terminalDisplay == nullptr) {
             return;
         }
+        priv->model.ensureLoaded();
         auto bar = new KCommandBar(terminalDisplay->topLevelWidget());
         QList<QAction *> actions;
         for (int i = 0; i < priv->model.rowCount(); i++) {
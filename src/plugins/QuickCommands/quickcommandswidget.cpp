@@ -339,6 +339,10 @@ void QuickCommandsWidget::runShellCheck()
 void QuickCommandsWidget::showEvent(QShowEvent *)
 {
     if (!priv->isSetup) {
+        // the store is only read once the widget is actually opened
+        if (priv->model != nullptr) {
+            priv->model->ensureLoaded();
+        }
         ui->commandsTreeView->expandAll();
         priv->isSetup = true;
     }
@@ -21,6 +21,9 @@ public:
     QString profileName;
     bool useSshConfig = false;
     bool importedFromSshConfig = false;
+    // the ssh config file this entry was imported from, so that a re-parse
+    // of a single file can replace just its own entries
+    QString importedFromFile;
 };
 
 Q_DECLARE_METATYPE(SSHConfigurationData)
@@ -17,8 +17,11 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QLoggingCategory>
+#include <QPointer>
+#include <QRunnable>
 #include <QStandardPaths>
 #include <QTextStream>
+#include <QThreadPool>
 
 #include "profile/ProfileManager.h"
 #include "session/Session.h"
@@ -35,6 +38,105 @@
 namespace
 {
 const QString sshDir = QStandardPaths::writableLocation(QStandardPaths::HomeLocation) + QStringLiteral("/.ssh/");
+
+// Pure parser for ~/.ssh/config; runs on a worker thread, so it must not
+// touch the model or the profile manager. Duplicate filtering and the
+// default profile are applied when the snapshot is merged into the model
+// in SSHManagerModel::finishImport(). Every file that could be opened is
+// recorded in parsedFiles so the model can watch it, and each entry
+// remembers the file its Host line came from.
+void parseSshConfigFile(const QString &file, QVector<SSHConfigurationData> &entries, QStringList &parsedFiles)
+{
+    QFile sshConfig(file);
+    if (!sshConfig.open(QIODevice::ReadOnly)) {
+        qCDebug(SshManagerPluginDebug) << "Can't open config file";
+        return;
+    }
+    parsedFiles.append(file);
+    QTextStream stream(&sshConfig);
+    QString line;
+
+    SSHConfigurationData data;
+
+    // If we hit a *, we ignore till the next Host.
+    bool ignoreEntry = false;
+    while (stream.readLineInto(&line)) {
+        // ignore comments
+        if (line.startsWith(QStringLiteral("#"))) {
+            continue;
+        }
+
+        QStringList lists = line.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        // ignore lines that are not "Type Value"
+        if (lists.count() != 2) {
+            continue;
+        }
+
+        if (lists.at(0) == QStringLiteral("Import")) {
+            if (lists.at(1).contains(QLatin1Char('*'))) {
+                // TODO: We don't handle globbing yet.
+                continue;
+            }
+
+            parseSshConfigFile(sshDir + lists.at(1), entries, parsedFiles);
+            continue;
+        }
+
+        if (lists.at(0) == QStringLiteral("Host")) {
+            if (line.contains(QLatin1Char('*'))) {
+                // Panic, ignore everything until the next Host appears.
+                ignoreEntry = true;
+                continue;
+            } else {
+                ignoreEntry = false;
+            }
+
+            // When we hit this, that means that we just finished reading the
+            // *previous* host. so we need to add it to the list and read the
+            // next value.
+            if (!data.host.isEmpty()) {
+                if (data.name.isEmpty()) {
+                    data.name = data.host;
+                }
+                data.useSshConfig = true;
+                data.importedFromSshConfig = true;
+                data.importedFromFile = file;
+                entries.append(data);
+            }
+
+            data = {};
+            data.host = lists.at(1);
+        }
+
+        if (ignoreEntry) {
+            continue;
+        }
+
+        if (lists.at(0) == QStringLiteral("HostName")) {
+            // hostname is always after Host, so this will be true.
+            const QString currentHost = data.host;
+            data.host = lists.at(1).trimmed();
+            data.name = currentHost.trimmed();
+        } else if (lists.at(0) == QStringLiteral("IdentityFile")) {
+            data.sshKey = lists.at(1).trimmed();
+        } else if (lists.at(0) == QStringLiteral("Port")) {
+            data.port = lists.at(1).trimmed();
+        } else if (lists.at(0) == QStringLiteral("User")) {
+            data.username = lists.at(1).trimmed();
+        }
+    }
+
+    // the last possible read
+    if (data.host.length()) {
+        if (data.name.isEmpty()) {
+            data.name = data.host.trimmed();
+        }
+        data.useSshConfig = true;
+        data.importedFromSshConfig = true;
+        data.importedFromFile = file;
+        entries.append(data);
+    }
+}
 }
 
 SSHManagerModel::SSHManagerModel(QObject *parent)
@@ -50,9 +152,7 @@ SSHManagerModel::SSHManagerModel(QObject *parent)
     }
     if (QFileInfo::exists(sshDir + QStringLiteral("config"))) {
         m_sshConfigWatcher.addPath(sshDir + QStringLiteral("config"));
-        connect(&m_sshConfigWatcher, &QFileSystemWatcher::fileChanged, this, [this] {
-            startImportFromSshConfig();
-        });
+        connect(&m_sshConfigWatcher, &QFileSystemWatcher::fileChanged, this, &SSHManagerModel::handleSshConfigChange);
         startImportFromSshConfig();
     }
 }
@@ -270,6 +370,7 @@ void SSHManagerModel::load()
             data.sshKey = sessionGroup.readEntry("sshkey");
             data.useSshConfig = sessionGroup.readEntry<bool>("useSshConfig", false);
             data.importedFromSshConfig = sessionGroup.readEntry<bool>("importedFromSshConfig", false);
+            data.importedFromFile = sessionGroup.readEntry("importedFromFile");
             addChildItem(data, groupName);
         }
     }
@@ -302,6 +403,7 @@ void SSHManagerModel::save()
             sshGroup.writeEntry("useSshConfig", data.useSshConfig);
             sshGroup.writeEntry("username", data.username);
             sshGroup.writeEntry("importedFromSshConfig", data.importedFromSshConfig);
+            sshGroup.writeEntry("importedFromFile", data.importedFromFile);
         }
     }
 
@@ -328,102 +430,148 @@ void SSHManagerModel::removeIndex(const QModelIndex &idx)
 
 void SSHManagerModel::startImportFromSshConfig()
 {
-    importFromSshConfigFile(sshDir + QStringLiteral("config"));
+    runImport({sshDir + QStringLiteral("config")}, true);
 }
 
-void SSHManagerModel::importFromSshConfigFile(const QString &file)
+void SSHManagerModel::handleSshConfigChange(const QString &path)
 {
-    QFile sshConfig(file);
-    if (!sshConfig.open(QIODevice::ReadOnly)) {
-        qCDebug(SshManagerPluginDebug) << "Can't open config file";
+    // most editors replace the file on save, which drops it from the watcher
+    if (QFileInfo::exists(path)) {
+        m_sshConfigWatcher.addPath(path);
+    }
+
+    if (path == sshDir + QStringLiteral("config")) {
+        // the top level file can add or remove Import lines, re-read everything
+        startImportFromSshConfig();
+    } else {
+        // an imported file changed; only its own entries need replacing
+        runImport({path}, false);
+    }
+}
+
+void SSHManagerModel::runImport(const QStringList &files, bool fullImport)
+{
+    if (m_importRunning) {
+        // something changed while a parse is in flight; coalesce into one
+        // full pass once the current snapshot has been merged
+        m_importQueued = true;
         return;
     }
-    QTextStream stream(&sshConfig);
-    QString line;
+    m_importRunning = true;
 
-    SSHConfigurationData data;
+    if (m_sshConfigTopLevelItem && !m_importProgressItem) {
+        m_importProgressItem = new QStandardItem(i18nc("@item:inlistbox Shown while ~/.ssh/config is parsed in the background", "Importing…"));
+        m_importProgressItem->setEnabled(false);
+        m_sshConfigTopLevelItem->appendRow(m_importProgressItem);
+    }
 
-    // If we hit a *, we ignore till the next Host.
-    bool ignoreEntry = false;
-    while (stream.readLineInto(&line)) {
-        // ignore comments
-        if (line.startsWith(QStringLiteral("#"))) {
-            continue;
+    QPointer<SSHManagerModel> self(this);
+    QThreadPool::globalInstance()->start(QRunnable::create([self, files, fullImport] {
+        // build the snapshot off the GUI thread; it is handed over whole so
+        // the model sees either the old or the new state, never a partial one
+        auto entries = std::make_shared<QVector<SSHConfigurationData>>();
+        auto parsedFiles = std::make_shared<QStringList>();
+        for (const QString &file : files) {
+            parseSshConfigFile(file, *entries, *parsedFiles);
         }
-
-        QStringList lists = line.split(QLatin1Char(' '), Qt::SkipEmptyParts);
-        // ignore lines that are not "Type Value"
-        if (lists.count() != 2) {
-            continue;
+        if (!self) {
+            return;
         }
+        QMetaObject::invokeMethod(
+            self.data(),
+            [self, entries, parsedFiles, fullImport] {
+                if (self) {
+                    self->finishImport(*entries, *parsedFiles, fullImport);
+                }
+            },
+            Qt::QueuedConnection);
+    }));
+}
 
-        if (lists.at(0) == QStringLiteral("Import")) {
-            if (lists.at(1).contains(QLatin1Char('*'))) {
-                // TODO: We don't handle globbing yet.
-                continue;
-            }
+void SSHManagerModel::importFromSshConfigFile(const QString &file)
+{
+    QVector<SSHConfigurationData> entries;
+    QStringList parsedFiles;
+    parseSshConfigFile(file, entries, parsedFiles);
+    finishImport(entries, parsedFiles, false);
+}
 
-            importFromSshConfigFile(sshDir + lists.at(1));
-            continue;
+void SSHManagerModel::finishImport(const QVector<SSHConfigurationData> &entries, const QStringList &parsedFiles, bool fullImport)
+{
+    if (m_importProgressItem && m_sshConfigTopLevelItem) {
+        m_sshConfigTopLevelItem->removeRow(m_importProgressItem->row());
+        m_importProgressItem = nullptr;
+    }
+    m_importRunning = false;
+
+    // entries from these files are replaced wholesale; a full parse also
+    // covers files that were imported last time but have disappeared since
+    QSet<QString> fromFiles(parsedFiles.cbegin(), parsedFiles.cend());
+    if (fullImport) {
+        for (const QString &file : std::as_const(m_importedFiles)) {
+            fromFiles.insert(file);
         }
+    }
+    mergeImportedEntries(fromFiles, entries);
 
-        if (lists.at(0) == QStringLiteral("Host")) {
-            if (line.contains(QLatin1Char('*'))) {
-                // Panic, ignore everything until the next Host appears.
-                ignoreEntry = true;
-                continue;
-            } else {
-                ignoreEntry = false;
+    if (fullImport) {
+        // keep the watcher in sync with the Import graph
+        for (const QString &file : std::as_const(m_importedFiles)) {
+            if (!parsedFiles.contains(file)) {
+                m_sshConfigWatcher.removePath(file);
             }
-
-            // When we hit this, that means that we just finished reading the
-            // *previous* host. so we need to add it to the list, if we can,
-            // and read the next value.
-            if (!data.host.isEmpty() && !hasHost(data.host)) {
-                // We already registered this entity.
-
-                if (data.name.isEmpty()) {
-                    data.name = data.host;
-                }
-                data.useSshConfig = true;
-                data.importedFromSshConfig = true;
-                data.profileName = Konsole::ProfileManager::instance()->defaultProfile()->name();
-                addChildItem(data, i18n("SSH Config"));
+        }
+        for (const QString &file : parsedFiles) {
+            if (!m_sshConfigWatcher.files().contains(file)) {
+                m_sshConfigWatcher.addPath(file);
             }
-
-            data = {};
-            data.host = lists.at(1);
         }
+        m_importedFiles = parsedFiles;
+    }
 
-        if (ignoreEntry) {
-            continue;
-        }
+    if (m_importQueued) {
+        m_importQueued = false;
+        startImportFromSshConfig();
+    }
+}
 
-        if (lists.at(0) == QStringLiteral("HostName")) {
-            // hostname is always after Host, so this will be true.
-            const QString currentHost = data.host;
-            data.host = lists.at(1).trimmed();
-            data.name = currentHost.trimmed();
-        } else if (lists.at(0) == QStringLiteral("IdentityFile")) {
-            data.sshKey = lists.at(1).trimmed();
-        } else if (lists.at(0) == QStringLiteral("Port")) {
-            data.port = lists.at(1).trimmed();
-        } else if (lists.at(0) == QStringLiteral("User")) {
-            data.username = lists.at(1).trimmed();
+void SSHManagerModel::mergeImportedEntries(const QSet<QString> &fromFiles, const QVector<SSHConfigurationData> &entries)
+{
+    if (!m_sshConfigTopLevelItem) {
+        addTopLevelItem(i18nc("@item:inlistbox Hosts from ssh/config file", "SSH Config"));
+    }
+    QStandardItem *folder = m_sshConfigTopLevelItem;
+    if (!folder) {
+        return;
+    }
+
+    // drop what was previously imported from the re-parsed files; entries
+    // edited by hand no longer carry the imported flag and are kept
+    for (int i = folder->rowCount() - 1; i >= 0; i--) {
+        const auto data = folder->child(i)->data(SSHRole).value<SSHConfigurationData>();
+        if (data.importedFromSshConfig && fromFiles.contains(data.importedFromFile)) {
+            folder->removeRow(i);
         }
     }
 
-    // the last possible read
-    if (data.host.length()) {
-        if (!hasHost(data.host)) {
-            if (data.name.isEmpty()) {
-                data.name = data.host.trimmed();
-            }
-            data.useSshConfig = true;
-            data.importedFromSshConfig = true;
-            addChildItem(data, i18n("SSH Config"));
+    for (const SSHConfigurationData &data : entries) {
+        if (hasHost(data.host)) {
+            // We already registered this entity.
+            continue;
+        }
+        SSHConfigurationData entry = data;
+        if (entry.profileName.isEmpty()) {
+            entry.profileName = Konsole::ProfileManager::instance()->defaultProfile()->name();
         }
+        auto newChild = new QStandardItem();
+        newChild->setData(QVariant::fromValue(entry), SSHRole);
+        newChild->setText(entry.name);
+        newChild->setToolTip(i18n("Host: %1", entry.host));
+        folder->appendRow(newChild);
     }
+    // one sort for the whole batch; with thousands of imported hosts the
+    // per-insert sort in addChildItem would dominate
+    folder->sortChildren(0);
 }
 
 void SSHManagerModel::setManageProfile(bool manage)
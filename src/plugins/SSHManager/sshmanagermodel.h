@@ -9,6 +9,7 @@
 #define SSHMANAGERMODEL_H
 
 #include <QFileSystemWatcher>
+#include <QSet>
 #include <QStandardItemModel>
 
 #include <memory>
@@ -49,6 +50,13 @@ public:
 
     Qt::ItemFlags flags(const QModelIndex &index) const override;
 
+    /**
+     * Parses ~/.ssh/config (and every file it imports) on a worker thread
+     * into a snapshot and merges it into the model in one go once done; a
+     * progress placeholder is shown under the SSH Config folder while the
+     * parse runs. Each imported file is watched individually, so editing
+     * one of them only re-parses that file.
+     */
     void startImportFromSshConfig();
     void importFromSshConfigFile(const QString &file);
     void load();
@@ -60,10 +68,22 @@ public:
     bool getManageProfile();
 
 private:
+    void handleSshConfigChange(const QString &path);
+    void runImport(const QStringList &files, bool fullImport);
+    void finishImport(const QVector<SSHConfigurationData> &entries, const QStringList &parsedFiles, bool fullImport);
+    void mergeImportedEntries(const QSet<QString> &fromFiles, const QVector<SSHConfigurationData> &entries);
+
     QStandardItem *m_sshConfigTopLevelItem = nullptr;
+    QStandardItem *m_importProgressItem = nullptr;
     QFileSystemWatcher m_sshConfigWatcher;
     Konsole::Session *m_session = nullptr;
 
+    /** every file the last full parse visited, mirrored into the watcher */
+    QStringList m_importedFiles;
+
+    bool m_importRunning = false;
+    bool m_importQueued = false;
+
     QHash<Konsole::Session *, QString> m_sessionToProfileName;
 
     bool manageProfile = false;
@@ -9,6 +9,7 @@
 
 #include "IKonsolePlugin.h"
 #include "MainWindow.h"
+#include "ViewManager.h"
 #include "konsoledebug.h"
 
 #include <KLocalizedString>
@@ -17,10 +18,21 @@
 
 #include <QAction>
 
+#include <algorithm>
+
 namespace Konsole
 {
 struct PluginManagerPrivate {
+    // discovered but not yet instantiated; represented by placeholder
+    // actions in the Plugins menu until first used
+    std::vector<KPluginMetaData> pendingPlugins;
     std::vector<IKonsolePlugin *> plugins;
+
+    // registered windows and their current plugin submenu, so that the menus
+    // can be rebuilt when a pending plugin is loaded after the fact
+    std::vector<MainWindow *> windows;
+    QHash<MainWindow *, QList<QAction *>> actionsForWindow;
+    QHash<MainWindow *, QHash<QString, QAction *>> placeholderForWindow;
 };
 
 PluginManager::PluginManager()
@@ -47,32 +59,121 @@ void PluginManager::loadAllPlugins()
             return false;
         }
     });
-    for (const auto &metaData : std::as_const(pluginMetaData)) {
-        const KPluginFactory::Result result = KPluginFactory::instantiatePlugin<IKonsolePlugin>(metaData);
-        if (!result) {
-            continue;
-        }
 
-        d->plugins.push_back(result.plugin);
+    // Only the metadata scan happens at startup; instantiating a plugin can
+    // be expensive (SSHManager parses the ssh configuration) and most
+    // sessions never open the plugin docks.
+    for (const auto &metaData : std::as_const(pluginMetaData)) {
+        d->pendingPlugins.push_back(metaData);
     }
 }
 
 void PluginManager::registerMainWindow(Konsole::MainWindow *window)
 {
+    d->windows.push_back(window);
+    connect(window, &QObject::destroyed, this, [this, window] {
+        d->windows.erase(std::remove(d->windows.begin(), d->windows.end(), window), d->windows.end());
+        d->actionsForWindow.remove(window);
+        d->placeholderForWindow.remove(window);
+    });
+
     QList<QAction *> internalPluginSubmenus;
     for (auto *plugin : d->plugins) {
         plugin->addMainWindow(window);
         internalPluginSubmenus.append(plugin->menuBarActions(window));
         window->addPlugin(plugin);
     }
+    for (const auto &metaData : d->pendingPlugins) {
+        internalPluginSubmenus.append(createPlaceholderAction(metaData, window));
+    }
 
-    if (internalPluginSubmenus.isEmpty()) {
+    d->actionsForWindow[window] = internalPluginSubmenus;
+    updatePluginActions(window);
+}
+
+QAction *PluginManager::createPlaceholderAction(const KPluginMetaData &metaData, Konsole::MainWindow *window)
+{
+    // Stand-in menu entry for a plugin that has not been loaded yet; the
+    // first use loads the plugin and replaces this action with the plugin's
+    // own menu entries.
+    auto *action = new QAction(i18nc("@action:inmenu <plugin name>, loads the plugin on first use", "Show %1", metaData.name()), window);
+    const QString pluginId = metaData.pluginId();
+    connect(action, &QAction::triggered, this, [this, pluginId, window] {
+        loadPendingPlugin(pluginId, window);
+    });
+    d->placeholderForWindow[window].insert(pluginId, action);
+    return action;
+}
+
+void PluginManager::loadPendingPlugin(const QString &pluginId, Konsole::MainWindow *triggeringWindow)
+{
+    auto metaIt = std::find_if(d->pendingPlugins.begin(), d->pendingPlugins.end(), [&pluginId](const KPluginMetaData &metaData) {
+        return metaData.pluginId() == pluginId;
+    });
+    if (metaIt == d->pendingPlugins.end()) {
+        return;
+    }
+    const KPluginMetaData metaData = *metaIt;
+    d->pendingPlugins.erase(metaIt);
+
+    const KPluginFactory::Result result = KPluginFactory::instantiatePlugin<IKonsolePlugin>(metaData);
+    IKonsolePlugin *plugin = result ? result.plugin : nullptr;
+    if (plugin) {
+        d->plugins.push_back(plugin);
+    } else {
+        qCWarning(KonsoleDebug) << "Failed to load plugin" << metaData.name() << ":" << result.errorString;
+    }
+
+    const std::vector<MainWindow *> windows = d->windows;
+    for (MainWindow *window : windows) {
+        QAction *placeholder = d->placeholderForWindow[window].take(pluginId);
+        QList<QAction *> &actions = d->actionsForWindow[window];
+        const int placeholderIndex = actions.indexOf(placeholder);
+
+        QList<QAction *> pluginActions;
+        if (plugin) {
+            plugin->addMainWindow(window);
+            window->addPlugin(plugin);
+            pluginActions = plugin->menuBarActions(window);
+        }
+
+        // splice the plugin's real entries in where the placeholder sat, so
+        // the menu keeps its order
+        if (placeholderIndex >= 0) {
+            actions.removeAt(placeholderIndex);
+            for (int i = 0; i < pluginActions.count(); i++) {
+                actions.insert(placeholderIndex + i, pluginActions.at(i));
+            }
+        } else {
+            actions.append(pluginActions);
+        }
+        updatePluginActions(window);
+        delete placeholder;
+
+        // catch the plugin up on the view it missed while unloaded
+        if (plugin) {
+            if (SessionController *controller = window->viewManager()->activeViewController()) {
+                plugin->activeViewChanged(controller, window);
+            }
+        }
+
+        // honor the click that loaded the plugin: both shipped plugins expose
+        // a dock toggle as their first action
+        if (plugin && window == triggeringWindow && !pluginActions.isEmpty()) {
+            pluginActions.first()->trigger();
+        }
+    }
+}
+
+void PluginManager::updatePluginActions(Konsole::MainWindow *window)
+{
+    QList<QAction *> actions = d->actionsForWindow[window];
+    if (actions.isEmpty()) {
         auto *emptyMenuAct = new QAction(i18n("No plugins available"), this);
         emptyMenuAct->setEnabled(false);
-        internalPluginSubmenus.append(emptyMenuAct);
+        actions.append(emptyMenuAct);
     }
-
-    window->setPluginsActions(internalPluginSubmenus);
+    window->setPluginsActions(actions);
 }
 
 std::vector<IKonsolePlugin *> PluginManager::plugins() const
@@ -13,6 +13,9 @@
 #include "konsoleapp_export.h"
 #include <memory>
 
+class QAction;
+class KPluginMetaData;
+
 namespace Konsole
 {
 class IKonsolePlugin;
@@ -26,12 +29,23 @@ class KONSOLEAPP_EXPORT PluginManager : public QObject
 public:
     PluginManager();
     ~PluginManager() override;
+
+    /**
+     * Discovers the available plugins. The plugin libraries themselves are
+     * not loaded here; each plugin is instantiated the first time its menu
+     * entry is used, so unused plugins cost nothing at startup.
+     */
     void loadAllPlugins();
     void registerMainWindow(Konsole::MainWindow *window);
 
+    /** The plugins that have been instantiated so far. */
     std::vector<IKonsolePlugin *> plugins() const;
 
 private:
+    QAction *createPlaceholderAction(const KPluginMetaData &metaData, Konsole::MainWindow *window);
+    void loadPendingPlugin(const QString &pluginId, Konsole::MainWindow *triggeringWindow);
+    void updatePluginActions(Konsole::MainWindow *window);
+
     std::unique_ptr<PluginManagerPrivate> d;
 };
 
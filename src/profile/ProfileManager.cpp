@@ -27,6 +27,7 @@
 #include "ProfileModel.h"
 #include "ProfileReader.h"
 #include "ProfileWriter.h"
+#include "StartupProfiler.h"
 
 Q_LOGGING_CATEGORY(KonsoleProfileDebug, "org.kde.konsole.profile", QtDebugMsg)
 
@@ -70,11 +71,20 @@ ProfileManager::ProfileManager()
         defaultProfileFileName = group.readEntry("DefaultProfile", "");
     }
 
-    loadAllProfiles(defaultProfileFileName);
-    loadShortcuts();
+    // Load only the default profile now so the first window maps without
+    // paying for every .profile in the config dirs; the rest are parsed on
+    // demand the first time the full list is needed (see allProfiles())
+    if (!defaultProfileFileName.isEmpty()) {
+        Profile::Ptr defaultProfile = loadProfile(defaultProfileFileName);
+        if (defaultProfile) {
+            _defaultProfile = defaultProfile;
+        }
+    }
 
     Q_ASSERT(_profiles.size() > 0);
     Q_ASSERT(_defaultProfile);
+
+    StartupProfiler::mark("profile-manager-loaded");
 }
 
 ProfileManager::~ProfileManager() = default;
@@ -90,8 +100,9 @@ ProfileManager::Iterator ProfileManager::findProfile(const Profile::Ptr &profile
     return std::find(_profiles.cbegin(), _profiles.cend(), profile);
 }
 
-ProfileManager::Iterator ProfileManager::nextProfile(const Profile::Ptr &profile) const
+ProfileManager::Iterator ProfileManager::nextProfile(const Profile::Ptr &profile)
 {
+    loadAllProfiles();
     auto next = std::find(_profiles.cbegin(), _profiles.cend(), profile);
     if (next == _profiles.cend()) {
         next = _profiles.cbegin();
@@ -104,8 +115,9 @@ ProfileManager::Iterator ProfileManager::nextProfile(const Profile::Ptr &profile
     return next;
 }
 
-ProfileManager::Iterator ProfileManager::prevProfile(const Profile::Ptr &profile) const
+ProfileManager::Iterator ProfileManager::prevProfile(const Profile::Ptr &profile)
 {
+    loadAllProfiles();
     auto prev = std::find(_profiles.cbegin(), _profiles.cend(), profile);
     if (prev == _profiles.cbegin()) {
         prev = _profiles.cend();
@@ -230,15 +242,21 @@ QStringList ProfileManager::availableProfileNames() const
     return names;
 }
 
-void ProfileManager::loadAllProfiles(const QString &defaultProfileFileName)
+void ProfileManager::loadAllProfiles()
 {
+    if (_loadedAllProfiles) {
+        return;
+    }
+    _loadedAllProfiles = true;
+
     const QStringList &paths = availableProfilePaths();
     for (const QString &path : paths) {
-        Profile::Ptr profile = loadProfile(path);
-        if (profile && !defaultProfileFileName.isEmpty() && path.endsWith(QLatin1Char('/') + defaultProfileFileName)) {
-            _defaultProfile = profile;
-        }
+        loadProfile(path);
     }
+
+    // the shortcut entries reference profiles by name, so they can only be
+    // resolved once every profile is loaded
+    loadShortcuts();
 }
 
 void ProfileManager::saveSettings()
@@ -253,6 +271,7 @@ void ProfileManager::sortProfiles()
 
 QList<Profile::Ptr> ProfileManager::allProfiles()
 {
+    loadAllProfiles();
     sortProfiles();
     return loadedProfiles();
 }
@@ -481,6 +500,10 @@ void ProfileManager::saveShortcuts()
 
 void ProfileManager::setShortcut(Profile::Ptr profile, const QKeySequence &keySequence)
 {
+    // make sure the existing shortcut assignments have been read before
+    // modifying and potentially re-saving them
+    loadAllProfiles();
+
     _profileShortcutsChanged = true;
     QKeySequence existingShortcut = shortcut(profile);
 
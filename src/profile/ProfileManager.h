@@ -162,8 +162,8 @@ public:
      */
     QString generateUniqueName() const;
 
-    Iterator nextProfile(const Profile::Ptr &profile) const;
-    Iterator prevProfile(const Profile::Ptr &profile) const;
+    Iterator nextProfile(const Profile::Ptr &profile);
+    Iterator prevProfile(const Profile::Ptr &profile);
 
 Q_SIGNALS:
 
@@ -196,12 +196,14 @@ private:
     /**
      * Loads all available profiles. This involves reading each
      * profile configuration file from disk and parsing it.
-     * Therefore it should only be done when necessary.
+     * Therefore it is deferred until the full profile list is first
+     * needed; subsequent calls return immediately.
      */
-    void loadAllProfiles(const QString &defaultProfileFileName = {});
+    void loadAllProfiles();
 
     // loads the mappings between shortcut key sequences and
-    // profile paths
+    // profile paths; requires all profiles to be loaded, since the
+    // entries reference profiles by name
     void loadShortcuts();
     // saves the mappings between shortcut key sequences and
     // profile paths
@@ -240,6 +242,10 @@ private:
     // dialog is accepted the profiles shortcut changes are saved
     bool _profileShortcutsChanged = false;
 
+    // Set once loadAllProfiles() has parsed every .profile on disk; until
+    // then only the built-in and default profiles are loaded
+    bool _loadedAllProfiles = false;
+
     KSharedConfigPtr m_config;
 };
 
@@ -181,24 +181,49 @@ bool ConPtyProcess::startProcess(const QString &shellPath,
 
     // this code runned in separate thread
     m_readThread = QThread::create([this]() {
-        // buffers
-        const DWORD BUFF_SIZE{1024};
-        char szBuffer[BUFF_SIZE]{};
+        // ReadFile() lands straight in a thread-private fill buffer which
+        // is handed to the GUI thread by pointer swap whenever the front
+        // buffer is empty, so in the common case each byte is copied only
+        // once between the pipe and the emulation
+        const DWORD ReadChunkSize{128 * 1024};
+        // bounds how far the reader may run ahead of a busy GUI thread,
+        // mirroring the byte budget Session::onReceiveBlock() applies on
+        // the Unix path; the pipe backpressures conhost while we wait
+        const qsizetype BufferHighWater{8 * 1024 * 1024};
+
+        QByteArray fillBuffer;
+        fillBuffer.reserve(ReadChunkSize);
 
         while (true) {
+            const qsizetype filled = fillBuffer.size();
+            fillBuffer.resize(filled + ReadChunkSize);
+
             DWORD dwBytesRead{};
 
             // Read from the pipe
-            BOOL result = ReadFile(m_hPipeIn, szBuffer, BUFF_SIZE, &dwBytesRead, NULL);
+            BOOL result = ReadFile(m_hPipeIn, fillBuffer.data() + filled, ReadChunkSize, &dwBytesRead, NULL);
+            const DWORD readError = result ? ERROR_SUCCESS : GetLastError();
+            fillBuffer.resize(filled + qsizetype(dwBytesRead));
 
-            const bool needMoreData = !result && GetLastError() == ERROR_MORE_DATA;
+            const bool needMoreData = readError == ERROR_MORE_DATA;
             if (result || needMoreData) {
                 QMutexLocker locker(&m_bufferMutex);
-                m_buffer.m_readBuffer.append(szBuffer, dwBytesRead);
+                if (m_buffer.m_readBuffer.isEmpty()) {
+                    m_buffer.m_readBuffer.swap(fillBuffer);
+                } else {
+                    // the GUI thread is behind; queue up behind the
+                    // pending bytes so readAll() stays a single swap
+                    m_buffer.m_readBuffer.append(fillBuffer);
+                    fillBuffer.clear();
+                }
                 m_buffer.emitReadyRead();
+
+                while (m_buffer.m_readBuffer.size() >= BufferHighWater && !QThread::currentThread()->isInterruptionRequested()) {
+                    m_bufferDrained.wait(&m_bufferMutex, 100);
+                }
             }
 
-            const bool brokenPipe = !result && GetLastError() == ERROR_BROKEN_PIPE;
+            const bool brokenPipe = readError == ERROR_BROKEN_PIPE;
             if (QThread::currentThread()->isInterruptionRequested() || brokenPipe)
                 break;
         }
@@ -242,6 +267,7 @@ bool ConPtyProcess::kill()
             CloseHandle(m_hPipeIn);
 
         m_readThread->requestInterruption();
+        m_bufferDrained.wakeAll();
         if (!m_readThread->wait(1000))
             m_readThread->terminate();
         m_readThread->deleteLater();
@@ -294,9 +320,29 @@ QByteArray ConPtyProcess::readAll()
         QMutexLocker locker(&m_bufferMutex);
         result.swap(m_buffer.m_readBuffer);
     }
+    // the read thread may be parked at its high-water mark
+    m_bufferDrained.wakeAll();
     return result;
 }
 
+IPtyProcess::ReadSpan ConPtyProcess::readLease()
+{
+    QMutexLocker locker(&m_bufferMutex);
+    // resize(0) keeps the capacity, so the swap hands the read thread a
+    // preallocated array back and the buffers ping-pong without heap
+    // traffic once they have grown to their working size
+    m_leaseBuffer.resize(0);
+    m_leaseBuffer.swap(m_buffer.m_readBuffer);
+    return {m_leaseBuffer.constData(), int(m_leaseBuffer.size())};
+}
+
+void ConPtyProcess::readAck()
+{
+    // the leased bytes have been consumed; a reader parked at the
+    // high-water mark may continue
+    m_bufferDrained.wakeAll();
+}
+
 qint64 ConPtyProcess::write(const char *data, int size)
 {
     DWORD dwBytesWritten{};
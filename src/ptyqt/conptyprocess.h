@@ -10,6 +10,8 @@
 #include <QMutex>
 #include <QThread>
 #include <QTimer>
+#include <QWaitCondition>
+#include <atomic>
 #include <process.h>
 #include <stdio.h>
 #include <windows.h>
@@ -130,14 +132,23 @@ public:
 
     void emitReadyRead()
     {
-        // for Q_EMIT signal from PtyBuffer own thread
-        QTimer::singleShot(1, this, [this]() {
-            Q_EMIT readyRead();
-        });
+        // coalesced: one queued notification per batch of chunks instead
+        // of a timer hop per chunk; the flag is re-armed on the GUI
+        // thread right before readyRead() is delivered
+        if (m_notifyPending.exchange(true))
+            return;
+        QMetaObject::invokeMethod(
+            this,
+            [this]() {
+                m_notifyPending = false;
+                Q_EMIT readyRead();
+            },
+            Qt::QueuedConnection);
     }
 
 private:
     QByteArray m_readBuffer;
+    std::atomic<bool> m_notifyPending{false};
 };
 
 class ConPtyProcess : public IPtyProcess
@@ -154,6 +165,8 @@ public:
     QString dumpDebugInfo();
     virtual QIODevice *notifier();
     virtual QByteArray readAll();
+    virtual ReadSpan readLease();
+    virtual void readAck();
     virtual qint64 write(const char *data, int size);
     bool isAvailable();
     void moveToThread(QThread *targetThread);
@@ -171,7 +184,13 @@ private:
 
     QThread *m_readThread;
     QMutex m_bufferMutex;
+    // wakes the read thread once readAll() has drained the front buffer
+    // below its high-water mark
+    QWaitCondition m_bufferDrained;
     PtyBuffer m_buffer;
+    // holds the span handed out by readLease() until readAck(); its
+    // storage is recycled into the front buffer on the next lease
+    QByteArray m_leaseBuffer;
 
     bool m_aboutToDestruct{false};
     PROCESS_INFORMATION m_shellProcessInformation{};
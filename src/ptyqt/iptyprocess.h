@@ -20,6 +20,13 @@ class IPtyProcess : public QObject
 public:
     enum PtyType { UnixPty = 0, WinPty = 1, ConPty = 2, AutoPty = 3 };
 
+    // A borrowed view into the backend's receive buffer, valid until the
+    // matching readAck() call; no data is copied
+    struct ReadSpan {
+        const char *data = nullptr;
+        int length = 0;
+    };
+
     IPtyProcess()
         : m_pid(0)
         , m_trace(false)
@@ -39,6 +46,12 @@ public:
     virtual QString dumpDebugInfo() = 0;
     virtual QIODevice *notifier() = 0;
     virtual QByteArray readAll() = 0;
+    // Leases the bytes currently pending in the receive buffer.  The
+    // backend keeps the underlying storage alive and untouched until the
+    // caller signals with readAck() that the span has been consumed, so
+    // the bytes can be fed to the emulation without a per-chunk copy.
+    virtual ReadSpan readLease() = 0;
+    virtual void readAck() = 0;
     virtual qint64 write(const char *data, int size) = 0;
     virtual bool isAvailable() = 0;
     virtual void moveToThread(QThread *targetThread) = 0;
@@ -11,6 +11,7 @@
 #include <QApplication>
 #include <QKeyEvent>
 #include <QModelIndex>
+#include <QSet>
 #include <QSortFilterProxyModel>
 #include <QVBoxLayout>
 
@@ -37,6 +38,21 @@ public:
     {
     }
 
+    void setSourceModel(QAbstractItemModel *model) override
+    {
+        if (model != nullptr) {
+            // a title or cwd changed under the current pattern; the
+            // narrowing memo may be wrong now, rescore everything once
+            connect(model, &QAbstractItemModel::dataChanged, this, [this] {
+                narrowing = false;
+                priorMatches.clear();
+                currentMatches.clear();
+                invalidateRowsFilter();
+            });
+        }
+        QSortFilterProxyModel::setSourceModel(model);
+    }
+
 protected:
     bool lessThan(const QModelIndex &sourceLeft, const QModelIndex &sourceRight) const override
     {
@@ -60,9 +76,13 @@ protected:
             return false;
         }
 
-        QStringView tabNameMatchPattern = pattern;
+        // extending the pattern can only narrow the result set, so rows
+        // rejected by the previous pattern need not be rescored at all
+        if (narrowing && !priorMatches.contains(sourceRow)) {
+            return false;
+        }
 
-        const QString &name = sm->idxToName(sourceRow);
+        QStringView tabNameMatchPattern = pattern;
 
         // dont use the QStringView(QString) ctor
         if (tabNameMatchPattern.isEmpty()) {
@@ -70,10 +90,25 @@ protected:
             return true;
         }
 
+        // match the title and the session working directory, keep the
+        // better of the two scores
+        const QString &name = sm->idxToName(sourceRow);
         auto result = filterByName(QStringView(name.data(), name.size()), tabNameMatchPattern);
 
+        const QString &cwd = sm->idxToCwd(sourceRow);
+        if (!cwd.isEmpty()) {
+            const auto cwdResult = filterByName(QStringView(cwd.data(), cwd.size()), tabNameMatchPattern);
+            if (cwdResult.matched && (!result.matched || cwdResult.score > result.score)) {
+                result = cwdResult;
+            }
+        }
+
         sm->setScoreForIndex(sourceRow, result.score);
 
+        if (result.matched) {
+            currentMatches.insert(sourceRow);
+        }
+
         return result.matched;
     }
 
@@ -81,6 +116,11 @@ public Q_SLOTS:
     bool setFilterText(const QString &text)
     {
         beginResetModel();
+        // reuse the previous pass's survivors when the user just typed
+        // more characters onto the same pattern
+        narrowing = !pattern.isEmpty() && text.startsWith(pattern, Qt::CaseInsensitive);
+        priorMatches = std::move(currentMatches);
+        currentMatches.clear();
         pattern = text;
         endResetModel();
 
@@ -95,6 +135,9 @@ private:
 
 private:
     QString pattern;
+    bool narrowing = false;
+    QSet<int> priorMatches;
+    mutable QSet<int> currentMatches;
 };
 
 /* ------------------------------------------------------------------------- */
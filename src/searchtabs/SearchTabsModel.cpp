@@ -58,12 +58,35 @@ void SearchTabsModel::refresh(ViewManager *viewManager)
     QList<ViewProperties *> viewProperties = viewManager->viewProperties();
 
     QVector<TabEntry> tabs;
+    QHash<int, int> rowForView;
     tabs.reserve(viewProperties.size());
+    rowForView.reserve(viewProperties.size());
     for (const auto view : std::as_const(viewProperties)) {
-        tabs.push_back(TabEntry{view->title(), view->identifier(), -1});
+        rowForView.insert(view->identifier(), tabs.size());
+        tabs.push_back(TabEntry{view->title(), view->currentDir(), view->identifier(), -1});
+
+        // keep the entry current from the event-driven title path while
+        // the search is open
+        connect(view, &ViewProperties::titleChanged, this, &SearchTabsModel::updateEntry, Qt::UniqueConnection);
     }
 
     beginResetModel();
     m_tabEntries = std::move(tabs);
+    m_rowForView = std::move(rowForView);
     endResetModel();
 }
+
+void SearchTabsModel::updateEntry(ViewProperties *view)
+{
+    const auto it = m_rowForView.constFind(view->identifier());
+    if (it == m_rowForView.constEnd()) {
+        return;
+    }
+
+    TabEntry &tab = m_tabEntries[it.value()];
+    tab.name = view->title();
+    tab.cwd = view->currentDir();
+
+    const QModelIndex idx = index(it.value(), 0);
+    Q_EMIT dataChanged(idx, idx);
+}
@@ -19,6 +19,7 @@ namespace Konsole
 
 struct TabEntry {
     QString name;
+    QString cwd;
     int view;
     int score = -1;
 };
@@ -38,6 +39,13 @@ public:
     QVariant data(const QModelIndex &idx, int role) const override;
     void refresh(ViewManager *viewManager);
 
+    /**
+     * Re-reads a single view's title and working directory after its
+     * titleChanged() signal, so the index stays current while the search
+     * is open without rebuilding the whole model.
+     */
+    void updateEntry(ViewProperties *view);
+
     bool isValid(int row) const
     {
         return row >= 0 && row < m_tabEntries.size();
@@ -53,6 +61,11 @@ public:
         return m_tabEntries.at(row).name;
     }
 
+    const QString &idxToCwd(int row) const
+    {
+        return m_tabEntries.at(row).cwd;
+    }
+
     int idxScore(const QModelIndex &idx) const
     {
         if (!idx.isValid()) {
@@ -63,6 +76,12 @@ public:
 
 private:
     QVector<TabEntry> m_tabEntries;
+
+    /**
+     * view identifier -> row, so event-driven title updates touch their
+     * row directly instead of scanning all entries
+     */
+    QHash<int, int> m_rowForView;
 };
 
 }
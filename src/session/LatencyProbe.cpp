@@ -0,0 +1,132 @@
+/*
+    This source file is part of Konsole, a terminal emulator.
+
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "LatencyProbe.h"
+
+// Konsole
+#include "Session.h"
+#include "terminalDisplay/TerminalDisplay.h"
+
+using namespace Konsole;
+
+static const int MinProbeIntervalMsecs = 250;
+// a character plus DEL; see the class documentation
+static const char probePayload[] = "x\177";
+
+LatencyProbe::LatencyProbe(Session *session)
+    : QObject(session)
+    , _session(session)
+{
+    _echoBuckets.fill(0);
+    _paintBuckets.fill(0);
+    _clock.start();
+
+    _timer.setSingleShot(false);
+    connect(&_timer, &QTimer::timeout, this, &LatencyProbe::sendProbe);
+}
+
+void LatencyProbe::start(int intervalMsecs)
+{
+    const QList<TerminalDisplay *> views = _session->views();
+    for (TerminalDisplay *view : views) {
+        connect(view, &TerminalDisplay::paintCompleted, this, &LatencyProbe::notifyPaintCompleted, Qt::UniqueConnection);
+    }
+
+    _timer.start(qMax(intervalMsecs, MinProbeIntervalMsecs));
+}
+
+void LatencyProbe::stop()
+{
+    _timer.stop();
+    _sendNsecs = -1;
+    _awaitingPaintNsecs = -1;
+}
+
+bool LatencyProbe::isActive() const
+{
+    return _timer.isActive();
+}
+
+void LatencyProbe::sendProbe()
+{
+    // the previous probe is still outstanding; another one now would
+    // only measure our own backlog
+    if (_sendNsecs >= 0 || _awaitingPaintNsecs >= 0) {
+        return;
+    }
+
+    _sendNsecs = _clock.nsecsElapsed();
+    _session->sendRawInput(QByteArray(probePayload, 2));
+}
+
+void LatencyProbe::notifyDataReceived()
+{
+    if (_sendNsecs < 0) {
+        return;
+    }
+
+    record(_echoBuckets, _clock.nsecsElapsed() - _sendNsecs);
+    _echoSamples++;
+
+    // keep the original send time so the paint sample is end-to-end
+    _awaitingPaintNsecs = _sendNsecs;
+    _sendNsecs = -1;
+}
+
+void LatencyProbe::notifyPaintCompleted()
+{
+    if (_awaitingPaintNsecs < 0) {
+        return;
+    }
+
+    record(_paintBuckets, _clock.nsecsElapsed() - _awaitingPaintNsecs);
+    _paintSamples++;
+    _awaitingPaintNsecs = -1;
+}
+
+QString LatencyProbe::report() const
+{
+    return QString::asprintf("echo: samples %llu, p50 %lld us, p99 %lld us\nend-to-end: samples %llu, p50 %lld us, p99 %lld us\n",
+                             _echoSamples,
+                             percentile(_echoBuckets, _echoSamples, 0.50),
+                             percentile(_echoBuckets, _echoSamples, 0.99),
+                             _paintSamples,
+                             percentile(_paintBuckets, _paintSamples, 0.50),
+                             percentile(_paintBuckets, _paintSamples, 0.99));
+}
+
+void LatencyProbe::record(Histogram &histogram, qint64 nsecs)
+{
+    const qint64 usecs = nsecs / 1000;
+    int bucket = 0;
+    while (bucket < BucketCount - 1 && (qint64(1) << bucket) <= usecs) {
+        bucket++;
+    }
+    histogram[bucket]++;
+}
+
+qint64 LatencyProbe::percentile(const Histogram &histogram, quint64 samples, double fraction)
+{
+    if (samples == 0) {
+        return 0;
+    }
+
+    const quint64 target = quint64(double(samples) * fraction);
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BucketCount; bucket++) {
+        seen += histogram[bucket];
+        if (seen > target) {
+            // the upper bound of the bucket the sample fell into
+            return bucket == 0 ? 1 : (qint64(1) << bucket);
+        }
+    }
+    return qint64(1) << (BucketCount - 1);
+}
+
+#include "moc_LatencyProbe.cpp"
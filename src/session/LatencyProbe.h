@@ -0,0 +1,89 @@
+/*
+    This source file is part of Konsole, a terminal emulator.
+
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+#include <array>
+
+namespace Konsole
+{
+class Session;
+
+/**
+ * Measures end-to-end input latency for one session by periodically
+ * typing a probe through the normal sendData() path and timing how long
+ * the echo takes to come back from the pty and to reach the screen.
+ *
+ * The payload is a printable character followed by DEL, so both line
+ * editors (which treat DEL as backward-delete-char) and canonical ttys
+ * (where DEL is the usual erase character) leave the input line and the
+ * screen unchanged.  The probe is enabled explicitly per session; against
+ * a full-screen application in raw mode the payload reaches the
+ * application unfiltered, so it is not meant to be left on unattended.
+ *
+ * Two histograms are kept: the pty echo round trip (send until the reply
+ * enters onReceiveBlock()) and end-to-end (send until the first
+ * paintCompleted() after the reply).  Percentiles are exported through
+ * Session's scriptable latencyProbeReport().
+ */
+class LatencyProbe : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LatencyProbe(Session *session);
+
+    /** Starts sending one probe every @p intervalMsecs (clamped to >= 250). */
+    void start(int intervalMsecs);
+
+    /** Stops probing; the collected histograms are kept. */
+    void stop();
+
+    bool isActive() const;
+
+    /** One line per metric: sample count, p50 and p99 in microseconds. */
+    QString report() const;
+
+    /** Called from Session::onReceiveBlock() for every pty read. */
+    void notifyDataReceived();
+
+private Q_SLOTS:
+    void sendProbe();
+    void notifyPaintCompleted();
+
+private:
+    // power-of-two microsecond buckets, the same binning PipelineMetrics
+    // uses: bucket 0 is <1us, bucket i covers [2^(i-1), 2^i) us
+    static const int BucketCount = 24;
+    using Histogram = std::array<quint64, BucketCount>;
+
+    static void record(Histogram &histogram, qint64 nsecs);
+    static qint64 percentile(const Histogram &histogram, quint64 samples, double fraction);
+
+    Session *_session;
+    QTimer _timer{this};
+    QElapsedTimer _clock;
+
+    qint64 _sendNsecs = -1; // probe sent, waiting for the echo
+    qint64 _awaitingPaintNsecs = -1; // send time of the echoed probe, waiting for the next paint
+
+    Histogram _echoBuckets;
+    Histogram _paintBuckets;
+    quint64 _echoSamples = 0;
+    quint64 _paintSamples = 0;
+};
+
+}
+
+#endif // LATENCYPROBE_H
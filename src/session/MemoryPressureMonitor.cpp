@@ -0,0 +1,154 @@
+/*
+    This source file is part of Konsole, a terminal emulator.
+
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "MemoryPressureMonitor.h"
+
+// Qt
+#include <QSocketNotifier>
+
+// Konsole
+#include "KonsoleSettings.h"
+#include "Session.h"
+#include "SessionManager.h"
+#include "SessionMonitorService.h"
+#include "terminalDisplay/TerminalDisplay.h"
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Konsole;
+
+// PSI trigger: notify when memory stalls for a total of 100ms within any
+// 1s window.  "some" pressure (any task stalled) fires well before the
+// OOM killer gets involved, which is the point of trimming early
+static const char PressureTrigger[] = "some 100000 1000000";
+
+// minimum spacing between trim passes; PSI keeps firing while pressure
+// lasts and one pass is meant to be enough for a while
+static constexpr qint64 TrimIntervalMsecs = 10 * 1000;
+
+// sessions focused more recently than this are exempt; trimming the
+// scrollback the user is actively working in would be hostile
+static constexpr qint64 MinIdleMsecs = 60 * 1000;
+
+// stop a trim pass once this much history has been freed
+static constexpr qint64 TrimBudgetBytes = 256ll * 1024 * 1024;
+
+// how often the hibernation sweep looks for long-idle hidden sessions;
+// the idle threshold is measured in hours, so a coarse period is plenty
+static constexpr int HibernationSweepMsecs = 10 * 60 * 1000;
+
+MemoryPressureMonitor::MemoryPressureMonitor()
+{
+    if (KonsoleSettings::sessionHibernation()) {
+        _hibernationTimer.setInterval(HibernationSweepMsecs);
+        connect(&_hibernationTimer, &QTimer::timeout, this, &MemoryPressureMonitor::hibernationSweep);
+        _hibernationTimer.start();
+    }
+#ifdef Q_OS_LINUX
+    if (!KonsoleSettings::memoryPressureTrimming()) {
+        return;
+    }
+    _fd = ::open("/proc/pressure/memory", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (_fd < 0) {
+        return; // kernel without PSI (or it is disabled); stay inert
+    }
+    if (::write(_fd, PressureTrigger, strlen(PressureTrigger) + 1) < 0) {
+        ::close(_fd);
+        _fd = -1;
+        return;
+    }
+    // the kernel signals the trigger as POLLPRI, which Qt surfaces as an
+    // exception condition on the fd
+    _notifier = new QSocketNotifier(_fd, QSocketNotifier::Exception, this);
+    connect(_notifier, &QSocketNotifier::activated, this, &MemoryPressureMonitor::pressureEvent);
+#endif
+}
+
+MemoryPressureMonitor::~MemoryPressureMonitor()
+{
+#ifdef Q_OS_LINUX
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+#endif
+}
+
+Q_GLOBAL_STATIC(MemoryPressureMonitor, theMemoryPressureMonitor)
+MemoryPressureMonitor *MemoryPressureMonitor::instance()
+{
+    return theMemoryPressureMonitor;
+}
+
+void MemoryPressureMonitor::pressureEvent()
+{
+    if (_sinceLastTrim.isValid() && _sinceLastTrim.elapsed() < TrimIntervalMsecs) {
+        return;
+    }
+    _sinceLastTrim.restart();
+    trimIdleSessions();
+}
+
+void MemoryPressureMonitor::trimIdleSessions()
+{
+    const qint64 now = SessionMonitorService::monotonicMs();
+    const int floorLines = qMax(0, KonsoleSettings::memoryPressureFloorLines());
+
+    QList<Session *> candidates;
+    const QList<Session *> sessions = SessionManager::instance()->sessions();
+    for (Session *session : sessions) {
+        if (!session->hasFocus() && now - session->lastFocusedTime() >= MinIdleMsecs) {
+            candidates.append(session);
+        }
+    }
+    // longest unfocused first: their scrollback is the least likely to be
+    // looked at again
+    std::sort(candidates.begin(), candidates.end(), [](Session *a, Session *b) {
+        return a->lastFocusedTime() < b->lastFocusedTime();
+    });
+
+    qint64 freed = 0;
+    for (Session *session : std::as_const(candidates)) {
+        const qint64 before = session->historySizeBytes();
+        if (session->dropOldestHistoryLines(floorLines) > 0) {
+            freed += before - session->historySizeBytes();
+        }
+        if (freed >= TrimBudgetBytes) {
+            break;
+        }
+    }
+}
+
+void MemoryPressureMonitor::hibernationSweep()
+{
+    const qint64 now = SessionMonitorService::monotonicMs();
+    const qint64 idleMsecs = qint64(qMax(1, KonsoleSettings::sessionHibernationHours())) * 60 * 60 * 1000;
+
+    const QList<Session *> sessions = SessionManager::instance()->sessions();
+    for (Session *session : sessions) {
+        if (session->hasFocus() || now - session->lastFocusedTime() < idleMsecs || now - session->lastActivityTime() < idleMsecs) {
+            continue;
+        }
+        // only hidden sessions: a visible pane scrolled into its history
+        // would thaw the snapshot again on the next repaint
+        bool visible = false;
+        const QList<TerminalDisplay *> views = session->views();
+        for (TerminalDisplay *view : views) {
+            visible = visible || view->isVisible();
+        }
+        if (!visible) {
+            session->hibernate();
+        }
+    }
+}
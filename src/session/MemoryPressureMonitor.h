@@ -0,0 +1,73 @@
+/*
+    This source file is part of Konsole, a terminal emulator.
+
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MEMORYPRESSUREMONITOR_H
+#define MEMORYPRESSUREMONITOR_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+class QSocketNotifier;
+
+namespace Konsole
+{
+/**
+ * Process-wide scrollback trimming policy for memory pressure.
+ *
+ * With many long-running sessions the scrollback can hold gigabytes, and
+ * under system memory pressure Konsole is a prime OOM-kill target.  When
+ * enabled (see the MemorySettings page), this service subscribes to the
+ * kernel's PSI memory-pressure interface and, on sustained pressure,
+ * drops the oldest compressed history blocks of unfocused sessions --
+ * longest-unfocused first, ordered by Session::lastFocusedTime() and
+ * measured by Session::historySizeBytes() -- until a trim budget is
+ * freed.  Every session keeps at least the configured floor of recent
+ * lines, and only history backends with a cheap trim (the compact
+ * scroll's cold tier) give anything up.
+ *
+ * Independently of pressure, the service can also hibernate sessions
+ * that have been hidden, unfocused and silent for hours (again see the
+ * MemorySettings page): their scrollback is swapped out to a disk
+ * snapshot and restored transparently on focus or output, so the
+ * resident footprint tracks the active sessions rather than the open
+ * ones.  See Session::hibernate().
+ *
+ * The pressure part is Linux only; without the PSI interface it stays
+ * inert.  Hibernation works everywhere.
+ */
+class KONSOLEPRIVATE_EXPORT MemoryPressureMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    MemoryPressureMonitor();
+    ~MemoryPressureMonitor() override;
+
+    /** Returns the monitor instance. */
+    static MemoryPressureMonitor *instance();
+
+private Q_SLOTS:
+    void pressureEvent();
+    void hibernationSweep();
+
+private:
+    void trimIdleSessions();
+
+    int _fd = -1; // the PSI trigger fd, or -1 when unavailable
+    QSocketNotifier *_notifier = nullptr;
+    QElapsedTimer _sinceLastTrim;
+    QTimer _hibernationTimer;
+};
+}
+
+#endif // MEMORYPRESSUREMONITOR_H
@@ -18,6 +18,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#endif
+
 // Qt
 #include <QApplication>
 #include <QByteArray>
@@ -27,7 +31,10 @@
 #include <QKeyEvent>
 #include <QRandomGenerator>
 #include <QRegularExpression>
+#include <QSocketNotifier>
+#include <QStandardPaths>
 #include <QThread>
+#include <QTimer>
 
 // KDE
 #include <KActionCollection>
@@ -56,17 +63,26 @@
 #endif
 
 #include "KonsoleSettings.h"
+#include "LatencyProbe.h"
 #include "NullProcessInfo.h"
+#include "PipelineMetrics.h"
 #include "Pty.h"
+#include "RawLogStream.h"
 #include "SSHProcessInfo.h"
 #include "SessionController.h"
 #include "SessionGroup.h"
 #include "SessionManager.h"
+#include "SessionMonitorService.h"
 #include "ShellCommand.h"
+#include "StartupProfiler.h"
 #include "Vt102Emulation.h"
 #include "ZModemDialog.h"
+#include "ZModemShuttle.h"
+#include "characters/ExtendedCharTable.h"
 #include "containers/ContainerRegistry.h"
 #include "decoders/PlainTextDecoder.h"
+#include "filterHotSpots/FilterChain.h"
+#include "filterHotSpots/SessionScanCache.h"
 #include "history/HistoryTypeFile.h"
 #include "history/HistoryTypeNone.h"
 #include "history/compact/CompactHistoryType.h"
@@ -117,6 +133,10 @@ void Session::initCommon()
     }
     _sessionId = maxSessionId + 1;
 
+    // never-focused / silent-so-far sessions count as idle since creation
+    _lastFocusedTime = SessionMonitorService::monotonicMs();
+    _lastActivityTime = _lastFocusedTime;
+
 #if HAVE_DBUS
     // prepare DBus communication
     new SessionAdaptor(this);
@@ -129,8 +149,8 @@ void Session::initCommon()
 
     connect(_emulation, &Konsole::Emulation::sessionAttributeChanged, this, &Konsole::Session::setSessionAttribute);
     connect(_emulation, &Konsole::Emulation::osc777Received, this, &Konsole::Session::handleOsc777);
-    connect(_emulation, &Konsole::Emulation::bell, this, [this]() {
-        Q_EMIT bellRequest(i18n("Bell in '%1' (Session '%2')", _displayTitle, _nameTitle));
+    connect(_emulation, &Konsole::Emulation::bell, this, [this](int count) {
+        Q_EMIT bellRequest(i18np("Bell in '%2' (Session '%3')", "%1 bells in '%2' (Session '%3')", count, _displayTitle, _nameTitle));
         this->setPendingNotification(Notification::Bell);
     });
     connect(_emulation, &Konsole::Emulation::zmodemDownloadDetected, this, &Konsole::Session::fireZModemDownloadDetected);
@@ -141,15 +161,21 @@ void Session::initCommon()
     connect(_emulation, &Konsole::Emulation::selectionChanged, this, &Konsole::Session::selectionChanged);
     connect(_emulation, &Konsole::Emulation::imageResizeRequest, this, &Konsole::Session::resizeRequest);
     connect(_emulation, &Konsole::Emulation::sessionAttributeRequest, this, &Konsole::Session::sessionAttributeRequest);
+    connect(_emulation, &Konsole::Emulation::commandExecutionStarted, this, [this]() {
+        _commandRunning = true;
+        _commandStartBytes = _ptyBytesReceived;
+        _commandTimer.start();
+    });
+    connect(_emulation, &Konsole::Emulation::commandExecutionFinished, this, [this](int exitCode) {
+        if (!_commandRunning) {
+            return;
+        }
+        _commandRunning = false;
+        _lastCommandDurationMsecs = _commandTimer.elapsed();
+        _lastCommandOutputBytes = _ptyBytesReceived - _commandStartBytes;
+        _lastCommandExitCode = exitCode;
+    });
 
-    // setup timer for monitoring session activity & silence
-    _silenceTimer = new QTimer(this);
-    _silenceTimer->setSingleShot(true);
-    connect(_silenceTimer, &QTimer::timeout, this, &Konsole::Session::silenceTimerDone);
-
-    _activityTimer = new QTimer(this);
-    _activityTimer->setSingleShot(true);
-    connect(_activityTimer, &QTimer::timeout, this, &Konsole::Session::activityTimerDone);
 }
 
 Session::Session(QObject *parent)
@@ -181,8 +207,22 @@ Session::Session(NoPtyTag, QObject *parent)
 
 Session::~Session()
 {
+    if (SessionMonitorService *service = SessionMonitorService::instance()) {
+        service->unregisterSession(this);
+    }
+#ifdef Q_OS_LINUX
+    if (_foregroundPidfd >= 0) {
+        ::close(_foregroundPidfd);
+    }
+#endif
+    qDeleteAll(_foregroundProcessInfoCache);
     delete _foregroundProcessInfo;
     delete _sessionProcessInfo;
+#ifndef Q_OS_WIN
+    // the shuttle's destructor joins its thread; do that before the pty
+    // closes the master fd the worker is polling
+    delete _zmodemShuttle;
+#endif
     // kill process before emulation, e.g. QProcess::finished will use _emulation in some cases
     delete _shellProcess;
     delete _emulation;
@@ -309,6 +349,103 @@ QByteArray Session::codec()
     return _emulation->encoder().name();
 }
 
+qlonglong Session::historySizeBytes() const
+{
+    return _emulation->historySizeBytes();
+}
+
+int Session::dropOldestHistoryLines(int keepLines)
+{
+    return _emulation->dropOldestHistoryLines(keepLines);
+}
+
+bool Session::hasFocus() const
+{
+    return _hasFocus;
+}
+
+qint64 Session::lastFocusedTime() const
+{
+    return _lastFocusedTime;
+}
+
+qint64 Session::lastActivityTime() const
+{
+    return _lastActivityTime;
+}
+
+bool Session::hibernate()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/hibernation");
+    if (!QDir().mkpath(dir)) {
+        return false;
+    }
+    return _emulation->hibernateHistory(dir + QLatin1Char('/') + _uniqueIdentifier.toString(QUuid::WithoutBraces) + QStringLiteral(".khist"));
+}
+
+void Session::onViewFocusChanged(bool focused)
+{
+    _hasFocus = focused;
+    _lastFocusedTime = SessionMonitorService::monotonicMs();
+    if (focused) {
+        // restore a hibernated scrollback before the user scrolls into it
+        _emulation->thawHistory();
+    }
+}
+
+qlonglong Session::screenBufferSizeBytes() const
+{
+    return _emulation->screenBufferSizeBytes();
+}
+
+qlonglong Session::extendedCharTableSizeBytes() const
+{
+    return ExtendedCharTable::instance.sizeBytes();
+}
+
+qlonglong Session::hotSpotCacheSize() const
+{
+    qlonglong hotSpots = 0;
+    for (TerminalDisplay *view : std::as_const(_views)) {
+        hotSpots += view->filterChain()->hotSpots().count();
+    }
+    return hotSpots;
+}
+
+qlonglong Session::ptyBytesReceived() const
+{
+    return _ptyBytesReceived;
+}
+
+qlonglong Session::lastCommandDuration() const
+{
+    return _lastCommandDurationMsecs;
+}
+
+qlonglong Session::lastCommandOutputBytes() const
+{
+    return _lastCommandOutputBytes;
+}
+
+int Session::lastCommandExitCode() const
+{
+    return _lastCommandExitCode;
+}
+
+QString Session::diagnostics() const
+{
+    // one "key: value" pair per line, consumed by `konsole --diagnose`
+    QString report;
+    report += QStringLiteral("title: %1\n").arg(title(NameRole));
+    report += QStringLiteral("process id: %1\n").arg(processId());
+    report += QStringLiteral("history bytes: %1\n").arg(historySizeBytes());
+    report += QStringLiteral("screen buffer bytes: %1\n").arg(screenBufferSizeBytes());
+    report += QStringLiteral("extended char table bytes (process-wide): %1\n").arg(extendedCharTableSizeBytes());
+    report += QStringLiteral("cached hotspots: %1\n").arg(hotSpotCacheSize());
+    report += QStringLiteral("pty bytes received: %1").arg(ptyBytesReceived());
+    return report;
+}
+
 void Session::setProgram(const QString &program)
 {
     _program = ShellCommand::expand(program);
@@ -379,6 +516,10 @@ void Session::addView(TerminalDisplay *widget)
 
     widget->setUsesMouseTracking(_emulation->programUsesMouseTracking());
 
+    // retain the rendered primary screen while fullscreen applications use
+    // the alternate screen, so leaving them restores it with one blit
+    connect(_emulation, &Konsole::Emulation::primaryScreenInUse, widget, &Konsole::TerminalDisplay::setUsesPrimaryScreen);
+
     connect(_emulation, &Konsole::Emulation::enableAlternateScrolling, widget->scrollBar(), &Konsole::TerminalScrollBar::setAlternateScrolling);
 
     connect(_emulation, &Konsole::Emulation::programBracketedPasteModeChanged, widget, &Konsole::TerminalDisplay::setBracketedPasteMode);
@@ -387,6 +528,13 @@ void Session::addView(TerminalDisplay *widget)
 
     widget->setScreenWindow(_emulation->createWindow());
 
+    // all views of this session share one filter-scan cache, so split
+    // views showing the same content decode and scan it once
+    if (_scanCache.isNull()) {
+        _scanCache = QSharedPointer<SessionScanCache>::create();
+    }
+    widget->setSessionScanCache(_scanCache);
+
     _emulation->setCurrentTerminalDisplay(widget);
 
     // connect view signals and slots
@@ -395,6 +543,7 @@ void Session::addView(TerminalDisplay *widget)
     connect(widget, &Konsole::TerminalDisplay::destroyed, this, &Konsole::Session::viewDestroyed);
 
     connect(widget, &Konsole::TerminalDisplay::compositeFocusChanged, _emulation, &Konsole::Emulation::focusChanged);
+    connect(widget, &Konsole::TerminalDisplay::compositeFocusChanged, this, &Konsole::Session::onViewFocusChanged);
 
     connect(_emulation, &Konsole::Emulation::setCursorStyleRequest, widget, &Konsole::TerminalDisplay::setCursorStyle);
     connect(_emulation, &Konsole::Emulation::resetCursorStyleRequest, widget, &Konsole::TerminalDisplay::resetCursorStyle);
@@ -415,6 +564,18 @@ void Session::removeView(TerminalDisplay *widget)
 {
     _views.removeAll(widget);
 
+    // the focusOut of a view removed while focused is never delivered
+    // here, so recheck the remaining views
+    if (_hasFocus) {
+        bool stillFocused = false;
+        for (TerminalDisplay *view : std::as_const(_views)) {
+            stillFocused = stillFocused || view->hasCompositeFocus();
+        }
+        if (!stillFocused) {
+            onViewFocusChanged(false);
+        }
+    }
+
     disconnect(widget, nullptr, this, nullptr);
 
     // disconnect
@@ -428,6 +589,8 @@ void Session::removeView(TerminalDisplay *widget)
     // disconnect state change signals emitted by emulation
     disconnect(_emulation, nullptr, widget, nullptr);
 
+    widget->setSessionScanCache(QSharedPointer<SessionScanCache>());
+
     // Close the session automatically when the last view is removed,
     // unless the session lifecycle is managed externally (e.g. by TmuxPaneManager).
     if (_views.count() == 0 && _paneSyncPolicy == PaneSyncPolicy::Independent) {
@@ -525,6 +688,8 @@ static QStringList postProcessArgs(const QStringList &contextArgs, const QString
 
 void Session::run()
 {
+    StartupProfiler::mark("first-session-run");
+
     // FIXME: run() is called twice in some instances
     if (isRunning()) {
         qCDebug(KonsoleDebug) << "Attempted to re-run an already running session (" << processId() << ")";
@@ -542,6 +707,26 @@ void Session::run()
         _uniqueIdentifier = QUuid::createUuid();
     }
 
+    // opt-in persistent scrollback: one snapshot file per session,
+    // keyed by the guid saveSession()/restoreSession() round-trips
+    const QString snapshotDir = QString::fromLocal8Bit(qgetenv("KONSOLE_HISTORY_SNAPSHOT_DIR"));
+    if (!snapshotDir.isEmpty()) {
+        _emulation->setHistorySnapshot(snapshotDir + QLatin1Char('/') + _uniqueIdentifier.toString(QUuid::WithoutBraces) + QStringLiteral(".khist"));
+    }
+
+    // opt-in raw output logging, e.g. for compliance setups: one
+    // append-only file per session, written off the GUI thread
+    const QString rawLogDir = QString::fromLocal8Bit(qgetenv("KONSOLE_RAW_LOG_DIR"));
+    if (!rawLogDir.isEmpty() && _rawLogStream == nullptr) {
+        startRawLog(rawLogDir + QLatin1Char('/') + _uniqueIdentifier.toString(QUuid::WithoutBraces) + QStringLiteral(".log"));
+    }
+
+    // opt-in always-on recording for postmortems, one asciicast per session
+    const QString recordingDir = QString::fromLocal8Bit(qgetenv("KONSOLE_RECORDING_DIR"));
+    if (!recordingDir.isEmpty() && _recordingStream == nullptr) {
+        startRecording(recordingDir + QLatin1Char('/') + _uniqueIdentifier.toString(QUuid::WithoutBraces) + QStringLiteral(".cast"));
+    }
+
     QStringList programs = {_program, QString::fromUtf8(qgetenv("SHELL")), QStringLiteral("/bin/sh")};
 
 #if HAVE_GETPWUID
@@ -766,6 +951,7 @@ void Session::setSessionAttribute(int what, const QString &caption)
     }
 
     if (modified) {
+        invalidateDynamicTitle();
         Q_EMIT sessionAttributeChanged();
     }
 }
@@ -779,13 +965,10 @@ void Session::setTabTitleFormat(TabTitleContext context, const QString &format)
 {
     if (context == LocalTabTitle) {
         _localTabTitleFormat = format;
-        ProcessInfo *process = getProcessInfo();
-        if (process) {
-            process->setUserNameRequired(format.contains(QLatin1String("%u")));
-        }
     } else if (context == RemoteTabTitle) {
         _remoteTabTitleFormat = format;
     }
+    invalidateDynamicTitle();
 }
 
 QString Session::tabTitleFormat(TabTitleContext context) const
@@ -829,7 +1012,7 @@ bool Session::isTabActivityColorSetByUser() const
     return _tabActivityColorSetByUser;
 }
 
-void Session::silenceTimerDone()
+void Session::notifySilence()
 {
     // FIXME: The idea here is that the notification popup will appear to tell the user than output from
     // the terminal has stopped and the popup will disappear when the user activates the session.
@@ -863,11 +1046,6 @@ void Session::silenceTimerDone()
     setPendingNotification(Notification::Silence);
 }
 
-void Session::activityTimerDone()
-{
-    _notifiedActivity = false;
-}
-
 void Session::resetNotifications()
 {
     static const Notification availableNotifications[] = {Activity, Silence, Bell};
@@ -920,7 +1098,35 @@ void Session::sessionAttributeRequest(int id, uint terminator)
 
 void Session::onViewSizeChange(int /* height */, int /* width */)
 {
-    updateTerminalSize();
+    // Interactive window resizing delivers a flood of size changes, and
+    // everything downstream of updateTerminalSize() is expensive: the
+    // screen reflow, the PTY winsize ioctl and the SIGWINCH the foreground
+    // program answers with a full redraw.  A single change (startup, pane
+    // split) is applied immediately; a storm is coalesced so the work runs
+    // once per RESIZE_SETTLE_DELAY and once more when the geometry settles.
+    // In between, the views keep showing the last image clipped to their
+    // new grid, which costs nothing.
+    static const int RESIZE_SETTLE_DELAY = 100; // ms
+
+    if (_resizeDebounceTimer == nullptr) {
+        _resizeDebounceTimer = new QTimer(this);
+        _resizeDebounceTimer->setSingleShot(true);
+        _resizeDebounceTimer->setInterval(RESIZE_SETTLE_DELAY);
+        connect(_resizeDebounceTimer, &QTimer::timeout, this, [this]() {
+            if (_resizePending) {
+                _resizePending = false;
+                updateTerminalSize();
+            }
+        });
+    }
+
+    if (!_resizeDebounceTimer->isActive()) {
+        updateTerminalSize();
+        _resizePending = false;
+    } else {
+        _resizePending = true;
+    }
+    _resizeDebounceTimer->start();
 }
 
 void Session::updateTerminalSize()
@@ -1178,6 +1384,7 @@ void Session::done(int exitCode, QProcess::ExitStatus exitStatus)
 
     if (!_autoClose) {
         _userTitle = i18nc("@info:shell This session is done", "Finished");
+        invalidateDynamicTitle();
         Q_EMIT sessionAttributeChanged();
         return;
     }
@@ -1196,7 +1403,7 @@ void Session::done(int exitCode, QProcess::ExitStatus exitStatus)
             message = i18n("Program '%1' exited with status %2.", _program, exitCode);
         }
 
-        // FIXME: See comments in Session::silenceTimerDone()
+        // FIXME: See comments in Session::notifySilence()
         KNotification *notification = new KNotification(QStringLiteral("Finished"), KNotification::CloseWhenWindowActivated);
         if (QApplication::activeWindow()) {
             notification->setWindow(QApplication::activeWindow()->windowHandle());
@@ -1328,6 +1535,32 @@ void Session::updateSessionProcessInfo()
     _sessionProcessInfo->update();
 }
 
+#ifdef Q_OS_LINUX
+// Reads the start time of @p pid from /proc/<pid>/stat; returns 0 if the
+// process is gone.  Used to validate cached ProcessInfo instances against
+// pid reuse, see ProcessInfo::startTime()
+static qulonglong procStartTime(int pid)
+{
+    QFile statFile(QStringLiteral("/proc/%1/stat").arg(pid));
+    if (!statFile.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QByteArray data = statFile.readAll();
+    // the process name (field 2) may contain spaces; fields are only
+    // space-separated after its closing parenthesis
+    const int nameEnd = data.lastIndexOf(')');
+    if (nameEnd < 0) {
+        return 0;
+    }
+    const QList<QByteArray> fields = data.mid(nameEnd + 2).split(' ');
+    // start time is field 22 of stat, i.e. the 20th after the name
+    if (fields.size() <= 19) {
+        return 0;
+    }
+    return fields.at(19).toULongLong();
+}
+#endif
+
 bool Session::updateForegroundProcessInfo()
 {
     if (!_shellProcess) {
@@ -1336,13 +1569,48 @@ bool Session::updateForegroundProcessInfo()
 
     const int foregroundPid = _shellProcess->foregroundProcessGroup();
     if (foregroundPid != _foregroundPid) {
-        delete _foregroundProcessInfo;
+        // park the previous instance in the cache; alternating between
+        // the shell and a child would otherwise re-read all of /proc on
+        // every switch
+        if (_foregroundProcessInfo != nullptr) {
+            delete _foregroundProcessInfoCache.take(_foregroundPid);
+            _foregroundProcessInfoCache.insert(_foregroundPid, _foregroundProcessInfo);
+            _foregroundProcessInfo = nullptr;
+        }
+
+        ProcessInfo *cached = _foregroundProcessInfoCache.take(foregroundPid);
+        if (cached != nullptr) {
+#ifdef Q_OS_LINUX
+            bool ok = false;
+            const qulonglong cachedStartTime = cached->startTime(&ok);
+            if (ok && cachedStartTime != 0 && cachedStartTime == procStartTime(foregroundPid)) {
+                _foregroundProcessInfo = cached;
+            } else {
+                // the pid was reused by a different process
+                delete cached;
+            }
+#else
+            // no cheap identity check available; never reuse
+            delete cached;
+#endif
+        }
+
+        if (_foregroundProcessInfo == nullptr) {
 #ifndef Q_OS_WIN
-        _foregroundProcessInfo = ProcessInfo::newInstance(foregroundPid, processId(), _shellProcess->pty()->ttyName());
+            _foregroundProcessInfo = ProcessInfo::newInstance(foregroundPid, processId(), _shellProcess->pty()->ttyName());
 #else
-        _foregroundProcessInfo = ProcessInfo::newInstance(foregroundPid, processId());
+            _foregroundProcessInfo = ProcessInfo::newInstance(foregroundPid, processId());
 #endif
+        }
         _foregroundPid = foregroundPid;
+
+        if (_foregroundProcessInfoCache.size() > 8) {
+            qDeleteAll(_foregroundProcessInfoCache);
+            _foregroundProcessInfoCache.clear();
+        }
+
+        watchForegroundProcess(foregroundPid);
+        invalidateDynamicTitle();
     }
 
     if (_foregroundProcessInfo != nullptr) {
@@ -1357,6 +1625,45 @@ bool Session::updateForegroundProcessInfo()
     }
 }
 
+void Session::watchForegroundProcess(int pid)
+{
+#if defined(Q_OS_LINUX) && defined(SYS_pidfd_open)
+    if (_foregroundPidfdNotifier != nullptr) {
+        _foregroundPidfdNotifier->setEnabled(false);
+        _foregroundPidfdNotifier->deleteLater();
+        _foregroundPidfdNotifier = nullptr;
+    }
+    if (_foregroundPidfd >= 0) {
+        ::close(_foregroundPidfd);
+        _foregroundPidfd = -1;
+    }
+
+    // the shell's exit is already reported through QProcess::finished
+    if (pid <= 0 || pid == processId()) {
+        return;
+    }
+
+    // pidfd_open requires Linux >= 5.3; when it fails the existing
+    // snapshot polling still picks the exit up, just later
+    const int fd = static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+    if (fd < 0) {
+        return;
+    }
+
+    _foregroundPidfd = fd;
+    _foregroundPidfdNotifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(_foregroundPidfdNotifier, &QSocketNotifier::activated, this, [this]() {
+        // the pidfd stays readable once the process has exited, so stop
+        // watching before notifying listeners
+        watchForegroundProcess(0);
+        invalidateDynamicTitle();
+        Q_EMIT foregroundProcessExited();
+    });
+#else
+    Q_UNUSED(pid)
+#endif
+}
+
 bool Session::isRemote()
 {
     ProcessInfo *process = getProcessInfo();
@@ -1365,8 +1672,41 @@ bool Session::isRemote()
     return (process->name(&ok) == QLatin1String("ssh") && ok);
 }
 
+void Session::invalidateDynamicTitle()
+{
+    _dynamicTitleDirty = true;
+}
+
+QString Session::rememberDynamicTitle(const QString &title)
+{
+#ifdef Q_OS_LINUX
+    // record the working directory the title was computed against, so
+    // the probe in getDynamicTitle() can tell when it moved
+    const int cwdPid = _foregroundPid > 0 ? _foregroundPid : processId();
+    _cachedDynamicTitleCwd = QFile::symLinkTarget(QStringLiteral("/proc/%1/cwd").arg(cwdPid));
+#endif
+    _cachedDynamicTitle = title;
+    _dynamicTitleDirty = false;
+    return title;
+}
+
 QString Session::getDynamicTitle()
 {
+#ifdef Q_OS_LINUX
+    // Idle sessions take this path on every snapshot: when none of the
+    // event-tracked format inputs changed, probing the foreground group
+    // (one ioctl) and its working directory (one readlink) is all that
+    // is needed to reuse the memoized title, instead of the full
+    // ProcessInfo update and marker interpolation below.
+    if (!_dynamicTitleDirty && !_cachedDynamicTitle.isNull() && _shellProcess != nullptr && _shellProcess->foregroundProcessGroup() == _foregroundPid) {
+        const int cwdPid = _foregroundPid > 0 ? _foregroundPid : processId();
+        const QString cwd = QFile::symLinkTarget(QStringLiteral("/proc/%1/cwd").arg(cwdPid));
+        if (!cwd.isEmpty() && cwd == _cachedDynamicTitleCwd) {
+            return _cachedDynamicTitle;
+        }
+    }
+#endif
+
     ProcessInfo *process = getProcessInfo();
     std::unique_ptr<SSHProcessInfo> sshProcess;
 
@@ -1388,7 +1728,7 @@ QString Session::getDynamicTitle()
         QString title = tabTitleFormat(Session::RemoteTabTitle);
         title.replace(QLatin1String("%w"), userTitle());
         title.replace(QLatin1String("%#"), QString::number(sessionId()));
-        return sshProcess->format(title);
+        return rememberDynamicTitle(sshProcess->format(title));
     }
 
     /*
@@ -1514,7 +1854,7 @@ QString Session::getDynamicTitle()
         }
     }
 
-    return title;
+    return rememberDynamicTitle(title);
 }
 
 QUrl Session::getUrl()
@@ -1641,10 +1981,11 @@ void Session::setMonitorActivity(bool monitor)
     _monitorActivity = monitor;
     _notifiedActivity = false;
 
-    // This timer is meaningful only after activity has been notified
-    _activityTimer->stop();
+    // This mask is meaningful only after activity has been notified
+    _activityMaskUntil = 0;
 
     setPendingNotification(Notification::Activity, false);
+    updateMonitorRegistration();
 }
 
 void Session::setMonitorSilence(bool monitor)
@@ -1655,19 +1996,21 @@ void Session::setMonitorSilence(bool monitor)
 
     _monitorSilence = monitor;
     if (_monitorSilence) {
-        _silenceTimer->start(_silenceSeconds * 1000);
-    } else {
-        _silenceTimer->stop();
+        // restart the silence window from now
+        _lastActivityTime = SessionMonitorService::monotonicMs();
+        _notifiedSilence = false;
     }
 
     setPendingNotification(Notification::Silence, false);
+    updateMonitorRegistration();
 }
 
 void Session::setMonitorSilenceSeconds(int seconds)
 {
     _silenceSeconds = seconds;
     if (_monitorSilence) {
-        _silenceTimer->start(_silenceSeconds * 1000);
+        _lastActivityTime = SessionMonitorService::monotonicMs();
+        _notifiedSilence = false;
     }
 }
 
@@ -1708,6 +2051,13 @@ bool Session::flowControlEnabled() const
         return _flowControlEnabled;
     }
 }
+QString Session::outputCoalescingMode() const
+{
+    if (_emulation != nullptr && _emulation->bufferedUpdateMode() == Emulation::BusyUpdate) {
+        return QStringLiteral("busy");
+    }
+    return QStringLiteral("interactive");
+}
 void Session::fireZModemDownloadDetected()
 {
     if (!_zmodemBusy) {
@@ -1732,6 +2082,36 @@ void Session::cancelZModem()
 void Session::startZModem(const QString &zmodem, const QString &dir, const QStringList &list)
 {
     _zmodemBusy = true;
+
+    _zmodemProgress = new ZModemDialog(QApplication::activeWindow(), false, i18n("ZModem Progress"));
+
+    connect(_zmodemProgress, &Konsole::ZModemDialog::zmodemCancel, this, &Konsole::Session::zmodemFinished);
+
+    _zmodemProgress->show();
+
+#ifndef Q_OS_WIN
+    // Hand the transfer to a worker thread which moves data between the pty
+    // and rz/sz directly, with bounded buffering in both directions.  The
+    // pty's own reader is suspended for the duration so the worker is the
+    // only consumer of the master fd; the GUI thread only sees throttled
+    // progress and status-line updates.
+    disconnect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::onReceiveBlock);
+    _shellProcess->setReadSuspended(true);
+
+    _zmodemShuttle = new ZModemShuttle(_shellProcess->pty()->masterFd(), //
+                                       zmodem,
+                                       QStringList() << QStringLiteral("-v") << QStringLiteral("-e") << list,
+                                       dir,
+                                       this);
+
+    connect(_zmodemShuttle, &Konsole::ZModemShuttle::statusText, _zmodemProgress, &Konsole::ZModemDialog::addText);
+    connect(_zmodemShuttle, &Konsole::ZModemShuttle::progress, _zmodemProgress, [this](qint64, qint64) {
+        _zmodemProgress->addProgressText(QStringLiteral("."));
+    });
+    connect(_zmodemShuttle, &Konsole::ZModemShuttle::transferFinished, this, &Konsole::Session::zmodemFinished);
+
+    _zmodemShuttle->start();
+#else
     _zmodemProc = new KProcess();
     _zmodemProc->setOutputChannelMode(KProcess::SeparateChannels);
 
@@ -1749,12 +2129,7 @@ void Session::startZModem(const QString &zmodem, const QString &dir, const QStri
 
     disconnect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::onReceiveBlock);
     connect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::zmodemReceiveBlock);
-
-    _zmodemProgress = new ZModemDialog(QApplication::activeWindow(), false, i18n("ZModem Progress"));
-
-    connect(_zmodemProgress, &Konsole::ZModemDialog::zmodemCancel, this, &Konsole::Session::zmodemFinished);
-
-    _zmodemProgress->show();
+#endif
 }
 
 void Session::zmodemReadAndSendBlock()
@@ -1808,6 +2183,27 @@ void Session::zmodemReceiveBlock(const char *data, int len)
 
 void Session::zmodemFinished()
 {
+#ifndef Q_OS_WIN
+    /* zmodemFinished() is called by ZModemShuttle's transferFinished() and
+       ZModemDialog's user1Clicked(). Null the member before tearing the
+       worker down so the cancel path cannot recursively invoke this
+       function again! */
+    if (_zmodemShuttle != nullptr) {
+        ZModemShuttle *shuttle = _zmodemShuttle;
+        _zmodemShuttle = nullptr; // Avoid recursive invocations!
+        _zmodemBusy = false;
+        shuttle->cancel();
+        shuttle->wait();
+        delete shuttle; // Now, the worker may be disposed safely.
+
+        _shellProcess->setReadSuspended(false);
+        connect(_shellProcess, &Konsole::Pty::receivedData, this, &Konsole::Session::onReceiveBlock);
+
+        _shellProcess->sendData(QByteArrayLiteral("\030\030\030\030")); // Abort
+        _shellProcess->sendData(QByteArrayLiteral("\001\013\n")); // Try to get prompt back
+        _zmodemProgress->transferDone();
+    }
+#else
     /* zmodemFinished() is called by QProcess's finished() and
        ZModemDialog's user1Clicked(). Therefore, an invocation by
        user1Clicked() will recursively invoke this function again
@@ -1825,12 +2221,194 @@ void Session::zmodemFinished()
         _shellProcess->sendData(QByteArrayLiteral("\001\013\n")); // Try to get prompt back
         _zmodemProgress->transferDone();
     }
+#endif
 }
 
+void Session::sendRawInput(const QByteArray &data)
+{
+    if (_shellProcess != nullptr) {
+        _shellProcess->sendData(data);
+    } else {
+        // no pty: input reaches its destination through whatever is
+        // connected to the emulation's sendData signal
+        _emulation->sendString(data);
+    }
+}
+
+bool Session::startRawLog(const QString &path)
+{
+    stopRawLog();
+
+    auto *stream = new RawLogStream(path, this);
+    if (!stream->isValid()) {
+        qWarning() << "Could not open raw log file" << path;
+        delete stream;
+        return false;
+    }
+
+    _rawLogStream = stream;
+    return true;
+}
+
+void Session::stopRawLog()
+{
+    delete _rawLogStream;
+    _rawLogStream = nullptr;
+}
+
+bool Session::isRawLogActive() const
+{
+    return _rawLogStream != nullptr;
+}
+
+void Session::startLatencyProbe(int intervalMsecs)
+{
+    if (_latencyProbe == nullptr) {
+        _latencyProbe = new LatencyProbe(this);
+    }
+    _latencyProbe->start(intervalMsecs);
+}
+
+void Session::stopLatencyProbe()
+{
+    if (_latencyProbe != nullptr) {
+        _latencyProbe->stop();
+    }
+}
+
+bool Session::isLatencyProbeActive() const
+{
+    return _latencyProbe != nullptr && _latencyProbe->isActive();
+}
+
+QString Session::latencyProbeReport() const
+{
+    return _latencyProbe != nullptr ? _latencyProbe->report() : QString();
+}
+
+bool Session::startRecording(const QString &path)
+{
+    stopRecording();
+
+    const QSize imageSize = size();
+    auto *stream = new RawLogStream(path, RawLogStream::AsciicastV2, imageSize.width(), imageSize.height(), this);
+    if (!stream->isValid()) {
+        qWarning() << "Could not open recording file" << path;
+        delete stream;
+        return false;
+    }
+
+    _recordingStream = stream;
+    return true;
+}
+
+void Session::stopRecording()
+{
+    delete _recordingStream;
+    _recordingStream = nullptr;
+}
+
+bool Session::isRecording() const
+{
+    return _recordingStream != nullptr;
+}
+
+// Emulation time spent by all sessions in the current event-loop slice.
+// The per-session budgets below are not enough on their own: with many
+// busy sessions each one still claims a full slice before yielding, and
+// the sum is what the user feels. The total is bounded too, and any
+// session crossing it suspends its reads the same way.
+static QElapsedTimer s_processSliceTimer;
+static qint64 s_processSliceUsecs = 0;
+// the portion contributed by sessions with a visible view; hidden
+// sessions yield to it, see onReceiveBlock()
+static qint64 s_visibleSliceUsecs = 0;
+
 void Session::onReceiveBlock(const char *buf, int len)
 {
+    PipelineMetrics::ScopedTimer timer(PipelineMetrics::PtyReadStage);
     handleActivity();
+    _ptyBytesReceived += len;
+
+    // tee the undecoded byte stream off to the raw log and the
+    // recording before any emulation work; append() only copies the
+    // block (plus a clock read for the recording)
+    if (_rawLogStream != nullptr) {
+        _rawLogStream->append(buf, len);
+    }
+    if (_recordingStream != nullptr) {
+        _recordingStream->append(buf, len);
+    }
+    if (_latencyProbe != nullptr) {
+        _latencyProbe->notifyDataReceived();
+    }
+
+    // aim at roughly this much emulation work per event-loop slice; short
+    // enough that keystrokes and repaints stay responsive during floods
+    constexpr qint64 TargetSliceUsecs = 10 * 1000;
+    constexpr qint64 MinSliceBudget = 64 * 1024;
+    constexpr qint64 MaxSliceBudget = 16 * 1024 * 1024;
+    // hidden sessions run in larger, less frequent quanta: double the
+    // byte budget and a real pause before resuming, so a build in a
+    // background tab gets throughput without diluting keystroke echo
+    // in the tab the user is looking at
+    constexpr int HiddenResumeDelayMsecs = 15;
+
+    const bool hasVisibleView = std::any_of(_views.constBegin(), _views.constEnd(), [](const TerminalDisplay *display) {
+        return display->isVisible();
+    });
+
+    // a gap since the last block means the event loop had its turn; start
+    // a fresh slice
+    if (!_receiveSliceTimer.isValid() || _receiveSliceTimer.elapsed() > TargetSliceUsecs / 1000) {
+        _receiveSliceTimer.start();
+        _receiveSliceBytes = 0;
+    }
+    if (!s_processSliceTimer.isValid() || s_processSliceTimer.elapsed() > TargetSliceUsecs / 1000) {
+        s_processSliceTimer.start();
+        s_processSliceUsecs = 0;
+        s_visibleSliceUsecs = 0;
+    }
+
+    QElapsedTimer emulationTimer;
+    emulationTimer.start();
     _emulation->receiveData(buf, len);
+    const qint64 elapsedUsecs = emulationTimer.nsecsElapsed() / 1000;
+
+    // retune the budget to the measured digestion rate, smoothed and
+    // clamped so scheduling blips cannot collapse or explode it
+    if (elapsedUsecs > 0 && len > 0) {
+        const qint64 tuned = qint64(len) * TargetSliceUsecs / elapsedUsecs;
+        _receiveSliceBudget = qBound(MinSliceBudget, (_receiveSliceBudget + tuned) / 2, MaxSliceBudget);
+    }
+
+    _receiveSliceBytes += len;
+    s_processSliceUsecs += elapsedUsecs;
+    if (hasVisibleView) {
+        s_visibleSliceUsecs += elapsedUsecs;
+    }
+
+    // a hidden session also yields as soon as a visible one has spent any
+    // emulation time in this slice; the visible session's quantum comes
+    // first, the hidden one catches up on its delayed resume
+    const qint64 sliceBudget = hasVisibleView ? _receiveSliceBudget : 2 * _receiveSliceBudget;
+    const bool outOfBudget = _receiveSliceBytes >= sliceBudget //
+        || s_processSliceUsecs >= TargetSliceUsecs //
+        || (!hasVisibleView && s_visibleSliceUsecs > 0);
+    if (outOfBudget && !_ptyReadSuspended && _shellProcess != nullptr) {
+        // out of budget: stop reading until everything already queued has
+        // run; the kernel's pty buffer holds the flood back meanwhile
+        _ptyReadSuspended = true;
+        _shellProcess->setReadSuspended(true);
+        QTimer::singleShot(hasVisibleView ? 0 : HiddenResumeDelayMsecs, this, [this]() {
+            _ptyReadSuspended = false;
+            _receiveSliceBytes = 0;
+            _receiveSliceTimer.start();
+            if (_shellProcess != nullptr) {
+                _shellProcess->setReadSuspended(false);
+            }
+        });
+    }
 }
 
 QSize Session::size()
@@ -2371,6 +2949,14 @@ void Session::handleActivity()
     // TODO: should this hardcoded interval be user configurable?
     const int activityMaskInSeconds = 15;
 
+    const qint64 now = SessionMonitorService::monotonicMs();
+
+    // This runs for every block of output, so silence monitoring is just
+    // a timestamp store here; SessionMonitorService evaluates the
+    // deadline in checkMonitorDeadlines()
+    _lastActivityTime = now;
+    _notifiedSilence = false;
+
     TerminalDisplay *view = nullptr;
     if (!_views.isEmpty()) {
         view = _views.first();
@@ -2393,12 +2979,7 @@ void Session::handleActivity()
 
         // mask activity notification for a while to avoid flooding
         _notifiedActivity = true;
-        _activityTimer->start(activityMaskInSeconds * 1000);
-    }
-
-    // reset the counter for monitoring continuous silence since there is activity
-    if (_monitorSilence) {
-        _silenceTimer->start(_silenceSeconds * 1000);
+        _activityMaskUntil = now + activityMaskInSeconds * 1000;
     }
 
     if (_monitorActivity) {
@@ -2406,6 +2987,27 @@ void Session::handleActivity()
     }
 }
 
+void Session::checkMonitorDeadlines(qint64 now)
+{
+    if (_notifiedActivity && now >= _activityMaskUntil) {
+        _notifiedActivity = false;
+    }
+
+    if (_monitorSilence && !_notifiedSilence && now - _lastActivityTime >= qint64(_silenceSeconds) * 1000) {
+        _notifiedSilence = true;
+        notifySilence();
+    }
+}
+
+void Session::updateMonitorRegistration()
+{
+    if (_monitorActivity || _monitorSilence) {
+        SessionMonitorService::instance()->registerSession(this);
+    } else {
+        SessionMonitorService::instance()->unregisterSession(this);
+    }
+}
+
 bool Session::isReadOnly() const
 {
     return _readOnly;
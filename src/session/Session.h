@@ -12,9 +12,11 @@
 #include "config-konsole.h"
 
 // Qt
+#include <QElapsedTimer>
 #include <QHash>
 #include <QLoggingCategory>
 #include <QProcess>
+#include <QSharedPointer>
 #include <QSize>
 #include <QStringList>
 #include <QUrl>
@@ -32,7 +34,9 @@
 #include "konsoleprivate_export.h"
 
 class QColor;
+class QSocketNotifier;
 class QTextCodec;
+class QTimer;
 
 class KConfigGroup;
 class KProcess;
@@ -40,12 +44,16 @@ class KProcess;
 namespace Konsole
 {
 class Emulation;
+class LatencyProbe;
 class Pty;
 class ProcessInfo;
+class RawLogStream;
 class TerminalDisplay;
 class ZModemDialog;
+class ZModemShuttle;
 class HistoryType;
 class SessionController;
+class SessionScanCache;
 /**
  * Represents a terminal session consisting of a pseudo-teletype and a terminal emulation.
  * The pseudo-teletype (or PTY) handles I/O between the terminal process and Konsole.
@@ -645,6 +653,80 @@ public Q_SLOTS:
     /** See setMonitorSilence() */
     Q_SCRIPTABLE void setMonitorSilenceSeconds(int seconds);
 
+    /**
+     * Sends already-encoded input bytes to this session's terminal
+     * process, bypassing the emulation.  Used by SessionGroup to fan
+     * broadcast input out cheaply; sessions without a pty (e.g. tmux
+     * panes) still deliver through their emulation's sendData listeners.
+     */
+    void sendRawInput(const QByteArray &data);
+
+    /**
+     * Starts mirroring the raw pty byte stream of this session into an
+     * append-only file at @p path, rotated by size.  The data is teed
+     * off before decoding on a dedicated I/O thread, so unlike the
+     * decoder-based autosave this is suitable for always-on logging of
+     * many sessions; the log contains escape sequences verbatim.
+     *
+     * Returns false if the file could not be opened.  A raw log is also
+     * started automatically when the KONSOLE_RAW_LOG_DIR environment
+     * variable points to a directory.
+     */
+    Q_SCRIPTABLE bool startRawLog(const QString &path);
+
+    /** Stops raw pty logging.  See startRawLog() */
+    Q_SCRIPTABLE void stopRawLog();
+
+    /** Returns true if the raw pty stream is being logged.  See startRawLog() */
+    Q_SCRIPTABLE bool isRawLogActive() const;
+
+    /**
+     * Starts the end-to-end input latency probe: every @p intervalMsecs
+     * a probe is typed through the normal input path and the time until
+     * its echo arrives back from the pty, and until the resulting frame
+     * has been painted, is recorded.  See LatencyProbe for the payload
+     * and its caveats with raw-mode applications.
+     */
+    Q_SCRIPTABLE void startLatencyProbe(int intervalMsecs);
+
+    /** Stops the latency probe.  See startLatencyProbe() */
+    Q_SCRIPTABLE void stopLatencyProbe();
+
+    /** Returns true while the latency probe is running.  See startLatencyProbe() */
+    Q_SCRIPTABLE bool isLatencyProbeActive() const;
+
+    /**
+     * Returns the probe's echo and end-to-end sample counts with p50/p99
+     * percentiles in microseconds.  See startLatencyProbe()
+     */
+    Q_SCRIPTABLE QString latencyProbeReport() const;
+
+    /**
+     * Starts recording this session's output to an asciicast v2 file at
+     * @p path, replayable with asciinema.  Like startRawLog() this uses
+     * a dedicated I/O thread; the receive path only takes a timestamp
+     * and copies the chunk.  A recording is also started automatically
+     * when the KONSOLE_RECORDING_DIR environment variable points to a
+     * directory.
+     *
+     * Returns false if the file could not be opened.
+     */
+    Q_SCRIPTABLE bool startRecording(const QString &path);
+
+    /** Stops recording.  See startRecording() */
+    Q_SCRIPTABLE void stopRecording();
+
+    /** Returns true if the session output is being recorded.  See startRecording() */
+    Q_SCRIPTABLE bool isRecording() const;
+
+    /**
+     * Evaluates the activity-mask and silence deadlines of this session
+     * against @p now, a SessionMonitorService::monotonicMs() timestamp.
+     * Called periodically by SessionMonitorService while this session is
+     * registered for activity or silence monitoring.
+     */
+    void checkMonitorDeadlines(qint64 now);
+
     /**
      * Sets whether flow control is enabled for this terminal
      * session.
@@ -654,6 +736,13 @@ public Q_SLOTS:
     /** Returns whether flow control is enabled for this terminal session. */
     Q_SCRIPTABLE bool flowControlEnabled() const;
 
+    /**
+     * Returns the output coalescing mode the emulation is currently using:
+     * "interactive" when updates are flushed almost immediately, "busy"
+     * when bulk output is coalesced to the display refresh period.
+     */
+    Q_SCRIPTABLE QString outputCoalescingMode() const;
+
     /**
      * @param text to send to the current foreground terminal program.
      * @param eol send this after @p text
@@ -720,6 +809,82 @@ public Q_SLOTS:
      */
     Q_SCRIPTABLE QByteArray codec();
 
+    /** Approximate number of bytes held by this session's scrollback history. */
+    Q_SCRIPTABLE qlonglong historySizeBytes() const;
+
+    /**
+     * Drops the oldest history lines down to @p keepLines where the
+     * history backend supports a cheap trim; returns the number of lines
+     * dropped.  Used by the memory-pressure trimmer.
+     */
+    int dropOldestHistoryLines(int keepLines);
+
+    /** Returns true while one of this session's views has keyboard focus. */
+    bool hasFocus() const;
+
+    /**
+     * The last time one of this session's views gained or lost keyboard
+     * focus (the session's creation time if that never happened), on the
+     * SessionMonitorService::monotonicMs() clock.  The memory-pressure
+     * trimmer prefers the sessions unfocused the longest.
+     */
+    qint64 lastFocusedTime() const;
+
+    /**
+     * The last time this session received a block of output from its
+     * pty, on the SessionMonitorService::monotonicMs() clock.
+     */
+    qint64 lastActivityTime() const;
+
+    /**
+     * Hibernates this session's scrollback to a disk snapshot in the
+     * cache directory, freeing its RAM; it is restored transparently on
+     * the next focus or output.  Returns false when the history backend
+     * does not support hibernation (see Screen::hibernateHistory()).
+     */
+    bool hibernate();
+
+    /** Approximate number of bytes held by this session's screen buffers. */
+    Q_SCRIPTABLE qlonglong screenBufferSizeBytes() const;
+
+    /**
+     * Approximate number of bytes held by the extended character table.
+     * The table is shared by every session in the process, so this is a
+     * process-wide figure, not a per-session one.
+     */
+    Q_SCRIPTABLE qlonglong extendedCharTableSizeBytes() const;
+
+    /** Number of hotspots currently cached by this session's views. */
+    Q_SCRIPTABLE qlonglong hotSpotCacheSize() const;
+
+    /** Total number of bytes received from the PTY over this session's lifetime. */
+    Q_SCRIPTABLE qlonglong ptyBytesReceived() const;
+
+    /**
+     * Wall-clock duration in milliseconds of the last command reported by
+     * shell integration (OSC 133), or -1 if no command has completed yet.
+     */
+    Q_SCRIPTABLE qlonglong lastCommandDuration() const;
+
+    /**
+     * Number of bytes the last shell-integration command wrote to the PTY,
+     * or -1 if no command has completed yet.
+     */
+    Q_SCRIPTABLE qlonglong lastCommandOutputBytes() const;
+
+    /**
+     * Exit status of the last shell-integration command, or -1 if no
+     * command has completed yet.
+     */
+    Q_SCRIPTABLE int lastCommandExitCode() const;
+
+    /**
+     * Returns a human readable per-session accounting summary covering the
+     * figures above; `konsole --diagnose` collects this for every session
+     * of every running Konsole process.
+     */
+    Q_SCRIPTABLE QString diagnostics() const;
+
     /** Sets the session's title for the specified @p role to @p title.
      *  This is an overloaded member function for setTitle(TitleRole, QString)
      *  provided for convenience since enum data types may not be
@@ -869,6 +1034,15 @@ Q_SIGNALS:
      */
     void finished(Session *session);
 
+    /**
+     * Emitted when the foreground process of the session's terminal
+     * exits, on platforms where this can be observed without polling
+     * (Linux, via a pidfd).  Listeners use this to refresh titles and
+     * process-finished notifications promptly instead of waiting for
+     * the next snapshot interval.
+     */
+    void foregroundProcessExited();
+
     /**
      * Emitted when one of certain session attributes has been changed.
      * See setSessionAttribute().
@@ -1001,12 +1175,13 @@ private Q_SLOTS:
     void fireZModemDownloadDetected();
     void fireZModemUploadDetected();
 
-    void silenceTimerDone();
-    void activityTimerDone();
     void resetNotifications();
 
     void onViewSizeChange(int height, int width);
 
+    // keeps hasFocus()/lastFocusedTime() up to date
+    void onViewFocusChanged(bool focused);
+
     // automatically detach views from sessions when view is destroyed
     void viewDestroyed(QObject *view);
 
@@ -1060,17 +1235,32 @@ private:
 
     QList<TerminalDisplay *> _views;
 
-    // monitor activity & silence
+    // filter-scan state shared by all of this session's views, created
+    // lazily when the first view attaches; see SessionScanCache
+    QSharedPointer<SessionScanCache> _scanCache;
+
+    // monitor activity & silence.  Deadlines are kept as
+    // SessionMonitorService::monotonicMs() timestamps and evaluated by
+    // the process-wide SessionMonitorService rather than per-session
+    // timers; the receive path only stores _lastActivityTime.
     bool _monitorPrompt = false;
     bool _monitorActivity = false;
     bool _monitorSilence = false;
     bool _notifiedActivity = false;
+    bool _notifiedSilence = false;
     int _silenceSeconds = 10;
-    QTimer *_silenceTimer = nullptr;
-    QTimer *_activityTimer = nullptr;
+    qint64 _lastActivityTime = 0;
+    qint64 _activityMaskUntil = 0;
+
+    // keyboard-focus tracking for the memory-pressure trimmer, on the
+    // same monotonic clock as the monitor deadlines above
+    bool _hasFocus = false;
+    qint64 _lastFocusedTime = 0;
 
     void setPendingNotification(Notification notification, bool enable = true);
     void handleActivity();
+    void notifySilence();
+    void updateMonitorRegistration();
 
     Notifications _activeNotifications;
 
@@ -1083,6 +1273,17 @@ private:
 
     QString _localTabTitleFormat = QString();
     QString _remoteTabTitleFormat = QString();
+
+    // memoized result of getDynamicTitle().  _dynamicTitleDirty is set
+    // by invalidateDynamicTitle() whenever an input of the title format
+    // changes through an observable event; the foreground process and
+    // its working directory are probed cheaply on each call instead.
+    QString _cachedDynamicTitle;
+    QString _cachedDynamicTitleCwd;
+    bool _dynamicTitleDirty = true;
+
+    void invalidateDynamicTitle();
+    QString rememberDynamicTitle(const QString &title);
     QColor _tabColor = QColor();
     QColor _tabActivityColor = QColor();
 
@@ -1104,6 +1305,32 @@ private:
     bool _addToUtmp = true;
     bool _flowControlEnabled = true;
 
+    // flow control between the pty and the emulation: each event-loop
+    // slice gets a byte budget adapted to how fast the emulation is
+    // currently digesting; when it runs out, pty reads are suspended
+    // until pending input and repaints have had their turn
+    qint64 _receiveSliceBudget = 256 * 1024;
+    qint64 _receiveSliceBytes = 0;
+    QElapsedTimer _receiveSliceTimer;
+    bool _ptyReadSuspended = false;
+
+    // lifetime total for the diagnostics D-Bus interface
+    qint64 _ptyBytesReceived = 0;
+
+    // per-command telemetry from the shell integration marks; see
+    // lastCommandDuration() and lastCommandOutputBytes()
+    QElapsedTimer _commandTimer;
+    qint64 _commandStartBytes = 0;
+    bool _commandRunning = false;
+    qint64 _lastCommandDurationMsecs = -1;
+    qint64 _lastCommandOutputBytes = -1;
+    int _lastCommandExitCode = -1;
+
+    // coalesces view size changes during interactive resizing, so the
+    // reflow and PTY winsize update run once per settled geometry
+    QTimer *_resizeDebounceTimer = nullptr;
+    bool _resizePending = false;
+
     QString _program = QString();
     QStringList _arguments;
 
@@ -1117,14 +1344,37 @@ private:
     ProcessInfo *_foregroundProcessInfo = nullptr;
     int _foregroundPid = 0;
 
+    // ProcessInfo instances for recent foreground pids, kept so that
+    // alternating between the shell and a child does not re-read all of
+    // /proc each time.  Entries are validated against the process start
+    // time before reuse to catch pid reuse.
+    QHash<int, ProcessInfo *> _foregroundProcessInfoCache;
+
+    // tees the raw pty byte stream into a log file; see startRawLog()
+    RawLogStream *_rawLogStream = nullptr;
+
+    // records output as asciicast v2 events; see startRecording()
+    RawLogStream *_recordingStream = nullptr;
+
+    // pidfd watching the current foreground process for exit; -1 when
+    // unsupported or not watching
+    int _foregroundPidfd = -1;
+    QSocketNotifier *_foregroundPidfdNotifier = nullptr;
+
+    void watchForegroundProcess(int pid);
+
     // Container context tracking
     ContainerInfo _containerContext;
     bool _enteredViaContainerCommand = false;
     int _lastContainerCheckPid = -1;
 
+    // end-to-end input latency probe, created on first use
+    LatencyProbe *_latencyProbe = nullptr;
+
     // ZModem
     bool _zmodemBusy = false;
-    KProcess *_zmodemProc = nullptr;
+    KProcess *_zmodemProc = nullptr; // Windows fallback path
+    ZModemShuttle *_zmodemShuttle = nullptr;
     ZModemDialog *_zmodemProgress = nullptr;
 
     bool _hasDarkBackground = false;
@@ -96,6 +96,8 @@
 // For Unix signal names
 #include <csignal>
 
+#include <algorithm>
+
 using namespace Konsole;
 
 QSet<SessionController *> SessionController::_allControllers;
@@ -203,6 +205,10 @@ SessionController::SessionController(Session *sessionParam, TerminalDisplay *vie
     // update the title when the session starts
     connect(session(), &Konsole::Session::started, this, &Konsole::SessionController::snapshot);
 
+    // refresh the title and process-finished notification as soon as the
+    // foreground process exits, instead of waiting for the next snapshot
+    connect(session(), &Konsole::Session::foregroundProcessExited, this, &Konsole::SessionController::snapshot);
+
     // listen for output changes to set activity flag
     connect(session()->emulation(), &Konsole::Emulation::outputChanged, this, &Konsole::SessionController::fireActivity);
 
@@ -1729,6 +1735,26 @@ void SessionController::searchTextChanged(const QString &text)
         view()->screenWindow()->scrollTo(_searchStartLine);
     }
 
+    // A pattern that narrows the previous one costs work proportional to
+    // the previous result set, so it can run on every keystroke.  When a
+    // full rescan is unavoidable on a large scrollback, coalesce fast
+    // typing into one scan instead of restarting per keystroke.
+    if (!text.isEmpty() && !canNarrowSearch(text) && view()->screenWindow()->lineCount() > 10000) {
+        if (_searchDebounceTimer == nullptr) {
+            _searchDebounceTimer = new QTimer(this);
+            _searchDebounceTimer->setSingleShot(true);
+            _searchDebounceTimer->setInterval(150);
+            connect(_searchDebounceTimer, &QTimer::timeout, this, [this]() {
+                beginSearch(_searchText, reverseSearchChecked() ? Enum::BackwardsSearch : Enum::ForwardsSearch, noWrapChecked());
+            });
+        }
+        _searchDebounceTimer->start();
+        return;
+    }
+    if (_searchDebounceTimer != nullptr) {
+        _searchDebounceTimer->stop();
+    }
+
     // update search.  this is called even when the text is
     // empty to clear the view's filters
     beginSearch(text, reverseSearchChecked() ? Enum::BackwardsSearch : Enum::ForwardsSearch, noWrapChecked());
@@ -1742,6 +1768,37 @@ void SessionController::searchCompleted(bool success)
     }
 }
 
+bool SessionController::canNarrowSearch(const QString &text) const
+{
+    if (!_searchMatchesValid || _searchMatchText.isEmpty() || _searchBar.isNull() || view().isNull() || view()->screenWindow() == nullptr) {
+        return false;
+    }
+
+    // only a literal search is guaranteed to match a superset of the
+    // lines a contained literal matches; regular expressions are not
+    const QBitArray options = _searchBar->optionsChecked();
+    if (options.at(IncrementalSearchBar::RegExp) || _searchMatchesRegExp) {
+        return false;
+    }
+    const bool caseSensitive = options.at(IncrementalSearchBar::MatchCase);
+    if (caseSensitive != _searchMatchesCaseSensitive) {
+        return false;
+    }
+    if (!text.contains(_searchMatchText, caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive)) {
+        return false;
+    }
+
+    // the line numbering must still be reconstructible: same screen, no
+    // reflow, and a history that has only grown (minus dropped lines)
+    ScreenWindow *window = view()->screenWindow();
+    const Screen *screen = window->screen();
+    if (screen != _searchMatchScreen || window->columnCount() != _searchMatchColumns) {
+        return false;
+    }
+    const int shift = screen->totalDroppedLines() - _searchMatchDroppedLines;
+    return screen->getHistLines() >= _searchMatchHistLines - shift;
+}
+
 void SessionController::beginSearch(const QString &text, Enum::SearchDirection direction, bool noWrap)
 {
     Q_ASSERT(_searchBar);
@@ -1771,6 +1828,51 @@ void SessionController::beginSearch(const QString &text, Enum::SearchDirection d
         task->setAutoDelete(true);
         task->setStartLine(_searchStartLine);
         task->addScreenWindow(session(), view()->screenWindow());
+
+        ScreenWindow *window = view()->screenWindow();
+        const Screen *screen = window->screen();
+        const bool narrow = canNarrowSearch(text);
+        if (narrow) {
+            // restrict the highlight scan to the previous matches in the
+            // immutable history part (renumbered past dropped lines) and
+            // everything that was still on screen or arrived since
+            const int shift = screen->totalDroppedLines() - _searchMatchDroppedLines;
+            const int immutableEnd = _searchMatchHistLines - shift;
+            QList<int> candidates;
+            candidates.reserve(_searchMatchLines.size() + window->lineCount() - immutableEnd);
+            for (const int line : std::as_const(_searchMatchLines)) {
+                const int shifted = line - shift;
+                if (shifted >= 0 && shifted < immutableEnd) {
+                    candidates.append(shifted);
+                }
+            }
+            for (int line = qMax(0, immutableEnd); line < window->lineCount(); line++) {
+                candidates.append(line);
+            }
+            std::sort(candidates.begin(), candidates.end());
+            task->setCandidateLines(candidates);
+        }
+
+        // record the result set so the next keystroke can narrow it
+        _searchMatchesValid = false;
+        _searchMatchLines.clear();
+        _searchMatchText = text;
+        _searchMatchScreen = screen;
+        _searchMatchesRegExp = _searchBar->optionsChecked().at(IncrementalSearchBar::RegExp);
+        _searchMatchesCaseSensitive = _searchBar->optionsChecked().at(IncrementalSearchBar::MatchCase);
+        _searchMatchHistLines = screen->getHistLines();
+        _searchMatchColumns = window->columnCount();
+        _searchMatchDroppedLines = screen->totalDroppedLines();
+        connect(task, &Konsole::SearchHistoryTask::searchResults, this, [this](const QSet<int> &lines, int) {
+            // emitted incrementally; accumulate the full set
+            _searchMatchLines.unite(lines);
+            _searchMatchesValid = true;
+        });
+
+        // drop the previous search's stripes so the scrollbar can fold the
+        // incremental result emissions into its density map additively
+        view()->scrollBar()->clearSearchLines();
+
         task->execute();
     } else if (text.isEmpty()) {
         view()->scrollBar()->clearSearchLines();
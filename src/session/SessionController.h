@@ -46,6 +46,7 @@ class IncrementalSearchBar;
 class Profile;
 class ProfileList;
 class RegExpFilter;
+class Screen;
 class ScreenWindow;
 class Session;
 class SessionGroup;
@@ -354,6 +355,9 @@ private:
     // direction - value from SearchHistoryTask::SearchDirection enum to specify
     //             the search direction
     void beginSearch(const QString &text, Enum::SearchDirection direction, bool noWrap);
+    // true when a search for @p text can be narrowed to the match lines
+    // of the previous search instead of rescanning the scrollback
+    bool canNarrowSearch(const QString &text) const;
     QRegularExpression regexpFromSearchBarOptions() const;
     bool reverseSearchChecked() const;
     bool noWrapChecked() const;
@@ -418,6 +422,23 @@ private:
     QString _searchText = QString();
     QPointer<IncrementalSearchBar> _searchBar;
 
+    // Narrowing state for incremental search: every match line of the
+    // previous pattern and the conditions it was gathered under, so
+    // extending the pattern only re-verifies those lines.  The dropped
+    // line count renumbers the set when the scrollback is at its cap.
+    QSet<int> _searchMatchLines;
+    QString _searchMatchText;
+    const Screen *_searchMatchScreen = nullptr;
+    bool _searchMatchesValid = false;
+    bool _searchMatchesCaseSensitive = false;
+    bool _searchMatchesRegExp = false;
+    int _searchMatchHistLines = 0;
+    int _searchMatchColumns = 0;
+    int _searchMatchDroppedLines = 0;
+    // fallback when a keystroke cannot narrow: coalesce typing into one
+    // full scan on large scrollbacks
+    QTimer *_searchDebounceTimer = nullptr;
+
     QString _previousForegroundProcessName = QString();
     bool _monitorProcessFinish;
     bool _monitorOnce;
@@ -14,6 +14,12 @@
 
 namespace Konsole
 {
+// How many groups each session is currently a master of, across all
+// groups.  Sessions which master another group must receive broadcast
+// input through their emulation so its sendData signal reaches that
+// group's forwardData(); plain slaves can take the direct pty path.
+static QHash<Session *, int> s_masterUseCount;
+
 SessionGroup::SessionGroup(QObject *parent)
     : QObject(parent)
 {
@@ -61,8 +67,12 @@ void SessionGroup::setMasterStatus(Session *session, bool master)
     _sessions[session] = master;
 
     if (master) {
+        s_masterUseCount[session]++;
         connect(session->emulation(), &Konsole::Emulation::sendData, this, &Konsole::SessionGroup::forwardData);
     } else {
+        if (--s_masterUseCount[session] <= 0) {
+            s_masterUseCount.remove(session);
+        }
         disconnect(session->emulation(), &Konsole::Emulation::sendData, this, &Konsole::SessionGroup::forwardData);
     }
 }
@@ -79,10 +89,19 @@ void SessionGroup::forwardData(const QByteArray &data)
     }
 
     _inForwardData = true;
-    const QList<Session *> sessionsKeys = _sessions.keys();
-    for (Session *other : sessionsKeys) {
-        if (!_sessions[other]) {
-            other->emulation()->sendString(data);
+    // the master's emulation has already encoded the input into 'data';
+    // hand the bytes straight to each slave's batched pty send queue
+    // instead of a dispatch through every member's emulation
+    for (auto it = _sessions.constBegin(), end = _sessions.constEnd(); it != end; ++it) {
+        if (it.value()) {
+            continue;
+        }
+        if (s_masterUseCount.contains(it.key())) {
+            // masters of other groups must see the input on their
+            // emulation's sendData signal so it is forwarded onwards
+            it.key()->emulation()->sendString(data);
+        } else {
+            it.key()->sendRawInput(data);
         }
     }
     _inForwardData = false;
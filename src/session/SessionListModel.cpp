@@ -13,10 +13,13 @@
 #include <KLocalizedString>
 
 #include <QIcon>
+#include <QTimer>
 
 // Konsole
 #include "Session.h"
 
+#include <algorithm>
+
 using Konsole::Session;
 using Konsole::SessionListModel;
 
@@ -32,6 +35,9 @@ void SessionListModel::setSessions(const QList<Session *> &sessions)
 
     for (Session *session : sessions) {
         connect(session, &Konsole::Session::finished, this, &Konsole::SessionListModel::sessionFinished);
+        connect(session, &Konsole::Session::sessionAttributeChanged, this, [this, session]() {
+            scheduleTitleUpdate(session);
+        });
     }
 
     endResetModel();
@@ -111,13 +117,92 @@ QModelIndex SessionListModel::parent(const QModelIndex &) const
 
 void SessionListModel::sessionFinished(Session *session)
 {
-    int row = _sessions.indexOf(session);
+    if (!_sessions.contains(session) || _pendingRemovals.contains(session)) {
+        return;
+    }
+
+    _pendingRemovals.append(session);
+
+    // the session is destroyed through deleteLater(); flush before the
+    // object goes away so data() never dereferences a dangling pointer
+    connect(session, &QObject::destroyed, this, &SessionListModel::flushPendingRemovals);
+
+    if (!_removalFlushScheduled) {
+        _removalFlushScheduled = true;
+        QTimer::singleShot(0, this, &SessionListModel::flushPendingRemovals);
+    }
+}
+
+void SessionListModel::flushPendingRemovals()
+{
+    _removalFlushScheduled = false;
+    if (_pendingRemovals.isEmpty()) {
+        return;
+    }
 
-    if (row != -1) {
-        beginRemoveRows(QModelIndex(), row, row);
-        sessionRemoved(session);
-        _sessions.removeAt(row);
+    QList<int> rows;
+    rows.reserve(_pendingRemovals.count());
+    for (Session *session : std::as_const(_pendingRemovals)) {
+        const int row = _sessions.indexOf(session);
+        if (row != -1) {
+            rows.append(row);
+        }
+    }
+    _pendingRemovals.clear();
+    std::sort(rows.begin(), rows.end());
+
+    // remove contiguous runs back to front so the earlier rows stay valid
+    int end = rows.count() - 1;
+    while (end >= 0) {
+        int start = end;
+        while (start > 0 && rows[start - 1] == rows[start] - 1) {
+            start--;
+        }
+        beginRemoveRows(QModelIndex(), rows[start], rows[end]);
+        for (int i = end; i >= start; i--) {
+            Session *session = _sessions[rows[i]];
+            sessionRemoved(session);
+            _pendingTitleUpdates.remove(session);
+            _sessions.removeAt(rows[i]);
+        }
         endRemoveRows();
+        end = start - 1;
+    }
+}
+
+void SessionListModel::scheduleTitleUpdate(Session *session)
+{
+    // title changes arrive per session - a broadcast rename touches every
+    // row - so collect them and emit one dataChanged range per turn
+    _pendingTitleUpdates.insert(session);
+
+    if (!_titleFlushScheduled) {
+        _titleFlushScheduled = true;
+        QTimer::singleShot(0, this, &SessionListModel::flushTitleUpdates);
+    }
+}
+
+void SessionListModel::flushTitleUpdates()
+{
+    _titleFlushScheduled = false;
+    if (_pendingTitleUpdates.isEmpty()) {
+        return;
+    }
+
+    int firstRow = -1;
+    int lastRow = -1;
+    for (Session *session : std::as_const(_pendingTitleUpdates)) {
+        const int row = _sessions.indexOf(session);
+        if (row == -1) {
+            continue;
+        }
+        firstRow = firstRow == -1 ? row : qMin(firstRow, row);
+        lastRow = qMax(lastRow, row);
+    }
+    _pendingTitleUpdates.clear();
+
+    if (firstRow != -1) {
+        Q_EMIT dataChanged(index(firstRow, 1, QModelIndex()), index(lastRow, 1, QModelIndex()), {Qt::DisplayRole, Qt::DecorationRole});
     }
 }
 
@@ -11,6 +11,7 @@
 
 // Qt
 #include <QAbstractListModel>
+#include <QSet>
 #include <QVariant>
 
 namespace Konsole
@@ -56,8 +57,26 @@ protected:
 private Q_SLOTS:
     void sessionFinished(Session *session);
 
+    /**
+     * Removes the sessions collected by sessionFinished() in one pass.
+     * Sessions finish one at a time even when a whole window closes, so
+     * the removals of one event-loop turn are coalesced into contiguous
+     * range removals instead of storming every attached view per row.
+     */
+    void flushPendingRemovals();
+
+    /** Emits one dataChanged range for the titles collected by
+     * scheduleTitleUpdate() during this event-loop turn. */
+    void flushTitleUpdates();
+
 private:
+    void scheduleTitleUpdate(Session *session);
+
     QList<Session *> _sessions;
+    QList<Session *> _pendingRemovals;
+    QSet<Session *> _pendingTitleUpdates;
+    bool _removalFlushScheduled = false;
+    bool _titleFlushScheduled = false;
 };
 }
 
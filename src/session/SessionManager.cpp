@@ -31,6 +31,7 @@
 #include "profile/ProfileCommandParser.h"
 #include "profile/ProfileManager.h"
 
+#include "MemoryPressureMonitor.h"
 #include "Session.h"
 #include "VirtualSession.h"
 
@@ -43,6 +44,9 @@ SessionManager::SessionManager()
 {
     ProfileManager *profileMananger = ProfileManager::instance();
     connect(profileMananger, &Konsole::ProfileManager::profileChanged, this, &Konsole::SessionManager::profileChanged);
+
+    // bring up the memory-pressure trimmer alongside the session registry
+    MemoryPressureMonitor::instance();
 }
 
 SessionManager::~SessionManager()
@@ -147,9 +151,13 @@ void SessionManager::sessionTerminated(Session *session)
 
 void SessionManager::applyProfile(const Profile::Ptr &profile, bool modifiedPropertiesOnly)
 {
+    // the set of properties to apply is the same for every attached
+    // session, so resolve it once for the whole fleet
+    const ShouldApplyProperty apply(profile, modifiedPropertiesOnly);
+
     for (Session *session : std::as_const(_sessions)) {
         if (_sessionProfiles[session] == profile) {
-            applyProfile(session, profile, modifiedPropertiesOnly);
+            applyProfile(session, profile, apply);
         }
     }
 }
@@ -175,12 +183,15 @@ void SessionManager::setSessionProfile(Session *session, Profile::Ptr profile)
 }
 
 void SessionManager::applyProfile(Session *session, const Profile::Ptr &profile, bool modifiedPropertiesOnly)
+{
+    applyProfile(session, profile, ShouldApplyProperty(profile, modifiedPropertiesOnly));
+}
+
+void SessionManager::applyProfile(Session *session, const Profile::Ptr &profile, const ShouldApplyProperty &apply)
 {
     Q_ASSERT(profile);
     _sessionProfiles[session] = profile;
 
-    ShouldApplyProperty apply(profile, modifiedPropertiesOnly);
-
     // Basic session settings
     if (apply.shouldApply(Profile::Name)) {
         session->setTitle(Session::NameRole, profile->name());
@@ -24,6 +24,7 @@ namespace Konsole
 class Session;
 class VirtualSession;
 class Profile;
+class ShouldApplyProperty;
 
 /**
  * Manages running terminal sessions.
@@ -126,6 +127,11 @@ private:
     // returns true )
     void applyProfile(Session *session, const QExplicitlySharedDataPointer<Profile> &profile, bool modifiedPropertiesOnly);
 
+    // as above, but with the property delta already resolved; used by the
+    // all-sessions overload so the delta is computed once per profile
+    // change rather than once per attached session
+    void applyProfile(Session *session, const QExplicitlySharedDataPointer<Profile> &profile, const ShouldApplyProperty &apply);
+
     QList<Session *> _sessions; // list of running sessions
 
     QHash<Session *, QExplicitlySharedDataPointer<Profile>> _sessionProfiles;
@@ -0,0 +1,71 @@
+/*
+    This source file is part of Konsole, a terminal emulator.
+
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "SessionMonitorService.h"
+
+// Qt
+#include <QElapsedTimer>
+
+// Konsole
+#include "Session.h"
+
+using namespace Konsole;
+
+// granularity of the deadline checks; the shortest monitored interval
+// (silence seconds) is measured in whole seconds, so a coarse tick is
+// plenty accurate and keeps the service off the profiles it exists to fix
+static constexpr int CheckIntervalMsecs = 250;
+
+SessionMonitorService::SessionMonitorService()
+{
+    _checkTimer.setInterval(CheckIntervalMsecs);
+    connect(&_checkTimer, &QTimer::timeout, this, &SessionMonitorService::checkDeadlines);
+}
+
+Q_GLOBAL_STATIC(SessionMonitorService, theSessionMonitorService)
+SessionMonitorService *SessionMonitorService::instance()
+{
+    return theSessionMonitorService;
+}
+
+void SessionMonitorService::registerSession(Session *session)
+{
+    if (_sessions.contains(session)) {
+        return;
+    }
+    _sessions.append(session);
+    if (!_checkTimer.isActive()) {
+        _checkTimer.start();
+    }
+}
+
+void SessionMonitorService::unregisterSession(Session *session)
+{
+    _sessions.removeOne(session);
+    if (_sessions.isEmpty()) {
+        _checkTimer.stop();
+    }
+}
+
+qint64 SessionMonitorService::monotonicMs()
+{
+    static QElapsedTimer timer;
+    if (!timer.isValid()) {
+        timer.start();
+    }
+    return timer.elapsed();
+}
+
+void SessionMonitorService::checkDeadlines()
+{
+    const qint64 now = monotonicMs();
+    for (Session *session : std::as_const(_sessions)) {
+        session->checkMonitorDeadlines(now);
+    }
+}
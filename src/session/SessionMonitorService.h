@@ -0,0 +1,72 @@
+/*
+    This source file is part of Konsole, a terminal emulator.
+
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SESSIONMONITORSERVICE_H
+#define SESSIONMONITORSERVICE_H
+
+// Qt
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+class Session;
+
+/**
+ * Process-wide timing service for session activity and silence
+ * monitoring.
+ *
+ * Previously every monitored session ran two single-shot QTimers of its
+ * own and restarted the silence timer on every block of pty output,
+ * which shows up as timer churn in the event loop with hundreds of
+ * broadcast sessions.  Sessions now record activity as a plain
+ * monotonic timestamp on the receive path and register here; one coarse
+ * repeating timer evaluates the silence and activity-mask deadlines of
+ * all registered sessions against those timestamps.
+ */
+class KONSOLEPRIVATE_EXPORT SessionMonitorService : public QObject
+{
+    Q_OBJECT
+
+public:
+    SessionMonitorService();
+
+    /** Returns the monitor service instance. */
+    static SessionMonitorService *instance();
+
+    /**
+     * Starts deadline checks for @p session.  Registering a session
+     * which is already registered has no effect.  The check timer only
+     * runs while at least one session is registered.
+     */
+    void registerSession(Session *session);
+
+    /** Stops deadline checks for @p session. */
+    void unregisterSession(Session *session);
+
+    /**
+     * Returns a monotonic millisecond timestamp for use with the
+     * deadline checks.  This is a single clock read, cheap enough for
+     * the pty receive path.
+     */
+    static qint64 monotonicMs();
+
+private Q_SLOTS:
+    void checkDeadlines();
+
+private:
+    QList<Session *> _sessions;
+    QTimer _checkTimer;
+};
+}
+
+#endif // SESSIONMONITORSERVICE_H
@@ -24,6 +24,13 @@ void VirtualSession::injectData(const char *data, int length)
     }
 }
 
+void VirtualSession::injectData(const QList<QByteArray> &buffers)
+{
+    if (_emulation) {
+        _emulation->receiveData(buffers);
+    }
+}
+
 void VirtualSession::setExternalProcessName(const QString &name)
 {
     auto *nullInfo = static_cast<NullProcessInfo *>(_sessionProcessInfo);
@@ -28,6 +28,13 @@ public:
 
     void injectData(const char *data, int length);
 
+    /**
+     * Scatter-gather variant: injects a list of already-framed buffers
+     * (e.g. decoded tmux %output batches) as one emulation pass without
+     * joining them first.
+     */
+    void injectData(const QList<QByteArray> &buffers);
+
     void setExternalProcessName(const QString &name);
     void setExternalCurrentDir(const QString &dir);
     void setExternalPaneTitle(const QString &title);
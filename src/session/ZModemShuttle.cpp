@@ -0,0 +1,343 @@
+/*
+    This source file is part of Konsole, a terminal emulator.
+
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "ZModemShuttle.h"
+
+#ifndef Q_OS_WIN
+
+// Qt
+#include <QVector>
+
+// System
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace Konsole;
+
+// read/write granularity of the shuttle
+static const int ChunkSize = 256 * 1024;
+// per-direction buffering cap; reading from the faster side pauses until
+// the slower side drains below this, so memory stays bounded no matter
+// how large the transfer is
+static const int BufferHighWater = 1024 * 1024;
+// floor for progress() emissions
+static const int ProgressIntervalMsecs = 100;
+
+namespace
+{
+// a byte queue consumed from the front without repeated memmoves; the
+// dead head space is reclaimed once it outgrows the live data
+struct ShuttleBuffer {
+    QByteArray data;
+    int head = 0;
+
+    int pending() const
+    {
+        return data.size() - head;
+    }
+
+    void append(const char *bytes, int length)
+    {
+        data.append(bytes, length);
+    }
+
+    void consume(int length)
+    {
+        head += length;
+        if (head >= data.size()) {
+            data.clear();
+            head = 0;
+        } else if (head > data.size() - head) {
+            data.remove(0, head);
+            head = 0;
+        }
+    }
+};
+
+void closeFd(int &fd)
+{
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void setNonBlocking(int fd)
+{
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+}
+
+ZModemShuttle::ZModemShuttle(int ptyMasterFd, const QString &program, const QStringList &arguments, const QString &workingDirectory, QObject *parent)
+    : QThread(parent)
+    , _ptyFd(ptyMasterFd)
+    , _program(program)
+    , _arguments(arguments)
+    , _workingDirectory(workingDirectory)
+{
+    // created on the owning thread and closed only in the destructor
+    // after wait(), so cancel() can write the token from any thread
+    // without racing the worker's teardown over the fd value
+    if (::pipe(_cancelPipe) != 0) {
+        _cancelPipe[0] = -1;
+        _cancelPipe[1] = -1;
+    }
+}
+
+ZModemShuttle::~ZModemShuttle()
+{
+    cancel();
+    wait();
+    closeFd(_cancelPipe[0]);
+    closeFd(_cancelPipe[1]);
+}
+
+void ZModemShuttle::cancel()
+{
+    if (_cancelPipe[1] >= 0) {
+        char token = 'x';
+        // a failed write just means run() is already past the poll loop
+        if (::write(_cancelPipe[1], &token, 1) < 0) {
+        }
+    }
+}
+
+bool ZModemShuttle::spawnChild()
+{
+    int in[2] = {-1, -1};
+    int out[2] = {-1, -1};
+    int err[2] = {-1, -1};
+    if (::pipe(in) != 0 || ::pipe(out) != 0 || ::pipe(err) != 0) {
+        for (int *p : {in, out, err}) {
+            closeFd(p[0]);
+            closeFd(p[1]);
+        }
+        return false;
+    }
+
+    // keep the encoded arguments alive across the exec
+    QVector<QByteArray> argStorage;
+    argStorage.append(_program.toLocal8Bit());
+    for (const QString &argument : _arguments) {
+        argStorage.append(argument.toLocal8Bit());
+    }
+    QVector<char *> argv;
+    argv.reserve(argStorage.size() + 1);
+    for (QByteArray &arg : argStorage) {
+        argv.append(arg.data());
+    }
+    argv.append(nullptr);
+    const QByteArray workDir = _workingDirectory.toLocal8Bit();
+
+    const pid_t pid = ::fork();
+    if (pid < 0) {
+        for (int *p : {in, out, err}) {
+            closeFd(p[0]);
+            closeFd(p[1]);
+        }
+        return false;
+    }
+
+    if (pid == 0) {
+        ::dup2(in[0], STDIN_FILENO);
+        ::dup2(out[1], STDOUT_FILENO);
+        ::dup2(err[1], STDERR_FILENO);
+        for (int *p : {in, out, err}) {
+            ::close(p[0]);
+            ::close(p[1]);
+        }
+        if (!workDir.isEmpty() && ::chdir(workDir.constData()) != 0) {
+            ::_exit(1);
+        }
+        ::execvp(argv[0], argv.data());
+        ::_exit(1);
+    }
+
+    ::close(in[0]);
+    ::close(out[1]);
+    ::close(err[1]);
+    _childPid = pid;
+    _childIn = in[1];
+    _childOut = out[0];
+    _childErr = err[0];
+    setNonBlocking(_childIn);
+    setNonBlocking(_childOut);
+    setNonBlocking(_childErr);
+    return true;
+}
+
+void ZModemShuttle::drainStatus(const char *data, int length)
+{
+    // same CR/LF splitting Session::zmodemReadStatus() used: rz/sz
+    // progress lines end in CR, messages in LF
+    QByteArray msg(data, length);
+    while (!msg.isEmpty()) {
+        const int i = msg.indexOf('\015');
+        const int j = msg.indexOf('\012');
+        QByteArray txt;
+        if ((i != -1) && ((j == -1) || (i < j))) {
+            msg = msg.mid(i + 1);
+        } else if (j != -1) {
+            txt = msg.left(j);
+            msg = msg.mid(j + 1);
+        } else {
+            txt = msg;
+            msg.truncate(0);
+        }
+        if (!txt.isEmpty()) {
+            Q_EMIT statusText(QString::fromLocal8Bit(txt));
+        }
+    }
+}
+
+void ZModemShuttle::reportProgress(bool force)
+{
+    if (_bytesToPty == _lastReportedToPty && _bytesFromPty == _lastReportedFromPty) {
+        return;
+    }
+    if (!force && _reportTimer.elapsed() - _lastReportMsecs < ProgressIntervalMsecs) {
+        return;
+    }
+    _lastReportMsecs = _reportTimer.elapsed();
+    _lastReportedToPty = _bytesToPty;
+    _lastReportedFromPty = _bytesFromPty;
+    Q_EMIT progress(_bytesToPty, _bytesFromPty);
+}
+
+void ZModemShuttle::run()
+{
+    if (_cancelPipe[0] < 0 || !spawnChild()) {
+        Q_EMIT transferFinished(-1);
+        return;
+    }
+
+    _reportTimer.start();
+
+    // writing to the child after it exited must fail with EPIPE instead
+    // of raising SIGPIPE at process scope
+    sigset_t pipeSet;
+    sigemptyset(&pipeSet);
+    sigaddset(&pipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSet, nullptr);
+
+    ShuttleBuffer toChild; // pty -> child (downloads)
+    ShuttleBuffer toPty; // child -> pty (uploads)
+    char chunk[ChunkSize];
+    bool cancelled = false;
+
+    while (true) {
+        struct pollfd fds[5];
+        // a negative fd makes poll() skip the entry
+        fds[0] = {_cancelPipe[0], POLLIN, 0};
+        fds[1] = {-1, 0, 0};
+        if (toPty.pending() > 0) {
+            fds[1] = {_ptyFd, POLLOUT, 0};
+        }
+        if (_childIn >= 0 && toChild.pending() < BufferHighWater) {
+            fds[1].fd = _ptyFd;
+            fds[1].events |= POLLIN;
+        }
+        fds[2] = {(_childOut >= 0 && toPty.pending() < BufferHighWater) ? _childOut : -1, POLLIN, 0};
+        fds[3] = {_childErr, POLLIN, 0};
+        fds[4] = {toChild.pending() > 0 ? _childIn : -1, POLLOUT, 0};
+
+        if (::poll(fds, 5, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if ((fds[0].revents & POLLIN) != 0) {
+            cancelled = true;
+            break;
+        }
+
+        if ((fds[1].revents & POLLIN) != 0) {
+            const int room = qMin(ChunkSize, BufferHighWater - toChild.pending());
+            const ssize_t n = ::read(_ptyFd, chunk, room);
+            if (n > 0) {
+                toChild.append(chunk, int(n));
+                _bytesFromPty += n;
+            }
+        }
+        if ((fds[1].revents & POLLOUT) != 0) {
+            const ssize_t n = ::write(_ptyFd, toPty.data.constData() + toPty.head, toPty.pending());
+            if (n > 0) {
+                toPty.consume(int(n));
+                _bytesToPty += n;
+            }
+        }
+
+        if (fds[2].fd >= 0 && (fds[2].revents & (POLLIN | POLLHUP)) != 0) {
+            const int room = qMin(ChunkSize, BufferHighWater - toPty.pending());
+            const ssize_t n = ::read(_childOut, chunk, room);
+            if (n > 0) {
+                toPty.append(chunk, int(n));
+            } else if (n == 0) {
+                closeFd(_childOut);
+            }
+        }
+
+        if (fds[3].fd >= 0 && (fds[3].revents & (POLLIN | POLLHUP)) != 0) {
+            const ssize_t n = ::read(_childErr, chunk, sizeof(chunk));
+            if (n > 0) {
+                drainStatus(chunk, int(n));
+            } else if (n == 0) {
+                closeFd(_childErr);
+            }
+        }
+
+        if (fds[4].fd >= 0 && (fds[4].revents & (POLLOUT | POLLERR | POLLHUP)) != 0) {
+            const ssize_t n = ::write(_childIn, toChild.data.constData() + toChild.head, toChild.pending());
+            if (n > 0) {
+                toChild.consume(int(n));
+            } else if (n < 0 && errno == EPIPE) {
+                closeFd(_childIn);
+            }
+        }
+
+        reportProgress();
+
+        // done once the child closed both output channels and everything
+        // it produced reached the pty
+        if (_childOut < 0 && _childErr < 0 && toPty.pending() == 0) {
+            break;
+        }
+    }
+
+    // the cancel pipe stays open until the destructor: closing either end
+    // here would race a concurrent cancel() on another thread, both on the
+    // fd values and by letting its write hit a closed or reused descriptor
+    closeFd(_childIn);
+    closeFd(_childOut);
+    closeFd(_childErr);
+
+    if (cancelled && _childPid > 0) {
+        ::kill(pid_t(_childPid), SIGTERM);
+    }
+    int status = 0;
+    int exitCode = -1;
+    if (_childPid > 0 && ::waitpid(pid_t(_childPid), &status, 0) == pid_t(_childPid) && WIFEXITED(status)) {
+        exitCode = WEXITSTATUS(status);
+    }
+
+    reportProgress(true);
+    Q_EMIT transferFinished(cancelled ? -1 : exitCode);
+}
+
+#include "moc_ZModemShuttle.cpp"
+
+#endif // Q_OS_WIN
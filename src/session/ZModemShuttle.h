@@ -0,0 +1,107 @@
+/*
+    This source file is part of Konsole, a terminal emulator.
+
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef ZMODEMSHUTTLE_H
+#define ZMODEMSHUTTLE_H
+
+// Qt
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+// Konsole
+#include "konsoleprivate_export.h"
+
+#ifndef Q_OS_WIN
+
+namespace Konsole
+{
+/**
+ * Shuttles a ZModem transfer between the session's pty and an rz/sz child
+ * process on its own thread, so multi-gigabyte transfers neither block the
+ * GUI thread nor buffer unbounded amounts of data.
+ *
+ * The shuttle spawns the child itself and moves data with large bounded
+ * buffers in both directions; the GUI thread only receives throttled
+ * progress() updates and the child's stderr status lines.  The caller must
+ * suspend the pty's own reader for the duration of the transfer and keep
+ * the pty alive until transferFinished() has been emitted and the thread
+ * has been joined.
+ */
+class KONSOLEPRIVATE_EXPORT ZModemShuttle : public QThread
+{
+    Q_OBJECT
+
+public:
+    ZModemShuttle(int ptyMasterFd, const QString &program, const QStringList &arguments, const QString &workingDirectory, QObject *parent = nullptr);
+    ~ZModemShuttle() override;
+
+    /**
+     * Asks the shuttle to stop: the child is terminated and run() returns
+     * once in-flight buffers are dropped.  Safe to call from any thread;
+     * returns immediately.
+     */
+    void cancel();
+
+Q_SIGNALS:
+    /** A line of status output from the child's stderr (rz/sz progress). */
+    void statusText(const QString &text);
+
+    /**
+     * Throttled byte counters: data written to the pty (uploads) and data
+     * read from the pty (downloads) since the transfer started.
+     */
+    void progress(qint64 bytesToPty, qint64 bytesFromPty);
+
+    /** The transfer ended; @p exitCode is the child's exit code, -1 on error or cancel. */
+    void transferFinished(int exitCode);
+
+protected:
+    void run() override;
+
+private:
+    // forks and execs the child with pipes on stdin/stdout/stderr;
+    // returns false when the child could not be started
+    bool spawnChild();
+
+    // splits accumulated stderr output on CR/LF and emits statusText()
+    // per complete line
+    void drainStatus(const char *data, int length);
+
+    // emits progress() at most every ProgressIntervalMsecs
+    void reportProgress(bool force = false);
+
+    const int _ptyFd;
+    const QString _program;
+    const QStringList _arguments;
+    const QString _workingDirectory;
+
+    qint64 _childPid = -1;
+    int _childIn = -1;
+    int _childOut = -1;
+    int _childErr = -1;
+    // written by cancel() to wake the poll loop; created in the
+    // constructor and closed in the destructor after wait(), never by
+    // run(), so the fds are stable while any thread can still cancel()
+    int _cancelPipe[2] = {-1, -1};
+
+    QElapsedTimer _reportTimer;
+    qint64 _bytesToPty = 0;
+    qint64 _bytesFromPty = 0;
+    qint64 _lastReportedToPty = 0;
+    qint64 _lastReportedFromPty = 0;
+    qint64 _lastReportMsecs = 0;
+};
+
+}
+
+#endif // Q_OS_WIN
+
+#endif // ZMODEMSHUTTLE_H
@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// Own
+#include "BlinkTimerService.h"
+
+// Konsole
+#include "TerminalDisplay.h"
+
+// Qt
+#include <QApplication>
+
+using namespace Konsole;
+
+BlinkTimerService *BlinkTimerService::instance()
+{
+    static BlinkTimerService service;
+    return &service;
+}
+
+BlinkTimerService::BlinkTimerService()
+{
+    _cursorTimer.setInterval(QApplication::cursorFlashTime() / 2);
+    connect(&_cursorTimer, &QTimer::timeout, this, &BlinkTimerService::tickCursor);
+
+    _textTimer.setInterval(TextBlinkInterval);
+    connect(&_textTimer, &QTimer::timeout, this, &BlinkTimerService::tickText);
+}
+
+void BlinkTimerService::subscribeCursor(TerminalDisplay *display)
+{
+    if (!_cursorSubscribers.contains(display)) {
+        _cursorSubscribers.append(display);
+    }
+    if (!_cursorTimer.isActive()) {
+        _cursorTimer.start();
+    }
+}
+
+void BlinkTimerService::unsubscribeCursor(TerminalDisplay *display)
+{
+    _cursorSubscribers.removeAll(display);
+    if (_cursorSubscribers.isEmpty()) {
+        _cursorTimer.stop();
+    }
+}
+
+void BlinkTimerService::subscribeText(TerminalDisplay *display)
+{
+    if (!_textSubscribers.contains(display)) {
+        _textSubscribers.append(display);
+    }
+    if (!_textTimer.isActive()) {
+        _textTimer.start();
+    }
+}
+
+void BlinkTimerService::unsubscribeText(TerminalDisplay *display)
+{
+    _textSubscribers.removeAll(display);
+    if (_textSubscribers.isEmpty()) {
+        _textTimer.stop();
+    }
+}
+
+void BlinkTimerService::tickCursor()
+{
+    // subscribers are QPointers so a display deleted without
+    // unsubscribing (destruction order at shutdown) is just skipped
+    for (const auto &display : std::as_const(_cursorSubscribers)) {
+        if (!display.isNull()) {
+            display->cursorBlinkTick();
+        }
+    }
+}
+
+void BlinkTimerService::tickText()
+{
+    for (const auto &display : std::as_const(_textSubscribers)) {
+        if (!display.isNull()) {
+            display->textBlinkTick();
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kurt Hindenburg <kurt.hindenburg@gmail.com>
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef BLINKTIMERSERVICE_H
+#define BLINKTIMERSERVICE_H
+
+// Qt
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include "konsoleprivate_export.h"
+
+namespace Konsole
+{
+class TerminalDisplay;
+
+/**
+ * Process-wide fan-out of cursor and text blink ticks.
+ *
+ * Every TerminalDisplay used to run its own pair of blink timers, so a
+ * window wall of N displays woke the event loop 2*N times per blink
+ * period, all out of phase.  This service runs one timer per blink kind
+ * and delivers phase-aligned ticks to the displays subscribed to it;
+ * displays subscribe only while they actually blink (focused cursor,
+ * blinking text present on screen), so idle displays cost nothing.  A
+ * timer stops entirely while it has no subscribers.
+ */
+class KONSOLEPRIVATE_EXPORT BlinkTimerService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static BlinkTimerService *instance();
+
+    /** Starts delivering cursor blink ticks to @p display; idempotent. */
+    void subscribeCursor(TerminalDisplay *display);
+    void unsubscribeCursor(TerminalDisplay *display);
+
+    /** Starts delivering text blink ticks to @p display; idempotent. */
+    void subscribeText(TerminalDisplay *display);
+    void unsubscribeText(TerminalDisplay *display);
+
+private:
+    BlinkTimerService();
+
+    void tickCursor();
+    void tickText();
+
+    // the delay in milliseconds between redrawing blinking text
+    static constexpr int TextBlinkInterval = 500;
+
+    QTimer _cursorTimer;
+    QTimer _textTimer;
+    QList<QPointer<TerminalDisplay>> _cursorSubscribers;
+    QList<QPointer<TerminalDisplay>> _textSubscribers;
+};
+
+}
+
+#endif // BLINKTIMERSERVICE_H
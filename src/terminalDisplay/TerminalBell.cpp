@@ -30,6 +30,12 @@ TerminalBell::TerminalBell(Enum::BellModeEnum bellMode)
 
 void TerminalBell::bell(TerminalDisplay *terminalDisplay, const QString &message, bool terminalHasFocus)
 {
+    // bells already arrive coalesced per Emulation::reportBell() window;
+    // the mask is a second line of defence for callers that bypass it
+    if (_bellMasked) {
+        return;
+    }
+
     switch (_bellMode) {
     case Enum::SystemBeepBell:
         QApplication::beep();
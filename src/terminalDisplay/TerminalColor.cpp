@@ -51,6 +51,14 @@ QColor TerminalColor::foregroundColor() const
 void TerminalColor::setColorTable(const QColor *table)
 {
     std::copy(table, table + TABLE_COLORS, m_colorTable);
+    // refresh the flat 256-color snapshot in one go; only its first 16
+    // entries depend on the scheme, the cube and gray ramp are fixed.
+    // The default fore/background swaps (visualBell) don't touch the
+    // entries the snapshot is derived from, so this is the only spot
+    // where it needs rebuilding.
+    for (int i = 0; i < 256; i++) {
+        m_color256Table[i] = color256(quint8(i), m_colorTable);
+    }
     setBackgroundColor(m_colorTable[DEFAULT_BACK_COLOR]);
     onColorsChanged();
 }
@@ -60,6 +68,11 @@ const QColor *TerminalColor::colorTable() const
     return m_colorTable;
 }
 
+const QColor *TerminalColor::color256Table() const
+{
+    return m_color256Table;
+}
+
 void TerminalColor::setOpacity(qreal opacity)
 {
     QColor color(m_blendColor);
@@ -36,6 +36,15 @@ public:
     void setColorTable(const QColor *table);
     const QColor *colorTable() const;
 
+    /**
+     * Returns the fully resolved 256-color palette for the current color
+     * table: the first 16 entries track the scheme's system colors, the
+     * rest are the color cube and gray ramp. Rebuilt whenever the color
+     * table changes, so paint code can resolve an indexed color with a
+     * single load instead of recomputing the cube entry per fragment.
+     */
+    const QColor *color256Table() const;
+
     void onColorsChanged();
 
     void setOpacity(qreal opacity);
@@ -77,6 +86,7 @@ private:
     QColor m_defaultBackColor;
 
     QColor m_colorTable[TABLE_COLORS];
+    QColor m_color256Table[256];
 };
 }
 
@@ -27,12 +27,15 @@
 #include <QLabel>
 #include <QMimeData>
 #include <QPainter>
+#include <QScreen>
 #include <QScrollEvent>
 #include <QScrollPrepareEvent>
 #include <QScroller>
 #include <QStyle>
+#include <QTextStream>
 #include <QTimer>
 #include <QVBoxLayout>
+#include <QVarLengthArray>
 
 // KDE
 #include <KColorScheme>
@@ -46,6 +49,7 @@
 #include <KShell>
 
 // Konsole
+#include "BlinkTimerService.h"
 #include "extras/AutoScrollHandler.h"
 #include "extras/CompositeWidgetFocusWatcher.h"
 
@@ -59,8 +63,12 @@
 #include "../widgets/TerminalDisplayAccessible.h"
 #include "Emulation.h" // to connect the URL escape sequence extractor
 #include "EscapeSequenceUrlExtractor.h"
+#include "AllocationTracker.h"
+#include "PipelineMetrics.h"
 #include "PrintOptions.h"
 #include "Screen.h"
+#include "SelectionMimeData.h"
+#include "StartupProfiler.h"
 #include "ViewManager.h" // for colorSchemeForProfile. // TODO: Rewrite this.
 #include "widgets/ViewSplitter.h"
 #include "WindowSystemInfo.h"
@@ -80,6 +88,12 @@
 #include "unicode/ushape.h"
 #include "unicode/utypes.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #define MAX_LINE_WIDTH 1024
 
 using namespace Konsole;
@@ -228,6 +242,9 @@ TerminalDisplay::TerminalDisplay(QWidget *parent)
 
     _contentRect = QRect(_margin, _margin, 1, 1);
 
+    updateCharClassTable();
+    updateDirtyRectInflation();
+
     // create scroll bar for scrolling output up and down
     _scrollBar = new TerminalScrollBar(this);
     _scrollBar->setAutoFillBackground(false);
@@ -245,15 +262,16 @@ TerminalDisplay::TerminalDisplay(QWidget *parent)
     _hoverLinkIndicator->setStyleSheet(QStringLiteral("background-color:palette(window); padding: 2px;"));
     _hoverLinkIndicator->setVisible(false);
 
-    // setup timers for blinking text
-    _blinkTextTimer = new QTimer(this);
-    _blinkTextTimer->setInterval(TEXT_BLINK_DELAY);
-    connect(_blinkTextTimer, &QTimer::timeout, this, &Konsole::TerminalDisplay::blinkTextEvent);
+    // paces wheel scrolling of the history to one combined move per frame
+    _wheelFlushTimer = new QTimer(this);
+    _wheelFlushTimer->setSingleShot(true);
+    connect(_wheelFlushTimer, &QTimer::timeout, this, &Konsole::TerminalDisplay::flushScrollWheel);
 
-    // setup timers for blinking cursor
-    _blinkCursorTimer = new QTimer(this);
-    _blinkCursorTimer->setInterval(QApplication::cursorFlashTime() / 2);
-    connect(_blinkCursorTimer, &QTimer::timeout, this, &Konsole::TerminalDisplay::blinkCursorEvent);
+    // publishes PRIMARY when a drag selection pauses instead of per move
+    _primarySettleTimer = new QTimer(this);
+    _primarySettleTimer->setSingleShot(true);
+    _primarySettleTimer->setInterval(300);
+    connect(_primarySettleTimer, &QTimer::timeout, this, &Konsole::TerminalDisplay::updatePrimarySelection);
 
     // hide mouse cursor on keystroke or idle
     KCursor::setAutoHideCursor(this, true);
@@ -316,6 +334,10 @@ TerminalDisplay::TerminalDisplay(QWidget *parent)
 
     _terminalColor = new TerminalColor(this);
     connect(_terminalColor, &TerminalColor::onPalette, _scrollBar, &TerminalScrollBar::updatePalette);
+    // a color scheme change invalidates the retained primary-screen frame
+    connect(_terminalColor, &TerminalColor::onPalette, this, [this] {
+        discardPrimaryScreenSnapshot();
+    });
 
     _terminalPainter = new TerminalPainter(this);
 
@@ -347,8 +369,8 @@ TerminalDisplay::TerminalDisplay(QWidget *parent)
 
 TerminalDisplay::~TerminalDisplay()
 {
-    disconnect(_blinkTextTimer);
-    disconnect(_blinkCursorTimer);
+    BlinkTimerService::instance()->unsubscribeCursor(this);
+    BlinkTimerService::instance()->unsubscribeText(this);
 
     delete[] _image;
     delete _filterChain;
@@ -454,20 +476,100 @@ void TerminalDisplay::processFilters()
         return;
     }
 
-    const QRegion preUpdateHotSpots = _filterChain->hotSpotRegion();
+    // a scan of the previous image may still be running; ask it to stop
+    // and keep _filterUpdateRequired set - its completion calls back here
+    // and the new image is picked up then
+    if (_filterChain->scanInFlight()) {
+        _filterChain->cancelScan();
+        return;
+    }
 
     // use _screenWindow->getImage() here rather than _image because
     // other classes may call processFilters() when this display's
     // ScreenWindow emits a scrolled() signal - which will happen before
     // updateImage() is called on the display and therefore _image is
     // out of date at this point
-    _filterChain->setImage(_screenWindow->getImage(), _screenWindow->windowLines(), _screenWindow->windowColumns(), _screenWindow->getLineProperties());
-    _filterChain->process();
+    Character *image = _screenWindow->getImage();
+
+    // identifies this exact viewport so the decoded snapshot can be
+    // exchanged with the session's other views; read after getImage() so
+    // the generation matches the buffer contents
+    SessionScanCache::ViewportKey viewportKey;
+    if (Screen *screen = _screenWindow->screen()) {
+        viewportKey.screen = screen;
+        viewportKey.generation = screen->contentGeneration();
+        viewportKey.currentLine = _screenWindow->currentLine();
+        viewportKey.lines = _screenWindow->windowLines();
+        viewportKey.columns = _screenWindow->windowColumns();
+    }
+
+    _filterChain->setImage(image, _screenWindow->windowLines(), _screenWindow->windowColumns(), _screenWindow->getLineProperties(), viewportKey);
+    _filterChain->processAsync(this);
+    _filterUpdateRequired = false;
+}
+
+// Returns the index of the first cell in [start, count) whose bytes differ
+// between the two rows, or count if the remainder is byte-identical.
+// Byte-equal cells are always equal under Character::operator==, so this
+// can skip over unchanged runs 32 bytes at a time; callers must still
+// re-check a reported cell with the cell comparison, which unlike the
+// byte comparison ignores the extra flags.
+static inline int findFirstModifiedCell(const Character *oldLine, const Character *newLine, int start, int count)
+{
+    static_assert(sizeof(Character) == 16, "wide row compare assumes 16-byte cells");
+    const uchar *a = reinterpret_cast<const uchar *>(oldLine);
+    const uchar *b = reinterpret_cast<const uchar *>(newLine);
+    int x = start;
+#if defined(__SSE2__)
+    for (; x + 2 <= count; x += 2) {
+        const auto *pa = reinterpret_cast<const __m128i *>(a + size_t(x) * sizeof(Character));
+        const auto *pb = reinterpret_cast<const __m128i *>(b + size_t(x) * sizeof(Character));
+        const __m128i eq0 = _mm_cmpeq_epi8(_mm_loadu_si128(pa), _mm_loadu_si128(pb));
+        const __m128i eq1 = _mm_cmpeq_epi8(_mm_loadu_si128(pa + 1), _mm_loadu_si128(pb + 1));
+        if (_mm_movemask_epi8(_mm_and_si128(eq0, eq1)) != 0xffff) {
+            return _mm_movemask_epi8(eq0) != 0xffff ? x : x + 1;
+        }
+    }
+#elif defined(__aarch64__)
+    for (; x + 2 <= count; x += 2) {
+        const uchar *pa = a + size_t(x) * sizeof(Character);
+        const uchar *pb = b + size_t(x) * sizeof(Character);
+        const uint8x16_t eq0 = vceqq_u8(vld1q_u8(pa), vld1q_u8(pb));
+        const uint8x16_t eq1 = vceqq_u8(vld1q_u8(pa + 16), vld1q_u8(pb + 16));
+        if (vminvq_u8(vandq_u8(eq0, eq1)) != 0xff) {
+            return vminvq_u8(eq0) != 0xff ? x : x + 1;
+        }
+    }
+#endif
+    for (; x < count; ++x) {
+        if (memcmp(a + size_t(x) * sizeof(Character), b + size_t(x) * sizeof(Character), sizeof(Character)) != 0) {
+            return x;
+        }
+    }
+    return count;
+}
 
-    const QRegion postUpdateHotSpots = _filterChain->hotSpotRegion();
+// Shifts the cached line properties the same way scrollImage() shifted the
+// internal image, mirroring its region capping.
+void TerminalDisplay::scrollLineProperties(int lines, QRect region)
+{
+    region.setBottom(qMin(region.bottom(), _lines - 2));
+    const int linesToMove = region.height() - abs(lines);
+    const int count = _lineProperties.count();
 
-    update(preUpdateHotSpots | postUpdateHotSpots);
-    _filterUpdateRequired = false;
+    if (lines > 0) {
+        for (int y = region.top(); y < region.top() + linesToMove; ++y) {
+            if (y >= 0 && y + lines < count) {
+                _lineProperties[y] = _lineProperties[y + lines];
+            }
+        }
+    } else {
+        for (int y = region.top() + linesToMove - 1; y >= region.top(); --y) {
+            if (y >= 0 && y - lines < count) {
+                _lineProperties[y - lines] = _lineProperties[y];
+            }
+        }
+    }
 }
 
 void TerminalDisplay::updateImage()
@@ -476,6 +578,15 @@ void TerminalDisplay::updateImage()
         return;
     }
 
+    // content is changing, so the next repaint must not take the
+    // dim-overlay-only shortcut in paintEvent()
+    _dimOverlayOnlyPending = false;
+
+    if (PipelineMetrics::enabled()) {
+        PipelineMetrics::instance()->recordUpdateImageStart();
+    }
+    PipelineMetrics::ScopedTimer timer(PipelineMetrics::UpdateImageStage);
+
     // Better control over screen resizing visual glitches
     _screenWindow->updateCurrentLine();
 
@@ -494,7 +605,15 @@ void TerminalDisplay::updateImage()
             if (viewResizeWidget) {
                 _resizeWidget->hide();
             }
-            _scrollBar->scrollImage(_screenWindow->scrollCount(), _screenWindow->scrollRegion(), _image, _imageSize);
+            const int scrollCount = _screenWindow->scrollCount();
+            const QRect scrollRegion = _screenWindow->scrollRegion();
+            if (_scrollBar->scrollImage(scrollCount, scrollRegion, _image, _imageSize)) {
+                // keep the cached line properties aligned with the blitted
+                // image, otherwise every moved line looks property-changed
+                // below and gets repainted despite the blit; this makes
+                // scrolling through history cost only the entering lines
+                scrollLineProperties(scrollCount, scrollRegion);
+            }
             if (viewResizeWidget) {
                 _resizeWidget->show();
             }
@@ -524,7 +643,6 @@ void TerminalDisplay::updateImage()
     const QPoint tL = contentsRect().topLeft();
     const int tLx = tL.x();
     const int tLy = tL.y();
-    _hasTextBlinker = false;
 
     CharacterColor cf; // undefined
 
@@ -534,10 +652,32 @@ void TerminalDisplay::updateImage()
     auto dirtyMask = new char[columnsToUpdate + 2];
     QRegion dirtyRegion;
 
+    // Dirty rows are flagged in a flat array and merged into rectangles
+    // after the diff; or-ing one QRect per row into the region made
+    // fragmented updates (e.g. syntax-highlighted vim) pay for hundreds
+    // of QRegion unions per frame.
+    QVarLengthArray<bool, 128> rowDirty(linesToUpdate);
+    rowDirty.fill(false);
+
     std::optional<int> startDirtyIndex;
     std::optional<int> endDirtyIndex;
 
+    // Per-line blink flags survive skipped lines, so the global blink state
+    // stays correct without rescanning the whole image every update.
+    if (_lineHasBlinker.size() != linesToUpdate) {
+        _lineHasBlinker.fill(false);
+        _lineHasBlinker.resize(linesToUpdate);
+        _blinkingLineCount = 0;
+    }
+
     for (y = 0; y < linesToUpdate; ++y) {
+        // The screen tracks which lines changed since our last update; a
+        // clean line with unchanged properties needs no diff and no copy.
+        const bool linePropertiesChanged = y >= _lineProperties.count() || y >= newLineProperties.count() || _lineProperties[y] != newLineProperties[y];
+        if (!linePropertiesChanged && !_screenWindow->isLineDirty(y)) {
+            continue;
+        }
+
         const Character *currentLine = &_image[y * _columns];
         const Character *const newLine = &newimg[y * columns];
 
@@ -549,6 +689,12 @@ void TerminalDisplay::updateImage()
         memset(dirtyMask, 0, columnsToUpdate + 2);
 
         for (x = 0; x < columnsToUpdate; ++x) {
+            // wide byte compares skip over unchanged runs; only cells whose
+            // bytes differ need the (narrower) cell comparison
+            x = findFirstModifiedCell(currentLine, newLine, x, columnsToUpdate);
+            if (x == columnsToUpdate) {
+                break;
+            }
             if (newLine[x] != currentLine[x]) {
                 dirtyMask[x] = 1;
 
@@ -560,9 +706,10 @@ void TerminalDisplay::updateImage()
             }
         }
 
+        bool lineHasBlinker = false;
         if (!_resizing) { // not while _resizing, we're expecting a paintEvent
             for (x = 0; x < columnsToUpdate; ++x) {
-                _hasTextBlinker |= newLine[x].rendition.f.blink;
+                lineHasBlinker |= (newLine[x].rendition.f.blink != 0);
 
                 // Start drawing if this character or the next one differs.
                 // We also take the next one into account to handle the situation
@@ -599,21 +746,19 @@ void TerminalDisplay::updateImage()
             }
         }
 
-        if (y >= _lineProperties.count() || y >= newLineProperties.count() || _lineProperties[y] != newLineProperties[y]) {
+        if (_lineHasBlinker.testBit(y) != lineHasBlinker) {
+            _lineHasBlinker.setBit(y, lineHasBlinker);
+            _blinkingLineCount += lineHasBlinker ? 1 : -1;
+        }
+
+        if (linePropertiesChanged) {
             updateLine = true;
         }
 
         // if the characters on the line are different in the old and the new _image
         // then this line must be repainted.
         if (updateLine) {
-            // add the area occupied by this line to the region which needs to be
-            // repainted
-            QRect dirtyRect = QRect(_contentRect.left() + tLx,
-                                    _contentRect.top() + tLy + _terminalFont->fontHeight() * y,
-                                    _terminalFont->fontWidth() * columnsToUpdate,
-                                    _terminalFont->fontHeight());
-
-            dirtyRegion |= highdpi_adjust_rect(dirtyRect);
+            rowDirty[y] = true;
         }
 
         // replace the line of characters in the old _image with the
@@ -621,6 +766,25 @@ void TerminalDisplay::updateImage()
         memcpy((void *)currentLine, (const void *)newLine, columnsToUpdate * sizeof(Character));
     }
     _lineProperties = newLineProperties;
+    _hasTextBlinker = _blinkingLineCount > 0;
+
+    // add the area occupied by the dirty lines to the region which needs
+    // to be repainted, one rectangle per run of consecutive dirty rows
+    for (y = 0; y < linesToUpdate;) {
+        if (!rowDirty[y]) {
+            ++y;
+            continue;
+        }
+        const int runStart = y;
+        while (y < linesToUpdate && rowDirty[y]) {
+            ++y;
+        }
+        const QRect dirtyRect = QRect(_contentRect.left() + tLx,
+                                      _contentRect.top() + tLy + _terminalFont->fontHeight() * runStart,
+                                      _terminalFont->fontWidth() * columnsToUpdate,
+                                      _terminalFont->fontHeight() * (y - runStart));
+        dirtyRegion |= highdpi_adjust_rect(dirtyRect, _dirtyRectInflation);
+    }
 
     // if the new _image is smaller than the previous _image, then ensure that the area
     // outside the new _image is cleared
@@ -628,7 +792,8 @@ void TerminalDisplay::updateImage()
         dirtyRegion |= highdpi_adjust_rect(QRect(_contentRect.left() + tLx,
                                                  _contentRect.top() + tLy + _terminalFont->fontHeight() * linesToUpdate,
                                                  _terminalFont->fontWidth() * _columns,
-                                                 _terminalFont->fontHeight() * (_usedLines - linesToUpdate)));
+                                                 _terminalFont->fontHeight() * (_usedLines - linesToUpdate)),
+                                           _dirtyRectInflation);
     }
     _usedLines = linesToUpdate;
 
@@ -636,7 +801,8 @@ void TerminalDisplay::updateImage()
         dirtyRegion |= highdpi_adjust_rect(QRect(_contentRect.left() + tLx + columnsToUpdate * _terminalFont->fontWidth(),
                                                  _contentRect.top() + tLy,
                                                  _terminalFont->fontWidth() * (_usedColumns - columnsToUpdate),
-                                                 _terminalFont->fontHeight() * _lines));
+                                                 _terminalFont->fontHeight() * _lines),
+                                           _dirtyRectInflation);
     }
     _usedColumns = columnsToUpdate;
 
@@ -650,26 +816,47 @@ void TerminalDisplay::updateImage()
             highdpi_adjust_rect(QRect(0,
                                       _contentRect.top() + (_screenWindow->currentResultLine() - _screenWindow->currentLine()) * _terminalFont->fontHeight(),
                                       _columns * _terminalFont->fontWidth(),
-                                      _terminalFont->fontHeight()));
-    }
-
-    if (_scrollBar->highlightScrolledLines().isEnabled()) {
-        dirtyRegion |= _terminalPainter->highlightScrolledLinesRegion(_scrollBar);
+                                      _terminalFont->fontHeight()),
+                                _dirtyRectInflation);
+    }
+
+    if (_scrollBar->highlightScrolledLines().isEnabled() && _screenWindow->scrollCount() != 0 && _scrollBar->maximum() > 0) {
+        // the strip region is maintained incrementally from the scroll
+        // delta; it sits in margin space reserved by calcGeometry(), so
+        // paintEvent() composites it over the background without dragging
+        // any text cells into the repaint
+        const int highlightLeftPosition = _scrollBar->scrollBarPosition() == Enum::ScrollBarLeft ? _scrollBar->width() : 0;
+        dirtyRegion |= _scrollBar->highlightScrolledLines().addScrolledLines(_screenWindow->scrollCount(),
+                                                                             _screenWindow->windowLines(),
+                                                                             _contentRect,
+                                                                             _terminalFont->fontHeight(),
+                                                                             highlightLeftPosition);
     }
     _screenWindow->resetScrollCount();
+    _screenWindow->resetDirtyLines();
 
     // update the parts of the display which have changed
     if (_screenWindow->screen()->hasGraphics()) {
+        // graphics placements repaint everything; the snapshot restore
+        // path cannot satisfy that
+        discardPrimaryScreenSnapshot();
         update();
     } else {
+        if (_restorePrimaryPending) {
+            // cells that changed since the primary-screen snapshot must
+            // be re-rendered on top of the restoring blit
+            _postRestoreDirtyRegion |= dirtyRegion;
+        }
         update(dirtyRegion);
     }
 
-    if (_allowBlinkingText && _hasTextBlinker && !_blinkTextTimer->isActive()) {
-        _blinkTextTimer->start();
+    // subscription to the shared blink service tracks the blink-presence
+    // counter, so displays without blinking content receive no ticks
+    if (_allowBlinkingText && _hasTextBlinker) {
+        BlinkTimerService::instance()->subscribeText(this);
     }
-    if (!_hasTextBlinker && _blinkTextTimer->isActive()) {
-        _blinkTextTimer->stop();
+    if (!_hasTextBlinker) {
+        BlinkTimerService::instance()->unsubscribeText(this);
         _textBlinking = false;
     }
     delete[] dirtyMask;
@@ -729,6 +916,13 @@ void TerminalDisplay::showNotification(QString text)
 
 void TerminalDisplay::paintEvent(QPaintEvent *pe)
 {
+    // mark() only reports the first occurrence, so this is a cheap no-op on
+    // every later frame
+    StartupProfiler::mark("first-paint");
+
+    PipelineMetrics::ScopedTimer timer(PipelineMetrics::PaintEventStage);
+    AllocationTracker::Scope allocationScope(AllocationTracker::PainterSubsystem);
+
     if (_linesAtLastOsd != _lines || _columnsAtLastOsd != _columns) {
         showResizeNotification();
     }
@@ -739,13 +933,61 @@ void TerminalDisplay::paintEvent(QPaintEvent *pe)
     QRegion dirtyImageRegion;
     const QRegion region = pe->region() & contentsRect();
 
-    for (const QRect &rect : region) {
-        dirtyImageRegion += widgetToImage(rect);
+    // Returning from the alternate screen: blit the retained primary frame
+    // in one go and only push the cells that changed since the snapshot
+    // through the renderer below.
+    QRegion renderRegion = region;
+    if (_restorePrimaryPending) {
+        _restorePrimaryPending = false;
+        paint.drawPixmap(contentsRect().topLeft(), _primaryScreenSnapshot);
+        renderRegion = _postRestoreDirtyRegion & region;
+        discardPrimaryScreenSnapshot();
+    }
+
+    // Dimming on focus loss only blends a translucent fill over the frame
+    // already in the backing store (retained thanks to WA_OpaquePaintEvent),
+    // so the cells don't have to be repainted; the cursor cell is the one
+    // exception, as it just switched to its unfocused look.
+    const bool dimOverlayOnly = _dimOverlayOnlyPending;
+    _dimOverlayOnlyPending = false;
+    if (dimOverlayOnly && _dimWhenInactive && !hasFocus() && !_borderWhenActive) {
+        bool cursorHandled = true;
+        if (_cursorOnlyUpdatePending && isCursorOnDisplay()) {
+            const int cursorLocation = loc(cursorPosition().x(), cursorPosition().y());
+            const QRect cursorImageRect(_visualCursorPosition, QSize(_image[cursorLocation].width(), 1));
+            cursorHandled = tryPaintCursorCell(paint, cursorImageRect);
+        }
+        if (cursorHandled) {
+            _cursorOnlyUpdatePending = false;
+            const QColor dimColor(0, 0, 0, _dimValue);
+            for (const QRect &rect : region) {
+                paint.fillRect(rect, dimColor);
+            }
+            return;
+        }
+    }
+
+    // the scrolled-lines highlight strip lives in margin space reserved by
+    // calcGeometry(); there are no text cells under it, so damage confined
+    // to its column (the scroll delta and the fade tick) needs only the
+    // background fill plus the overlay composite further down
+    QRect highlightStripColumn;
+    if (_scrollBar->highlightScrolledLines().isEnabled()) {
+        const int highlightLeftPosition = _scrollBar->scrollBarPosition() == Enum::ScrollBarLeft ? _scrollBar->width() : 0;
+        highlightStripColumn = highdpi_adjust_rect(QRect(highlightLeftPosition, 0, HighlightScrolledLines::HIGHLIGHT_SCROLLED_LINES_WIDTH, height()));
+    }
+
+    for (const QRect &rect : renderRegion) {
         // We can use the opacity settings only if we are in a top level window which actually supports opacity.
         // Many apps that use a konsole part such as kate or dolphin don't for performance reasons.
         // This will result in repaint glitches iin wayland due to missing damage information
         const bool useOpacity = window() && window()->testAttribute(Qt::WA_TranslucentBackground);
         _terminalPainter->drawBackground(paint, rect, _terminalColor->backgroundColor(), useOpacity);
+
+        if (!highlightStripColumn.isNull() && highlightStripColumn.contains(rect)) {
+            continue;
+        }
+        dirtyImageRegion += widgetToImage(rect);
     }
 
     if (_displayVerticalLine) {
@@ -765,7 +1007,30 @@ void TerminalDisplay::paintEvent(QPaintEvent *pe)
         return;
     }
 
+    const bool cursorOnlyUpdate = _cursorOnlyUpdatePending;
+    _cursorOnlyUpdatePending = false;
+
+    // The preedit layer painted below is opaque, so cells entirely behind
+    // it don't need their content drawn.  The pixel-coverage check guards
+    // the case of preeditRect() being clipped mid-cell at the content edge.
+    QRect preeditImageRect;
+    if (!_inputMethodData.preeditString.isEmpty() && isCursorOnDisplay()) {
+        const QRect preeditPixelRect = preeditRect();
+        if (!preeditPixelRect.isEmpty()) {
+            const QRect covered = widgetToImage(preeditPixelRect);
+            if (preeditPixelRect.contains(imageToWidget(covered))) {
+                preeditImageRect = covered;
+            }
+        }
+    }
+
     for (const QRect &rect : std::as_const(dirtyImageRegion)) {
+        if (cursorOnlyUpdate && tryPaintCursorCell(paint, rect)) {
+            continue;
+        }
+        if (!preeditImageRect.isEmpty() && preeditImageRect.contains(rect)) {
+            continue;
+        }
         _terminalPainter->drawContents(_image, paint, rect, false, _imageSize, _bidiEnabled, _lineProperties, _screenWindow->screen()->ulColorTable());
     }
 
@@ -816,6 +1081,21 @@ void TerminalDisplay::paintEvent(QPaintEvent *pe)
 
     // Draw badge overlay
     drawBadge(paint);
+
+    if (PipelineMetrics::enabled() && PipelineMetrics::instance()->overlayEnabled()) {
+        const QString text = PipelineMetrics::instance()->overlayText();
+        if (!text.isEmpty()) {
+            QFont overlayFont = font();
+            overlayFont.setPointSizeF(qMax(overlayFont.pointSizeF() - 2.0, 6.0));
+            paint.setFont(overlayFont);
+            const QRect overlayRect = paint.fontMetrics().boundingRect(contentsRect().adjusted(4, 4, -4, -4), Qt::AlignRight | Qt::AlignTop, text);
+            paint.fillRect(overlayRect.adjusted(-4, -4, 4, 4), QColor(0, 0, 0, 160));
+            paint.setPen(Qt::white);
+            paint.drawText(overlayRect, Qt::AlignRight | Qt::AlignTop, text);
+        }
+    }
+
+    Q_EMIT paintCompleted();
 }
 
 void TerminalDisplay::drawBadge(QPainter &painter)
@@ -948,6 +1228,11 @@ FilterChain *TerminalDisplay::filterChain() const
     return _filterChain;
 }
 
+void TerminalDisplay::setSessionScanCache(const QSharedPointer<SessionScanCache> &cache)
+{
+    _filterChain->setSessionScanCache(cache);
+}
+
 void TerminalDisplay::paintFilters(QPainter &painter)
 {
     if (_filterUpdateRequired) {
@@ -992,12 +1277,10 @@ void TerminalDisplay::setBlinkingCursorEnabled(bool blink)
 {
     _allowBlinkingCursor = blink;
 
-    if (blink && !_blinkCursorTimer->isActive()) {
-        _blinkCursorTimer->start();
-    }
-
-    if (!blink && _blinkCursorTimer->isActive()) {
-        _blinkCursorTimer->stop();
+    if (blink) {
+        BlinkTimerService::instance()->subscribeCursor(this);
+    } else {
+        BlinkTimerService::instance()->unsubscribeCursor(this);
         if (_cursorBlinking) {
             // if cursor is blinking(hidden), blink it again to make it show
             _cursorBlinking = false;
@@ -1017,12 +1300,11 @@ void TerminalDisplay::setBlinkingTextEnabled(bool blink)
 {
     _allowBlinkingText = blink;
 
-    if (blink && !_blinkTextTimer->isActive()) {
-        _blinkTextTimer->start();
-    }
-
-    if (!blink && _blinkTextTimer->isActive()) {
-        _blinkTextTimer->stop();
+    if (blink) {
+        // updateImage() unsubscribes again if no blinking content remains
+        BlinkTimerService::instance()->subscribeText(this);
+    } else {
+        BlinkTimerService::instance()->unsubscribeText(this);
         _textBlinking = false;
     }
 }
@@ -1037,7 +1319,7 @@ void TerminalDisplay::focusOutEvent(QFocusEvent *)
     updateCursor();
 
     // suppress further cursor blinking
-    _blinkCursorTimer->stop();
+    BlinkTimerService::instance()->unsubscribeCursor(this);
     Q_ASSERT(!_cursorBlinking);
 
     // if text is blinking (hidden), blink it again to make it shown
@@ -1046,7 +1328,7 @@ void TerminalDisplay::focusOutEvent(QFocusEvent *)
     }
 
     // suppress further text blinking
-    _blinkTextTimer->stop();
+    BlinkTimerService::instance()->unsubscribeText(this);
     Q_ASSERT(!_textBlinking);
 
     // If waiting for a triple click - losing focus cancels that (do the pending copy)
@@ -1056,13 +1338,15 @@ void TerminalDisplay::focusOutEvent(QFocusEvent *)
 void TerminalDisplay::focusInEvent(QFocusEvent *)
 {
     if (_allowBlinkingCursor) {
-        _blinkCursorTimer->start();
+        BlinkTimerService::instance()->subscribeCursor(this);
+        // grant a full phase of visibility before the first shared toggle
+        _cursorBlinkSkipTick = true;
     }
 
     updateCursor();
 
     if (_allowBlinkingText && _hasTextBlinker) {
-        _blinkTextTimer->start();
+        BlinkTimerService::instance()->subscribeText(this);
     }
 }
 
@@ -1072,6 +1356,10 @@ void TerminalDisplay::blinkTextEvent()
 
     _textBlinking = !_textBlinking;
 
+    // blinking text has to be redrawn, so the dim-overlay-only shortcut in
+    // paintEvent() must not swallow this update (focusOutEvent() un-blinks)
+    _dimOverlayOnlyPending = false;
+
     // TODO: Optimize to only repaint the areas of the widget where there is
     // blinking text rather than repainting the whole widget.
     update();
@@ -1085,6 +1373,22 @@ void TerminalDisplay::blinkCursorEvent()
     updateCursor();
 }
 
+void TerminalDisplay::cursorBlinkTick()
+{
+    // one tick is skipped after a keystroke or focus-in so the cursor
+    // stays visible for a full phase; see _cursorBlinkSkipTick
+    if (_cursorBlinkSkipTick) {
+        _cursorBlinkSkipTick = false;
+        return;
+    }
+    blinkCursorEvent();
+}
+
+void TerminalDisplay::textBlinkTick()
+{
+    blinkTextEvent();
+}
+
 void TerminalDisplay::updateCursor()
 {
     if (!isCursorOnDisplay()) {
@@ -1096,9 +1400,60 @@ void TerminalDisplay::updateCursor()
 
     int charWidth = _image[cursorLocation].width();
     QRect cursorRect = imageToWidget(highdpi_adjust_rect(QRect(_visualCursorPosition, QSize(charWidth, 1))));
+    // blink and focus changes repaint only the cursor cell; let paintEvent
+    // try the single-cell path instead of rebuilding the line's fragments
+    _cursorOnlyUpdatePending = true;
     update(cursorRect);
 }
 
+bool TerminalDisplay::tryPaintCursorCell(QPainter &paint, const QRect &imageRect)
+{
+    if (_screenWindow.isNull() || !isCursorOnDisplay()) {
+        return false;
+    }
+    // the update rect for a cursor cell can straddle a cell boundary after
+    // high-DPI adjustment, but never legitimately covers more than that
+    if (imageRect.width() > 2 || imageRect.height() > 2) {
+        return false;
+    }
+    if (_screenWindow->screen()->hasGraphics()) {
+        return false;
+    }
+
+    // Everything drawn here bypasses the per-line machinery of
+    // drawContents(), so each touched row must be plain LTR text (which
+    // guarantees the identity bidi mapping) and each touched cell must need
+    // none of the below/above-text decorations.
+    for (int cy = imageRect.top(); cy <= imageRect.bottom(); ++cy) {
+        const LineProperty lineProperty = cy < _lineProperties.count() ? _lineProperties[cy] : LineProperty();
+        if (lineProperty != LineProperty()) {
+            return false;
+        }
+        for (int cx = 0; cx < _usedColumns; ++cx) {
+            const Character &ch = _image[loc(cx, cy)];
+            if (ch.character < ' ' || ch.character >= 0x300 || ch.rendition.f.extended != 0) {
+                return false;
+            }
+        }
+    }
+    for (int cy = imageRect.top(); cy <= imageRect.bottom(); ++cy) {
+        for (int cx = imageRect.left(); cx <= imageRect.right(); ++cx) {
+            const Character &cell = _image[loc(cx, cy)];
+            if (cell.rendition.f.selected != 0 || cell.rendition.f.underline != 0 || cell.rendition.f.overline != 0 || cell.rendition.f.strikeout != 0
+                || (cell.flags & EF_REPL) != 0) {
+                return false;
+            }
+        }
+    }
+
+    for (int cy = imageRect.top(); cy <= imageRect.bottom(); ++cy) {
+        for (int cx = imageRect.left(); cx <= imageRect.right(); ++cx) {
+            _terminalPainter->drawCursorCell(paint, imageToWidget(QRect(cx, cy, 1, 1)), _image[loc(cx, cy)], LineProperty());
+        }
+    }
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 /*                                                                           */
 /*                          Geometry & Resizing                              */
@@ -1141,21 +1496,14 @@ void TerminalDisplay::propagateSize()
 
 void TerminalDisplay::updateImageSize()
 {
-    Character *oldImage = _image;
     const int oldLines = _lines;
     const int oldColumns = _columns;
 
-    makeImage();
+    // geometry or font changes invalidate the retained primary frame
+    discardPrimaryScreenSnapshot();
 
-    if (oldImage != nullptr) {
-        // copy the old image to reduce flicker
-        int lines = qMin(oldLines, _lines);
-        int columns = qMin(oldColumns, _columns);
-        for (int line = 0; line < lines; line++) {
-            memcpy((void *)&_image[_columns * line], (void *)&oldImage[oldColumns * line], columns * sizeof(Character));
-        }
-        delete[] oldImage;
-    }
+    // preserves the overlapping part of the old content, see makeImage()
+    makeImage();
 
     if (!_screenWindow.isNull()) {
         _screenWindow->setWindowLines(_lines);
@@ -1174,10 +1522,23 @@ void TerminalDisplay::updateImageSize()
     _resizing = false;
 }
 
+void TerminalDisplay::updateDirtyRectInflation()
+{
+    // the compensation border in highdpi_adjust_rect() only matters where
+    // fractional scaling can round cell edges to different device pixels;
+    // on integer ratios it just drags an extra row and column of cells
+    // into every repaint
+    const qreal dpr = devicePixelRatioF();
+    _dirtyRectInflation = qFuzzyCompare(dpr, static_cast<qreal>(qRound(dpr))) ? 0 : 1;
+}
+
 void TerminalDisplay::makeImage()
 {
     _wallpaper->load();
 
+    const int oldLines = _lines;
+    const int oldColumns = _columns;
+
     calcGeometry();
 
     // confirm that array will be of non-zero size, since the painting code
@@ -1187,9 +1548,51 @@ void TerminalDisplay::makeImage()
 
     _imageSize = _lines * _columns;
 
-    _image = new Character[_imageSize];
+    if (_image == nullptr) {
+        _image = new Character[_imageSize];
+        _imageCapacity = _imageSize;
+        clearImage();
+        return;
+    }
+
+    const int lines = qMin(oldLines, _lines);
+    const int columns = qMin(oldColumns, _columns);
+
+    // The allocation only grows - a drag-resize changes the geometry
+    // hundreds of times and a multi-megabyte alloc/free cycle per event
+    // dominates the heap traffic.  Either way the overlapping part of the
+    // old content is carried over to reduce flicker.
+    if (_imageSize > _imageCapacity) {
+        Character *oldImage = _image;
+        _image = new Character[_imageSize];
+        _imageCapacity = _imageSize;
+        clearImage();
+        for (int line = 0; line < lines; line++) {
+            memcpy(&_image[_columns * line], &oldImage[oldColumns * line], columns * sizeof(Character));
+        }
+        delete[] oldImage;
+        return;
+    }
+
+    // Reusing the buffer means moving the preserved rows to the new
+    // stride in place.  The regions overlap, so rows are walked towards
+    // the narrower stride: forwards when rows shrink, backwards when they
+    // grow, which never overwrites a row that is still to be moved.
+    if (_columns <= oldColumns) {
+        for (int line = 0; line < lines; line++) {
+            memmove(&_image[_columns * line], &_image[oldColumns * line], columns * sizeof(Character));
+        }
+    } else {
+        for (int line = lines - 1; line >= 0; line--) {
+            memmove(&_image[_columns * line], &_image[oldColumns * line], columns * sizeof(Character));
+        }
+    }
 
-    clearImage();
+    // blank the area the carried-over content does not cover
+    for (int line = 0; line < lines; line++) {
+        std::fill(_image + _columns * line + columns, _image + _columns * (line + 1), Screen::DefaultChar);
+    }
+    std::fill(_image + _columns * lines, _image + _imageSize, Screen::DefaultChar);
 }
 
 void TerminalDisplay::clearImage()
@@ -1449,20 +1852,27 @@ void TerminalDisplay::mouseMoveEvent(QMouseEvent *ev)
     }
     auto [charLine, charColumn] = getCharacterPosition(ev->pos(), !usesMouseTracking());
 
-    processFilters();
+    // High-polling-rate mice deliver hundreds of move events per cell, and
+    // the hotspot hit-testing and hover effects only depend on the cell
+    // under the cursor plus the modifiers and buttons (e.g. Ctrl showing a
+    // link underline), so repeats within a cell are short-circuited.
+    const bool sameChar = charLine == _prevCharacterLine && charColumn == _prevCharacterColumn;
+    const bool sameHoverState = sameChar && ev->modifiers() == _prevMouseModifiers && ev->buttons() == _prevMouseButtons;
+    _prevCharacterLine = charLine;
+    _prevCharacterColumn = charColumn;
+    _prevMouseModifiers = ev->modifiers();
+    _prevMouseButtons = ev->buttons();
 
-    _filterChain->mouseMoveEvent(this, ev, charLine, charColumn);
+    if (!sameHoverState) {
+        processFilters();
+
+        _filterChain->mouseMoveEvent(this, ev, charLine, charColumn);
+    }
 
     // if the program running in the terminal is interested in Mouse Tracking
     // events then emit a mouse movement signal, unless the shift key is
     // being held down, which overrides this.
     if (usesMouseTracking() && !(ev->modifiers() & Qt::ShiftModifier)) {
-        // Ignore mouse movements that don't change the character position.
-        bool sameChar = charLine == _prevCharacterLine && charColumn == _prevCharacterColumn;
-
-        _prevCharacterLine = charLine;
-        _prevCharacterColumn = charColumn;
-
         if (!_readOnly) {
             int button = 3;
             if ((ev->buttons() & Qt::LeftButton) != 0u) {
@@ -1532,6 +1942,11 @@ void TerminalDisplay::sendMouseSignal(int button, QPoint pos, int eventType, boo
 
 void TerminalDisplay::leaveEvent(QEvent *ev)
 {
+    // the next move event must not be mistaken for a repeat within the
+    // same cell, as the hover state was reset in the meantime
+    _prevCharacterLine = -1;
+    _prevCharacterColumn = -1;
+
     // remove underline from an active link when cursor leaves the widget area,
     // also restore regular mouse cursor shape
     _filterChain->leaveEvent(this, ev);
@@ -1692,6 +2107,10 @@ void TerminalDisplay::extendSelection(const QPoint &position)
     } else {
         _screenWindow->setSelectionEnd(here.x() + offset, here.y(), _trimTrailingSpaces);
     }
+
+    // owners of PRIMARY are only refreshed once the pointer pauses; a
+    // drag across a large scrollback then costs nothing per motion event
+    _primarySettleTimer->start();
 }
 
 void TerminalDisplay::mouseReleaseEvent(QMouseEvent *ev)
@@ -1708,6 +2127,8 @@ void TerminalDisplay::mouseReleaseEvent(QMouseEvent *ev)
             clearSelection();
         } else {
             if (_actSel > 1) {
+                // the release copy below covers any pending settle update
+                _primarySettleTimer->stop();
                 copyToX11Selection();
                 if (_possibleTripleClick) {
                     const QString text = _screenWindow->selectedText(currentDecodingOptions());
@@ -1860,6 +2281,20 @@ void TerminalDisplay::mouseDoubleClickEvent(QMouseEvent *ev)
     });
 }
 
+int TerminalDisplay::frameIntervalMsecs()
+{
+    static const int interval = []() {
+        if (const QScreen *screen = QGuiApplication::primaryScreen()) {
+            const qreal refreshRate = screen->refreshRate();
+            if (refreshRate > 1.0) {
+                return qBound(5, qRound(1000.0 / refreshRate), 50);
+            }
+        }
+        return 17; // assume 60Hz when the refresh rate is unknown
+    }();
+    return interval;
+}
+
 void TerminalDisplay::wheelEvent(QWheelEvent *ev)
 {
     // Guard against events arriving after the session has been destroyed
@@ -1911,20 +2346,21 @@ void TerminalDisplay::wheelEvent(QWheelEvent *ev)
         return;
     } else if (!usesMouseTracking() && (_scrollBar->maximum() > 0)) {
         // If the program running in the terminal is not interested in Mouse
-        // Tracking events, send the event to the scrollbar if the slider
-        // has room to move
+        // Tracking events, scroll the history.  The deltas are only
+        // accumulated here: high-resolution touchpads deliver hundreds of
+        // wheel events per second during kinetic scrolling, and moving the
+        // scrollbar for each one costs a scrollTo() plus updateImage()
+        // per event.  flushScrollWheel() converts the combined delta into
+        // one line scroll per display frame instead; the first event of a
+        // gesture flushes immediately so discrete wheels keep their
+        // latency.
 
         _scrollWheelState.addWheelEvent(ev);
 
-        _scrollBar->event(ev);
-
-        // Reapply scrollbar position since the scrollbar event handler
-        // sometimes makes the scrollbar visible when set to hidden.
-        // Don't call propagateSize and update, since nothing changed.
-        _scrollBar->applyScrollBarPosition(false);
-
-        _sessionController->setSearchStartToWindowCurrentLine();
-        _scrollWheelState.clearAll();
+        if (!_wheelFlushTimer->isActive()) {
+            flushScrollWheel();
+            _wheelFlushTimer->start(frameIntervalMsecs());
+        }
     } else if (!_readOnly) {
         _scrollWheelState.addWheelEvent(ev);
 
@@ -1962,6 +2398,32 @@ void TerminalDisplay::wheelEvent(QWheelEvent *ev)
     enable_zoom = false;
 }
 
+void TerminalDisplay::flushScrollWheel()
+{
+    if (!_sessionController || _sessionController->session().isNull() || _screenWindow.isNull()) {
+        _scrollWheelState.clearAll();
+        return;
+    }
+
+    // one line per cell height of pixel delta; for click wheels the usual
+    // system setting of lines per 15 degree notch
+    const int pixelStep = qMax(1, static_cast<int>(_terminalFont->fontHeight() * qApp->devicePixelRatio()));
+    const int angleStep = ScrollState::DEFAULT_ANGLE_SCROLL_LINE / qMax(1, QApplication::wheelScrollLines());
+    const int lines = _scrollWheelState.consumeSteps(pixelStep, angleStep);
+    if (lines == 0) {
+        return;
+    }
+
+    // one combined move; scrollBarPositionChanged() does the scrollTo()
+    // and the single updateImage() for it
+    _scrollBar->setValue(_scrollBar->value() - lines);
+    _sessionController->setSearchStartToWindowCurrentLine();
+
+    // keep pacing while the gesture lasts; wheelEvent() only flushes
+    // directly when this timer is idle
+    _wheelFlushTimer->start(frameIntervalMsecs());
+}
+
 void TerminalDisplay::viewScrolledByUser()
 {
     Q_ASSERT(_sessionController != nullptr);
@@ -2312,6 +2774,10 @@ bool TerminalDisplay::focusNextPrevChild(bool next)
 
 uint TerminalDisplay::charClass(const Character &ch) const
 {
+    if (ch.rendition.f.extended == 0 && ch.character < 128) {
+        return _asciiCharClass[ch.character];
+    }
+
     if (ch.rendition.f.extended != 0) {
         ushort extendedCharLength = 0;
         const char32_t *chars = ExtendedCharTable::instance.lookupExtendedChar(ch.character, extendedCharLength);
@@ -2332,7 +2798,15 @@ uint TerminalDisplay::charClass(const Character &ch) const
             return ' ';
         }
 
-        if (QChar::isLetterOrNumber(ch.character) || _wordCharacters.contains(QString::fromUcs4(&ch.character, 1), Qt::CaseInsensitive)) {
+        if (QChar::isLetterOrNumber(ch.character)) {
+            return 'a';
+        }
+
+        // Only characters outside the Basic Multilingual Plane still need
+        // to go through a string; everything else is a single QChar
+        const bool isWordChar = ch.character < 0x10000 ? _wordCharacters.contains(QChar(static_cast<ushort>(ch.character)), Qt::CaseInsensitive)
+                                                       : _wordCharacters.contains(QString::fromUcs4(&ch.character, 1), Qt::CaseInsensitive);
+        if (isWordChar) {
             return 'a';
         }
 
@@ -2340,9 +2814,23 @@ uint TerminalDisplay::charClass(const Character &ch) const
     }
 }
 
+void TerminalDisplay::updateCharClassTable()
+{
+    for (uint c = 0; c < 128; ++c) {
+        if (QChar::isSpace(c)) {
+            _asciiCharClass[c] = ' ';
+        } else if (QChar::isLetterOrNumber(c) || _wordCharacters.contains(QLatin1Char(char(c)), Qt::CaseInsensitive)) {
+            _asciiCharClass[c] = 'a';
+        } else {
+            _asciiCharClass[c] = c;
+        }
+    }
+}
+
 void TerminalDisplay::setWordCharacters(const QString &wc)
 {
     _wordCharacters = wc;
+    updateCharClassTable();
 }
 
 void TerminalDisplay::setUsesMouseTracking(bool on)
@@ -2351,6 +2839,66 @@ void TerminalDisplay::setUsesMouseTracking(bool on)
     resetCursor();
 }
 
+void TerminalDisplay::setUsesPrimaryScreen(bool use)
+{
+    if (use == _usesPrimaryScreen) {
+        return;
+    }
+    _usesPrimaryScreen = use;
+
+    if (!use) {
+        takePrimaryScreenSnapshot();
+        return;
+    }
+
+    const bool dimmed = _dimWhenInactive && !hasFocus();
+    if (!_primaryScreenSnapshot.isNull() && _primarySnapshotColumns == _columns && _primarySnapshotLines == _lines
+        && _primarySnapshotImage.size() == size_t(_imageSize) && _primarySnapshotContentsSize == contentsRect().size() && !dimmed) {
+        // Restore the retained cell buffer so the next updateImage() diff
+        // only flags cells that actually changed while the alternate
+        // screen was active; paintEvent() blits the retained pixels
+        // underneath them.
+        memcpy(_image, _primarySnapshotImage.data(), _primarySnapshotImage.size() * sizeof(Character));
+        _lineProperties = _primarySnapshotLineProperties;
+        _restorePrimaryPending = true;
+        _postRestoreDirtyRegion = QRegion();
+        update();
+    } else {
+        discardPrimaryScreenSnapshot();
+    }
+}
+
+void TerminalDisplay::takePrimaryScreenSnapshot()
+{
+    discardPrimaryScreenSnapshot();
+
+    // A dimmed frame cannot be restored (the paint path would dim it
+    // again) and blinking text would be frozen in whatever phase the
+    // snapshot caught; both are rare enough to just fall back to a
+    // normal repaint.
+    const bool dimmed = _dimWhenInactive && !hasFocus();
+    if (_image == nullptr || !isVisible() || dimmed || _hasTextBlinker) {
+        return;
+    }
+
+    _primaryScreenSnapshot = grab(contentsRect());
+    _primarySnapshotImage.assign(_image, _image + _imageSize);
+    _primarySnapshotLineProperties = _lineProperties;
+    _primarySnapshotContentsSize = contentsRect().size();
+    _primarySnapshotColumns = _columns;
+    _primarySnapshotLines = _lines;
+}
+
+void TerminalDisplay::discardPrimaryScreenSnapshot()
+{
+    _primaryScreenSnapshot = QPixmap();
+    _primarySnapshotImage.clear();
+    _primarySnapshotImage.shrink_to_fit();
+    _primarySnapshotLineProperties.clear();
+    _restorePrimaryPending = false;
+    _postRestoreDirtyRegion = QRegion();
+}
+
 void TerminalDisplay::setAllowMouseTracking(bool allow)
 {
     _allowMouseTracking = allow;
@@ -2588,34 +3136,29 @@ void TerminalDisplay::copyToX11Selection(bool useSavedText)
         return;
     }
 
-    QString text;
-    QString html;
+    QMimeData *mimeData = nullptr;
     if (useSavedText) {
-        text = _doubleClickSelectedText;
-        html = _doubleClickSelectedHtml;
+        if (_doubleClickSelectedText.isEmpty()) {
+            return;
+        }
+        mimeData = new QMimeData;
+        mimeData->setText(_doubleClickSelectedText);
+        if (!_doubleClickSelectedHtml.isEmpty()) {
+            mimeData->setHtml(_doubleClickSelectedHtml);
+        }
     } else {
-        text = _screenWindow->selectedText(currentDecodingOptions());
-        if (!text.isEmpty() && _copyTextAsHTML) {
-            html = _screenWindow->selectedText(currentDecodingOptions() | Screen::ConvertToHtml);
+        mimeData = selectionMimeData(currentDecodingOptions());
+        if (mimeData == nullptr) {
+            return;
         }
     }
 
-    if (text.isEmpty()) {
-        return;
-    }
-
     // Copying the double-click selection *does* double click select + copy.
     // Copying another selection *cancels* double-click select + copy.
     // In both cases, no double-click copy is pending anymore.
     _doubleClickSelectedText.clear();
     _doubleClickSelectedHtml.clear();
 
-    QMimeData *mimeData = new QMimeData;
-    mimeData->setText(text);
-    if (!html.isEmpty()) {
-        mimeData->setHtml(html);
-    }
-
     if (QApplication::clipboard()->supportsSelection()) {
         QApplication::clipboard()->setMimeData(mimeData, QClipboard::Selection);
     }
@@ -2625,25 +3168,64 @@ void TerminalDisplay::copyToX11Selection(bool useSavedText)
     }
 }
 
+void TerminalDisplay::updatePrimarySelection()
+{
+    // only while a drag selection is still in progress; the release path
+    // runs the full copyToX11Selection() with its double-click and
+    // copy-to-clipboard bookkeeping
+    if (_actSel < 2 || _screenWindow.isNull() || !QApplication::clipboard()->supportsSelection()) {
+        return;
+    }
+
+    // SelectionMimeData defers decoding until a paste asks for it, so
+    // publishing the paused selection does not read the selected range
+    QMimeData *mimeData = selectionMimeData(currentDecodingOptions());
+    if (mimeData != nullptr) {
+        QApplication::clipboard()->setMimeData(mimeData, QClipboard::Selection);
+    }
+}
+
 void TerminalDisplay::copyToClipboard(Screen::DecodingOptions options)
 {
     if (_screenWindow.isNull()) {
         return;
     }
 
-    const QString &text = _screenWindow->selectedText(currentDecodingOptions() | options);
-    if (text.isEmpty()) {
+    QMimeData *mimeData = selectionMimeData(currentDecodingOptions() | options);
+    if (mimeData == nullptr) {
         return;
     }
 
-    auto mimeData = new QMimeData;
-    mimeData->setText(text);
+    QApplication::clipboard()->setMimeData(mimeData, QClipboard::Clipboard);
+}
+
+QMimeData *TerminalDisplay::selectionMimeData(Screen::DecodingOptions options)
+{
+    Screen *screen = _screenWindow->screen();
+
+    int startIndex = 0;
+    int endIndex = 0;
+    if (!screen->selectedTextRange(startIndex, endIndex)) {
+        return nullptr;
+    }
 
-    if (_copyTextAsHTML) {
-        mimeData->setHtml(_screenWindow->selectedText(currentDecodingOptions() | Screen::ConvertToHtml));
+    // Column-mode rendering depends on live screen state beyond the two
+    // indexes, and block selections are hand-sized anyway, so only they
+    // are still decoded up front.
+    if (screen->blockSelectionMode()) {
+        const QString text = screen->text(startIndex, endIndex, options);
+        if (text.isEmpty()) {
+            return nullptr;
+        }
+        auto mimeData = new QMimeData;
+        mimeData->setText(text);
+        if (_copyTextAsHTML) {
+            mimeData->setHtml(screen->text(startIndex, endIndex, options | Screen::ConvertToHtml));
+        }
+        return mimeData;
     }
 
-    QApplication::clipboard()->setMimeData(mimeData, QClipboard::Clipboard);
+    return new SelectionMimeData(_screenWindow, startIndex, endIndex, options, _copyTextAsHTML);
 }
 
 void TerminalDisplay::pasteFromClipboard(bool appendEnter)
@@ -3011,7 +3593,10 @@ void TerminalDisplay::keyPressEvent(QKeyEvent *event)
         }
 
         if (_allowBlinkingCursor) {
-            _blinkCursorTimer->start();
+            BlinkTimerService::instance()->subscribeCursor(this);
+            // skipping the next shared tick keeps the cursor solid while
+            // typing, like restarting a private timer used to
+            _cursorBlinkSkipTick = true;
             if (_cursorBlinking) {
                 // if cursor is blinking(hidden), blink it again to show it
                 blinkCursorEvent();
@@ -3121,6 +3706,14 @@ bool TerminalDisplay::event(QEvent *event)
         }
         break;
     case QEvent::FocusOut:
+        // Applying the focus dim doesn't need the cells repainted, see the
+        // overlay shortcut in paintEvent(); removing it on FocusIn does.
+        if (_dimWhenInactive && !_borderWhenActive) {
+            _dimOverlayOnlyPending = true;
+            update();
+            break;
+        }
+        Q_FALLTHROUGH();
     case QEvent::FocusIn:
         if (_screenWindow != nullptr) {
             // force a redraw on focusIn, fixes the
@@ -3131,6 +3724,10 @@ bool TerminalDisplay::event(QEvent *event)
         update();
         break;
 
+    case QEvent::DevicePixelRatioChange:
+        updateDirtyRectInflation();
+        break;
+
     case QEvent::ScrollPrepare:
         scrollPrepareEvent(static_cast<QScrollPrepareEvent *>(event));
         break;
@@ -3412,18 +4009,33 @@ void TerminalDisplay::applyProfile(const Profile::Ptr &profile)
 
 void TerminalDisplay::printScreen()
 {
-    auto lprintContent = [this](QPainter &painter, bool friendly) {
+    auto lfontget = [this]() {
+        return _terminalFont->getVTFont();
+    };
+    auto lprintContent = [this, lfontget](QPainter &painter, bool friendly) {
         QPoint columnLines(_usedLines, _usedColumns);
-        auto lfontget = [this]() {
-            return _terminalFont->getVTFont();
-        };
         auto lfontset = [this](const QFont &f) {
             _terminalFont->setVTFont(f);
         };
 
         _printManager->printContent(painter, friendly, columnLines, lfontget, lfontset);
     };
-    _printManager->printRequest(lprintContent, this);
+    // for printing the whole scrollback instead of the visible screen
+    auto llineCount = [this]() {
+        return _screenWindow.isNull() ? 0 : _screenWindow->lineCount();
+    };
+    auto ldecodeRange = [this](int firstLine, int lastLine) {
+        QString text;
+        QTextStream stream(&text);
+        PlainTextDecoder decoder;
+        decoder.begin(&stream);
+        if (!session().isNull() && session()->emulation() != nullptr) {
+            session()->emulation()->writeToStream(&decoder, firstLine, lastLine);
+        }
+        decoder.end();
+        return text;
+    };
+    _printManager->printRequest(lprintContent, this, lfontget, llineCount, ldecodeRange);
 }
 
 Character TerminalDisplay::getCursorCharacter(int column, int line)
@@ -3463,6 +4075,35 @@ int TerminalDisplay::bidiMap(Character *screenline,
     int lastNonSpace = 0;
     shaped = false;
 
+    // Fast path: a line of plain LTR spacing characters needs no Arabic
+    // shaping and resolves to the identity visual order, so the ICU
+    // analysis below can be skipped entirely. This removes the constant
+    // per-paint BiDi cost on ASCII-only screens when bidi rendering is
+    // enabled; one UCS4 compare per cell decides eligibility.
+    bool plainLtr = true;
+    for (i = 0; i < linewidth; i++) {
+        const Character &char_value = screenline[i];
+        if (char_value.rendition.f.extended != 0 || char_value.character < ' ' || char_value.character >= 0x2B0) {
+            plainLtr = false;
+            break;
+        }
+    }
+    if (plainLtr) {
+        for (i = 0; i < linewidth; i++) {
+            const char32_t cc = screenline[i].character;
+            log2line[i] = i;
+            line2log[i] = i;
+            vis2line[i] = i;
+            line.append(QChar(ushort(cc)));
+            if (cc != 0x20 && cc != 0xA0) {
+                lastNonSpace = i;
+            }
+        }
+        log2line[i] = linewidth;
+        return (!bidi || _bidiLineLTR) ? lastNonSpace : linewidth - 1;
+    }
+    line.reserve(linewidth);
+
     // use one string to assign into to avoid temporary allocations
     QString convertBuffer;
 
@@ -9,10 +9,14 @@
 #define TERMINALDISPLAY_H
 
 // Qt
+#include <QBitArray>
 #include <QColor>
+#include <QPixmap>
 #include <QPointer>
 #include <QWidget>
 
+#include <array>
+#include <vector>
 #include <memory>
 
 // Konsole
@@ -55,6 +59,7 @@ class TerminalFont;
 class KonsolePrintManager;
 
 class FilterChain;
+class SessionScanCache;
 class TerminalImageFilterChain;
 class SessionController;
 class IncrementalSearchBar;
@@ -71,6 +76,16 @@ inline QRect highdpi_adjust_rect(const QRect &rect)
     return rect.adjusted(-1, -1, 1, 1);
 }
 
+/**
+ * Overload taking the border width, for callers that precompute it once
+ * per device-pixel-ratio change (zero on integer ratios, where no
+ * fractional rounding can occur) instead of always paying the 1px border.
+ */
+inline QRect highdpi_adjust_rect(const QRect &rect, int margin)
+{
+    return rect.adjusted(-margin, -margin, margin, margin);
+}
+
 /**
  * A widget which displays output from a terminal emulation and sends input keypresses and mouse activity
  * to the terminal.
@@ -113,12 +128,23 @@ public:
      */
     FilterChain *filterChain() const;
 
+    /**
+     * Installs the filter-scan cache shared by all views of the session
+     * this display shows, so that decoded snapshots and empty scan
+     * results are computed once per session rather than once per view.
+     * Called by Session::addView(); a null @p cache detaches the display
+     * from the session's cache.
+     */
+    void setSessionScanCache(const QSharedPointer<SessionScanCache> &cache);
+
     /**
      * Updates the filters in the display's filter chain.  This will cause
      * the hotspots to be updated to match the current image.
      *
-     * WARNING:  This function can be expensive depending on the
-     * image size and number of filters in the filterChain()
+     * The scan itself runs on a worker thread; until it completes,
+     * hotspot queries keep answering from the previous image (at most
+     * one frame stale).  If the image changes again mid-scan, the stale
+     * scan is canceled and a new one started from the fresh snapshot.
      *
      * TODO - This API does not really allow efficient usage.  Revise it so
      * that the processing can be done in a better way.
@@ -144,6 +170,14 @@ public:
     /** Specifies whether or not text can blink. */
     void setBlinkingTextEnabled(bool blink);
 
+    /**
+     * Blink phase toggles delivered by the process-wide BlinkTimerService
+     * while this display is subscribed to it; see subscribeCursor() and
+     * subscribeText() there.
+     */
+    void cursorBlinkTick();
+    void textBlinkTick();
+
     void setSessionController(SessionController *controller);
     SessionController *sessionController();
     Session::Ptr session() const;
@@ -313,6 +347,13 @@ public:
         return _scrollBar;
     }
 
+    /**
+     * The primary display's refresh period in milliseconds; the pacing
+     * interval for work that is pointless to repeat faster than the
+     * screen can show it (wheel scroll coalescing, auto-scroll).
+     */
+    static int frameIntervalMsecs();
+
     TerminalColor *terminalColor() const
     {
         return _terminalColor;
@@ -368,6 +409,18 @@ public:
     struct InputMethodData {
         QString preeditString;
         QRect previousPreeditRect;
+
+        // The rendered preedit overlay; repaints of the area it covers
+        // recomposite this pixmap instead of re-rendering the string, so
+        // it is only rebuilt when the composition (or anything feeding
+        // into its appearance) changes.  See
+        // TerminalPainter::drawInputMethodPreeditString().
+        QPixmap cachedLayer;
+        QString cachedString;
+        QRect cachedRect;
+        QColor cachedForeground;
+        QColor cachedBackground;
+        Character cachedStyle;
     };
 
     // returns true if the cursor's position is on display.
@@ -493,6 +546,14 @@ public Q_SLOTS:
      */
     void setUsesMouseTracking(bool on);
 
+    /**
+     * Informs the display whether the emulation currently shows the
+     * primary screen. Switching to the alternate screen snapshots the
+     * rendered primary frame; switching back restores it with a single
+     * blit instead of re-rendering every cell.
+     */
+    void setUsesPrimaryScreen(bool use);
+
     void setBracketedPasteMode(bool on);
 
     /**
@@ -553,6 +614,13 @@ Q_SIGNALS:
 
     void peekPrimaryRequested(bool doPeek);
 
+    /**
+     * Emitted after paintEvent() has finished drawing a frame.  Used by
+     * Session's latency probe to timestamp when echoed input actually
+     * reached the screen.
+     */
+    void paintCompleted();
+
 protected:
     // events
     bool event(QEvent *event) override;
@@ -601,6 +669,13 @@ protected:
     //     - Other characters (returns the input character)
     uint charClass(const Character &ch) const;
 
+    // Fills _asciiCharClass from the current word characters
+    void updateCharClassTable();
+
+    // see setUsesPrimaryScreen()
+    void takePrimaryScreenSnapshot();
+    void discardPrimaryScreenSnapshot();
+
     void clearImage();
 
     void mouseTripleClickEvent(QMouseEvent *ev);
@@ -619,6 +694,15 @@ private Q_SLOTS:
 
     void viewScrolledByUser();
 
+    // applies the wheel deltas accumulated in _scrollWheelState to the
+    // scrollbar as one combined line scroll; see wheelEvent()
+    void flushScrollWheel();
+
+    // publishes the current selection to PRIMARY while a drag selection
+    // is still in progress; run by _primarySettleTimer when the pointer
+    // pauses, so the selection is never re-published per motion event
+    void updatePrimarySelection();
+
 private:
     Q_DISABLE_COPY(TerminalDisplay)
 
@@ -633,6 +717,10 @@ private:
     void updateImageSize();
     void makeImage();
 
+    // recomputes _dirtyRectInflation; called once at construction and on
+    // DevicePixelRatioChange instead of per dirty rect per frame
+    void updateDirtyRectInflation();
+
     void paintFilters(QPainter &painter);
 
     // draws the badge overlay on the terminal
@@ -643,6 +731,14 @@ private:
     // redraws the cursor
     void updateCursor();
 
+    // paints a cursor-only update rect cell-by-cell, bypassing
+    // drawContents(); returns false when the cells are not plain enough
+    // and the regular path must be used
+    bool tryPaintCursorCell(QPainter &paint, const QRect &imageRect);
+
+    // shifts the cached line properties to match a scrollImage() blit
+    void scrollLineProperties(int lines, QRect region);
+
     bool handleShortcutOverrideEvent(QKeyEvent *keyEvent);
 
     void doPaste(QString text, bool appendReturn);
@@ -663,6 +759,11 @@ private:
     // Uses the current settings for trimming whitespace and preserving linebreaks to create a proper flag value for Screen
     Screen::DecodingOptions currentDecodingOptions();
 
+    // Builds the clipboard data for the current selection, decoding lazily
+    // where possible (see SelectionMimeData); returns nullptr if there is
+    // nothing to copy
+    QMimeData *selectionMimeData(Screen::DecodingOptions options);
+
     // Boilerplate setup for MessageWidget
     KMessageWidget *createMessageWidget(const QString &text);
 
@@ -707,6 +808,8 @@ private:
     // getCharacterPosition() in mouseMoveEvent().
     int _prevCharacterLine = -1;
     int _prevCharacterColumn = -1;
+    Qt::KeyboardModifiers _prevMouseModifiers;
+    Qt::MouseButtons _prevMouseButtons;
 
     int _usedLines = 1; // the number of lines that are actually being used, this will be less
     // than 'lines' if the character image provided with setImage() is smaller
@@ -718,6 +821,7 @@ private:
 
     QRect _contentRect;
     Character *_image = nullptr; // [lines][columns]
+    int _imageCapacity = 0; // cells allocated for _image; grows only, see makeImage()
     // only the area [usedLines][usedColumns] in the image contains valid data
 
     int _imageSize = 0;
@@ -726,6 +830,10 @@ private:
     QColor _colorTable[TABLE_COLORS];
 
     bool _resizing = false;
+    // border added around updateImage() dirty rects to compensate
+    // fractional-scaling rounding; 0 on integer device pixel ratios,
+    // recomputed by updateDirtyRectInflation()
+    int _dirtyRectInflation = 1;
     bool _showTerminalSizeHint = true;
     bool _bidiEnabled = false;
     bool _bidiLineLTR = true;
@@ -748,6 +856,10 @@ private:
     Enum::MiddleClickPasteModeEnum _middleClickPasteMode = Enum::PasteFromX11Selection;
 
     QString _wordCharacters;
+    // Precomputed charClass() results for ASCII, rebuilt by
+    // setWordCharacters(); the word-boundary scans call charClass() for
+    // every cell and the per-cell QString round trip dominated them
+    std::array<uint, 128> _asciiCharClass;
     TerminalBell _bell{Enum::NotifyBell};
 
     bool _allowBlinkingText = true; // allow text to blink
@@ -755,10 +867,32 @@ private:
     bool _allowAnimatingCursor = false; // allow cursor to animate
     bool _textBlinking = false; // text is blinking, hide it when drawing
     bool _cursorBlinking = false; // cursor is blinking, hide it when drawing
+    bool _cursorOnlyUpdatePending = false; // next repaint may take the single-cell cursor path
+    bool _dimOverlayOnlyPending = false; // next repaint may just blend the focus dim over the retained frame
+
+    // rendered primary-screen frame retained while the alternate screen is
+    // active; see setUsesPrimaryScreen()
+    QPixmap _primaryScreenSnapshot;
+    std::vector<Character> _primarySnapshotImage;
+    QVector<LineProperty> _primarySnapshotLineProperties;
+    QSize _primarySnapshotContentsSize;
+    int _primarySnapshotColumns = 0;
+    int _primarySnapshotLines = 0;
+    bool _usesPrimaryScreen = true;
+    bool _restorePrimaryPending = false; // next repaint starts from the restored snapshot
+    QRegion _postRestoreDirtyRegion; // cells changed since the snapshot, re-rendered on top of it
     bool _cursorAnimating = false; // cursor is animating, animate it when drawing
     bool _hasTextBlinker = false; // has characters to blink
-    QTimer *_blinkTextTimer = nullptr;
-    QTimer *_blinkCursorTimer = nullptr;
+    QBitArray _lineHasBlinker; // per-line blink presence, kept across skipped lines in updateImage()
+    int _blinkingLineCount = 0; // set bits in _lineHasBlinker, so arming the blink timer is a counter check
+    // the next shared cursor tick is skipped after a keystroke, which
+    // keeps the cursor solid while typing (the per-display equivalent of
+    // restarting a private blink timer)
+    bool _cursorBlinkSkipTick = false;
+
+    // restarted on every selection extension; a PRIMARY update only
+    // happens when the pointer settles (or on release), never per move
+    QTimer *_primarySettleTimer = nullptr;
 
     bool _openLinksByDirectClick = false; // Open URL and hosts by single mouse click
 
@@ -796,9 +930,6 @@ private:
 
     InputMethodData _inputMethodData;
 
-    // the delay in milliseconds between redrawing blinking text
-    static const int TEXT_BLINK_DELAY = 500;
-
     // the duration of the size hint in milliseconds
     static const int SIZE_HINT_DURATION = 1000;
 
@@ -824,6 +955,10 @@ private:
     QColor _focusBorderColor = QColor();
 
     ScrollState _scrollWheelState;
+    // paces flushScrollWheel() to one scrollbar move per display frame;
+    // kinetic touchpad scrolling delivers hundreds of wheel events per
+    // second and each used to trigger its own updateImage()
+    QTimer *_wheelFlushTimer = nullptr;
     IncrementalSearchBar *_searchBar = nullptr;
     TerminalHeaderBar *_headerBar = nullptr;
     QRect _searchResultRect;
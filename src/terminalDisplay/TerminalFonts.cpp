@@ -36,6 +36,7 @@ void TerminalFont::applyProfile(const Profile::Ptr &profile)
     m_useFontBrailleCharacters = profile->property<bool>(Profile::UseFontBrailleCharacters);
     m_lineSpacing = uint(profile->lineSpacing());
     setVTFont(profile->font());
+    m_fontFallbackCache.clear();
     extraFonts[0] = profile->emojiFont();
     if (extraFonts[0].family().isEmpty()) {
         extraFonts[0] = QFont(QStringLiteral("Noto Color Emoji"));
@@ -224,6 +225,8 @@ bool TerminalFont::useFontBrailleCharacters() const
 
 void TerminalFont::fontChange(const QFont &)
 {
+    m_fontFallbackCache.clear();
+
     QFontMetrics fm(qobject_cast<QWidget *>(m_parent)->font());
     m_fontHeight = fm.height() + m_lineSpacing;
 
@@ -253,4 +256,28 @@ QFont TerminalFont::getExtraFont(int i) const
 {
     return extraFonts[i];
 }
+
+QFont TerminalFont::fontForCharacter(uint ucs4, const QFont &baseFont) const
+{
+    auto it = m_fontFallbackCache.constFind(ucs4);
+    if (it == m_fontFallbackCache.constEnd()) {
+        qint16 decision = -1;
+        if (QFontMetrics(baseFont).inFontUcs4(ucs4)) {
+            decision = 0;
+        } else {
+            for (auto extraIt = extraFonts.constBegin(); extraIt != extraFonts.constEnd(); ++extraIt) {
+                if (QFontMetrics(extraIt.value()).inFontUcs4(ucs4)) {
+                    decision = qint16(1 + extraIt.key());
+                    break;
+                }
+            }
+        }
+        it = m_fontFallbackCache.insert(ucs4, decision);
+    }
+
+    if (it.value() <= 0) {
+        return baseFont;
+    }
+    return extraFonts[it.value() - 1];
+}
 }
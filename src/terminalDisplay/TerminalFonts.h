@@ -9,6 +9,7 @@
 #ifndef TERMINALFONTS_H
 #define TERMINALFONTS_H
 
+#include <QHash>
 #include <QWidget>
 
 #include "konsoleprivate_export.h"
@@ -51,6 +52,16 @@ public:
     bool hasExtraFont(int i) const;
     QFont getExtraFont(int i) const;
 
+    /**
+     * Returns the font to draw @p ucs4 with: @p baseFont when it covers the
+     * character, the first configured extra font that covers it otherwise,
+     * or @p baseFont again when nothing does (Qt's font merging then picks
+     * a system fallback at draw time). The coverage decision is cached per
+     * codepoint and reset on font changes, so mixed emoji/CJK output does
+     * not re-resolve fallbacks every frame.
+     */
+    QFont fontForCharacter(uint ucs4, const QFont &baseFont) const;
+
 protected:
     void fontChange(const QFont &);
 
@@ -70,6 +81,11 @@ private:
     bool m_useFontBrailleCharacters = true;
     QMap<int, QFont> extraFonts;
 
+    // Per-codepoint fallback decision, see fontForCharacter().
+    // 0 means the base font covers the codepoint, -1 means no configured
+    // font does, otherwise the value is 1 + the extraFonts key to use.
+    mutable QHash<uint, qint16> m_fontFallbackCache;
+
     Profile::Ptr m_profile;
 };
 
@@ -26,6 +26,7 @@
 #include <QPainter>
 #include <QPainterPath>
 #include <QPen>
+#include <QPixmapCache>
 #include <QRect>
 #include <QRegion>
 #include <QString>
@@ -34,6 +35,10 @@
 
 #include <optional>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // we use this to force QPainter to display text in LTR mode
 // more information can be found in: https://unicode.org/reports/tr9/
 const QChar LTR_OVERRIDE_CHAR(0x202D);
@@ -176,15 +181,15 @@ qreal wcag20Contrast(const QColor &c1, const QColor &c2)
     return (l1 > l2) ? l1 / l2 : l2 / l1;
 }
 
-std::optional<QColor> calculateBackgroundColor(const Character style, const QColor *colorTable)
+std::optional<QColor> calculateBackgroundColor(const Character style, const QColor *colorTable, const QColor *color256)
 {
-    auto c1 = style.backgroundColor.color(colorTable);
+    auto c1 = style.backgroundColor.color(colorTable, color256);
     const auto initialBG = c1;
 
     c1.setAlphaF(0.8);
 
     const auto blend1 = alphaBlend(c1, colorTable[DEFAULT_FORE_COLOR]), blend2 = alphaBlend(c1, colorTable[DEFAULT_BACK_COLOR]);
-    const auto fg = style.foregroundColor.color(colorTable);
+    const auto fg = style.foregroundColor.color(colorTable, color256);
 
     const auto contrast1 = wcag20Contrast(fg, blend1), contrast2 = wcag20Contrast(fg, blend2);
     const auto contrastBG1 = wcag20Contrast(blend1, initialBG), contrastBG2 = wcag20Contrast(blend2, initialBG);
@@ -208,6 +213,21 @@ static void reverseRendition(Character &p)
     p.backgroundColor = f;
 }
 
+// True when two cells share rendition, colors and extra flags, i.e. they can
+// be drawn as part of the same text fragment. The style fields occupy the
+// last twelve bytes of the 16-byte cell, so with SSE2 this is a single wide
+// compare with the character bytes masked off.
+static inline bool sameDrawStyle(const Character &a, const Character &b)
+{
+    static_assert(sizeof(Character) == 16, "style run compare assumes 16-byte cells");
+#if defined(__SSE2__)
+    const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&a)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(&b)));
+    return (_mm_movemask_epi8(eq) & 0xfff0) == 0xfff0;
+#else
+    return memcmp(reinterpret_cast<const char *>(&a) + 4, reinterpret_cast<const char *>(&b) + 4, 12) == 0;
+#endif
+}
+
 void TerminalPainter::drawContents(Character *image,
                                    QPainter &paint,
                                    const QRect &rect,
@@ -276,6 +296,7 @@ void TerminalPainter::drawContents(Character *image,
     const QFont::Weight boldWeight = it != std::end(FontWeights) ? *it : QFont::Black;
     paint.setLayoutDirection(Qt::LeftToRight);
     const QColor *colorTable = m_parentDisplay->terminalColor()->colorTable();
+    const QColor *color256 = m_parentDisplay->terminalColor()->color256Table();
 
     for (int y = rect.y(); y <= rect.bottom(); y++) {
         int pos = m_parentDisplay->loc(0, y);
@@ -384,6 +405,43 @@ void TerminalPainter::drawContents(Character *image,
                 continue;
             }
 
+            // Batch a run of identity-mapped single-column cells sharing
+            // rendition, colors and flags into one fragment, so a uniform
+            // line becomes one style setup and one draw call. Shaped,
+            // reordered, wide and cursor cells keep the per-cell path.
+            if (!wordMode && !shaped && !doubleWidth && log_x == x && char_value.rendition.f.cursor == 0 && !char_value.isRightHalfOfDoubleWide()
+                && log2line[x + 1] - log2line[x] == 1) {
+                int runEnd = x;
+                while (runEnd < right) {
+                    const int next = runEnd + 1;
+                    const Character &nextChar = image[pos + next];
+                    if (vis2log(next) != next || log2line[next + 1] - log2line[next] != 1 || nextChar.isRightHalfOfDoubleWide()
+                        || image[qMin(pos + next + 1, imageSize - 1)].isRightHalfOfDoubleWide() || !sameDrawStyle(char_value, nextChar)) {
+                        break;
+                    }
+                    runEnd = next;
+                }
+                if (runEnd > x) {
+                    const QString runStr = line.mid(log2line[x], runEnd - x + 1);
+                    const int runX = leftPadding + fontWidth * x * (doubleWidthLine ? 2 : 1);
+                    const QRect runArea(textScale.inverted().map(QPoint(runX, textY)), QSize(fontWidth * (runEnd - x + 1), textHeight));
+                    drawTextCharacters(paint,
+                                       runArea,
+                                       runStr,
+                                       char_value,
+                                       colorTable,
+                                       invertedRendition,
+                                       lineProperty,
+                                       printerFriendly,
+                                       oldRendition,
+                                       oldColor,
+                                       normalWeight,
+                                       boldWeight);
+                    x = runEnd;
+                    continue;
+                }
+            }
+
             QString unistr = line.mid(log2line[log_x], log2line[log_x + 1] - log2line[log_x]);
             if (shaped) {
                 unistr[0] = shapemap[log2line[log_x]];
@@ -407,14 +465,14 @@ void TerminalPainter::drawContents(Character *image,
                         }
                     }
 
-                    QColor foregroundColor = style.foregroundColor.color(colorTable);
-                    QColor backgroundColor = style.backgroundColor.color(colorTable);
+                    QColor foregroundColor = style.foregroundColor.color(colorTable, color256);
+                    QColor backgroundColor = style.backgroundColor.color(colorTable, color256);
 
                     if (style.rendition.f.selected) {
                         if (!invertedRendition) {
-                            backgroundColor = calculateBackgroundColor(style, colorTable).value_or(foregroundColor);
+                            backgroundColor = calculateBackgroundColor(style, colorTable, color256).value_or(foregroundColor);
                             if (backgroundColor == foregroundColor) {
-                                foregroundColor = style.backgroundColor.color(colorTable);
+                                foregroundColor = style.backgroundColor.color(colorTable, color256);
                             }
                         }
                     }
@@ -507,6 +565,33 @@ void TerminalPainter::drawContents(Character *image,
         }
 
         paint.setWorldTransform(textScale.inverted(), true);
+        if (!printerFriendly) {
+            // Highlight-all search matches: the search filter committed its
+            // match spans into the hotspot interval index, so the highlights
+            // for this line can be filled directly without re-walking every
+            // hotspot (or re-running the pattern) at paint time
+            const QList<QPair<int, int>> markerSpans = m_parentDisplay->filterChain()->markerSpansForLine(y);
+            if (!markerSpans.isEmpty()) {
+                // TODO - Do not use a hardcoded color for this
+                const bool isCurrentResultLine = (m_parentDisplay->screenWindow()->currentResultLine() == (y + m_parentDisplay->screenWindow()->currentLine()));
+                const QColor markerColor = isCurrentResultLine ? QColor(255, 255, 0, 120) : QColor(255, 0, 0, 120);
+                for (const auto &span : markerSpans) {
+                    int endColumn = span.second;
+                    if (endColumn > m_parentDisplay->columns()) {
+                        // middle line of a multi-line match; ignore the
+                        // whitespace at the end of the line
+                        endColumn = m_parentDisplay->columns() - 1;
+                        while (endColumn > 0 && image[pos + endColumn].isSpace()) {
+                            endColumn--;
+                        }
+                        endColumn++;
+                    }
+                    QRect r;
+                    r.setCoords(span.first * fontWidth + leftPadding, textY, endColumn * fontWidth + leftPadding - 1, textY + fontHeight - 1);
+                    paint.fillRect(r, markerColor);
+                }
+            }
+        }
         if (lineProperty.flags.f.prompt_start && semanticHintsActive) {
             QPen pen(m_parentDisplay->terminalColor()->foregroundColor());
             paint.setPen(pen);
@@ -560,59 +645,12 @@ void TerminalPainter::highlightScrolledLines(QPainter &painter, bool isTimerActi
     painter.fillRect(rect, color);
 }
 
-QRegion TerminalPainter::highlightScrolledLinesRegion(TerminalScrollBar *scrollBar)
-{
-    QRegion dirtyRegion;
-    const int highlightLeftPosition = m_parentDisplay->scrollBar()->scrollBarPosition() == Enum::ScrollBarLeft ? m_parentDisplay->scrollBar()->width() : 0;
-
-    int start = 0;
-    int nb_lines = abs(m_parentDisplay->screenWindow()->scrollCount());
-    if (nb_lines > 0 && m_parentDisplay->scrollBar()->maximum() > 0) {
-        QRect new_highlight;
-        bool addToCurrentHighlight = scrollBar->highlightScrolledLines().isTimerActive()
-            && (m_parentDisplay->screenWindow()->scrollCount() * scrollBar->highlightScrolledLines().getPreviousScrollCount() > 0);
-        if (addToCurrentHighlight) {
-            const int oldScrollCount = scrollBar->highlightScrolledLines().getPreviousScrollCount();
-            if (m_parentDisplay->screenWindow()->scrollCount() > 0) {
-                start = -1 * (oldScrollCount + m_parentDisplay->screenWindow()->scrollCount()) + m_parentDisplay->screenWindow()->windowLines();
-            } else {
-                start = -1 * oldScrollCount;
-            }
-            scrollBar->highlightScrolledLines().setPreviousScrollCount(oldScrollCount + m_parentDisplay->screenWindow()->scrollCount());
-        } else {
-            start = m_parentDisplay->screenWindow()->scrollCount() > 0 ? m_parentDisplay->screenWindow()->windowLines() - nb_lines : 0;
-            scrollBar->highlightScrolledLines().setPreviousScrollCount(m_parentDisplay->screenWindow()->scrollCount());
-        }
-
-        new_highlight.setRect(highlightLeftPosition,
-                              m_parentDisplay->contentRect().top() + start * m_parentDisplay->terminalFont()->fontHeight(),
-                              scrollBar->highlightScrolledLines().HIGHLIGHT_SCROLLED_LINES_WIDTH,
-                              nb_lines * m_parentDisplay->terminalFont()->fontHeight());
-        new_highlight.setTop(std::max(new_highlight.top(), m_parentDisplay->contentRect().top()));
-        new_highlight.setBottom(std::min(new_highlight.bottom(), m_parentDisplay->contentRect().bottom()));
-        new_highlight = highdpi_adjust_rect(new_highlight);
-        if (!new_highlight.isValid()) {
-            new_highlight = QRect(0, 0, 0, 0);
-        }
-
-        if (addToCurrentHighlight) {
-            scrollBar->highlightScrolledLines().rect() |= new_highlight;
-        } else {
-            dirtyRegion |= scrollBar->highlightScrolledLines().rect();
-            scrollBar->highlightScrolledLines().rect() = new_highlight;
-        }
-        dirtyRegion |= new_highlight;
-
-        scrollBar->highlightScrolledLines().startTimer();
-    }
-
-    return dirtyRegion;
-}
-
 void TerminalPainter::drawBackground(QPainter &painter, const QRect &rect, const QColor &backgroundColor, bool useOpacitySetting)
 {
-    if (!m_parentDisplay->wallpaper()->isNull()
-        && m_parentDisplay->wallpaper()->draw(painter, rect, useOpacitySetting ? m_parentDisplay->terminalColor()->opacity() : 1.0, backgroundColor)) {
+    const ColorSchemeWallpaper::Ptr wallpaper = m_parentDisplay->wallpaper();
+    if (!wallpaper->isNull() && !wallpaper->isAnimated() && drawBackgroundFromCache(painter, rect, backgroundColor, useOpacitySetting)) {
+    } else if (!wallpaper->isNull()
+               && wallpaper->draw(painter, rect, useOpacitySetting ? m_parentDisplay->terminalColor()->opacity() : 1.0, backgroundColor)) {
     } else if (qAlpha(m_parentDisplay->terminalColor()->blendColor()) < 0xff && useOpacitySetting) {
 #if defined(Q_OS_MACOS)
         // TODO: On MacOS, using CompositionMode doesn't work. Altering the
@@ -632,6 +670,51 @@ void TerminalPainter::drawBackground(QPainter &painter, const QRect &rect, const
     }
 }
 
+bool TerminalPainter::drawBackgroundFromCache(QPainter &painter, const QRect &rect, const QColor &backgroundColor, bool useOpacitySetting)
+{
+    const ColorSchemeWallpaper::Ptr wallpaper = m_parentDisplay->wallpaper();
+    const qreal opacity = useOpacitySetting ? m_parentDisplay->terminalColor()->opacity() : 1.0;
+    const qreal dpr = m_parentDisplay->devicePixelRatioF();
+    const QSize size = m_parentDisplay->size();
+
+    const bool cacheValid = !m_backgroundCache.isNull() //
+        && m_backgroundCacheSize == size //
+        && m_backgroundCacheColor == backgroundColor //
+        && qFuzzyCompare(m_backgroundCacheDpr, dpr) //
+        && qFuzzyCompare(m_backgroundCacheOpacity, opacity) //
+        && m_backgroundCacheWallpaper == wallpaper.data();
+
+    if (!cacheValid) {
+        QPixmap cache(QSize(qCeil(size.width() * dpr), qCeil(size.height() * dpr)));
+        cache.setDevicePixelRatio(dpr);
+        cache.fill(Qt::transparent);
+
+        QPainter cachePainter(&cache);
+        if (!wallpaper->draw(cachePainter, QRect(QPoint(0, 0), size), opacity, backgroundColor)) {
+            m_backgroundCache = QPixmap();
+            return false;
+        }
+
+        m_backgroundCache = cache;
+        m_backgroundCacheSize = size;
+        m_backgroundCacheColor = backgroundColor;
+        m_backgroundCacheDpr = dpr;
+        m_backgroundCacheOpacity = opacity;
+        m_backgroundCacheWallpaper = wallpaper.data();
+    }
+
+    // Composited over a cleared surface at cache-build time, so replacing
+    // the target pixels reproduces what drawing directly would have left
+    // there, including the alpha of translucent profiles
+    const QPainter::CompositionMode originalMode = painter.compositionMode();
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    const QRectF sourceRect(rect.x() * dpr, rect.y() * dpr, rect.width() * dpr, rect.height() * dpr);
+    painter.drawPixmap(QRectF(rect), m_backgroundCache, sourceRect);
+    painter.setCompositionMode(originalMode);
+
+    return true;
+}
+
 void TerminalPainter::updateCursorTextColor(const QColor &backgroundColor, QColor &characterColor)
 {
     if (m_parentDisplay->cursorShape() == Enum::BlockCursor) {
@@ -704,6 +787,71 @@ void TerminalPainter::drawCursor(QPainter &painter, const QRectF &cursorRect, co
     }
 }
 
+bool TerminalPainter::drawTextViaGlyphCache(QPainter &painter, int x, int y, const QString &text)
+{
+    // Only simple LTR spacing characters can be drawn cell-by-cell without
+    // changing shaping; everything else (combining marks, RTL scripts,
+    // surrogate pairs, double-width characters) takes the regular
+    // QPainter::drawText() path.
+    for (const QChar qc : text) {
+        const char16_t u = qc.unicode();
+        if (u < 0x20 || u >= 0x300) {
+            return false;
+        }
+    }
+
+    // Blitting assumes the painter maps our integer cell grid 1:1.
+    if (painter.combinedTransform().type() > QTransform::TxTranslate) {
+        return false;
+    }
+
+    const int cellWidth = m_parentDisplay->terminalFont()->fontWidth();
+    const int cellHeight = m_parentDisplay->terminalFont()->fontHeight();
+    const int ascent = m_parentDisplay->terminalFont()->fontAscent();
+    // allow glyphs (italic overhang, antialiasing fringes) to spill a
+    // little outside their cell, as they can with direct drawText()
+    const int pad = (cellWidth + 1) / 2;
+
+    const QFont font = painter.font();
+    const QColor color = painter.pen().color();
+    const qreal dpr = painter.device()->devicePixelRatioF();
+    const bool antialias = painter.testRenderHint(QPainter::TextAntialiasing);
+
+    // The font key, color and device pixel ratio are part of the cache key,
+    // so a font or DPR change simply stops hitting the old entries and
+    // QPixmapCache evicts them; no explicit invalidation hook is needed.
+    const QString keySuffix = QLatin1Char(' ') + font.key() + QLatin1Char(' ') + QString::number(color.rgba(), 16) + QLatin1Char(' ') + QString::number(dpr)
+        + (font.underline() ? QLatin1Char('u') : QLatin1Char('-')) + (font.strikeOut() ? QLatin1Char('s') : QLatin1Char('-'))
+        + (font.overline() ? QLatin1Char('o') : QLatin1Char('-')) + (antialias ? QLatin1Char('a') : QLatin1Char('-'));
+
+    for (int i = 0; i < text.size(); ++i) {
+        const QChar c = text.at(i);
+
+        const QString key = QLatin1String("konsole-glyph ") + QString::number(c.unicode(), 16) + keySuffix;
+
+        QPixmap glyph;
+        if (!QPixmapCache::find(key, &glyph)) {
+            glyph = QPixmap(QSize(qRound((cellWidth + 2 * pad) * dpr), qRound(cellHeight * dpr)));
+            glyph.setDevicePixelRatio(dpr);
+            glyph.fill(Qt::transparent);
+
+            QPainter glyphPainter(&glyph);
+            glyphPainter.setFont(font);
+            glyphPainter.setPen(color);
+            glyphPainter.setLayoutDirection(Qt::LeftToRight);
+            glyphPainter.setRenderHint(QPainter::TextAntialiasing, antialias);
+            glyphPainter.drawText(pad, ascent, QString(c));
+            glyphPainter.end();
+
+            QPixmapCache::insert(key, glyph);
+        }
+
+        painter.drawPixmap(x + i * cellWidth - pad, y - ascent, glyph);
+    }
+
+    return true;
+}
+
 void TerminalPainter::drawCharacters(QPainter &painter,
                                      const QRect &rect,
                                      const QString &text,
@@ -761,7 +909,7 @@ void TerminalPainter::drawCharacters(QPainter &painter,
     }
 
     // setup pen
-    const QColor foregroundColor = style.foregroundColor.color(m_parentDisplay->terminalColor()->colorTable());
+    const QColor foregroundColor = style.foregroundColor.color(m_parentDisplay->terminalColor()->colorTable(), m_parentDisplay->terminalColor()->color256Table());
     const QColor color = characterColor.isValid() ? characterColor : foregroundColor;
     QPen pen = painter.pen();
     if (pen.color() != color) {
@@ -790,10 +938,12 @@ void TerminalPainter::drawCharacters(QPainter &painter,
             y += shifted;
         }
 
-        if (m_parentDisplay->bidiEnabled()) {
-            painter.drawText(rect.x(), y, text);
-        } else {
-            painter.drawText(rect.x(), y, LTR_OVERRIDE_CHAR + text);
+        if (!drawTextViaGlyphCache(painter, rect.x(), y, text)) {
+            if (m_parentDisplay->bidiEnabled()) {
+                painter.drawText(rect.x(), y, text);
+            } else {
+                painter.drawText(rect.x(), y, LTR_OVERRIDE_CHAR + text);
+            }
         }
 
         if (shifted > 0) {
@@ -820,22 +970,100 @@ void TerminalPainter::drawLineCharString(TerminalDisplay *display, QPainter &pai
     painter.setRenderHint(QPainter::Antialiasing, false);
 }
 
+void TerminalPainter::drawCursorCell(QPainter &painter, const QRect &cellRect, const Character cell, const LineProperty lineProperty)
+{
+    const QColor *colorTable = m_parentDisplay->terminalColor()->colorTable();
+    const QColor *color256 = m_parentDisplay->terminalColor()->color256Table();
+
+    // the caller's paint event has already filled the region with the
+    // default background; only non-default cell backgrounds need a fill
+    const QColor backgroundColor = cell.backgroundColor.color(colorTable, color256);
+    if (backgroundColor != m_parentDisplay->terminalColor()->backgroundColor()) {
+        painter.fillRect(cellRect, backgroundColor);
+    }
+
+    if (cell.rendition.f.cursor != 0) {
+        QColor foregroundColor = cell.foregroundColor.color(colorTable, color256);
+        QColor characterColor = foregroundColor;
+        drawCursor(painter, cellRect, foregroundColor, backgroundColor, characterColor);
+    }
+
+    static const QFont::Weight FontWeights[] = {
+        QFont::Thin,
+        QFont::Light,
+        QFont::Normal,
+        QFont::Bold,
+        QFont::Black,
+    };
+    const QFont::Weight normalWeight = m_parentDisplay->font().weight();
+    auto it = std::upper_bound(std::begin(FontWeights), std::end(FontWeights), normalWeight);
+    const QFont::Weight boldWeight = it != std::end(FontWeights) ? *it : QFont::Black;
+
+    RenditionFlags oldRendition = -1;
+    QColor oldColor = QColor();
+    drawTextCharacters(painter,
+                       cellRect,
+                       QString(QChar(ushort(cell.character))),
+                       cell,
+                       colorTable,
+                       false /* invertedRendition; eligible cells are never selected */,
+                       lineProperty,
+                       false /* printerFriendly */,
+                       oldRendition,
+                       oldColor,
+                       normalWeight,
+                       boldWeight);
+}
+
 void TerminalPainter::drawInputMethodPreeditString(QPainter &painter, const QRect &rect, TerminalDisplay::InputMethodData &inputMethodData, Character *image)
 {
     if (inputMethodData.preeditString.isEmpty() || !m_parentDisplay->isCursorOnDisplay()) {
+        inputMethodData.cachedLayer = QPixmap();
         return;
     }
 
     const QPoint cursorPos = m_parentDisplay->cursorPosition();
 
-    QColor characterColor;
     const QColor background = m_parentDisplay->terminalColor()->colorTable()[DEFAULT_BACK_COLOR];
     const QColor foreground = m_parentDisplay->terminalColor()->colorTable()[DEFAULT_FORE_COLOR];
     const Character style = image[m_parentDisplay->loc(cursorPos.x(), cursorPos.y())];
 
-    drawBackground(painter, rect, background, true);
-    drawCursor(painter, rect, foreground, background, characterColor);
-    drawCharacters(painter, rect, inputMethodData.preeditString, style, characterColor, LineProperty());
+    // Rendering the composition is the expensive part, so it is done into
+    // an offscreen layer that is reused until the string itself or anything
+    // feeding into its appearance changes; repaints of the covered area -
+    // every composition keystroke over busy output - just blit it.
+    const qreal dpr = m_parentDisplay->devicePixelRatioF();
+    const bool cacheValid = !inputMethodData.cachedLayer.isNull() //
+        && inputMethodData.cachedString == inputMethodData.preeditString //
+        && inputMethodData.cachedRect == rect //
+        && inputMethodData.cachedForeground == foreground //
+        && inputMethodData.cachedBackground == background //
+        && inputMethodData.cachedStyle == style //
+        && qFuzzyCompare(inputMethodData.cachedLayer.devicePixelRatio(), dpr);
+
+    if (!cacheValid) {
+        QPixmap layer(QSize(qCeil(rect.width() * dpr), qCeil(rect.height() * dpr)));
+        layer.setDevicePixelRatio(dpr);
+
+        QPainter layerPainter(&layer);
+        layerPainter.setFont(painter.font());
+        layerPainter.setRenderHints(painter.renderHints());
+        layerPainter.translate(-rect.topLeft());
+
+        QColor characterColor;
+        drawBackground(layerPainter, rect, background, true);
+        drawCursor(layerPainter, rect, foreground, background, characterColor);
+        drawCharacters(layerPainter, rect, inputMethodData.preeditString, style, characterColor, LineProperty());
+
+        inputMethodData.cachedLayer = layer;
+        inputMethodData.cachedString = inputMethodData.preeditString;
+        inputMethodData.cachedRect = rect;
+        inputMethodData.cachedForeground = foreground;
+        inputMethodData.cachedBackground = background;
+        inputMethodData.cachedStyle = style;
+    }
+
+    painter.drawPixmap(rect.topLeft(), inputMethodData.cachedLayer);
 
     inputMethodData.previousPreeditRect = rect;
 }
@@ -858,6 +1086,7 @@ void TerminalPainter::drawBelowText(QPainter &painter,
 {
     // setup painter
 
+    const QColor *color256 = m_parentDisplay->terminalColor()->color256Table();
     bool first = true;
     QRect constRect(0, 0, 0, 0);
     QColor backgroundColor;
@@ -885,18 +1114,18 @@ void TerminalPainter::drawBelowText(QPainter &painter,
             //   colors OR
             // - blending the foreground/background colors
             if (style[x].rendition.f.selected && invertedRendition) {
-                backgroundColor = style[x].foregroundColor.color(colorTable);
-                foregroundColor = style[x].backgroundColor.color(colorTable);
+                backgroundColor = style[x].foregroundColor.color(colorTable, color256);
+                foregroundColor = style[x].backgroundColor.color(colorTable, color256);
             } else {
-                foregroundColor = style[x].foregroundColor.color(colorTable);
-                backgroundColor = style[x].backgroundColor.color(colorTable);
+                foregroundColor = style[x].foregroundColor.color(colorTable, color256);
+                backgroundColor = style[x].backgroundColor.color(colorTable, color256);
             }
 
             if (style[x].rendition.f.selected) {
                 if (!invertedRendition) {
-                    backgroundColor = calculateBackgroundColor(style[x], colorTable).value_or(foregroundColor);
+                    backgroundColor = calculateBackgroundColor(style[x], colorTable, color256).value_or(foregroundColor);
                     if (backgroundColor == foregroundColor) {
-                        foregroundColor = style[x].backgroundColor.color(colorTable);
+                        foregroundColor = style[x].backgroundColor.color(colorTable, color256);
                     }
                 }
             }
@@ -931,6 +1160,7 @@ void TerminalPainter::drawAboveText(QPainter &painter,
                                     int lastNonSpace,
                                     CharacterColor const *ulColorTable)
 {
+    const QColor *color256 = m_parentDisplay->terminalColor()->color256Table();
     bool first = true;
     QColor backgroundColor;
     QColor foregroundColor;
@@ -973,7 +1203,7 @@ void TerminalPainter::drawAboveText(QPainter &painter,
                     && startUnderline >= 0) {
                     QPen pen(foregroundColor);
                     if (ulColorTable != nullptr && (style[lastX].flags & EF_UNDERLINE_COLOR) != 0) {
-                        pen.setColor(ulColorTable[((style[lastX].flags & EF_UNDERLINE_COLOR)) / EF_UNDERLINE_COLOR_1 - 1].color(colorTable));
+                        pen.setColor(ulColorTable[((style[lastX].flags & EF_UNDERLINE_COLOR)) / EF_UNDERLINE_COLOR_1 - 1].color(colorTable, color256));
                     }
                     const int lw = m_parentDisplay->terminalFont()->lineWidth();
                     qreal y = rect.y() + m_parentDisplay->terminalFont()->fontAscent() + m_parentDisplay->terminalFont()->underlinePos()
@@ -1033,18 +1263,18 @@ void TerminalPainter::drawAboveText(QPainter &painter,
             //   colors OR
             // - blending the foreground/background colors
             if (style[x].rendition.f.selected && invertedRendition) {
-                backgroundColor = style[x].foregroundColor.color(colorTable);
-                foregroundColor = style[x].backgroundColor.color(colorTable);
+                backgroundColor = style[x].foregroundColor.color(colorTable, color256);
+                foregroundColor = style[x].backgroundColor.color(colorTable, color256);
             } else {
-                foregroundColor = style[x].foregroundColor.color(colorTable);
-                backgroundColor = style[x].backgroundColor.color(colorTable);
+                foregroundColor = style[x].foregroundColor.color(colorTable, color256);
+                backgroundColor = style[x].backgroundColor.color(colorTable, color256);
             }
 
             if (style[x].rendition.f.selected) {
                 if (!invertedRendition) {
-                    backgroundColor = calculateBackgroundColor(style[x], colorTable).value_or(foregroundColor);
+                    backgroundColor = calculateBackgroundColor(style[x], colorTable, color256).value_or(foregroundColor);
                     if (backgroundColor == foregroundColor) {
-                        foregroundColor = style[x].backgroundColor.color(colorTable);
+                        foregroundColor = style[x].backgroundColor.color(colorTable, color256);
                     }
                 }
             }
@@ -1159,14 +1389,15 @@ void TerminalPainter::drawTextCharacters(QPainter &painter,
             }
         }
 
-        QColor foregroundColor = style.foregroundColor.color(colorTable);
-        QColor backgroundColor = style.backgroundColor.color(colorTable);
+        const QColor *color256 = m_parentDisplay->terminalColor()->color256Table();
+        QColor foregroundColor = style.foregroundColor.color(colorTable, color256);
+        QColor backgroundColor = style.backgroundColor.color(colorTable, color256);
 
         if (style.rendition.f.selected) {
             if (!invertedRendition) {
-                backgroundColor = calculateBackgroundColor(style, colorTable).value_or(foregroundColor);
+                backgroundColor = calculateBackgroundColor(style, colorTable, color256).value_or(foregroundColor);
                 if (backgroundColor == foregroundColor) {
-                    foregroundColor = style.backgroundColor.color(colorTable);
+                    foregroundColor = style.backgroundColor.color(colorTable, color256);
                 }
             }
         }
@@ -1218,6 +1449,23 @@ void TerminalPainter::drawTextCharacters(QPainter &painter,
                 painter.setFont(currentFont);
             }
         }
+
+        // For a lone character outside the Basic Latin range, resolve the
+        // font covering it through the cached lookup in TerminalFont instead
+        // of leaving it to Qt's font merging, which re-runs the fallback
+        // search on every draw. Multi-character runs keep the primary font
+        // so Latin text mixed into them renders unchanged.
+        if (!text.isEmpty() && text.size() <= 2 && text.at(0).unicode() >= 0x2B0) {
+            const uint ucs4 = (text.size() == 2 && text.at(0).isHighSurrogate() && text.at(1).isLowSurrogate())
+                ? QChar::surrogateToUcs4(text.at(0), text.at(1))
+                : text.at(0).unicode();
+            const QFont resolved = m_parentDisplay->terminalFont()->fontForCharacter(ucs4, painter.font());
+            if (resolved != painter.font()) {
+                savedFont = painter.font();
+                restoreFont = true;
+                painter.setFont(resolved);
+            }
+        }
     }
 
     if (characterColor != oldColor) {
@@ -1247,7 +1495,9 @@ void TerminalPainter::drawTextCharacters(QPainter &painter,
             // We shift half way down here to center
             y += m_parentDisplay->terminalFont()->lineSpacing() / 2;
         }
-        painter.drawText(rect.x(), y, text);
+        if (!drawTextViaGlyphCache(painter, rect.x(), y, text)) {
+            painter.drawText(rect.x(), y, text);
+        }
         if (0 && text.toUcs4().length() >= 1) {
             fprintf(stderr, " %lli  ", (qint64)text.toUcs4().length());
             for (int i = 0; i < text.toUcs4().length(); i++) {
@@ -10,6 +10,7 @@
 #define TERMINALPAINTER_HPP
 
 // Qt
+#include <QPixmap>
 #include <QPolygonF>
 #include <QRectF>
 #include <QVariantAnimation>
@@ -63,9 +64,6 @@ public Q_SLOTS:
     // draw a thin highlight on the left of the screen for lines that have been scrolled into view
     void highlightScrolledLines(QPainter &painter, bool isTimerActive, QRect rect);
 
-    // compute which region need to be repainted for scrolled lines highlight
-    QRegion highlightScrolledLinesRegion(TerminalScrollBar *scrollBar);
-
     // draws the background for a text fragment
     // if useOpacitySetting is true then the color's alpha value will be set to
     // the display's transparency (set with setOpacity()), otherwise the background
@@ -80,13 +78,29 @@ public Q_SLOTS:
                         const QColor &characterColor,
                         const LineProperty lineProperty);
 
+    // draws a single plain cell (cursor blink fast path); the caller is
+    // responsible for checking that the cell needs none of the per-line
+    // machinery (bidi, decorations, selection, hints) of drawContents()
+    void drawCursorCell(QPainter &painter, const QRect &cellRect, const Character cell, const LineProperty lineProperty);
+
     // draws the preedit string for input methods
     void drawInputMethodPreeditString(QPainter &painter, const QRect &rect, TerminalDisplay::InputMethodData &inputMethodData, Character *image);
 
 private:
+    // draws simple spacing text cell-by-cell from a cache of rasterized
+    // glyph pixmaps keyed on (codepoint, font, color, DPR), so repeated
+    // frames blit instead of re-shaping and re-rasterizing; returns false
+    // when the text needs the regular QPainter::drawText() path
+    bool drawTextViaGlyphCache(QPainter &painter, int x, int y, const QString &text);
+
     // draws a string of line graphics
     void drawLineCharString(TerminalDisplay *display, QPainter &painter, int x, int y, const QString &str, const Character attributes);
 
+    // blits @p rect of a non-animated wallpaper background from
+    // m_backgroundCache, rebuilding the cache first if it is stale;
+    // returns false when the wallpaper could not be drawn
+    bool drawBackgroundFromCache(QPainter &painter, const QRect &rect, const QColor &backgroundColor, bool useOpacitySetting);
+
     void updateCursorTextColor(const QColor &backgroundColor, QColor &characterColor);
     // draws the cursor character
     void drawCursor(QPainter &painter, const QRectF &cursorRect, const QColor &foregroundColor, const QColor &backgroundColor, QColor &characterColor);
@@ -140,6 +154,17 @@ private:
     QVariantAnimation *m_cursorAnim;
     QRectF m_lastTargetRect;
     QPolygonF m_animatedCursorPolygon;
+
+    // The wallpaper background composited at display size, so dirty-rect
+    // fills blit from it instead of rescaling and re-blending the image
+    // every frame; rebuilt when any part of the key below changes.  See
+    // drawBackground().
+    QPixmap m_backgroundCache;
+    QSize m_backgroundCacheSize;
+    QColor m_backgroundCacheColor;
+    qreal m_backgroundCacheDpr = 0;
+    qreal m_backgroundCacheOpacity = -1;
+    const void *m_backgroundCacheWallpaper = nullptr;
 };
 
 }
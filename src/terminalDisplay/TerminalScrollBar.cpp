@@ -164,11 +164,11 @@ void TerminalScrollBar::applyScrollBarPosition(bool propagate)
 // display is much cheaper than re-rendering all the text for the
 // part of the image which has moved up or down.
 // Instead only new lines have to be drawn
-void TerminalScrollBar::scrollImage(int lines, const QRect &screenWindowRegion, Character *image, int imageSize)
+bool TerminalScrollBar::scrollImage(int lines, const QRect &screenWindowRegion, Character *image, int imageSize)
 {
     // return if there is nothing to do
     if ((lines == 0) || (image == nullptr)) {
-        return;
+        return false;
     }
 
     const auto display = qobject_cast<TerminalDisplay *>(this->parent());
@@ -181,7 +181,7 @@ void TerminalScrollBar::scrollImage(int lines, const QRect &screenWindowRegion,
 
     // return if there is nothing to do
     if (!region.isValid() || (region.top() + abs(lines)) >= region.bottom() || display->lines() <= region.bottom()) {
-        return;
+        return false;
     }
 
     // Note:  With Qt 4.4 the left edge of the scrolled area must be at 0
@@ -220,7 +220,7 @@ void TerminalScrollBar::scrollImage(int lines, const QRect &screenWindowRegion,
     scrollRect.setHeight(linesToMove * display->terminalFont()->fontHeight());
 
     if (!scrollRect.isValid() || scrollRect.isEmpty()) {
-        return;
+        return false;
     }
 
     // scroll internal image
@@ -241,6 +241,7 @@ void TerminalScrollBar::scrollImage(int lines, const QRect &screenWindowRegion,
 
     // scroll the display vertically to match internal _image
     display->scroll(0, display->terminalFont()->fontHeight() * (-lines), scrollRect);
+    return true;
 }
 
 void TerminalScrollBar::changeEvent(QEvent *e)
@@ -280,10 +281,16 @@ void TerminalScrollBar::paintEvent(QPaintEvent *event)
     QPainter p(this);
     p.setPen(Qt::NoPen);
 
+    // The density map already holds one entry per scrollbar pixel, so only
+    // the buckets inside the exposed rect need to be walked - independent
+    // of how many matches the search produced.
     p.setBrush(searchLineColor);
-    for (int y: std::as_const(_searchLines)) {
-        y = (y * height()) / _terminalLines;
-        p.drawRoundedRect(2, y, width() - 4, stripeHeight, cornerRadius, cornerRadius);
+    const int firstBucket = qMax(0, event->rect().top() - 1);
+    const int lastBucket = qMin(int(_searchLineBuckets.size()) - 1, event->rect().bottom() + 1);
+    for (int y = firstBucket; y <= lastBucket; ++y) {
+        if (_searchLineBuckets.at(y) > 0) {
+            p.drawRoundedRect(2, y, width() - 4, stripeHeight, cornerRadius, cornerRadius);
+        }
     }
 
     for (int i = 0; i < _markers.size(); ++i) {
@@ -295,25 +302,78 @@ void TerminalScrollBar::paintEvent(QPaintEvent *event)
 void TerminalScrollBar::searchLines(const QSet<int>& indexSet, int lines) {
     if (indexSet.isEmpty()) {
         _searchLines.clear();
-    } else {
-        _searchLines = indexSet;
+        _searchLineBuckets.clear();
+
+        if(sender()) {
+            _terminalLines = lines;
+        }
+
+        update();
+        return;
     }
 
+    // The search task emits its cumulative match set as chunks complete,
+    // so each emission is a superset of the previous one for the same
+    // search.  When the line-to-pixel mapping is unchanged, fold in only
+    // the lines not seen yet and repaint only the buckets they land in.
+    const bool remap = (sender() != nullptr && _terminalLines != lines) || _searchLineBuckets.size() != height();
+
     if(sender()) {
         _terminalLines = lines;
     }
 
-    update();
+    if (remap) {
+        _searchLines = indexSet;
+        rebuildSearchLineBuckets();
+        update();
+        return;
+    }
+
+    QRegion dirty;
+    for (const int line : indexSet) {
+        if (_searchLines.contains(line)) {
+            continue;
+        }
+        _searchLines.insert(line);
+
+        const int bucket = searchLineBucket(line);
+        if (bucket >= 0 && bucket < _searchLineBuckets.size() && _searchLineBuckets[bucket]++ == 0) {
+            // pad by a pixel on each side for the stripe's rounded corners
+            dirty += QRect(0, bucket - 1, width(), 3);
+        }
+    }
+
+    if (!dirty.isEmpty()) {
+        update(dirty);
+    }
 }
 
 void TerminalScrollBar::clearSearchLines() {
     searchLines(QSet<int>{}, 1000);
 }
 
+int TerminalScrollBar::searchLineBucket(int line) const
+{
+    return int((qint64(line) * height()) / qMax(1, _terminalLines));
+}
+
+void TerminalScrollBar::rebuildSearchLineBuckets()
+{
+    _searchLineBuckets.fill(0, height());
+
+    for (const int line : std::as_const(_searchLines)) {
+        const int bucket = searchLineBucket(line);
+        if (bucket >= 0 && bucket < _searchLineBuckets.size()) {
+            _searchLineBuckets[bucket]++;
+        }
+    }
+}
+
 void TerminalScrollBar::resizeEvent(QResizeEvent *event)
 {
     QScrollBar::resizeEvent(event);
     regenerateMarkersGeometry();
+    rebuildSearchLineBuckets();
 }
 
 void TerminalScrollBar::mouseDoubleClickEvent(QMouseEvent *event)
@@ -79,7 +79,9 @@ public:
     // 'region' is the part of the image to scroll - currently only
     // the top, bottom and height of 'region' are taken into account,
     // the left and right are ignored.
-    void scrollImage(int lines, const QRect &screenWindowRegion, Character *image, int imageSize);
+    // returns true when the internal image and the widget contents were
+    // actually shifted, false when the caller has to repaint everything
+    bool scrollImage(int lines, const QRect &screenWindowRegion, Character *image, int imageSize);
 
     Enum::ScrollBarPositionEnum scrollBarPosition() const
     {
@@ -149,6 +151,13 @@ private:
 
     double markerHeight() const;
 
+    // The scrollbar pixel a terminal line's search stripe lands on
+    int searchLineBucket(int line) const;
+
+    // Recomputes the per-pixel density map from _searchLines, after a
+    // resize or a change of the line-to-pixel mapping
+    void rebuildSearchLineBuckets();
+
     bool _scrollFullPage = false;
     bool _alternateScrolling = false;
     Enum::ScrollBarPositionEnum _scrollbarLocation = Enum::ScrollBarRight;
@@ -158,6 +167,10 @@ private:
     double _markerPSize = 2.0;
     QList<Marker *> _markers;
     QSet<int> _searchLines;
+    // how many search matches land on each scrollbar pixel; maintained
+    // incrementally as the search task streams in results, so painting
+    // and updating are independent of the match count
+    QList<int> _searchLineBuckets;
     int _terminalLines = 1;
     QColor _searchHighlightLineColor;
     int _lineOpacity = 100;
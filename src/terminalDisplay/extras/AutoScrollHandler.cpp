@@ -7,11 +7,17 @@
 
 #include "AutoScrollHandler.h"
 #include "../TerminalDisplay.h"
+#include "../TerminalFonts.h"
+#include "../TerminalScrollBar.h"
 #include <QAccessible>
 #include <QApplication>
 
 using namespace Konsole;
 
+// the legacy fixed auto-scroll tick; the per-frame steps are scaled so
+// the average speed stays what users are used to from it
+static const int LegacyIntervalMsecs = 100;
+
 AutoScrollHandler::AutoScrollHandler(QWidget *parent)
     : QObject(parent)
 {
@@ -25,14 +31,53 @@ void AutoScrollHandler::timerEvent(QTimerEvent *event)
     }
 
     auto *terminalDisplay = static_cast<TerminalDisplay *>(parent());
+    const QRect bounds = widget()->rect();
+    const QPoint cursorPos = widget()->mapFromGlobal(QCursor::pos());
+    const int fontHeight = qMax(1, terminalDisplay->terminalFont()->fontHeight());
+
+    // one line per legacy tick plus one per line-height the pointer sits
+    // beyond the edge -- the speed the fixed timer used to reach in a
+    // single jump -- accumulated in fractional per-frame steps so the
+    // view glides instead
+    int direction = 0;
+    int overshoot = 0;
+    if (cursorPos.y() < bounds.top()) {
+        direction = -1;
+        overshoot = bounds.top() - cursorPos.y();
+    } else if (cursorPos.y() > bounds.bottom()) {
+        direction = 1;
+        overshoot = cursorPos.y() - bounds.bottom();
+    }
+
+    if (direction == 0) {
+        _stepAccumulator = 0.0;
+    } else {
+        const double linesPerTick = 1.0 + double(overshoot) / fontHeight;
+        _stepAccumulator += linesPerTick * TerminalDisplay::frameIntervalMsecs() / LegacyIntervalMsecs;
+        const int lines = int(_stepAccumulator);
+        if (lines > 0) {
+            _stepAccumulator -= lines;
+            TerminalScrollBar *scrollBar = terminalDisplay->scrollBar();
+            scrollBar->setValue(scrollBar->value() + direction * lines);
+        }
+    }
+
+    // extend the selection to the freshly revealed lines within the same
+    // frame; the position is clamped inside the widget so the move does
+    // not trigger a second, jumpy scroll in extendSelection()
+    const QPoint clampedPos(qBound(bounds.left(), cursorPos.x(), bounds.right()), qBound(bounds.top(), cursorPos.y(), bounds.bottom()));
     QMouseEvent mouseEvent(QEvent::MouseMove,
-                           widget()->mapFromGlobal(QCursor::pos()),
-                           QCursor::pos(),
+                           clampedPos,
+                           widget()->mapToGlobal(clampedPos),
                            Qt::NoButton,
                            Qt::LeftButton,
                            terminalDisplay->usesMouseTracking() ? Qt::ShiftModifier : Qt::NoModifier);
 
+    // the clamped position lies inside the widget; keep the filter below
+    // from mistaking our own event for the pointer returning
+    _sendingSyntheticMove = true;
     QApplication::sendEvent(widget(), &mouseEvent);
+    _sendingSyntheticMove = false;
 }
 
 bool AutoScrollHandler::eventFilter(QObject *watched, QEvent *event)
@@ -42,6 +87,9 @@ bool AutoScrollHandler::eventFilter(QObject *watched, QEvent *event)
 
     switch (event->type()) {
     case QEvent::MouseMove: {
+        if (_sendingSyntheticMove) {
+            break;
+        }
         auto *mouseEvent = static_cast<QMouseEvent *>(event);
         bool mouseInWidget = widget()->rect().contains(mouseEvent->pos());
         auto *terminalDisplay = static_cast<TerminalDisplay *>(parent());
@@ -53,7 +101,10 @@ bool AutoScrollHandler::eventFilter(QObject *watched, QEvent *event)
             _timerId = 0;
         } else {
             if ((_timerId == 0) && terminalDisplay->selectionState() != 0 && ((mouseEvent->buttons() & Qt::LeftButton) != 0U)) {
-                _timerId = startTimer(100);
+                // stepping faster than the display refreshes just queues
+                // repaints; one scroll plus selection extension per frame
+                _stepAccumulator = 0.0;
+                _timerId = startTimer(TerminalDisplay::frameIntervalMsecs());
             }
         }
 
@@ -30,6 +30,11 @@ private:
     }
 
     int _timerId = 0;
+    // fractional scroll lines carried between frame ticks; see timerEvent()
+    double _stepAccumulator = 0.0;
+    // the synthetic per-frame move is clamped inside the widget; it must
+    // not be mistaken for the pointer returning
+    bool _sendingSyntheticMove = false;
 };
 
 }
@@ -10,6 +10,7 @@
 #include "HighlightScrolledLines.h"
 
 // Konsole
+#include "../TerminalDisplay.h"
 #include "../TerminalScrollBar.h"
 
 namespace Konsole
@@ -38,6 +39,46 @@ void HighlightScrolledLines::setPreviousScrollCount(int scrollCount)
     _previousScrollCount = scrollCount;
 }
 
+QRegion HighlightScrolledLines::addScrolledLines(int scrollCount, int windowLines, const QRect &contentRect, int fontHeight, int leftPosition)
+{
+    QRegion dirtyRegion;
+    const int nb_lines = abs(scrollCount);
+
+    int start = 0;
+    const bool addToCurrentHighlight = isTimerActive() && (scrollCount * _previousScrollCount > 0);
+    if (addToCurrentHighlight) {
+        if (scrollCount > 0) {
+            start = -1 * (_previousScrollCount + scrollCount) + windowLines;
+        } else {
+            start = -1 * _previousScrollCount;
+        }
+        _previousScrollCount += scrollCount;
+    } else {
+        start = scrollCount > 0 ? windowLines - nb_lines : 0;
+        _previousScrollCount = scrollCount;
+    }
+
+    QRect newHighlight;
+    newHighlight.setRect(leftPosition, contentRect.top() + start * fontHeight, HIGHLIGHT_SCROLLED_LINES_WIDTH, nb_lines * fontHeight);
+    newHighlight.setTop(std::max(newHighlight.top(), contentRect.top()));
+    newHighlight.setBottom(std::min(newHighlight.bottom(), contentRect.bottom()));
+    newHighlight = highdpi_adjust_rect(newHighlight);
+    if (!newHighlight.isValid()) {
+        newHighlight = QRect(0, 0, 0, 0);
+    }
+
+    if (addToCurrentHighlight) {
+        _rect |= newHighlight;
+    } else {
+        dirtyRegion |= _rect;
+        _rect = newHighlight;
+    }
+    dirtyRegion |= newHighlight;
+
+    startTimer();
+    return dirtyRegion;
+}
+
 void HighlightScrolledLines::setTimer(TerminalScrollBar *parent)
 {
     if (_enabled && _timer == nullptr) {
@@ -11,6 +11,7 @@
 
 // Qt
 #include <QRect>
+#include <QRegion>
 #include <QTimer>
 #include <QWidget>
 
@@ -45,6 +46,16 @@ public:
     void setEnabled(bool enable);
     int getPreviousScrollCount();
     void setPreviousScrollCount(int scrollCount);
+    /**
+     * Folds @p scrollCount freshly scrolled lines into the highlight,
+     * extending the current highlight while the fade timer runs and the
+     * scroll keeps its direction, or restarting it otherwise.  Returns
+     * the region to repaint: the new strip, plus the old one when the
+     * highlight restarts.  Call only when lines actually scrolled; the
+     * region is maintained incrementally from the deltas, so the feature
+     * costs nothing on updates that do not scroll.
+     */
+    QRegion addScrolledLines(int scrollCount, int windowLines, const QRect &contentRect, int fontHeight, int leftPosition);
     /**
      * Set the highlight line timer if it's enabled
      */
@@ -22,6 +22,8 @@
 
 #include <QLoggingCategory>
 
+#include <algorithm>
+
 Q_LOGGING_CATEGORY(KonsoleTmuxController, "konsole.tmux.controller", QtWarningMsg)
 
 namespace Konsole
@@ -83,6 +85,16 @@ TmuxController::~TmuxController()
 void TmuxController::initialize()
 {
     setState(State::Initializing);
+    // Both queries are written to the gateway immediately and answered in
+    // order, so the extra one costs no additional round trip. Knowing which
+    // pane has focus before the windows arrive lets
+    // handleListWindowsResponse() queue its capture-pane first.
+    _gateway->sendCommand(TmuxCommand(QStringLiteral("list-panes"))
+                              .flag(QStringLiteral("-a"))
+                              .format(QStringLiteral("#{window_active}#{pane_active} #{pane_id}")),
+                          [this](bool success, const QString &response) {
+                              handleActivePaneResponse(success, response);
+                          });
     _gateway->sendCommand(TmuxCommand(QStringLiteral("list-windows"))
                               .format(QStringLiteral("#{window_id} #{window_name} #{window_layout}")),
                           [this](bool success, const QString &response) {
@@ -90,6 +102,25 @@ void TmuxController::initialize()
                           });
 }
 
+void TmuxController::handleActivePaneResponse(bool success, const QString &response)
+{
+    if (!success || response.isEmpty()) {
+        return;
+    }
+
+    // One line per pane: "<window_active><pane_active> %<pane_id>"; the
+    // session's focused pane is the one marked "11".
+    const QStringList lines = response.split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        const QStringList parts = line.split(QLatin1Char(' '));
+        if (parts.size() < 2 || parts[0] != QLatin1String("11") || !parts[1].startsWith(QLatin1Char('%'))) {
+            continue;
+        }
+        _activePaneId = parts[1].mid(1).toInt();
+        return;
+    }
+}
+
 Session *TmuxController::gatewaySession() const
 {
     return _gatewaySession;
@@ -317,7 +348,23 @@ void TmuxController::handleListWindowsResponse(bool success, const QString &resp
     // %output arriving during capture would mix ANSI-escaped terminal output
     // with the plain-text capture-pane content, producing garbled display.
     _paneManager->suppressAllOutput();
-    const auto paneIds = _paneManager->allPaneIds();
+
+    // The captures are all pipelined up front — sendCommand() writes each
+    // command immediately and control mode tags the replies — so the round
+    // trips overlap instead of running back-to-back. tmux answers in
+    // submission order, so queue the focused pane first and the rest of
+    // its window next; background windows render last.
+    QList<int> paneIds = _paneManager->allPaneIds();
+    const QList<int> activeWindowPanes = _windowPanes.value(windowIdForPane(_activePaneId));
+    const auto captureRank = [&](int paneId) {
+        if (paneId == _activePaneId) {
+            return 0;
+        }
+        return activeWindowPanes.contains(paneId) ? 1 : 2;
+    };
+    std::stable_sort(paneIds.begin(), paneIds.end(), [&](int a, int b) {
+        return captureRank(a) < captureRank(b);
+    });
     for (int paneId : paneIds) {
         _stateRecovery->capturePaneHistory(paneId);
     }
@@ -364,6 +411,16 @@ void TmuxController::onLayoutChanged(int windowId, const QString &layout, const
     }
 
     if (parsed.has_value()) {
+        // tmux re-announces the window layout for events that move no pane
+        // (focus changes, session attach, …). The layout string embeds a
+        // checksum, so an identical string means identical geometry — skip
+        // the whole apply instead of re-walking the splitter tree.
+        if (!zoomed && _windowToTabIndex.contains(windowId) && _appliedLayoutStrings.value(windowId) == layout) {
+            qCDebug(KonsoleTmuxController) << "onLayoutChanged: layout string unchanged, skipping apply";
+            return;
+        }
+        _appliedLayoutStrings[windowId] = layout;
+
         setState(State::ApplyingLayout);
         applyWindowLayout(windowId, parsed.value());
         setState(State::Idle);
@@ -459,6 +516,7 @@ void TmuxController::onWindowClosed(int windowId)
     }
     _windowToTabIndex.remove(windowId);
     _windowPanes.remove(windowId);
+    _appliedLayoutStrings.remove(windowId);
 }
 
 void TmuxController::onWindowRenamed(int windowId, const QString &name)
@@ -88,6 +88,7 @@ private:
     void setWindowTabTitle(int windowId, const QString &name);
     void refreshPaneTitles();
     void handleListWindowsResponse(bool success, const QString &response);
+    void handleActivePaneResponse(bool success, const QString &response);
 
     TmuxGateway *_gateway;
     Session *_gatewaySession;
@@ -101,6 +102,7 @@ private:
     QMap<int, int> _windowToTabIndex;
     QMap<int, QList<int>> _windowPanes;
     QSet<int> _zoomedWindows;
+    QMap<int, QString> _appliedLayoutStrings;
 
     QTimer *_paneTitleTimer;
 
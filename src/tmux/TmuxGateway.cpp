@@ -8,10 +8,14 @@
 
 #include "TmuxCommand.h"
 #include "Emulation.h"
+#include "PipelineMetrics.h"
 #include "session/Session.h"
 
 #include <QLoggingCategory>
 
+#include <array>
+#include <cstring>
+
 Q_LOGGING_CATEGORY(KonsoleTmuxGateway, "konsole.tmux.gateway", QtWarningMsg)
 
 namespace Konsole
@@ -21,10 +25,15 @@ TmuxGateway::TmuxGateway(Session *gatewaySession, QObject *parent)
     : QObject(parent)
     , _gatewaySession(gatewaySession)
 {
+    _metricsClock.start();
 }
 
 void TmuxGateway::processLine(const QByteArray &line)
 {
+    if (PipelineMetrics::enabled()) {
+        PipelineMetrics::instance()->recordGatewayBytesIn(line.size() + 1); // +1 for the line terminator
+    }
+
     if (_inResponseBlock) {
         // Match %end/%error by command ID: "%end <id> <number>" or "%error <id> <number>"
         if (line.startsWith("%end ") || line.startsWith("%error ")) {
@@ -269,6 +278,12 @@ void TmuxGateway::handleNotification(const QByteArray &line)
 void TmuxGateway::finishCurrentCommand(bool success)
 {
     _inResponseBlock = false;
+    if (PipelineMetrics::enabled()) {
+        if (_currentCommand.sentNsecs >= 0) {
+            PipelineMetrics::instance()->record(PipelineMetrics::GatewayRoundTripStage, _metricsClock.nsecsElapsed() - _currentCommand.sentNsecs);
+        }
+        PipelineMetrics::instance()->recordGatewayQueueDepth(_pendingCommands.size());
+    }
     qCDebug(KonsoleTmuxGateway) << "finishCommand:" << (success ? "OK" : "FAIL") << "cmd=" << _currentCommand.command
                                 << "response=" << _currentCommand.response.left(200);
     if (_currentCommand.callback) {
@@ -294,9 +309,15 @@ void TmuxGateway::sendCommand(const TmuxCommand &command, CommandCallback callba
     PendingCommand cmd;
     cmd.command = commandStr;
     cmd.callback = std::move(callback);
-    _pendingCommands.enqueue(cmd);
 
     QByteArray data = commandStr.toUtf8() + '\n';
+    if (PipelineMetrics::enabled()) {
+        cmd.sentNsecs = _metricsClock.nsecsElapsed();
+        PipelineMetrics::instance()->recordGatewayBytesOut(data.size());
+        PipelineMetrics::instance()->recordGatewayQueueDepth(_pendingCommands.size() + 1);
+    }
+    _pendingCommands.enqueue(cmd);
+
     writeToGateway(data);
 }
 
@@ -391,11 +412,38 @@ void TmuxGateway::detach()
 
 QByteArray TmuxGateway::decodeOctalEscapes(const QByteArray &encoded)
 {
+    // bytes copied through unchanged: everything except backslashes
+    // (escape introducer) and control characters other than tab.  The
+    // table lets the run loop below skip plain text without branching
+    // per byte; with tmux octal-escaping everything non-printable, runs
+    // cover almost the entire notification.
+    static const auto plainByte = []() {
+        std::array<bool, 256> table{};
+        for (int b = 0; b < 256; b++) {
+            table[b] = (b >= ' ' || b == '\t') && b != '\\';
+        }
+        return table;
+    }();
+
     QByteArray result;
     result.reserve(encoded.size());
 
+    const char *data = encoded.constData();
+    const int size = encoded.size();
     int i = 0;
-    while (i < encoded.size()) {
+    while (i < size) {
+        // bulk-copy the span up to the next escape or control character
+        int runStart = i;
+        while (i < size && plainByte[static_cast<unsigned char>(data[i])]) {
+            i++;
+        }
+        if (i > runStart) {
+            result.append(data + runStart, i - runStart);
+        }
+        if (i >= size) {
+            break;
+        }
+
         char c = encoded[i];
         if (c == '\\' && i + 3 < encoded.size()) {
             // Try to read 3 octal digits
@@ -442,8 +490,21 @@ QByteArray TmuxGateway::decodeVisEncoded(const QByteArray &encoded)
     QByteArray result;
     result.reserve(encoded.size());
 
+    const char *data = encoded.constData();
+    const int size = encoded.size();
     int i = 0;
-    while (i < encoded.size()) {
+    while (i < size) {
+        // bulk-copy everything up to the next backslash
+        const char *backslash = static_cast<const char *>(std::memchr(data + i, '\\', size - i));
+        const int escapePos = backslash != nullptr ? static_cast<int>(backslash - data) : size;
+        if (escapePos > i) {
+            result.append(data + i, escapePos - i);
+            i = escapePos;
+        }
+        if (i >= size) {
+            break;
+        }
+
         char c = encoded[i];
         if (c == '\\' && i + 1 < encoded.size()) {
             char next = encoded[i + 1];
@@ -8,6 +8,7 @@
 #define TMUXGATEWAY_H
 
 #include <QByteArray>
+#include <QElapsedTimer>
 #include <QObject>
 #include <QQueue>
 
@@ -75,11 +76,13 @@ private:
         CommandCallback callback;
         QString response;
         int commandId = -1;
+        qint64 sentNsecs = -1; // for GatewayRoundTrip metrics; -1 = unstamped
     };
     QQueue<PendingCommand> _pendingCommands;
     bool _inResponseBlock = false;
     bool _serverOriginated = false;
     PendingCommand _currentCommand;
+    QElapsedTimer _metricsClock;
 };
 
 } // namespace Konsole
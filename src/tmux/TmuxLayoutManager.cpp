@@ -286,7 +286,10 @@ int TmuxLayoutManager::applyLayout(int tabIndex, const TmuxLayoutNode &layout)
                     display->setParent(nullptr);
                 }
 
-                // Build a new splitter with the updated layout
+                // Build a new splitter with the updated layout; any panes
+                // without an existing display get their views constructed
+                // in one transaction with a single relayout at the end
+                _viewManager->beginBulkViewCreation();
                 auto *newSplitter = new ViewSplitter();
                 newSplitter->setTmuxMode(true);
                 buildSplitterTree(newSplitter, layout, existingDisplays);
@@ -301,6 +304,7 @@ int TmuxLayoutManager::applyLayout(int tabIndex, const TmuxLayoutNode &layout)
                 tabIndex = container->indexOfSplitter(newSplitter);
                 container->setTabText(tabIndex, tabText);
                 container->setTabIcon(tabIndex, tabIcon);
+                _viewManager->endBulkViewCreation();
 
                 // The old splitter (and any remaining children like nested splitters)
                 // will be deleted. Displays were already detached above.
@@ -327,6 +331,7 @@ int TmuxLayoutManager::applyLayout(int tabIndex, const TmuxLayoutNode &layout)
         return tabIndex;
     }
 
+    _viewManager->beginBulkViewCreation();
     auto *splitter = new ViewSplitter();
     splitter->setTmuxMode(true);
     QMap<int, TerminalDisplay *> noExisting;
@@ -341,6 +346,7 @@ int TmuxLayoutManager::applyLayout(int tabIndex, const TmuxLayoutNode &layout)
     }
 
     container->addSplitter(splitter);
+    _viewManager->endBulkViewCreation();
     return container->indexOfSplitter(splitter);
 }
 
@@ -407,7 +413,13 @@ bool TmuxLayoutManager::updateSplitterSizes(ViewSplitter *splitter, const TmuxLa
                 sizes.append(widget->sizeHint().height());
             }
         }
-        splitter->setSizes(sizes);
+        // QSplitter::setSizes() relayouts unconditionally; during a drag
+        // only one splitter level actually changes, so leave the others
+        // alone. The leaf setSize()/setForcedSize() calls above already
+        // no-op when the pane's grid size is unchanged.
+        if (sizes != splitter->sizes()) {
+            splitter->setSizes(sizes);
+        }
     }
 
     return true;
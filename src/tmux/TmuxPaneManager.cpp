@@ -14,14 +14,32 @@
 #include "profile/ProfileManager.h"
 #include "session/SessionManager.h"
 #include "session/VirtualSession.h"
+#include "terminalDisplay/TerminalDisplay.h"
 
 namespace Konsole
 {
+// Dormant panes (no visible display) buffer this much raw output before
+// being force-fed to their emulation, so a flooding hidden pane cannot
+// grow the buffer without bound and the backlog still ends up in history.
+static const int DormantSpillBytes = 256 * 1024;
+
+// How often one dormant pane is caught up in the background.
+static const int DormantDrainIntervalMsecs = 250;
 
 TmuxPaneManager::TmuxPaneManager(TmuxGateway *gateway, QObject *parent)
     : QObject(parent)
     , _gateway(gateway)
 {
+    // One flush per event-loop pass: a gateway read full of %output
+    // notifications lands as a single batched injection per pane, and
+    // the emulation's own bufferedUpdate() debouncing takes it from there.
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(0);
+    connect(&_flushTimer, &QTimer::timeout, this, &TmuxPaneManager::flushPendingOutput);
+
+    // Catch-up clock for dormant panes; runs only while a backlog exists
+    _dormantDrainTimer.setInterval(DormantDrainIntervalMsecs);
+    connect(&_dormantDrainTimer, &QTimer::timeout, this, &TmuxPaneManager::drainDormantPane);
 }
 
 Session *TmuxPaneManager::createPaneSession(int paneId)
@@ -57,6 +75,8 @@ void TmuxPaneManager::destroyPaneSession(int paneId)
     if (it != _paneToSession.end()) {
         Session *session = it.value();
         _paneToSession.erase(it);
+        _pendingOutput.remove(paneId);
+        _dormantBuffers.remove(paneId);
         session->close();
     }
 }
@@ -80,15 +100,99 @@ void TmuxPaneManager::deliverOutput(int paneId, const QByteArray &data)
         return;
     }
 
-    auto *session = qobject_cast<VirtualSession *>(_paneToSession.value(paneId, nullptr));
-    if (session) {
-        session->injectData(data.constData(), data.size());
+    // A busy pane arrives as a flood of small %output notifications, and
+    // each injectData() call is a full walk of the emulation's receive
+    // path. Coalesce per pane and flush once per event-loop pass instead,
+    // so every pane sees at most one batched injection per pass. The
+    // decoded buffers are kept as a list — appending shares the bytes,
+    // and the scatter-gather injectData() decodes them in one pass.
+    _pendingOutput[paneId].append(data);
+    if (!_flushTimer.isActive()) {
+        _flushTimer.start();
     }
 }
 
+void TmuxPaneManager::flushPendingOutput()
+{
+    QMap<int, QList<QByteArray>> pending;
+    pending.swap(_pendingOutput);
+
+    for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+        const int paneId = it.key();
+        auto *session = qobject_cast<VirtualSession *>(_paneToSession.value(paneId, nullptr));
+        if (!session) {
+            continue;
+        }
+
+        // Panes in hidden tmux windows don't need their emulation run for
+        // every flush — nobody is looking. Park the bytes and let the
+        // background drain (or the pane becoming visible) catch them up in
+        // one batch. A flooding hidden pane is force-fed at the spill
+        // bound so the backlog stays bounded and lands in history.
+        if (!hasVisibleView(session)) {
+            QByteArray &dormant = _dormantBuffers[paneId];
+            for (const QByteArray &chunk : it.value()) {
+                dormant.append(chunk);
+            }
+            if (dormant.size() >= DormantSpillBytes) {
+                const QByteArray spill = dormant;
+                _dormantBuffers.remove(paneId);
+                session->injectData(spill.constData(), spill.size());
+            } else if (!_dormantDrainTimer.isActive()) {
+                _dormantDrainTimer.start();
+            }
+            continue;
+        }
+
+        // A pane that just became visible may still have parked output;
+        // deliver it first to keep the byte order intact
+        auto dormantIt = _dormantBuffers.find(paneId);
+        if (dormantIt != _dormantBuffers.end()) {
+            const QByteArray dormant = dormantIt.value();
+            _dormantBuffers.erase(dormantIt);
+            session->injectData(dormant.constData(), dormant.size());
+        }
+
+        session->injectData(it.value());
+    }
+}
+
+void TmuxPaneManager::drainDormantPane()
+{
+    // One pane per tick keeps the catch-up work off the interactive path
+    if (!_dormantBuffers.isEmpty()) {
+        auto it = _dormantBuffers.begin();
+        const int paneId = it.key();
+        const QByteArray backlog = it.value();
+        _dormantBuffers.erase(it);
+
+        auto *session = qobject_cast<VirtualSession *>(_paneToSession.value(paneId, nullptr));
+        if (session) {
+            session->injectData(backlog.constData(), backlog.size());
+        }
+    }
+
+    if (_dormantBuffers.isEmpty()) {
+        _dormantDrainTimer.stop();
+    }
+}
+
+bool TmuxPaneManager::hasVisibleView(Session *session)
+{
+    const QList<TerminalDisplay *> views = session->views();
+    for (TerminalDisplay *view : views) {
+        if (view->isVisible()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void TmuxPaneManager::suppressOutput(int paneId)
 {
     _suppressedPanes.insert(paneId);
+    _pendingOutput.remove(paneId);
+    _dormantBuffers.remove(paneId);
 }
 
 void TmuxPaneManager::suppressAllOutput()
@@ -105,6 +209,21 @@ void TmuxPaneManager::unsuppressOutput(int paneId)
 
 void TmuxPaneManager::pausePane(int paneId)
 {
+    // Deliver anything parked or coalesced for this pane first so the
+    // pause buffer starts strictly after it
+    QList<QByteArray> backlog;
+    const QByteArray dormant = _dormantBuffers.take(paneId);
+    if (!dormant.isEmpty()) {
+        backlog.append(dormant);
+    }
+    backlog.append(_pendingOutput.take(paneId));
+    if (!backlog.isEmpty()) {
+        auto *session = qobject_cast<VirtualSession *>(_paneToSession.value(paneId, nullptr));
+        if (session) {
+            session->injectData(backlog);
+        }
+    }
+
     _pausedPanes.insert(paneId);
     _gateway->sendCommand(TmuxCommand(QStringLiteral("refresh-client"))
                               .flag(QStringLiteral("-A"))
@@ -118,9 +237,11 @@ void TmuxPaneManager::continuePane(int paneId)
     if (_pauseBuffers.contains(paneId)) {
         QByteArray buffered = _pauseBuffers.take(paneId);
         if (!buffered.isEmpty()) {
-            auto *session = qobject_cast<VirtualSession *>(_paneToSession.value(paneId, nullptr));
-            if (session) {
-                session->injectData(buffered.constData(), buffered.size());
+            // Route through the coalescing queue so later output appended
+            // before the flush stays in order
+            _pendingOutput[paneId].append(buffered);
+            if (!_flushTimer.isActive()) {
+                _flushTimer.start();
             }
         }
     }
@@ -10,6 +10,7 @@
 #include <QMap>
 #include <QObject>
 #include <QSet>
+#include <QTimer>
 
 namespace Konsole
 {
@@ -48,11 +49,19 @@ Q_SIGNALS:
     void paneViewSizeChanged();
 
 private:
+    void flushPendingOutput();
+    void drainDormantPane();
+    static bool hasVisibleView(Session *session);
+
     TmuxGateway *_gateway;
     QMap<int, Session *> _paneToSession;
     QSet<int> _pausedPanes;
     QSet<int> _suppressedPanes;
     QMap<int, QByteArray> _pauseBuffers;
+    QMap<int, QList<QByteArray>> _pendingOutput;
+    QMap<int, QByteArray> _dormantBuffers;
+    QTimer _flushTimer{this};
+    QTimer _dormantDrainTimer{this};
 };
 
 } // namespace Konsole
@@ -20,12 +20,17 @@
 #include "widgets/ViewSplitter.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QLoggingCategory>
 
 Q_LOGGING_CATEGORY(KonsoleTmuxResize, "konsole.tmux.resize", QtWarningMsg)
 
 namespace Konsole
 {
+// Bounds for the trailing-edge settling window. Until a round trip has
+// been measured the lower bound applies, which matches a local server.
+static const int MinSettleMsecs = 100;
+static const int MaxSettleMsecs = 1000;
 
 static void setSubtreeHeight(TmuxLayoutNode &node, int height)
 {
@@ -110,7 +115,7 @@ TmuxResizeCoordinator::TmuxResizeCoordinator(TmuxGateway *gateway, TmuxControlle
     , _viewManager(viewManager)
 {
     _resizeTimer.setSingleShot(true);
-    _resizeTimer.setInterval(100);
+    _resizeTimer.setInterval(MinSettleMsecs);
     connect(&_resizeTimer, &QTimer::timeout, this, &TmuxResizeCoordinator::sendClientSize);
 
     connect(qApp, &QApplication::focusChanged, this, [this]() {
@@ -345,16 +350,40 @@ void TmuxResizeCoordinator::sendClientSize()
                                        << "size changed from" << lastSize << "to" << QSize(totalCols, totalLines)
                                        << "→ sending refresh-client -C";
             lastSize = QSize(totalCols, totalLines);
+            QElapsedTimer roundTrip;
+            roundTrip.start();
             _gateway->sendCommand(TmuxCommand(QStringLiteral("refresh-client"))
                                       .flag(QStringLiteral("-C"))
                                       .arg(QLatin1Char('@') + QString::number(windowId) + QLatin1Char(':') + QString::number(totalCols) + QLatin1Char('x')
-                                           + QString::number(totalLines)));
+                                           + QString::number(totalLines)),
+                                  [this, roundTrip](bool success, const QString &) {
+                                      if (success) {
+                                          recordGatewayRtt(roundTrip.elapsed());
+                                      }
+                                  });
         } else {
             qCDebug(KonsoleTmuxResize) << "sendClientSize: windowId=" << windowId << "size unchanged at" << lastSize << "→ skipping";
         }
     }
 }
 
+void TmuxResizeCoordinator::recordGatewayRtt(qint64 elapsedMsecs)
+{
+    // Smooth with an exponential moving average so one slow reply does
+    // not blow the window up, then let the settling window track it.
+    // Resizing faster than the server can answer just trades partial
+    // resizes for redraw cascades, so the window is kept at roughly two
+    // round trips: the echo-back %layout-change from the previous resize
+    // has arrived before the next one goes out.
+    _gatewayRttMsecs = _gatewayRttMsecs == 0 ? elapsedMsecs : (3 * _gatewayRttMsecs + elapsedMsecs) / 4;
+
+    const int settle = qBound(MinSettleMsecs, int(2 * _gatewayRttMsecs), MaxSettleMsecs);
+    if (settle != _resizeTimer.interval()) {
+        qCDebug(KonsoleTmuxResize) << "recordGatewayRtt: rtt=" << elapsedMsecs << "smoothed=" << _gatewayRttMsecs << "→ settle window" << settle;
+        _resizeTimer.setInterval(settle);
+    }
+}
+
 void TmuxResizeCoordinator::setWindowSize(int windowId, int cols, int lines)
 {
     QSize newSize(cols, lines);
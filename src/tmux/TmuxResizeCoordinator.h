@@ -35,6 +35,8 @@ public:
     void setWindowSize(int windowId, int cols, int lines);
 
 private:
+    void recordGatewayRtt(qint64 elapsedMsecs);
+
     TmuxGateway *_gateway;
     TmuxController *_controller;
     TmuxPaneManager *_paneManager;
@@ -44,6 +46,7 @@ private:
     QTimer _resizeTimer;
     QMap<int, QSize> _lastClientSizes;
     QMap<int, QSize> _tmuxWindowSizes;
+    qint64 _gatewayRttMsecs = 0; // smoothed round-trip time, 0 = unmeasured
 };
 
 } // namespace Konsole
@@ -1306,6 +1306,12 @@ QSize EditProfileDialog::sizeHint() const
 
 void EditProfileDialog::unpreviewAll()
 {
+    // drop previews that never reached the profile
+    _pendingPreviewChanges.clear();
+    if (_previewFlushTimer != nullptr) {
+        _previewFlushTimer->stop();
+    }
+
     // undo any preview changes
     if (!_previewedProperties.empty()) {
         ProfileManager::instance()->changeProfile(_profile, _previewedProperties, false);
@@ -1314,6 +1320,8 @@ void EditProfileDialog::unpreviewAll()
 
 void EditProfileDialog::unpreview(Profile::Property prop)
 {
+    _pendingPreviewChanges.erase(prop);
+
     auto node = _previewedProperties.extract(prop);
     if (!node) {
         return;
@@ -1337,10 +1345,51 @@ void EditProfileDialog::preview(Profile::Property prop, const QVariant &value)
         return;
     }
 
+    // a widget re-reporting the already applied (or already queued) value
+    // must not fire another profile-apply cascade
+    const auto pending = _pendingPreviewChanges.find(prop);
+    if (pending != _pendingPreviewChanges.end()) {
+        if (pending->second == value) {
+            return;
+        }
+    } else if (original->property<QVariant>(prop) == value) {
+        return;
+    }
+
     _previewedProperties.insert({prop, original->property<QVariant>(prop)});
 
-    // temporary change to color scheme
-    ProfileManager::instance()->changeProfile(_profile, {{prop, value}}, false);
+    // queue the temporary change; within a frame the latest value per
+    // property wins, so dragging a slider costs one apply per frame
+    // instead of one per widget signal
+    _pendingPreviewChanges[prop] = value;
+
+    if (_previewFlushTimer == nullptr) {
+        // one preview apply per frame at most
+        static const int PREVIEW_APPLY_INTERVAL = 33; // ms
+        _previewFlushTimer = new QTimer(this);
+        _previewFlushTimer->setSingleShot(true);
+        _previewFlushTimer->setInterval(PREVIEW_APPLY_INTERVAL);
+        connect(_previewFlushTimer, &QTimer::timeout, this, &Konsole::EditProfileDialog::flushPreview);
+    }
+
+    if (!_previewFlushTimer->isActive()) {
+        // leading edge: the first change of a gesture applies immediately
+        flushPreview();
+    }
+}
+
+void EditProfileDialog::flushPreview()
+{
+    if (_pendingPreviewChanges.empty()) {
+        return;
+    }
+
+    Profile::PropertyMap changes;
+    changes.swap(_pendingPreviewChanges);
+    ProfileManager::instance()->changeProfile(_profile, changes, false);
+
+    // pace a continuing gesture to one apply per interval
+    _previewFlushTimer->start();
 }
 
 void EditProfileDialog::previewColorScheme(const QModelIndex &index)
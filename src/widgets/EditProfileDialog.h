@@ -31,6 +31,7 @@ class KPluralHandlingSpinBox;
 class KLocalizedString;
 class QItemSelectionModel;
 class QTextCodec;
+class QTimer;
 
 namespace Ui
 {
@@ -304,6 +305,11 @@ private:
     void preview(Profile::Property prop, const QVariant &value);
     void unpreview(Profile::Property prop);
     void unpreviewAll();
+
+    // Applies the preview changes queued by preview() to the profile in
+    // one pass; driven by _previewFlushTimer so a slider firing dozens
+    // of values per second causes one profile-apply cascade per frame.
+    void flushPreview();
     void enableIfNonEmptySelection(QWidget *widget, QItemSelectionModel *selectionModel);
 
     void updateCaption(const Profile::Ptr &profile);
@@ -375,6 +381,11 @@ private:
 
     Profile::PropertyMap _previewedProperties;
 
+    // preview changes waiting for the next flushPreview(); latest value
+    // per property wins
+    Profile::PropertyMap _pendingPreviewChanges;
+    QTimer *_previewFlushTimer = nullptr;
+
     ColorSchemeEditor *_colorDialog = nullptr;
     QDialogButtonBox *_buttonBox = nullptr;
     FontDialog *_fontDialog = nullptr;
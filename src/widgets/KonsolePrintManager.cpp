@@ -14,12 +14,15 @@
 
 // Qt
 #include <QFont>
+#include <QFontMetrics>
 #include <QPainter>
 #include <QPoint>
 #include <QPointer>
 #include <QPrintDialog>
 #include <QPrinter>
+#include <QProgressDialog>
 #include <QRect>
+#include <QStringList>
 #include <QWidget>
 
 // KDE
@@ -35,7 +38,7 @@ KonsolePrintManager::KonsolePrintManager(pDrawBackground drawBackground, pDrawCo
     _backgroundColor = colorGet;
 }
 
-void KonsolePrintManager::printRequest(pPrintContent pContent, QWidget *parent)
+void KonsolePrintManager::printRequest(pPrintContent pContent, QWidget *parent, pVTFontGet vtFontGet, pLineCountGet lineCount, pDecodeRange decodeRange)
 {
     if (!pContent) {
         return;
@@ -54,11 +57,16 @@ void KonsolePrintManager::printRequest(pPrintContent pContent, QWidget *parent)
         return;
     }
 
+    KConfigGroup configGroup(KSharedConfig::openConfig(), QStringLiteral("PrintOptions"));
+
+    if (configGroup.readEntry("PrintScrollback", false) && vtFontGet && lineCount && decodeRange) {
+        printScrollback(printer, parent, vtFontGet, lineCount, decodeRange);
+        return;
+    }
+
     QPainter painter;
     painter.begin(&printer);
 
-    KConfigGroup configGroup(KSharedConfig::openConfig(), QStringLiteral("PrintOptions"));
-
     if (configGroup.readEntry("ScaleOutput", true)) {
         QRect page_rect = printer.pageLayout().paintRectPixels(printer.resolution());
         double scale = qMin(page_rect.width() / static_cast<double>(parent->width()), page_rect.height() / static_cast<double>(parent->height()));
@@ -68,6 +76,55 @@ void KonsolePrintManager::printRequest(pPrintContent pContent, QWidget *parent)
     pContent(painter, configGroup.readEntry("PrinterFriendly", true));
 }
 
+// Prints the entire history as paginated plain text.  QPrinter only accepts
+// pages serially from the one active painter, so instead of decoding and
+// rendering everything up front, each page's slice of the history is decoded
+// on demand - memory stays bounded by a page - and the modal progress dialog
+// pumps the event loop between pages, keeping the application responsive
+// and the job cancellable.
+bool KonsolePrintManager::printScrollback(QPrinter &printer, QWidget *parent, const pVTFontGet &vtFontGet, const pLineCountGet &lineCount, const pDecodeRange &decodeRange)
+{
+    QPainter painter;
+    painter.begin(&printer);
+
+    // Reinitialize the font with the printers paint device so the font
+    // measurement calculations will be done correctly
+    QFont font(vtFontGet(), painter.device());
+    painter.setFont(font);
+
+    const QFontMetrics metrics(font, painter.device());
+    const int lineHeight = metrics.lineSpacing();
+    const QRect pageRect = printer.pageLayout().paintRectPixels(printer.resolution());
+    const int linesPerPage = qMax(1, pageRect.height() / qMax(1, lineHeight));
+    const int totalLines = lineCount();
+
+    QProgressDialog progress(i18n("Printing scrollback..."), i18n("Cancel"), 0, totalLines, parent);
+    progress.setWindowModality(Qt::WindowModal);
+
+    for (int firstLine = 0; firstLine < totalLines; firstLine += linesPerPage) {
+        progress.setValue(firstLine);
+        if (progress.wasCanceled()) {
+            printer.abort();
+            return false;
+        }
+
+        if (firstLine > 0) {
+            printer.newPage();
+        }
+
+        const int lastLine = qMin(firstLine + linesPerPage - 1, totalLines - 1);
+        const QStringList lines = decodeRange(firstLine, lastLine).split(QLatin1Char('\n'));
+        int y = metrics.ascent();
+        for (const QString &line : lines) {
+            painter.drawText(0, y, line);
+            y += lineHeight;
+        }
+    }
+
+    progress.setValue(totalLines);
+    return true;
+}
+
 void KonsolePrintManager::printContent(QPainter &painter, bool friendly, QPoint columnsLines, pVTFontGet vtFontGet, pVTFontSet vtFontSet)
 {
     // Reinitialize the font with the printers paint device so the font
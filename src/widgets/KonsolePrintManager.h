@@ -15,6 +15,8 @@ class QFont;
 class QRect;
 class QColor;
 class QPoint;
+class QPrinter;
+class QString;
 class QWidget;
 class QPainter;
 
@@ -29,14 +31,18 @@ public:
     typedef std::function<void(QPainter &painter, const QRect &rect, const QColor &backgroundColor, bool useOpacitySetting)> pDrawBackground;
     typedef std::function<void(QPainter &paint, const QRect &rect, bool friendly)> pDrawContents;
     typedef std::function<QColor()> pColorGet;
+    typedef std::function<int()> pLineCountGet;
+    typedef std::function<QString(int firstLine, int lastLine)> pDecodeRange;
 
     KonsolePrintManager(pDrawBackground drawBackground, pDrawContents drawContents, pColorGet colorGet);
     ~KonsolePrintManager() = default;
 
-    void printRequest(pPrintContent pContent, QWidget *parent);
+    void printRequest(pPrintContent pContent, QWidget *parent, pVTFontGet vtFontGet, pLineCountGet lineCount, pDecodeRange decodeRange);
     void printContent(QPainter &painter, bool friendly, QPoint columnsLines, pVTFontGet vtFontGet, pVTFontSet vtFontSet);
 
 private:
+    bool printScrollback(QPrinter &printer, QWidget *parent, const pVTFontGet &vtFontGet, const pLineCountGet &lineCount, const pDecodeRange &decodeRange);
+
     pDrawBackground _drawBackground;
     pDrawContents _drawContents;
     pColorGet _backgroundColor;
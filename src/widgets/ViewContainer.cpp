@@ -12,6 +12,7 @@
 #include <QBoxLayout>
 #include <QFile>
 #include <QKeyEvent>
+#include <QLabel>
 #include <QMenu>
 #include <QTabBar>
 
@@ -44,6 +45,9 @@
 
 using namespace Konsole;
 
+// width of the cached hover previews, in device-independent pixels
+static const int TabPreviewWidth = 250;
+
 TabbedViewContainer::TabbedViewContainer(ViewManager *connectedViewManager, QWidget *parent)
     : QTabWidget(parent)
     , _connectedViewManager(connectedViewManager)
@@ -109,6 +113,9 @@ TabbedViewContainer::TabbedViewContainer(ViewManager *connectedViewManager, QWid
 
     connect(tabBar(), &QTabBar::tabCloseRequested, this, &TabbedViewContainer::closeTerminalTab);
 
+    // for the hover previews served from the snapshot cache
+    tabBar()->installEventFilter(this);
+
     auto detachAction = _contextPopupMenu->addAction(QIcon::fromTheme(QStringLiteral("tab-detach")), i18nc("@action:inmenu", "&Detach Tab"), this, [this] {
         Q_EMIT detachTab(_contextMenuTabIndex);
     });
@@ -473,6 +480,7 @@ void TabbedViewContainer::viewDestroyed(QObject *view)
 
     // Remove icon state keyed by this widget (cleanup any matching entry)
     _tabIconState.remove(w);
+    _tabPreviews.remove(w);
 
     removeTab(idx);
     forgetView();
@@ -587,6 +595,13 @@ void TabbedViewContainer::openTabContextMenu(const QPoint &point)
 void TabbedViewContainer::currentTabChanged(int index)
 {
     if (index != -1) {
+        // snapshot the tab we are leaving - one capture per deactivation -
+        // so hovering it later is served entirely from the cache
+        if (_previousTabIndex != -1 && _previousTabIndex != index) {
+            captureTabPreview(_previousTabIndex);
+        }
+        _previousTabIndex = index;
+
         auto splitview = viewSplitterAt(index);
         if (!splitview) {
             return;
@@ -603,6 +618,72 @@ void TabbedViewContainer::currentTabChanged(int index)
     }
 }
 
+void TabbedViewContainer::captureTabPreview(int index)
+{
+    QWidget *page = widget(index);
+    if (page == nullptr || page->size().isEmpty()) {
+        return;
+    }
+
+    // same mechanism as TerminalDisplay::takePrimaryScreenSnapshot(): one
+    // off-screen render of the page, immediately downscaled
+    const QPixmap snapshot = page->grab();
+    if (snapshot.isNull()) {
+        return;
+    }
+
+    const qreal ratio = page->devicePixelRatioF();
+    QPixmap preview = snapshot.scaledToWidth(qRound(TabPreviewWidth * ratio), Qt::SmoothTransformation);
+    preview.setDevicePixelRatio(ratio);
+    _tabPreviews[page] = preview;
+}
+
+void TabbedViewContainer::showTabPreview(int index)
+{
+    const QPixmap preview = _tabPreviews.value(widget(index));
+    if (preview.isNull()) {
+        hideTabPreview();
+        return;
+    }
+
+    if (_tabPreviewPopup == nullptr) {
+        _tabPreviewPopup = new QLabel(this, Qt::ToolTip | Qt::BypassGraphicsProxyWidget);
+        _tabPreviewPopup->setFrameStyle(QFrame::Box | QFrame::Plain);
+    }
+    _tabPreviewPopup->setPixmap(preview);
+    _tabPreviewPopup->adjustSize();
+    _tabPreviewPopup->move(tabBar()->mapToGlobal(tabBar()->tabRect(index).bottomLeft()) + QPoint(0, 2));
+    _tabPreviewPopup->show();
+}
+
+void TabbedViewContainer::hideTabPreview()
+{
+    if (_tabPreviewPopup != nullptr) {
+        _tabPreviewPopup->hide();
+    }
+}
+
+bool TabbedViewContainer::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == tabBar()) {
+        if (event->type() == QEvent::ToolTip) {
+            const auto *helpEvent = static_cast<QHelpEvent *>(event);
+            const int index = tabBar()->tabAt(helpEvent->pos());
+            // the current tab is already visible; everything else is shown
+            // from the snapshot cache, never by re-rendering the hidden
+            // session - tabs that were never activated have no preview
+            if (index != -1 && index != currentIndex() && _tabPreviews.contains(widget(index))) {
+                showTabPreview(index);
+                return true;
+            }
+            hideTabPreview();
+        } else if (event->type() == QEvent::Leave || event->type() == QEvent::Hide || event->type() == QEvent::MouseButtonPress) {
+            hideTabPreview();
+        }
+    }
+    return QTabWidget::eventFilter(watched, event);
+}
+
 void TabbedViewContainer::wheelScrolled(int delta)
 {
     if (delta < 0) {
@@ -650,7 +731,19 @@ void TabbedViewContainer::updateTitle(ViewProperties *item)
     const int index = indexOfSplitter(topLevelSplitter);
     QString tabText = item->title();
 
-    setTabToolTip(index, tabText);
+    // shells with OSC 133 integration retitle the tab at every prompt, so
+    // the tooltip tracks the command statistics without a separate hook
+    QString toolTip = tabText;
+    Session *session = controller->session();
+    if (session != nullptr && session->lastCommandDuration() >= 0) {
+        toolTip += QLatin1Char('\n')
+            + i18nc("@info:tooltip statistics of the last shell command",
+                    "Last command: %1 ms, %2 bytes of output, exit code %3",
+                    session->lastCommandDuration(),
+                    session->lastCommandOutputBytes(),
+                    session->lastCommandExitCode());
+    }
+    setTabToolTip(index, toolTip);
 
     // To avoid having & replaced with _ (shortcut indicator)
     tabText.replace(QLatin1Char('&'), QLatin1String("&&"));
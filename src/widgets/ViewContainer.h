@@ -9,6 +9,7 @@
 
 // Qt
 #include <QObject>
+#include <QPixmap>
 #include <QTabWidget>
 
 // Konsole
@@ -17,6 +18,7 @@
 #include "session/Session.h"
 
 // Qt
+class QLabel;
 class QPoint;
 class QToolButton;
 class QMenu;
@@ -235,6 +237,9 @@ protected:
     void closeTerminalTab(int idx);
 
     void keyReleaseEvent(QKeyEvent *event) override;
+
+    // shows cached tab previews when hovering the tab bar
+    bool eventFilter(QObject *watched, QEvent *event) override;
 private Q_SLOTS:
     void viewDestroyed(QObject *view);
     void konsoleConfigChanged();
@@ -244,6 +249,13 @@ private:
     void closeTmuxTab(const QList<TerminalDisplay *> &terminals);
     void forgetView();
 
+    /** Caches a downscaled snapshot of the tab page at @p index.  Called
+     * when a tab deactivates, so hovering it later can show a preview
+     * without re-rendering the hidden session. */
+    void captureTabPreview(int index);
+    void showTabPreview(int index);
+    void hideTabPreview();
+
     struct TabIconState {
         TabIconState()
             : readOnly(false)
@@ -265,6 +277,11 @@ private:
     bool _stylesheetSet = false;
 
     QHash<const QWidget *, TabIconState> _tabIconState;
+    // downscaled snapshots of deactivated tab pages, keyed like
+    // _tabIconState, served as hover previews from the cache
+    QHash<const QWidget *, QPixmap> _tabPreviews;
+    QLabel *_tabPreviewPopup = nullptr;
+    int _previousTabIndex = -1;
     ViewManager *_connectedViewManager;
     QMenu *_contextPopupMenu;
     QToolButton *_newTabButton;
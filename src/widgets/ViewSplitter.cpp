@@ -57,6 +57,10 @@ ViewSplitter::ViewSplitter(QWidget *parent)
     , _id(++lastSplitterId)
 {
     setAcceptDrops(true);
+    // Show a rubber-band preview while a handle is dragged and commit the
+    // real relayout on release, so every affected TerminalDisplay (and its
+    // PTY) is resized once per drag instead of once per mouse event
+    setOpaqueResize(false);
     setHandleWidth(calculateHandleWidth(KonsoleSettings::self()->splitDragHandleSize()));
     connect(KonsoleSettings::self(), &KonsoleSettings::configChanged, this, [this] {
         if (!_tmuxMode) {
@@ -693,6 +697,7 @@ QPoint Konsole::ViewSplitter::mapFromTopLevel(const QPoint &p)
 Konsole::ViewSplitterHandle::ViewSplitterHandle(Qt::Orientation orientation, QSplitter *parent)
     : QSplitterHandle(orientation, parent)
     , mouseReleaseEventCounter(0)
+    , snappedPosition(-1)
 {
 }
 
@@ -769,6 +774,7 @@ void Konsole::ViewSplitterHandle::mousePressEvent(QMouseEvent *ev)
     std::sort(std::begin(allSplitterSizes), std::end(allSplitterSizes));
 
     mouseReleaseEventCounter = 0;
+    snappedPosition = -1;
 
     QSplitterHandle::mousePressEvent(ev);
 }
@@ -780,6 +786,12 @@ void Konsole::ViewSplitterHandle::mouseReleaseEvent(QMouseEvent *ev)
         mouseDoubleClickEvent(ev);
     }
     QSplitterHandle::mouseReleaseEvent(ev);
+    if (snappedPosition >= 0) {
+        // the drag ended on a snapped preview; commit that position instead
+        // of the raw mouse position the base class just used
+        moveSplitter(snappedPosition);
+        snappedPosition = -1;
+    }
     Q_EMIT dragFinished();
 }
 
@@ -795,10 +807,14 @@ void Konsole::ViewSplitterHandle::mouseMoveEvent(QMouseEvent *ev)
     if (threshould <= 20) {
         auto *thisSplitter = qobject_cast<ViewSplitter *>(splitter());
         QPoint localPoint = thisSplitter->mapFromTopLevel(orientation() == Qt::Horizontal ? QPoint(nearest, 0) : QPoint(0, nearest));
-        moveSplitter(orientation() == Qt::Horizontal ? localPoint.x() : localPoint.y());
+        // preview the snapped position with the rubber band; the actual
+        // relayout is committed once, on release
+        snappedPosition = orientation() == Qt::Horizontal ? localPoint.x() : localPoint.y();
+        thisSplitter->showRubberBand(snappedPosition);
         return;
     }
 
+    snappedPosition = -1;
     mouseReleaseEventCounter = 0;
 
     QSplitterHandle::mouseMoveEvent(ev);
@@ -44,6 +44,11 @@ private:
      * the second mouse press event is not fired, nor is the double click event.
      * We use this counter to detect a double click. */
     int mouseReleaseEventCounter;
+
+    /* Splitter-local position the drag preview snapped to, or -1 when the
+     * drag is not snapped to a handle in a neighbouring splitter.  The
+     * relayout is only committed on release. */
+    int snappedPosition;
 };
 
 /**
@@ -171,6 +176,16 @@ public:
     QPoint mapToTopLevel(const QPoint &p);
     QPoint mapFromTopLevel(const QPoint &p);
 
+    /**
+     * Shows the drag-preview rubber band at @p position (in splitter
+     * coordinates), as used by non-opaque resizing.  Lets the handle
+     * preview a snapped position without committing a relayout mid-drag.
+     */
+    void showRubberBand(int position)
+    {
+        setRubberBand(position);
+    }
+
     int id() const
     {
         return _id;
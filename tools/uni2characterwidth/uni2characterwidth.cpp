@@ -654,6 +654,9 @@ using GeneratorFunc = bool (*)(QTextStream &, const QVector<CharacterProperties>
 bool code(QTextStream &out, const QVector<CharacterProperties> &props, const QVector<CharacterWidth> &widths, const QMap<QString, QString> &args)
 {
     static constexpr int DIRECT_LUT_SIZE = 256;
+    static constexpr int PAGE_SHIFT = 7;
+    static constexpr int PAGE_SIZE = 1 << PAGE_SHIFT;
+    static constexpr int PAGES_NUM = CODE_POINTS_NUM / PAGE_SIZE;
 
     Q_UNUSED(props);
     QTextStream eout(stderr, QIODevice::WriteOnly);
@@ -676,9 +679,9 @@ bool code(QTextStream &out, const QVector<CharacterProperties> &props, const QVe
         {QStringLiteral("cmdline"), args.value(QStringLiteral("cmdline"))},
         {QStringLiteral("direct-lut"), Var::Vector(DIRECT_LUT_SIZE)},
         {QStringLiteral("direct-lut-size"), DIRECT_LUT_SIZE},
-        {QStringLiteral("ranges-luts"), Var::Vector()},
-        {QStringLiteral("ranges-lut-list"), Var::Vector()},
-        {QStringLiteral("ranges-lut-list-size"), 0},
+        {QStringLiteral("page-shift"), PAGE_SHIFT},
+        {QStringLiteral("page-index"), Var::Vector(PAGES_NUM)},
+        {QStringLiteral("page-data"), Var::Vector()},
     };
 
     // Fill direct-lut with widths of 0x00-0xFF
@@ -687,48 +690,32 @@ bool code(QTextStream &out, const QVector<CharacterProperties> &props, const QVe
         data[QStringLiteral("direct-lut")].vec[i] = int(widths[i]);
     }
 
-    static const QVector<CharacterWidth> widthsSortOrder = {CharacterWidth::NonPrintable, 2, CharacterWidth::Ambiguous, 0, 1};
-    const QMap<CharacterWidth, QVector<QPair<uint, uint>>> mergedRanges = mergedRangesFromWidths(widths, widthsSortOrder, {DIRECT_LUT_SIZE, CODE_POINTS_NUM});
-
-    // Find last non-empty ranges lut
-    int lastWidthId = 0;
-    for (int wi = widthsSortOrder.size() - 1; wi > 0; --wi) {
-        if (mergedRanges.contains(widthsSortOrder[wi])) {
-            lastWidthId = wi;
-            break;
+    // Deduplicate fixed-size pages of widths. The page index selects the
+    // shared page, giving the generated code an O(1) branch-free lookup
+    // instead of binary searches over ranges.
+    QMap<QByteArray, int> pageIds;
+    auto &pageIndex = data[QStringLiteral("page-index")].vec;
+    auto &pageData = data[QStringLiteral("page-data")].vec;
+    for (int page = 0; page < PAGES_NUM; ++page) {
+        QByteArray key(PAGE_SIZE, '\0');
+        for (int i = 0; i < PAGE_SIZE; ++i) {
+            key[i] = char(int8_t(widths[page * PAGE_SIZE + i]));
         }
-    }
-    // Create ranges-luts for all widths except last non-empty one and empty ones
-    for (int wi = 0; lastWidthId != 0 && wi < lastWidthId; ++wi) {
-        const CharacterWidth width = widthsSortOrder[wi];
-        auto currentMergedRangesIt = mergedRanges.find(width);
-        if (currentMergedRangesIt == mergedRanges.end() || currentMergedRangesIt.value().isEmpty())
-            continue;
-        const int size = mergedRanges[width].size();
-        const QString name = QString(QStringLiteral("LUT_%1")).arg(width.toString().toUpper());
-        data[QStringLiteral("ranges-luts")].vec.append(Var::Map{
-            {QStringLiteral("name"), name},
-            {QStringLiteral("ranges"), Var::Vector()},
-            {QStringLiteral("size"), size},
-        });
-        data[QStringLiteral("ranges-lut-list")].vec.append(Var::Map{
-            {QStringLiteral("width"), int(width)},
-            {QStringLiteral("name"), name},
-            {QStringLiteral("size"), size},
-        });
-        auto &currentLut = data[QStringLiteral("ranges-luts")].vec.last()[QStringLiteral("ranges")].vec;
-        for (const auto &range : *currentMergedRangesIt) {
-            Q_ASSERT(range.first <= LAST_CODE_POINT);
-            Q_ASSERT(range.second <= LAST_CODE_POINT);
-            currentLut.append(Var(Var::Map{{QStringLiteral("first"), range.first}, {QStringLiteral("last"), range.second}}));
+        int id = pageIds.value(key, -1);
+        if (id < 0) {
+            id = pageIds.size();
+            pageIds.insert(key, id);
+            for (int i = 0; i < PAGE_SIZE; ++i) {
+                pageData.append(Var::Number(int8_t(key[i])));
+            }
         }
+        pageIndex[page] = Var::Number(id);
+    }
+    // The template stores page ids in uint8_t
+    if (pageIds.size() > 256) {
+        eout << QStringLiteral("Too many unique pages (%1) for a uint8_t page index - widen PAGE_INDEX in the template.").arg(pageIds.size()) << Qt::endl;
+        exit(1);
     }
-    data[QStringLiteral("ranges-lut-list")].vec.append(Var::Map{
-        {QStringLiteral("width"), widthsSortOrder[lastWidthId].width()},
-        {QStringLiteral("name"), QStringLiteral("nullptr")},
-        {QStringLiteral("size"), 1},
-    });
-    data[QStringLiteral("ranges-lut-list-size")] = mergedRanges.size();
 
     Template t(templateText);
     t.parse();